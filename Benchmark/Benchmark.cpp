@@ -0,0 +1,21 @@
+#include <vector>
+#include <string>
+
+#ifndef _WIN32
+	#define __stdcall
+#endif
+
+using std::string;
+using std::vector;
+
+extern "C" {
+	int __stdcall RunBenchmark(vector<string> args);
+}
+
+//Runs one of the core's micro-benchmarks (see InteropDLL/BenchmarkApiWrapper.cpp)
+//e.g: benchmark savestate --iterations 1000 ../PGOGames
+int main(int argc, char* argv[])
+{
+	vector<string> args(argv + 1, argv + argc);
+	return RunBenchmark(args);
+}
@@ -13,6 +13,7 @@
 #include "Debugger/ITraceLogger.h"
 #include "Debugger/ExpressionEvaluator.h"
 #include "Debugger/TraceLogFileSaver.h"
+#include "Debugger/TraceStore.h"
 #include "Utilities/HexUtilities.h"
 #include "Shared/Emulator.h"
 #include "Shared/EmuSettings.h"
@@ -109,14 +110,6 @@ enum class RowDataType
 	Mode,
 };
 
-struct TraceLogPpuState
-{
-	uint32_t Cycle;
-	uint32_t HClock;
-	int32_t Scanline;
-	uint32_t FrameCount;
-};
-
 struct RowPart
 {
 	RowDataType DataType;
@@ -143,6 +136,12 @@ protected:
 
 	vector<RowPart> _rowParts;
 
+	//True when the format contains [EffectiveAddress] or [MemoryValue] (binary logs then record them for each row)
+	bool _hasMemoryTags = false;
+
+	//Binary log row being formatted by GetBinaryTraceRow (its effective address & memory value are used instead of the live ones)
+	BinaryTraceRow* _binaryRow = nullptr;
+
 	uint32_t _currentPos = 0;
 
 	bool _pendingLog = false;
@@ -157,6 +156,9 @@ protected:
 	unique_ptr<ExpressionEvaluator> _expEvaluator;
 	ExpressionData _conditionData;
 
+	//Register columns of the trace store (A, X, Y, SP, PS), nullptr when the CPU has no such register
+	ExpressionRegisterAccessor _storeRegisters[5] = {};
+
 	void WriteByteCode(DisassemblyInfo& info, RowPart& rowPart, string& output)
 	{
 		string byteCode;
@@ -186,9 +188,19 @@ protected:
 		}
 	}
 	
+	EffectiveAddressInfo GetEffectiveAddress(DisassemblyInfo& info, void* cpuState, CpuType cpuType)
+	{
+		if(_binaryRow) {
+			//Rows logged without memory info (the format had no memory tags at the time) show neither tag
+			BinaryTraceMemoryInfo& memInfo = _binaryRow->MemoryInfo;
+			return _binaryRow->HasMemoryInfo ? EffectiveAddressInfo(memInfo.Address, memInfo.ValueSize, memInfo.ShowAddress, (MemoryType)memInfo.Type) : EffectiveAddressInfo();
+		}
+		return info.GetEffectiveAddress(_debugger, cpuState, cpuType);
+	}
+
 	void WriteEffectiveAddress(DisassemblyInfo& info, RowPart& rowPart, void* cpuState, string& output, MemoryType cpuMemoryType, CpuType cpuType)
 	{
-		EffectiveAddressInfo effectiveAddress = info.GetEffectiveAddress(_debugger, cpuState, cpuType);
+		EffectiveAddressInfo effectiveAddress = GetEffectiveAddress(info, cpuState, cpuType);
 		if(effectiveAddress.ShowAddress && effectiveAddress.Address >= 0) {
 			MemoryType effectiveMemType = effectiveAddress.Type == MemoryType::None ? cpuMemoryType : effectiveAddress.Type;
 			if(_options.UseLabels) {
@@ -211,10 +223,10 @@ protected:
 
 	void WriteMemoryValue(DisassemblyInfo& info, RowPart& rowPart, void* cpuState, string& output, MemoryType memType, CpuType cpuType)
 	{
-		EffectiveAddressInfo effectiveAddress = info.GetEffectiveAddress(_debugger, cpuState, cpuType);
+		EffectiveAddressInfo effectiveAddress = GetEffectiveAddress(info, cpuState, cpuType);
 		if(effectiveAddress.Address >= 0 && effectiveAddress.ValueSize > 0) {
 			MemoryType effectiveMemType = effectiveAddress.Type == MemoryType::None ? memType : effectiveAddress.Type;
-			uint16_t value = info.GetMemoryValue(effectiveAddress, _memoryDumper, effectiveMemType);
+			uint16_t value = _binaryRow ? _binaryRow->MemoryInfo.Value : info.GetMemoryValue(effectiveAddress, _memoryDumper, effectiveMemType);
 			if(rowPart.DisplayInHex) {
 				output += "= $";
 				if(effectiveAddress.ValueSize == 2) {
@@ -286,27 +298,85 @@ protected:
 
 		_pendingLog = false;
 
-		if(_debugger->GetTraceLogFileSaver()->IsEnabled()) {
-			string row;
-			row.reserve(300);
-			
-			//Display PC
-			RowPart rowPart = {};
-			rowPart.DisplayInHex = true;
-			rowPart.MinWidth = DebugUtilities::GetProgramCounterSize(_cpuType);
-			WriteIntValue(row, ((TraceLoggerType*)this)->GetProgramCounter(cpuState), rowPart);
-			row += "  ";
-
-			((TraceLoggerType*)this)->GetTraceRow(row, cpuState, _ppuState[_currentPos], disassemblyInfo);
-			_debugger->GetTraceLogFileSaver()->Log(row);
+		TraceLogFileSaver* fileSaver = _debugger->GetTraceLogFileSaver();
+		if(fileSaver->IsEnabled()) {
+			if(fileSaver->IsBinary()) {
+				//Formatting is deferred until the log is read back, except for the values that depend on the current memory contents
+				if(_hasMemoryTags) {
+					BinaryTraceMemoryInfo memInfo = GetMemoryInfo(cpuState, disassemblyInfo);
+					fileSaver->LogBinary(_cpuType, disassemblyInfo, &cpuState, sizeof(CpuStateType), _ppuState[_currentPos], &memInfo);
+				} else {
+					fileSaver->LogBinary(_cpuType, disassemblyInfo, &cpuState, sizeof(CpuStateType), _ppuState[_currentPos], nullptr);
+				}
+			} else {
+				string row;
+				row.reserve(300);
+				GetFileRow(row, cpuState, _ppuState[_currentPos], disassemblyInfo);
+				fileSaver->Log(row);
+			}
+		}
+
+		TraceStore* traceStore = _debugger->GetTraceStore();
+		if(traceStore->IsEnabled()) {
+			AddStoreRow(traceStore, cpuState, _ppuState[_currentPos], disassemblyInfo);
 		}
 
 		_currentPos = (_currentPos + 1) % ExecutionLogSize;
 	}
 
+	BinaryTraceMemoryInfo GetMemoryInfo(CpuStateType& cpuState, DisassemblyInfo& disassemblyInfo)
+	{
+		BinaryTraceMemoryInfo memInfo = {};
+		EffectiveAddressInfo effectiveAddress = disassemblyInfo.GetEffectiveAddress(_debugger, &cpuState, _cpuType);
+		memInfo.Address = (int32_t)effectiveAddress.Address;
+		memInfo.Type = (uint8_t)effectiveAddress.Type;
+		memInfo.ValueSize = effectiveAddress.ValueSize;
+		memInfo.ShowAddress = effectiveAddress.ShowAddress;
+		if(effectiveAddress.Address >= 0 && effectiveAddress.ValueSize > 0) {
+			MemoryType effectiveMemType = effectiveAddress.Type == MemoryType::None ? _cpuMemoryType : effectiveAddress.Type;
+			memInfo.Value = (uint16_t)disassemblyInfo.GetMemoryValue(effectiveAddress, _memoryDumper, effectiveMemType);
+		}
+		return memInfo;
+	}
+
+	void AddStoreRow(TraceStore* traceStore, CpuStateType& cpuState, TraceLogPpuState& ppuState, DisassemblyInfo& disassemblyInfo)
+	{
+		TraceStoreRow row;
+		row.Type = _cpuType;
+		row.OpSize = disassemblyInfo.GetOpSize();
+		uint8_t* byteCode = disassemblyInfo.GetByteCode();
+		row.ByteCode = byteCode[0] | (byteCode[1] << 8) | (byteCode[2] << 16) | (byteCode[3] << 24);
+		row.ProgramCounter = ((TraceLoggerType*)this)->GetProgramCounter(cpuState);
+
+		uint32_t* registers[5] = { &row.A, &row.X, &row.Y, &row.SP, &row.PS };
+		for(int i = 0; i < 5; i++) {
+			*registers[i] = _storeRegisters[i] ? (uint32_t)_storeRegisters[i](cpuState) : 0;
+		}
+
+		EffectiveAddressInfo effectiveAddress = disassemblyInfo.GetEffectiveAddress(_debugger, &cpuState, _cpuType);
+		row.EffectiveAddress = effectiveAddress.Address >= 0 && effectiveAddress.ValueSize > 0 ? (int32_t)effectiveAddress.Address : -1;
+		row.CycleCount = ((TraceLoggerType*)this)->GetCycleCount(cpuState);
+		row.FrameCount = ppuState.FrameCount;
+		row.Scanline = (int16_t)ppuState.Scanline;
+		traceStore->AddRow(row);
+	}
+
+	void GetFileRow(string& row, CpuStateType& cpuState, TraceLogPpuState& ppuState, DisassemblyInfo& disassemblyInfo)
+	{
+		//Display PC
+		RowPart rowPart = {};
+		rowPart.DisplayInHex = true;
+		rowPart.MinWidth = DebugUtilities::GetProgramCounterSize(_cpuType);
+		WriteIntValue(row, ((TraceLoggerType*)this)->GetProgramCounter(cpuState), rowPart);
+		row += "  ";
+
+		((TraceLoggerType*)this)->GetTraceRow(row, cpuState, ppuState, disassemblyInfo);
+	}
+
 	void ParseFormatString(string format)
 	{
 		_rowParts.clear();
+		_hasMemoryTags = false;
 
 		std::regex formatRegex = std::regex("(\\[\\s*([^[]*?)\\s*(,\\s*([\\d]*)\\s*(h){0,1}){0,1}\\s*\\])|([^[]*)", std::regex_constants::icase);
 		std::sregex_iterator start = std::sregex_iterator(format.cbegin(), format.cend(), formatRegex);
@@ -327,6 +397,8 @@ protected:
 				part.DataType = InternalGetFormatTagType(tag);
 				if(part.DataType == RowDataType::Text) {
 					part.Text = "[Invalid tag]";
+				} else if(part.DataType == RowDataType::EffectiveAddress || part.DataType == RowDataType::MemoryValue) {
+					_hasMemoryTags = true;
 				}
 
 				if(!match.str(4).empty()) {
@@ -393,6 +465,21 @@ protected:
 		}
 	}
 
+	//Used by CreateFormatter: keeps the format & options, but not the execution log buffers or the condition evaluator
+	BaseTraceLogger(const BaseTraceLogger& src)
+	{
+		_options = src._options;
+		_console = src._console;
+		_settings = src._settings;
+		_labelManager = src._labelManager;
+		_memoryDumper = src._memoryDumper;
+		_debugger = src._debugger;
+		_cpuType = src._cpuType;
+		_cpuMemoryType = src._cpuMemoryType;
+		_rowParts = src._rowParts;
+		_hasMemoryTags = src._hasMemoryTags;
+	}
+
 public:
 	BaseTraceLogger(Debugger* debugger, IDebugger* cpuDebugger, CpuType cpuType)
 	{
@@ -420,6 +507,11 @@ public:
 		_cpuMemoryType = DebugUtilities::GetCpuMemoryType(cpuType);
 
 		_expEvaluator.reset(new ExpressionEvaluator(debugger, cpuDebugger, cpuType));
+
+		int64_t storeRegisters[5] = { EvalValues::RegA, EvalValues::RegX, EvalValues::RegY, EvalValues::RegSP, EvalValues::RegPS };
+		for(int i = 0; i < 5; i++) {
+			_storeRegisters[i] = _expEvaluator->GetRegisterAccessor(storeRegisters[i]);
+		}
 	}
 
 	virtual ~BaseTraceLogger()
@@ -489,6 +581,11 @@ public:
 		_debugger->ProcessConfigChange();
 	}
 
+	TraceLoggerOptions GetOptions() override
+	{
+		return _options;
+	}
+
 	int64_t GetRowId(uint32_t offset) override
 	{
 		int32_t pos = ((int32_t)_currentPos - (int32_t)offset);
@@ -510,6 +607,27 @@ public:
 		return true;
 	}
 
+	bool GetBinaryTraceRow(BinaryTraceRow& data, string& output, uint32_t& programCounter) override
+	{
+		static_assert(sizeof(CpuStateType) <= UINT16_MAX, "CPU state too large for the binary trace log format");
+		if(data.Type != _cpuType || data.StateSize != sizeof(CpuStateType)) {
+			return false;
+		}
+
+		CpuStateType state;
+		memcpy(&state, data.CpuState, sizeof(CpuStateType));
+		programCounter = ((TraceLoggerType*)this)->GetProgramCounter(state);
+		_binaryRow = &data;
+		((TraceLoggerType*)this)->GetTraceRow(output, state, data.PpuState, data.Disassembly);
+		_binaryRow = nullptr;
+		return true;
+	}
+
+	unique_ptr<ITraceLogger> CreateFormatter() override
+	{
+		return std::make_unique<TraceLoggerType>(*(TraceLoggerType*)this);
+	}
+
 	void GetExecutionTrace(TraceRow& row, uint32_t offset) override
 	{
 		int pos = ((int)_currentPos - offset);
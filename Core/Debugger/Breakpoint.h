@@ -23,6 +23,10 @@ public:
 	bool IsMarked();
 	bool IsAllowedForOpType(MemoryOperationType opType);
 
+	MemoryType GetMemoryType() { return _memoryType; }
+	int32_t GetStartAddress() { return _startAddr; }
+	int32_t GetEndAddress() { return _endAddr; }
+
 private:
 	uint32_t _id;
 	CpuType _cpuType;
@@ -24,6 +24,7 @@ void BreakpointManager::SetBreakpoints(Breakpoint breakpoints[], uint32_t count)
 	for(int i = 0; i < BreakpointManager::BreakpointTypeCount; i++) {
 		_breakpoints[i].clear();
 		_rpnList[i].clear();
+		_indexes[i].clear();
 		_hasBreakpointType[i] = false;
 	}
 
@@ -39,10 +40,11 @@ void BreakpointManager::SetBreakpoints(Breakpoint breakpoints[], uint32_t count)
 					continue;
 				}
 
-				if(bp.IsAllowedForOpType(opType)) {
-					_breakpoints[i].push_back(bp);
+				if(!bp.IsAllowedForOpType(opType)) {
+					continue;
 				}
 
+				_breakpoints[i].push_back(bp);
 				if(bp.HasCondition()) {
 					bool success = true;
 					ExpressionData data = _bpExpEval->GetRpnList(bp.GetCondition(), success);
@@ -56,6 +58,69 @@ void BreakpointManager::SetBreakpoints(Breakpoint breakpoints[], uint32_t count)
 			}
 		}
 	}
+
+	for(int i = 0; i < BreakpointManager::BreakpointTypeCount; i++) {
+		BuildIndex(i);
+	}
+}
+
+void BreakpointManager::BuildIndex(int opType)
+{
+	//Group the breakpoints by memory type, each group is sorted by start address so
+	//CheckBreakpoint only has to look at the few ranges that can contain the address
+	vector<Breakpoint>& breakpoints = _breakpoints[opType];
+	for(uint32_t i = 0; i < (uint32_t)breakpoints.size(); i++) {
+		Breakpoint& bp = breakpoints[i];
+		BreakpointIndex* index = FindIndex(opType, bp.GetMemoryType());
+		if(!index) {
+			_indexes[opType].push_back({ bp.GetMemoryType(), DebugUtilities::IsRelativeMemory(bp.GetMemoryType()), {} });
+			index = &_indexes[opType].back();
+		}
+		index->Ranges.push_back({ bp.GetStartAddress(), bp.GetEndAddress(), 0, i });
+	}
+
+	for(BreakpointIndex& index : _indexes[opType]) {
+		std::sort(index.Ranges.begin(), index.Ranges.end(), [](const BreakpointRange& a, const BreakpointRange& b) {
+			return a.StartAddr < b.StartAddr;
+		});
+
+		int32_t maxEndAddr = INT32_MIN;
+		for(BreakpointRange& range : index.Ranges) {
+			maxEndAddr = std::max(maxEndAddr, range.EndAddr);
+			range.MaxEndAddr = maxEndAddr;
+		}
+	}
+}
+
+BreakpointManager::BreakpointIndex* BreakpointManager::FindIndex(int opType, MemoryType memType)
+{
+	for(BreakpointIndex& index : _indexes[opType]) {
+		if(index.Type == memType) {
+			return &index;
+		}
+	}
+	return nullptr;
+}
+
+void BreakpointManager::AddMatches(BreakpointIndex& index, int64_t startAddr, int64_t endAddr)
+{
+	vector<BreakpointRange>& ranges = index.Ranges;
+	if(ranges.back().MaxEndAddr < startAddr || ranges.front().StartAddr > endAddr) {
+		return;
+	}
+
+	auto it = std::upper_bound(ranges.begin(), ranges.end(), endAddr, [](int64_t value, const BreakpointRange& range) {
+		return value < range.StartAddr;
+	});
+	while(it != ranges.begin()) {
+		--it;
+		if(it->MaxEndAddr < startAddr) {
+			break;
+		}
+		if(it->EndAddr >= startAddr) {
+			_matches.push_back(it->Index);
+		}
+	}
 }
 
 BreakpointType BreakpointManager::GetBreakpointType(MemoryOperationType type)
@@ -84,20 +149,43 @@ BreakpointType BreakpointManager::GetBreakpointType(MemoryOperationType type)
 template<uint8_t accessWidth>
 int BreakpointManager::InternalCheckBreakpoint(MemoryOperationInfo operationInfo, AddressInfo &address, bool processMarkedBreakpoints)
 {
+	int opType = (int)operationInfo.Type;
+	_matches.clear();
+
+	//Same rules as Breakpoint::Matches: relative breakpoints match on the CPU address when the
+	//operation's memory type matches, all others match on the absolute address
+	bool isRelative = DebugUtilities::IsRelativeMemory(operationInfo.MemType);
+	if(isRelative) {
+		if(BreakpointIndex* index = FindIndex(opType, operationInfo.MemType)) {
+			AddMatches(*index, (int32_t)operationInfo.Address, (int64_t)(int32_t)operationInfo.Address + accessWidth - 1);
+		}
+	}
+	if(!isRelative || address.Type != operationInfo.MemType) {
+		if(BreakpointIndex* index = FindIndex(opType, address.Type)) {
+			AddMatches(*index, address.Address, (int64_t)address.Address + accessWidth - 1);
+		}
+	}
+
+	if(_matches.empty()) {
+		return -1;
+	}
+	if(_matches.size() > 1) {
+		//Process the breakpoints in the order they were set (affects which ID is returned & event order)
+		std::sort(_matches.begin(), _matches.end());
+	}
+
 	EvalResultType resultType;
-	vector<Breakpoint> &breakpoints = _breakpoints[(int)operationInfo.Type];
-	for(size_t i = 0, len = breakpoints.size(); i < len; i++) {
-		if(breakpoints[i].Matches<accessWidth>(operationInfo, address)) {
-			if(breakpoints[i].HasCondition() && !_bpExpEval->Evaluate(_rpnList[(int)operationInfo.Type][i], resultType, operationInfo, address)) {
-				continue;
-			}
+	vector<Breakpoint> &breakpoints = _breakpoints[opType];
+	for(uint32_t i : _matches) {
+		if(breakpoints[i].HasCondition() && !_bpExpEval->Evaluate(_rpnList[opType][i], resultType, operationInfo, address)) {
+			continue;
+		}
 
-			if(breakpoints[i].IsMarked() && processMarkedBreakpoints) {
-				_eventManager->AddEvent(DebugEventType::Breakpoint, operationInfo, breakpoints[i].GetId());
-			}
-			if(breakpoints[i].IsEnabled()) {
-				return breakpoints[i].GetId();
-			}
+		if(breakpoints[i].IsMarked() && processMarkedBreakpoints) {
+			_eventManager->AddEvent(DebugEventType::Breakpoint, operationInfo, breakpoints[i].GetId());
+		}
+		if(breakpoints[i].IsEnabled()) {
+			return breakpoints[i].GetId();
 		}
 	}
 
@@ -16,6 +16,22 @@ class BreakpointManager
 private:
 	static constexpr int BreakpointTypeCount = (int)MemoryOperationType::PpuRenderingRead + 1;
 
+	struct BreakpointRange
+	{
+		int32_t StartAddr;
+		int32_t EndAddr;
+		int32_t MaxEndAddr; //Max EndAddr of this range and all previous ones
+		uint32_t Index; //Index in _breakpoints/_rpnList
+	};
+
+	//Breakpoint ranges for a single memory type, sorted by StartAddr
+	struct BreakpointIndex
+	{
+		MemoryType Type;
+		bool IsRelative;
+		vector<BreakpointRange> Ranges;
+	};
+
 	Debugger* _debugger;
 	IDebugger *_cpuDebugger;
 	CpuType _cpuType;
@@ -25,10 +41,15 @@ private:
 	vector<ExpressionData> _rpnList[BreakpointTypeCount];
 	bool _hasBreakpoint;
 	bool _hasBreakpointType[BreakpointTypeCount] = {};
+	vector<BreakpointIndex> _indexes[BreakpointTypeCount];
+	vector<uint32_t> _matches;
 
 	unique_ptr<ExpressionEvaluator> _bpExpEval;
 
 	BreakpointType GetBreakpointType(MemoryOperationType type);
+	void BuildIndex(int opType);
+	BreakpointIndex* FindIndex(int opType, MemoryType memType);
+	void AddMatches(BreakpointIndex& index, int64_t startAddr, int64_t endAddr);
 	template<uint8_t accessWidth> int InternalCheckBreakpoint(MemoryOperationInfo operationInfo, AddressInfo &address, bool processMarkedBreakpoints);
 
 public:
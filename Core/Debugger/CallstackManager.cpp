@@ -33,7 +33,9 @@ void CallstackManager::Push(AddressInfo &src, uint32_t srcAddr, AddressInfo& des
 	stackFrame.Flags = flags;
 
 	_callstack.push_back(stackFrame);
-	_profiler->StackFunction(dest, flags);
+	if(_profilerEnabled) {
+		_profiler->StackFunction(dest, flags);
+	}
 }
 
 void CallstackManager::Pop(AddressInfo& dest, uint32_t destAddress)
@@ -44,7 +46,9 @@ void CallstackManager::Pop(AddressInfo& dest, uint32_t destAddress)
 
 	StackFrameInfo prevFrame = _callstack.back();
 	_callstack.pop_back();
-	_profiler->UnstackFunction();
+	if(_profilerEnabled) {
+		_profiler->UnstackFunction();
+	}
 
 	uint32_t returnAddr = prevFrame.Return;
 
@@ -57,7 +61,9 @@ void CallstackManager::Pop(AddressInfo& dest, uint32_t destAddress)
 				foundMatch = true;
 				for(int j = (int)_callstack.size() - i - 1; j >= 0; j--) {
 					_callstack.pop_back();
-					_profiler->UnstackFunction();
+					if(_profilerEnabled) {
+						_profiler->UnstackFunction();
+					}
 				}
 				break;
 			}
@@ -103,6 +109,15 @@ Profiler* CallstackManager::GetProfiler()
 	return _profiler.get();
 }
 
+void CallstackManager::SetProfilerEnabled(bool enabled)
+{
+	if(enabled && !_profilerEnabled) {
+		//The profiler's stack is out of sync with the callstack after being disabled
+		_profiler->ResetState();
+	}
+	_profilerEnabled = enabled;
+}
+
 void CallstackManager::Clear()
 {
 	_callstack.clear();
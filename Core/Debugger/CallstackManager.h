@@ -12,6 +12,7 @@ private:
 	Debugger* _debugger;
 	deque<StackFrameInfo> _callstack;
 	unique_ptr<Profiler> _profiler;
+	bool _profilerEnabled = true;
 
 public:
 	CallstackManager(Debugger* debugger, IDebugger* cpuDebugger);
@@ -38,6 +39,18 @@ public:
 	void GetCallstack(StackFrameInfo* callstackArray, uint32_t &callstackSize);
 	int32_t GetReturnAddress();
 	Profiler* GetProfiler();
+	void SetProfilerEnabled(bool enabled);
+
+	//Copies the targets of the last maxDepth stack frames (outermost first), returns the number of frames copied
+	uint32_t GetTopFrames(AddressInfo* targets, uint32_t maxDepth)
+	{
+		uint32_t depth = std::min((uint32_t)_callstack.size(), maxDepth);
+		auto itt = _callstack.end() - depth;
+		for(uint32_t i = 0; i < depth; i++, itt++) {
+			targets[i] = itt->AbsTarget;
+		}
+		return depth;
+	}
 
 	void Clear();
 };
\ No newline at end of file
@@ -7,6 +7,8 @@
 #include "Debugger/CodeDataLogger.h"
 #include "Debugger/Disassembler.h"
 #include "Debugger/DisassemblySearch.h"
+#include "Debugger/DisassemblyExporter.h"
+#include "Debugger/SamplingProfiler.h"
 #include "Debugger/BreakpointManager.h"
 #include "Debugger/PpuTools.h"
 #include "Debugger/DebugBreakHelper.h"
@@ -17,6 +19,7 @@
 #include "Debugger/ExpressionEvaluator.h"
 #include "Debugger/BaseEventManager.h"
 #include "Debugger/TraceLogFileSaver.h"
+#include "Debugger/TraceStore.h"
 #include "Debugger/CdlManager.h"
 #include "Debugger/ITraceLogger.h"
 #include "Shared/SocketServer.h"
@@ -74,9 +77,12 @@ Debugger::Debugger(Emulator* emu, shared_ptr<IConsole> console)
 	_memoryDumper.reset(new MemoryDumper(this));
 	_disassembler.reset(new Disassembler(console.get(), this));
 	_disassemblySearch.reset(new DisassemblySearch(_disassembler.get(), _labelManager.get()));
+	_disassemblyExporter.reset(new DisassemblyExporter(this, _disassembler.get(), _labelManager.get()));
+	_samplingProfiler.reset(new SamplingProfiler(this));
 	_memoryAccessCounter.reset(new MemoryAccessCounter(this));
 	_scriptManager.reset(new ScriptManager(this));
 	_traceLogSaver.reset(new TraceLogFileSaver());
+	_traceStore.reset(new TraceStore());
 	_cdlManager.reset(new CdlManager(this, _disassembler.get()));
 
 	//Use cpuTypes for iteration (ordered), not _cpuTypes (order is important for coprocessors, etc.)
@@ -217,6 +223,10 @@ void Debugger::ProcessInstruction()
 	}
 
 	debugger->AllowChangeProgramCounter = false;
+
+	if(_samplingProfiler->IsSampling(type)) {
+		_samplingProfiler->ProcessInstruction(debugger);
+	}
 	
 	if(_scriptManager->HasCpuMemoryCallbacks()) {
 		MemoryOperationInfo memOp = debugger->InstructionProgress.LastMemOperation;
@@ -459,7 +469,7 @@ void Debugger::SleepUntilResume(CpuType sourceCpu, BreakSource source, MemoryOpe
 		// Broadcast BREAK event to socket clients
 		stringstream ss;
 		ss << "{\"cpu\":" << (int)sourceCpu << ",\"id\":" << breakpointId << ",\"pc\":\"" << HexUtilities::ToHex(GetProgramCounter(sourceCpu, true)) << "\"}";
-		SocketServer::BroadcastEvent("breakpoint_hit", ss.str());
+		SocketServer::BroadcastEvent("breakpoint_hit", ss.str(), _emu->GetInstanceId());
 
 		_emu->GetNotificationManager()->SendNotification(ConsoleNotificationType::CodeBreak, &evt);
 		ProcessEvent(EventType::CodeBreak, sourceCpu);
@@ -620,6 +630,33 @@ int64_t Debugger::EvaluateExpression(string expression, CpuType cpuType, EvalRes
 	return 0;
 }
 
+bool Debugger::CompileExpression(string expression, CpuType cpuType, ExpressionData &data)
+{
+	if(!_debuggers[(int)cpuType].Evaluator) {
+		return false;
+	}
+
+	try {
+		bool success = false;
+		data = _debuggers[(int)cpuType].Evaluator->GetRpnList(expression, success);
+		return success && !data.RpnQueue.empty();
+	} catch(std::exception&) {
+		return false;
+	}
+}
+
+int64_t Debugger::EvaluateExpression(ExpressionData &data, CpuType cpuType, EvalResultType &resultType)
+{
+	MemoryOperationInfo operationInfo { 0, 0, MemoryOperationType::Read, MemoryType::None };
+	AddressInfo addressInfo = { 0, MemoryType::None };
+	if(_debuggers[(int)cpuType].Evaluator) {
+		return _debuggers[(int)cpuType].Evaluator->Evaluate(data, resultType, operationInfo, addressInfo);
+	}
+
+	resultType = EvalResultType::Invalid;
+	return 0;
+}
+
 void Debugger::Run()
 {
 	for(int i = 0; i <= (int)DebugUtilities::GetLastCpuType(); i++) {
@@ -1073,6 +1110,103 @@ uint32_t Debugger::GetExecutionTrace(TraceRow output[], uint32_t startOffset, ui
 	return count;
 }
 
+vector<unique_ptr<ITraceLogger>> Debugger::CreateTraceLogFormatters()
+{
+	//Only the copy of the loggers' options needs execution to be stopped, the rows are formatted
+	//by the copies afterwards (without pausing emulation or touching the loggers' state)
+	DebugBreakHelper helper(this);
+
+	vector<unique_ptr<ITraceLogger>> formatters((int)DebugUtilities::GetLastCpuType() + 1);
+	for(CpuType cpuType : _cpuTypes) {
+		ITraceLogger* logger = GetTraceLogger(cpuType);
+		if(logger) {
+			formatters[(int)cpuType] = logger->CreateFormatter();
+		}
+	}
+	return formatters;
+}
+
+int32_t Debugger::GetBinaryTraceLog(string filename, TraceRow output[], uint64_t startRow, uint32_t maxRowCount)
+{
+	vector<unique_ptr<ITraceLogger>> formatters = CreateTraceLogFormatters();
+
+	uint32_t count = 0;
+	string logOutput;
+	bool valid = maxRowCount == 0 || TraceLogFileSaver::ReadBinaryLog(filename, startRow, [&](BinaryTraceRow& data) {
+		ITraceLogger* logger = formatters[(int)data.Type].get();
+		TraceRow& row = output[count];
+		logOutput.clear();
+		if(!logger || !logger->GetBinaryTraceRow(data, logOutput, row.ProgramCounter)) {
+			row.ProgramCounter = 0;
+		}
+
+		row.Type = data.Type;
+		data.Disassembly.GetByteCode(row.ByteCode);
+		row.ByteCodeSize = data.Disassembly.GetOpSize();
+		row.LogSize = std::min<uint32_t>(499, (uint32_t)logOutput.size());
+		memcpy(row.LogOutput, logOutput.c_str(), row.LogSize);
+		row.LogOutput[row.LogSize] = 0;
+		return ++count < maxRowCount;
+	});
+
+	return valid ? (int32_t)count : -1;
+}
+
+int64_t Debugger::ConvertBinaryTraceLog(string inputFile, string outputFile)
+{
+	ofstream output(outputFile, ios::out | ios::binary);
+	if(!output) {
+		return -1;
+	}
+
+	vector<unique_ptr<ITraceLogger>> formatters = CreateTraceLogFormatters();
+
+	//Rows are written in the same format as text trace logs (see BaseTraceLogger::GetFileRow)
+	int64_t count = 0;
+	string row;
+	string buffer;
+	bool valid = TraceLogFileSaver::ReadBinaryLog(inputFile, 0, [&](BinaryTraceRow& data) {
+		ITraceLogger* logger = formatters[(int)data.Type].get();
+		uint32_t pc = 0;
+		row.clear();
+		if(logger && logger->GetBinaryTraceRow(data, row, pc)) {
+			string pcText = HexUtilities::ToHex(pc);
+			int pcSize = DebugUtilities::GetProgramCounterSize(data.Type);
+			if(pcSize > (int)pcText.size()) {
+				buffer.append(pcSize - pcText.size(), '0');
+			}
+			buffer += pcText;
+			buffer += "  ";
+			buffer += row;
+			buffer += '\n';
+			count++;
+		}
+
+		if(buffer.size() > 0x100000) {
+			output << buffer;
+			buffer.clear();
+		}
+		return true;
+	});
+	output << buffer;
+
+	return valid ? count : -1;
+}
+
+bool Debugger::StartTraceLogFile(string filename, bool binary)
+{
+	//The emulation thread writes to the file saver's buffers without locking, execution must be stopped while they are replaced
+	DebugBreakHelper helper(this);
+	_traceLogSaver->StartLogging(filename, binary);
+	return _traceLogSaver->IsEnabled();
+}
+
+void Debugger::StopTraceLogFile()
+{
+	DebugBreakHelper helper(this);
+	_traceLogSaver->StopLogging();
+}
+
 PpuTools* Debugger::GetPpuTools(CpuType cpuType)
 {
 	if(_debuggers[(int)cpuType].Debugger) {
@@ -22,6 +22,8 @@ class MemoryDumper;
 class MemoryAccessCounter;
 class Disassembler;
 class DisassemblySearch;
+class DisassemblyExporter;
+class SamplingProfiler;
 class BreakpointManager;
 class PpuTools;
 class CodeDataLogger;
@@ -35,10 +37,12 @@ class IAssembler;
 class IDebugger;
 class ITraceLogger;
 class TraceLogFileSaver;
+class TraceStore;
 class FrozenAddressManager;
 
 struct TraceRow;
 struct BaseState;
+struct ExpressionData;
 
 enum class EventType;
 enum class MemoryOperationType;
@@ -70,10 +74,13 @@ private:
 	unique_ptr<CodeDataLogger> _codeDataLogger;
 	unique_ptr<Disassembler> _disassembler;
 	unique_ptr<DisassemblySearch> _disassemblySearch;
+	unique_ptr<DisassemblyExporter> _disassemblyExporter;
+	unique_ptr<SamplingProfiler> _samplingProfiler;
 	unique_ptr<LabelManager> _labelManager;
 	unique_ptr<CdlManager> _cdlManager;
 
 	unique_ptr<TraceLogFileSaver> _traceLogSaver;
+	unique_ptr<TraceStore> _traceStore;
 
 	SimpleLock _logLock;
 	std::list<string> _debuggerLog;
@@ -102,6 +109,8 @@ private:
 	bool IsBreakOptionEnabled(BreakSource src);
 	template<CpuType type> void SleepOnBreakRequest();
 
+	vector<unique_ptr<ITraceLogger>> CreateTraceLogFormatters();
+
 public:
 	Debugger(Emulator* emu, shared_ptr<IConsole> console);
 	~Debugger();
@@ -128,6 +137,9 @@ public:
 
 	void GetTokenList(CpuType cpuType, char* tokenList);
 	int64_t EvaluateExpression(string expression, CpuType cpuType, EvalResultType &resultType, bool useCache);
+	//Precompiled variants for expressions evaluated often outside of breakpoints (e.g socket API logpoints)
+	bool CompileExpression(string expression, CpuType cpuType, ExpressionData &data);
+	int64_t EvaluateExpression(ExpressionData &data, CpuType cpuType, EvalResultType &resultType);
 
 	void Run();
 	void PauseOnNextFrame();
@@ -179,14 +191,21 @@ public:
 
 	void ClearExecutionTrace();
 	uint32_t GetExecutionTrace(TraceRow output[], uint32_t startOffset, uint32_t maxLineCount);
+	int32_t GetBinaryTraceLog(string filename, TraceRow output[], uint64_t startRow, uint32_t maxRowCount);
+	int64_t ConvertBinaryTraceLog(string inputFile, string outputFile);
+	bool StartTraceLogFile(string filename, bool binary);
+	void StopTraceLogFile();
 	
 	CpuType GetMainCpuType() { return _mainCpuType; }
 
 	TraceLogFileSaver* GetTraceLogFileSaver() { return _traceLogSaver.get(); }
+	TraceStore* GetTraceStore() { return _traceStore.get(); }
 	MemoryDumper* GetMemoryDumper() { return _memoryDumper.get(); }
 	MemoryAccessCounter* GetMemoryAccessCounter() { return _memoryAccessCounter.get(); }
 	Disassembler* GetDisassembler() { return _disassembler.get(); }
 	DisassemblySearch* GetDisassemblySearch() { return _disassemblySearch.get(); }
+	DisassemblyExporter* GetDisassemblyExporter() { return _disassemblyExporter.get(); }
+	SamplingProfiler* GetSamplingProfiler() { return _samplingProfiler.get(); }
 	LabelManager* GetLabelManager() { return _labelManager.get(); }
 	CdlManager* GetCdlManager() { return _cdlManager.get(); }
 	ScriptManager* GetScriptManager() { return _scriptManager.get(); }
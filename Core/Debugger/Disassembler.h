@@ -24,6 +24,7 @@ class Disassembler
 {
 private:
 	friend class DisassemblySearch;
+	friend class DisassemblyExporter;
 
 	IConsole *_console;
 	EmuSettings* _settings;
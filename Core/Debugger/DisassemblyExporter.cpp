@@ -0,0 +1,289 @@
+#include "pch.h"
+#include <algorithm>
+#include "Debugger/DisassemblyExporter.h"
+#include "Debugger/Debugger.h"
+#include "Debugger/Disassembler.h"
+#include "Debugger/DisassemblyInfo.h"
+#include "Debugger/CdlManager.h"
+#include "Debugger/CodeDataLogger.h"
+#include "Debugger/MemoryDumper.h"
+#include "Debugger/DebugBreakHelper.h"
+#include "Shared/EmuSettings.h"
+#include "Utilities/CRC32.h"
+#include "Utilities/HexUtilities.h"
+#include "Utilities/ThreadPool.h"
+#include "Utilities/Timer.h"
+#include "Utilities/magic_enum.hpp"
+
+DisassemblyExporter::DisassemblyExporter(Debugger* debugger, Disassembler* disassembler, LabelManager* labelManager)
+{
+	_debugger = debugger;
+	_disassembler = disassembler;
+	_labelManager = labelManager;
+}
+
+DisassemblyExporter::~DisassemblyExporter()
+{
+}
+
+uint32_t DisassemblyExporter::GetConfigKey()
+{
+	//Settings that change the disassembly's text
+	DebugConfig& cfg = _debugger->GetEmulator()->GetSettings()->GetDebugConfig();
+	return (cfg.UseLowerCaseDisassembly ? 0x01 : 0) | (cfg.SnesUseAltSpcOpNames ? 0x02 : 0);
+}
+
+uint64_t DisassemblyExporter::GetBlockHash(uint32_t start, uint32_t end, uint32_t memSize, CodeDataLogger* cdl, CpuType cpuType)
+{
+	//Includes the bytes/CDL flags around the block: the output depends on where the instruction that
+	//crosses the start of the block begins, and on the operands of the instruction that crosses its end
+	uint32_t hashStart = start - std::min(start, MaxInstructionSize);
+	uint32_t hashEnd = std::min(end + MaxInstructionSize, memSize);
+
+	MemoryDumper* dumper = _debugger->GetMemoryDumper();
+	uint64_t hash = CRC32::GetCRC(dumper->GetMemoryBuffer(_memType) + hashStart, hashEnd - hashStart);
+	hash |= (uint64_t)CRC32::GetCRC(cdl->GetRawData() + hashStart, hashEnd - hashStart) << 32;
+
+	//The CPU addresses shown in the output depend on how the ROM is mapped (e.g banked ROMs)
+	for(uint32_t addr = start; addr < end; addr += 0x1000) {
+		AddressInfo relAddr = _debugger->GetRelativeAddress({ (int32_t)addr, _memType }, cpuType);
+		hash = (hash ^ (uint32_t)relAddr.Address) * 0x100000001B3ULL;
+	}
+	return hash;
+}
+
+void DisassemblyExporter::FindChangedLabels(unordered_map<uint64_t, LabelInfo>& labels, unordered_set<uint64_t>& changedKeys)
+{
+	for(auto& [key, label] : labels) {
+		auto prev = _labels.find(key);
+		if(prev == _labels.end() || prev->second.Label != label.Label || prev->second.Comment != label.Comment) {
+			changedKeys.insert(key);
+		}
+	}
+	for(auto& [key, label] : _labels) {
+		if(labels.find(key) == labels.end()) {
+			changedKeys.insert(key);
+		}
+	}
+}
+
+DisassemblyExportResult DisassemblyExporter::Export(MemoryType memType, string filename, bool forceFullExport)
+{
+	DisassemblyExportResult result = {};
+	Timer timer;
+
+	//Pause emulation while exporting, the ROM/CDL/labels can't change during the export
+	DebugBreakHelper helper(_debugger);
+
+	CodeDataLogger* cdl = _debugger->GetCdlManager()->GetCodeDataLogger(memType);
+	uint32_t memSize = _debugger->GetMemoryDumper()->GetMemorySize(memType);
+	if(!cdl || memSize == 0 || !_debugger->GetMemoryDumper()->GetMemoryBuffer(memType)) {
+		return result;
+	}
+
+	ofstream file(filename, ios::out | ios::binary);
+	if(!file) {
+		return result;
+	}
+
+	CpuType cpuType = DebugUtilities::ToCpuType(memType);
+	uint32_t blockCount = (memSize + BlockSize - 1) / BlockSize;
+	uint32_t configKey = GetConfigKey();
+	if(forceFullExport || memType != _memType || blockCount != _blocks.size() || configKey != _configKey) {
+		_blocks.clear();
+		_blocks.resize(blockCount);
+		_memType = memType;
+		_configKey = configKey;
+	}
+
+	unordered_map<uint64_t, LabelInfo> labels;
+	_labelManager->GetLabels(labels);
+	unordered_set<uint64_t> changedLabels;
+	FindChangedLabels(labels, changedLabels);
+	_labels = std::move(labels);
+
+	vector<uint32_t> dirtyBlocks;
+	for(uint32_t i = 0; i < blockCount; i++) {
+		Block& block = _blocks[i];
+		uint32_t start = i * BlockSize;
+		uint64_t hash = GetBlockHash(start, std::min(start + BlockSize, memSize), memSize, cdl, cpuType);
+
+		bool dirty = !block.Valid || block.DataHash != hash;
+		for(size_t j = 0; !dirty && j < block.LabelKeys.size(); j++) {
+			dirty = changedLabels.find(block.LabelKeys[j]) != changedLabels.end();
+		}
+
+		block.DataHash = hash;
+		if(dirty) {
+			dirtyBlocks.push_back(i);
+		}
+	}
+
+	if(!_pool) {
+		_pool.reset(new ThreadPool());
+	}
+
+	DisassemblerSource& src = _disassembler->GetSource(memType);
+	_pool->ParallelFor((uint32_t)dirtyBlocks.size(), [&](uint32_t i) {
+		uint32_t blockIndex = dirtyBlocks[i];
+		uint32_t start = blockIndex * BlockSize;
+		DisassembleBlock(_blocks[blockIndex], start, std::min(start + BlockSize, memSize), memSize, cdl, src, cpuType);
+	});
+
+	for(Block& block : _blocks) {
+		file.write(block.Output.c_str(), block.Output.size());
+		result.LineCount += block.LineCount;
+	}
+	file.close();
+
+	result.Success = !file.fail();
+	result.BlockCount = blockCount;
+	result.DisassembledBlocks = (uint32_t)dirtyBlocks.size();
+	result.ReusedBlocks = blockCount - result.DisassembledBlocks;
+	result.ElapsedMs = timer.GetElapsedMS();
+	return result;
+}
+
+void DisassemblyExporter::DisassembleBlock(Block& block, uint32_t start, uint32_t end, uint32_t memSize, CodeDataLogger* cdl, DisassemblerSource& src, CpuType cpuType)
+{
+	constexpr int bytesPerRow = 8;
+
+	MemoryDumper* dumper = _debugger->GetMemoryDumper();
+	EmuSettings* settings = _debugger->GetEmulator()->GetSettings();
+	uint8_t* rom = dumper->GetMemoryBuffer(_memType);
+	MemoryType cpuMemType = DebugUtilities::GetCpuMemoryType(cpuType);
+	bool useLowerCase = settings->GetDebugConfig().UseLowerCaseDisassembly;
+
+	vector<uint64_t> labelKeys;
+	LabelManager::SetLookupLog(&labelKeys);
+
+	string& out = block.Output;
+	out.clear();
+	uint32_t lineCount = 0;
+
+	auto toHex = [memSize](uint32_t addr) {
+		return memSize > 0x1000000 ? HexUtilities::ToHex(addr, true) : HexUtilities::ToHex24(addr);
+	};
+
+	out += ";-------------------------------------------------------------------------------\n";
+	out += "; " + string(magic_enum::enum_name(_memType)) + " $" + toHex(start) + "-$" + toHex(end - 1) + "\n";
+	out += ";-------------------------------------------------------------------------------\n";
+	lineCount += 3;
+
+	//Mapping of the previous address, reused as long as the following addresses are mapped contiguously
+	int32_t prevAbsAddr = -1;
+	int32_t prevRelAddr = -1;
+	auto getRelativeAddress = [&](uint32_t absAddr) {
+		if(prevRelAddr >= 0) {
+			int32_t relAddr = prevRelAddr + (int32_t)(absAddr - prevAbsAddr);
+			AddressInfo check = _debugger->GetAbsoluteAddress({ relAddr, cpuMemType });
+			if(check.Address == (int32_t)absAddr && check.Type == _memType) {
+				return relAddr;
+			}
+		}
+		prevAbsAddr = absAddr;
+		prevRelAddr = _debugger->GetRelativeAddress({ (int32_t)absAddr, _memType }, cpuType).Address;
+		return prevRelAddr;
+	};
+
+	auto writeAddress = [&](uint32_t absAddr, int32_t relAddr) {
+		out += toHex(absAddr);
+		out += "  ";
+		string cpuAddr = relAddr >= 0 ? DebugUtilities::AddressToHex(cpuType, relAddr) : string(DebugUtilities::GetProgramCounterSize(cpuType), '-');
+		out += cpuAddr;
+		out += "  ";
+	};
+
+	auto writeLabel = [&](uint32_t absAddr, bool isCode) {
+		LabelInfo labelInfo;
+		if(_labelManager->GetLabelAndComment({ (int32_t)absAddr, _memType }, labelInfo)) {
+			if(isCode && labelInfo.Comment.find('\n') != string::npos) {
+				size_t pos = 0;
+				while(pos != string::npos) {
+					size_t next = labelInfo.Comment.find('\n', pos);
+					out += ";" + labelInfo.Comment.substr(pos, next == string::npos ? string::npos : next - pos) + "\n";
+					lineCount++;
+					pos = next == string::npos ? next : next + 1;
+				}
+				labelInfo.Comment.clear();
+			}
+			if(labelInfo.Label.size()) {
+				out += labelInfo.Label + ":\n";
+				lineCount++;
+			}
+			return labelInfo.Comment;
+		}
+		return string();
+	};
+
+	//Skip the end of an instruction that starts in the previous block
+	uint32_t i = start;
+	for(uint32_t j = 1; j < MaxInstructionSize && j <= start && start < src.Cache.size(); j++) {
+		DisassemblyInfo& prevInfo = src.Cache[start - j];
+		if(prevInfo.IsInitialized() && cdl->IsCode(start - j) && start - j + prevInfo.GetOpSize() > start) {
+			i = start - j + prevInfo.GetOpSize();
+			break;
+		}
+	}
+
+	string text;
+	while(i < end) {
+		if(cdl->IsCode(i)) {
+			DisassemblyInfo info = i < src.Cache.size() ? src.Cache[i] : DisassemblyInfo();
+			if(!info.IsInitialized()) {
+				info.Initialize(i, 0, cpuType, _memType, dumper);
+			}
+			uint32_t opSize = std::min<uint32_t>(std::max<uint8_t>(info.GetOpSize(), 1), memSize - i);
+
+			if(cdl->IsSubEntryPoint(i)) {
+				out += "\n";
+				lineCount++;
+			}
+
+			string comment = writeLabel(i, true);
+			int32_t relAddr = getRelativeAddress(i);
+			writeAddress(i, relAddr);
+
+			string byteCode;
+			for(uint32_t j = 0; j < opSize; j++) {
+				byteCode += HexUtilities::ToHex(rom[i + j]);
+				byteCode += ' ';
+			}
+			byteCode.resize(std::max<size_t>(byteCode.size(), 13), ' ');
+			out += byteCode;
+
+			text.clear();
+			info.GetDisassembly(text, relAddr >= 0 ? relAddr : i, _labelManager, settings);
+			out += text;
+			if(comment.size()) {
+				out += "  ;" + comment;
+			}
+			out += "\n";
+			lineCount++;
+			i += opSize;
+		} else {
+			//Data/unknown bytes, up to 8 per line (a new line is started at each label)
+			string comment = writeLabel(i, false);
+			writeAddress(i, getRelativeAddress(i));
+			out += useLowerCase ? ".db" : ".DB";
+			uint32_t count = 0;
+			do {
+				out += " $" + HexUtilities::ToHex(rom[i]);
+				i++;
+				count++;
+			} while(count < bytesPerRow && i < end && !cdl->IsCode(i) && !_labelManager->HasLabelOrComment({ (int32_t)i, _memType }));
+			if(comment.size()) {
+				out += "  ;" + comment;
+			}
+			out += "\n";
+			lineCount++;
+		}
+	}
+
+	LabelManager::SetLookupLog(nullptr);
+	std::sort(labelKeys.begin(), labelKeys.end());
+	labelKeys.erase(std::unique(labelKeys.begin(), labelKeys.end()), labelKeys.end());
+	block.LabelKeys = std::move(labelKeys);
+	block.LineCount = lineCount;
+	block.Valid = true;
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include "pch.h"
+#include "Debugger/LabelManager.h"
+#include "Debugger/DebugUtilities.h"
+
+class Debugger;
+class Disassembler;
+class CodeDataLogger;
+class ThreadPool;
+struct DisassemblerSource;
+
+struct DisassemblyExportResult
+{
+	bool Success = false;
+	uint32_t BlockCount = 0;
+	uint32_t DisassembledBlocks = 0;
+	uint32_t ReusedBlocks = 0;
+	uint64_t LineCount = 0;
+	double ElapsedMs = 0;
+};
+
+//Exports the disassembly of a whole ROM (e.g PRG ROM) to a text file, based on the CDL data.
+//The ROM is split in 64 KB blocks that are disassembled in parallel. The output of each block
+//is kept along with a hash of its ROM/CDL bytes and the list of labels it looked up, so the next
+//export of the same ROM only disassembles the blocks whose data, CDL or labels changed.
+class DisassemblyExporter
+{
+private:
+	static constexpr uint32_t BlockSize = 0x10000;
+	//Instructions at a block's edges read up to this many bytes from the neighboring blocks
+	static constexpr uint32_t MaxInstructionSize = 8;
+
+	struct Block
+	{
+		bool Valid = false;
+		uint64_t DataHash = 0;
+		vector<uint64_t> LabelKeys; //Sorted keys of every label looked up while disassembling the block
+		string Output;
+		uint32_t LineCount = 0;
+	};
+
+	Debugger* _debugger;
+	Disassembler* _disassembler;
+	LabelManager* _labelManager;
+
+	MemoryType _memType = MemoryType::None;
+	uint32_t _configKey = 0;
+	vector<Block> _blocks;
+	unordered_map<uint64_t, LabelInfo> _labels;
+	unique_ptr<ThreadPool> _pool;
+
+	uint32_t GetConfigKey();
+	uint64_t GetBlockHash(uint32_t start, uint32_t end, uint32_t memSize, CodeDataLogger* cdl, CpuType cpuType);
+	void FindChangedLabels(unordered_map<uint64_t, LabelInfo>& labels, unordered_set<uint64_t>& changedKeys);
+	void DisassembleBlock(Block& block, uint32_t start, uint32_t end, uint32_t memSize, CodeDataLogger* cdl, DisassemblerSource& src, CpuType cpuType);
+
+public:
+	DisassemblyExporter(Debugger* debugger, Disassembler* disassembler, LabelManager* labelManager);
+	~DisassemblyExporter();
+
+	//memType must be a ROM memory type with a code data logger (e.g SnesPrgRom)
+	DisassemblyExportResult Export(MemoryType memType, string filename, bool forceFullExport = false);
+};
@@ -45,6 +45,16 @@ void DisassemblyInfo::Initialize(uint32_t cpuAddress, uint8_t cpuFlags, CpuType
 	_initialized = true;
 }
 
+void DisassemblyInfo::Initialize(uint8_t* byteCode, uint8_t opSize, uint8_t cpuFlags, CpuType cpuType)
+{
+	_cpuType = cpuType;
+	_flags = cpuFlags;
+	_opSize = std::min<uint8_t>(opSize, sizeof(_byteCode));
+	memset(_byteCode, 0, sizeof(_byteCode));
+	memcpy(_byteCode, byteCode, _opSize);
+	_initialized = true;
+}
+
 bool DisassemblyInfo::IsInitialized()
 {
 	return _initialized;
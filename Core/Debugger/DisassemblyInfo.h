@@ -46,6 +46,7 @@ public:
 	DisassemblyInfo(uint32_t cpuAddress, uint8_t cpuFlags, CpuType cpuType, MemoryType memType, MemoryDumper* memoryDumper);
 
 	void Initialize(uint32_t cpuAddress, uint8_t cpuFlags, CpuType cpuType, MemoryType memType, MemoryDumper* memoryDumper);
+	void Initialize(uint8_t* byteCode, uint8_t opSize, uint8_t cpuFlags, CpuType cpuType);
 	bool IsInitialized();
 	bool IsValid(uint8_t cpuFlags);
 	void Reset();
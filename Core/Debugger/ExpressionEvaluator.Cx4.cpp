@@ -81,4 +81,36 @@ int64_t ExpressionEvaluator::GetCx4TokenValue(int64_t token, EvalResultType& res
 
 		default: return 0;
 	}
+}
+
+ExpressionRegisterAccessor ExpressionEvaluator::GetCx4RegisterAccessor(int64_t token)
+{
+	switch(token) {
+		case EvalValues::R0: return [](BaseState& state) -> int64_t { Cx4State& s = (Cx4State&)state; return s.Regs[0]; };
+		case EvalValues::R1: return [](BaseState& state) -> int64_t { Cx4State& s = (Cx4State&)state; return s.Regs[1]; };
+		case EvalValues::R2: return [](BaseState& state) -> int64_t { Cx4State& s = (Cx4State&)state; return s.Regs[2]; };
+		case EvalValues::R3: return [](BaseState& state) -> int64_t { Cx4State& s = (Cx4State&)state; return s.Regs[3]; };
+		case EvalValues::R4: return [](BaseState& state) -> int64_t { Cx4State& s = (Cx4State&)state; return s.Regs[4]; };
+		case EvalValues::R5: return [](BaseState& state) -> int64_t { Cx4State& s = (Cx4State&)state; return s.Regs[5]; };
+		case EvalValues::R6: return [](BaseState& state) -> int64_t { Cx4State& s = (Cx4State&)state; return s.Regs[6]; };
+		case EvalValues::R7: return [](BaseState& state) -> int64_t { Cx4State& s = (Cx4State&)state; return s.Regs[7]; };
+		case EvalValues::R8: return [](BaseState& state) -> int64_t { Cx4State& s = (Cx4State&)state; return s.Regs[8]; };
+		case EvalValues::R9: return [](BaseState& state) -> int64_t { Cx4State& s = (Cx4State&)state; return s.Regs[9]; };
+		case EvalValues::R10: return [](BaseState& state) -> int64_t { Cx4State& s = (Cx4State&)state; return s.Regs[10]; };
+		case EvalValues::R11: return [](BaseState& state) -> int64_t { Cx4State& s = (Cx4State&)state; return s.Regs[11]; };
+		case EvalValues::R12: return [](BaseState& state) -> int64_t { Cx4State& s = (Cx4State&)state; return s.Regs[12]; };
+		case EvalValues::R13: return [](BaseState& state) -> int64_t { Cx4State& s = (Cx4State&)state; return s.Regs[13]; };
+		case EvalValues::R14: return [](BaseState& state) -> int64_t { Cx4State& s = (Cx4State&)state; return s.Regs[14]; };
+		case EvalValues::R15: return [](BaseState& state) -> int64_t { Cx4State& s = (Cx4State&)state; return s.Regs[15]; };
+		case EvalValues::RegPB: return [](BaseState& state) -> int64_t { Cx4State& s = (Cx4State&)state; return s.PB; };
+		case EvalValues::RegPC: return [](BaseState& state) -> int64_t { Cx4State& s = (Cx4State&)state; return s.PC; };
+		case EvalValues::RegA: return [](BaseState& state) -> int64_t { Cx4State& s = (Cx4State&)state; return s.A; };
+		case EvalValues::RegP: return [](BaseState& state) -> int64_t { Cx4State& s = (Cx4State&)state; return s.P; };
+		case EvalValues::RegSP: return [](BaseState& state) -> int64_t { Cx4State& s = (Cx4State&)state; return s.SP; };
+		case EvalValues::RegMult: return [](BaseState& state) -> int64_t { Cx4State& s = (Cx4State&)state; return s.Mult; };
+		case EvalValues::RegMDR: return [](BaseState& state) -> int64_t { Cx4State& s = (Cx4State&)state; return s.MemoryDataReg; };
+		case EvalValues::RegMAR: return [](BaseState& state) -> int64_t { Cx4State& s = (Cx4State&)state; return s.MemoryAddressReg; };
+		case EvalValues::RegDPR: return [](BaseState& state) -> int64_t { Cx4State& s = (Cx4State&)state; return s.DataPointerReg; };
+		default: return nullptr;
+	}
 }
\ No newline at end of file
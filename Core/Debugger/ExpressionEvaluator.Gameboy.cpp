@@ -60,4 +60,25 @@ int64_t ExpressionEvaluator::GetGameboyTokenValue(int64_t token, EvalResultType&
 
 		default: return 0;
 	}
+}
+
+ExpressionRegisterAccessor ExpressionEvaluator::GetGameboyRegisterAccessor(int64_t token)
+{
+	switch(token) {
+		case EvalValues::RegA: return [](BaseState& state) -> int64_t { GbCpuState& s = (GbCpuState&)state; return s.A; };
+		case EvalValues::RegB: return [](BaseState& state) -> int64_t { GbCpuState& s = (GbCpuState&)state; return s.B; };
+		case EvalValues::RegC: return [](BaseState& state) -> int64_t { GbCpuState& s = (GbCpuState&)state; return s.C; };
+		case EvalValues::RegD: return [](BaseState& state) -> int64_t { GbCpuState& s = (GbCpuState&)state; return s.D; };
+		case EvalValues::RegE: return [](BaseState& state) -> int64_t { GbCpuState& s = (GbCpuState&)state; return s.E; };
+		case EvalValues::RegF: return [](BaseState& state) -> int64_t { GbCpuState& s = (GbCpuState&)state; return s.Flags; };
+		case EvalValues::RegH: return [](BaseState& state) -> int64_t { GbCpuState& s = (GbCpuState&)state; return s.H; };
+		case EvalValues::RegL: return [](BaseState& state) -> int64_t { GbCpuState& s = (GbCpuState&)state; return s.L; };
+		case EvalValues::RegAF: return [](BaseState& state) -> int64_t { GbCpuState& s = (GbCpuState&)state; return (s.A << 8) | s.Flags; };
+		case EvalValues::RegBC: return [](BaseState& state) -> int64_t { GbCpuState& s = (GbCpuState&)state; return (s.B << 8) | s.C; };
+		case EvalValues::RegDE: return [](BaseState& state) -> int64_t { GbCpuState& s = (GbCpuState&)state; return (s.D << 8) | s.E; };
+		case EvalValues::RegHL: return [](BaseState& state) -> int64_t { GbCpuState& s = (GbCpuState&)state; return (s.H << 8) | s.L; };
+		case EvalValues::RegSP: return [](BaseState& state) -> int64_t { GbCpuState& s = (GbCpuState&)state; return s.SP; };
+		case EvalValues::RegPC: return [](BaseState& state) -> int64_t { GbCpuState& s = (GbCpuState&)state; return s.PC; };
+		default: return nullptr;
+	}
 }
\ No newline at end of file
@@ -64,4 +64,33 @@ int64_t ExpressionEvaluator::GetGsuTokenValue(int64_t token, EvalResultType& res
 
 		default: return 0;
 	}
+}
+
+ExpressionRegisterAccessor ExpressionEvaluator::GetGsuRegisterAccessor(int64_t token)
+{
+	switch(token) {
+		case EvalValues::R0: return [](BaseState& state) -> int64_t { GsuState& s = (GsuState&)state; return s.R[0]; };
+		case EvalValues::R1: return [](BaseState& state) -> int64_t { GsuState& s = (GsuState&)state; return s.R[1]; };
+		case EvalValues::R2: return [](BaseState& state) -> int64_t { GsuState& s = (GsuState&)state; return s.R[2]; };
+		case EvalValues::R3: return [](BaseState& state) -> int64_t { GsuState& s = (GsuState&)state; return s.R[3]; };
+		case EvalValues::R4: return [](BaseState& state) -> int64_t { GsuState& s = (GsuState&)state; return s.R[4]; };
+		case EvalValues::R5: return [](BaseState& state) -> int64_t { GsuState& s = (GsuState&)state; return s.R[5]; };
+		case EvalValues::R6: return [](BaseState& state) -> int64_t { GsuState& s = (GsuState&)state; return s.R[6]; };
+		case EvalValues::R7: return [](BaseState& state) -> int64_t { GsuState& s = (GsuState&)state; return s.R[7]; };
+		case EvalValues::R8: return [](BaseState& state) -> int64_t { GsuState& s = (GsuState&)state; return s.R[8]; };
+		case EvalValues::R9: return [](BaseState& state) -> int64_t { GsuState& s = (GsuState&)state; return s.R[9]; };
+		case EvalValues::R10: return [](BaseState& state) -> int64_t { GsuState& s = (GsuState&)state; return s.R[10]; };
+		case EvalValues::R11: return [](BaseState& state) -> int64_t { GsuState& s = (GsuState&)state; return s.R[11]; };
+		case EvalValues::R12: return [](BaseState& state) -> int64_t { GsuState& s = (GsuState&)state; return s.R[12]; };
+		case EvalValues::R13: return [](BaseState& state) -> int64_t { GsuState& s = (GsuState&)state; return s.R[13]; };
+		case EvalValues::R14: return [](BaseState& state) -> int64_t { GsuState& s = (GsuState&)state; return s.R[14]; };
+		case EvalValues::R15: return [](BaseState& state) -> int64_t { GsuState& s = (GsuState&)state; return s.R[15]; };
+		case EvalValues::SrcReg: return [](BaseState& state) -> int64_t { GsuState& s = (GsuState&)state; return s.SrcReg; };
+		case EvalValues::DstReg: return [](BaseState& state) -> int64_t { GsuState& s = (GsuState&)state; return s.DestReg; };
+		case EvalValues::SFR: return [](BaseState& state) -> int64_t { GsuState& s = (GsuState&)state; return (s.SFR.GetFlagsHigh() << 8) | s.SFR.GetFlagsLow(); };
+		case EvalValues::PBR: return [](BaseState& state) -> int64_t { GsuState& s = (GsuState&)state; return s.ProgramBank; };
+		case EvalValues::RomBR: return [](BaseState& state) -> int64_t { GsuState& s = (GsuState&)state; return s.RomBank; };
+		case EvalValues::RamBR: return [](BaseState& state) -> int64_t { GsuState& s = (GsuState&)state; return s.RamBank; };
+		default: return nullptr;
+	}
 }
\ No newline at end of file
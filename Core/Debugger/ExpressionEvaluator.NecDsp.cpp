@@ -45,4 +45,25 @@ int64_t ExpressionEvaluator::GetNecDspTokenValue(int64_t token, EvalResultType&
 		case EvalValues::RegPC: return s.PC;
 		default: return 0;
 	}
+}
+
+ExpressionRegisterAccessor ExpressionEvaluator::GetNecDspRegisterAccessor(int64_t token)
+{
+	switch(token) {
+		case EvalValues::RegA: return [](BaseState& state) -> int64_t { NecDspState& s = (NecDspState&)state; return s.A; };
+		case EvalValues::RegB: return [](BaseState& state) -> int64_t { NecDspState& s = (NecDspState&)state; return s.B; };
+		case EvalValues::RegTR: return [](BaseState& state) -> int64_t { NecDspState& s = (NecDspState&)state; return s.TR; };
+		case EvalValues::RegTRB: return [](BaseState& state) -> int64_t { NecDspState& s = (NecDspState&)state; return s.TRB; };
+		case EvalValues::RegRP: return [](BaseState& state) -> int64_t { NecDspState& s = (NecDspState&)state; return s.RP; };
+		case EvalValues::RegDP: return [](BaseState& state) -> int64_t { NecDspState& s = (NecDspState&)state; return s.DP; };
+		case EvalValues::RegDR: return [](BaseState& state) -> int64_t { NecDspState& s = (NecDspState&)state; return s.DR; };
+		case EvalValues::RegSR: return [](BaseState& state) -> int64_t { NecDspState& s = (NecDspState&)state; return s.SR; };
+		case EvalValues::RegK: return [](BaseState& state) -> int64_t { NecDspState& s = (NecDspState&)state; return s.K; };
+		case EvalValues::RegL: return [](BaseState& state) -> int64_t { NecDspState& s = (NecDspState&)state; return s.L; };
+		case EvalValues::RegM: return [](BaseState& state) -> int64_t { NecDspState& s = (NecDspState&)state; return s.M; };
+		case EvalValues::RegN: return [](BaseState& state) -> int64_t { NecDspState& s = (NecDspState&)state; return s.N; };
+		case EvalValues::RegSP: return [](BaseState& state) -> int64_t { NecDspState& s = (NecDspState&)state; return s.SP; };
+		case EvalValues::RegPC: return [](BaseState& state) -> int64_t { NecDspState& s = (NecDspState&)state; return s.PC; };
+		default: return nullptr;
+	}
 }
\ No newline at end of file
@@ -72,4 +72,17 @@ int64_t ExpressionEvaluator::GetNesTokenValue(int64_t token, EvalResultType& res
 
 		default: return 0;
 	}
+}
+
+ExpressionRegisterAccessor ExpressionEvaluator::GetNesRegisterAccessor(int64_t token)
+{
+	switch(token) {
+		case EvalValues::RegA: return [](BaseState& state) -> int64_t { NesCpuState& s = (NesCpuState&)state; return s.A; };
+		case EvalValues::RegX: return [](BaseState& state) -> int64_t { NesCpuState& s = (NesCpuState&)state; return s.X; };
+		case EvalValues::RegY: return [](BaseState& state) -> int64_t { NesCpuState& s = (NesCpuState&)state; return s.Y; };
+		case EvalValues::RegSP: return [](BaseState& state) -> int64_t { NesCpuState& s = (NesCpuState&)state; return s.SP; };
+		case EvalValues::RegPS: return [](BaseState& state) -> int64_t { NesCpuState& s = (NesCpuState&)state; return s.PS; };
+		case EvalValues::RegPC: return [](BaseState& state) -> int64_t { NesCpuState& s = (NesCpuState&)state; return s.PC; };
+		default: return nullptr;
+	}
 }
\ No newline at end of file
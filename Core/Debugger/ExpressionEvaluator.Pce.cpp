@@ -87,3 +87,16 @@ int64_t ExpressionEvaluator::GetPceTokenValue(int64_t token, EvalResultType& res
 		default: return 0;
 	}
 }
+
+ExpressionRegisterAccessor ExpressionEvaluator::GetPceRegisterAccessor(int64_t token)
+{
+	switch(token) {
+		case EvalValues::RegA: return [](BaseState& state) -> int64_t { PceCpuState& s = (PceCpuState&)state; return s.A; };
+		case EvalValues::RegX: return [](BaseState& state) -> int64_t { PceCpuState& s = (PceCpuState&)state; return s.X; };
+		case EvalValues::RegY: return [](BaseState& state) -> int64_t { PceCpuState& s = (PceCpuState&)state; return s.Y; };
+		case EvalValues::RegSP: return [](BaseState& state) -> int64_t { PceCpuState& s = (PceCpuState&)state; return s.SP; };
+		case EvalValues::RegPS: return [](BaseState& state) -> int64_t { PceCpuState& s = (PceCpuState&)state; return s.PS; };
+		case EvalValues::RegPC: return [](BaseState& state) -> int64_t { PceCpuState& s = (PceCpuState&)state; return s.PC; };
+		default: return nullptr;
+	}
+}
\ No newline at end of file
@@ -103,4 +103,41 @@ int64_t ExpressionEvaluator::GetSmsTokenValue(int64_t token, EvalResultType& res
 
 		default: return 0;
 	}
+}
+
+ExpressionRegisterAccessor ExpressionEvaluator::GetSmsRegisterAccessor(int64_t token)
+{
+	switch(token) {
+		case EvalValues::RegA: return [](BaseState& state) -> int64_t { SmsCpuState& s = (SmsCpuState&)state; return s.A; };
+		case EvalValues::RegB: return [](BaseState& state) -> int64_t { SmsCpuState& s = (SmsCpuState&)state; return s.B; };
+		case EvalValues::RegC: return [](BaseState& state) -> int64_t { SmsCpuState& s = (SmsCpuState&)state; return s.C; };
+		case EvalValues::RegD: return [](BaseState& state) -> int64_t { SmsCpuState& s = (SmsCpuState&)state; return s.D; };
+		case EvalValues::RegE: return [](BaseState& state) -> int64_t { SmsCpuState& s = (SmsCpuState&)state; return s.E; };
+		case EvalValues::RegF: return [](BaseState& state) -> int64_t { SmsCpuState& s = (SmsCpuState&)state; return s.Flags; };
+		case EvalValues::RegH: return [](BaseState& state) -> int64_t { SmsCpuState& s = (SmsCpuState&)state; return s.H; };
+		case EvalValues::RegL: return [](BaseState& state) -> int64_t { SmsCpuState& s = (SmsCpuState&)state; return s.L; };
+		case EvalValues::RegAF: return [](BaseState& state) -> int64_t { SmsCpuState& s = (SmsCpuState&)state; return (s.A << 8) | s.Flags; };
+		case EvalValues::RegBC: return [](BaseState& state) -> int64_t { SmsCpuState& s = (SmsCpuState&)state; return (s.B << 8) | s.C; };
+		case EvalValues::RegDE: return [](BaseState& state) -> int64_t { SmsCpuState& s = (SmsCpuState&)state; return (s.D << 8) | s.E; };
+		case EvalValues::RegHL: return [](BaseState& state) -> int64_t { SmsCpuState& s = (SmsCpuState&)state; return (s.H << 8) | s.L; };
+		case EvalValues::RegAltA: return [](BaseState& state) -> int64_t { SmsCpuState& s = (SmsCpuState&)state; return s.AltA; };
+		case EvalValues::RegAltB: return [](BaseState& state) -> int64_t { SmsCpuState& s = (SmsCpuState&)state; return s.AltB; };
+		case EvalValues::RegAltC: return [](BaseState& state) -> int64_t { SmsCpuState& s = (SmsCpuState&)state; return s.AltC; };
+		case EvalValues::RegAltD: return [](BaseState& state) -> int64_t { SmsCpuState& s = (SmsCpuState&)state; return s.AltD; };
+		case EvalValues::RegAltE: return [](BaseState& state) -> int64_t { SmsCpuState& s = (SmsCpuState&)state; return s.AltE; };
+		case EvalValues::RegAltF: return [](BaseState& state) -> int64_t { SmsCpuState& s = (SmsCpuState&)state; return s.AltFlags; };
+		case EvalValues::RegAltH: return [](BaseState& state) -> int64_t { SmsCpuState& s = (SmsCpuState&)state; return s.AltH; };
+		case EvalValues::RegAltL: return [](BaseState& state) -> int64_t { SmsCpuState& s = (SmsCpuState&)state; return s.AltL; };
+		case EvalValues::RegAltAF: return [](BaseState& state) -> int64_t { SmsCpuState& s = (SmsCpuState&)state; return (s.AltA << 8) | s.AltFlags; };
+		case EvalValues::RegAltBC: return [](BaseState& state) -> int64_t { SmsCpuState& s = (SmsCpuState&)state; return (s.AltB << 8) | s.AltC; };
+		case EvalValues::RegAltDE: return [](BaseState& state) -> int64_t { SmsCpuState& s = (SmsCpuState&)state; return (s.AltD << 8) | s.AltE; };
+		case EvalValues::RegAltHL: return [](BaseState& state) -> int64_t { SmsCpuState& s = (SmsCpuState&)state; return (s.AltH << 8) | s.AltL; };
+		case EvalValues::RegIX: return [](BaseState& state) -> int64_t { SmsCpuState& s = (SmsCpuState&)state; return (s.IXH << 8) | s.IXL; };
+		case EvalValues::RegIY: return [](BaseState& state) -> int64_t { SmsCpuState& s = (SmsCpuState&)state; return (s.IYH << 8) | s.IYL; };
+		case EvalValues::RegI: return [](BaseState& state) -> int64_t { SmsCpuState& s = (SmsCpuState&)state; return s.I; };
+		case EvalValues::RegR: return [](BaseState& state) -> int64_t { SmsCpuState& s = (SmsCpuState&)state; return s.R; };
+		case EvalValues::RegSP: return [](BaseState& state) -> int64_t { SmsCpuState& s = (SmsCpuState&)state; return s.SP; };
+		case EvalValues::RegPC: return [](BaseState& state) -> int64_t { SmsCpuState& s = (SmsCpuState&)state; return s.PC; };
+		default: return nullptr;
+	}
 }
\ No newline at end of file
@@ -70,4 +70,19 @@ int64_t ExpressionEvaluator::GetSnesTokenValue(int64_t token, EvalResultType& re
 
 		default: return 0;
 	}
+}
+
+ExpressionRegisterAccessor ExpressionEvaluator::GetSnesRegisterAccessor(int64_t token)
+{
+	switch(token) {
+		case EvalValues::RegA: return [](BaseState& state) -> int64_t { SnesCpuState& s = (SnesCpuState&)state; return s.A; };
+		case EvalValues::RegX: return [](BaseState& state) -> int64_t { SnesCpuState& s = (SnesCpuState&)state; return s.X; };
+		case EvalValues::RegY: return [](BaseState& state) -> int64_t { SnesCpuState& s = (SnesCpuState&)state; return s.Y; };
+		case EvalValues::RegSP: return [](BaseState& state) -> int64_t { SnesCpuState& s = (SnesCpuState&)state; return s.SP; };
+		case EvalValues::RegPS: return [](BaseState& state) -> int64_t { SnesCpuState& s = (SnesCpuState&)state; return s.PS; };
+		case EvalValues::RegDB: return [](BaseState& state) -> int64_t { SnesCpuState& s = (SnesCpuState&)state; return s.DBR; };
+		case EvalValues::RegD: return [](BaseState& state) -> int64_t { SnesCpuState& s = (SnesCpuState&)state; return s.D; };
+		case EvalValues::RegPC: return [](BaseState& state) -> int64_t { SnesCpuState& s = (SnesCpuState&)state; return (s.K << 16) | s.PC; };
+		default: return nullptr;
+	}
 }
\ No newline at end of file
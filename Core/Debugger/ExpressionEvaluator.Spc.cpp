@@ -31,4 +31,18 @@ int64_t ExpressionEvaluator::GetSpcTokenValue(int64_t token, EvalResultType& res
 		case EvalValues::SpcDspReg: return s.DspReg;
 		default: return 0;
 	}
+}
+
+ExpressionRegisterAccessor ExpressionEvaluator::GetSpcRegisterAccessor(int64_t token)
+{
+	switch(token) {
+		case EvalValues::RegA: return [](BaseState& state) -> int64_t { SpcState& s = (SpcState&)state; return s.A; };
+		case EvalValues::RegX: return [](BaseState& state) -> int64_t { SpcState& s = (SpcState&)state; return s.X; };
+		case EvalValues::RegY: return [](BaseState& state) -> int64_t { SpcState& s = (SpcState&)state; return s.Y; };
+		case EvalValues::RegSP: return [](BaseState& state) -> int64_t { SpcState& s = (SpcState&)state; return s.SP; };
+		case EvalValues::RegPS: return [](BaseState& state) -> int64_t { SpcState& s = (SpcState&)state; return s.PS; };
+		case EvalValues::RegPC: return [](BaseState& state) -> int64_t { SpcState& s = (SpcState&)state; return s.PC; };
+		case EvalValues::SpcDspReg: return [](BaseState& state) -> int64_t { SpcState& s = (SpcState&)state; return s.DspReg; };
+		default: return nullptr;
+	}
 }
\ No newline at end of file
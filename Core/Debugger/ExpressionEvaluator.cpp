@@ -356,7 +356,274 @@ bool ExpressionEvaluator::ToRpn(string expression, ExpressionData &data)
 	return true;
 }
 
+bool ExpressionEvaluator::GetLabelValue(ExpressionData& data, int64_t labelIndex, int64_t& value, EvalResultType& resultType)
+{
+	if((size_t)labelIndex < data.Labels.size()) {
+		value = _labelManager->GetLabelRelativeAddress(data.Labels[(uint32_t)labelIndex], _cpuType);
+	} else {
+		value = -2;
+	}
+	if(value < 0) {
+		//Label is no longer valid
+		resultType = value == -1 ? EvalResultType::OutOfScope : EvalResultType::Invalid;
+		return false;
+	}
+	return true;
+}
+
+int64_t ExpressionEvaluator::GetTokenValue(int64_t token, EvalResultType& resultType, MemoryOperationInfo& operationInfo, AddressInfo& addressInfo)
+{
+	switch(token) {
+		case EvalValues::Value: return operationInfo.Value;
+		case EvalValues::Address: return operationInfo.Address;
+		case EvalValues::MemoryAddress: return addressInfo.Address;
+		case EvalValues::IsWrite: return operationInfo.Type == MemoryOperationType::Write || operationInfo.Type == MemoryOperationType::DmaWrite || operationInfo.Type == MemoryOperationType::DummyWrite;
+		case EvalValues::IsRead: return operationInfo.Type != MemoryOperationType::Write && operationInfo.Type != MemoryOperationType::DmaWrite && operationInfo.Type != MemoryOperationType::DummyWrite;
+		case EvalValues::IsDma: return operationInfo.Type == MemoryOperationType::DmaRead || operationInfo.Type == MemoryOperationType::DmaWrite;
+		case EvalValues::IsDummy: return operationInfo.Type == MemoryOperationType::DummyRead|| operationInfo.Type == MemoryOperationType::DummyWrite;
+		case EvalValues::OpProgramCounter: return _cpuDebugger->GetProgramCounter(true);
+
+		default:
+			if(!_cpuDebugger) {
+				return 0;
+			}
+
+			switch(_cpuType) {
+				case CpuType::Snes: return GetSnesTokenValue(token, resultType);
+				case CpuType::Spc: return GetSpcTokenValue(token, resultType);
+				case CpuType::NecDsp: return GetNecDspTokenValue(token, resultType);
+				case CpuType::Sa1: return GetSnesTokenValue(token, resultType);
+				case CpuType::Gsu: return GetGsuTokenValue(token, resultType);
+				case CpuType::Cx4: return GetCx4TokenValue(token, resultType);
+				case CpuType::Gameboy: return GetGameboyTokenValue(token, resultType);
+				case CpuType::Nes: return GetNesTokenValue(token, resultType);
+				case CpuType::Pce: return GetPceTokenValue(token, resultType);
+				case CpuType::Sms: return GetSmsTokenValue(token, resultType);
+				case CpuType::Gba: return GetGbaTokenValue(token, resultType);
+			}
+			return token;
+	}
+}
+
+ExpressionRegisterAccessor ExpressionEvaluator::GetRegisterAccessor(int64_t token)
+{
+	switch(_cpuType) {
+		case CpuType::Snes: return GetSnesRegisterAccessor(token);
+		case CpuType::Spc: return GetSpcRegisterAccessor(token);
+		case CpuType::NecDsp: return GetNecDspRegisterAccessor(token);
+		case CpuType::Sa1: return GetSnesRegisterAccessor(token);
+		case CpuType::Gsu: return GetGsuRegisterAccessor(token);
+		case CpuType::Cx4: return GetCx4RegisterAccessor(token);
+		case CpuType::Gameboy: return GetGameboyRegisterAccessor(token);
+		case CpuType::Nes: return GetNesRegisterAccessor(token);
+		case CpuType::Pce: return GetPceRegisterAccessor(token);
+		case CpuType::Sms: return GetSmsRegisterAccessor(token);
+		case CpuType::Gba: return GetGbaRegisterAccessor(token);
+	}
+	return nullptr;
+}
+
+void ExpressionEvaluator::Compile(ExpressionData &data)
+{
+	//Turns the RPN list into a list of typed instructions for Execute():
+	//-Register tokens are resolved to direct accessors for this CPU's state
+	//-Operators on constants are folded, and memory reads at constant addresses use a single instruction
+	//Anything Compile() can't prove valid is left to the interpreter (empty program), which keeps its exact behavior
+	vector<ExpressionInstruction> program;
+	program.reserve(data.RpnQueue.size());
+	bool usesCpuState = false;
+	int depth = 0;
+
+	auto isConstant = [&](size_t count) {
+		if(program.size() < count) {
+			return false;
+		}
+		for(size_t i = program.size() - count; i < program.size(); i++) {
+			if(program[i].Op != ExpressionOpCode::Constant) {
+				return false;
+			}
+		}
+		return true;
+	};
+
+	for(int64_t token : data.RpnQueue) {
+		if(token >= EvalValues::RegA) {
+			ExpressionInstruction inst = { ExpressionOpCode::ReadToken, token, nullptr };
+			if(token >= EvalValues::FirstLabelIndex) {
+				inst = { ExpressionOpCode::ReadLabel, token - EvalValues::FirstLabelIndex, nullptr };
+			} else if(_cpuDebugger) {
+				inst.Accessor = GetRegisterAccessor(token);
+				if(inst.Accessor) {
+					inst.Op = ExpressionOpCode::ReadRegister;
+					usesCpuState = true;
+				}
+			}
+			program.push_back(inst);
+			depth++;
+		} else if(token >= EvalOperators::Multiplication) {
+			if(token > EvalOperators::Braces) {
+				return;
+			}
+
+			bool isBinary = token <= EvalOperators::LogicalOr;
+			if(depth < (isBinary ? 2 : 1)) {
+				return;
+			}
+
+			ExpressionOpCode op = (ExpressionOpCode)((int)ExpressionOpCode::Multiplication + (token - EvalOperators::Multiplication));
+			if(isBinary) {
+				depth--;
+				//Divisions by 0 (and -1, which can overflow) are left to Execute()
+				bool isDivision = op == ExpressionOpCode::Division || op == ExpressionOpCode::Modulo;
+				if(isConstant(2) && !(isDivision && (program.back().Value == 0 || program.back().Value == -1))) {
+					int64_t right = program.back().Value;
+					program.pop_back();
+					int64_t& left = program.back().Value;
+					switch(op) {
+						case ExpressionOpCode::Multiplication: left = left * right; break;
+						case ExpressionOpCode::Division: left = left / right; break;
+						case ExpressionOpCode::Modulo: left = left % right; break;
+						case ExpressionOpCode::Addition: left = left + right; break;
+						case ExpressionOpCode::Substration: left = left - right; break;
+						case ExpressionOpCode::ShiftLeft: left = left << right; break;
+						case ExpressionOpCode::ShiftRight: left = left >> right; break;
+						case ExpressionOpCode::SmallerThan: left = left < right; break;
+						case ExpressionOpCode::SmallerOrEqual: left = left <= right; break;
+						case ExpressionOpCode::GreaterThan: left = left > right; break;
+						case ExpressionOpCode::GreaterOrEqual: left = left >= right; break;
+						case ExpressionOpCode::Equal: left = left == right; break;
+						case ExpressionOpCode::NotEqual: left = left != right; break;
+						case ExpressionOpCode::BinaryAnd: left = left & right; break;
+						case ExpressionOpCode::BinaryXor: left = left ^ right; break;
+						case ExpressionOpCode::BinaryOr: left = left | right; break;
+						case ExpressionOpCode::LogicalAnd: left = (bool)(left && right); break;
+						case ExpressionOpCode::LogicalOr: left = (bool)(left || right); break;
+						default: break;
+					}
+					continue;
+				}
+			} else if(isConstant(1)) {
+				int64_t& value = program.back().Value;
+				switch(op) {
+					case ExpressionOpCode::Plus: continue;
+					case ExpressionOpCode::Minus: value = -value; continue;
+					case ExpressionOpCode::BinaryNot: value = ~value; continue;
+					case ExpressionOpCode::LogicalNot: value = (bool)!value; continue;
+
+					//Memory reads are never folded, but the address can be part of the instruction
+					case ExpressionOpCode::ReadDword: program.back().Op = ExpressionOpCode::ReadDwordAt; continue;
+					case ExpressionOpCode::ReadByte: program.back().Op = ExpressionOpCode::ReadByteAt; continue;
+					case ExpressionOpCode::ReadWord: program.back().Op = ExpressionOpCode::ReadWordAt; continue;
+					default: break;
+				}
+			}
+			program.push_back({ op, 0, nullptr });
+		} else {
+			program.push_back({ ExpressionOpCode::Constant, token, nullptr });
+			depth++;
+		}
+
+		if(depth >= 100) {
+			return;
+		}
+	}
+
+	if(depth != 1) {
+		return;
+	}
+
+	int64_t lastToken = data.RpnQueue.back();
+	data.HasResultType = lastToken >= EvalOperators::Multiplication && lastToken < EvalValues::RegA;
+	if(data.HasResultType) {
+		bool isBoolean = (lastToken >= EvalOperators::SmallerThan && lastToken <= EvalOperators::NotEqual) || lastToken == EvalOperators::LogicalAnd || lastToken == EvalOperators::LogicalOr;
+		data.ResultType = isBoolean ? EvalResultType::Boolean : EvalResultType::Numeric;
+	}
+	data.UsesCpuState = usesCpuState;
+	data.Program = std::move(program);
+}
+
+int64_t ExpressionEvaluator::Execute(ExpressionData &data, EvalResultType &resultType, MemoryOperationInfo &operationInfo, AddressInfo& addressInfo)
+{
+	int64_t stack[100];
+	int pos = 0;
+	BaseState* state = data.UsesCpuState ? &_cpuDebugger->GetState() : nullptr;
+	MemoryDumper* memoryDumper = _debugger->GetMemoryDumper();
+	resultType = EvalResultType::Numeric;
+
+	for(ExpressionInstruction& inst : data.Program) {
+		switch(inst.Op) {
+			case ExpressionOpCode::Constant: stack[pos++] = inst.Value; break;
+			case ExpressionOpCode::ReadRegister: stack[pos++] = inst.Accessor(*state); break;
+			case ExpressionOpCode::ReadToken: stack[pos++] = GetTokenValue(inst.Value, resultType, operationInfo, addressInfo); break;
+			case ExpressionOpCode::ReadLabel:
+				if(!GetLabelValue(data, inst.Value, stack[pos++], resultType)) {
+					return 0;
+				}
+				break;
+
+			case ExpressionOpCode::Multiplication: pos--; stack[pos - 1] = stack[pos - 1] * stack[pos]; break;
+			case ExpressionOpCode::Division:
+				pos--;
+				if(stack[pos] == 0) {
+					resultType = EvalResultType::DivideBy0;
+					return 0;
+				}
+				stack[pos - 1] = stack[pos - 1] / stack[pos];
+				break;
+			case ExpressionOpCode::Modulo:
+				pos--;
+				if(stack[pos] == 0) {
+					resultType = EvalResultType::DivideBy0;
+					return 0;
+				}
+				stack[pos - 1] = stack[pos - 1] % stack[pos];
+				break;
+			case ExpressionOpCode::Addition: pos--; stack[pos - 1] = stack[pos - 1] + stack[pos]; break;
+			case ExpressionOpCode::Substration: pos--; stack[pos - 1] = stack[pos - 1] - stack[pos]; break;
+			case ExpressionOpCode::ShiftLeft: pos--; stack[pos - 1] = stack[pos - 1] << stack[pos]; break;
+			case ExpressionOpCode::ShiftRight: pos--; stack[pos - 1] = stack[pos - 1] >> stack[pos]; break;
+			case ExpressionOpCode::SmallerThan: pos--; stack[pos - 1] = stack[pos - 1] < stack[pos]; break;
+			case ExpressionOpCode::SmallerOrEqual: pos--; stack[pos - 1] = stack[pos - 1] <= stack[pos]; break;
+			case ExpressionOpCode::GreaterThan: pos--; stack[pos - 1] = stack[pos - 1] > stack[pos]; break;
+			case ExpressionOpCode::GreaterOrEqual: pos--; stack[pos - 1] = stack[pos - 1] >= stack[pos]; break;
+			case ExpressionOpCode::Equal: pos--; stack[pos - 1] = stack[pos - 1] == stack[pos]; break;
+			case ExpressionOpCode::NotEqual: pos--; stack[pos - 1] = stack[pos - 1] != stack[pos]; break;
+			case ExpressionOpCode::BinaryAnd: pos--; stack[pos - 1] = stack[pos - 1] & stack[pos]; break;
+			case ExpressionOpCode::BinaryXor: pos--; stack[pos - 1] = stack[pos - 1] ^ stack[pos]; break;
+			case ExpressionOpCode::BinaryOr: pos--; stack[pos - 1] = stack[pos - 1] | stack[pos]; break;
+			case ExpressionOpCode::LogicalAnd: pos--; stack[pos - 1] = (bool)(stack[pos - 1] && stack[pos]); break;
+			case ExpressionOpCode::LogicalOr: pos--; stack[pos - 1] = (bool)(stack[pos - 1] || stack[pos]); break;
+
+			case ExpressionOpCode::Plus: break;
+			case ExpressionOpCode::Minus: stack[pos - 1] = -stack[pos - 1]; break;
+			case ExpressionOpCode::BinaryNot: stack[pos - 1] = ~stack[pos - 1]; break;
+			case ExpressionOpCode::LogicalNot: stack[pos - 1] = (bool)!stack[pos - 1]; break;
+			case ExpressionOpCode::AbsoluteAddress: stack[pos - 1] = stack[pos - 1] >= 0 ? _debugger->GetAbsoluteAddress({ (int32_t)stack[pos - 1], _cpuMemory }).Address : -1; break;
+			case ExpressionOpCode::ReadDword: stack[pos - 1] = memoryDumper->GetMemoryValue32(_cpuMemory, (uint32_t)stack[pos - 1]); break;
+			case ExpressionOpCode::ReadByte: stack[pos - 1] = memoryDumper->GetMemoryValue(_cpuMemory, (uint32_t)stack[pos - 1]); break;
+			case ExpressionOpCode::ReadWord: stack[pos - 1] = memoryDumper->GetMemoryValue16(_cpuMemory, (uint32_t)stack[pos - 1]); break;
+
+			case ExpressionOpCode::ReadDwordAt: stack[pos++] = memoryDumper->GetMemoryValue32(_cpuMemory, (uint32_t)inst.Value); break;
+			case ExpressionOpCode::ReadByteAt: stack[pos++] = memoryDumper->GetMemoryValue(_cpuMemory, (uint32_t)inst.Value); break;
+			case ExpressionOpCode::ReadWordAt: stack[pos++] = memoryDumper->GetMemoryValue16(_cpuMemory, (uint32_t)inst.Value); break;
+		}
+	}
+
+	if(data.HasResultType) {
+		resultType = data.ResultType;
+	}
+	return std::clamp<int64_t>(stack[0], INT32_MIN, UINT32_MAX);
+}
+
 int64_t ExpressionEvaluator::Evaluate(ExpressionData &data, EvalResultType &resultType, MemoryOperationInfo &operationInfo, AddressInfo& addressInfo)
+{
+	if(!data.Program.empty()) {
+		return Execute(data, resultType, operationInfo, addressInfo);
+	}
+	return Interpret(data, resultType, operationInfo, addressInfo);
+}
+
+int64_t ExpressionEvaluator::Interpret(ExpressionData &data, EvalResultType &resultType, MemoryOperationInfo &operationInfo, AddressInfo& addressInfo)
 {
 	if(data.RpnQueue.empty()) {
 		resultType = EvalResultType::Invalid;
@@ -375,48 +642,11 @@ int64_t ExpressionEvaluator::Evaluate(ExpressionData &data, EvalResultType &resu
 		if(token >= EvalValues::RegA) {
 			//Replace value with a special value
 			if(token >= EvalValues::FirstLabelIndex) {
-				int64_t labelIndex = token - EvalValues::FirstLabelIndex;
-				if((size_t)labelIndex < data.Labels.size()) {
-					token = _labelManager->GetLabelRelativeAddress(data.Labels[(uint32_t)labelIndex], _cpuType);
-				} else {
-					token = -2;
-				}
-				if(token < 0) {
-					//Label is no longer valid
-					resultType = token == -1 ? EvalResultType::OutOfScope : EvalResultType::Invalid;
+				if(!GetLabelValue(data, token - EvalValues::FirstLabelIndex, token, resultType)) {
 					return 0;
 				}
 			} else {
-				switch(token) {
-					case EvalValues::Value: token = operationInfo.Value; break;
-					case EvalValues::Address: token = operationInfo.Address; break;
-					case EvalValues::MemoryAddress: token = addressInfo.Address; break;
-					case EvalValues::IsWrite: token = operationInfo.Type == MemoryOperationType::Write || operationInfo.Type == MemoryOperationType::DmaWrite || operationInfo.Type == MemoryOperationType::DummyWrite; break;
-					case EvalValues::IsRead: token = operationInfo.Type != MemoryOperationType::Write && operationInfo.Type != MemoryOperationType::DmaWrite && operationInfo.Type != MemoryOperationType::DummyWrite; break;
-					case EvalValues::IsDma: token = operationInfo.Type == MemoryOperationType::DmaRead || operationInfo.Type == MemoryOperationType::DmaWrite; break;
-					case EvalValues::IsDummy: token = operationInfo.Type == MemoryOperationType::DummyRead|| operationInfo.Type == MemoryOperationType::DummyWrite; break;
-					case EvalValues::OpProgramCounter: token = _cpuDebugger->GetProgramCounter(true); break;
-
-					default:
-						if(!_cpuDebugger) {
-							token = 0;
-						} else {
-							switch(_cpuType) {
-								case CpuType::Snes: token = GetSnesTokenValue(token, resultType); break;
-								case CpuType::Spc: token = GetSpcTokenValue(token, resultType); break;
-								case CpuType::NecDsp: token = GetNecDspTokenValue(token, resultType); break;
-								case CpuType::Sa1: token = GetSnesTokenValue(token, resultType); break;
-								case CpuType::Gsu: token = GetGsuTokenValue(token, resultType); break;
-								case CpuType::Cx4: token = GetCx4TokenValue(token, resultType); break;
-								case CpuType::Gameboy: token = GetGameboyTokenValue(token, resultType); break;
-								case CpuType::Nes: token = GetNesTokenValue(token, resultType); break;
-								case CpuType::Pce: token = GetPceTokenValue(token, resultType); break;
-								case CpuType::Sms: token = GetSmsTokenValue(token, resultType); break;
-								case CpuType::Gba: token = GetGbaTokenValue(token, resultType); break;
-							}
-						}
-						break;
-				}
+				token = GetTokenValue(token, resultType, operationInfo, addressInfo);
 			}
 		} else if(token >= EvalOperators::Multiplication) {
 			if(pos <= 0) {
@@ -557,6 +787,7 @@ ExpressionData* ExpressionEvaluator::PrivateGetRpnList(string expression, bool&
 		ExpressionData data;
 		success = ToRpn(fixedExp, data);
 		if(success) {
+			Compile(data);
 			LockHandler lock = _cacheLock.AcquireSafe();
 			_cache[expression] = data;
 			cachedData = &_cache[expression];
@@ -624,6 +855,17 @@ void ExpressionEvaluator::RunTests()
 
 		assert(type == expectedType);
 		assert(result == expectedResult);
+
+		//The compiled program must match the interpreter
+		bool success;
+		ExpressionData* data = PrivateGetRpnList(expr, success);
+		if(data) {
+			ExpressionData rpnData = *data;
+			rpnData.Program.clear();
+			EvalResultType rpnType;
+			assert(Evaluate(rpnData, rpnType, opInfo, addrInfo) == result);
+			assert(rpnType == type);
+		}
 	};
 	
 	test("1 - -1", EvalResultType::Numeric, 2);
@@ -10,6 +10,8 @@
 class Debugger;
 class LabelManager;
 class IDebugger;
+class MemoryDumper;
+struct BaseState;
 
 enum EvalOperators : int64_t
 {
@@ -199,10 +201,68 @@ public:
 	}
 };
 
+//Reads a register directly from the CPU state, resolved when the expression is compiled
+typedef int64_t (*ExpressionRegisterAccessor)(BaseState& state);
+
+enum class ExpressionOpCode : uint8_t
+{
+	Constant,
+	ReadRegister,
+	ReadToken, //Any other token (operation info, PPU state, flags), read through the CPU-specific Get*TokenValue
+	ReadLabel,
+
+	//Same order as EvalOperators
+	Multiplication,
+	Division,
+	Modulo,
+	Addition,
+	Substration,
+	ShiftLeft,
+	ShiftRight,
+	SmallerThan,
+	SmallerOrEqual,
+	GreaterThan,
+	GreaterOrEqual,
+	Equal,
+	NotEqual,
+	BinaryAnd,
+	BinaryXor,
+	BinaryOr,
+	LogicalAnd,
+	LogicalOr,
+	Plus,
+	Minus,
+	BinaryNot,
+	LogicalNot,
+	AbsoluteAddress,
+	ReadDword,
+	ReadByte,
+	ReadWord,
+
+	//Memory reads at a constant address
+	ReadDwordAt,
+	ReadByteAt,
+	ReadWordAt,
+};
+
+struct ExpressionInstruction
+{
+	ExpressionOpCode Op;
+	int64_t Value;
+	ExpressionRegisterAccessor Accessor;
+};
+
 struct ExpressionData
 {
 	vector<int64_t> RpnQueue;
 	vector<string> Labels;
+
+	//Stack-machine form of RpnQueue produced by ExpressionEvaluator::Compile - used instead of RpnQueue when not empty
+	vector<ExpressionInstruction> Program;
+	//Result type set by the last operator (when the RPN list ends with one), otherwise given by the last value
+	EvalResultType ResultType = EvalResultType::Numeric;
+	bool HasResultType = false;
+	bool UsesCpuState = false;
 };
 
 class ExpressionEvaluator
@@ -258,13 +318,29 @@ private:
 	unordered_map<string, int64_t>& GetGbaTokens();
 	int64_t GetGbaTokenValue(int64_t token, EvalResultType& resultType);
 
+	ExpressionRegisterAccessor GetSnesRegisterAccessor(int64_t token);
+	ExpressionRegisterAccessor GetSpcRegisterAccessor(int64_t token);
+	ExpressionRegisterAccessor GetGsuRegisterAccessor(int64_t token);
+	ExpressionRegisterAccessor GetCx4RegisterAccessor(int64_t token);
+	ExpressionRegisterAccessor GetNecDspRegisterAccessor(int64_t token);
+	ExpressionRegisterAccessor GetGameboyRegisterAccessor(int64_t token);
+	ExpressionRegisterAccessor GetNesRegisterAccessor(int64_t token);
+	ExpressionRegisterAccessor GetPceRegisterAccessor(int64_t token);
+	ExpressionRegisterAccessor GetSmsRegisterAccessor(int64_t token);
+	ExpressionRegisterAccessor GetGbaRegisterAccessor(int64_t token);
+
 	bool ReturnBool(int64_t value, EvalResultType& resultType);
+	int64_t GetTokenValue(int64_t token, EvalResultType& resultType, MemoryOperationInfo& operationInfo, AddressInfo& addressInfo);
+	bool GetLabelValue(ExpressionData& data, int64_t labelIndex, int64_t& value, EvalResultType& resultType);
 
 	int64_t ProcessSharedTokens(string token);
 	
 	string GetNextToken(string expression, size_t &pos, ExpressionData &data, bool &success, bool previousTokenIsOp);
 	bool ProcessSpecialOperator(EvalOperators evalOp, std::stack<EvalOperators> &opStack, std::stack<int> &precedenceStack, vector<int64_t> &outputQueue);
 	bool ToRpn(string expression, ExpressionData &data);
+	void Compile(ExpressionData &data);
+	int64_t Interpret(ExpressionData &data, EvalResultType &resultType, MemoryOperationInfo &operationInfo, AddressInfo& addressInfo);
+	int64_t Execute(ExpressionData &data, EvalResultType &resultType, MemoryOperationInfo &operationInfo, AddressInfo& addressInfo);
 	int64_t PrivateEvaluate(string expression, EvalResultType &resultType, MemoryOperationInfo &operationInfo, AddressInfo& addressInfo, bool &success);
 	ExpressionData* PrivateGetRpnList(string expression, bool& success);
 
@@ -281,6 +357,9 @@ public:
 
 	bool Validate(string expression);
 
+	//Returns a function that reads the given register (EvalValues) from this CPU's state, or nullptr if the CPU doesn't have it
+	ExpressionRegisterAccessor GetRegisterAccessor(int64_t token);
+
 #if _DEBUG
 	void RunTests();
 #endif
@@ -2,6 +2,8 @@
 #include "pch.h"
 #include "Debugger/DebugTypes.h"
 
+struct BinaryTraceRow;
+
 struct TraceRow
 {
 	uint32_t ProgramCounter;
@@ -12,6 +14,14 @@ struct TraceRow
 	char LogOutput[500];
 };
 
+struct TraceLogPpuState
+{
+	uint32_t Cycle;
+	uint32_t HClock;
+	int32_t Scanline;
+	uint32_t FrameCount;
+};
+
 struct TraceLoggerOptions
 {
 	bool Enabled;
@@ -33,6 +43,13 @@ public:
 	virtual void GetExecutionTrace(TraceRow& row, uint32_t offset) = 0;
 	virtual void Clear() = 0;
 	virtual void SetOptions(TraceLoggerOptions options) = 0;
+	virtual TraceLoggerOptions GetOptions() = 0;
+
+	//Formats a row read from a binary trace log (same output as GetExecutionTrace) - returns false if the row doesn't match this CPU's state format
+	virtual bool GetBinaryTraceRow(BinaryTraceRow& data, string& output, uint32_t& programCounter) = 0;
+
+	//Returns a copy of this logger's current format/options that can only be used to call GetBinaryTraceRow
+	virtual unique_ptr<ITraceLogger> CreateFormatter() = 0;
 
 	__forceinline bool IsEnabled() { return _enabled; }
 };
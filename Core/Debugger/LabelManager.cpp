@@ -4,6 +4,8 @@
 #include "Debugger/DebugUtilities.h"
 #include "Debugger/DebugBreakHelper.h"
 
+thread_local vector<uint64_t>* LabelManager::_lookupLog = nullptr;
+
 LabelManager::LabelManager(Debugger *debugger)
 {
 	_debugger = debugger;
@@ -74,6 +76,9 @@ bool LabelManager::InternalGetLabel(AddressInfo address, string &label)
 {
 	int64_t key = GetLabelKey(address.Address, address.Type);
 	if(key >= 0) {
+		if(_lookupLog) {
+			_lookupLog->push_back(key);
+		}
 		auto result = _codeLabels.find(key);
 		if(result != _codeLabels.end()) {
 			label = result->second.Label;
@@ -107,6 +112,9 @@ bool LabelManager::GetLabelAndComment(AddressInfo address, LabelInfo &labelInfo)
 		int64_t key = GetLabelKey(address.Address, address.Type);
 
 		if(key >= 0) {
+			if(_lookupLog) {
+				_lookupLog->push_back(key);
+			}
 			auto result = _codeLabels.find(key);
 			if(result != _codeLabels.end()) {
 				labelInfo = result->second;
@@ -155,6 +163,12 @@ int32_t LabelManager::GetLabelRelativeAddress(string &label, CpuType cpuType)
 	return -2;
 }
 
+void LabelManager::GetLabels(unordered_map<uint64_t, LabelInfo>& labels)
+{
+	labels.clear();
+	labels.insert(_codeLabels.begin(), _codeLabels.end());
+}
+
 bool LabelManager::HasLabelOrComment(AddressInfo address)
 {
 	if(DebugUtilities::IsRelativeMemory(address.Type)) {
@@ -164,6 +178,9 @@ bool LabelManager::HasLabelOrComment(AddressInfo address)
 	if(address.Address >= 0) {
 		uint64_t key = GetLabelKey(address.Address, address.Type);
 		if(key >= 0) {
+			if(_lookupLog) {
+				_lookupLog->push_back(key);
+			}
 			return _codeLabels.find(key) != _codeLabels.end();
 		}
 	}
@@ -30,6 +30,8 @@ private:
 
 	Debugger *_debugger;
 
+	static thread_local vector<uint64_t>* _lookupLog;
+
 	int64_t GetLabelKey(uint32_t absoluteAddr, MemoryType memType);
 	MemoryType GetKeyMemoryType(uint64_t key);
 	bool InternalGetLabel(AddressInfo address, string& label);
@@ -50,4 +52,9 @@ public:
 	bool ContainsLabel(string &label);
 
 	bool HasLabelOrComment(AddressInfo address);
+
+	void GetLabels(unordered_map<uint64_t, LabelInfo>& labels);
+
+	//When set, the key of every label lookup done on the calling thread is appended to log (nullptr to stop logging)
+	static void SetLookupLog(vector<uint64_t>* log) { _lookupLog = log; }
 };
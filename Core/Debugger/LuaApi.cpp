@@ -94,6 +94,9 @@ int LuaApi::GetLibrary(lua_State *lua)
 		{ "write16", LuaApi::WriteMemory16 },
 		{ "read32", LuaApi::ReadMemory32 },
 		{ "write32", LuaApi::WriteMemory32 },
+		{ "readRange", LuaApi::ReadMemoryRange },
+		{ "writeRange", LuaApi::WriteMemoryRange },
+		{ "unpackArray", LuaApi::UnpackArray },
 
 		{ "readWord", LuaApi::ReadMemory16 }, //for backward compatibility
 		{ "writeWord", LuaApi::WriteMemory16 }, //for backward compatibility
@@ -336,6 +339,120 @@ int LuaApi::WriteMemory32(lua_State* lua)
 	return l.ReturnCount();
 }
 
+static constexpr int MaxMemoryRangeLength = 0x1000000;
+static vector<uint8_t> _rangeBuffer;
+
+//Pushes the output table at outputIndex (or a new table when there is none) to the stack
+static void PushOutputTable(lua_State* lua, int outputIndex, int size)
+{
+	if(outputIndex) {
+		lua_pushvalue(lua, outputIndex);
+	} else {
+		lua_createtable(lua, size, 0);
+	}
+}
+
+//Removes the values past the end of the result from a reused output table (at the top of the stack)
+static void TrimOutputTable(lua_State* lua, int size)
+{
+	for(lua_Integer i = (lua_Integer)lua_rawlen(lua, -1); i > size; i--) {
+		lua_pushnil(lua);
+		lua_rawseti(lua, -2, i);
+	}
+}
+
+int LuaApi::ReadMemoryRange(lua_State* lua)
+{
+	LuaCallHelper l(lua);
+	l.ForceParamCount(4);
+	int outputIndex = l.GetTableIndex();
+	int type = l.ReadInteger();
+	MemoryType memType = (MemoryType)(type & 0xFF);
+	int length = l.ReadInteger();
+	int address = l.ReadInteger();
+	checkminparams(3);
+	errorCond(address < 0, "address must be >= 0");
+	errorCond(length < 0 || length > MaxMemoryRangeLength, "length out of range");
+	checkEnum(MemoryType, memType, "invalid memory type");
+
+	//Bytes past the end of the memory are returned as 0, like emu.read
+	_rangeBuffer.assign(length, 0);
+	if(length > 0) {
+		_memoryDumper->GetMemoryValues(memType, address, address + length - 1, _rangeBuffer.data());
+	}
+
+	if(!outputIndex) {
+		//No output table given, return the data as a string
+		lua_pushlstring(lua, (char*)_rangeBuffer.data(), length);
+		return 1;
+	}
+
+	PushOutputTable(lua, outputIndex, length);
+	TrimOutputTable(lua, length);
+	for(int i = 0; i < length; i++) {
+		lua_pushinteger(lua, _rangeBuffer[i]);
+		lua_rawseti(lua, -2, i + 1);
+	}
+	return 1;
+}
+
+int LuaApi::WriteMemoryRange(lua_State* lua)
+{
+	LuaCallHelper l(lua);
+	int type = l.ReadInteger();
+	bool disableSideEffects = (type & 0x100) == 0x100;
+	MemoryType memType = (MemoryType)(type & 0xFF);
+	bool validData = l.ReadBytes(_rangeBuffer);
+	int address = l.ReadInteger();
+	checkparams();
+	errorCond(!validData, "data must be a string or an array of bytes");
+	errorCond(address < 0, "address must be >= 0");
+	checkEnum(MemoryType, memType, "invalid memory type");
+	for(size_t i = 0; i < _rangeBuffer.size(); i++) {
+		_memoryDumper->SetMemoryValue(memType, address + (uint32_t)i, _rangeBuffer[i], disableSideEffects);
+	}
+	return l.ReturnCount();
+}
+
+int LuaApi::UnpackArray(lua_State* lua)
+{
+	LuaCallHelper l(lua);
+	l.ForceParamCount(4);
+	int outputIndex = l.GetTableIndex();
+	bool returnSignedValue = l.ReadBool();
+	int elementSize = l.ReadInteger(1);
+	bool validData = l.ReadBytes(_rangeBuffer);
+	checkminparams(1);
+	errorCond(!validData, "data must be a string or an array of bytes");
+	errorCond(elementSize != 1 && elementSize != 2 && elementSize != 4, "element size must be 1, 2 or 4");
+
+	//Little endian values, trailing bytes that don't fill a whole element are ignored
+	uint8_t* data = _rangeBuffer.data();
+	int count = (int)(_rangeBuffer.size() / elementSize);
+	PushOutputTable(lua, outputIndex, count);
+	TrimOutputTable(lua, count);
+	for(int i = 0; i < count; i++, data += elementSize) {
+		lua_Integer value;
+		switch(elementSize) {
+			default:
+			case 1: value = returnSignedValue ? (lua_Integer)(int8_t)data[0] : data[0]; break;
+			case 2: {
+				uint16_t v = data[0] | (data[1] << 8);
+				value = returnSignedValue ? (lua_Integer)(int16_t)v : v;
+				break;
+			}
+			case 4: {
+				uint32_t v = data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t)data[3] << 24);
+				value = returnSignedValue ? (lua_Integer)(int32_t)v : v;
+				break;
+			}
+		}
+		lua_pushinteger(lua, value);
+		lua_rawseti(lua, -2, i + 1);
+	}
+	return 1;
+}
+
 int LuaApi::ConvertAddress(lua_State *lua)
 {
 	LuaCallHelper l(lua);
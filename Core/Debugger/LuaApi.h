@@ -32,6 +32,9 @@ public:
 	static int WriteMemory16(lua_State *lua);
 	static int ReadMemory32(lua_State* lua);
 	static int WriteMemory32(lua_State* lua);
+	static int ReadMemoryRange(lua_State* lua);
+	static int WriteMemoryRange(lua_State* lua);
+	static int UnpackArray(lua_State* lua);
 
 	static int GetLabelAddress(lua_State* lua);
 	static int ConvertAddress(lua_State *lua);
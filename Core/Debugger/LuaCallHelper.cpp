@@ -117,6 +117,45 @@ int LuaCallHelper::GetReference()
 	}
 }
 
+int LuaCallHelper::GetTableIndex()
+{
+	//Moves the table to the bottom of the stack instead of referencing it in the registry,
+	//so nothing leaks if the function raises an error before returning it
+	_paramCount++;
+	if(lua_istable(_lua, -1)) {
+		lua_insert(_lua, 1);
+		return 1;
+	} else {
+		lua_pop(_lua, 1);
+		return 0;
+	}
+}
+
+bool LuaCallHelper::ReadBytes(vector<uint8_t>& output)
+{
+	//Accepts either a string or an array of byte values
+	_paramCount++;
+	bool result = true;
+	if(lua_type(_lua, -1) == LUA_TSTRING) {
+		size_t len;
+		const char* data = lua_tolstring(_lua, -1, &len);
+		output.assign((uint8_t*)data, (uint8_t*)data + len);
+	} else if(lua_istable(_lua, -1)) {
+		size_t len = lua_rawlen(_lua, -1);
+		output.resize(len);
+		for(size_t i = 0; i < len; i++) {
+			lua_rawgeti(_lua, -1, i + 1);
+			output[i] = (uint8_t)lua_tointeger(_lua, -1);
+			lua_pop(_lua, 1);
+		}
+	} else {
+		output.clear();
+		result = false;
+	}
+	lua_pop(_lua, 1);
+	return result;
+}
+
 void LuaCallHelper::Return(bool value)
 {
 	lua_pushboolean(_lua, value);
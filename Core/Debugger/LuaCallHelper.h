@@ -28,6 +28,8 @@ public:
 	uint32_t ReadInteger(uint32_t defaultValue = 0);
 	string ReadString();
 	int GetReference();
+	int GetTableIndex();
+	bool ReadBytes(vector<uint8_t>& output);
 
 	Nullable<bool> ReadOptionalBool();
 	Nullable<int32_t> ReadOptionalInteger();
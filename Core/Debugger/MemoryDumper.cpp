@@ -285,6 +285,15 @@ void MemoryDumper::GetMemoryValues(MemoryType memoryType, uint32_t start, uint32
 {
 	int x = 0;
 	uint32_t size = GetMemorySize(memoryType);
+	if(!DebugUtilities::IsRelativeMemory(memoryType) && start <= end && start < size) {
+		//Non-CPU memory types are plain buffers, copy the whole block at once
+		uint8_t* src = GetMemoryBuffer(memoryType);
+		if(src) {
+			memcpy(output, src + start, std::min(end, size - 1) - start + 1);
+			return;
+		}
+	}
+
 	for(uint32_t i = start; i <= end && i < size; i++) {
 		output[x++] = InternalGetMemoryValue(memoryType, i);
 	}
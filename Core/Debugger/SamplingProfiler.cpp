@@ -0,0 +1,353 @@
+#include "pch.h"
+#include <algorithm>
+#include "Debugger/SamplingProfiler.h"
+#include "Debugger/Debugger.h"
+#include "Debugger/CallstackManager.h"
+#include "Debugger/LabelManager.h"
+#include "Debugger/DebugBreakHelper.h"
+#include "Debugger/DebugUtilities.h"
+#include "Shared/Emulator.h"
+#include "Utilities/HexUtilities.h"
+#include "Utilities/magic_enum.hpp"
+
+SamplingProfiler::SamplingProfiler(Debugger* debugger)
+{
+	_debugger = debugger;
+}
+
+SamplingProfiler::~SamplingProfiler()
+{
+	StopThread();
+}
+
+bool SamplingProfiler::Start(CpuType cpuType, uint32_t interval)
+{
+	DebugBreakHelper helper(_debugger);
+
+	CallstackManager* callstackManager = _debugger->GetCallstackManager(cpuType);
+	if(!callstackManager || interval == 0) {
+		return false;
+	}
+
+	Stop();
+	Reset();
+
+	_cpuType = cpuType;
+	_cpuMemType = DebugUtilities::GetCpuMemoryType(cpuType);
+	_callstackManager = callstackManager;
+	_interval = interval;
+	_prevSampleClock = UINT64_MAX; //Resync on the first instruction
+
+	for(int i = 0; i < 2; i++) {
+		_buffers[i].resize(BufferSize);
+	}
+	_activeBuffer = 0;
+	_buffer = _buffers[0].data();
+	_bufferPos = 0;
+
+	_pendingBuffer = -1;
+	_stopAggregator = false;
+	_aggregatorThread = std::thread(&SamplingProfiler::AggregatorLoop, this);
+
+	_callstackManager->SetProfilerEnabled(false);
+	_enabled = true;
+	return true;
+}
+
+void SamplingProfiler::Stop()
+{
+	DebugBreakHelper helper(_debugger);
+	if(!_enabled) {
+		return;
+	}
+
+	_enabled = false;
+	_callstackManager->SetProfilerEnabled(true);
+	StopThread();
+}
+
+void SamplingProfiler::StopThread()
+{
+	if(!_aggregatorThread.joinable()) {
+		return;
+	}
+
+	SwapBuffers();
+	{
+		std::unique_lock<std::mutex> lock(_aggregatorLock);
+		_stopAggregator = true;
+	}
+	_aggregatorSignal.notify_all();
+	_aggregatorThread.join();
+
+	for(int i = 0; i < 2; i++) {
+		_buffers[i] = {};
+	}
+	_buffer = nullptr;
+	_bufferPos = 0;
+}
+
+void SamplingProfiler::Reset()
+{
+	DebugBreakHelper helper(_debugger);
+	Flush();
+
+	std::unique_lock<std::mutex> lock(_dataLock);
+	_sampleCount = 0;
+	_totalClocks = 0;
+	_functions.clear();
+	_stacks.clear();
+	_addresses.clear();
+	_frames.clear();
+}
+
+void SamplingProfiler::TakeSample(IDebugger* cpuDebugger, uint64_t clock)
+{
+	if(clock < _prevSampleClock) {
+		_prevSampleClock = clock;
+		return;
+	}
+
+	ProfilerSample& sample = _buffer[_bufferPos];
+	sample.Clocks = clock - _prevSampleClock;
+	sample.Frame = _debugger->GetEmulator()->GetFrameCount();
+
+	AddressInfo pc = _debugger->GetAbsoluteAddress({ (int32_t)cpuDebugger->GetProgramCounter(true), _cpuMemType });
+	sample.Pc = GetFunctionKey(pc);
+
+	AddressInfo frames[ProfilerSample::MaxStackDepth];
+	sample.Depth = (uint8_t)_callstackManager->GetTopFrames(frames, ProfilerSample::MaxStackDepth);
+	for(int i = 0; i < sample.Depth; i++) {
+		sample.Stack[i] = GetFunctionKey(frames[i]);
+	}
+
+	_prevSampleClock = clock;
+	_bufferPos++;
+	if(_bufferPos == BufferSize) {
+		SwapBuffers();
+	}
+}
+
+void SamplingProfiler::SwapBuffers()
+{
+	//Wait for the aggregator to be done with the other buffer, then hand it this one
+	std::unique_lock<std::mutex> lock(_aggregatorLock);
+	_aggregatorSignal.wait(lock, [this] { return _pendingBuffer < 0; });
+
+	if(_bufferPos > 0) {
+		_pendingBuffer = _activeBuffer;
+		_pendingSize = _bufferPos;
+		_aggregatorSignal.notify_all();
+
+		_activeBuffer ^= 1;
+		_buffer = _buffers[_activeBuffer].data();
+		_bufferPos = 0;
+	}
+}
+
+void SamplingProfiler::Flush()
+{
+	//Hand over the partial buffer and wait until it has been aggregated
+	if(_enabled) {
+		SwapBuffers();
+		std::unique_lock<std::mutex> lock(_aggregatorLock);
+		_aggregatorSignal.wait(lock, [this] { return _pendingBuffer < 0; });
+	}
+}
+
+void SamplingProfiler::AggregatorLoop()
+{
+	while(true) {
+		int bufferIndex;
+		uint32_t size;
+		{
+			std::unique_lock<std::mutex> lock(_aggregatorLock);
+			_aggregatorSignal.wait(lock, [this] { return _stopAggregator || _pendingBuffer >= 0; });
+			if(_pendingBuffer < 0) {
+				//Stop is only requested after the last buffer has been handed over
+				return;
+			}
+			bufferIndex = _pendingBuffer;
+			size = _pendingSize;
+		}
+
+		Aggregate(_buffers[bufferIndex].data(), size);
+
+		{
+			std::unique_lock<std::mutex> lock(_aggregatorLock);
+			_pendingBuffer = -1;
+		}
+		_aggregatorSignal.notify_all();
+	}
+}
+
+void SamplingProfiler::Aggregate(ProfilerSample* samples, uint32_t count)
+{
+	std::unique_lock<std::mutex> lock(_dataLock);
+
+	vector<int32_t> stack;
+	for(uint32_t i = 0; i < count; i++) {
+		ProfilerSample& sample = samples[i];
+		int32_t leaf = sample.Depth > 0 ? sample.Stack[sample.Depth - 1] : -1;
+
+		_sampleCount++;
+		_totalClocks += sample.Clocks;
+
+		SampledFunction& func = _functions[leaf];
+		func.Key = leaf;
+		func.ExclusiveClocks += sample.Clocks;
+		func.SampleCount++;
+
+		_addresses[sample.Pc] += sample.Clocks;
+
+		stack.assign(sample.Stack, sample.Stack + sample.Depth);
+		_stacks[stack] += sample.Clocks;
+
+		//Recursive functions only count once towards the inclusive time
+		std::sort(stack.begin(), stack.end());
+		stack.erase(std::unique(stack.begin(), stack.end()), stack.end());
+		for(int32_t key : stack) {
+			SampledFunction& parent = _functions[key];
+			parent.Key = key;
+			parent.InclusiveClocks += sample.Clocks;
+		}
+		if(sample.Depth == 0) {
+			func.InclusiveClocks += sample.Clocks;
+		}
+
+		if(_frames.empty() || _frames.back().Frame != sample.Frame) {
+			if(_frames.size() >= MaxFrames) {
+				_frames.pop_front();
+			}
+			_frames.push_back({});
+			_frames.back().Frame = sample.Frame;
+		}
+		SampledFrame& frame = _frames.back();
+		frame.TotalClocks += sample.Clocks;
+		frame.Functions[leaf] += sample.Clocks;
+	}
+}
+
+string SamplingProfiler::GetFunctionName(int32_t key)
+{
+	if(key < 0) {
+		return "[root]";
+	}
+
+	AddressInfo addr = { key & 0xFFFFFF, (MemoryType)((uint32_t)key >> 24) };
+	string label = _debugger->GetLabelManager()->GetLabel(addr);
+	if(!label.empty()) {
+		return label;
+	}
+	return string(magic_enum::enum_name(addr.Type)) + "_" + HexUtilities::ToHex24(addr.Address);
+}
+
+SamplingProfilerStatus SamplingProfiler::GetStatus()
+{
+	DebugBreakHelper helper(_debugger);
+	Flush();
+
+	std::unique_lock<std::mutex> lock(_dataLock);
+	SamplingProfilerStatus status;
+	status.Enabled = _enabled;
+	status.Cpu = _cpuType;
+	status.Interval = _interval;
+	status.SampleCount = _sampleCount;
+	status.TotalClocks = _totalClocks;
+	status.FunctionCount = (uint32_t)_functions.size();
+	status.StackCount = (uint32_t)_stacks.size();
+	status.AddressCount = (uint32_t)_addresses.size();
+	return status;
+}
+
+vector<SampledFunction> SamplingProfiler::GetFunctions(uint32_t count)
+{
+	DebugBreakHelper helper(_debugger);
+	Flush();
+
+	vector<SampledFunction> functions;
+	{
+		std::unique_lock<std::mutex> lock(_dataLock);
+		functions.reserve(_functions.size());
+		for(auto& [key, func] : _functions) {
+			functions.push_back(func);
+		}
+	}
+
+	std::sort(functions.begin(), functions.end(), [](const SampledFunction& a, const SampledFunction& b) {
+		return a.ExclusiveClocks > b.ExclusiveClocks;
+	});
+	if(count > 0 && functions.size() > count) {
+		functions.resize(count);
+	}
+	return functions;
+}
+
+vector<std::pair<int32_t, uint64_t>> SamplingProfiler::GetHotAddresses(uint32_t count)
+{
+	DebugBreakHelper helper(_debugger);
+	Flush();
+
+	vector<std::pair<int32_t, uint64_t>> addresses;
+	{
+		std::unique_lock<std::mutex> lock(_dataLock);
+		addresses.assign(_addresses.begin(), _addresses.end());
+	}
+
+	std::sort(addresses.begin(), addresses.end(), [](const std::pair<int32_t, uint64_t>& a, const std::pair<int32_t, uint64_t>& b) {
+		return a.second > b.second;
+	});
+	if(count > 0 && addresses.size() > count) {
+		addresses.resize(count);
+	}
+	return addresses;
+}
+
+vector<SampledFrame> SamplingProfiler::GetFrames(uint32_t frameCount)
+{
+	DebugBreakHelper helper(_debugger);
+	Flush();
+
+	std::unique_lock<std::mutex> lock(_dataLock);
+
+	//The last frame is still being sampled (unless sampling is stopped)
+	size_t end = _enabled && !_frames.empty() ? _frames.size() - 1 : _frames.size();
+	size_t start = end > frameCount ? end - frameCount : 0;
+	return vector<SampledFrame>(_frames.begin() + start, _frames.begin() + end);
+}
+
+bool SamplingProfiler::ExportFlameGraph(string filename)
+{
+	DebugBreakHelper helper(_debugger);
+	Flush();
+
+	ofstream file(filename, ios::out | ios::binary);
+	if(!file) {
+		return false;
+	}
+
+	std::unique_lock<std::mutex> lock(_dataLock);
+	unordered_map<int32_t, string> names;
+	auto getName = [&](int32_t key) -> string& {
+		auto result = names.find(key);
+		if(result == names.end()) {
+			result = names.emplace(key, GetFunctionName(key)).first;
+		}
+		return result->second;
+	};
+
+	string line;
+	for(auto& [stack, clocks] : _stacks) {
+		line = getName(-1);
+		for(int32_t key : stack) {
+			line += ';';
+			line += getName(key);
+		}
+		line += ' ';
+		line += std::to_string(clocks);
+		line += '\n';
+		file.write(line.c_str(), line.size());
+	}
+	file.close();
+	return !file.fail();
+}
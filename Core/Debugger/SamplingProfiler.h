@@ -0,0 +1,133 @@
+#pragma once
+#include "pch.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <map>
+#include "Debugger/DebugTypes.h"
+#include "Debugger/IDebugger.h"
+
+class Debugger;
+class CallstackManager;
+
+struct ProfilerSample
+{
+	static constexpr int MaxStackDepth = 8;
+
+	uint64_t Clocks; //Clocks elapsed since the previous sample
+	uint32_t Frame;
+	int32_t Pc; //Function key format (see SamplingProfiler::GetFunctionKey), -1 if unmapped
+	uint8_t Depth;
+	int32_t Stack[MaxStackDepth]; //Function keys, outermost first
+};
+
+struct SampledFunction
+{
+	int32_t Key = -1;
+	uint64_t ExclusiveClocks = 0;
+	uint64_t InclusiveClocks = 0;
+	uint64_t SampleCount = 0;
+};
+
+struct SampledFrame
+{
+	uint32_t Frame = 0;
+	uint64_t TotalClocks = 0;
+	unordered_map<int32_t, uint64_t> Functions; //Exclusive clocks per function
+};
+
+struct SamplingProfilerStatus
+{
+	bool Enabled = false;
+	CpuType Cpu = CpuType::Snes;
+	uint32_t Interval = 0;
+	uint64_t SampleCount = 0;
+	uint64_t TotalClocks = 0;
+	uint32_t FunctionCount = 0;
+	uint32_t StackCount = 0;
+	uint32_t AddressCount = 0;
+};
+
+//Statistical alternative to Profiler: instead of updating the function stats on every call/return,
+//the PC and the top of the callstack are recorded every N clocks (same clock as the profiler's) into
+//a fixed buffer. Full buffers are aggregated on a background thread into per-function totals,
+//per-stack totals (exported as a flame graph) and a per-frame breakdown of the last frames.
+//While sampling, the CPU's instrumented profiler is disabled.
+class SamplingProfiler
+{
+private:
+	static constexpr uint32_t BufferSize = 4096;
+	static constexpr uint32_t MaxFrames = 600;
+
+	Debugger* _debugger;
+
+	bool _enabled = false;
+	CpuType _cpuType = CpuType::Snes;
+	MemoryType _cpuMemType = MemoryType::None;
+	CallstackManager* _callstackManager = nullptr;
+	uint32_t _interval = 0;
+	uint64_t _prevSampleClock = 0;
+
+	vector<ProfilerSample> _buffers[2];
+	ProfilerSample* _buffer = nullptr;
+	uint32_t _bufferPos = 0;
+	int _activeBuffer = 0;
+
+	std::thread _aggregatorThread;
+	std::mutex _aggregatorLock;
+	std::condition_variable _aggregatorSignal;
+	int _pendingBuffer = -1;
+	uint32_t _pendingSize = 0;
+	bool _stopAggregator = false;
+
+	//Aggregated data, only accessed by the aggregator thread or while holding _dataLock
+	std::mutex _dataLock;
+	uint64_t _sampleCount = 0;
+	uint64_t _totalClocks = 0;
+	unordered_map<int32_t, SampledFunction> _functions;
+	std::map<vector<int32_t>, uint64_t> _stacks;
+	unordered_map<int32_t, uint64_t> _addresses; //Clocks per PC
+	deque<SampledFrame> _frames;
+
+	void TakeSample(IDebugger* cpuDebugger, uint64_t clock);
+	void SwapBuffers();
+	void AggregatorLoop();
+	void Aggregate(ProfilerSample* samples, uint32_t count);
+	void StopThread();
+	void Flush();
+
+public:
+	static constexpr uint32_t DefaultInterval = 1000;
+
+	SamplingProfiler(Debugger* debugger);
+	~SamplingProfiler();
+
+	//Returns false if the CPU has no callstack (or the interval is 0)
+	bool Start(CpuType cpuType, uint32_t interval);
+	void Stop();
+	void Reset();
+
+	__forceinline bool IsSampling(CpuType cpuType) { return _enabled && _cpuType == cpuType; }
+
+	__forceinline void ProcessInstruction(IDebugger* cpuDebugger)
+	{
+		uint64_t clock = cpuDebugger->GetCpuCycleCount(true);
+		//Also resyncs when the clock goes backwards (e.g after a power cycle or loading a state)
+		if(clock - _prevSampleClock >= _interval) {
+			TakeSample(cpuDebugger, clock);
+		}
+	}
+
+	static int32_t GetFunctionKey(AddressInfo& addr) { return addr.Address < 0 ? -1 : (addr.Address | ((uint8_t)addr.Type << 24)); }
+	string GetFunctionName(int32_t key);
+
+	SamplingProfilerStatus GetStatus();
+	//Functions sorted by exclusive clocks (highest first), count = 0 returns all of them
+	vector<SampledFunction> GetFunctions(uint32_t count);
+	//PC addresses (function key format) sorted by clocks (highest first)
+	vector<std::pair<int32_t, uint64_t>> GetHotAddresses(uint32_t count);
+	//The last frameCount complete frames, oldest first
+	vector<SampledFrame> GetFrames(uint32_t frameCount);
+	//Writes the sampled stacks in the "folded" format used by flamegraph.pl/speedscope (one "a;b;c clocks" line per stack)
+	bool ExportFlameGraph(string filename);
+};
@@ -233,6 +233,7 @@ void ScriptingContext::RegisterMemoryCallback(CallbackType type, int startAddr,
 	}
 
 	_callbacks[(int)type].push_back(callback);
+	RebuildMemoryCallbackIndex(type);
 }
 
 void ScriptingContext::RefreshMemoryCallbackFlags()
@@ -266,6 +267,7 @@ void ScriptingContext::UnregisterMemoryCallback(CallbackType type, int startAddr
 
 		if(isMatch) {
 			_callbacks[(int)type].erase(_callbacks[(int)type].begin() + i);
+			RebuildMemoryCallbackIndex(type);
 			break;
 		}
 	}
@@ -285,44 +287,106 @@ void ScriptingContext::UnregisterEventCallback(EventType type, int reference)
 	luaL_unref(_lua, LUA_REGISTRYINDEX, reference);
 }
 
-bool ScriptingContext::IsAddressMatch(MemoryCallback& callback, AddressInfo addr)
+void ScriptingContext::RebuildMemoryCallbackIndex(CallbackType type)
 {
-	return addr.Type == callback.MemType && addr.Address >= (int32_t)callback.StartAddress && addr.Address <= (int32_t)callback.EndAddress;
+	vector<MemoryCallbackGroup>& groups = _callbackGroups[(int)type];
+	groups.clear();
+	memset(_hasAbsoluteCallbacks[(int)type], 0, sizeof(_hasAbsoluteCallbacks[(int)type]));
+
+	vector<MemoryCallback>& callbacks = _callbacks[(int)type];
+	for(uint32_t i = 0; i < (uint32_t)callbacks.size(); i++) {
+		MemoryCallback& callback = callbacks[i];
+		auto result = std::find_if(groups.begin(), groups.end(), [&](MemoryCallbackGroup& group) {
+			return group.Cpu == callback.Cpu && group.MemType == callback.MemType;
+		});
+		if(result == groups.end()) {
+			groups.push_back({ callback.Cpu, callback.MemType, {} });
+			result = groups.end() - 1;
+		}
+		result->Ranges.push_back({ callback.StartAddress, callback.EndAddress, 0, i });
+
+		if(!DebugUtilities::IsRelativeMemory(callback.MemType)) {
+			_hasAbsoluteCallbacks[(int)type][(int)callback.Cpu] = true;
+		}
+	}
+
+	for(MemoryCallbackGroup& group : groups) {
+		std::sort(group.Ranges.begin(), group.Ranges.end(), [](const MemoryCallbackGroup::Range& a, const MemoryCallbackGroup::Range& b) {
+			return a.StartAddress < b.StartAddress;
+		});
+
+		uint32_t maxEndAddress = 0;
+		for(MemoryCallbackGroup::Range& range : group.Ranges) {
+			maxEndAddress = std::max(maxEndAddress, range.EndAddress);
+			range.MaxEndAddress = maxEndAddress;
+		}
+	}
 }
 
-template<typename T>
-void ScriptingContext::InternalCallMemoryCallback(AddressInfo relAddr, T& value, CallbackType type, CpuType cpuType)
+void ScriptingContext::FindMemoryCallbacks(CallbackType type, CpuType cpuType, AddressInfo addr)
 {
-	if(_callbacks[(int)type].empty()) {
+	if(addr.Address < 0) {
 		return;
 	}
 
-	_context = this;
-	bool needTimerReset = true;
-	lua_setwatchdogtimer(_lua, ScriptingContext::ExecutionCountHook, 1000);
-	LuaApi::SetContext(this);
-	for(MemoryCallback& callback : _callbacks[(int)type]) {
-		if(callback.Cpu != cpuType) {
+	uint32_t address = (uint32_t)addr.Address;
+	for(MemoryCallbackGroup& group : _callbackGroups[(int)type]) {
+		if(group.Cpu != cpuType || group.MemType != addr.Type) {
 			continue;
-		} 
+		}
 
-		if(DebugUtilities::IsRelativeMemory(callback.MemType)) {
-			if(!IsAddressMatch(callback, relAddr)) {
-				continue;
+		auto it = std::upper_bound(group.Ranges.begin(), group.Ranges.end(), address, [](uint32_t value, const MemoryCallbackGroup::Range& range) {
+			return value < range.StartAddress;
+		});
+		while(it != group.Ranges.begin()) {
+			--it;
+			if(it->MaxEndAddress < address) {
+				break;
 			}
-		} else {
-			if(!IsAddressMatch(callback, _debugger->GetAbsoluteAddress(relAddr))) {
-				continue;
+			if(it->EndAddress >= address) {
+				_matchedCallbacks.push_back(it->Index);
 			}
 		}
+		return;
+	}
+}
+
+template<typename T>
+void ScriptingContext::InternalCallMemoryCallback(AddressInfo relAddr, T& value, CallbackType type, CpuType cpuType)
+{
+	if(_callbacks[(int)type].empty()) {
+		return;
+	}
 
-		if(needTimerReset) {
-			_timer.Reset();
-			needTimerReset = false;
+	//Relative callbacks match on the CPU address, the others on the absolute address (only resolved when needed)
+	_matchedCallbacks.clear();
+	FindMemoryCallbacks(type, cpuType, relAddr);
+	if(_hasAbsoluteCallbacks[(int)type][(int)cpuType]) {
+		AddressInfo absAddr = _debugger->GetAbsoluteAddress(relAddr);
+		if(absAddr.Type != relAddr.Type) {
+			FindMemoryCallbacks(type, cpuType, absAddr);
 		}
+	}
 
+	if(_matchedCallbacks.empty()) {
+		return;
+	}
+
+	//Call them in the order they were registered - copy the references since a callback can (un)register callbacks
+	std::sort(_matchedCallbacks.begin(), _matchedCallbacks.end());
+	vector<int> references;
+	references.reserve(_matchedCallbacks.size());
+	for(uint32_t index : _matchedCallbacks) {
+		references.push_back(_callbacks[(int)type][index].Reference);
+	}
+
+	_context = this;
+	_timer.Reset();
+	lua_setwatchdogtimer(_lua, ScriptingContext::ExecutionCountHook, 1000);
+	LuaApi::SetContext(this);
+	for(int reference : references) {
 		int top = lua_gettop(_lua);
-		lua_rawgeti(_lua, LUA_REGISTRYINDEX, callback.Reference);
+		lua_rawgeti(_lua, LUA_REGISTRYINDEX, reference);
 		lua_pushinteger(_lua, relAddr.Address);
 		lua_pushinteger(_lua, value);
 		if(lua_pcall(_lua, 2, LUA_MULTRET, 0) != 0) {
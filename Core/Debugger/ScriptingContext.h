@@ -4,6 +4,7 @@
 #include "Utilities/SimpleLock.h"
 #include "Utilities/Timer.h"
 #include "Debugger/DebugTypes.h"
+#include "Debugger/DebugUtilities.h"
 #include "Shared/EventType.h"
 
 class Debugger;
@@ -25,6 +26,22 @@ struct MemoryCallback
 	int Reference;
 };
 
+//Callbacks for a single CPU/memory type, sorted by StartAddress
+struct MemoryCallbackGroup
+{
+	struct Range
+	{
+		uint32_t StartAddress;
+		uint32_t EndAddress;
+		uint32_t MaxEndAddress; //Max EndAddress of this range and all previous ones
+		uint32_t Index; //Index in _callbacks
+	};
+
+	CpuType Cpu;
+	MemoryType MemType;
+	vector<Range> Ranges;
+};
+
 enum class ScriptDrawSurface
 {
 	ConsoleScreen,
@@ -56,12 +73,18 @@ protected:
 	string _scriptName;
 	bool _initDone = false;
 
+	static constexpr int CpuTypeCount = (int)DebugUtilities::GetLastCpuType() + 1;
+
 	vector<MemoryCallback> _callbacks[3];
+	vector<MemoryCallbackGroup> _callbackGroups[3];
+	bool _hasAbsoluteCallbacks[3][CpuTypeCount] = {};
+	vector<uint32_t> _matchedCallbacks;
 	vector<int> _eventCallbacks[(int)EventType::LastValue + 1];
 
 	template<typename T> void InternalCallMemoryCallback(AddressInfo relAddr, T& value, CallbackType type, CpuType cpuType);
 
-	bool IsAddressMatch(MemoryCallback& callback, AddressInfo addr);
+	void RebuildMemoryCallbackIndex(CallbackType type);
+	void FindMemoryCallbacks(CallbackType type, CpuType cpuType, AddressInfo addr);
 
 public:
 	ScriptingContext(Debugger* debugger);
@@ -0,0 +1,199 @@
+#include "pch.h"
+#include "Debugger/TraceLogFileSaver.h"
+#include "Debugger/DebugUtilities.h"
+#include "Utilities/Lz4.h"
+
+struct BinaryTraceBlockHeader
+{
+	uint32_t Size;
+	uint32_t CompressedSize;
+	uint32_t RowCount;
+};
+
+TraceLogFileSaver::~TraceLogFileSaver()
+{
+	StopLogging();
+}
+
+void TraceLogFileSaver::StartLogging(string filename, bool binary)
+{
+	StopLogging();
+
+	_outputFile.open(filename, ios::out | ios::binary);
+	if(!_outputFile) {
+		return;
+	}
+
+	_binary = binary;
+	if(_binary) {
+		uint32_t header[2] = { BinaryMagic, BinaryVersion };
+		_outputFile.write((char*)header, sizeof(header));
+		_compressBuffer.resize(Lz4::GetMaxCompressedSize(BufferSize));
+	}
+
+	for(int i = 0; i < 2; i++) {
+		_buffers[i].resize(BufferSize);
+	}
+	_activeBuffer = 0;
+	_buffer = _buffers[0].data();
+	_bufferPos = 0;
+	_bufferRows = 0;
+
+	_pendingBuffer = -1;
+	_stopWriter = false;
+	_writerThread = std::thread(&TraceLogFileSaver::WriterLoop, this);
+
+	_enabled = true;
+}
+
+void TraceLogFileSaver::StopLogging()
+{
+	if(!_enabled) {
+		return;
+	}
+
+	_enabled = false;
+	SwapBuffers();
+
+	{
+		std::unique_lock<std::mutex> lock(_writerLock);
+		_stopWriter = true;
+	}
+	_writerSignal.notify_all();
+	_writerThread.join();
+
+	_outputFile.close();
+	for(int i = 0; i < 2; i++) {
+		_buffers[i] = {};
+	}
+	_compressBuffer = {};
+	_buffer = nullptr;
+}
+
+void TraceLogFileSaver::SwapBuffers()
+{
+	//Wait for the writer to be done with the other buffer, then hand it this one
+	std::unique_lock<std::mutex> lock(_writerLock);
+	_writerSignal.wait(lock, [this] { return _pendingBuffer < 0; });
+
+	if(_bufferPos > 0) {
+		_pendingBuffer = _activeBuffer;
+		_pendingSize = _bufferPos;
+		_pendingRows = _bufferRows;
+		_writerSignal.notify_all();
+
+		_activeBuffer ^= 1;
+		_buffer = _buffers[_activeBuffer].data();
+		_bufferPos = 0;
+		_bufferRows = 0;
+	}
+}
+
+void TraceLogFileSaver::WriterLoop()
+{
+	while(true) {
+		int bufferIndex;
+		uint32_t size;
+		uint32_t rowCount;
+		{
+			std::unique_lock<std::mutex> lock(_writerLock);
+			_writerSignal.wait(lock, [this] { return _stopWriter || _pendingBuffer >= 0; });
+			if(_pendingBuffer < 0) {
+				//Stop is only requested after the last buffer has been handed over
+				return;
+			}
+			bufferIndex = _pendingBuffer;
+			size = _pendingSize;
+			rowCount = _pendingRows;
+		}
+
+		WriteBlock(_buffers[bufferIndex].data(), size, rowCount);
+
+		{
+			std::unique_lock<std::mutex> lock(_writerLock);
+			_pendingBuffer = -1;
+		}
+		_writerSignal.notify_all();
+	}
+}
+
+void TraceLogFileSaver::WriteBlock(uint8_t* data, uint32_t size, uint32_t rowCount)
+{
+	if(!_binary) {
+		_outputFile.write((char*)data, size);
+		return;
+	}
+
+	BinaryTraceBlockHeader header = { size, Lz4::Compress(data, size, _compressBuffer.data()), rowCount };
+	_outputFile.write((char*)&header, sizeof(header));
+	_outputFile.write((char*)_compressBuffer.data(), header.CompressedSize);
+}
+
+bool TraceLogFileSaver::ReadBinaryLog(string filename, uint64_t startRow, const std::function<bool(BinaryTraceRow&)>& callback)
+{
+	ifstream file(filename, ios::in | ios::binary);
+	uint32_t fileHeader[2] = {};
+	if(!file || !file.read((char*)fileHeader, sizeof(fileHeader)) || fileHeader[0] != BinaryMagic || fileHeader[1] != BinaryVersion) {
+		return false;
+	}
+
+	vector<uint8_t> compressed;
+	vector<uint8_t> block;
+	uint64_t rowIndex = 0;
+	BinaryTraceBlockHeader header;
+	while(file.read((char*)&header, sizeof(header))) {
+		if(header.Size > BufferSize || header.CompressedSize > Lz4::GetMaxCompressedSize(BufferSize)) {
+			return false;
+		}
+
+		if(rowIndex + header.RowCount <= startRow) {
+			//Skip blocks before the first requested row without decompressing them
+			rowIndex += header.RowCount;
+			file.seekg(header.CompressedSize, ios::cur);
+			continue;
+		}
+
+		compressed.resize(header.CompressedSize);
+		block.resize(header.Size);
+		if(!file.read((char*)compressed.data(), header.CompressedSize) || !Lz4::Decompress(compressed.data(), header.CompressedSize, block.data(), header.Size)) {
+			return false;
+		}
+
+		uint32_t pos = 0;
+		for(uint32_t i = 0; i < header.RowCount; i++, rowIndex++) {
+			BinaryTraceRowHeader rowHeader;
+			if(pos + sizeof(rowHeader) + sizeof(TraceLogPpuState) > header.Size) {
+				return false;
+			}
+			memcpy(&rowHeader, block.data() + pos, sizeof(rowHeader));
+			if(rowHeader.Type > DebugUtilities::GetLastCpuType()) {
+				return false;
+			}
+
+			bool hasMemoryInfo = rowHeader.RowFlags & BinaryTraceRowFlags::HasMemoryInfo;
+			uint32_t rowSize = sizeof(rowHeader) + sizeof(TraceLogPpuState) + rowHeader.OpSize + rowHeader.StateSize + (hasMemoryInfo ? sizeof(BinaryTraceMemoryInfo) : 0);
+			if(pos + rowSize > header.Size) {
+				return false;
+			}
+
+			if(rowIndex >= startRow) {
+				BinaryTraceRow row = {};
+				row.Type = rowHeader.Type;
+				memcpy(&row.PpuState, block.data() + pos + sizeof(rowHeader), sizeof(TraceLogPpuState));
+				row.Disassembly.Initialize(block.data() + pos + sizeof(rowHeader) + sizeof(TraceLogPpuState), rowHeader.OpSize, rowHeader.Flags, rowHeader.Type);
+				row.CpuState = block.data() + pos + sizeof(rowHeader) + sizeof(TraceLogPpuState) + rowHeader.OpSize;
+				row.StateSize = rowHeader.StateSize;
+				row.HasMemoryInfo = hasMemoryInfo;
+				if(hasMemoryInfo) {
+					memcpy(&row.MemoryInfo, row.CpuState + rowHeader.StateSize, sizeof(BinaryTraceMemoryInfo));
+				}
+				if(!callback(row)) {
+					return true;
+				}
+			}
+			pos += rowSize;
+		}
+	}
+
+	return true;
+}
@@ -1,48 +1,136 @@
 #pragma once
 #include "pch.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include "Debugger/ITraceLogger.h"
+#include "Debugger/DisassemblyInfo.h"
 
+//Header written before each row of a binary trace log, followed by the PPU state,
+//the instruction's byte code (OpSize bytes), the raw CPU state (StateSize bytes)
+//and a BinaryTraceMemoryInfo when RowFlags contains BinaryTraceRowFlags::HasMemoryInfo
+struct BinaryTraceRowHeader
+{
+	CpuType Type;
+	uint8_t Flags;
+	uint8_t OpSize;
+	uint8_t RowFlags;
+	uint16_t StateSize;
+	uint16_t Reserved;
+};
+
+namespace BinaryTraceRowFlags
+{
+	enum BinaryTraceRowFlags : uint8_t
+	{
+		HasMemoryInfo = 0x01
+	};
+}
+
+//Effective address & memory value of the instruction, recorded when the row is logged
+//(they depend on the memory contents at that time, so they can't be calculated when the log is read back)
+struct BinaryTraceMemoryInfo
+{
+	int32_t Address;
+	uint16_t Value;
+	uint8_t Type; //MemoryType
+	uint8_t ValueSize;
+	uint8_t ShowAddress;
+	uint8_t Reserved[3];
+};
+
+//A row read back from a binary trace log (CpuState is only valid during the callback)
+struct BinaryTraceRow
+{
+	CpuType Type;
+	DisassemblyInfo Disassembly;
+	TraceLogPpuState PpuState;
+	const uint8_t* CpuState;
+	uint32_t StateSize;
+	bool HasMemoryInfo;
+	BinaryTraceMemoryInfo MemoryInfo;
+};
+
+//Writes the trace log to a file, either as text or in a binary format that stores the raw
+//CPU state for each row and is only formatted to text when it is read back (see Debugger::ConvertBinaryTraceLog).
+//Rows are appended to one of 2 buffers on the emulation thread, a background thread writes
+//(and for binary logs, LZ4-compresses) the other one.
 class TraceLogFileSaver
 {
 private:
+	static constexpr uint32_t BufferSize = 0x100000;
+	static constexpr uint32_t BinaryMagic = 0x4352544D; //"MTRC"
+	static constexpr uint32_t BinaryVersion = 1;
+
 	bool _enabled = false;
-	string _outputFilepath;
-	string _outputBuffer;
+	bool _binary = false;
 	ofstream _outputFile;
 
+	vector<uint8_t> _buffers[2];
+	uint8_t* _buffer = nullptr;
+	uint32_t _bufferPos = 0;
+	uint32_t _bufferRows = 0;
+	int _activeBuffer = 0;
+
+	std::thread _writerThread;
+	std::mutex _writerLock;
+	std::condition_variable _writerSignal;
+	int _pendingBuffer = -1;
+	uint32_t _pendingSize = 0;
+	uint32_t _pendingRows = 0;
+	bool _stopWriter = false;
+	vector<uint8_t> _compressBuffer;
+
+	void WriterLoop();
+	void WriteBlock(uint8_t* data, uint32_t size, uint32_t rowCount);
+	void SwapBuffers();
+
 public:
-	~TraceLogFileSaver()
-	{
-		StopLogging();
-	}
+	~TraceLogFileSaver();
 
-	void StartLogging(string filename)
-	{
-		_outputBuffer.clear();
-		_outputFile.open(filename, ios::out | ios::binary);
-		_enabled = true;
-	}
+	void StartLogging(string filename, bool binary = false);
+	void StopLogging();
 
-	void StopLogging()
+	__forceinline bool IsEnabled() { return _enabled; }
+	__forceinline bool IsBinary() { return _binary; }
+
+	void Log(string& log)
 	{
-		if(_enabled) {
-			_enabled = false;
-			if(_outputFile) {
-				if(!_outputBuffer.empty()) {
-					_outputFile << _outputBuffer;
-				}
-				_outputFile.close();
+		uint32_t size = (uint32_t)log.size() + 1;
+		if(_bufferPos + size > BufferSize) {
+			SwapBuffers();
+			if(size > BufferSize) {
+				return;
 			}
 		}
-	}
 
-	__forceinline bool IsEnabled() { return _enabled; }
+		memcpy(_buffer + _bufferPos, log.c_str(), log.size());
+		_buffer[_bufferPos + log.size()] = '\n';
+		_bufferPos += size;
+	}
 
-	void Log(string& log)
+	//memoryInfo is optional (nullptr when the trace format doesn't display the effective address or memory value)
+	__forceinline void LogBinary(CpuType cpuType, DisassemblyInfo& disassemblyInfo, void* cpuState, uint16_t stateSize, TraceLogPpuState& ppuState, BinaryTraceMemoryInfo* memoryInfo)
 	{
-		_outputBuffer += log + '\n';
-		if(_outputBuffer.size() > 32768) {
-			_outputFile << _outputBuffer;
-			_outputBuffer.clear();
+		BinaryTraceRowHeader header = { cpuType, disassemblyInfo.GetFlags(), disassemblyInfo.GetOpSize(), (uint8_t)(memoryInfo ? BinaryTraceRowFlags::HasMemoryInfo : 0), stateSize, 0 };
+		uint32_t size = sizeof(header) + sizeof(TraceLogPpuState) + header.OpSize + stateSize + (memoryInfo ? sizeof(BinaryTraceMemoryInfo) : 0);
+		if(_bufferPos + size > BufferSize) {
+			SwapBuffers();
 		}
+
+		uint8_t* out = _buffer + _bufferPos;
+		memcpy(out, &header, sizeof(header));
+		memcpy(out + sizeof(header), &ppuState, sizeof(TraceLogPpuState));
+		memcpy(out + sizeof(header) + sizeof(TraceLogPpuState), disassemblyInfo.GetByteCode(), header.OpSize);
+		memcpy(out + sizeof(header) + sizeof(TraceLogPpuState) + header.OpSize, cpuState, stateSize);
+		if(memoryInfo) {
+			memcpy(out + sizeof(header) + sizeof(TraceLogPpuState) + header.OpSize + stateSize, memoryInfo, sizeof(BinaryTraceMemoryInfo));
+		}
+		_bufferPos += size;
+		_bufferRows++;
 	}
-};
\ No newline at end of file
+
+	//Calls callback for each row, starting at startRow, until it returns false - returns false if the file is not a valid binary trace log
+	static bool ReadBinaryLog(string filename, uint64_t startRow, const std::function<bool(BinaryTraceRow&)>& callback);
+};
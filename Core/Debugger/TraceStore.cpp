@@ -0,0 +1,170 @@
+#include "pch.h"
+#include "Debugger/TraceStore.h"
+
+TraceStore::Chunk::Chunk()
+{
+	Type.resize(ChunkSize);
+	OpSize.resize(ChunkSize);
+	ByteCode.resize(ChunkSize);
+	ProgramCounter.resize(ChunkSize);
+	A.resize(ChunkSize);
+	X.resize(ChunkSize);
+	Y.resize(ChunkSize);
+	SP.resize(ChunkSize);
+	PS.resize(ChunkSize);
+	EffectiveAddress.resize(ChunkSize);
+	CycleCount.resize(ChunkSize);
+	FrameCount.resize(ChunkSize);
+	Scanline.resize(ChunkSize);
+}
+
+void TraceStore::Chunk::Reset(uint64_t firstRowId)
+{
+	FirstRowId = firstRowId;
+	RowCount = 0;
+	CpuMask = 0;
+	MinPc = UINT32_MAX;
+	MaxPc = 0;
+	MinAddr = INT32_MAX;
+	MaxAddr = INT32_MIN;
+	MinFrame = UINT32_MAX;
+	MaxFrame = 0;
+}
+
+bool TraceStore::Chunk::CanMatch(const TraceStoreQuery& query)
+{
+	if(RowCount == 0 || (query.CpuMask && !(query.CpuMask & CpuMask))) {
+		return false;
+	}
+	if(query.EffectiveAddress.Enabled && MinAddr > MaxAddr) {
+		//No row in this chunk accessed memory
+		return false;
+	}
+	return query.ProgramCounter.Overlaps(MinPc, MaxPc) && query.EffectiveAddress.Overlaps(MinAddr, MaxAddr) && query.FrameCount.Overlaps(MinFrame, MaxFrame);
+}
+
+void TraceStore::Chunk::GetRow(uint32_t i, TraceStoreRow& row)
+{
+	row.Type = Type[i];
+	row.OpSize = OpSize[i];
+	row.ByteCode = ByteCode[i];
+	row.ProgramCounter = ProgramCounter[i];
+	row.A = A[i];
+	row.X = X[i];
+	row.Y = Y[i];
+	row.SP = SP[i];
+	row.PS = PS[i];
+	row.EffectiveAddress = EffectiveAddress[i];
+	row.CycleCount = CycleCount[i];
+	row.FrameCount = FrameCount[i];
+	row.Scanline = Scanline[i];
+}
+
+void TraceStore::Start(uint32_t maxRows)
+{
+	uint32_t maxChunks = std::max<uint32_t>(1, (maxRows + ChunkSize - 1) / ChunkSize);
+	if(maxChunks != _maxChunks) {
+		_maxChunks = maxChunks;
+		while(_chunks.size() > _maxChunks) {
+			_chunks.pop_front();
+		}
+	}
+
+	if(_chunks.empty()) {
+		AddChunk();
+	}
+	_enabled = true;
+}
+
+void TraceStore::Stop()
+{
+	_enabled = false;
+}
+
+void TraceStore::Clear()
+{
+	_chunks.clear();
+	_current = nullptr;
+	if(_enabled) {
+		AddChunk();
+	}
+}
+
+void TraceStore::AddChunk()
+{
+	unique_ptr<Chunk> chunk;
+	if(_chunks.size() >= _maxChunks) {
+		//Recycle the oldest chunk's memory
+		chunk = std::move(_chunks.front());
+		_chunks.pop_front();
+	} else {
+		chunk.reset(new Chunk());
+	}
+
+	chunk->Reset(_nextRowId);
+	_current = chunk.get();
+	_chunks.push_back(std::move(chunk));
+}
+
+uint64_t TraceStore::GetRowCount()
+{
+	return _chunks.empty() ? 0 : _nextRowId - _chunks.front()->FirstRowId;
+}
+
+uint64_t TraceStore::GetFirstRowId()
+{
+	return _chunks.empty() ? _nextRowId : _chunks.front()->FirstRowId;
+}
+
+uint64_t TraceStore::GetMemorySize()
+{
+	constexpr uint32_t rowSize = sizeof(CpuType) + sizeof(uint8_t) + sizeof(uint32_t) * 8 + sizeof(int32_t) + sizeof(uint64_t) + sizeof(int16_t);
+	return (uint64_t)_chunks.size() * ChunkSize * rowSize;
+}
+
+void TraceStore::Query(const TraceStoreQuery& query, TraceStoreQueryResult& result)
+{
+	for(unique_ptr<Chunk>& chunkPtr : _chunks) {
+		Chunk& c = *chunkPtr;
+		if(c.FirstRowId + c.RowCount <= query.StartRow) {
+			continue;
+		}
+
+		if(!c.CanMatch(query)) {
+			result.SkippedChunks++;
+			continue;
+		}
+
+		result.ScannedChunks++;
+		uint32_t start = query.StartRow > c.FirstRowId ? (uint32_t)(query.StartRow - c.FirstRowId) : 0;
+		result.ScannedRows += c.RowCount - start;
+		for(uint32_t i = start; i < c.RowCount; i++) {
+			if(!query.ProgramCounter.Contains(c.ProgramCounter[i])) {
+				continue;
+			}
+			if(query.EffectiveAddress.Enabled && (c.EffectiveAddress[i] < 0 || !query.EffectiveAddress.Contains(c.EffectiveAddress[i]))) {
+				continue;
+			}
+			if(query.CpuMask && !(query.CpuMask & (1 << (int)c.Type[i]))) {
+				continue;
+			}
+			if(!query.OpCode.Contains(c.ByteCode[i] & 0xFF) || !query.FrameCount.Contains(c.FrameCount[i])) {
+				continue;
+			}
+			if(!query.A.Contains(c.A[i]) || !query.X.Contains(c.X[i]) || !query.Y.Contains(c.Y[i]) || !query.SP.Contains(c.SP[i]) || !query.PS.Contains(c.PS[i])) {
+				continue;
+			}
+
+			if(result.Rows.size() >= query.MaxResults) {
+				result.ScannedRows -= c.RowCount - i;
+				result.NextRow = c.FirstRowId + i;
+				return;
+			}
+
+			TraceStoreRow row;
+			c.GetRow(i, row);
+			result.Rows.push_back(row);
+			result.RowIds.push_back(c.FirstRowId + i);
+		}
+	}
+}
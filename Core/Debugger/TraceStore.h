@@ -0,0 +1,159 @@
+#pragma once
+#include "pch.h"
+#include <deque>
+#include "Debugger/DebugTypes.h"
+
+struct TraceStoreRow
+{
+	CpuType Type;
+	uint8_t OpSize;
+	uint32_t ByteCode; //First 4 bytes of the instruction (little endian)
+	uint32_t ProgramCounter;
+	uint32_t A;
+	uint32_t X;
+	uint32_t Y;
+	uint32_t SP;
+	uint32_t PS;
+	int32_t EffectiveAddress; //-1 if the instruction doesn't access memory
+	uint64_t CycleCount;
+	uint32_t FrameCount;
+	int16_t Scanline;
+};
+
+//Inclusive [Min, Max] value range for a TraceStoreQuery column
+struct TraceStoreRange
+{
+	bool Enabled = false;
+	int64_t Min = 0;
+	int64_t Max = 0;
+
+	__forceinline bool Contains(int64_t value) const { return !Enabled || (value >= Min && value <= Max); }
+	__forceinline bool Overlaps(int64_t min, int64_t max) const { return !Enabled || (min <= Max && max >= Min); }
+};
+
+struct TraceStoreQuery
+{
+	uint32_t CpuMask = 0; //Bit per CpuType, 0 = any CPU
+	TraceStoreRange ProgramCounter;
+	TraceStoreRange EffectiveAddress;
+	TraceStoreRange OpCode;
+	TraceStoreRange A;
+	TraceStoreRange X;
+	TraceStoreRange Y;
+	TraceStoreRange SP;
+	TraceStoreRange PS;
+	TraceStoreRange FrameCount;
+	uint64_t StartRow = 0;
+	uint32_t MaxResults = 100;
+};
+
+struct TraceStoreQueryResult
+{
+	vector<uint64_t> RowIds;
+	vector<TraceStoreRow> Rows;
+	uint64_t ScannedRows = 0;
+	uint32_t ScannedChunks = 0;
+	uint32_t SkippedChunks = 0;
+	uint64_t NextRow = 0; //Row to resume from when the result is truncated (0 = done)
+};
+
+//Opt-in columnar store for execution trace rows, filled by the trace loggers while enabled.
+//Rows are kept in fixed-size chunks (each column in its own array), with per-chunk min/max
+//summaries so queries can skip whole chunks. The oldest chunk is recycled once MaxRows is reached.
+//Not thread-safe: rows are added on the emulation thread, callers must break execution (DebugBreakHelper) before querying.
+class TraceStore
+{
+private:
+	static constexpr uint32_t ChunkSize = 0x10000;
+
+	struct Chunk
+	{
+		uint64_t FirstRowId = 0;
+		uint32_t RowCount = 0;
+
+		uint32_t CpuMask = 0;
+		uint32_t MinPc = UINT32_MAX;
+		uint32_t MaxPc = 0;
+		int32_t MinAddr = INT32_MAX;
+		int32_t MaxAddr = INT32_MIN;
+		uint32_t MinFrame = UINT32_MAX;
+		uint32_t MaxFrame = 0;
+
+		vector<CpuType> Type;
+		vector<uint8_t> OpSize;
+		vector<uint32_t> ByteCode;
+		vector<uint32_t> ProgramCounter;
+		vector<uint32_t> A;
+		vector<uint32_t> X;
+		vector<uint32_t> Y;
+		vector<uint32_t> SP;
+		vector<uint32_t> PS;
+		vector<int32_t> EffectiveAddress;
+		vector<uint64_t> CycleCount;
+		vector<uint32_t> FrameCount;
+		vector<int16_t> Scanline;
+
+		Chunk();
+		void Reset(uint64_t firstRowId);
+		bool CanMatch(const TraceStoreQuery& query);
+		void GetRow(uint32_t index, TraceStoreRow& row);
+	};
+
+	bool _enabled = false;
+	uint32_t _maxChunks = 0;
+	uint64_t _nextRowId = 0;
+	std::deque<unique_ptr<Chunk>> _chunks;
+	Chunk* _current = nullptr;
+
+	void AddChunk();
+
+public:
+	static constexpr uint32_t DefaultMaxRows = 4 * 1024 * 1024;
+
+	void Start(uint32_t maxRows = DefaultMaxRows);
+	void Stop();
+	void Clear();
+
+	__forceinline bool IsEnabled() { return _enabled; }
+
+	uint64_t GetRowCount();
+	uint64_t GetFirstRowId();
+	uint32_t GetMaxRows() { return _maxChunks * ChunkSize; }
+	uint64_t GetMemorySize();
+
+	__forceinline void AddRow(TraceStoreRow& row)
+	{
+		if(_current->RowCount == ChunkSize) {
+			AddChunk();
+		}
+
+		Chunk& c = *_current;
+		uint32_t i = c.RowCount++;
+		c.Type[i] = row.Type;
+		c.OpSize[i] = row.OpSize;
+		c.ByteCode[i] = row.ByteCode;
+		c.ProgramCounter[i] = row.ProgramCounter;
+		c.A[i] = row.A;
+		c.X[i] = row.X;
+		c.Y[i] = row.Y;
+		c.SP[i] = row.SP;
+		c.PS[i] = row.PS;
+		c.EffectiveAddress[i] = row.EffectiveAddress;
+		c.CycleCount[i] = row.CycleCount;
+		c.FrameCount[i] = row.FrameCount;
+		c.Scanline[i] = row.Scanline;
+
+		c.CpuMask |= 1 << (int)row.Type;
+		c.MinPc = std::min(c.MinPc, row.ProgramCounter);
+		c.MaxPc = std::max(c.MaxPc, row.ProgramCounter);
+		if(row.EffectiveAddress >= 0) {
+			c.MinAddr = std::min(c.MinAddr, row.EffectiveAddress);
+			c.MaxAddr = std::max(c.MaxAddr, row.EffectiveAddress);
+		}
+		c.MinFrame = std::min(c.MinFrame, row.FrameCount);
+		c.MaxFrame = std::max(c.MaxFrame, row.FrameCount);
+		_nextRowId++;
+	}
+
+	void Query(const TraceStoreQuery& query, TraceStoreQueryResult& result);
+};
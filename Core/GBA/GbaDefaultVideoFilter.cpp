@@ -7,6 +7,7 @@
 #include "Shared/RewindManager.h"
 #include "Shared/SettingTypes.h"
 #include "Shared/ColorUtilities.h"
+#include "Shared/Video/PixelConverter.h"
 
 GbaDefaultVideoFilter::GbaDefaultVideoFilter(Emulator* emu, bool applyNtscFilter) : BaseVideoFilter(emu), _ntscFilter(emu)
 {
@@ -67,6 +68,7 @@ void GbaDefaultVideoFilter::InitLookupTable()
 		}
 	}
 
+	_useLookupTable = _gbaAdjustColors || config.Hue != 0 || config.Saturation != 0 || config.Brightness != 0 || config.Contrast != 0;
 	_videoConfig = config;
 }
 
@@ -93,10 +95,16 @@ void GbaDefaultVideoFilter::ApplyFilter(uint16_t* ppuOutputBuffer)
 {
 	uint32_t* out = GetOutputBuffer();
 
-	for(uint32_t i = 0; i < GbaConstants::ScreenHeight; i++) {
-		for(uint32_t j = 0; j < GbaConstants::ScreenWidth; j++) {
-			out[i * GbaConstants::ScreenWidth + j] = GetPixel(ppuOutputBuffer, i * GbaConstants::ScreenWidth + j);
+	if(_useLookupTable) {
+		for(uint32_t i = 0; i < GbaConstants::ScreenHeight; i++) {
+			for(uint32_t j = 0; j < GbaConstants::ScreenWidth; j++) {
+				out[i * GbaConstants::ScreenWidth + j] = GetPixel(ppuOutputBuffer, i * GbaConstants::ScreenWidth + j);
+			}
 		}
+	} else if(_blendFrames) {
+		PixelConverter::ConvertAndBlendRgb555(_prevFrame, ppuOutputBuffer, out, GbaConstants::PixelCount);
+	} else {
+		PixelConverter::ConvertRgb555(ppuOutputBuffer, out, GbaConstants::PixelCount);
 	}
 
 	if(_blendFrames) {
@@ -10,6 +10,7 @@ class GbaDefaultVideoFilter : public BaseVideoFilter
 {
 private:
 	uint32_t _calculatedPalette[0x8000] = {};
+	bool _useLookupTable = false; //When false, colors are converted with PixelConverter (same result, no color adjustments)
 	VideoConfig _videoConfig = {};
 
 	uint16_t* _prevFrame = nullptr;
@@ -158,6 +158,9 @@ void GbaPpu::ProcessEndOfScanline()
 			(settings->GetEmulationSpeed() == 0 || settings->GetEmulationSpeed() > 150) &&
 			_frameSkipTimer.GetElapsedMS() < 15
 		);
+		if(_emu->IsHeadlessRenderSkipped()) {
+			_skipRender = true;
+		}
 		if(!_skipRender) {
 			_currentBuffer = _currentBuffer == _outputBuffers[0] ? _outputBuffers[1] : _outputBuffers[0];
 		}
@@ -8,6 +8,7 @@
 #include "Shared/RewindManager.h"
 #include "Shared/SettingTypes.h"
 #include "Shared/ColorUtilities.h"
+#include "Shared/Video/PixelConverter.h"
 
 GbDefaultVideoFilter::GbDefaultVideoFilter(Emulator* emu, bool applyNtscFilter) : BaseVideoFilter(emu), _ntscFilter(emu)
 {
@@ -72,6 +73,7 @@ void GbDefaultVideoFilter::InitLookupTable()
 		}
 	}
 
+	_useLookupTable = _gbcAdjustColors || config.Hue != 0 || config.Saturation != 0 || config.Brightness != 0 || config.Contrast != 0;
 	_videoConfig = config;
 }
 
@@ -101,10 +103,16 @@ void GbDefaultVideoFilter::ApplyFilter(uint16_t* ppuOutputBuffer)
 
 	uint32_t* out = GetOutputBuffer();
 	
-	for(uint32_t i = 0; i < GbConstants::ScreenHeight; i++) {
-		for(uint32_t j = 0; j < GbConstants::ScreenWidth; j++) {
-			out[i * GbConstants::ScreenWidth + j] = GetPixel(ppuOutputBuffer, i * GbConstants::ScreenWidth + j);
+	if(_useLookupTable) {
+		for(uint32_t i = 0; i < GbConstants::ScreenHeight; i++) {
+			for(uint32_t j = 0; j < GbConstants::ScreenWidth; j++) {
+				out[i * GbConstants::ScreenWidth + j] = GetPixel(ppuOutputBuffer, i * GbConstants::ScreenWidth + j);
+			}
 		}
+	} else if(_blendFrames) {
+		PixelConverter::ConvertAndBlendRgb555(_prevFrame, ppuOutputBuffer, out, GbConstants::PixelCount);
+	} else {
+		PixelConverter::ConvertRgb555(ppuOutputBuffer, out, GbConstants::PixelCount);
 	}
 
 	if(_blendFrames) {
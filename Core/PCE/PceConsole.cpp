@@ -277,7 +277,7 @@ PpuFrameInfo PceConsole::GetPpuFrame()
 	//TODO - height/width/scanlinecount vary based on VDC settings
 	frame.Height = PceConstants::InternalOutputHeight;
 	frame.Width = PceConstants::InternalOutputWidth;
-	frame.FrameBufferSize = PceConstants::MaxScreenWidth * (PceConstants::ScreenHeight + 1) * sizeof(uint16_t);
+	frame.FrameBufferSize = PceConstants::OutputBufferSize * sizeof(uint16_t);
 	return frame;
 }
 
@@ -12,6 +12,9 @@ public:
 	static constexpr uint32_t MaxScreenWidth = PceConstants::ClockPerScanline / 2;
 	static constexpr uint32_t ScreenHeight = 242;
 
+	//Size of the VPC's output buffers, in pixels - the extra line stores the clock divider used by each row
+	static constexpr uint32_t OutputBufferSize = PceConstants::MaxScreenWidth * (PceConstants::ScreenHeight + 1);
+
 	static constexpr int RowOverscanSize = 18;
 	static constexpr int InternalResMultipler = 4;
 
@@ -21,7 +21,7 @@ PceVpc::PceVpc(Emulator* emu, PceConsole* console, PceVce* vce)
 	_vce = vce;
 
 	//Add an extra line to the buffer - this is used to store clock divider values for each row
-	uint32_t bufferSize = PceConstants::MaxScreenWidth * (PceConstants::ScreenHeight + 1);
+	uint32_t bufferSize = PceConstants::OutputBufferSize;
 	_outBuffer[0] = new uint16_t[bufferSize];
 	_outBuffer[1] = new uint16_t[bufferSize];
 	_currentOutBuffer = _outBuffer[0];
@@ -155,7 +155,7 @@ void PceVpc::ProcessStartFrame()
 		_frameSkipTimer.Reset();
 	}
 
-	if(_emu->IsRunAheadFrame()) {
+	if(_emu->IsRunAheadFrame() || _emu->IsHeadlessRenderSkipped()) {
 		_skipRender = true;
 	} else {
 		_skipRender = (
@@ -293,9 +293,11 @@ void PceVpc::SendFrame(PceVdc* vdc)
 	if(!_skipRender) {
 		if(_console->GetRomFormat() == RomFormat::PceHes) {
 			RenderedFrame frame(_currentOutBuffer, 256, 240, 1.0, _vdc1->GetState().FrameCount, _console->GetControlManager()->GetPortStates());
+			frame.FrameBufferSize = PceConstants::OutputBufferSize * sizeof(uint16_t);
 			_emu->GetVideoDecoder()->UpdateFrame(frame, forRewind, forRewind);
 		} else {
 			RenderedFrame frame(_currentOutBuffer, PceConstants::InternalOutputWidth, PceConstants::InternalOutputHeight, 1.0 / PceConstants::InternalResMultipler, _vdc1->GetState().FrameCount, _console->GetControlManager()->GetPortStates());
+			frame.FrameBufferSize = PceConstants::OutputBufferSize * sizeof(uint16_t);
 			_emu->GetVideoDecoder()->UpdateFrame(frame, forRewind, forRewind);
 		}
 	}
@@ -323,6 +325,7 @@ void PceVpc::DebugSendFrame()
 	}
 
 	RenderedFrame frame(_currentOutBuffer, PceConstants::InternalOutputWidth, PceConstants::InternalOutputHeight, 0.25, _vdc1->GetState().FrameCount);
+	frame.FrameBufferSize = PceConstants::OutputBufferSize * sizeof(uint16_t);
 	_emu->GetVideoDecoder()->UpdateFrame(frame, false, false);
 }
 
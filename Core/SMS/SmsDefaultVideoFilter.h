@@ -7,11 +7,13 @@
 #include "Shared/Emulator.h"
 #include "Shared/RewindManager.h"
 #include "Shared/ColorUtilities.h"
+#include "Shared/Video/PixelConverter.h"
 
 class SmsDefaultVideoFilter : public BaseVideoFilter
 {
 private:
 	uint32_t _calculatedPalette[0x8000] = {};
+	bool _useLookupTable = false; //When false, colors are converted with PixelConverter (same result, no color adjustments)
 	VideoConfig _videoConfig = {};
 	uint16_t _prevFrame[256 * 240] = {};
 	bool _blendFrames = false;
@@ -54,6 +56,7 @@ protected:
 			}
 		}
 
+		_useLookupTable = config.Hue != 0 || config.Saturation != 0 || config.Brightness != 0 || config.Contrast != 0;
 		_videoConfig = config;
 	}
 
@@ -71,6 +74,19 @@ protected:
 		return ((((a) ^ (b)) & 0xfffefefeL) >> 1) + ((a) & (b));
 	}
 
+	void ConvertPixels(uint16_t* vdpFrame, uint32_t offset, uint32_t* out, uint32_t count)
+	{
+		if(_useLookupTable) {
+			for(uint32_t i = 0; i < count; i++) {
+				out[i] = GetPixel(vdpFrame, offset + i);
+			}
+		} else if(_blendFrames) {
+			PixelConverter::ConvertAndBlendRgb555(_prevFrame + offset, vdpFrame + offset, out, count);
+		} else {
+			PixelConverter::ConvertRgb555(vdpFrame + offset, out, count);
+		}
+	}
+
 public:
 	SmsDefaultVideoFilter(Emulator* emu, SmsConsole* console) : BaseVideoFilter(emu)
 	{
@@ -95,9 +111,7 @@ public:
 			}
 
 			for(uint32_t y = 0; y < frame.Height; y++) {
-				for(uint32_t x = 0; x < frame.Width; x++) {
-					out[(y * frame.Width) + x] = GetPixel(in, (y + linesToSkip) * 256 + x + 48);
-				}
+				ConvertPixels(in, (y + linesToSkip) * 256 + 48, out + y * frame.Width, frame.Width);
 			}
 
 			if(_blendFrames) {
@@ -111,9 +125,7 @@ public:
 				if(y + overscan.Top < linesToSkip || y > linesToSkip + scanlineCount - overscan.Top) {
 					memset(out+y*frame.Width, 0, frame.Width * sizeof(uint32_t));
 				} else {
-					for(uint32_t x = 0; x < frame.Width; x++) {
-						out[(y * frame.Width) + x] = GetPixel(in, (y + overscan.Top - linesToSkip) * _baseFrameInfo.Width + x + overscan.Left);
-					}
+					ConvertPixels(in, (y + overscan.Top - linesToSkip) * _baseFrameInfo.Width + overscan.Left, out + y * frame.Width, frame.Width);
 				}
 			}
 		}
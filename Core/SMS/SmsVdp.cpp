@@ -427,6 +427,7 @@ void SmsVdp::ProcessScanlineEvents()
 				uint32_t width = _console->GetModel() == SmsModel::Sms ? 256 : 160;
 				uint32_t height = _console->GetModel() == SmsModel::Sms ? 240 : 144;
 				RenderedFrame frame(_currentOutputBuffer, width, height, 1.0, _state.FrameCount, _console->GetControlManager()->GetPortStates());
+				frame.FrameBufferSize = 256 * 240 * sizeof(uint16_t); //Game Gear frames are read from the full SMS-sized buffer
 				bool rewinding = _emu->GetRewindManager()->IsRewinding();
 				_emu->GetVideoDecoder()->UpdateFrame(frame, rewinding, rewinding);
 
@@ -911,6 +912,7 @@ void SmsVdp::DebugSendFrame()
 	
 	uint32_t height = _console->GetModel() == SmsModel::Sms ? 240 : 144;
 	RenderedFrame frame(_currentOutputBuffer, width, height, 1.0, _state.FrameCount);
+	frame.FrameBufferSize = 256 * 240 * sizeof(uint16_t);
 	_emu->GetVideoDecoder()->UpdateFrame(frame, false, false);
 }
 
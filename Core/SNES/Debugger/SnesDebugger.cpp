@@ -47,6 +47,7 @@ SnesDebugger::SnesDebugger(Debugger* debugger, CpuType cpuType) : IDebugger(debu
 
 	_debugger = debugger;
 	_emu = debugger->GetEmulator();
+	_socketState = _emu->GetSocketState();
 	SnesConsole* console = (SnesConsole*)debugger->GetConsole();
 	_console = console;
 	_disassembler = debugger->GetDisassembler();
@@ -141,13 +142,13 @@ void SnesDebugger::ProcessInstruction()
 	uint32_t pc = (state.K << 16) | state.PC;
 	
 	// Logpoints: Check if current PC has a logpoint registered
-	if (SocketServer::HasLogpoints()) {
-		SocketServer::CheckLogpoints(_cpuType, pc, _emu);
+	if (_socketState->HasLogpoint(_cpuType, pc)) {
+		SocketServer::CheckLogpoints(_debugger, _cpuType, pc, _emu);
 	}
 
 	// P register change tracking: Log if P changed since last instruction
-	if (SocketServer::IsPRegisterWatchEnabled() && state.PS != _prevPRegister) {
-		SocketServer::LogPRegisterChange(_prevProgramCounter, _prevPRegister, state.PS, _prevOpCode, state.CycleCount);
+	if (_socketState->IsPRegisterWatchEnabled() && state.PS != _prevPRegister) {
+		_socketState->LogPRegisterChange(_prevProgramCounter, _prevPRegister, state.PS, _prevOpCode, state.CycleCount);
 	}
 
 	AddressInfo addressInfo = GetAbsoluteAddress(pc);
@@ -276,9 +277,9 @@ void SnesDebugger::ProcessWrite(uint32_t addr, uint8_t value, MemoryOperationTyp
 	if (addressInfo.Type == MemoryType::SnesWorkRam && addressInfo.Address >= 0) {
 		absoluteAddr = 0x7E0000 + addressInfo.Address;
 	}
-	if (SocketServer::HasMemoryWatch(absoluteAddr)) {
+	if (_socketState->HasMemoryWatch(absoluteAddr)) {
 		SnesCpuState& state = GetCpuState();
-		SocketServer::LogMemoryWrite(_prevProgramCounter, absoluteAddr, value, 1, state.CycleCount, state.SP);
+		_socketState->LogMemoryWrite(_prevProgramCounter, absoluteAddr, value, 1, state.CycleCount, state.SP);
 	}
 
 	if(addressInfo.Address >= 0 && (addressInfo.Type == MemoryType::SnesWorkRam || addressInfo.Type == MemoryType::SnesSaveRam)) {
@@ -27,6 +27,7 @@ class SnesAssembler;
 class SnesPpuTools;
 class PpuTools;
 class DummySnesCpu;
+struct SocketInstanceState;
 enum class MemoryOperationType;
 
 class SnesDebugger final : public IDebugger
@@ -45,6 +46,7 @@ class SnesDebugger final : public IDebugger
 	SnesPpu* _ppu;
 	MemoryMappings* _memoryMappings;
 	SnesCodeDataLogger* _cdl;
+	SocketInstanceState* _socketState;
 
 	unique_ptr<SnesCodeDataLogger> _codeDataLogger;
 	unique_ptr<BaseEventManager> _eventManager;
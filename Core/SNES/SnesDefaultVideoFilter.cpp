@@ -6,6 +6,7 @@
 #include "Shared/EmuSettings.h"
 #include "Shared/SettingTypes.h"
 #include "Shared/ColorUtilities.h"
+#include "Shared/Video/PixelConverter.h"
 
 SnesDefaultVideoFilter::SnesDefaultVideoFilter(Emulator* emu) : BaseVideoFilter(emu)
 {
@@ -60,6 +61,7 @@ void SnesDefaultVideoFilter::InitLookupTable()
 		}
 	}
 
+	_useLookupTable = config.Hue != 0 || config.Saturation != 0 || config.Brightness != 0 || config.Contrast != 0;
 	_videoConfig = config;
 }
 
@@ -92,26 +94,29 @@ void SnesDefaultVideoFilter::ApplyFilter(uint16_t *ppuOutputBuffer)
 
 	if(_baseFrameInfo.Width == 256 && _forceFixedRes) {
 		for(uint32_t i = 0; i < frameInfo.Height; i++) {
-			for(uint32_t j = 0; j < frameInfo.Width; j++) {
-				out[i * frameInfo.Width + j] = GetPixel(ppuOutputBuffer, i / 2 * width + j / 2 + yOffset + xOffset);
+			if(_useLookupTable) {
+				for(uint32_t j = 0; j < frameInfo.Width; j++) {
+					out[i * frameInfo.Width + j] = GetPixel(ppuOutputBuffer, i / 2 * width + j / 2 + yOffset + xOffset);
+				}
+			} else {
+				PixelConverter::ConvertRgb555Doubled(ppuOutputBuffer + i / 2 * width + yOffset + xOffset, out + i * frameInfo.Width, frameInfo.Width / 2);
 			}
 		}
 	} else {
 		for(uint32_t i = 0; i < frameInfo.Height; i++) {
-			for(uint32_t j = 0; j < frameInfo.Width; j++) {
-				out[i*frameInfo.Width+j] = GetPixel(ppuOutputBuffer, i * width + j + yOffset + xOffset);
+			if(_useLookupTable) {
+				for(uint32_t j = 0; j < frameInfo.Width; j++) {
+					out[i*frameInfo.Width+j] = GetPixel(ppuOutputBuffer, i * width + j + yOffset + xOffset);
+				}
+			} else {
+				PixelConverter::ConvertRgb555(ppuOutputBuffer + i * width + yOffset + xOffset, out + i * frameInfo.Width, frameInfo.Width);
 			}
 		}
 	}
 
 	if(_baseFrameInfo.Width == 512 && _blendHighRes) {
-		//Very basic blend effect for high resolution modes
-		for(uint32_t i = 0; i < frameInfo.Height; i++) {
-			for(uint32_t j = 0; j < frameInfo.Width; j++) {
-				uint32_t &pixel1 = out[i*frameInfo.Width + j];
-				pixel1 = BlendPixels(pixel1, out[i * frameInfo.Width + j + 1]);
-			}
-		}
+		//Very basic blend effect for high resolution modes (each pixel is blended with the one on its right)
+		PixelConverter::BlendWithNextPixel(out, frameInfo.Width * frameInfo.Height);
 	}
 }
 
@@ -119,8 +124,3 @@ uint32_t SnesDefaultVideoFilter::GetPixel(uint16_t* ppuFrame, uint32_t offset)
 {
 	return _calculatedPalette[ppuFrame[offset]];
 }
-
-uint32_t SnesDefaultVideoFilter::BlendPixels(uint32_t a, uint32_t b)
-{
-	return ((((a) ^ (b)) & 0xfffefefeL) >> 1) + ((a) & (b));
-}
@@ -500,7 +500,7 @@ bool SnesPpu::ProcessEndOfScanline(uint16_t& hClock)
 				_frameSkipTimer.GetElapsedMS() < 10
 			);
 			
-			if(_emu->IsRunAheadFrame()) {
+			if(_emu->IsRunAheadFrame() || _emu->IsHeadlessRenderSkipped()) {
 				_skipRender = true;
 			}
 
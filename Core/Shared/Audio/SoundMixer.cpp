@@ -65,7 +65,8 @@ void SoundMixer::StopAudio(bool clearBuffer)
 
 void SoundMixer::PlayAudioBuffer(int16_t* samples, uint32_t sampleCount, uint32_t sourceRate)
 {
-	if(sampleCount == 0) {
+	if(sampleCount == 0 || _emu->IsHeadlessFrame()) {
+		//Headless frames are never heard - skip resampling and effects entirely
 		return;
 	}
 
@@ -157,14 +157,20 @@ void BaseControlManager::ClearDevices()
 
 void BaseControlManager::UpdateInputState()
 {
-	KeyManager::RefreshKeyState();
+	//Secondary instances (see SocketServer) only get input from input providers, never from the host's devices
+	bool useHostInput = _emu->GetInstanceId() == 0;
+	if(useHostInput) {
+		KeyManager::RefreshKeyState();
+	}
 
 	auto lock = _deviceLock.AcquireSafe();
 
 	//string log = "F: " + std::to_string(_emu->GetFrameCount()) + " C:" + std::to_string(_pollCounter) + " ";
 	for(shared_ptr<BaseControlDevice>& device : _controlDevices) {
 		device->ClearState();
-		device->SetStateFromInput();
+		if(useHostInput) {
+			device->SetStateFromInput();
+		}
 
 		for(size_t i = 0; i < _inputProviders.size(); i++) {
 			IInputProvider* provider = _inputProviders[i];
@@ -22,6 +22,7 @@
 #include "Shared/CheatManager.h"
 #include "Shared/SystemActionManager.h"
 #include "Shared/SocketServer.h"
+#include "Shared/SharedMemoryExporter.h"
 #include "Shared/Movies/MovieManager.h"
 #include "Shared/TimingInfo.h"
 #include "Shared/HistoryViewer.h"
@@ -66,14 +67,19 @@ Emulator::Emulator() :
 	_historyViewer(new HistoryViewer(this)),
 	_gameServer(new GameServer(this)),
 	_gameClient(new GameClient(this)),
-	_rewindManager(new RewindManager(this))
+	_rewindManager(new RewindManager(this)),
+	_socketState(new SocketInstanceState())
 {
 	_paused = false;
 	_pauseOnNextFrame = false;
 	_stopFlag = false;
 	_isRunAheadFrame = false;
+	_isHeadlessFrame = false;
+	_skipHeadlessRender = false;
 	_lockCounter = 0;
 	_threadPaused = false;
+	_waitingForPauseEnd = false;
+	_pauseRequestCount = 0;
 
 	_debugRequestCount = 0;
 	_blockDebuggerRequestCount = 0;
@@ -85,7 +91,7 @@ Emulator::~Emulator()
 {
 }
 
-void Emulator::Initialize(bool enableShortcuts)
+void Emulator::Initialize(bool enableShortcuts, bool enableSocketServer)
 {
 	_systemActionManager.reset(new SystemActionManager(this));
 	if(enableShortcuts) {
@@ -96,9 +102,13 @@ void Emulator::Initialize(bool enableShortcuts)
 	_videoDecoder->StartThread();
 	_videoRenderer->StartThread();
 
+	_sharedMemoryExporter.reset(new SharedMemoryExporter(this));
+
 	// Start socket server for CLI integration
-	_socketServer.reset(new SocketServer(this));
-	_socketServer->Start();
+	if(enableSocketServer) {
+		_socketServer.reset(new SocketServer(this));
+		_socketServer->Start();
+	}
 }
 
 void Emulator::Release()
@@ -110,6 +120,7 @@ void Emulator::Release()
 		_socketServer->Stop();
 		_socketServer.reset();
 	}
+	_sharedMemoryExporter.reset();
 
 	_gameClient->Disconnect();
 	_gameServer->StopServer();
@@ -180,6 +191,61 @@ void Emulator::Run()
 	PlatformUtilities::RestoreTimerResolution();
 }
 
+uint32_t Emulator::RunHeadlessFrames(uint32_t frameCount, bool renderLastFrame, IInputProvider* inputProvider, const std::function<bool(uint32_t)>& onFrameDone)
+{
+	shared_ptr<IConsole> console = GetConsole();
+	if(!console || frameCount == 0) {
+		return 0;
+	}
+
+	//Without the debugger, pause first and wait for the emulation thread to park in WaitForPauseEnd
+	//(sleeping), otherwise it would spin in WaitForLock for the whole batch once the lock is taken
+	bool pausedForBatch = false;
+	uint32_t pauseRequestCount = _pauseRequestCount;
+	if(!_debugger && !_paused && _emuThread) {
+		_paused = true;
+		pausedForBatch = true;
+		while(!_waitingForPauseEnd && _paused && !_stopFlag && !_debugger) {
+			std::this_thread::sleep_for(std::chrono::duration<int, std::milli>(1));
+		}
+	}
+
+	auto lock = AcquireLock(false);
+
+	//This thread temporarily becomes the emulation thread
+	thread::id emulationThreadId = _emulationThreadId;
+	_emulationThreadId = std::this_thread::get_id();
+
+	if(inputProvider) {
+		console->GetControlManager()->RegisterInputProvider(inputProvider);
+	}
+
+	_isHeadlessFrame = true;
+	uint32_t framesRun = 0;
+	while(framesRun < frameCount && !_stopFlag) {
+		_skipHeadlessRender = !renderLastFrame || framesRun + 1 < frameCount;
+		console->RunFrame();
+		framesRun++;
+
+		if(onFrameDone && !onFrameDone(framesRun)) {
+			break;
+		}
+	}
+	_isHeadlessFrame = false;
+	_skipHeadlessRender = false;
+
+	if(inputProvider) {
+		console->GetControlManager()->UnregisterInputProvider(inputProvider);
+	}
+
+	_emulationThreadId = emulationThreadId;
+	if(pausedForBatch && pauseRequestCount == _pauseRequestCount) {
+		//Only resume if nothing paused/resumed the emulation during the batch
+		_paused = false;
+	}
+	return framesRun;
+}
+
 void Emulator::ProcessAutoSaveState()
 {
 	if(_autoSaveStateFrameCounter > 0) {
@@ -221,7 +287,7 @@ void Emulator::RunFrameWithRunAhead()
 	//Run a single frame and save the state (no audio/video)
 	_isRunAheadFrame = true;
 	_console->RunFrame();
-	Serialize(runAheadState, false, 0);
+	Serialize(runAheadState, false, 0, true);
 
 	while(frameCount > 1) {
 		//Run extra frames if the requested run ahead frame count is higher than 1
@@ -262,25 +328,31 @@ void Emulator::OnBeforeSendFrame()
 void Emulator::ProcessEndOfFrame()
 {
 	// Broadcast frame_complete event
-	if (_socketServer && _socketServer->IsRunning()) {
-		stringstream ss;
-		ss << "{\"frame\":" << GetFrameCount() << "}";
-		SocketServer::BroadcastEvent("frame_complete", ss.str());
+	if (SocketServer::HasEventSubscribers() && !_isHeadlessFrame) {
+		SocketServer::BroadcastEvent("frame_complete", "{\"frame\":" + std::to_string(GetFrameCount()) + "}", _instanceId);
 	}
+	_socketState->ReleaseRetiredMemoryWatchIndexes();
+	_socketState->ReleaseRetiredLogpointIndexes();
 
 	if(!_isRunAheadFrame) {
-		_frameLimiter->ProcessFrame();
-		while(_frameLimiter->WaitForNextFrame()) {
-			if(_stopFlag || _frameDelay != GetFrameDelay() || _paused || _pauseOnNextFrame || _lockCounter > 0) {
-				//Need to process another event, stop sleeping
-				break;
-			}
+		if(_sharedMemoryExporter && !_skipHeadlessRender) {
+			_sharedMemoryExporter->Publish();
 		}
 
-		double newFrameDelay = GetFrameDelay();
-		if(newFrameDelay != _frameDelay) {
-			_frameDelay = newFrameDelay;
-			_frameLimiter->SetDelay(_frameDelay);
+		if(!_isHeadlessFrame) {
+			_frameLimiter->ProcessFrame();
+			while(_frameLimiter->WaitForNextFrame()) {
+				if(_stopFlag || _frameDelay != GetFrameDelay() || _paused || _pauseOnNextFrame || _lockCounter > 0) {
+					//Need to process another event, stop sleeping
+					break;
+				}
+			}
+
+			double newFrameDelay = GetFrameDelay();
+			if(newFrameDelay != _frameDelay) {
+				_frameDelay = newFrameDelay;
+				_frameLimiter->SetDelay(_frameDelay);
+			}
 		}
 
 		_console->GetControlManager()->ProcessEndOfFrame();
@@ -777,6 +849,7 @@ void Emulator::PauseOnNextFrame()
 	if(debugger) {
 		debugger->PauseOnNextFrame();
 	} else {
+		_pauseRequestCount++;
 		_pauseOnNextFrame = true;
 		_paused = false;
 	}
@@ -788,6 +861,7 @@ void Emulator::Pause()
 	if(debugger) {
 		debugger->Step(GetCpuTypes()[0], 1, StepType::Step, BreakSource::Pause);
 	} else {
+		_pauseRequestCount++;
 		_paused = true;
 	}
 }
@@ -798,6 +872,7 @@ void Emulator::Resume()
 	if(debugger) {
 		debugger->Run();
 	} else {
+		_pauseRequestCount++;
 		_paused = false;
 	}
 }
@@ -823,6 +898,7 @@ void Emulator::WaitForPauseEnd()
 	PlatformUtilities::EnableScreensaver();
 	PlatformUtilities::RestoreTimerResolution();
 
+	_waitingForPauseEnd = true;
 	while(_paused && !_rewindManager->IsRewinding() && !_stopFlag && !_debugger) {
 		//Sleep until emulation is resumed
 		std::this_thread::sleep_for(std::chrono::duration<int, std::milli>(30));
@@ -832,6 +908,7 @@ void Emulator::WaitForPauseEnd()
 			break;
 		}
 	}
+	_waitingForPauseEnd = false;
 
 	PlatformUtilities::DisableScreensaver();
 	PlatformUtilities::EnableHighResolutionTimer();
@@ -906,14 +983,20 @@ void Emulator::WaitForLock()
 	}
 }
 
-void Emulator::Serialize(ostream& out, bool includeSettings, int compressionLevel)
+void Emulator::Serialize(ostream& out, bool includeSettings, int compressionLevel, bool compact, CompressionCodec codec)
 {
 	Serializer s(SaveStateManager::FileFormatVersion, true);
+	if(compact) {
+		s.UseCompactFormat(_stateLayoutIds[includeSettings]);
+	}
 	if(includeSettings) {
 		SV(_settings);
 	}
 	s.Stream(_console, "");
-	s.SaveTo(out, compressionLevel);
+	s.SaveTo(out, compressionLevel, codec);
+	if(compact) {
+		_stateLayoutIds[includeSettings] = s.GetCompactLayoutId();
+	}
 }
 
 bool Emulator::Deserialize(istream& in, uint32_t fileFormatVersion, bool includeSettings, optional<ConsoleType> srcConsoleType, bool sendNotification)
@@ -7,9 +7,11 @@
 #include "Core/Shared/Interfaces/IConsole.h"
 #include "Core/Shared/Audio/AudioPlayerTypes.h"
 #include "Utilities/Timer.h"
+#include "Utilities/CompressionCodec.h"
 #include "Utilities/safe_ptr.h"
 #include "Utilities/SimpleLock.h"
 #include "Utilities/VirtualFile.h"
+#include <functional>
 
 class Debugger;
 class DebugHud;
@@ -35,6 +37,8 @@ class AudioPlayerHud;
 class GameServer;
 class GameClient;
 class SocketServer;
+class SharedMemoryExporter;
+struct SocketInstanceState;
 
 class IInputRecorder;
 class IInputProvider;
@@ -88,6 +92,9 @@ private:
 	const shared_ptr<RewindManager> _rewindManager;
 
 	unique_ptr<SocketServer> _socketServer;
+	unique_ptr<SharedMemoryExporter> _sharedMemoryExporter;
+	const unique_ptr<SocketInstanceState> _socketState;
+	uint32_t _instanceId = 0;
 
 	thread::id _emulationThreadId;
 
@@ -100,16 +107,23 @@ private:
 	atomic<bool> _paused;
 	atomic<bool> _pauseOnNextFrame;
 	atomic<bool> _threadPaused;
+	atomic<bool> _waitingForPauseEnd; //Emulation thread is parked in WaitForPauseEnd (not holding _runLock)
+	atomic<uint32_t> _pauseRequestCount; //Incremented by Pause/Resume/PauseOnNextFrame
 
 	atomic<int> _debugRequestCount;
 	atomic<int> _blockDebuggerRequestCount;
 
 	atomic<bool> _isRunAheadFrame;
+	atomic<bool> _isHeadlessFrame;
+	atomic<bool> _skipHeadlessRender;
 	bool _frameRunning = false;
 
 	RomInfo _rom;
 	ConsoleType _consoleType = {};
 
+	//Compact save state layouts used by Serialize(), with/without settings
+	uint32_t _stateLayoutIds[2] = {};
+
 	ConsoleMemoryInfo _consoleMemory[DebugUtilities::GetMemoryTypeCount()] = {};
 
 	unique_ptr<DebugStats> _stats;
@@ -144,7 +158,9 @@ public:
 	Emulator();
 	~Emulator();
 
-	void Initialize(bool enableShortcuts = true);
+	//Only the main emulator starts the socket server - other instances (history viewer, tests,
+	//instances created through the socket API) must not take over its socket path
+	void Initialize(bool enableShortcuts = true, bool enableSocketServer = true);
 	void Release();
 
 	void Run();
@@ -183,7 +199,8 @@ public:
 
 	void SuspendDebugger(bool release);
 
-	void Serialize(ostream& out, bool includeSettings, int compressionLevel = 1);
+	//compact: use the in-memory compact format (faster, but can't be written to a file - see Serializer::UseCompactFormat)
+	void Serialize(ostream& out, bool includeSettings, int compressionLevel = 1, bool compact = false, CompressionCodec codec = CompressionCodec::Zlib);
 	bool Deserialize(istream& in, uint32_t fileFormatVersion, bool includeSettings, optional<ConsoleType> consoleType = std::nullopt, bool sendNotification = true);
 
 	SoundMixer* GetSoundMixer() { return _soundMixer.get(); }
@@ -203,6 +220,10 @@ public:
 	GameServer* GetGameServer() { return _gameServer.get(); }
 	GameClient* GetGameClient() { return _gameClient.get(); }
 	SocketServer* GetSocketServer() { return _socketServer.get(); }
+	SharedMemoryExporter* GetSharedMemoryExporter() { return _sharedMemoryExporter.get(); }
+	SocketInstanceState* GetSocketState() { return _socketState.get(); }
+	uint32_t GetInstanceId() { return _instanceId; }
+	void SetInstanceId(uint32_t instanceId) { _instanceId = instanceId; }
 	shared_ptr<SystemActionManager> GetSystemActionManager() { return _systemActionManager; }
 
 	BaseVideoFilter* GetVideoFilter(bool getDefaultFilter = false);
@@ -235,6 +256,12 @@ public:
 	bool IsRunning() { return _console != nullptr; }
 	bool IsRunAheadFrame() { return _isRunAheadFrame; }
 
+	//Headless frames skip audio output and frame limiting, and (except for the last frame of a batch
+	//when requested) video decoding - the SNES, PCE and GBA PPUs also skip rendering the pixels
+	bool IsHeadlessFrame() { return _isHeadlessFrame; }
+	bool IsHeadlessRenderSkipped() { return _skipHeadlessRender; }
+	uint32_t RunHeadlessFrames(uint32_t frameCount, bool renderLastFrame, IInputProvider* inputProvider, const std::function<bool(uint32_t)>& onFrameDone);
+
 	TimingInfo GetTimingInfo(CpuType cpuType);
 	uint32_t GetFrameCount();
 
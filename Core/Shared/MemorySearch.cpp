@@ -0,0 +1,228 @@
+#include "pch.h"
+#include "MemorySearch.h"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+bool MemorySearchPattern::Parse(const string& text, MemorySearchPattern& out, string& error)
+{
+	out.Bytes.clear();
+	out.Mask.clear();
+
+	size_t pos = 0;
+	while (pos < text.size()) {
+		while (pos < text.size() && (text[pos] == ' ' || text[pos] == ',')) {
+			pos++;
+		}
+		if (pos >= text.size()) {
+			break;
+		}
+
+		size_t endPos = pos;
+		while (endPos < text.size() && text[endPos] != ' ' && text[endPos] != ',') {
+			endPos++;
+		}
+
+		string token = text.substr(pos, endPos - pos);
+		pos = endPos;
+
+		if (token == "??" || token == "?" || token == "**") {
+			out.Bytes.push_back(0);
+			out.Mask.push_back(0);
+			continue;
+		}
+
+		if (token.size() > 2 && token[0] == '0' && (token[1] == 'x' || token[1] == 'X')) {
+			token = token.substr(2);
+		}
+		if (token.empty() || token.size() > 2 || !std::all_of(token.begin(), token.end(), [](char c) { return std::isxdigit((unsigned char)c); })) {
+			error = "Invalid pattern byte: " + token;
+			return false;
+		}
+		out.Bytes.push_back((uint8_t)std::stoul(token, nullptr, 16));
+		out.Mask.push_back(0xFF);
+	}
+
+	if (out.Bytes.empty()) {
+		error = "Invalid pattern";
+		return false;
+	}
+	return true;
+}
+
+MemorySearchPattern MemorySearchPattern::FromValue(uint32_t value, uint32_t width)
+{
+	MemorySearchPattern pattern;
+	for (uint32_t i = 0; i < width; i++) {
+		pattern.Bytes.push_back((uint8_t)(value >> (i * 8)));
+		pattern.Mask.push_back(0xFF);
+	}
+	return pattern;
+}
+
+void MemorySearch::FindPattern(const uint8_t* data, uint32_t size, uint32_t baseAddr, const MemorySearchPattern& pattern, uint32_t align, vector<uint32_t>& matches)
+{
+	uint32_t patternSize = (uint32_t)pattern.Bytes.size();
+	if (patternSize == 0 || size < patternSize) {
+		return;
+	}
+	if (align == 0) {
+		align = 1;
+	}
+
+	// Longest run of fixed bytes - this is what gets searched for, the rest is verified after
+	uint32_t anchorStart = 0;
+	uint32_t anchorSize = 0;
+	for (uint32_t i = 0; i < patternSize;) {
+		if (!pattern.Mask[i]) {
+			i++;
+			continue;
+		}
+		uint32_t runStart = i;
+		while (i < patternSize && pattern.Mask[i]) {
+			i++;
+		}
+		if (i - runStart > anchorSize) {
+			anchorStart = runStart;
+			anchorSize = i - runStart;
+		}
+	}
+
+	uint32_t lastStart = size - patternSize;
+
+	if (anchorSize == 0) {
+		// Only wildcards - every aligned position matches
+		for (uint32_t offset = 0; offset <= lastStart; offset += align) {
+			matches.push_back(baseAddr + offset);
+		}
+		return;
+	}
+
+	auto verify = [&](uint32_t offset) {
+		if (offset % align) {
+			return false;
+		}
+		const uint8_t* start = data + offset;
+		for (uint32_t i = 0; i < patternSize; i++) {
+			if ((start[i] ^ pattern.Bytes[i]) & pattern.Mask[i]) {
+				return false;
+			}
+		}
+		return true;
+	};
+
+	// The anchor can only appear within [anchorStart, lastStart + anchorStart + anchorSize)
+	const uint8_t* anchor = pattern.Bytes.data() + anchorStart;
+	const uint8_t* searchStart = data + anchorStart;
+	const uint8_t* searchEnd = data + lastStart + anchorStart + anchorSize;
+
+	if (anchorSize >= 4) {
+		std::boyer_moore_horspool_searcher<const uint8_t*> searcher(anchor, anchor + anchorSize);
+		const uint8_t* it = searchStart;
+		while (it < searchEnd) {
+			auto found = searcher(it, searchEnd);
+			if (found.first == searchEnd) {
+				break;
+			}
+			uint32_t offset = (uint32_t)(found.first - data) - anchorStart;
+			if (verify(offset)) {
+				matches.push_back(baseAddr + offset);
+			}
+			it = found.first + 1;
+		}
+	} else {
+		// Short anchors: memchr (vectorized by the C library) on the first byte, then compare
+		const uint8_t* it = searchStart;
+		while (it + anchorSize <= searchEnd) {
+			it = (const uint8_t*)memchr(it, anchor[0], searchEnd - it - anchorSize + 1);
+			if (!it) {
+				break;
+			}
+			if (memcmp(it, anchor, anchorSize) == 0) {
+				uint32_t offset = (uint32_t)(it - data) - anchorStart;
+				if (verify(offset)) {
+					matches.push_back(baseAddr + offset);
+				}
+			}
+			it++;
+		}
+	}
+}
+
+static uint32_t ReadValue(const uint8_t* data, uint32_t width)
+{
+	uint32_t value = 0;
+	for (uint32_t i = 0; i < width; i++) {
+		value |= (uint32_t)data[i] << (i * 8);
+	}
+	return value;
+}
+
+void MemorySearch::Compare(const uint8_t* current, const uint8_t* previous, uint32_t size, uint32_t baseAddr, uint32_t width, uint32_t align, MemorySearchCompare compare, vector<uint32_t>& matches)
+{
+	if (width == 0 || width > 4 || size < width) {
+		return;
+	}
+	if (align == 0) {
+		align = 1;
+	}
+
+	uint32_t lastStart = size - width;
+	uint32_t offset = 0;
+
+	if (width == 1 && align == 1 && (compare == MemorySearchCompare::Changed || compare == MemorySearchCompare::Unchanged)) {
+		// Compare 8 bytes at a time - identical blocks are the common case in both modes
+		bool wantChanged = compare == MemorySearchCompare::Changed;
+		for (; offset + 8 <= size; offset += 8) {
+			uint64_t a, b;
+			memcpy(&a, current + offset, 8);
+			memcpy(&b, previous + offset, 8);
+			if (a == b) {
+				if (!wantChanged) {
+					for (uint32_t i = 0; i < 8; i++) {
+						matches.push_back(baseAddr + offset + i);
+					}
+				}
+				continue;
+			}
+			for (uint32_t i = 0; i < 8; i++) {
+				if ((current[offset + i] != previous[offset + i]) == wantChanged) {
+					matches.push_back(baseAddr + offset + i);
+				}
+			}
+		}
+	}
+
+	for (; offset <= lastStart; offset += align) {
+		uint32_t now = ReadValue(current + offset, width);
+		uint32_t before = ReadValue(previous + offset, width);
+		bool match = false;
+		switch (compare) {
+			case MemorySearchCompare::Changed: match = now != before; break;
+			case MemorySearchCompare::Unchanged: match = now == before; break;
+			case MemorySearchCompare::Increased: match = now > before; break;
+			case MemorySearchCompare::Decreased: match = now < before; break;
+		}
+		if (match) {
+			matches.push_back(baseAddr + offset);
+		}
+	}
+}
+
+void MemorySearch::Intersect(vector<uint32_t>& matches, const vector<uint32_t>& candidates)
+{
+	auto out = matches.begin();
+	auto candidate = candidates.begin();
+	for (uint32_t addr : matches) {
+		while (candidate != candidates.end() && *candidate < addr) {
+			candidate++;
+		}
+		if (candidate == candidates.end()) {
+			break;
+		}
+		if (*candidate == addr) {
+			*out++ = addr;
+		}
+	}
+	matches.erase(out, matches.end());
+}
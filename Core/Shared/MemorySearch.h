@@ -0,0 +1,38 @@
+#pragma once
+#include "pch.h"
+
+// Relation between a value now and the same value in a snapshot
+enum class MemorySearchCompare {
+	Changed,
+	Unchanged,
+	Increased,
+	Decreased
+};
+
+// Byte pattern with optional wildcards ("A9 ?? 8D")
+struct MemorySearchPattern {
+	vector<uint8_t> Bytes;
+	vector<uint8_t> Mask; // 0xFF = byte must match, 0x00 = wildcard
+
+	// Space/comma-separated hex bytes, "??", "?" or "**" for wildcards
+	static bool Parse(const string& text, MemorySearchPattern& out, string& error);
+	// Little-endian value of 1-4 bytes
+	static MemorySearchPattern FromValue(uint32_t value, uint32_t width);
+};
+
+// Search primitives used by the SEARCH socket command. All of them scan a contiguous buffer
+// directly (no per-byte memory accessor calls) and append matching addresses, in ascending
+// order, to `matches` as baseAddr + offset.
+class MemorySearch {
+public:
+	// Finds every occurrence of pattern whose start offset is a multiple of align.
+	// The longest run of non-wildcard bytes is located with memchr/Boyer-Moore-Horspool
+	// first, and the full masked pattern is only verified at those candidates.
+	static void FindPattern(const uint8_t* data, uint32_t size, uint32_t baseAddr, const MemorySearchPattern& pattern, uint32_t align, vector<uint32_t>& matches);
+
+	// Compares width-byte little-endian values (width 1-4) at every align-th offset
+	static void Compare(const uint8_t* current, const uint8_t* previous, uint32_t size, uint32_t baseAddr, uint32_t width, uint32_t align, MemorySearchCompare compare, vector<uint32_t>& matches);
+
+	// Keeps only the addresses also present in candidates (both must be sorted)
+	static void Intersect(vector<uint32_t>& matches, const vector<uint32_t>& candidates);
+};
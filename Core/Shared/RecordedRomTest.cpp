@@ -62,6 +62,7 @@ void RecordedRomTest::ValidateFrame()
 		_screenshotHashes.pop_front();
 	}
 	_currentCount--;
+	_validatedFrames++;
 
 	if(memcmp(_screenshotHashes.front(), md5Hash, 16) != 0) {
 		_badFrameCount++;
@@ -109,6 +110,7 @@ void RecordedRomTest::Reset()
 	_runningTest = false;
 	_recording = false;
 	_badFrameCount = 0;
+	_validatedFrames = 0;
 }
 
 void RecordedRomTest::Record(string filename, bool reset)
@@ -145,7 +147,7 @@ void RecordedRomTest::Record(string filename, bool reset)
 	}
 }
 
-RomTestResult RecordedRomTest::Run(string filename)
+RomTestResult RecordedRomTest::Run(string filename, uint32_t timeoutMs)
 {
 	RomTestResult result = {};
 	_emu->GetNotificationManager()->RegisterNotificationListener(shared_from_this());
@@ -224,9 +226,16 @@ RomTestResult RecordedRomTest::Run(string filename)
 
 			_runningTest = true;
 			_emu->Unlock();
-			_signal.Wait();
+			bool timedOut = !_signal.Wait((int)timeoutMs);
 			_emu->Stop(!_inBackground);
 			_runningTest = false;
+
+			if(timedOut) {
+				settings->ClearFlag(EmulationFlags::MaximumSpeed);
+				result.State = RomTestState::Failed;
+				result.ErrorCode = -5;
+				return result;
+			}
 		} else {
 			//Something went wrong when loading the rom
 			_emu->Unlock();
@@ -30,6 +30,7 @@ private:
 	bool _recording = false;
 	bool _runningTest = false;
 	int _badFrameCount = 0;
+	uint32_t _validatedFrames = 0;
 	bool _isLastFrameGood = false;
 
 	uint8_t _previousHash[16] = {};
@@ -54,6 +55,10 @@ public:
 
 	void ProcessNotification(ConsoleNotificationType type, void* parameter) override;
 	void Record(string filename, bool reset);
-	RomTestResult Run(string filename);
+	//timeoutMs = 0 waits until the movie ends, the test fails with error -5 when the timeout expires first
+	RomTestResult Run(string filename, uint32_t timeoutMs = 0);
 	void Stop();
+
+	//Number of frames compared by the last Run()
+	uint32_t GetFrameCount() { return _validatedFrames; }
 };
\ No newline at end of file
@@ -9,6 +9,7 @@ struct RenderedFrame
 	void* Data = nullptr; //Used by HD packs
 	uint32_t Width = 256;
 	uint32_t Height = 240;
+	uint32_t FrameBufferSize = 0; //In bytes, 0 = Width * Height pixels (set when the PPU's buffer uses another layout)
 	double Scale = 1.0;
 	uint32_t FrameNumber = 0;
 	uint32_t VideoPhase = 0;
@@ -3,57 +3,94 @@
 #include "Shared/Emulator.h"
 #include "Shared/SaveStateManager.h"
 #include "Utilities/CompressionHelper.h"
+#include "Utilities/Serializer.h"
 
 void RewindData::GetStateData(stringstream &stateData, deque<RewindData>& prevStates, int32_t position)
 {
 	vector<uint8_t> data;
-	CompressionHelper::Decompress(_saveStateData, data);
-
-	if(!IsFullState) {
-		position = (position > 0 ? position : (int32_t)prevStates.size()) - 1;
-		ProcessXorState(data, prevStates, position);
+	if(!GetUncompressedState(data, prevStates, position)) {
+		return;
 	}
 
+	//Rewind states use the compact format, which is only valid in memory
+	Serializer::ConvertToKeyedFormat(data);
 	stateData.write((char*)data.data(), data.size());
 }
 
-template<typename T>
-void RewindData::ProcessXorState(T& data, deque<RewindData>& prevStates, int32_t position)
+const vector<uint8_t>* RewindData::GetFullStateData(deque<RewindData>& prevStates, int32_t position, vector<uint8_t>& buffer)
 {
-	//Find last full state and XOR with it
-	while(position >= 0 && position < prevStates.size()) {
+	//Find the last full state before this one
+	while(position >= 0 && position < (int32_t)prevStates.size()) {
 		RewindData& prevState = prevStates[position];
 		if(prevState.IsFullState) {
-			//XOR with previous state to restore state data to its initial state
 			if(!prevState._uncompressedData.empty()) {
-				for(size_t i = 0, len = std::min(prevState._uncompressedData.size(), data.size()); i < len; i++) {
-					data[i] ^= prevState._uncompressedData[i];
-				}
-			} else {
-				vector<uint8_t> prevStateData;
-				CompressionHelper::Decompress(prevState._saveStateData, prevStateData);
-				for(size_t i = 0, len = std::min(prevStateData.size(), data.size()); i < len; i++) {
-					data[i] ^= prevStateData[i];
-				}
+				return &prevState._uncompressedData;
+			}
+			if(!CompressionHelper::Decompress(prevState._saveStateData, buffer)) {
+				return nullptr;
 			}
-			break;
+			return &buffer;
 		}
 		position--;
 	}
+	return nullptr;
 }
 
-void RewindData::LoadState(Emulator* emu, deque<RewindData>& prevStates, int32_t position, bool sendNotification)
+bool RewindData::GetUncompressedState(vector<uint8_t>& data, deque<RewindData>& prevStates, int32_t position)
 {
-	if(_saveStateData.size() == 0) {
-		return;
+	if(_saveStateData.empty() || !CompressionHelper::Decompress(_saveStateData, data)) {
+		return false;
 	}
-		
-	vector<uint8_t> data;
-	CompressionHelper::Decompress(_saveStateData, data);
 
-	if(!IsFullState) {
-		position = (position > 0 ? position : (int32_t)prevStates.size()) - 1;
-		ProcessXorState(data, prevStates, position);
+	if(IsFullState) {
+		return true;
+	}
+
+	//Delta state: the dirty pages (XORed with the full state), preceded by the state's size and a bitmap of the dirty pages
+	position = (position > 0 ? position : (int32_t)prevStates.size()) - 1;
+	vector<uint8_t> buffer;
+	const vector<uint8_t>* fullState = GetFullStateData(prevStates, position, buffer);
+	if(!fullState || data.size() < sizeof(uint32_t)) {
+		return false;
+	}
+
+	uint32_t stateSize;
+	memcpy(&stateSize, data.data(), sizeof(uint32_t));
+	uint32_t pageCount = (stateSize + RewindData::PageSize - 1) / RewindData::PageSize;
+	uint32_t bitmapSize = (pageCount + 7) / 8;
+	if(data.size() < sizeof(uint32_t) + bitmapSize) {
+		return false;
+	}
+
+	vector<uint8_t> state(stateSize, 0);
+	memcpy(state.data(), fullState->data(), std::min<size_t>(stateSize, fullState->size()));
+
+	const uint8_t* bitmap = data.data() + sizeof(uint32_t);
+	const uint8_t* pageData = bitmap + bitmapSize;
+	const uint8_t* end = data.data() + data.size();
+	for(uint32_t page = 0; page < pageCount; page++) {
+		if(bitmap[page >> 3] & (1 << (page & 0x07))) {
+			uint32_t start = page * RewindData::PageSize;
+			uint32_t size = std::min(RewindData::PageSize, stateSize - start);
+			if(pageData + size > end) {
+				return false;
+			}
+			for(uint32_t i = 0; i < size; i++) {
+				state[start + i] ^= pageData[i];
+			}
+			pageData += size;
+		}
+	}
+
+	data = std::move(state);
+	return true;
+}
+
+void RewindData::LoadState(Emulator* emu, deque<RewindData>& prevStates, int32_t position, bool sendNotification)
+{
+	vector<uint8_t> data;
+	if(!GetUncompressedState(data, prevStates, position)) {
+		return;
 	}
 
 	stringstream stream;
@@ -66,15 +103,49 @@ void RewindData::LoadState(Emulator* emu, deque<RewindData>& prevStates, int32_t
 void RewindData::SaveState(Emulator* emu, deque<RewindData>& prevStates, int32_t position)
 {
 	std::stringstream state;
-	emu->Serialize(state, true, 0);
+	emu->Serialize(state, true, 0, true);
 
 	string data = state.str();
 
 	position = position > 0 ? position : (int32_t)prevStates.size();
 
+	vector<uint8_t> buffer;
+	const vector<uint8_t>* fullState = nullptr;
 	if(position > 0 && (position % 30) != 0) {
-		position--;
-		ProcessXorState(data, prevStates, position);
+		fullState = GetFullStateData(prevStates, position - 1, buffer);
+	}
+
+	if(fullState) {
+		//Only keep the pages that differ from the last full state - compact save states keep each value at the
+		//same offset from one frame to the next, so this mostly leaves the memory pages that were written to
+		uint32_t stateSize = (uint32_t)data.size();
+		uint32_t pageCount = (stateSize + RewindData::PageSize - 1) / RewindData::PageSize;
+		uint32_t bitmapSize = (pageCount + 7) / 8;
+
+		string delta;
+		delta.reserve(sizeof(uint32_t) + bitmapSize + RewindData::PageSize * 16);
+		delta.append((char*)&stateSize, sizeof(uint32_t));
+		delta.append(bitmapSize, 0);
+
+		const uint8_t* src = (uint8_t*)data.data();
+		const uint8_t* ref = fullState->data();
+		uint32_t refSize = (uint32_t)fullState->size();
+		for(uint32_t page = 0; page < pageCount; page++) {
+			uint32_t start = page * RewindData::PageSize;
+			uint32_t size = std::min(RewindData::PageSize, stateSize - start);
+			if(start + size <= refSize && memcmp(src + start, ref + start, size) == 0) {
+				continue;
+			}
+
+			delta[sizeof(uint32_t) + (page >> 3)] |= (1 << (page & 0x07));
+			size_t offset = delta.size();
+			delta.append((char*)src + start, size);
+			for(uint32_t i = 0; i < size && start + i < refSize; i++) {
+				delta[offset + i] ^= ref[start + i];
+			}
+		}
+
+		CompressionHelper::Compress(delta, 1, _saveStateData, CompressionCodec::Lz4);
 	} else {
 		IsFullState = true;
 		while(position > 0) {
@@ -89,8 +160,8 @@ void RewindData::SaveState(Emulator* emu, deque<RewindData>& prevStates, int32_t
 
 		//Keep uncompressed data for the next 30 states - this avoids having to decompress the state 30 times
 		_uncompressedData = vector<uint8_t>(data.begin(), data.end());
+		CompressionHelper::Compress(data, 1, _saveStateData, CompressionCodec::Lz4);
 	}
 
-	CompressionHelper::Compress(data, 1, _saveStateData);
 	FrameCount = 0;
 }
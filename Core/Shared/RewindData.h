@@ -11,8 +11,11 @@ private:
 	vector<uint8_t> _saveStateData;
 	vector<uint8_t> _uncompressedData;
 
-	template<typename T>
-	void ProcessXorState(T& data, deque<RewindData>& prevStates, int32_t position);
+	//Delta states only store the pages that differ from the last full state
+	static constexpr uint32_t PageSize = 1024;
+
+	static const vector<uint8_t>* GetFullStateData(deque<RewindData>& prevStates, int32_t position, vector<uint8_t>& buffer);
+	bool GetUncompressedState(vector<uint8_t>& data, deque<RewindData>& prevStates, int32_t position);
 
 public:
 	std::deque<ControlDeviceState> InputLogs[BaseControlDevice::PortCount];
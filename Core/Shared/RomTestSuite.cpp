@@ -0,0 +1,436 @@
+#include "pch.h"
+#include <atomic>
+#include <mutex>
+#include "Shared/RomTestSuite.h"
+#include "Shared/RecordedRomTest.h"
+#include "Shared/Emulator.h"
+#include "Shared/EmuSettings.h"
+#include "Shared/NotificationManager.h"
+#include "Shared/Interfaces/INotificationListener.h"
+#include "Utilities/AutoResetEvent.h"
+#include "Utilities/FolderUtilities.h"
+#include "Utilities/StringUtilities.h"
+#include "Utilities/ThreadPool.h"
+#include "Utilities/VirtualFile.h"
+#include "Utilities/Timer.h"
+#include "Utilities/magic_enum.hpp"
+
+//Reads a memory value at the end of a specific frame, on the emulation thread (instead of polling the frame count)
+class FrameCountListener : public INotificationListener
+{
+private:
+	Emulator* _emu;
+	uint32_t _frameCount;
+	MemoryType _memType;
+	uint32_t _address;
+	uint32_t _size;
+	std::atomic<bool> _done;
+
+public:
+	AutoResetEvent Signal;
+	uint64_t Value = 0;
+	bool ValidAddress = false;
+
+	FrameCountListener(Emulator* emu, uint32_t frameCount, MemoryType memType, uint32_t address, uint32_t size)
+	{
+		_emu = emu;
+		_frameCount = frameCount;
+		_memType = memType;
+		_address = address;
+		_size = size;
+		_done = false;
+	}
+
+	void ProcessNotification(ConsoleNotificationType type, void* parameter) override
+	{
+		if(type != ConsoleNotificationType::PpuFrameDone || _done || _emu->GetFrameCount() < _frameCount) {
+			return;
+		}
+
+		ConsoleMemoryInfo memInfo = _emu->GetMemory(_memType);
+		uint8_t* memBuffer = (uint8_t*)memInfo.Memory;
+		ValidAddress = memBuffer && _address < memInfo.Size;
+		for(uint32_t i = 0; ValidAddress && i < _size && _address + i < memInfo.Size; i++) {
+			Value |= (uint64_t)memBuffer[_address + i] << (8 * i);
+		}
+
+		_done = true;
+		Signal.Signal();
+	}
+};
+
+MemoryTestStatus RomTestSuite::RunMemoryTest(Emulator* emu, string romPath, uint32_t frameCount, MemoryType memType, uint32_t address, uint32_t size, uint64_t& value, uint32_t timeoutMs)
+{
+	shared_ptr<FrameCountListener> listener(new FrameCountListener(emu, frameCount, memType, address, std::clamp<uint32_t>(size, 1, 8)));
+	emu->GetNotificationManager()->RegisterNotificationListener(listener);
+
+	if(!emu->LoadRom((VirtualFile)romPath, VirtualFile())) {
+		return MemoryTestStatus::LoadFailed;
+	}
+	emu->GetSettings()->SetFlag(EmulationFlags::MaximumSpeed);
+
+	bool timedOut = !listener->Signal.Wait((int)timeoutMs);
+
+	emu->Stop(false);
+	emu->GetSettings()->ClearFlag(EmulationFlags::MaximumSpeed);
+
+	if(timedOut) {
+		return MemoryTestStatus::TimedOut;
+	}
+
+	value = listener->Value;
+	return listener->ValidAddress ? MemoryTestStatus::Done : MemoryTestStatus::InvalidAddress;
+}
+
+bool RomTestSuite::ParseTestLine(string line, string folder, vector<RomTestCase>& tests, string& error)
+{
+	size_t commentStart = line.find('#');
+	if(commentStart != string::npos) {
+		line = line.substr(0, commentStart);
+	}
+
+	std::replace(line.begin(), line.end(), '\t', ' ');
+	vector<string> parts;
+	for(string& part : StringUtilities::Split(line, ' ')) {
+		part = StringUtilities::Trim(part);
+		if(!part.empty()) {
+			parts.push_back(part);
+		}
+	}
+	if(parts.empty()) {
+		return true;
+	}
+
+	string path = parts[0];
+	bool isAbsolute = path[0] == '/' || path[0] == '\\' || (path.size() > 1 && path[1] == ':');
+	if(!folder.empty() && !isAbsolute) {
+		path = FolderUtilities::CombinePath(folder, path);
+	}
+
+	if(parts.size() == 1) {
+		//Single test file, folder or nested manifest
+		return LoadTests(path, tests, error);
+	}
+
+	RomTestCase test;
+	test.Name = parts[0];
+	test.Path = path;
+	test.Type = RomTestType::Memory;
+
+	bool hasMemType = false;
+	bool hasExpected = false;
+	for(size_t i = 1; i < parts.size(); i++) {
+		size_t separator = parts[i].find('=');
+		if(separator == string::npos) {
+			error = "Invalid test parameter: " + parts[i];
+			return false;
+		}
+
+		string key = StringUtilities::ToLower(parts[i].substr(0, separator));
+		string value = parts[i].substr(separator + 1);
+		try {
+			if(key == "frames") {
+				test.Frames = (uint32_t)std::stoul(value, nullptr, 0);
+			} else if(key == "addr" || key == "address") {
+				test.Address = (uint32_t)std::stoul(value, nullptr, 0);
+			} else if(key == "size") {
+				test.Size = std::clamp<uint32_t>((uint32_t)std::stoul(value, nullptr, 0), 1, 8);
+			} else if(key == "expect" || key == "expected") {
+				test.Expected = std::stoull(value, nullptr, 0);
+				hasExpected = true;
+			} else if(key == "memtype") {
+				auto memType = magic_enum::enum_cast<MemoryType>(value);
+				if(!memType.has_value()) {
+					error = "Unknown memory type: " + value;
+					return false;
+				}
+				test.MemType = memType.value();
+				hasMemType = true;
+			} else if(key == "timeout") {
+				test.Timeout = std::min<uint32_t>((uint32_t)std::stoul(value, nullptr, 0), 86400);
+			} else if(key == "name") {
+				test.Name = value;
+			} else {
+				error = "Unknown test parameter: " + key;
+				return false;
+			}
+		} catch(std::exception&) {
+			error = "Invalid value for " + key + ": " + value;
+			return false;
+		}
+	}
+
+	if(!hasMemType || !hasExpected) {
+		error = "Memory tests require memtype and expect: " + line;
+		return false;
+	}
+
+	tests.push_back(test);
+	return true;
+}
+
+bool RomTestSuite::LoadTests(string path, vector<RomTestCase>& tests, string& error)
+{
+	vector<string> testFiles = FolderUtilities::GetFilesInFolder(path, { ".mtp" }, true);
+	if(!testFiles.empty()) {
+		std::sort(testFiles.begin(), testFiles.end());
+		for(string& file : testFiles) {
+			RomTestCase test;
+			test.Name = file.substr(std::min(path.size() + 1, file.size()));
+			test.Path = file;
+			tests.push_back(test);
+		}
+		return true;
+	}
+
+	string extension = StringUtilities::ToLower(FolderUtilities::GetExtension(path));
+	if(extension == ".mtp") {
+		RomTestCase test;
+		test.Name = FolderUtilities::GetFilename(path, true);
+		test.Path = path;
+		tests.push_back(test);
+		return true;
+	}
+
+	ifstream manifest(path);
+	if(!manifest) {
+		error = "Could not open: " + path;
+		return false;
+	}
+
+	string folder = FolderUtilities::GetFolderName(path);
+	string line;
+	int lineNumber = 0;
+	while(std::getline(manifest, line)) {
+		lineNumber++;
+		if(!line.empty() && line.back() == '\r') {
+			line.pop_back();
+		}
+		if(!ParseTestLine(line, folder, tests, error)) {
+			error = path + ":" + std::to_string(lineNumber) + ": " + error;
+			return false;
+		}
+	}
+	return true;
+}
+
+RomTestCaseResult RomTestSuite::RunTest(Emulator* emu, RomTestCase& test)
+{
+	RomTestCaseResult result;
+	Timer timer;
+
+	uint32_t timeout = test.Timeout.value_or(0);
+	uint32_t timeoutMs = timeout * 1000;
+	string timeoutMessage = "Timed out after " + std::to_string(timeout) + " s";
+
+	if(test.Type == RomTestType::Recorded) {
+		shared_ptr<RecordedRomTest> romTest(new RecordedRomTest(emu, true));
+		RomTestResult testResult = romTest->Run(test.Path, timeoutMs);
+		result.State = testResult.State;
+		result.ErrorCode = testResult.ErrorCode;
+		result.Frames = romTest->GetFrameCount();
+		if(testResult.ErrorCode == -5) {
+			result.Message = timeoutMessage;
+		} else if(testResult.ErrorCode < 0) {
+			result.State = RomTestState::Failed;
+			result.Message = "Could not load test (error " + std::to_string(testResult.ErrorCode) + ")";
+		} else if(testResult.ErrorCode > 0) {
+			result.Message = std::to_string(testResult.ErrorCode) + " frame(s) did not match";
+		}
+	} else {
+		uint64_t value = 0;
+		MemoryTestStatus status = RunMemoryTest(emu, test.Path, test.Frames, test.MemType, test.Address, test.Size, value, timeoutMs);
+		if(status != MemoryTestStatus::Done) {
+			result.State = RomTestState::Failed;
+			switch(status) {
+				default:
+				case MemoryTestStatus::LoadFailed: result.ErrorCode = -1; result.Message = "Could not load ROM"; break;
+				case MemoryTestStatus::InvalidAddress: result.ErrorCode = -2; result.Message = "Could not read memory"; break;
+				case MemoryTestStatus::TimedOut: result.ErrorCode = -5; result.Message = timeoutMessage; break;
+			}
+		} else {
+			uint64_t mask = test.Size >= 8 ? UINT64_MAX : ((1ULL << (test.Size * 8)) - 1);
+			result.Frames = test.Frames;
+			if((value & mask) == (test.Expected & mask)) {
+				result.State = RomTestState::Passed;
+			} else {
+				result.State = RomTestState::Failed;
+				result.ErrorCode = 1;
+				std::stringstream ss;
+				ss << "Expected $" << std::hex << std::uppercase << (test.Expected & mask) << ", got $" << (value & mask);
+				result.Message = ss.str();
+			}
+		}
+	}
+
+	result.WallMs = timer.GetElapsedMS();
+	return result;
+}
+
+vector<RomTestCaseResult> RomTestSuite::Run(vector<RomTestCase>& tests, uint32_t threadCount, const std::function<void(RomTestCase&, RomTestCaseResult&)>& onTestDone)
+{
+	vector<RomTestCaseResult> results(tests.size());
+
+	//Emulators are reused by the next test that runs on an idle thread (at most one per thread)
+	std::mutex lock;
+	vector<unique_ptr<Emulator>> emulators;
+	vector<Emulator*> idleEmulators;
+
+	auto runTest = [&](uint32_t i) {
+		Emulator* emu = nullptr;
+		{
+			std::unique_lock<std::mutex> guard(lock);
+			if(!idleEmulators.empty()) {
+				emu = idleEmulators.back();
+				idleEmulators.pop_back();
+			}
+		}
+
+		if(!emu) {
+			unique_ptr<Emulator> newEmu(new Emulator());
+			newEmu->Initialize(false, false);
+			newEmu->GetSettings()->SetFlag(EmulationFlags::ConsoleMode);
+			emu = newEmu.get();
+
+			std::unique_lock<std::mutex> guard(lock);
+			emulators.push_back(std::move(newEmu));
+		}
+
+		//Memory tests use the same settings as TestApi's RunTest, the emulator's own settings are restored
+		//afterwards so they don't leak into the next test that runs on it
+		GameboyConfig& gbConfig = emu->GetSettings()->GetGameboyConfig();
+		GameboyConfig savedGbConfig = gbConfig;
+		if(tests[i].Type == RomTestType::Memory) {
+			gbConfig.Model = GameboyModel::Gameboy;
+			gbConfig.RamPowerOnState = RamState::AllZeros;
+		}
+
+		results[i] = RunTest(emu, tests[i]);
+		gbConfig = savedGbConfig;
+
+		std::unique_lock<std::mutex> guard(lock);
+		idleEmulators.push_back(emu);
+		if(onTestDone) {
+			onTestDone(tests[i], results[i]);
+		}
+	};
+
+	if(threadCount == 1) {
+		for(uint32_t i = 0; i < (uint32_t)tests.size(); i++) {
+			runTest(i);
+		}
+	} else {
+		//Threads pick the next pending test as soon as they are done with one, so long tests don't hold up the others
+		ThreadPool pool(threadCount > 1 ? threadCount - 1 : 0);
+		pool.ParallelFor((uint32_t)tests.size(), runTest);
+	}
+
+	for(unique_ptr<Emulator>& emu : emulators) {
+		emu->Stop(false);
+		emu->Release();
+	}
+	return results;
+}
+
+string RomTestSuite::XmlEscape(const string& value)
+{
+	string out;
+	for(char c : value) {
+		switch(c) {
+			case '&': out += "&amp;"; break;
+			case '<': out += "&lt;"; break;
+			case '>': out += "&gt;"; break;
+			case '"': out += "&quot;"; break;
+			case '\'': out += "&apos;"; break;
+			default: out += c; break;
+		}
+	}
+	return out;
+}
+
+string RomTestSuite::JsonEscape(const string& value)
+{
+	string out;
+	for(char c : value) {
+		switch(c) {
+			case '"': out += "\\\""; break;
+			case '\\': out += "\\\\"; break;
+			case '\n': out += "\\n"; break;
+			case '\r': out += "\\r"; break;
+			case '\t': out += "\\t"; break;
+			default:
+				if((uint8_t)c < 0x20) {
+					char buffer[8];
+					snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+					out += buffer;
+				} else {
+					out += c;
+				}
+				break;
+		}
+	}
+	return out;
+}
+
+static double GetFps(RomTestCaseResult& result)
+{
+	return result.WallMs > 0 ? result.Frames * 1000.0 / result.WallMs : 0;
+}
+
+bool RomTestSuite::WriteJUnitReport(string filename, vector<RomTestCase>& tests, vector<RomTestCaseResult>& results, double totalMs)
+{
+	ofstream file(filename, ios::out | ios::binary);
+	if(!file) {
+		return false;
+	}
+
+	size_t failures = std::count_if(results.begin(), results.end(), [](RomTestCaseResult& r) { return r.State == RomTestState::Failed; });
+
+	file << std::fixed << std::setprecision(3);
+	file << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+	file << "<testsuite name=\"RomTests\" tests=\"" << tests.size() << "\" failures=\"" << failures << "\" errors=\"0\" time=\"" << totalMs / 1000 << "\">\n";
+	for(size_t i = 0; i < tests.size(); i++) {
+		RomTestCaseResult& result = results[i];
+		file << "  <testcase classname=\"" << (tests[i].Type == RomTestType::Recorded ? "recorded" : "memory") << "\" name=\"" << XmlEscape(tests[i].Name) << "\" time=\"" << result.WallMs / 1000 << "\">\n";
+		if(result.State == RomTestState::Failed) {
+			file << "    <failure message=\"" << XmlEscape(result.Message) << "\"/>\n";
+		}
+		file << "    <system-out>frames=" << result.Frames << " fps=" << std::setprecision(1) << GetFps(result) << std::setprecision(3);
+		if(result.State == RomTestState::PassedWithWarnings) {
+			file << " warning=" << XmlEscape(result.Message);
+		}
+		file << "</system-out>\n";
+		file << "  </testcase>\n";
+	}
+	file << "</testsuite>\n";
+	file.close();
+	return !file.fail();
+}
+
+bool RomTestSuite::WriteJsonReport(string filename, vector<RomTestCase>& tests, vector<RomTestCaseResult>& results, double totalMs)
+{
+	ofstream file(filename, ios::out | ios::binary);
+	if(!file) {
+		return false;
+	}
+
+	size_t failures = std::count_if(results.begin(), results.end(), [](RomTestCaseResult& r) { return r.State == RomTestState::Failed; });
+
+	file << std::fixed << std::setprecision(3);
+	file << "{\"tests\":" << tests.size() << ",\"failures\":" << failures << ",\"wallMs\":" << totalMs << ",\"results\":[\n";
+	for(size_t i = 0; i < tests.size(); i++) {
+		RomTestCaseResult& result = results[i];
+		file << "  {\"name\":\"" << JsonEscape(tests[i].Name) << "\"";
+		file << ",\"type\":\"" << (tests[i].Type == RomTestType::Recorded ? "recorded" : "memory") << "\"";
+		file << ",\"state\":\"" << magic_enum::enum_name(result.State) << "\"";
+		file << ",\"errorCode\":" << result.ErrorCode;
+		file << ",\"message\":\"" << JsonEscape(result.Message) << "\"";
+		file << ",\"frames\":" << result.Frames;
+		file << ",\"wallMs\":" << result.WallMs;
+		file << ",\"fps\":" << GetFps(result) << "}";
+		file << (i + 1 < tests.size() ? ",\n" : "\n");
+	}
+	file << "]}\n";
+	file.close();
+	return !file.fail();
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include "pch.h"
+#include <functional>
+#include "Shared/MemoryType.h"
+#include "Shared/RecordedRomTest.h"
+
+class Emulator;
+
+enum class RomTestType
+{
+	Recorded, //.mtp file (frame hashes + input movie), see RecordedRomTest
+	Memory //Runs a ROM for N frames and compares a memory value
+};
+
+enum class MemoryTestStatus
+{
+	Done,
+	LoadFailed,
+	InvalidAddress,
+	TimedOut
+};
+
+struct RomTestCase
+{
+	string Name;
+	string Path;
+	RomTestType Type = RomTestType::Recorded;
+	optional<uint32_t> Timeout; //In seconds, 0 = no timeout, not set = no timeout unless the runner sets a default
+
+	//Memory tests
+	uint32_t Frames = 500;
+	MemoryType MemType = MemoryType::None;
+	uint32_t Address = 0;
+	uint32_t Size = 1;
+	uint64_t Expected = 0;
+};
+
+struct RomTestCaseResult
+{
+	RomTestState State = RomTestState::Failed;
+	int32_t ErrorCode = 0;
+	string Message;
+	uint32_t Frames = 0;
+	double WallMs = 0;
+};
+
+//Runs a list of ROM tests (loaded from a manifest) in parallel, with one Emulator per worker thread.
+//Manifest format, one test per line ('#' starts a comment, paths are relative to the manifest's folder):
+//  tests/smb.mtp                                              - recorded test
+//  tests/recorded                                             - every .mtp file in the folder (recursive)
+//  gb/blargg.gb frames=500 memtype=GbHighRam addr=0x02 expect=1 [size=1-8] [timeout=seconds]  - memory test
+//timeout=0 disables the timeout, even when the runner has a default timeout
+class RomTestSuite
+{
+private:
+	static string XmlEscape(const string& value);
+	static string JsonEscape(const string& value);
+	static bool ParseTestLine(string line, string folder, vector<RomTestCase>& tests, string& error);
+	static RomTestCaseResult RunTest(Emulator* emu, RomTestCase& test);
+
+public:
+	//Adds the tests listed in a manifest (or all .mtp files in a folder, or a single test file)
+	static bool LoadTests(string path, vector<RomTestCase>& tests, string& error);
+
+	//threadCount = 0 uses one thread per hardware thread
+	static vector<RomTestCaseResult> Run(vector<RomTestCase>& tests, uint32_t threadCount, const std::function<void(RomTestCase&, RomTestCaseResult&)>& onTestDone);
+
+	//Runs a ROM until exactly frameCount frames have been emulated and returns the (up to 8) bytes at address, little-endian
+	//Gives up (and stops the emulation) after timeoutMs, 0 = no timeout
+	static MemoryTestStatus RunMemoryTest(Emulator* emu, string romPath, uint32_t frameCount, MemoryType memType, uint32_t address, uint32_t size, uint64_t& value, uint32_t timeoutMs = 0);
+
+	static bool WriteJUnitReport(string filename, vector<RomTestCase>& tests, vector<RomTestCaseResult>& results, double totalMs);
+	static bool WriteJsonReport(string filename, vector<RomTestCase>& tests, vector<RomTestCaseResult>& results, double totalMs);
+};
@@ -209,20 +209,20 @@ void SaveStateManager::GetSaveStateHeader(ostream &stream)
 	stream.write(romName.c_str(), romName.size());
 }
 
-void SaveStateManager::SaveState(ostream &stream)
+void SaveStateManager::SaveState(ostream &stream, CompressionCodec codec)
 {
 	GetSaveStateHeader(stream);
-	_emu->Serialize(stream, false);
+	_emu->Serialize(stream, false, 1, false, codec);
 }
 
-bool SaveStateManager::SaveState(string filepath, bool showSuccessMessage)
+bool SaveStateManager::SaveState(string filepath, bool showSuccessMessage, CompressionCodec codec)
 {
 	ofstream file(filepath, ios::out | ios::binary);
 
 	if(file) {
 		{
 			auto lock = _emu->AcquireLock();
-			SaveState(file);
+			SaveState(file, codec);
 			_emu->ProcessEvent(EventType::StateSaved);
 		}
 		file.close();
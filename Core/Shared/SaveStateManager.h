@@ -1,5 +1,6 @@
 #pragma once
 #include "pch.h"
+#include "Utilities/CompressionCodec.h"
 
 class Emulator;
 struct RenderedFrame;
@@ -47,8 +48,9 @@ public:
 
 	void GetSaveStateHeader(ostream & stream);
 
-	void SaveState(ostream &stream);
-	bool SaveState(string filepath, bool showSuccessMessage = true);
+	//Files should keep the default (zlib) codec - LZ4 states can't be loaded by older versions
+	void SaveState(ostream &stream, CompressionCodec codec = CompressionCodec::Zlib);
+	bool SaveState(string filepath, bool showSuccessMessage = true, CompressionCodec codec = CompressionCodec::Zlib);
 	void SaveState(int stateIndex, bool displayMessage = true);
 	bool LoadState(istream &stream);
 	bool LoadState(string filepath, bool showSuccessMessage = true);
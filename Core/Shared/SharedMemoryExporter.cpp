@@ -0,0 +1,306 @@
+#include "pch.h"
+#include "SharedMemoryExporter.h"
+#include "Emulator.h"
+#include "MessageManager.h"
+#include "Shared/Interfaces/IConsole.h"
+#include "Core/Debugger/DebugUtilities.h"
+#include "Utilities/Timer.h"
+#include "Utilities/magic_enum.hpp"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+static_assert(sizeof(atomic<uint64_t>) == sizeof(uint64_t), "Sequence must be a plain 64-bit value in the shared layout");
+static_assert(std::is_standard_layout<SharedMemoryHeader>::value, "SharedMemoryHeader is read by other processes");
+
+static constexpr uint32_t DataAlignment = 64;
+
+static uint32_t AlignOffset(uint32_t offset)
+{
+	return (offset + DataAlignment - 1) & ~(DataAlignment - 1);
+}
+
+SharedMemoryExporter::SharedMemoryExporter(Emulator* emu) : _emu(emu), _active(false)
+{
+}
+
+SharedMemoryExporter::~SharedMemoryExporter()
+{
+	Stop();
+}
+
+bool SharedMemoryExporter::Start(const string& name, const vector<MemoryType>& memTypes, string& error)
+{
+	if (name.size() < 2 || name[0] != '/' || name.find('/', 1) != string::npos || name.size() > 255) {
+		error = "Shared memory name must start with '/' and contain no other '/'";
+		return false;
+	}
+	if (memTypes.size() > MaxRegions) {
+		error = "Too many memory types (max " + std::to_string(MaxRegions) + ")";
+		return false;
+	}
+
+	// The layout depends on the PPU frame and memory sizes, which can only be read while the emulation
+	// thread is paused (taken before _lock, which the emulation thread takes in Publish)
+	auto emuLock = _emu->AcquireLock();
+	auto lock = _lock.AcquireSafe();
+	Close(true);
+
+	_name = name;
+	_exportAllTypes = memTypes.empty();
+	_requestedTypes = memTypes;
+	_framesPublished = 0;
+	_lastPublishUs = 0;
+	_lastError.clear();
+
+	PpuFrameInfo frame = _emu->GetPpuFrame();
+	if (!UpdateLayout(frame, error)) {
+		_lastError = error;
+		Close(true);
+		return false;
+	}
+
+	_active = true;
+	MessageManager::Log("[SharedMemory] Exporting " + std::to_string(_regions.size()) + " memory types to " + _name);
+	return true;
+}
+
+void SharedMemoryExporter::Stop()
+{
+	auto lock = _lock.AcquireSafe();
+	if (_fd >= 0) {
+		MessageManager::Log("[SharedMemory] Stopped exporting to " + _name);
+	}
+	Close(true);
+}
+
+void SharedMemoryExporter::Close(bool unlink)
+{
+	_active = false;
+	if (_mapping) {
+		munmap(_mapping, _mappingSize);
+		_mapping = nullptr;
+		_mappingSize = 0;
+	}
+	if (_fd >= 0) {
+		close(_fd);
+		_fd = -1;
+		if (unlink) {
+			shm_unlink(_name.c_str());
+		}
+	}
+	_regions.clear();
+	_frameOffset = 0;
+	_frameCapacity = 0;
+}
+
+SharedMemoryStatus SharedMemoryExporter::GetStatus()
+{
+	auto lock = _lock.AcquireSafe();
+	SharedMemoryStatus status;
+	status.Active = _active;
+	status.Name = _name;
+	status.Error = _lastError;
+	status.TotalSize = _mappingSize;
+	status.LayoutId = _layoutId;
+	status.FramesPublished = _framesPublished;
+	status.LastPublishUs = _lastPublishUs;
+	for (const Region& region : _regions) {
+		status.MemoryTypes.push_back(region.Type);
+	}
+	return status;
+}
+
+vector<MemoryType> SharedMemoryExporter::GetExportedTypes()
+{
+	vector<MemoryType> types;
+	if (_exportAllTypes) {
+		for (int i = 0; i < DebugUtilities::GetMemoryTypeCount() && types.size() < MaxRegions; i++) {
+			MemoryType type = (MemoryType)i;
+			if (!DebugUtilities::IsRom(type) && _emu->GetMemory(type).Size > 0) {
+				types.push_back(type);
+			}
+		}
+	} else {
+		types = _requestedTypes;
+	}
+	return types;
+}
+
+bool SharedMemoryExporter::IsLayoutValid(const PpuFrameInfo& frame)
+{
+	if (frame.FrameBufferSize > _frameCapacity) {
+		return false;
+	}
+
+	// Compare without allocating - this runs every frame
+	size_t regionIndex = 0;
+	auto matches = [&](MemoryType type) {
+		if (regionIndex >= _regions.size() || _regions[regionIndex].Type != type) {
+			return false;
+		}
+		return _regions[regionIndex++].Size == _emu->GetMemory(type).Size;
+	};
+
+	if (_exportAllTypes) {
+		for (int i = 0; i < DebugUtilities::GetMemoryTypeCount() && regionIndex < MaxRegions; i++) {
+			MemoryType type = (MemoryType)i;
+			if (!DebugUtilities::IsRom(type) && _emu->GetMemory(type).Size > 0 && !matches(type)) {
+				return false;
+			}
+		}
+	} else {
+		for (MemoryType type : _requestedTypes) {
+			if (!matches(type)) {
+				return false;
+			}
+		}
+	}
+	return regionIndex == _regions.size();
+}
+
+bool SharedMemoryExporter::UpdateLayout(const PpuFrameInfo& frame, string& error)
+{
+	vector<MemoryType> types = GetExportedTypes();
+
+	uint32_t offset = AlignOffset(sizeof(SharedMemoryHeader));
+	_frameOffset = offset;
+	_frameCapacity = std::max(_frameCapacity, frame.FrameBufferSize);
+	offset = AlignOffset(offset + _frameCapacity);
+
+	vector<Region> regions;
+	for (MemoryType type : types) {
+		uint32_t size = _emu->GetMemory(type).Size;
+		regions.push_back({ type, offset, size });
+		offset = AlignOffset(offset + size);
+	}
+
+	// Only ever grow the object - shrinking it would make existing reader mappings fault
+	if (offset > _mappingSize && !CreateMapping(offset, error)) {
+		return false;
+	}
+
+	_regions = std::move(regions);
+	_layoutId++;
+
+	SharedMemoryHeader* header = (SharedMemoryHeader*)_mapping;
+	header->LayoutId = _layoutId;
+	header->TotalSize = _mappingSize;
+	header->FrameOffset = _frameOffset;
+	header->FrameSize = _frameCapacity;
+	header->RegionCount = (uint32_t)_regions.size();
+	memset(header->Regions, 0, sizeof(header->Regions));
+	for (size_t i = 0; i < _regions.size(); i++) {
+		SharedMemoryRegionEntry& entry = header->Regions[i];
+		entry.MemoryType = (uint32_t)_regions[i].Type;
+		entry.Offset = _regions[i].Offset;
+		entry.Size = _regions[i].Size;
+		string typeName(magic_enum::enum_name(_regions[i].Type));
+		strncpy(entry.Name, typeName.c_str(), sizeof(entry.Name) - 1);
+	}
+	return true;
+}
+
+bool SharedMemoryExporter::CreateMapping(uint32_t size, string& error)
+{
+	// Some platforms (e.g macOS) only allow setting the size of a shared memory object once,
+	// so growing it means replacing it with a new object (readers keep the old one mapped until they reopen it)
+	shm_unlink(_name.c_str());
+	int fd = shm_open(_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+	if (fd < 0) {
+		error = string("shm_open failed: ") + strerror(errno);
+		return false;
+	}
+
+	void* mapping = MAP_FAILED;
+	if (ftruncate(fd, size) != 0) {
+		error = string("ftruncate failed: ") + strerror(errno);
+	} else if ((mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED) {
+		error = string("mmap failed: ") + strerror(errno);
+	}
+	if (mapping == MAP_FAILED) {
+		close(fd);
+		shm_unlink(_name.c_str());
+		return false;
+	}
+
+	SharedMemoryHeader* header = (SharedMemoryHeader*)mapping;
+	memcpy(header->Magic, Magic, sizeof(header->Magic));
+	header->Version = Version;
+	header->HeaderSize = sizeof(SharedMemoryHeader);
+
+	if (_mapping) {
+		// Continue the sequence where the old object left it (Publish ends the frame on the new object),
+		// and make the readers of the old object reopen it by name
+		SharedMemoryHeader* oldHeader = (SharedMemoryHeader*)_mapping;
+		uint64_t sequence = oldHeader->Sequence.load(std::memory_order_relaxed);
+		header->Sequence.store(sequence, std::memory_order_relaxed);
+		oldHeader->LayoutId = _layoutId + 1;
+		oldHeader->TotalSize = size;
+		oldHeader->Sequence.store(sequence + (sequence & 1), std::memory_order_release);
+
+		munmap(_mapping, _mappingSize);
+		close(_fd);
+	}
+
+	_fd = fd;
+	_mapping = (uint8_t*)mapping;
+	_mappingSize = size;
+	return true;
+}
+
+void SharedMemoryExporter::Publish()
+{
+	if (!_active.load(std::memory_order_relaxed)) {
+		return;
+	}
+
+	auto lock = _lock.AcquireSafe();
+	if (!_mapping) {
+		return;
+	}
+
+	Timer timer;
+	PpuFrameInfo frame = _emu->GetPpuFrame();
+	SharedMemoryHeader* header = (SharedMemoryHeader*)_mapping;
+
+	uint64_t sequence = header->Sequence.load(std::memory_order_relaxed);
+	header->Sequence.store(sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	if (!IsLayoutValid(frame)) {
+		string error;
+		if (!UpdateLayout(frame, error)) {
+			// The old mapping is still valid - leave it readable and stop publishing
+			header->Sequence.store(sequence + 2, std::memory_order_release);
+			MessageManager::Log("[SharedMemory] Stopped: " + error);
+			_lastError = error;
+			_active = false;
+			return;
+		}
+		header = (SharedMemoryHeader*)_mapping;
+	}
+
+	if (frame.FrameBuffer && frame.FrameBufferSize > 0) {
+		memcpy(_mapping + _frameOffset, frame.FrameBuffer, frame.FrameBufferSize);
+		header->FrameWidth = frame.Width;
+		header->FrameHeight = frame.Height;
+		header->FrameBytesPerPixel = frame.Width && frame.Height ? frame.FrameBufferSize / (frame.Width * frame.Height) : 0;
+	}
+
+	for (const Region& region : _regions) {
+		ConsoleMemoryInfo mem = _emu->GetMemory(region.Type);
+		if (mem.Memory) {
+			memcpy(_mapping + region.Offset, mem.Memory, region.Size);
+		}
+	}
+	header->FrameCount = frame.FrameCount;
+
+	header->Sequence.store(sequence + 2, std::memory_order_release);
+
+	_framesPublished++;
+	_lastPublishUs = (uint64_t)(timer.GetElapsedMS() * 1000);
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include "pch.h"
+#include "Shared/MemoryType.h"
+#include "Utilities/SimpleLock.h"
+
+class Emulator;
+struct PpuFrameInfo;
+
+// Layout of the shared memory region (all fields little-endian, offsets from the start of the mapping).
+// Readers use Sequence as a seqlock: it is odd while the emulation thread is copying a frame in,
+// so a reader copies what it needs and retries when Sequence was odd or changed in the meantime.
+// When the region has to grow (e.g. a ROM with larger memory types is loaded), it is replaced by a new
+// object with the same name, and the old object's TotalSize/LayoutId are set to the new object's values -
+// readers must then reopen it by name. The region never shrinks while it exists.
+struct SharedMemoryRegionEntry
+{
+	uint32_t MemoryType;
+	uint32_t Offset;
+	uint32_t Size;
+	uint32_t Reserved;
+	char Name[32];
+};
+
+struct SharedMemoryHeader
+{
+	char Magic[8];
+	uint32_t Version;
+	uint32_t HeaderSize;
+	atomic<uint64_t> Sequence;
+	uint64_t FrameCount;
+	uint32_t LayoutId;
+	uint32_t TotalSize;
+	uint32_t FrameWidth;
+	uint32_t FrameHeight;
+	uint32_t FrameOffset;
+	uint32_t FrameSize;
+	uint32_t FrameBytesPerPixel;
+	uint32_t RegionCount;
+	SharedMemoryRegionEntry Regions[32];
+};
+
+struct SharedMemoryStatus
+{
+	bool Active = false;
+	string Name;
+	string Error;
+	uint32_t TotalSize = 0;
+	uint32_t LayoutId = 0;
+	uint64_t FramesPublished = 0;
+	uint64_t LastPublishUs = 0;
+	vector<MemoryType> MemoryTypes;
+};
+
+// Publishes the frame buffer and selected memory types into a POSIX shared memory object
+// at the end of each frame, so local tools can read emulator state without socket round-trips.
+class SharedMemoryExporter {
+public:
+	static constexpr const char* Magic = "MESENSHM";
+	static constexpr uint32_t Version = 1;
+	static constexpr uint32_t MaxRegions = 32;
+
+	SharedMemoryExporter(Emulator* emu);
+	~SharedMemoryExporter();
+
+	// Creates (or replaces) the shared memory object. An empty memTypes list exports
+	// every registered non-ROM memory type of the current console.
+	bool Start(const string& name, const vector<MemoryType>& memTypes, string& error);
+	void Stop();
+	bool IsActive() const { return _active.load(std::memory_order_relaxed); }
+	SharedMemoryStatus GetStatus();
+
+	// Called by the emulation thread at the end of each (non run-ahead) frame
+	void Publish();
+
+private:
+	struct Region
+	{
+		MemoryType Type;
+		uint32_t Offset;
+		uint32_t Size;
+	};
+
+	Emulator* _emu;
+	atomic<bool> _active;
+	SimpleLock _lock;
+
+	string _name;
+	string _lastError;
+	int _fd = -1;
+	uint8_t* _mapping = nullptr;
+	uint32_t _mappingSize = 0;
+	uint32_t _layoutId = 0;
+	uint64_t _framesPublished = 0;
+	uint64_t _lastPublishUs = 0;
+
+	bool _exportAllTypes = true;
+	vector<MemoryType> _requestedTypes;
+	vector<Region> _regions;
+	uint32_t _frameOffset = 0;
+	uint32_t _frameCapacity = 0;
+
+	vector<MemoryType> GetExportedTypes();
+	bool IsLayoutValid(const PpuFrameInfo& frame);
+	bool UpdateLayout(const PpuFrameInfo& frame, string& error);
+	bool CreateMapping(uint32_t size, string& error);
+	void Close(bool unlink);
+};
@@ -10,9 +10,15 @@
 #include "RomInfo.h"
 #include "Core/Debugger/Debugger.h"
 #include "Core/Debugger/ITraceLogger.h"
+#include "Core/Debugger/TraceLogFileSaver.h"
+#include "Core/Debugger/DebugBreakHelper.h"
+#include "Core/Debugger/TraceStore.h"
 #include "Core/Debugger/ScriptManager.h"
 #include "Core/Debugger/DebugTypes.h"
 #include "Core/Debugger/Disassembler.h"
+#include "Core/Debugger/DisassemblyExporter.h"
+#include "Core/Debugger/SamplingProfiler.h"
+#include "Core/Debugger/CdlManager.h"
 #include "Core/Debugger/MemoryDumper.h"
 #include "Core/Debugger/LabelManager.h"
 #include "Core/Debugger/Breakpoint.h"
@@ -20,18 +26,32 @@
 #include "Core/Debugger/CallstackManager.h"
 #include "Core/Debugger/DebugUtilities.h"
 #include "SNES/SnesCpuTypes.h"
+#include "SNES/Input/SnesController.h"
+#include "NES/Input/NesController.h"
+#include "Gameboy/Input/GbController.h"
+#include "GBA/Input/GbaController.h"
+#include "PCE/Input/PceController.h"
+#include "SMS/Input/SmsController.h"
 #include "Shared/TimingInfo.h"
+#include "Shared/Interfaces/IInputProvider.h"
+#include "Shared/BaseControlManager.h"
 #include "Shared/Video/VideoDecoder.h"
 #include "Shared/Video/VideoRenderer.h"
+#include "Shared/Video/ScreenshotEncoder.h"
 #include "Utilities/HexUtilities.h"
 #include "Utilities/VirtualFile.h"
 #include "Utilities/FolderUtilities.h"
+#include "Utilities/magic_enum.hpp"
+#include "Utilities/StringUtilities.h"
 #include "SNES/SnesPpuTypes.h"
 #include "SNES/SpcTypes.h"
 #include "SNES/Coprocessors/DSP/NecDspTypes.h"
 #include "SNES/Coprocessors/GSU/GsuTypes.h"
 #include "SNES/Coprocessors/CX4/Cx4Types.h"
 #include "YazeStateBridge.h"
+#include "SharedMemoryExporter.h"
+#include "MemorySearch.h"
+#include "Utilities/ThreadPool.h"
 
 #include <sys/socket.h>
 #include <sys/un.h>
@@ -60,42 +80,15 @@ using std::make_unique;
 
 namespace fs = std::filesystem;
 
-// Static member definitions for memory snapshots
-unordered_map<string, MemorySnapshot> SocketServer::_snapshots;
-SimpleLock SocketServer::_snapshotLock;
-
-// Static member definitions for breakpoints
-vector<SocketBreakpoint> SocketServer::_breakpoints;
-uint32_t SocketServer::_nextBreakpointId = 1;
-SimpleLock SocketServer::_breakpointLock;
-
-// Static member definitions for P register tracking
-std::deque<PRegisterChange> SocketServer::_pRegisterLog;
-uint32_t SocketServer::_pRegisterLogMaxSize = 1000;
-bool SocketServer::_pRegisterWatchEnabled = false;
-uint8_t SocketServer::_lastPRegister = 0;
-SimpleLock SocketServer::_pRegisterLock;
-
-// Static member definitions for memory write attribution
-vector<MemoryWatchRegion> SocketServer::_memoryWatches;
-unordered_map<uint32_t, std::deque<MemoryWriteRecord>> SocketServer::_memoryWriteLog;
-uint32_t SocketServer::_nextMemoryWatchId = 1;
-SimpleLock SocketServer::_memoryWatchLock;
-
-// Static member definitions for symbol table
-unordered_map<string, SymbolEntry> SocketServer::_symbolTable;
-SimpleLock SocketServer::_symbolLock;
-
-// Static member definitions for logpoints
-vector<SocketLogpoint> SocketServer::_logpoints;
-std::deque<LogpointHit> SocketServer::_logpointHits;
-uint32_t SocketServer::_nextLogpointId = 1;
-uint32_t SocketServer::_logpointHitMaxSize = 1000;
-SimpleLock SocketServer::_logpointLock;
-
 // Static member definitions for event subscription
-unordered_map<int, std::set<string>> SocketServer::_eventSubscriptions;
+unordered_map<int, EventSubscriber> SocketServer::_eventSubscriptions;
 SimpleLock SocketServer::_eventLock;
+MpscQueue<SocketEvent> SocketServer::_eventQueue(4096);
+AutoResetEvent SocketServer::_eventSignal;
+atomic<bool> SocketServer::_eventThreadIdle(false);
+atomic<uint32_t> SocketServer::_eventSubscriberCount(0);
+atomic<uint64_t> SocketServer::_eventsPublished(0);
+atomic<uint64_t> SocketServer::_eventsDroppedQueueFull(0);
 
 // Static member definitions for agent registration
 unordered_map<int, AgentInfo> SocketServer::_registeredAgents;
@@ -121,15 +114,6 @@ SimpleLock SocketServer::_validationLock;
 SocketLogLevel SocketServer::_logLevel = SocketLogLevel::Info;
 SimpleLock SocketServer::_logLevelLock;
 
-// Static member definitions for state diff
-unordered_map<string, string> SocketServer::_lastState;
-SimpleLock SocketServer::_stateLock;
-
-// Static member definitions for watch triggers
-vector<WatchTrigger> SocketServer::_watchTriggers;
-uint32_t SocketServer::_nextWatchTriggerId = 1;
-SimpleLock SocketServer::_watchTriggerLock;
-
 // Forward declarations for helper functions
 static string NormalizeKey(string value);
 static bool TryParseMemoryType(const string& memtype, MemoryType& outType);
@@ -141,11 +125,14 @@ static string CpuTypeName(CpuType cpuType);
 static void AppendCpuStateJson(stringstream& ss, CpuType cpuType, Debugger* debugger);
 static string Trim(string value);
 static bool ReadRequestLine(int clientFd, std::atomic<bool>& running, string& out, string& error);
+static bool ReadExact(int clientFd, std::atomic<bool>& running, uint8_t* out, size_t length, string& error);
 static bool ParseJsonObject(const string& json, unordered_map<string, string>& out, string& error);
 static bool ParseJsonString(const string& json, size_t& index, string& out, string& error);
 static void AppendUtf8(string& out, uint32_t codepoint);
 static bool WriteAll(int clientFd, const string& data);
+static ssize_t SendSome(int clientFd, const char* buffer, size_t length);
 static string Base64Encode(const vector<uint8_t>& data);
+static void AppendBase64(string& out, const uint8_t* data, size_t size);
 static string Base64Decode(const string& encoded);
 static uint64_t NowMs();
 static bool ParseBoolValue(const string& value);
@@ -153,6 +140,14 @@ static bool ResolveSaveStatePath(const string& inputPath, bool allowExternal, st
 static string BuildSaveLoadStatusJson(const SaveLoadResult& status);
 static bool WriteFileAtomic(const string& path, const string& contents);
 
+static ssize_t SendSome(int clientFd, const char* buffer, size_t length) {
+#ifdef MSG_NOSIGNAL
+	return send(clientFd, buffer, length, MSG_NOSIGNAL);
+#else
+	return write(clientFd, buffer, length);
+#endif
+}
+
 static bool WriteAll(int clientFd, const string& data) {
 	const char* buffer = data.c_str();
 	size_t total = data.size();
@@ -283,8 +278,10 @@ void SocketServer::RegisterHandlers() {
 	_handlers["STATEINSPECT"] = HandleStateInspector;
 	_handlers["INPUT"] = HandleSetInput;
 	_handlers["DISASM"] = HandleDisasm;
+	_handlers["DISASM_EXPORT"] = HandleDisasmExport;
 	_handlers["STEP"] = HandleStep;
 	_handlers["FRAME"] = HandleRunFrame;
+	_handlers["RUN_FRAMES"] = HandleRunFrames;
         _handlers["CALLSTACK"] = HandleCallstack;
         _handlers["OSD"] = HandleOsd;
 	_handlers["ROMINFO"] = HandleRomInfo;
@@ -300,6 +297,8 @@ void SocketServer::RegisterHandlers() {
 	_handlers["SUBSCRIBE"] = HandleSubscribe;
 	_handlers["BATCH"] = HandleBatch;
 	_handlers["TRACE"] = HandleTrace;
+	_handlers["TRACE_QUERY"] = HandleTraceQuery;
+	_handlers["PROFILER"] = HandleProfiler;
 
 	// P register tracking handlers
 	_handlers["P_WATCH"] = HandlePWatch;
@@ -344,6 +343,11 @@ void SocketServer::RegisterHandlers() {
 	_handlers["STATE_DIFF"] = HandleStateDiff;
 	_handlers["WATCH_TRIGGER"] = HandleWatchTrigger;
 
+	// Protocol negotiation
+	_handlers["PROTOCOL"] = HandleProtocol;
+	_handlers["SHM"] = HandleShm;
+	_handlers["INSTANCE"] = HandleInstance;
+
 	// Initialize validation rules
 	{
 		auto lock = _lock.AcquireSafe();
@@ -356,12 +360,17 @@ void SocketServer::RegisterHandler(const string& command, CommandHandler handler
 	_handlers[command] = handler;
 }
 
+SocketInstanceState::~SocketInstanceState() {
+	delete memoryWatchIndex.load();
+	delete logpointIndex.load();
+}
+
 // Debugger hook: Log P register changes
-void SocketServer::LogPRegisterChange(uint32_t pc, uint8_t oldP, uint8_t newP, uint8_t opcode, uint64_t cycleCount) {
-	if (!_pRegisterWatchEnabled) return;
+void SocketInstanceState::LogPRegisterChange(uint32_t pc, uint8_t oldP, uint8_t newP, uint8_t opcode, uint64_t cycleCount) {
+	if (!pRegisterWatchEnabled) return;
 	if (oldP == newP) return;  // No change
 
-	auto lock = _pRegisterLock.AcquireSafe();
+	auto lock = pRegisterLock.AcquireSafe();
 
 	PRegisterChange change;
 	change.pc = pc;
@@ -370,51 +379,161 @@ void SocketServer::LogPRegisterChange(uint32_t pc, uint8_t oldP, uint8_t newP, u
 	change.opcode = opcode;
 	change.cycleCount = cycleCount;
 
-	_pRegisterLog.push_back(change);
+	pRegisterLog.push_back(change);
 
 	// Trim if over max size
-	while (_pRegisterLog.size() > _pRegisterLogMaxSize) {
-		_pRegisterLog.pop_front();
+	while (pRegisterLog.size() > pRegisterLogMaxSize) {
+		pRegisterLog.pop_front();
 	}
 }
 
-// Debugger hook: Check if any memory watch covers an address
-bool SocketServer::HasMemoryWatch(uint32_t addr) {
-	auto lock = _memoryWatchLock.AcquireSafe();
-	for (const auto& watch : _memoryWatches) {
-		if (addr >= watch.startAddr && addr <= watch.endAddr) {
-			return true;
+// Rebuild the lock-free watch index from memoryWatches and publish it.
+// The previous index is retired rather than deleted, since the write hook may still be reading it.
+void SocketInstanceState::RebuildMemoryWatchIndex() {
+	const MemoryWatchIndex* prevIndex = memoryWatchIndex.load(std::memory_order_relaxed);
+
+	unique_ptr<MemoryWatchIndex> index;
+	if (!memoryWatches.empty()) {
+		index = make_unique<MemoryWatchIndex>();
+		index->intervals.reserve(memoryWatches.size());
+		for (const auto& watch : memoryWatches) {
+			index->intervals.push_back({ watch.startAddr, watch.endAddr, 0, watch.id });
+
+			constexpr uint32_t maxAddr = (1 << MemoryWatchIndex::AddressBits) - 1;
+			if (watch.startAddr <= maxAddr) {
+				uint32_t firstPage = watch.startAddr >> MemoryWatchIndex::PageShift;
+				uint32_t lastPage = std::min(watch.endAddr, maxAddr) >> MemoryWatchIndex::PageShift;
+				for (uint32_t page = firstPage; page <= lastPage; page++) {
+					index->pageBitmap[page >> 6] |= (uint64_t)1 << (page & 0x3F);
+				}
+			}
+		}
+
+		std::sort(index->intervals.begin(), index->intervals.end(), [](const MemoryWatchIndex::Interval& a, const MemoryWatchIndex::Interval& b) {
+			return a.startAddr < b.startAddr;
+		});
+		uint32_t maxEndAddr = 0;
+		for (auto& interval : index->intervals) {
+			maxEndAddr = std::max(maxEndAddr, interval.endAddr);
+			interval.maxEndAddr = maxEndAddr;
+		}
+	}
+
+	memoryWatchIndex.store(index.release(), std::memory_order_release);
+	if (prevIndex) {
+		retiredMemoryWatchIndexes.emplace_back(const_cast<MemoryWatchIndex*>(prevIndex));
+		hasRetiredMemoryWatchIndexes = true;
+	}
+}
+
+void SocketInstanceState::ReleaseRetiredMemoryWatchIndexes() {
+	if (!hasRetiredMemoryWatchIndexes.load(std::memory_order_relaxed)) return;
+
+	auto lock = memoryWatchLock.AcquireSafe();
+	retiredMemoryWatchIndexes.clear();
+	hasRetiredMemoryWatchIndexes = false;
+}
+
+// Rebuild the lock-free logpoint index from the enabled logpoints and publish it (retiring the previous one)
+void SocketInstanceState::RebuildLogpointIndex() {
+	const LogpointIndex* prevIndex = logpointIndex.load(std::memory_order_relaxed);
+
+	unique_ptr<LogpointIndex> index;
+	for (const auto& lp : logpoints) {
+		if (!lp.enabled) continue;
+
+		if (!index) {
+			index = make_unique<LogpointIndex>();
+		}
+		index->entries.push_back({ lp.id, lp.cpuType, (uint32_t)lp.addr, !lp.expression.empty(), lp.compiledExpression });
+		index->Set(lp.cpuType, (uint32_t)lp.addr);
+	}
+
+	if (index) {
+		std::stable_sort(index->entries.begin(), index->entries.end(), [](const LogpointIndex::Entry& a, const LogpointIndex::Entry& b) {
+			return a.cpuType != b.cpuType ? a.cpuType < b.cpuType : a.addr < b.addr;
+		});
+	}
+
+	logpointIndex.store(index.release(), std::memory_order_release);
+	if (prevIndex) {
+		retiredLogpointIndexes.emplace_back(const_cast<LogpointIndex*>(prevIndex));
+		hasRetiredLogpointIndexes = true;
+	}
+}
+
+void SocketInstanceState::ReleaseRetiredLogpointIndexes() {
+	if (!hasRetiredLogpointIndexes.load(std::memory_order_relaxed)) return;
+
+	auto lock = logpointLock.AcquireSafe();
+	retiredLogpointIndexes.clear();
+	hasRetiredLogpointIndexes = false;
+}
+
+// Same text as the debugger's watch window for each result type
+static string FormatLogpointValue(EvalResultType resultType, int64_t value) {
+	switch (resultType) {
+		case EvalResultType::Numeric: return std::to_string(value);
+		case EvalResultType::Boolean: return value == 0 ? "false" : "true";
+		case EvalResultType::DivideBy0: return "<division by zero>";
+		case EvalResultType::OutOfScope: return "<label out of scope>";
+		default: return "<invalid expression>";
+	}
+}
+
+void SocketInstanceState::DrainLogpointHits(uint32_t instanceId) {
+	bool broadcast = SocketServer::HasEventSubscribers();
+
+	RawLogpointHit raw;
+	while (rawLogpointHits.TryPop(raw)) {
+		LogpointHit hit;
+		hit.logpointId = raw.logpointId;
+		hit.pc = raw.pc;
+		hit.cpuType = raw.cpuType;
+		hit.cycleCount = raw.cycleCount;
+		if (raw.hasValue) {
+			hit.value = FormatLogpointValue(raw.resultType, raw.value);
+		}
+
+		if (broadcast) {
+			stringstream ss;
+			ss << "{\"id\":" << hit.logpointId << ",\"pc\":\"" << FormatHex(hit.pc, 6) << "\",\"value\":\"" << JsonEscape(hit.value) << "\"}";
+			SocketServer::BroadcastEvent("LOGPOINT", ss.str(), instanceId);
+		}
+
+		logpointHits.push_back(std::move(hit));
+		if (logpointHits.size() > logpointHitMaxSize) {
+			logpointHits.pop_front();
 		}
 	}
-	return false;
 }
 
 // Debugger hook: Log memory writes for watched addresses
-void SocketServer::LogMemoryWrite(uint32_t pc, uint32_t addr, uint16_t value, uint8_t size, uint64_t cycleCount, uint16_t stackPointer) {
-	auto lock = _memoryWatchLock.AcquireSafe();
-
-	// Check all watches to see if this address is being watched
-	for (auto& watch : _memoryWatches) {
-		// Check if the write overlaps with the watch region
-		uint32_t writeEnd = addr + size - 1;
-		if (writeEnd >= watch.startAddr && addr <= watch.endAddr) {
-			// This write overlaps with the watch region
-			MemoryWriteRecord record;
-			record.pc = pc;
-			record.addr = addr;
-			record.value = value;
-			record.size = size;
-			record.cycleCount = cycleCount;
-			record.stackPointer = stackPointer;
-
-			_memoryWriteLog[watch.id].push_back(record);
-
-			// Trim if over max depth
-			while (_memoryWriteLog[watch.id].size() > watch.maxDepth) {
-				_memoryWriteLog[watch.id].pop_front();
+void SocketInstanceState::LogMemoryWrite(uint32_t pc, uint32_t addr, uint16_t value, uint8_t size, uint64_t cycleCount, uint16_t stackPointer) {
+	auto lock = memoryWatchLock.AcquireSafe();
+
+	const MemoryWatchIndex* index = memoryWatchIndex.load(std::memory_order_acquire);
+	if (index) {
+		MemoryWriteRecord record;
+		record.pc = pc;
+		record.addr = addr;
+		record.value = value;
+		record.size = size;
+		record.cycleCount = cycleCount;
+		record.stackPointer = stackPointer;
+
+		// Every watch overlapping the written range gets a copy of the record
+		index->ForEachOverlap(addr, addr + size - 1, [this, &record](const MemoryWatchIndex::Interval& interval) {
+			auto logIt = memoryWriteLog.find(interval.watchId);
+			if (logIt != memoryWriteLog.end()) {
+				logIt->second.Push(record);
 			}
-		}
+		});
 	}
+
+	// This runs on the emulation thread, which is the only thread reading indexes without the lock
+	retiredMemoryWatchIndexes.clear();
+	hasRetiredMemoryWatchIndexes = false;
 }
 
 void SocketServer::Start() {
@@ -451,6 +570,7 @@ void SocketServer::Start() {
 
 	_running = true;
 	_serverThread = make_unique<thread>(&SocketServer::ServerLoop, this);
+	_eventThread = make_unique<thread>(&SocketServer::EventLoop, this);
 
 	MessageManager::Log("[SocketServer] Started on " + _socketPath);
 	
@@ -475,6 +595,15 @@ void SocketServer::Stop() {
 	}
 	_serverThread.reset();
 
+	_eventSignal.Signal();
+	if (_eventThread && _eventThread->joinable()) {
+		_eventThread->join();
+	}
+	_eventThread.reset();
+
+	// No command can reach the secondary instances anymore
+	ReleaseInstances();
+
 	// Remove socket file
 	unlink(_socketPath.c_str());
 	
@@ -546,9 +675,11 @@ void SocketServer::ServerLoop() {
 	vector<struct pollfd> pfds;
 	pfds.push_back({ _serverFd, POLLIN, 0 });
 	auto lastStatusUpdate = std::chrono::steady_clock::now();
+	bool hasLogpoints = false;
 
 	while (_running) {
-		int ret = poll(pfds.data(), (nfds_t)pfds.size(), 100); // 100ms timeout
+		// Wake up more often while logpoint hits may need to be published
+		int ret = poll(pfds.data(), (nfds_t)pfds.size(), hasLogpoints ? 10 : 100);
 		if (ret < 0) {
 			if (errno != EINTR) {
 				break;
@@ -556,6 +687,8 @@ void SocketServer::ServerLoop() {
 			continue;
 		}
 
+		hasLogpoints = DrainLogpointHits();
+
 		auto now = std::chrono::steady_clock::now();
 		if (now - lastStatusUpdate >= std::chrono::seconds(1)) {
 			UpdateStatusFile();
@@ -586,26 +719,20 @@ void SocketServer::ServerLoop() {
 		for (size_t i = 1; i < pfds.size(); ) {
 			if (pfds[i].revents & POLLIN) {
 				if (!HandleClient(pfds[i].fd)) {
-					// Connection should be closed
+					// Connection should be closed - remove from event clients first,
+					// so the publisher thread can't write to a closed (or reused) fd
+					RemoveSubscriber(pfds[i].fd);
+					_binaryClients.erase(pfds[i].fd);
 					close(pfds[i].fd);
 
-					// Remove from event clients if it was subscribed
-					{
-						auto lock = _eventLock.AcquireSafe();
-						_eventSubscriptions.erase(pfds[i].fd);
-					}
-
 					pfds.erase(pfds.begin() + i);
 					continue;
 				}
 			} else if (pfds[i].revents & (POLLERR | POLLHUP | POLLNVAL)) {
-				close(pfds[i].fd);
-
 				// Remove from event clients
-				{
-					auto lock = _eventLock.AcquireSafe();
-					_eventSubscriptions.erase(pfds[i].fd);
-				}
+				RemoveSubscriber(pfds[i].fd);
+				_binaryClients.erase(pfds[i].fd);
+				close(pfds[i].fd);
 
 				pfds.erase(pfds.begin() + i);
 				continue;
@@ -618,9 +745,15 @@ void SocketServer::ServerLoop() {
 	for (size_t i = 1; i < pfds.size(); i++) {
 		close(pfds[i].fd);
 	}
+	_binaryClients.clear();
 }
 
 bool SocketServer::HandleClient(int clientFd) {
+	auto binaryClient = _binaryClients.find(clientFd);
+	if (binaryClient != _binaryClients.end()) {
+		return HandleBinaryClient(clientFd, binaryClient->second);
+	}
+
 	auto startTime = std::chrono::steady_clock::now();
 	string request;
 	string readError;
@@ -632,7 +765,7 @@ bool SocketServer::HandleClient(int clientFd) {
 			response.error = readError;
 			response.errorCode = SocketErrorCode::ConnectionError;
 			string responseJson = response.ToJson() + "\n";
-			if (!WriteAll(clientFd, responseJson)) {
+			if (!SendToClient(clientFd, responseJson)) {
 				return false; // Failure to write error response, close connection
 			}
 		}
@@ -648,7 +781,7 @@ bool SocketServer::HandleClient(int clientFd) {
 		response.error = parseError.empty() ? "Invalid request" : parseError;
 		response.errorCode = SocketErrorCode::InvalidRequest;
 		string responseJson = response.ToJson() + "\n";
-		WriteAll(clientFd, responseJson);
+		SendToClient(clientFd, responseJson);
 		return true; // Keep open, maybe next command is valid
 	}
 
@@ -661,10 +794,48 @@ bool SocketServer::HandleClient(int clientFd) {
 		response.error = validationError;
 		response.errorCode = validationErrorCode;
 		string responseJson = response.ToJson() + "\n";
-		WriteAll(clientFd, responseJson);
+		SendToClient(clientFd, responseJson);
 		return true; // Keep open, validation errors are retryable
 	}
 
+	SocketResponse response = DispatchCommand(cmd);
+
+	// Calculate latency
+	auto endTime = std::chrono::steady_clock::now();
+	auto latencyUs = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count();
+	RecordCommandHistory(cmd.type, response.errorCode, latencyUs);
+
+	string responseJson = response.ToJson() + "\n";
+	SendToClient(clientFd, responseJson);
+
+	if (cmd.type == "PROTOCOL" && response.success && NormalizeKey(cmd.GetParam("mode")) == "binary") {
+		// All further requests on this connection use binary frames, addressed to the handshake's instance
+		int instanceId = 0;
+		TryParseInt(cmd.GetParam("instance", "0"), instanceId);
+		_binaryClients[clientFd] = (uint32_t)instanceId;
+	}
+	
+	// If the command was SUBSCRIBE, we definitely keep it open,
+	// but generally we keep all open now until they disconnect.
+	return true;
+}
+
+SocketResponse SocketServer::DispatchCommand(const SocketCommand& cmd) {
+	// Any command can target a secondary instance with "instance":"<id>"
+	Emulator* emu = _emu;
+	string instanceParam = cmd.GetParam("instance");
+	if (!instanceParam.empty()) {
+		int instanceId = 0;
+		emu = TryParseInt(instanceParam, instanceId) && instanceId >= 0 ? GetInstance((uint32_t)instanceId) : nullptr;
+		if (!emu) {
+			SocketResponse response;
+			response.success = false;
+			response.error = "Unknown instance: " + instanceParam;
+			response.errorCode = SocketErrorCode::InvalidParameter;
+			return response;
+		}
+	}
+
 	CommandHandler handler;
 	{
 		auto lock = _lock.AcquireSafe();
@@ -677,7 +848,7 @@ bool SocketServer::HandleClient(int clientFd) {
 	SocketResponse response;
 	if (handler) {
 		try {
-			response = handler(_emu, cmd);
+			response = handler(emu, cmd);
 		} catch (const std::exception& e) {
 			response.success = false;
 			response.error = string("Internal error: ") + e.what();
@@ -695,262 +866,361 @@ bool SocketServer::HandleClient(int clientFd) {
 		response.errorCode = SocketErrorCode::CommandNotFound;
 		response.retryable = false;
 	}
+	return response;
+}
 
-	// Calculate latency
-	auto endTime = std::chrono::steady_clock::now();
-	auto latencyUs = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count();
-
-	// Record command history
-	{
-		auto lock = _historyLock.AcquireSafe();
-		CommandHistoryEntry entry;
-		entry.command = cmd.type;
-		auto now = std::chrono::system_clock::now();
-		auto timeT = std::chrono::system_clock::to_time_t(now);
-		char timeStr[64];
-		std::strftime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M:%S", std::localtime(&timeT));
-		entry.timestamp = timeStr;
-		entry.errorCode = response.errorCode;
-		entry.latencyUs = latencyUs;
-		
-		_commandHistory.push_back(entry);
-		while (_commandHistory.size() > _commandHistoryMaxSize) {
-			_commandHistory.pop_front();
-		}
+void SocketServer::RecordCommandHistory(const string& command, SocketErrorCode errorCode, uint64_t latencyUs) {
+	auto lock = _historyLock.AcquireSafe();
+	CommandHistoryEntry entry;
+	entry.command = command;
+	auto now = std::chrono::system_clock::now();
+	auto timeT = std::chrono::system_clock::to_time_t(now);
+	char timeStr[64];
+	std::strftime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M:%S", std::localtime(&timeT));
+	entry.timestamp = timeStr;
+	entry.errorCode = errorCode;
+	entry.latencyUs = latencyUs;
+	
+	_commandHistory.push_back(entry);
+	while (_commandHistory.size() > _commandHistoryMaxSize) {
+		_commandHistory.pop_front();
 	}
+}
 
-	string responseJson = response.ToJson() + "\n";
-	WriteAll(clientFd, responseJson);
-	
-	// If the command was SUBSCRIBE, we definitely keep it open,
-	// but generally we keep all open now until they disconnect.
-	return true;
+// ============================================================================
+// Binary Protocol
+// ============================================================================
+
+static uint16_t ReadLE16(const uint8_t* data) {
+	return (uint16_t)(data[0] | (data[1] << 8));
 }
 
-bool SocketServer::ParseCommand(const string& json, SocketCommand& cmd, string& error) {
-	cmd.type.clear();
-	cmd.params.clear();
+static uint32_t ReadLE32(const uint8_t* data) {
+	return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
 
-	unordered_map<string, string> params;
-	if(!ParseJsonObject(json, params, error)) {
-		return false;
-	}
+static void AppendLE16(string& out, uint16_t value) {
+	out.push_back((char)(value & 0xFF));
+	out.push_back((char)(value >> 8));
+}
 
-	auto typeIt = params.find("type");
-	if(typeIt == params.end()) {
-		error = "Missing type field";
-		return false;
-	}
+static void AppendLE32(string& out, uint32_t value) {
+	AppendLE16(out, value & 0xFFFF);
+	AppendLE16(out, value >> 16);
+}
 
-	cmd.type = Trim(typeIt->second);
-	if(cmd.type.empty()) {
-		error = "Missing command type";
+static string BuildBinaryFrame(SocketErrorCode status, uint16_t tag, const char* payload, size_t payloadSize) {
+	string frame;
+	frame.reserve(SocketBinaryHeaderSize + payloadSize);
+	AppendLE32(frame, (uint32_t)payloadSize);
+	AppendLE16(frame, (uint16_t)status);
+	AppendLE16(frame, tag);
+	frame.append(payload, payloadSize);
+	return frame;
+}
+
+static string BuildBinaryError(SocketErrorCode status, uint16_t tag, const string& error) {
+	return BuildBinaryFrame(status == SocketErrorCode::None ? SocketErrorCode::InternalError : status, tag, error.data(), error.size());
+}
+
+// Reads and parses a binary COMMAND payload into a regular SocketCommand (no JSON involved)
+static bool ParseBinaryCommand(const vector<uint8_t>& payload, SocketCommand& cmd, string& error) {
+	size_t pos = 0;
+	auto readString = [&](size_t lengthSize, string& out) -> bool {
+		if (pos + lengthSize > payload.size()) {
+			return false;
+		}
+		size_t length = lengthSize == 1 ? payload[pos] : ReadLE16(&payload[pos]);
+		pos += lengthSize;
+		if (pos + length > payload.size()) {
+			return false;
+		}
+		out.assign((const char*)payload.data() + pos, length);
+		pos += length;
+		return true;
+	};
+
+	if (!readString(1, cmd.type) || pos + 2 > payload.size()) {
+		error = "Malformed command payload";
 		return false;
 	}
-
 	std::transform(cmd.type.begin(), cmd.type.end(), cmd.type.begin(), [](unsigned char c) {
 		return static_cast<char>(std::toupper(c));
 	});
 
-	params.erase(typeIt);
-	cmd.params = std::move(params);
+	uint16_t paramCount = ReadLE16(&payload[pos]);
+	pos += 2;
+	for (uint16_t i = 0; i < paramCount; i++) {
+		string key;
+		string value;
+		if (!readString(1, key) || !readString(2, value)) {
+			error = "Malformed command parameter";
+			return false;
+		}
+		cmd.params[std::move(key)] = std::move(value);
+	}
 	return true;
 }
 
-bool SocketServer::ValidateCommand(const SocketCommand& cmd, string& error, SocketErrorCode& errorCode) {
-	auto lock = _validationLock.AcquireSafe();
-	auto it = _validationRules.find(cmd.type);
-	
-	// If no specific rule, use default validation
-	CommandValidation rule;
-	if (it != _validationRules.end()) {
-		rule = it->second;
-	} else {
-		// Default rule
-		rule.maxRequestSize = 1024 * 1024;
-		rule.maxParams = 50;
-		rule.allowEmptyParams = true;
-	}
-
-	// Check parameter count
-	if (cmd.params.size() > rule.maxParams) {
-		error = "Too many parameters (max: " + std::to_string(rule.maxParams) + ")";
-		errorCode = SocketErrorCode::InvalidParameter;
+bool SocketServer::HandleBinaryClient(int clientFd, uint32_t& instanceId) {
+	uint8_t header[SocketBinaryHeaderSize];
+	string readError;
+	if (!ReadExact(clientFd, _running, header, SocketBinaryHeaderSize, readError)) {
 		return false;
 	}
 
-	// Check required parameters
-	for (const auto& required : rule.requiredParams) {
-		if (cmd.params.find(required) == cmd.params.end()) {
-			error = "Missing required parameter: " + required;
-			errorCode = SocketErrorCode::MissingParameter;
-			return false;
-		}
+	auto startTime = std::chrono::steady_clock::now();
+	uint32_t payloadSize = ReadLE32(header);
+	SocketBinaryOpcode opcode = (SocketBinaryOpcode)ReadLE16(header + 4);
+	uint16_t tag = ReadLE16(header + 6);
+
+	if (payloadSize > SocketBinaryMaxPayload) {
+		// Can't resync the stream after this, close the connection
+		SendToClient(clientFd, BuildBinaryError(SocketErrorCode::RequestTooLarge, tag, "Request too large"));
+		return false;
 	}
 
-	// Check if empty params are allowed
-	if (!rule.allowEmptyParams && cmd.params.empty()) {
-		error = "Command requires parameters";
-		errorCode = SocketErrorCode::MissingParameter;
+	vector<uint8_t> payload(payloadSize);
+	if (payloadSize > 0 && !ReadExact(clientFd, _running, payload.data(), payloadSize, readError)) {
 		return false;
 	}
 
-	errorCode = SocketErrorCode::None;
-	return true;
-}
+	string response;
+	SocketErrorCode status = SocketErrorCode::None;
+	const char* commandName = "BINARY";
 
-// ============================================================================
-// Command Handlers
-// ============================================================================
+	// Instances are only destroyed by this thread, the pointer stays valid until the request is done
+	Emulator* emu = GetInstance(instanceId);
+	auto getEmulator = [&]() -> bool {
+		if (!emu) {
+			status = SocketErrorCode::InvalidState;
+			response = BuildBinaryError(status, tag, "Selected instance " + std::to_string(instanceId) + " was destroyed");
+			return false;
+		}
+		return true;
+	};
 
-SocketResponse SocketServer::HandlePing(Emulator* emu, const SocketCommand& cmd) {
-	SocketResponse resp;
-	resp.success = true;
-	resp.data = "\"PONG\"";
-	return resp;
-}
+	auto getDumper = [&](MemoryDumper*& dumper) -> bool {
+		if (!getEmulator()) {
+			return false;
+		}
+		if (!emu->IsRunning()) {
+			status = SocketErrorCode::EmulatorNotRunning;
+			response = BuildBinaryError(status, tag, "No ROM loaded");
+			return false;
+		}
+		auto dbg = emu->GetDebugger(true);
+		if (!dbg.GetDebugger()) {
+			status = SocketErrorCode::DebuggerNotAvailable;
+			response = BuildBinaryError(status, tag, "Debugger not available");
+			return false;
+		}
+		dumper = dbg.GetDebugger()->GetMemoryDumper();
+		return true;
+	};
 
-SocketResponse SocketServer::HandleState(Emulator* emu, const SocketCommand& cmd) {
-	SocketResponse resp;
+	switch (opcode) {
+		case SocketBinaryOpcode::Ping:
+			commandName = "BIN_PING";
+			response = BuildBinaryFrame(status, tag, nullptr, 0);
+			break;
 
-	if (!emu->IsRunning()) {
-		resp.success = false;
-		resp.error = "No ROM loaded";
-		return resp;
-	}
+		case SocketBinaryOpcode::Read:
+		case SocketBinaryOpcode::Write: {
+			bool isRead = opcode == SocketBinaryOpcode::Read;
+			commandName = isRead ? "BIN_READ" : "BIN_WRITE";
+			if (payload.size() < (isRead ? 9u : 5u)) {
+				status = SocketErrorCode::InvalidRequest;
+				response = BuildBinaryError(status, tag, "Payload too short");
+				break;
+			}
 
-	stringstream ss;
-	ss << "{";
-	ss << "\"running\":" << (emu->IsRunning() ? "true" : "false") << ",";
-	ss << "\"paused\":" << (emu->IsPaused() ? "true" : "false") << ",";
-	ss << "\"frame\":" << emu->GetFrameCount() << ",";
-	ss << "\"fps\":" << fixed << setprecision(2) << emu->GetFps() << ",";
-	ss << "\"consoleType\":" << static_cast<int>(emu->GetConsoleType());
+			MemoryType memType = (MemoryType)payload[0];
+			uint32_t addr = ReadLE32(&payload[1]);
+			uint32_t length = isRead ? ReadLE32(&payload[5]) : (uint32_t)payload.size() - 5;
+			if ((uint32_t)memType >= DebugUtilities::GetMemoryTypeCount()) {
+				status = SocketErrorCode::InvalidParameter;
+				response = BuildBinaryError(status, tag, "Unknown memtype");
+				break;
+			}
+			if (isRead && length > SocketBinaryMaxPayload) {
+				status = SocketErrorCode::RequestTooLarge;
+				response = BuildBinaryError(status, tag, "Length too large");
+				break;
+			}
 
-	// If debugging, get more state
-	if (emu->IsDebugging()) {
-		auto dbg = emu->GetDebugger(false);
-		if (dbg.GetDebugger()) {
-			// Could add breakpoint count, etc.
-			ss << ",\"debugging\":true";
-		}
-	}
+			MemoryDumper* dumper = nullptr;
+			if (!getDumper(dumper)) {
+				break;
+			}
 
-	SaveLoadResult lastSave;
-	SaveLoadResult lastLoad;
-	{
-		auto lock = _saveLoadStatusLock.AcquireSafe();
-		lastSave = _lastSaveResult;
-		lastLoad = _lastLoadResult;
-	}
-	ss << ",\"lastSave\":" << BuildSaveLoadStatusJson(lastSave);
-	ss << ",\"lastLoad\":" << BuildSaveLoadStatusJson(lastLoad);
+			uint32_t memSize = dumper->GetMemorySize(memType);
+			if (memSize == 0 || addr >= memSize || length > memSize - addr) {
+				status = SocketErrorCode::MemoryOutOfRange;
+				response = BuildBinaryError(status, tag, "Address out of range");
+				break;
+			}
 
-	ss << "}";
+			if (isRead) {
+				// Read straight into the response frame, after its header
+				AppendLE32(response, length);
+				AppendLE16(response, (uint16_t)status);
+				AppendLE16(response, tag);
+				response.resize(SocketBinaryHeaderSize + length);
+				if (length > 0) {
+					dumper->GetMemoryValues(memType, addr, addr + length - 1, (uint8_t*)response.data() + SocketBinaryHeaderSize);
+				}
+			} else {
+				if (length > 0) {
+					dumper->SetMemoryValues(memType, addr, payload.data() + 5, length);
+				}
+				response = BuildBinaryFrame(status, tag, nullptr, 0);
+			}
+			break;
+		}
 
-	resp.success = true;
-	resp.data = ss.str();
-	return resp;
-}
+		case SocketBinaryOpcode::Frame: {
+			commandName = "BIN_FRAME";
+			SocketCommand cmd;
+			cmd.type = "FRAME";
+			cmd.clientFd = clientFd;
+			cmd.params["count"] = std::to_string(payload.size() >= 4 ? ReadLE32(payload.data()) : 1);
+			cmd.params["instance"] = std::to_string(instanceId);
+			SocketResponse resp = DispatchCommand(cmd);
+			status = resp.success ? SocketErrorCode::None : (resp.errorCode == SocketErrorCode::None ? SocketErrorCode::InvalidState : resp.errorCode);
+			response = resp.success ? BuildBinaryFrame(status, tag, nullptr, 0) : BuildBinaryError(status, tag, resp.error);
+			break;
+		}
 
-SocketResponse SocketServer::HandleHealth(Emulator* emu, const SocketCommand& cmd) {
-	SocketResponse resp;
-
-	bool running = emu->IsRunning();
-	bool paused = emu->IsPaused();
-	bool debugging = emu->IsDebugging();
-	bool scriptRunning = false;
-	if(running) {
-		auto dbg = emu->GetDebugger(false);
-		if(dbg.GetDebugger() && dbg.GetDebugger()->GetScriptManager()) {
-			scriptRunning = dbg.GetDebugger()->GetScriptManager()->HasScript();
+		case SocketBinaryOpcode::State: {
+			commandName = "BIN_STATE";
+			if (!getEmulator()) {
+				break;
+			}
+			string state;
+			AppendLE32(state, emu->IsRunning() ? emu->GetFrameCount() : 0);
+			state.push_back(emu->IsRunning() ? 1 : 0);
+			state.push_back(emu->IsPaused() ? 1 : 0);
+			response = BuildBinaryFrame(status, tag, state.data(), state.size());
+			break;
 		}
-	}
-
-	string watchHudText;
-	if(running && emu->GetVideoRenderer()) {
-		watchHudText = emu->GetVideoRenderer()->GetWatchHudText();
-	}
-
-	bool disasmOk = false;
-	string disasmData = "null";
-	string pcValue = "null";
-	CpuType cpuType = CpuType::Snes;
 
-	if(running) {
-		auto dbg = emu->GetDebugger(true);
-		if(dbg.GetDebugger()) {
-			auto cpuTypes = emu->GetCpuTypes();
-			if(!cpuTypes.empty()) {
-				cpuType = cpuTypes[0];
+		case SocketBinaryOpcode::Command: {
+			commandName = "BIN_COMMAND";
+			SocketCommand cmd;
+			cmd.clientFd = clientFd;
+			cmd.binary = true;
+			string parseError;
+			if (!ParseBinaryCommand(payload, cmd, parseError)) {
+				status = SocketErrorCode::InvalidRequest;
+				response = BuildBinaryError(status, tag, parseError);
+				break;
+			}
+			if (cmd.type == "SUBSCRIBE" || cmd.type == "PROTOCOL") {
+				// JSON event lines can't be mixed into a binary stream
+				status = SocketErrorCode::InvalidState;
+				response = BuildBinaryError(status, tag, cmd.type + " is not available in binary mode");
+				break;
+			}
+			if (!cmd.HasParam("instance")) {
+				cmd.params["instance"] = std::to_string(instanceId);
 			}
 
-			uint32_t pc = dbg.GetDebugger()->GetProgramCounter(cpuType, true);
-			pcValue = "\"" + FormatHex(pc, DebugUtilities::GetProgramCounterSize(cpuType)) + "\"";
+			string validationError;
+			if (!ValidateCommand(cmd, validationError, status)) {
+				response = BuildBinaryError(status, tag, validationError);
+				break;
+			}
 
-			SocketCommand disasmCmd;
-			disasmCmd.type = "DISASM";
-			disasmCmd.params["addr"] = FormatHex(pc, DebugUtilities::GetProgramCounterSize(cpuType));
-			disasmCmd.params["count"] = "1";
+			SocketResponse resp = DispatchCommand(cmd);
+			if (resp.success) {
+				status = SocketErrorCode::None;
+				response = BuildBinaryFrame(status, tag, resp.data.data(), resp.data.size());
+			} else {
+				status = resp.errorCode == SocketErrorCode::None ? SocketErrorCode::InternalError : resp.errorCode;
+				response = BuildBinaryError(status, tag, resp.error);
+			}
+			break;
+		}
 
-			SocketResponse disasmResp = HandleDisasm(emu, disasmCmd);
-			disasmOk = disasmResp.success;
-			if(disasmResp.success) {
-				disasmData = disasmResp.data;
+		case SocketBinaryOpcode::Instance: {
+			commandName = "BIN_INSTANCE";
+			if (payload.size() < 4) {
+				status = SocketErrorCode::InvalidRequest;
+				response = BuildBinaryError(status, tag, "Payload too short");
+				break;
 			}
+			uint32_t newInstanceId = ReadLE32(payload.data());
+			if (!GetInstance(newInstanceId)) {
+				status = SocketErrorCode::InvalidParameter;
+				response = BuildBinaryError(status, tag, "Unknown instance: " + std::to_string(newInstanceId));
+				break;
+			}
+			instanceId = newInstanceId;
+			response = BuildBinaryFrame(status, tag, nullptr, 0);
+			break;
 		}
+
+		default:
+			status = SocketErrorCode::CommandNotFound;
+			response = BuildBinaryError(status, tag, "Unknown opcode: " + std::to_string((int)opcode));
+			break;
 	}
 
-	// Get additional diagnostics
-	size_t agentCount = 0;
-	size_t subscriptionCount = 0;
-	uint64_t totalCommands = 0;
-	{
-		auto lock = _agentLock.AcquireSafe();
-		agentCount = _registeredAgents.size();
+	auto endTime = std::chrono::steady_clock::now();
+	auto latencyUs = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count();
+	RecordCommandHistory(commandName, status, latencyUs);
+
+	return SendToClient(clientFd, response);
+}
+
+SocketResponse SocketServer::HandleProtocol(Emulator* emu, const SocketCommand& cmd) {
+	SocketResponse resp;
+	(void)emu;
+
+	string mode = NormalizeKey(cmd.GetParam("mode", "json"));
+	if (mode != "binary" && mode != "json") {
+		resp.success = false;
+		resp.error = "Unknown mode: " + mode + ". Use json or binary.";
+		resp.errorCode = SocketErrorCode::InvalidParameter;
+		return resp;
 	}
+
 	{
 		auto lock = _eventLock.AcquireSafe();
-		subscriptionCount = _eventSubscriptions.size();
-	}
-	{
-		auto lock = _historyLock.AcquireSafe();
-		totalCommands = _commandHistory.size();
+		if (mode == "binary" && _eventSubscriptions.count(cmd.clientFd)) {
+			resp.success = false;
+			resp.error = "Unsubscribe from events before switching to binary mode";
+			resp.errorCode = SocketErrorCode::InvalidState;
+			return resp;
+		}
 	}
 
-	// Get YAZE sync status
-	string lastYazeState = YazeStateBridge::GetLastSyncedState();
-	uint64_t lastYazeFrame = YazeStateBridge::GetLastSyncedFrame();
-	string lastYazeError = YazeStateBridge::GetLastError();
-	uint64_t lastYazeErrorTime = YazeStateBridge::GetLastErrorTimeMs();
-
 	stringstream ss;
-	ss << "{";
-	ss << "\"running\":" << (running ? "true" : "false") << ",";
-	ss << "\"paused\":" << (paused ? "true" : "false") << ",";
-	ss << "\"debugging\":" << (debugging ? "true" : "false") << ",";
-	ss << "\"scriptRunning\":" << (scriptRunning ? "true" : "false") << ",";
-	ss << "\"consoleType\":" << static_cast<int>(emu->GetConsoleType()) << ",";
-	ss << "\"cpuType\":" << (running ? std::to_string(static_cast<int>(cpuType)) : "null") << ",";
-	ss << "\"pc\":" << pcValue << ",";
-	ss << "\"disasmOk\":" << (disasmOk ? "true" : "false") << ",";
-	ss << "\"disasm\":" << (disasmOk ? disasmData : "null") << ",";
-	ss << "\"watchHudText\":\"" << JsonEscape(watchHudText) << "\",";
-	ss << "\"diagnostics\":{";
-	ss << "\"registeredAgents\":" << agentCount << ",";
-	ss << "\"activeSubscriptions\":" << subscriptionCount << ",";
-	ss << "\"totalCommands\":" << totalCommands << ",";
-	ss << "\"yazeSync\":{";
-	ss << "\"lastState\":\"" << JsonEscape(lastYazeState) << "\",";
-	ss << "\"lastFrame\":" << lastYazeFrame << ",";
-	if(lastYazeError.empty()) {
-		ss << "\"lastError\":null,";
-	} else {
-		ss << "\"lastError\":\"" << JsonEscape(lastYazeError) << "\",";
+	ss << "{\"protocol\":\"" << mode << "\",\"version\":1";
+	if (mode == "binary") {
+		ss << ",\"headerSize\":" << SocketBinaryHeaderSize;
+		ss << ",\"maxPayload\":" << SocketBinaryMaxPayload;
+		ss << ",\"opcodes\":{";
+		ss << "\"PING\":" << (int)SocketBinaryOpcode::Ping;
+		ss << ",\"READ\":" << (int)SocketBinaryOpcode::Read;
+		ss << ",\"WRITE\":" << (int)SocketBinaryOpcode::Write;
+		ss << ",\"FRAME\":" << (int)SocketBinaryOpcode::Frame;
+		ss << ",\"STATE\":" << (int)SocketBinaryOpcode::State;
+		ss << ",\"COMMAND\":" << (int)SocketBinaryOpcode::Command;
+		ss << ",\"INSTANCE\":" << (int)SocketBinaryOpcode::Instance;
+		ss << "}";
+
+		// READ/WRITE take the numeric memory type
+		ss << ",\"memoryTypes\":{";
+		bool first = true;
+		for (auto& entry : magic_enum::enum_entries<MemoryType>()) {
+			if (!first) ss << ",";
+			first = false;
+			ss << "\"" << entry.second << "\":" << (int)entry.first;
+		}
+		ss << "}";
 	}
-	ss << "\"lastErrorTimeMs\":" << lastYazeErrorTime;
-	ss << "}";
-	ss << "}";
 	ss << "}";
 
 	resp.success = true;
@@ -958,397 +1228,615 @@ SocketResponse SocketServer::HandleHealth(Emulator* emu, const SocketCommand& cm
 	return resp;
 }
 
-SocketResponse SocketServer::HandlePause(Emulator* emu, const SocketCommand& cmd) {
-	SocketResponse resp;
-	emu->Pause();
-	resp.success = true;
-	resp.data = "\"OK\"";
-	return resp;
-}
-
-SocketResponse SocketServer::HandleResume(Emulator* emu, const SocketCommand& cmd) {
-	SocketResponse resp;
-	emu->Resume();
-	resp.success = true;
-	resp.data = "\"OK\"";
-	return resp;
-}
-
-SocketResponse SocketServer::HandleReset(Emulator* emu, const SocketCommand& cmd) {
-	SocketResponse resp;
-	emu->Reset();
-	resp.success = true;
-	resp.data = "\"OK\"";
-	return resp;
-}
-
-SocketResponse SocketServer::HandleRead(Emulator* emu, const SocketCommand& cmd) {
+SocketResponse SocketServer::HandleShm(Emulator* emu, const SocketCommand& cmd) {
 	SocketResponse resp;
-
-	auto it = cmd.params.find("addr");
-	if (it == cmd.params.end()) {
+	SharedMemoryExporter* exporter = emu->GetSharedMemoryExporter();
+	if (!exporter) {
 		resp.success = false;
-		resp.error = "Missing addr parameter";
+		resp.error = "Shared memory export is not available";
+		resp.errorCode = SocketErrorCode::InvalidState;
 		return resp;
 	}
 
-	uint32_t addr = 0;
-	string addrStr = it->second;
-	if (addrStr.substr(0, 2) == "0x" || addrStr.substr(0, 2) == "0X") {
-		addr = std::stoul(addrStr.substr(2), nullptr, 16);
-	} else {
-		addr = std::stoul(addrStr, nullptr, 16);
-	}
+	string action = NormalizeKey(cmd.GetParam("action", "status"));
+	if (action == "start") {
+		string defaultName = "/mesen2-" + std::to_string(getpid());
+		if (emu->GetInstanceId() != 0) {
+			defaultName += "-" + std::to_string(emu->GetInstanceId());
+		}
+		string name = cmd.GetParam("name", defaultName);
 
-	// Read from memory (default to SNES memory map)
-	auto dbg = emu->GetDebugger(true);
-	if (!dbg.GetDebugger()) {
-		resp.success = false;
-		resp.error = "Debugger not available";
-		return resp;
-	}
+		// Comma-separated memory types, e.g. "wram,vram,cgram" (default: all registered RAM types)
+		vector<MemoryType> memTypes;
+		for (const string& entry : StringUtilities::Split(cmd.GetParam("memtypes"), ',')) {
+			string memtype = StringUtilities::Trim(entry);
+			if (memtype.empty()) {
+				continue;
+			}
+			MemoryType memType;
+			if (!TryParseMemoryType(memtype, memType)) {
+				resp.success = false;
+				resp.error = "Invalid memtype: " + memtype;
+				resp.errorCode = SocketErrorCode::InvalidParameter;
+				return resp;
+			}
+			memTypes.push_back(memType);
+		}
 
-	MemoryType memType = MemoryType::SnesMemory;
-	auto memtypeIt = cmd.params.find("memtype");
-	if (memtypeIt != cmd.params.end()) {
-		if(!TryParseMemoryType(memtypeIt->second, memType)) {
+		string error;
+		if (!exporter->Start(name, memTypes, error)) {
 			resp.success = false;
-			resp.error = "Unknown memtype: " + memtypeIt->second;
+			resp.error = error;
+			resp.errorCode = SocketErrorCode::InternalError;
 			return resp;
 		}
-	}
-
-	auto dumper = dbg.GetDebugger()->GetMemoryDumper();
-	uint32_t memSize = dumper->GetMemorySize(memType);
-	if(memSize == 0) {
-		resp.success = false;
-		resp.error = "Memory type not available or empty";
-		return resp;
-	}
-	if(addr >= memSize) {
+	} else if (action == "stop") {
+		exporter->Stop();
+	} else if (action != "status") {
 		resp.success = false;
-		resp.error = "Address out of range";
+		resp.error = "Unknown action: " + action + ". Use start, stop or status.";
+		resp.errorCode = SocketErrorCode::InvalidParameter;
 		return resp;
 	}
 
-	uint8_t value = dumper->GetMemoryValue(memType, addr);
-
+	SharedMemoryStatus status = exporter->GetStatus();
 	stringstream ss;
-	ss << "\"0x" << hex << uppercase << setw(2) << setfill('0') << (int)value << "\"";
+	ss << "{\"active\":" << (status.Active ? "true" : "false");
+	ss << ",\"name\":\"" << JsonEscape(status.Name) << "\"";
+	ss << ",\"version\":" << SharedMemoryExporter::Version;
+	ss << ",\"size\":" << status.TotalSize;
+	ss << ",\"layoutId\":" << status.LayoutId;
+	ss << ",\"framesPublished\":" << status.FramesPublished;
+	ss << ",\"lastPublishUs\":" << status.LastPublishUs;
+	ss << ",\"memtypes\":[";
+	for (size_t i = 0; i < status.MemoryTypes.size(); i++) {
+		if (i > 0) ss << ",";
+		ss << "\"" << magic_enum::enum_name(status.MemoryTypes[i]) << "\"";
+	}
+	ss << "]";
+	if (!status.Error.empty()) {
+		ss << ",\"error\":\"" << JsonEscape(status.Error) << "\"";
+	}
+	ss << "}";
+
 	resp.success = true;
 	resp.data = ss.str();
 	return resp;
 }
 
-SocketResponse SocketServer::HandleRead16(Emulator* emu, const SocketCommand& cmd) {
-	SocketResponse resp;
+// ============================================================================
+// Emulator Instances
+// ============================================================================
 
-	auto it = cmd.params.find("addr");
-	if (it == cmd.params.end()) {
-		resp.success = false;
-		resp.error = "Missing addr parameter";
-		return resp;
+Emulator* SocketServer::GetInstance(uint32_t instanceId) {
+	if (instanceId == 0) {
+		return _emu;
 	}
+	auto lock = _instanceLock.AcquireSafe();
+	auto it = _instances.find(instanceId);
+	return it != _instances.end() ? it->second.get() : nullptr;
+}
 
-	uint32_t addr = 0;
-	string addrStr = it->second;
-	if (addrStr.substr(0, 2) == "0x" || addrStr.substr(0, 2) == "0X") {
-		addr = std::stoul(addrStr.substr(2), nullptr, 16);
-	} else {
-		addr = std::stoul(addrStr, nullptr, 16);
+vector<uint32_t> SocketServer::GetInstanceIds() {
+	auto lock = _instanceLock.AcquireSafe();
+	vector<uint32_t> ids = { 0 };
+	for (const auto& [id, instance] : _instances) {
+		ids.push_back(id);
 	}
+	return ids;
+}
 
-	auto dbg = emu->GetDebugger(true);
-	if (!dbg.GetDebugger()) {
-		resp.success = false;
-		resp.error = "Debugger not available";
-		return resp;
+uint32_t SocketServer::CreateInstance(const string& romPath, bool cloneState, string& error) {
+	VirtualFile romFile = romPath.empty() ? _emu->GetRomInfo().RomFile : VirtualFile(romPath);
+	VirtualFile patchFile = romPath.empty() ? _emu->GetRomInfo().PatchFile : VirtualFile();
+	if (!romFile.IsValid()) {
+		error = romPath.empty() ? "No ROM loaded - specify rom" : "ROM not found: " + romPath;
+		return 0;
 	}
 
-	MemoryType memType = MemoryType::SnesMemory;
-	auto memtypeIt = cmd.params.find("memtype");
-	if (memtypeIt != cmd.params.end()) {
-		if(!TryParseMemoryType(memtypeIt->second, memType)) {
-			resp.success = false;
-			resp.error = "Unknown memtype: " + memtypeIt->second;
-			return resp;
-		}
-	}
+	// Secondary instances only run on RUN_FRAMES threads - no emulation thread, shortcuts or socket of their own
+	unique_ptr<Emulator> instance(new Emulator());
+	instance->Initialize(false, false);
+	instance->GetSettings()->CopySettings(*_emu->GetSettings());
 
-	auto dumper = dbg.GetDebugger()->GetMemoryDumper();
-	uint32_t memSize = dumper->GetMemorySize(memType);
-	if(memSize == 0) {
-		resp.success = false;
-		resp.error = "Memory type not available or empty";
-		return resp;
+	uint32_t instanceId;
+	{
+		auto lock = _instanceLock.AcquireSafe();
+		instanceId = _nextInstanceId++;
 	}
-	if(addr >= memSize || addr + 1 >= memSize) {
-		resp.success = false;
-		resp.error = "Address out of range";
-		return resp;
+	instance->SetInstanceId(instanceId);
+
+	// stopRom = false: nothing to stop yet, and no emulation thread gets started
+	if (!instance->LoadRom(romFile, patchFile, false)) {
+		instance->Release();
+		error = "Failed to load ROM: " + romFile.GetFilePath();
+		return 0;
 	}
 
-	uint8_t lo = dumper->GetMemoryValue(memType, addr);
-	uint8_t hi = dumper->GetMemoryValue(memType, addr + 1);
-	uint16_t value = lo | (hi << 8);
+	if (cloneState) {
+		if (!_emu->IsRunning()) {
+			instance->Release();
+			error = "No ROM loaded - nothing to clone";
+			return 0;
+		}
+		stringstream state;
+		{
+			auto lock = _emu->AcquireLock(false);
+			_emu->GetSaveStateManager()->SaveState(state, CompressionCodec::Lz4);
+		}
+		bool loaded;
+		{
+			auto lock = instance->AcquireLock(false);
+			loaded = instance->GetSaveStateManager()->LoadState(state);
+		}
+		if (!loaded) {
+			instance->Release();
+			error = "Failed to copy state to the new instance";
+			return 0;
+		}
+	}
 
-	stringstream ss;
-	ss << "\"0x" << hex << uppercase << setw(4) << setfill('0') << value << "\"";
-	resp.success = true;
-	resp.data = ss.str();
-	return resp;
+	auto lock = _instanceLock.AcquireSafe();
+	_instances[instanceId] = std::move(instance);
+	return instanceId;
 }
 
-SocketResponse SocketServer::HandleWrite(Emulator* emu, const SocketCommand& cmd) {
-	SocketResponse resp;
-
-	auto addrIt = cmd.params.find("addr");
-	auto valIt = cmd.params.find("value");
-	if (valIt == cmd.params.end()) {
-		valIt = cmd.params.find("val");
-	}
-
-	if (addrIt == cmd.params.end() || valIt == cmd.params.end()) {
-		resp.success = false;
-		resp.error = "Missing addr or value parameter";
-		return resp;
+bool SocketServer::DestroyInstance(uint32_t instanceId) {
+	unique_ptr<Emulator> instance;
+	{
+		auto lock = _instanceLock.AcquireSafe();
+		auto it = _instances.find(instanceId);
+		if (it == _instances.end()) {
+			return false;
+		}
+		instance = std::move(it->second);
+		_instances.erase(it);
 	}
 
-	uint32_t addr = 0;
-	string addrStr = addrIt->second;
-	if (addrStr.substr(0, 2) == "0x" || addrStr.substr(0, 2) == "0X") {
-		addr = std::stoul(addrStr.substr(2), nullptr, 16);
-	} else {
-		addr = std::stoul(addrStr, nullptr, 16);
-	}
+	// Rollout instances never write battery files or the recent games list
+	instance->Stop(false, true, false);
+	instance->Release();
+	return true;
+}
 
-	uint8_t value = 0;
-	string valStr = valIt->second;
-	if (valStr.substr(0, 2) == "0x" || valStr.substr(0, 2) == "0X") {
-		value = std::stoul(valStr.substr(2), nullptr, 16);
-	} else {
-		value = std::stoul(valStr);
+void SocketServer::ReleaseInstances() {
+	for (uint32_t instanceId : GetInstanceIds()) {
+		if (instanceId != 0) {
+			DestroyInstance(instanceId);
+		}
 	}
+	_instancePool.reset();
+}
 
-	auto dbg = emu->GetDebugger(true);
-	if (!dbg.GetDebugger()) {
+SocketResponse SocketServer::HandleInstance(Emulator* emu, const SocketCommand& cmd) {
+	SocketResponse resp;
+	SocketServer* server = emu->GetSocketServer();
+	if (!server) {
 		resp.success = false;
-		resp.error = "Debugger not available";
+		resp.error = "Instances can only be managed through instance 0";
+		resp.errorCode = SocketErrorCode::InvalidParameter;
 		return resp;
 	}
 
-	MemoryType memType = MemoryType::SnesMemory;
-	auto memtypeIt = cmd.params.find("memtype");
-	if (memtypeIt != cmd.params.end()) {
-		if(!TryParseMemoryType(memtypeIt->second, memType)) {
+	string action = NormalizeKey(cmd.GetParam("action", "list"));
+	if (action == "create") {
+		int count = 1;
+		if (cmd.params.count("count") && (!TryParseInt(cmd.GetParam("count"), count) || count < 1 || count > 256)) {
 			resp.success = false;
-			resp.error = "Unknown memtype: " + memtypeIt->second;
+			resp.error = "count must be 1-256";
+			resp.errorCode = SocketErrorCode::InvalidParameter;
 			return resp;
 		}
-	}
 
-	auto dumper = dbg.GetDebugger()->GetMemoryDumper();
-	uint32_t memSize = dumper->GetMemorySize(memType);
-	if(memSize == 0) {
-		resp.success = false;
-		resp.error = "Memory type not available or empty";
+		// By default a new instance starts from instance 0's current state when running the same ROM
+		bool cloneState = NormalizeKey(cmd.GetParam("clone", cmd.HasParam("rom") ? "false" : "true")) == "true";
+		vector<uint32_t> created;
+		for (int i = 0; i < count; i++) {
+			string error;
+			uint32_t instanceId = server->CreateInstance(cmd.GetParam("rom"), cloneState, error);
+			if (instanceId == 0) {
+				// Don't leave a partial batch behind
+				for (uint32_t id : created) {
+					server->DestroyInstance(id);
+				}
+				resp.success = false;
+				resp.error = error;
+				resp.errorCode = SocketErrorCode::InvalidState;
+				return resp;
+			}
+			created.push_back(instanceId);
+		}
+
+		stringstream ss;
+		ss << "{\"created\":[";
+		for (size_t i = 0; i < created.size(); i++) {
+			if (i > 0) ss << ",";
+			ss << created[i];
+		}
+		ss << "]}";
+		resp.success = true;
+		resp.data = ss.str();
 		return resp;
-	}
-	if(addr >= memSize) {
+	} else if (action == "destroy") {
+		vector<uint32_t> ids;
+		string idParam = cmd.GetParam("id");
+		if (NormalizeKey(idParam) == "all") {
+			ids = server->GetInstanceIds();
+			ids.erase(ids.begin());
+		} else {
+			for (const string& entry : StringUtilities::Split(idParam, ',')) {
+				int instanceId = 0;
+				if (!TryParseInt(StringUtilities::Trim(entry), instanceId) || instanceId <= 0 || !server->GetInstance((uint32_t)instanceId)) {
+					resp.success = false;
+					resp.error = "Unknown instance: " + entry + " (instance 0 can't be destroyed)";
+					resp.errorCode = SocketErrorCode::InvalidParameter;
+					return resp;
+				}
+				ids.push_back((uint32_t)instanceId);
+			}
+		}
+		for (uint32_t instanceId : ids) {
+			server->DestroyInstance(instanceId);
+		}
+		resp.success = true;
+		resp.data = "{\"destroyed\":" + std::to_string(ids.size()) + "}";
+		return resp;
+	} else if (action != "list") {
 		resp.success = false;
-		resp.error = "Address out of range";
+		resp.error = "Unknown action: " + action + ". Use create, destroy or list.";
+		resp.errorCode = SocketErrorCode::InvalidParameter;
 		return resp;
 	}
 
-	dumper->SetMemoryValue(memType, addr, value, false);
+	stringstream ss;
+	ss << "{\"instances\":[";
+	vector<uint32_t> ids = server->GetInstanceIds();
+	for (size_t i = 0; i < ids.size(); i++) {
+		Emulator* instance = server->GetInstance(ids[i]);
+		if (i > 0) ss << ",";
+		ss << "{\"id\":" << ids[i];
+		ss << ",\"running\":" << (instance->IsRunning() ? "true" : "false");
+		ss << ",\"frame\":" << instance->GetFrameCount();
+		ss << ",\"rom\":\"" << JsonEscape(instance->GetRomInfo().RomFile.GetFileName()) << "\"}";
+	}
+	ss << "],\"threads\":" << std::thread::hardware_concurrency() << "}";
 
 	resp.success = true;
-	resp.data = "\"OK\"";
+	resp.data = ss.str();
 	return resp;
 }
 
-SocketResponse SocketServer::HandleWrite16(Emulator* emu, const SocketCommand& cmd) {
-	SocketResponse resp;
+bool SocketServer::ParseCommand(const string& json, SocketCommand& cmd, string& error) {
+	cmd.type.clear();
+	cmd.params.clear();
 
-	auto addrIt = cmd.params.find("addr");
-	auto valIt = cmd.params.find("value");
-	if (valIt == cmd.params.end()) {
-		valIt = cmd.params.find("val");
+	unordered_map<string, string> params;
+	if(!ParseJsonObject(json, params, error)) {
+		return false;
 	}
 
-	if (addrIt == cmd.params.end() || valIt == cmd.params.end()) {
-		resp.success = false;
-		resp.error = "Missing addr or value parameter";
-		return resp;
+	auto typeIt = params.find("type");
+	if(typeIt == params.end()) {
+		error = "Missing type field";
+		return false;
 	}
 
-	uint32_t addr = 0;
-	string addrStr = addrIt->second;
-	if (addrStr.substr(0, 2) == "0x" || addrStr.substr(0, 2) == "0X") {
-		addr = std::stoul(addrStr.substr(2), nullptr, 16);
-	} else {
-		addr = std::stoul(addrStr, nullptr, 16);
+	cmd.type = Trim(typeIt->second);
+	if(cmd.type.empty()) {
+		error = "Missing command type";
+		return false;
 	}
 
-	uint16_t value = 0;
-	string valStr = valIt->second;
-	if (valStr.substr(0, 2) == "0x" || valStr.substr(0, 2) == "0X") {
-		value = std::stoul(valStr.substr(2), nullptr, 16);
+	std::transform(cmd.type.begin(), cmd.type.end(), cmd.type.begin(), [](unsigned char c) {
+		return static_cast<char>(std::toupper(c));
+	});
+
+	params.erase(typeIt);
+	cmd.params = std::move(params);
+	return true;
+}
+
+bool SocketServer::ValidateCommand(const SocketCommand& cmd, string& error, SocketErrorCode& errorCode) {
+	auto lock = _validationLock.AcquireSafe();
+	auto it = _validationRules.find(cmd.type);
+	
+	// If no specific rule, use default validation
+	CommandValidation rule;
+	if (it != _validationRules.end()) {
+		rule = it->second;
 	} else {
-		value = std::stoul(valStr);
+		// Default rule
+		rule.maxRequestSize = 1024 * 1024;
+		rule.maxParams = 50;
+		rule.allowEmptyParams = true;
 	}
 
-	auto dbg = emu->GetDebugger(true);
-	if (!dbg.GetDebugger()) {
-		resp.success = false;
-		resp.error = "Debugger not available";
-		return resp;
+	// Check parameter count
+	if (cmd.params.size() > rule.maxParams) {
+		error = "Too many parameters (max: " + std::to_string(rule.maxParams) + ")";
+		errorCode = SocketErrorCode::InvalidParameter;
+		return false;
 	}
 
-	auto dumper = dbg.GetDebugger()->GetMemoryDumper();
-	MemoryType memType = MemoryType::SnesMemory;
-	auto memtypeIt = cmd.params.find("memtype");
-	if (memtypeIt != cmd.params.end()) {
-		if(!TryParseMemoryType(memtypeIt->second, memType)) {
-			resp.success = false;
-			resp.error = "Unknown memtype: " + memtypeIt->second;
-			return resp;
+	// Check required parameters
+	for (const auto& required : rule.requiredParams) {
+		if (cmd.params.find(required) == cmd.params.end()) {
+			error = "Missing required parameter: " + required;
+			errorCode = SocketErrorCode::MissingParameter;
+			return false;
 		}
 	}
 
-	uint32_t memSize = dumper->GetMemorySize(memType);
-	if(memSize == 0) {
-		resp.success = false;
-		resp.error = "Memory type not available or empty";
-		return resp;
-	}
-	if(addr >= memSize || addr + 1 >= memSize) {
-		resp.success = false;
-		resp.error = "Address out of range";
-		return resp;
+	// Check if empty params are allowed
+	if (!rule.allowEmptyParams && cmd.params.empty()) {
+		error = "Command requires parameters";
+		errorCode = SocketErrorCode::MissingParameter;
+		return false;
 	}
 
-	dumper->SetMemoryValue(memType, addr, value & 0xFF, false);
-	dumper->SetMemoryValue(memType, addr + 1, (value >> 8) & 0xFF, false);
+	errorCode = SocketErrorCode::None;
+	return true;
+}
+
+// ============================================================================
+// Command Handlers
+// ============================================================================
 
+SocketResponse SocketServer::HandlePing(Emulator* emu, const SocketCommand& cmd) {
+	SocketResponse resp;
 	resp.success = true;
-	resp.data = "\"OK\"";
+	resp.data = "\"PONG\"";
 	return resp;
 }
 
-SocketResponse SocketServer::HandleReadBlock(Emulator* emu, const SocketCommand& cmd) {
+SocketResponse SocketServer::HandleState(Emulator* emu, const SocketCommand& cmd) {
 	SocketResponse resp;
 
-	auto addrIt = cmd.params.find("addr");
-	auto lenIt = cmd.params.find("len");
-	if (lenIt == cmd.params.end()) {
-		lenIt = cmd.params.find("length");
-	}
-
-	if (addrIt == cmd.params.end() || lenIt == cmd.params.end()) {
+	if (!emu->IsRunning()) {
 		resp.success = false;
-		resp.error = "Missing addr or len parameter";
+		resp.error = "No ROM loaded";
 		return resp;
 	}
 
-	uint32_t addr = 0;
-	string addrStr = addrIt->second;
-	if (addrStr.substr(0, 2) == "0x" || addrStr.substr(0, 2) == "0X") {
-		addr = std::stoul(addrStr.substr(2), nullptr, 16);
-	} else {
-		addr = std::stoul(addrStr, nullptr, 16);
-	}
-
-	uint32_t len = std::stoul(lenIt->second);
-	if (len > 0x10000) len = 0x10000; // Limit to 64KB
-
-	auto dbg = emu->GetDebugger(true);
-	if (!dbg.GetDebugger()) {
-		resp.success = false;
-		resp.error = "Debugger not available";
-		return resp;
-	}
+	stringstream ss;
+	ss << "{";
+	ss << "\"running\":" << (emu->IsRunning() ? "true" : "false") << ",";
+	ss << "\"paused\":" << (emu->IsPaused() ? "true" : "false") << ",";
+	ss << "\"frame\":" << emu->GetFrameCount() << ",";
+	ss << "\"fps\":" << fixed << setprecision(2) << emu->GetFps() << ",";
+	ss << "\"consoleType\":" << static_cast<int>(emu->GetConsoleType());
 
-	MemoryType memType = MemoryType::SnesMemory;
-	auto memtypeIt = cmd.params.find("memtype");
-	if (memtypeIt != cmd.params.end()) {
-		if(!TryParseMemoryType(memtypeIt->second, memType)) {
-			resp.success = false;
-			resp.error = "Unknown memtype: " + memtypeIt->second;
-			return resp;
+	// If debugging, get more state
+	if (emu->IsDebugging()) {
+		auto dbg = emu->GetDebugger(false);
+		if (dbg.GetDebugger()) {
+			// Could add breakpoint count, etc.
+			ss << ",\"debugging\":true";
 		}
 	}
 
-	auto dumper = dbg.GetDebugger()->GetMemoryDumper();
-	uint32_t memSize = dumper->GetMemorySize(memType);
-	if(memSize == 0) {
-		resp.success = false;
-		resp.error = "Memory type not available or empty";
-		return resp;
-	}
-	if(addr >= memSize) {
-		resp.success = false;
-		resp.error = "Address out of range";
-		return resp;
-	}
-	if(addr + len > memSize) {
-		len = memSize - addr;
+	SaveLoadResult lastSave;
+	SaveLoadResult lastLoad;
+	{
+		auto lock = _saveLoadStatusLock.AcquireSafe();
+		lastSave = _lastSaveResult;
+		lastLoad = _lastLoadResult;
 	}
-
+	ss << ",\"lastSave\":" << BuildSaveLoadStatusJson(lastSave);
+	ss << ",\"lastLoad\":" << BuildSaveLoadStatusJson(lastLoad);
+
+	ss << "}";
+
+	resp.success = true;
+	resp.data = ss.str();
+	return resp;
+}
+
+SocketResponse SocketServer::HandleHealth(Emulator* emu, const SocketCommand& cmd) {
+	SocketResponse resp;
+
+	bool running = emu->IsRunning();
+	bool paused = emu->IsPaused();
+	bool debugging = emu->IsDebugging();
+	bool scriptRunning = false;
+	if(running) {
+		auto dbg = emu->GetDebugger(false);
+		if(dbg.GetDebugger() && dbg.GetDebugger()->GetScriptManager()) {
+			scriptRunning = dbg.GetDebugger()->GetScriptManager()->HasScript();
+		}
+	}
+
+	string watchHudText;
+	if(running && emu->GetVideoRenderer()) {
+		watchHudText = emu->GetVideoRenderer()->GetWatchHudText();
+	}
+
+	bool disasmOk = false;
+	string disasmData = "null";
+	string pcValue = "null";
+	CpuType cpuType = CpuType::Snes;
+
+	if(running) {
+		auto dbg = emu->GetDebugger(true);
+		if(dbg.GetDebugger()) {
+			auto cpuTypes = emu->GetCpuTypes();
+			if(!cpuTypes.empty()) {
+				cpuType = cpuTypes[0];
+			}
+
+			uint32_t pc = dbg.GetDebugger()->GetProgramCounter(cpuType, true);
+			pcValue = "\"" + FormatHex(pc, DebugUtilities::GetProgramCounterSize(cpuType)) + "\"";
+
+			SocketCommand disasmCmd;
+			disasmCmd.type = "DISASM";
+			disasmCmd.params["addr"] = FormatHex(pc, DebugUtilities::GetProgramCounterSize(cpuType));
+			disasmCmd.params["count"] = "1";
+
+			SocketResponse disasmResp = HandleDisasm(emu, disasmCmd);
+			disasmOk = disasmResp.success;
+			if(disasmResp.success) {
+				disasmData = disasmResp.data;
+			}
+		}
+	}
+
+	// Get additional diagnostics
+	size_t agentCount = 0;
+	size_t subscriptionCount = 0;
+	uint64_t totalCommands = 0;
+	{
+		auto lock = _agentLock.AcquireSafe();
+		agentCount = _registeredAgents.size();
+	}
+	{
+		auto lock = _eventLock.AcquireSafe();
+		subscriptionCount = _eventSubscriptions.size();
+	}
+	{
+		auto lock = _historyLock.AcquireSafe();
+		totalCommands = _commandHistory.size();
+	}
+
+	// Get YAZE sync status
+	string lastYazeState = YazeStateBridge::GetLastSyncedState();
+	uint64_t lastYazeFrame = YazeStateBridge::GetLastSyncedFrame();
+	string lastYazeError = YazeStateBridge::GetLastError();
+	uint64_t lastYazeErrorTime = YazeStateBridge::GetLastErrorTimeMs();
+
 	stringstream ss;
-	ss << "\"";
-	for (uint32_t i = 0; i < len; i++) {
-		uint8_t val = dumper->GetMemoryValue(memType, addr + i);
-		ss << hex << uppercase << setw(2) << setfill('0') << (int)val;
+	ss << "{";
+	ss << "\"running\":" << (running ? "true" : "false") << ",";
+	ss << "\"paused\":" << (paused ? "true" : "false") << ",";
+	ss << "\"debugging\":" << (debugging ? "true" : "false") << ",";
+	ss << "\"scriptRunning\":" << (scriptRunning ? "true" : "false") << ",";
+	ss << "\"consoleType\":" << static_cast<int>(emu->GetConsoleType()) << ",";
+	ss << "\"cpuType\":" << (running ? std::to_string(static_cast<int>(cpuType)) : "null") << ",";
+	ss << "\"pc\":" << pcValue << ",";
+	ss << "\"disasmOk\":" << (disasmOk ? "true" : "false") << ",";
+	ss << "\"disasm\":" << (disasmOk ? disasmData : "null") << ",";
+	ss << "\"watchHudText\":\"" << JsonEscape(watchHudText) << "\",";
+	ss << "\"diagnostics\":{";
+	ss << "\"registeredAgents\":" << agentCount << ",";
+	ss << "\"activeSubscriptions\":" << subscriptionCount << ",";
+	ss << "\"totalCommands\":" << totalCommands << ",";
+	ss << "\"yazeSync\":{";
+	ss << "\"lastState\":\"" << JsonEscape(lastYazeState) << "\",";
+	ss << "\"lastFrame\":" << lastYazeFrame << ",";
+	if(lastYazeError.empty()) {
+		ss << "\"lastError\":null,";
+	} else {
+		ss << "\"lastError\":\"" << JsonEscape(lastYazeError) << "\",";
 	}
-	ss << "\"";
+	ss << "\"lastErrorTimeMs\":" << lastYazeErrorTime;
+	ss << "}";
+	ss << "}";
+	ss << "}";
 
 	resp.success = true;
 	resp.data = ss.str();
 	return resp;
 }
 
-SocketResponse SocketServer::HandleWriteBlock(Emulator* emu, const SocketCommand& cmd) {
+SocketResponse SocketServer::HandlePause(Emulator* emu, const SocketCommand& cmd) {
 	SocketResponse resp;
+	emu->Pause();
+	resp.success = true;
+	resp.data = "\"OK\"";
+	return resp;
+}
 
-	auto addrIt = cmd.params.find("addr");
-	auto hexIt = cmd.params.find("hex");
+SocketResponse SocketServer::HandleResume(Emulator* emu, const SocketCommand& cmd) {
+	SocketResponse resp;
+	emu->Resume();
+	resp.success = true;
+	resp.data = "\"OK\"";
+	return resp;
+}
 
-	if (addrIt == cmd.params.end() || hexIt == cmd.params.end()) {
+SocketResponse SocketServer::HandleReset(Emulator* emu, const SocketCommand& cmd) {
+	SocketResponse resp;
+	emu->Reset();
+	resp.success = true;
+	resp.data = "\"OK\"";
+	return resp;
+}
+
+SocketResponse SocketServer::HandleRead(Emulator* emu, const SocketCommand& cmd) {
+	SocketResponse resp;
+
+	auto it = cmd.params.find("addr");
+	if (it == cmd.params.end()) {
 		resp.success = false;
-		resp.error = "Missing addr or hex parameter";
+		resp.error = "Missing addr parameter";
 		return resp;
 	}
 
 	uint32_t addr = 0;
-	string addrStr = addrIt->second;
+	string addrStr = it->second;
 	if (addrStr.substr(0, 2) == "0x" || addrStr.substr(0, 2) == "0X") {
 		addr = std::stoul(addrStr.substr(2), nullptr, 16);
 	} else {
 		addr = std::stoul(addrStr, nullptr, 16);
 	}
 
-	string hexStr = hexIt->second;
-	string cleaned;
-	cleaned.reserve(hexStr.size());
-	for (char c : hexStr) {
-		if (std::isspace(static_cast<unsigned char>(c)) || c == ',') {
-			continue;
+	// Read from memory (default to SNES memory map)
+	auto dbg = emu->GetDebugger(true);
+	if (!dbg.GetDebugger()) {
+		resp.success = false;
+		resp.error = "Debugger not available";
+		return resp;
+	}
+
+	MemoryType memType = MemoryType::SnesMemory;
+	auto memtypeIt = cmd.params.find("memtype");
+	if (memtypeIt != cmd.params.end()) {
+		if(!TryParseMemoryType(memtypeIt->second, memType)) {
+			resp.success = false;
+			resp.error = "Unknown memtype: " + memtypeIt->second;
+			return resp;
 		}
-		cleaned.push_back(c);
 	}
 
-	if (cleaned.empty()) {
+	auto dumper = dbg.GetDebugger()->GetMemoryDumper();
+	uint32_t memSize = dumper->GetMemorySize(memType);
+	if(memSize == 0) {
 		resp.success = false;
-		resp.error = "Empty hex payload";
+		resp.error = "Memory type not available or empty";
 		return resp;
 	}
-	if (cleaned.size() % 2 != 0) {
+	if(addr >= memSize) {
 		resp.success = false;
-		resp.error = "Hex payload must have an even length";
+		resp.error = "Address out of range";
+		return resp;
+	}
+
+	uint8_t value = dumper->GetMemoryValue(memType, addr);
+
+	stringstream ss;
+	ss << "\"0x" << hex << uppercase << setw(2) << setfill('0') << (int)value << "\"";
+	resp.success = true;
+	resp.data = ss.str();
+	return resp;
+}
+
+SocketResponse SocketServer::HandleRead16(Emulator* emu, const SocketCommand& cmd) {
+	SocketResponse resp;
+
+	auto it = cmd.params.find("addr");
+	if (it == cmd.params.end()) {
+		resp.success = false;
+		resp.error = "Missing addr parameter";
 		return resp;
 	}
 
+	uint32_t addr = 0;
+	string addrStr = it->second;
+	if (addrStr.substr(0, 2) == "0x" || addrStr.substr(0, 2) == "0X") {
+		addr = std::stoul(addrStr.substr(2), nullptr, 16);
+	} else {
+		addr = std::stoul(addrStr, nullptr, 16);
+	}
+
 	auto dbg = emu->GetDebugger(true);
 	if (!dbg.GetDebugger()) {
 		resp.success = false;
@@ -1373,408 +1861,270 @@ SocketResponse SocketServer::HandleWriteBlock(Emulator* emu, const SocketCommand
 		resp.error = "Memory type not available or empty";
 		return resp;
 	}
-
-	uint32_t byteCount = static_cast<uint32_t>(cleaned.size() / 2);
-	if(addr >= memSize || addr + byteCount > memSize) {
+	if(addr >= memSize || addr + 1 >= memSize) {
 		resp.success = false;
 		resp.error = "Address out of range";
 		return resp;
 	}
 
-	for(uint32_t i = 0; i < byteCount; i++) {
-		string byteStr = cleaned.substr(i * 2, 2);
-		uint8_t value = static_cast<uint8_t>(std::stoul(byteStr, nullptr, 16));
-		dumper->SetMemoryValue(memType, addr + i, value, false);
-	}
+	uint8_t lo = dumper->GetMemoryValue(memType, addr);
+	uint8_t hi = dumper->GetMemoryValue(memType, addr + 1);
+	uint16_t value = lo | (hi << 8);
 
 	stringstream ss;
-	ss << "{\"written\":" << byteCount << "}";
+	ss << "\"0x" << hex << uppercase << setw(4) << setfill('0') << value << "\"";
 	resp.success = true;
 	resp.data = ss.str();
 	return resp;
 }
 
-SocketResponse SocketServer::HandleSaveState(Emulator* emu, const SocketCommand& cmd) {
+SocketResponse SocketServer::HandleWrite(Emulator* emu, const SocketCommand& cmd) {
 	SocketResponse resp;
 
-	if(!emu || !emu->IsRunning()) {
+	auto addrIt = cmd.params.find("addr");
+	auto valIt = cmd.params.find("value");
+	if (valIt == cmd.params.end()) {
+		valIt = cmd.params.find("val");
+	}
+
+	if (addrIt == cmd.params.end() || valIt == cmd.params.end()) {
 		resp.success = false;
-		resp.error = "No ROM loaded";
-		resp.errorCode = SocketErrorCode::EmulatorNotRunning;
-		{
-			auto lock = _saveLoadStatusLock.AcquireSafe();
-			_lastSaveResult.valid = true;
-			_lastSaveResult.success = false;
-			_lastSaveResult.path.clear();
-			_lastSaveResult.error = resp.error;
-			_lastSaveResult.frame = 0;
-			_lastSaveResult.timestampMs = NowMs();
-		}
+		resp.error = "Missing addr or value parameter";
 		return resp;
 	}
 
-	auto slotIt = cmd.params.find("slot");
-	auto pathIt = cmd.params.find("path");
-	auto labelIt = cmd.params.find("label");
-	auto pauseIt = cmd.params.find("pause");
-	auto allowExternalIt = cmd.params.find("allow_external");
-	if(allowExternalIt == cmd.params.end()) {
-		allowExternalIt = cmd.params.find("allowExternal");
+	uint32_t addr = 0;
+	string addrStr = addrIt->second;
+	if (addrStr.substr(0, 2) == "0x" || addrStr.substr(0, 2) == "0X") {
+		addr = std::stoul(addrStr.substr(2), nullptr, 16);
+	} else {
+		addr = std::stoul(addrStr, nullptr, 16);
 	}
 
-	bool pause = false;
-	if (pauseIt != cmd.params.end()) {
-		pause = ParseBoolValue(pauseIt->second);
-	}
-
-	bool allowExternal = false;
-	if (allowExternalIt != cmd.params.end()) {
-		allowExternal = ParseBoolValue(allowExternalIt->second);
+	uint8_t value = 0;
+	string valStr = valIt->second;
+	if (valStr.substr(0, 2) == "0x" || valStr.substr(0, 2) == "0X") {
+		value = std::stoul(valStr.substr(2), nullptr, 16);
+	} else {
+		value = std::stoul(valStr);
 	}
 
-	string statePath;
-	string errorMessage;
-
-	auto saveLoadLock = _saveLoadLock.AcquireSafe();
-	bool wasPaused = emu->IsPaused();
-	if(pause && !wasPaused) {
-		emu->Pause();
+	auto dbg = emu->GetDebugger(true);
+	if (!dbg.GetDebugger()) {
+		resp.success = false;
+		resp.error = "Debugger not available";
+		return resp;
 	}
 
-	if (slotIt != cmd.params.end()) {
-		int slot = 0;
-		if(!TryParseInt(slotIt->second, slot) || slot <= 0) {
-			resp.success = false;
-			resp.error = "Invalid slot value";
-			resp.errorCode = SocketErrorCode::InvalidParameter;
-			errorMessage = resp.error;
-		}
-		else {
-			statePath = emu->GetSaveStateManager()->GetStateFilepath(slot);
-			bool saved = emu->GetSaveStateManager()->SaveState(statePath, false);
-			resp.success = saved;
-			if(saved) {
-				resp.data = "\"OK\"";
-				YazeStateBridge::NotifyStateSaved(statePath, emu->GetFrameCount());
-				if(labelIt != cmd.params.end()) {
-					SaveStateManager::SetStateLabel(statePath, labelIt->second);
-				}
-			} else {
-				resp.error = "Failed to save state to slot";
-				resp.errorCode = SocketErrorCode::InternalError;
-				errorMessage = resp.error;
-			}
-		}
-	} else if (pathIt != cmd.params.end()) {
-		string resolvedPath;
-		string validationError;
-		if(!ResolveSaveStatePath(pathIt->second, allowExternal, resolvedPath, validationError)) {
+	MemoryType memType = MemoryType::SnesMemory;
+	auto memtypeIt = cmd.params.find("memtype");
+	if (memtypeIt != cmd.params.end()) {
+		if(!TryParseMemoryType(memtypeIt->second, memType)) {
 			resp.success = false;
-			resp.error = validationError;
-			resp.errorCode = SocketErrorCode::PermissionDenied;
-			errorMessage = resp.error;
-		} else {
-			statePath = resolvedPath;
-			bool saved = emu->GetSaveStateManager()->SaveState(statePath, false);
-			resp.success = saved;
-			if(saved) {
-				resp.data = "\"OK\"";
-				YazeStateBridge::NotifyStateSaved(statePath, emu->GetFrameCount());
-				if(labelIt != cmd.params.end()) {
-					SaveStateManager::SetStateLabel(statePath, labelIt->second);
-				}
-			} else {
-				resp.error = "Failed to save state to file";
-				resp.errorCode = SocketErrorCode::InternalError;
-				errorMessage = resp.error;
-			}
+			resp.error = "Unknown memtype: " + memtypeIt->second;
+			return resp;
 		}
-	} else {
-		resp.success = false;
-		resp.error = "Missing slot or path parameter";
-		resp.errorCode = SocketErrorCode::MissingParameter;
-		errorMessage = resp.error;
 	}
 
-	if(pause && !wasPaused) {
-		emu->Resume();
+	auto dumper = dbg.GetDebugger()->GetMemoryDumper();
+	uint32_t memSize = dumper->GetMemorySize(memType);
+	if(memSize == 0) {
+		resp.success = false;
+		resp.error = "Memory type not available or empty";
+		return resp;
 	}
-
-	{
-		auto lock = _saveLoadStatusLock.AcquireSafe();
-		_lastSaveResult.valid = true;
-		_lastSaveResult.success = resp.success;
-		_lastSaveResult.path = statePath;
-		_lastSaveResult.error = errorMessage;
-		_lastSaveResult.frame = emu->GetFrameCount();
-		_lastSaveResult.timestampMs = NowMs();
+	if(addr >= memSize) {
+		resp.success = false;
+		resp.error = "Address out of range";
+		return resp;
 	}
 
+	dumper->SetMemoryValue(memType, addr, value, false);
+
+	resp.success = true;
+	resp.data = "\"OK\"";
 	return resp;
 }
 
-SocketResponse SocketServer::HandleLoadState(Emulator* emu, const SocketCommand& cmd) {
+SocketResponse SocketServer::HandleWrite16(Emulator* emu, const SocketCommand& cmd) {
 	SocketResponse resp;
 
-	if(!emu || !emu->IsRunning()) {
-		resp.success = false;
-		resp.error = "No ROM loaded";
-		resp.errorCode = SocketErrorCode::EmulatorNotRunning;
-		{
-			auto lock = _saveLoadStatusLock.AcquireSafe();
-			_lastLoadResult.valid = true;
-			_lastLoadResult.success = false;
-			_lastLoadResult.path.clear();
-			_lastLoadResult.error = resp.error;
-			_lastLoadResult.frame = 0;
-			_lastLoadResult.timestampMs = NowMs();
-		}
-		return resp;
+	auto addrIt = cmd.params.find("addr");
+	auto valIt = cmd.params.find("value");
+	if (valIt == cmd.params.end()) {
+		valIt = cmd.params.find("val");
 	}
 
-	auto slotIt = cmd.params.find("slot");
-	auto pathIt = cmd.params.find("path");
-	auto pauseIt = cmd.params.find("pause");
-	auto allowExternalIt = cmd.params.find("allow_external");
-	if(allowExternalIt == cmd.params.end()) {
-		allowExternalIt = cmd.params.find("allowExternal");
+	if (addrIt == cmd.params.end() || valIt == cmd.params.end()) {
+		resp.success = false;
+		resp.error = "Missing addr or value parameter";
+		return resp;
 	}
 
-	bool pause = false;
-	if (pauseIt != cmd.params.end()) {
-		pause = ParseBoolValue(pauseIt->second);
+	uint32_t addr = 0;
+	string addrStr = addrIt->second;
+	if (addrStr.substr(0, 2) == "0x" || addrStr.substr(0, 2) == "0X") {
+		addr = std::stoul(addrStr.substr(2), nullptr, 16);
+	} else {
+		addr = std::stoul(addrStr, nullptr, 16);
 	}
 
-	bool allowExternal = false;
-	if (allowExternalIt != cmd.params.end()) {
-		allowExternal = ParseBoolValue(allowExternalIt->second);
+	uint16_t value = 0;
+	string valStr = valIt->second;
+	if (valStr.substr(0, 2) == "0x" || valStr.substr(0, 2) == "0X") {
+		value = std::stoul(valStr.substr(2), nullptr, 16);
+	} else {
+		value = std::stoul(valStr);
 	}
 
-	string statePath;
-	string errorMessage;
-
-	auto saveLoadLock = _saveLoadLock.AcquireSafe();
-	bool wasPaused = emu->IsPaused();
-	if(pause && !wasPaused) {
-		emu->Pause();
+	auto dbg = emu->GetDebugger(true);
+	if (!dbg.GetDebugger()) {
+		resp.success = false;
+		resp.error = "Debugger not available";
+		return resp;
 	}
 
-	if (slotIt != cmd.params.end()) {
-		int slot = 0;
-		if(!TryParseInt(slotIt->second, slot) || slot <= 0) {
-			resp.success = false;
-			resp.error = "Invalid slot value";
-			resp.errorCode = SocketErrorCode::InvalidParameter;
-			errorMessage = resp.error;
-		} else {
-			statePath = emu->GetSaveStateManager()->GetStateFilepath(slot);
-			bool success = emu->GetSaveStateManager()->LoadState(slot);
-			resp.success = success;
-			resp.data = success ? "\"OK\"" : "";
-			if (!success) {
-				resp.error = "Failed to load state from slot";
-				resp.errorCode = SocketErrorCode::InvalidState;
-				errorMessage = resp.error;
-			}
-		}
-	} else if (pathIt != cmd.params.end()) {
-		string resolvedPath;
-		string validationError;
-		if(!ResolveSaveStatePath(pathIt->second, allowExternal, resolvedPath, validationError)) {
+	auto dumper = dbg.GetDebugger()->GetMemoryDumper();
+	MemoryType memType = MemoryType::SnesMemory;
+	auto memtypeIt = cmd.params.find("memtype");
+	if (memtypeIt != cmd.params.end()) {
+		if(!TryParseMemoryType(memtypeIt->second, memType)) {
 			resp.success = false;
-			resp.error = validationError;
-			resp.errorCode = SocketErrorCode::PermissionDenied;
-			errorMessage = resp.error;
-		} else {
-			statePath = resolvedPath;
-			bool success = emu->GetSaveStateManager()->LoadState(statePath);
-			resp.success = success;
-			resp.data = success ? "\"OK\"" : "";
-			if (!success) {
-				resp.error = "Failed to load state from file";
-				resp.errorCode = SocketErrorCode::InvalidState;
-				errorMessage = resp.error;
-			}
+			resp.error = "Unknown memtype: " + memtypeIt->second;
+			return resp;
 		}
-	} else {
-		resp.success = false;
-		resp.error = "Missing slot or path parameter";
-		resp.errorCode = SocketErrorCode::MissingParameter;
-		errorMessage = resp.error;
 	}
 
-	if(pause && !wasPaused) {
-		emu->Resume();
+	uint32_t memSize = dumper->GetMemorySize(memType);
+	if(memSize == 0) {
+		resp.success = false;
+		resp.error = "Memory type not available or empty";
+		return resp;
 	}
-
-	{
-		auto lock = _saveLoadStatusLock.AcquireSafe();
-		_lastLoadResult.valid = true;
-		_lastLoadResult.success = resp.success;
-		_lastLoadResult.path = statePath;
-		_lastLoadResult.error = errorMessage;
-		_lastLoadResult.frame = emu->GetFrameCount();
-		_lastLoadResult.timestampMs = NowMs();
+	if(addr >= memSize || addr + 1 >= memSize) {
+		resp.success = false;
+		resp.error = "Address out of range";
+		return resp;
 	}
 
+	dumper->SetMemoryValue(memType, addr, value & 0xFF, false);
+	dumper->SetMemoryValue(memType, addr + 1, (value >> 8) & 0xFF, false);
+
+	resp.success = true;
+	resp.data = "\"OK\"";
 	return resp;
 }
 
-SocketResponse SocketServer::HandleSaveStateLabel(Emulator* emu, const SocketCommand& cmd) {
+SocketResponse SocketServer::HandleReadBlock(Emulator* emu, const SocketCommand& cmd) {
 	SocketResponse resp;
 
-	string action = cmd.GetParam("action", "get");
-	action = NormalizeKey(action);
-	if(action.empty()) {
-		action = "get";
+	auto addrIt = cmd.params.find("addr");
+	auto lenIt = cmd.params.find("len");
+	if (lenIt == cmd.params.end()) {
+		lenIt = cmd.params.find("length");
 	}
 
-	auto slotIt = cmd.params.find("slot");
-	auto pathIt = cmd.params.find("path");
+	if (addrIt == cmd.params.end() || lenIt == cmd.params.end()) {
+		resp.success = false;
+		resp.error = "Missing addr or len parameter";
+		return resp;
+	}
 
-	string statePath;
-	int slotValue = 0;
-	bool hasSlot = slotIt != cmd.params.end();
-
-	if(hasSlot) {
-		if(!emu || !emu->IsRunning()) {
-			resp.success = false;
-			resp.error = "No ROM loaded";
-			resp.errorCode = SocketErrorCode::EmulatorNotRunning;
-			return resp;
-		}
-
-		if(!TryParseInt(slotIt->second, slotValue) || slotValue <= 0) {
-			resp.success = false;
-			resp.error = "Invalid slot value";
-			resp.errorCode = SocketErrorCode::InvalidParameter;
-			return resp;
-		}
-		statePath = emu->GetSaveStateManager()->GetStateFilepath(slotValue);
-	} else if(pathIt != cmd.params.end()) {
-		statePath = pathIt->second;
+	uint32_t addr = 0;
+	string addrStr = addrIt->second;
+	if (addrStr.substr(0, 2) == "0x" || addrStr.substr(0, 2) == "0X") {
+		addr = std::stoul(addrStr.substr(2), nullptr, 16);
 	} else {
-		resp.success = false;
-		resp.error = "Missing slot or path parameter";
-		resp.errorCode = SocketErrorCode::MissingParameter;
-		return resp;
+		addr = std::stoul(addrStr, nullptr, 16);
 	}
 
-	if(action == "get") {
-		string label = SaveStateManager::GetStateLabel(statePath);
-		stringstream ss;
-		ss << "{";
-		if(hasSlot) {
-			ss << "\"slot\":" << slotValue << ",";
-		}
-		ss << "\"path\":\"" << JsonEscape(statePath) << "\",";
-		if(label.empty()) {
-			ss << "\"label\":null";
-		} else {
-			ss << "\"label\":\"" << JsonEscape(label) << "\"";
-		}
-		ss << "}";
+	uint32_t len = std::stoul(lenIt->second);
+	if (len > 0x10000) len = 0x10000; // Limit to 64KB
 
-		resp.success = true;
-		resp.data = ss.str();
+	auto dbg = emu->GetDebugger(true);
+	if (!dbg.GetDebugger()) {
+		resp.success = false;
+		resp.error = "Debugger not available";
 		return resp;
 	}
 
-	if(action == "set") {
-		auto labelIt = cmd.params.find("label");
-		if(labelIt == cmd.params.end()) {
-			resp.success = false;
-			resp.error = "Missing label parameter";
-			resp.errorCode = SocketErrorCode::MissingParameter;
-			return resp;
-		}
-
-		if(!SaveStateManager::SetStateLabel(statePath, labelIt->second)) {
+	MemoryType memType = MemoryType::SnesMemory;
+	auto memtypeIt = cmd.params.find("memtype");
+	if (memtypeIt != cmd.params.end()) {
+		if(!TryParseMemoryType(memtypeIt->second, memType)) {
 			resp.success = false;
-			resp.error = "Failed to write label";
-			resp.errorCode = SocketErrorCode::InternalError;
+			resp.error = "Unknown memtype: " + memtypeIt->second;
 			return resp;
 		}
+	}
 
-		resp.success = true;
-		resp.data = "\"OK\"";
+	auto dumper = dbg.GetDebugger()->GetMemoryDumper();
+	uint32_t memSize = dumper->GetMemorySize(memType);
+	if(memSize == 0) {
+		resp.success = false;
+		resp.error = "Memory type not available or empty";
 		return resp;
 	}
-
-	if(action == "clear") {
-		if(!SaveStateManager::ClearStateLabel(statePath)) {
-			resp.success = false;
-			resp.error = "Failed to clear label";
-			resp.errorCode = SocketErrorCode::InternalError;
-			return resp;
-		}
-
-		resp.success = true;
-		resp.data = "\"OK\"";
+	if(addr >= memSize) {
+		resp.success = false;
+		resp.error = "Address out of range";
 		return resp;
 	}
+	if(addr + len > memSize) {
+		len = memSize - addr;
+	}
 
-	resp.success = false;
-	resp.error = "Invalid action: " + action;
-	resp.errorCode = SocketErrorCode::InvalidParameter;
+	stringstream ss;
+	ss << "\"";
+	for (uint32_t i = 0; i < len; i++) {
+		uint8_t val = dumper->GetMemoryValue(memType, addr + i);
+		ss << hex << uppercase << setw(2) << setfill('0') << (int)val;
+	}
+	ss << "\"";
+
+	resp.success = true;
+	resp.data = ss.str();
 	return resp;
 }
 
-SocketResponse SocketServer::HandleLoadScript(Emulator* emu, const SocketCommand& cmd) {
+SocketResponse SocketServer::HandleWriteBlock(Emulator* emu, const SocketCommand& cmd) {
 	SocketResponse resp;
 
-	auto nameIt = cmd.params.find("name");
-	auto pathIt = cmd.params.find("path");
-	auto contentIt = cmd.params.find("content");
-
-	string name = nameIt != cmd.params.end() ? nameIt->second : "cli_script";
-	string path = pathIt != cmd.params.end() ? pathIt->second : "";
-	string content = contentIt != cmd.params.end() ? contentIt->second : "";
-
-	if (content.empty() && path.empty()) {
-		resp.success = false;
-		resp.error = "Must provide path or content";
-		return resp;
-	}
+	auto addrIt = cmd.params.find("addr");
+	auto hexIt = cmd.params.find("hex");
 
-	auto dbg = emu->GetDebugger(true);
-	if (!dbg.GetDebugger()) {
+	if (addrIt == cmd.params.end() || hexIt == cmd.params.end()) {
 		resp.success = false;
-		resp.error = "Debugger not available";
+		resp.error = "Missing addr or hex parameter";
 		return resp;
 	}
 
-	int32_t scriptId = dbg.GetDebugger()->GetScriptManager()->LoadScript(name, path, content, -1);
-
-	resp.success = scriptId >= 0;
-	if (resp.success) {
-		resp.data = std::to_string(scriptId);
+	uint32_t addr = 0;
+	string addrStr = addrIt->second;
+	if (addrStr.substr(0, 2) == "0x" || addrStr.substr(0, 2) == "0X") {
+		addr = std::stoul(addrStr.substr(2), nullptr, 16);
 	} else {
-		resp.error = "Failed to load script";
+		addr = std::stoul(addrStr, nullptr, 16);
 	}
 
-	return resp;
-}
-
-SocketResponse SocketServer::HandleExecLua(Emulator* emu, const SocketCommand& cmd) {
-	SocketResponse resp;
-
-	auto codeIt = cmd.params.find("code");
-	if (codeIt == cmd.params.end()) {
-		// Legacy scripts might use "content" or no key if it was the only param
-		codeIt = cmd.params.find("content");
+	string hexStr = hexIt->second;
+	string cleaned;
+	cleaned.reserve(hexStr.size());
+	for (char c : hexStr) {
+		if (std::isspace(static_cast<unsigned char>(c)) || c == ',') {
+			continue;
+		}
+		cleaned.push_back(c);
 	}
 
-	if (codeIt == cmd.params.end()) {
+	if (cleaned.empty()) {
 		resp.success = false;
-		resp.error = "Missing Lua code (base64 encoded)";
+		resp.error = "Empty hex payload";
 		return resp;
 	}
-
-	string decoded = Base64Decode(codeIt->second);
-	if (decoded.empty() && !codeIt->second.empty()) {
+	if (cleaned.size() % 2 != 0) {
 		resp.success = false;
-		resp.error = "Failed to decode base64 code";
+		resp.error = "Hex payload must have an even length";
 		return resp;
 	}
 
@@ -1785,118 +2135,606 @@ SocketResponse SocketServer::HandleExecLua(Emulator* emu, const SocketCommand& c
 		return resp;
 	}
 
-	// EXEC_LUA runs the script once and removes it, or uses a persistent "exec" slot.
-	// We use -1 to create a new script host for this execution.
-	int32_t scriptId = dbg.GetDebugger()->GetScriptManager()->LoadScript("exec_lua", "", decoded, -1);
-
-	resp.success = scriptId >= 0;
-	if (resp.success) {
-		resp.data = std::to_string(scriptId);
-	} else {
-		resp.error = "Failed to execute Lua code";
+	MemoryType memType = MemoryType::SnesMemory;
+	auto memtypeIt = cmd.params.find("memtype");
+	if (memtypeIt != cmd.params.end()) {
+		if(!TryParseMemoryType(memtypeIt->second, memType)) {
+			resp.success = false;
+			resp.error = "Unknown memtype: " + memtypeIt->second;
+			return resp;
+		}
 	}
 
-	return resp;
-}
-
-SocketResponse SocketServer::HandleScreenshot(Emulator* emu, const SocketCommand& cmd) {
-	SocketResponse resp;
-
-	if (!emu->IsRunning()) {
+	auto dumper = dbg.GetDebugger()->GetMemoryDumper();
+	uint32_t memSize = dumper->GetMemorySize(memType);
+	if(memSize == 0) {
 		resp.success = false;
-		resp.error = "No ROM loaded";
+		resp.error = "Memory type not available or empty";
 		return resp;
 	}
 
-	// Capture screenshot to PNG stream
-	std::stringstream pngStream;
-	emu->GetVideoDecoder()->TakeScreenshot(pngStream);
-
-	string pngData = pngStream.str();
-	if (pngData.empty()) {
+	uint32_t byteCount = static_cast<uint32_t>(cleaned.size() / 2);
+	if(addr >= memSize || addr + byteCount > memSize) {
 		resp.success = false;
-		resp.error = "Failed to capture screenshot";
+		resp.error = "Address out of range";
 		return resp;
 	}
 
-	// Base64 encode the PNG data
-	static const char* base64Chars =
-		"ABCDEFGHIJKLMNOPQRSTUVWXYZ"
-		"abcdefghijklmnopqrstuvwxyz"
-		"0123456789+/";
-
-	string encoded;
-	encoded.reserve(((pngData.size() + 2) / 3) * 4);
-
-	uint32_t i = 0;
-	uint8_t a3[3];
-	uint8_t a4[4];
-
-	for (char c : pngData) {
-		a3[i++] = (uint8_t)c;
-		if (i == 3) {
-			a4[0] = (a3[0] & 0xfc) >> 2;
-			a4[1] = ((a3[0] & 0x03) << 4) + ((a3[1] & 0xf0) >> 4);
-			a4[2] = ((a3[1] & 0x0f) << 2) + ((a3[2] & 0xc0) >> 6);
-			a4[3] = a3[2] & 0x3f;
-			for (int j = 0; j < 4; j++) {
-				encoded += base64Chars[a4[j]];
-			}
-			i = 0;
-		}
-	}
-
-	if (i > 0) {
-		for (uint32_t j = i; j < 3; j++) {
-			a3[j] = 0;
-		}
-		a4[0] = (a3[0] & 0xfc) >> 2;
-		a4[1] = ((a3[0] & 0x03) << 4) + ((a3[1] & 0xf0) >> 4);
-		a4[2] = ((a3[1] & 0x0f) << 2) + ((a3[2] & 0xc0) >> 6);
-		for (uint32_t j = 0; j < i + 1; j++) {
-			encoded += base64Chars[a4[j]];
-		}
-		while (i++ < 3) {
-			encoded += '=';
-		}
+	for(uint32_t i = 0; i < byteCount; i++) {
+		string byteStr = cleaned.substr(i * 2, 2);
+		uint8_t value = static_cast<uint8_t>(std::stoul(byteStr, nullptr, 16));
+		dumper->SetMemoryValue(memType, addr + i, value, false);
 	}
 
+	stringstream ss;
+	ss << "{\"written\":" << byteCount << "}";
 	resp.success = true;
-	resp.data = "\"" + encoded + "\"";
+	resp.data = ss.str();
 	return resp;
 }
 
-SocketResponse SocketServer::HandleGetCpuState(Emulator* emu, const SocketCommand& cmd) {
+SocketResponse SocketServer::HandleSaveState(Emulator* emu, const SocketCommand& cmd) {
 	SocketResponse resp;
 
-	if (!emu->IsRunning()) {
+	if(!emu || !emu->IsRunning()) {
 		resp.success = false;
 		resp.error = "No ROM loaded";
+		resp.errorCode = SocketErrorCode::EmulatorNotRunning;
+		{
+			auto lock = _saveLoadStatusLock.AcquireSafe();
+			_lastSaveResult.valid = true;
+			_lastSaveResult.success = false;
+			_lastSaveResult.path.clear();
+			_lastSaveResult.error = resp.error;
+			_lastSaveResult.frame = 0;
+			_lastSaveResult.timestampMs = NowMs();
+		}
 		return resp;
 	}
 
-	auto dbg = emu->GetDebugger(true);
-	if (!dbg.GetDebugger()) {
-		resp.success = false;
-		resp.error = "Debugger not available";
-		return resp;
+	auto slotIt = cmd.params.find("slot");
+	auto pathIt = cmd.params.find("path");
+	auto labelIt = cmd.params.find("label");
+	auto pauseIt = cmd.params.find("pause");
+	auto allowExternalIt = cmd.params.find("allow_external");
+	if(allowExternalIt == cmd.params.end()) {
+		allowExternalIt = cmd.params.find("allowExternal");
 	}
 
-	// Decide which CPU to sample (default = first/primary CPU)
-	CpuType cpuType = emu->GetCpuTypes()[0];
-	auto cpuParam = cmd.params.find("cputype");
-	if (cpuParam != cmd.params.end()) {
-		string ct = cpuParam->second;
-		std::transform(ct.begin(), ct.end(), ct.begin(), ::tolower);
-		if (ct == "spc" || ct == "apu") {
-			cpuType = CpuType::Spc;
-		} else if (ct == "snes" || ct == "cpu" || ct == "main") {
-			cpuType = emu->GetCpuTypes()[0];
-		}
-		// If requested CPU is not available, error out
-		bool found = false;
-		for (auto c : emu->GetCpuTypes()) {
-			if (c == cpuType) {
+	bool pause = false;
+	if (pauseIt != cmd.params.end()) {
+		pause = ParseBoolValue(pauseIt->second);
+	}
+
+	bool allowExternal = false;
+	if (allowExternalIt != cmd.params.end()) {
+		allowExternal = ParseBoolValue(allowExternalIt->second);
+	}
+
+	//LZ4 saves/loads faster but produces larger files that only this build can load (LOADSTATE detects the codec)
+	CompressionCodec codec = CompressionCodec::Zlib;
+	bool validCodec = true;
+	auto compressionIt = cmd.params.find("compression");
+	if (compressionIt != cmd.params.end()) {
+		string compression = compressionIt->second;
+		std::transform(compression.begin(), compression.end(), compression.begin(), [](unsigned char c) { return std::tolower(c); });
+		if (compression == "lz4" || compression == "fast") {
+			codec = CompressionCodec::Lz4;
+		} else if (compression != "zlib") {
+			validCodec = false;
+		}
+	}
+
+	string statePath;
+	string errorMessage;
+
+	auto saveLoadLock = _saveLoadLock.AcquireSafe();
+	bool wasPaused = emu->IsPaused();
+	if(pause && !wasPaused) {
+		emu->Pause();
+	}
+
+	if (!validCodec) {
+		resp.success = false;
+		resp.error = "Invalid compression value (expected zlib or lz4)";
+		resp.errorCode = SocketErrorCode::InvalidParameter;
+		errorMessage = resp.error;
+	} else if (slotIt != cmd.params.end()) {
+		int slot = 0;
+		if(!TryParseInt(slotIt->second, slot) || slot <= 0) {
+			resp.success = false;
+			resp.error = "Invalid slot value";
+			resp.errorCode = SocketErrorCode::InvalidParameter;
+			errorMessage = resp.error;
+		}
+		else {
+			statePath = emu->GetSaveStateManager()->GetStateFilepath(slot);
+			bool saved = emu->GetSaveStateManager()->SaveState(statePath, false, codec);
+			resp.success = saved;
+			if(saved) {
+				resp.data = "\"OK\"";
+				YazeStateBridge::NotifyStateSaved(statePath, emu->GetFrameCount());
+				if(labelIt != cmd.params.end()) {
+					SaveStateManager::SetStateLabel(statePath, labelIt->second);
+				}
+			} else {
+				resp.error = "Failed to save state to slot";
+				resp.errorCode = SocketErrorCode::InternalError;
+				errorMessage = resp.error;
+			}
+		}
+	} else if (pathIt != cmd.params.end()) {
+		string resolvedPath;
+		string validationError;
+		if(!ResolveSaveStatePath(pathIt->second, allowExternal, resolvedPath, validationError)) {
+			resp.success = false;
+			resp.error = validationError;
+			resp.errorCode = SocketErrorCode::PermissionDenied;
+			errorMessage = resp.error;
+		} else {
+			statePath = resolvedPath;
+			bool saved = emu->GetSaveStateManager()->SaveState(statePath, false, codec);
+			resp.success = saved;
+			if(saved) {
+				resp.data = "\"OK\"";
+				YazeStateBridge::NotifyStateSaved(statePath, emu->GetFrameCount());
+				if(labelIt != cmd.params.end()) {
+					SaveStateManager::SetStateLabel(statePath, labelIt->second);
+				}
+			} else {
+				resp.error = "Failed to save state to file";
+				resp.errorCode = SocketErrorCode::InternalError;
+				errorMessage = resp.error;
+			}
+		}
+	} else {
+		resp.success = false;
+		resp.error = "Missing slot or path parameter";
+		resp.errorCode = SocketErrorCode::MissingParameter;
+		errorMessage = resp.error;
+	}
+
+	if(pause && !wasPaused) {
+		emu->Resume();
+	}
+
+	{
+		auto lock = _saveLoadStatusLock.AcquireSafe();
+		_lastSaveResult.valid = true;
+		_lastSaveResult.success = resp.success;
+		_lastSaveResult.path = statePath;
+		_lastSaveResult.error = errorMessage;
+		_lastSaveResult.frame = emu->GetFrameCount();
+		_lastSaveResult.timestampMs = NowMs();
+	}
+
+	return resp;
+}
+
+SocketResponse SocketServer::HandleLoadState(Emulator* emu, const SocketCommand& cmd) {
+	SocketResponse resp;
+
+	if(!emu || !emu->IsRunning()) {
+		resp.success = false;
+		resp.error = "No ROM loaded";
+		resp.errorCode = SocketErrorCode::EmulatorNotRunning;
+		{
+			auto lock = _saveLoadStatusLock.AcquireSafe();
+			_lastLoadResult.valid = true;
+			_lastLoadResult.success = false;
+			_lastLoadResult.path.clear();
+			_lastLoadResult.error = resp.error;
+			_lastLoadResult.frame = 0;
+			_lastLoadResult.timestampMs = NowMs();
+		}
+		return resp;
+	}
+
+	auto slotIt = cmd.params.find("slot");
+	auto pathIt = cmd.params.find("path");
+	auto pauseIt = cmd.params.find("pause");
+	auto allowExternalIt = cmd.params.find("allow_external");
+	if(allowExternalIt == cmd.params.end()) {
+		allowExternalIt = cmd.params.find("allowExternal");
+	}
+
+	bool pause = false;
+	if (pauseIt != cmd.params.end()) {
+		pause = ParseBoolValue(pauseIt->second);
+	}
+
+	bool allowExternal = false;
+	if (allowExternalIt != cmd.params.end()) {
+		allowExternal = ParseBoolValue(allowExternalIt->second);
+	}
+
+	string statePath;
+	string errorMessage;
+
+	auto saveLoadLock = _saveLoadLock.AcquireSafe();
+	bool wasPaused = emu->IsPaused();
+	if(pause && !wasPaused) {
+		emu->Pause();
+	}
+
+	if (slotIt != cmd.params.end()) {
+		int slot = 0;
+		if(!TryParseInt(slotIt->second, slot) || slot <= 0) {
+			resp.success = false;
+			resp.error = "Invalid slot value";
+			resp.errorCode = SocketErrorCode::InvalidParameter;
+			errorMessage = resp.error;
+		} else {
+			statePath = emu->GetSaveStateManager()->GetStateFilepath(slot);
+			bool success = emu->GetSaveStateManager()->LoadState(slot);
+			resp.success = success;
+			resp.data = success ? "\"OK\"" : "";
+			if (!success) {
+				resp.error = "Failed to load state from slot";
+				resp.errorCode = SocketErrorCode::InvalidState;
+				errorMessage = resp.error;
+			}
+		}
+	} else if (pathIt != cmd.params.end()) {
+		string resolvedPath;
+		string validationError;
+		if(!ResolveSaveStatePath(pathIt->second, allowExternal, resolvedPath, validationError)) {
+			resp.success = false;
+			resp.error = validationError;
+			resp.errorCode = SocketErrorCode::PermissionDenied;
+			errorMessage = resp.error;
+		} else {
+			statePath = resolvedPath;
+			bool success = emu->GetSaveStateManager()->LoadState(statePath);
+			resp.success = success;
+			resp.data = success ? "\"OK\"" : "";
+			if (!success) {
+				resp.error = "Failed to load state from file";
+				resp.errorCode = SocketErrorCode::InvalidState;
+				errorMessage = resp.error;
+			}
+		}
+	} else {
+		resp.success = false;
+		resp.error = "Missing slot or path parameter";
+		resp.errorCode = SocketErrorCode::MissingParameter;
+		errorMessage = resp.error;
+	}
+
+	if(pause && !wasPaused) {
+		emu->Resume();
+	}
+
+	{
+		auto lock = _saveLoadStatusLock.AcquireSafe();
+		_lastLoadResult.valid = true;
+		_lastLoadResult.success = resp.success;
+		_lastLoadResult.path = statePath;
+		_lastLoadResult.error = errorMessage;
+		_lastLoadResult.frame = emu->GetFrameCount();
+		_lastLoadResult.timestampMs = NowMs();
+	}
+
+	return resp;
+}
+
+SocketResponse SocketServer::HandleSaveStateLabel(Emulator* emu, const SocketCommand& cmd) {
+	SocketResponse resp;
+
+	string action = cmd.GetParam("action", "get");
+	action = NormalizeKey(action);
+	if(action.empty()) {
+		action = "get";
+	}
+
+	auto slotIt = cmd.params.find("slot");
+	auto pathIt = cmd.params.find("path");
+
+	string statePath;
+	int slotValue = 0;
+	bool hasSlot = slotIt != cmd.params.end();
+
+	if(hasSlot) {
+		if(!emu || !emu->IsRunning()) {
+			resp.success = false;
+			resp.error = "No ROM loaded";
+			resp.errorCode = SocketErrorCode::EmulatorNotRunning;
+			return resp;
+		}
+
+		if(!TryParseInt(slotIt->second, slotValue) || slotValue <= 0) {
+			resp.success = false;
+			resp.error = "Invalid slot value";
+			resp.errorCode = SocketErrorCode::InvalidParameter;
+			return resp;
+		}
+		statePath = emu->GetSaveStateManager()->GetStateFilepath(slotValue);
+	} else if(pathIt != cmd.params.end()) {
+		statePath = pathIt->second;
+	} else {
+		resp.success = false;
+		resp.error = "Missing slot or path parameter";
+		resp.errorCode = SocketErrorCode::MissingParameter;
+		return resp;
+	}
+
+	if(action == "get") {
+		string label = SaveStateManager::GetStateLabel(statePath);
+		stringstream ss;
+		ss << "{";
+		if(hasSlot) {
+			ss << "\"slot\":" << slotValue << ",";
+		}
+		ss << "\"path\":\"" << JsonEscape(statePath) << "\",";
+		if(label.empty()) {
+			ss << "\"label\":null";
+		} else {
+			ss << "\"label\":\"" << JsonEscape(label) << "\"";
+		}
+		ss << "}";
+
+		resp.success = true;
+		resp.data = ss.str();
+		return resp;
+	}
+
+	if(action == "set") {
+		auto labelIt = cmd.params.find("label");
+		if(labelIt == cmd.params.end()) {
+			resp.success = false;
+			resp.error = "Missing label parameter";
+			resp.errorCode = SocketErrorCode::MissingParameter;
+			return resp;
+		}
+
+		if(!SaveStateManager::SetStateLabel(statePath, labelIt->second)) {
+			resp.success = false;
+			resp.error = "Failed to write label";
+			resp.errorCode = SocketErrorCode::InternalError;
+			return resp;
+		}
+
+		resp.success = true;
+		resp.data = "\"OK\"";
+		return resp;
+	}
+
+	if(action == "clear") {
+		if(!SaveStateManager::ClearStateLabel(statePath)) {
+			resp.success = false;
+			resp.error = "Failed to clear label";
+			resp.errorCode = SocketErrorCode::InternalError;
+			return resp;
+		}
+
+		resp.success = true;
+		resp.data = "\"OK\"";
+		return resp;
+	}
+
+	resp.success = false;
+	resp.error = "Invalid action: " + action;
+	resp.errorCode = SocketErrorCode::InvalidParameter;
+	return resp;
+}
+
+SocketResponse SocketServer::HandleLoadScript(Emulator* emu, const SocketCommand& cmd) {
+	SocketResponse resp;
+
+	auto nameIt = cmd.params.find("name");
+	auto pathIt = cmd.params.find("path");
+	auto contentIt = cmd.params.find("content");
+
+	string name = nameIt != cmd.params.end() ? nameIt->second : "cli_script";
+	string path = pathIt != cmd.params.end() ? pathIt->second : "";
+	string content = contentIt != cmd.params.end() ? contentIt->second : "";
+
+	if (content.empty() && path.empty()) {
+		resp.success = false;
+		resp.error = "Must provide path or content";
+		return resp;
+	}
+
+	auto dbg = emu->GetDebugger(true);
+	if (!dbg.GetDebugger()) {
+		resp.success = false;
+		resp.error = "Debugger not available";
+		return resp;
+	}
+
+	int32_t scriptId = dbg.GetDebugger()->GetScriptManager()->LoadScript(name, path, content, -1);
+
+	resp.success = scriptId >= 0;
+	if (resp.success) {
+		resp.data = std::to_string(scriptId);
+	} else {
+		resp.error = "Failed to load script";
+	}
+
+	return resp;
+}
+
+SocketResponse SocketServer::HandleExecLua(Emulator* emu, const SocketCommand& cmd) {
+	SocketResponse resp;
+
+	auto codeIt = cmd.params.find("code");
+	if (codeIt == cmd.params.end()) {
+		// Legacy scripts might use "content" or no key if it was the only param
+		codeIt = cmd.params.find("content");
+	}
+
+	if (codeIt == cmd.params.end()) {
+		resp.success = false;
+		resp.error = "Missing Lua code (base64 encoded)";
+		return resp;
+	}
+
+	string decoded = Base64Decode(codeIt->second);
+	if (decoded.empty() && !codeIt->second.empty()) {
+		resp.success = false;
+		resp.error = "Failed to decode base64 code";
+		return resp;
+	}
+
+	auto dbg = emu->GetDebugger(true);
+	if (!dbg.GetDebugger()) {
+		resp.success = false;
+		resp.error = "Debugger not available";
+		return resp;
+	}
+
+	// EXEC_LUA runs the script once and removes it, or uses a persistent "exec" slot.
+	// We use -1 to create a new script host for this execution.
+	int32_t scriptId = dbg.GetDebugger()->GetScriptManager()->LoadScript("exec_lua", "", decoded, -1);
+
+	resp.success = scriptId >= 0;
+	if (resp.success) {
+		resp.data = std::to_string(scriptId);
+	} else {
+		resp.error = "Failed to execute Lua code";
+	}
+
+	return resp;
+}
+
+SocketResponse SocketServer::HandleScreenshot(Emulator* emu, const SocketCommand& cmd) {
+	SocketResponse resp;
+
+	if (!emu->IsRunning()) {
+		resp.success = false;
+		resp.error = "No ROM loaded";
+		return resp;
+	}
+
+	// Without any option, the response stays a bare base64 PNG string
+	static const char* optionNames[] = { "format", "level", "x", "y", "width", "height", "downscale", "encoding" };
+	bool legacy = true;
+	for (const char* name : optionNames) {
+		if (cmd.HasParam(name)) {
+			legacy = false;
+		}
+	}
+
+	ScreenshotOptions options;
+	string format = NormalizeKey(cmd.GetParam("format", "png"));
+	if (format == "png") {
+		options.Format = ScreenshotFormat::Png;
+	} else if (format == "qoi") {
+		options.Format = ScreenshotFormat::Qoi;
+	} else if (format == "raw" || format == "argb") {
+		options.Format = ScreenshotFormat::Raw;
+		format = "raw";
+	} else {
+		resp.success = false;
+		resp.error = "Unknown format: " + format + ". Use png, qoi or raw.";
+		resp.errorCode = SocketErrorCode::InvalidParameter;
+		return resp;
+	}
+
+	struct IntOption {
+		const char* name;
+		uint32_t& value;
+		int minValue;
+		int maxValue;
+	};
+	IntOption intOptions[] = {
+		{ "level", options.PngLevel, 0, 10 },
+		{ "x", options.CropX, 0, 65535 },
+		{ "y", options.CropY, 0, 65535 },
+		{ "width", options.CropWidth, 1, 65535 },
+		{ "height", options.CropHeight, 1, 65535 },
+		{ "downscale", options.Downscale, 1, 8 },
+	};
+	for (IntOption& option : intOptions) {
+		if (cmd.HasParam(option.name)) {
+			int value = 0;
+			if (!TryParseInt(cmd.GetParam(option.name), value) || value < option.minValue || value > option.maxValue) {
+				resp.success = false;
+				resp.error = string("Invalid ") + option.name + " (" + std::to_string(option.minValue) + "-" + std::to_string(option.maxValue) + ")";
+				resp.errorCode = SocketErrorCode::InvalidParameter;
+				return resp;
+			}
+			option.value = (uint32_t)value;
+		}
+	}
+
+	// Raw bytes can only be returned through the binary protocol's COMMAND opcode
+	string encoding = NormalizeKey(cmd.GetParam("encoding", "base64"));
+	if (encoding != "base64" && (encoding != "binary" || !cmd.binary)) {
+		resp.success = false;
+		resp.error = encoding == "binary" ? "encoding=binary requires the binary protocol" : "Unknown encoding: " + encoding + ". Use base64 or binary.";
+		resp.errorCode = SocketErrorCode::InvalidParameter;
+		return resp;
+	}
+
+	shared_ptr<ScreenshotResult> screenshot = emu->GetVideoDecoder()->TakeScreenshot(options);
+	if (!screenshot || !screenshot->Error.empty() || screenshot->Data.empty()) {
+		resp.success = false;
+		resp.error = screenshot && !screenshot->Error.empty() ? screenshot->Error : "Failed to capture screenshot";
+		resp.errorCode = screenshot && !screenshot->Error.empty() ? SocketErrorCode::InvalidParameter : SocketErrorCode::InternalError;
+		return resp;
+	}
+
+	resp.success = true;
+	if (encoding == "binary") {
+		// u32 frame | u32 width | u32 height | u32 format | encoded image
+		string& out = resp.data;
+		out.reserve(16 + screenshot->Data.size());
+		AppendLE32(out, screenshot->FrameNumber);
+		AppendLE32(out, screenshot->Width);
+		AppendLE32(out, screenshot->Height);
+		AppendLE32(out, (uint32_t)options.Format);
+		out.append((const char*)screenshot->Data.data(), screenshot->Data.size());
+	} else if (legacy) {
+		resp.data = "\"";
+		AppendBase64(resp.data, screenshot->Data.data(), screenshot->Data.size());
+		resp.data += "\"";
+	} else {
+		string& out = resp.data;
+		out.reserve(128 + (screenshot->Data.size() + 2) / 3 * 4);
+		out += "{\"frame\":" + std::to_string(screenshot->FrameNumber);
+		out += ",\"width\":" + std::to_string(screenshot->Width);
+		out += ",\"height\":" + std::to_string(screenshot->Height);
+		out += ",\"format\":\"" + format + "\"";
+		out += ",\"size\":" + std::to_string(screenshot->Data.size());
+		out += ",\"data\":\"";
+		AppendBase64(out, screenshot->Data.data(), screenshot->Data.size());
+		out += "\"}";
+	}
+	return resp;
+}
+
+SocketResponse SocketServer::HandleGetCpuState(Emulator* emu, const SocketCommand& cmd) {
+	SocketResponse resp;
+
+	if (!emu->IsRunning()) {
+		resp.success = false;
+		resp.error = "No ROM loaded";
+		return resp;
+	}
+
+	auto dbg = emu->GetDebugger(true);
+	if (!dbg.GetDebugger()) {
+		resp.success = false;
+		resp.error = "Debugger not available";
+		return resp;
+	}
+
+	// Decide which CPU to sample (default = first/primary CPU)
+	CpuType cpuType = emu->GetCpuTypes()[0];
+	auto cpuParam = cmd.params.find("cputype");
+	if (cpuParam != cmd.params.end()) {
+		string ct = cpuParam->second;
+		std::transform(ct.begin(), ct.end(), ct.begin(), ::tolower);
+		if (ct == "spc" || ct == "apu") {
+			cpuType = CpuType::Spc;
+		} else if (ct == "snes" || ct == "cpu" || ct == "main") {
+			cpuType = emu->GetCpuTypes()[0];
+		}
+		// If requested CPU is not available, error out
+		bool found = false;
+		for (auto c : emu->GetCpuTypes()) {
+			if (c == cpuType) {
 				found = true;
 				break;
 			}
@@ -2402,6 +3240,387 @@ SocketResponse SocketServer::HandleRunFrame(Emulator* emu, const SocketCommand&
 	return resp;
 }
 
+// Feeds a scripted per-frame button sequence to one controller port during RUN_FRAMES
+// Buttons are mapped to each console's standard controller the same way as the debuggers' input overrides (INPUT)
+class HeadlessInputProvider : public IInputProvider
+{
+public:
+	vector<DebugControllerState> Frames;
+	bool Loop = false;
+	uint8_t Port = 0;
+	uint32_t FrameIndex = 0;
+
+	static bool IsSupported(BaseControlDevice* device)
+	{
+		return dynamic_cast<SnesController*>(device) || dynamic_cast<NesController*>(device) || dynamic_cast<GbController*>(device) ||
+			dynamic_cast<GbaController*>(device) || dynamic_cast<PceController*>(device) || dynamic_cast<SmsController*>(device);
+	}
+
+	// Replaces the device's state, returns false if the device is not a standard controller of any console
+	static bool ApplyState(BaseControlDevice* device, const DebugControllerState& state)
+	{
+		if (!IsSupported(device)) {
+			return false;
+		}
+
+		device->ClearState();
+		if (SnesController* snes = dynamic_cast<SnesController*>(device)) {
+			snes->SetBitValue(SnesController::Buttons::A, state.A);
+			snes->SetBitValue(SnesController::Buttons::B, state.B);
+			snes->SetBitValue(SnesController::Buttons::X, state.X);
+			snes->SetBitValue(SnesController::Buttons::Y, state.Y);
+			snes->SetBitValue(SnesController::Buttons::L, state.L);
+			snes->SetBitValue(SnesController::Buttons::R, state.R);
+			snes->SetBitValue(SnesController::Buttons::Select, state.Select);
+			snes->SetBitValue(SnesController::Buttons::Start, state.Start);
+			snes->SetBitValue(SnesController::Buttons::Up, state.Up);
+			snes->SetBitValue(SnesController::Buttons::Down, state.Down);
+			snes->SetBitValue(SnesController::Buttons::Left, state.Left);
+			snes->SetBitValue(SnesController::Buttons::Right, state.Right);
+		} else if (NesController* nes = dynamic_cast<NesController*>(device)) {
+			nes->SetBitValue(NesController::Buttons::A, state.A);
+			nes->SetBitValue(NesController::Buttons::B, state.B);
+			nes->SetBitValue(NesController::Buttons::Select, state.Select);
+			nes->SetBitValue(NesController::Buttons::Start, state.Start);
+			nes->SetBitValue(NesController::Buttons::Up, state.Up);
+			nes->SetBitValue(NesController::Buttons::Down, state.Down);
+			nes->SetBitValue(NesController::Buttons::Left, state.Left);
+			nes->SetBitValue(NesController::Buttons::Right, state.Right);
+		} else if (GbController* gb = dynamic_cast<GbController*>(device)) {
+			gb->SetBitValue(GbController::Buttons::A, state.A);
+			gb->SetBitValue(GbController::Buttons::B, state.B);
+			gb->SetBitValue(GbController::Buttons::Select, state.Select);
+			gb->SetBitValue(GbController::Buttons::Start, state.Start);
+			gb->SetBitValue(GbController::Buttons::Up, state.Up);
+			gb->SetBitValue(GbController::Buttons::Down, state.Down);
+			gb->SetBitValue(GbController::Buttons::Left, state.Left);
+			gb->SetBitValue(GbController::Buttons::Right, state.Right);
+		} else if (GbaController* gba = dynamic_cast<GbaController*>(device)) {
+			gba->SetBitValue(GbaController::Buttons::A, state.A);
+			gba->SetBitValue(GbaController::Buttons::B, state.B);
+			gba->SetBitValue(GbaController::Buttons::L, state.L);
+			gba->SetBitValue(GbaController::Buttons::R, state.R);
+			gba->SetBitValue(GbaController::Buttons::Select, state.Select);
+			gba->SetBitValue(GbaController::Buttons::Start, state.Start);
+			gba->SetBitValue(GbaController::Buttons::Up, state.Up);
+			gba->SetBitValue(GbaController::Buttons::Down, state.Down);
+			gba->SetBitValue(GbaController::Buttons::Left, state.Left);
+			gba->SetBitValue(GbaController::Buttons::Right, state.Right);
+		} else if (PceController* pce = dynamic_cast<PceController*>(device)) {
+			pce->SetBitValue(PceController::Buttons::I, state.A);
+			pce->SetBitValue(PceController::Buttons::II, state.B);
+			pce->SetBitValue(PceController::Buttons::Select, state.Select);
+			pce->SetBitValue(PceController::Buttons::Run, state.Start);
+			pce->SetBitValue(PceController::Buttons::Up, state.Up);
+			pce->SetBitValue(PceController::Buttons::Down, state.Down);
+			pce->SetBitValue(PceController::Buttons::Left, state.Left);
+			pce->SetBitValue(PceController::Buttons::Right, state.Right);
+		} else if (SmsController* sms = dynamic_cast<SmsController*>(device)) {
+			sms->SetBitValue(SmsController::Buttons::A, state.A);
+			sms->SetBitValue(SmsController::Buttons::B, state.B);
+			sms->SetBitValue(SmsController::Buttons::Pause, state.Start);
+			sms->SetBitValue(SmsController::Buttons::Up, state.Up);
+			sms->SetBitValue(SmsController::Buttons::Down, state.Down);
+			sms->SetBitValue(SmsController::Buttons::Left, state.Left);
+			sms->SetBitValue(SmsController::Buttons::Right, state.Right);
+		}
+		return true;
+	}
+
+	bool SetInput(BaseControlDevice* device) override
+	{
+		if (device->GetPort() != Port) {
+			return false;
+		}
+
+		DebugControllerState state = {};
+		if (!Frames.empty() && (Loop || FrameIndex < Frames.size())) {
+			state = Frames[FrameIndex % Frames.size()];
+		}
+
+		// Scripted input fully replaces keyboard/gamepad input for this port
+		return ApplyState(device, state);
+	}
+};
+
+static bool TryParseButton(const string& name, DebugControllerState& state)
+{
+	string key = StringUtilities::ToUpper(StringUtilities::Trim(name));
+	if (key.empty()) return true;
+	if (key == "A") state.A = true;
+	else if (key == "B") state.B = true;
+	else if (key == "X") state.X = true;
+	else if (key == "Y") state.Y = true;
+	else if (key == "L") state.L = true;
+	else if (key == "R") state.R = true;
+	else if (key == "UP") state.Up = true;
+	else if (key == "DOWN") state.Down = true;
+	else if (key == "LEFT") state.Left = true;
+	else if (key == "RIGHT") state.Right = true;
+	else if (key == "SELECT") state.Select = true;
+	else if (key == "START") state.Start = true;
+	else return false;
+	return true;
+}
+
+SocketResponse SocketServer::RunFramesOnInstances(const vector<uint32_t>& instanceIds, const SocketCommand& cmd) {
+	vector<Emulator*> instances;
+	for (uint32_t instanceId : instanceIds) {
+		instances.push_back(GetInstance(instanceId));
+	}
+
+	if (!_instancePool) {
+		_instancePool.reset(new ThreadPool());
+	}
+
+	SocketCommand instanceCmd = cmd;
+	instanceCmd.params.erase("instances");
+
+	// Every instance runs its batch on its own pool thread - instances share no emulation state
+	vector<SocketResponse> results(instances.size());
+	vector<uint32_t> framesRun(instances.size());
+	auto start = std::chrono::steady_clock::now();
+	_instancePool->ParallelFor((uint32_t)instances.size(), [&](uint32_t i) {
+		uint32_t startFrame = instances[i]->GetFrameCount();
+		try {
+			results[i] = HandleRunFrames(instances[i], instanceCmd);
+		} catch (const std::exception& e) {
+			results[i].success = false;
+			results[i].error = string("Internal error: ") + e.what();
+		}
+		framesRun[i] = instances[i]->GetFrameCount() - startFrame;
+	});
+	double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	uint64_t totalFrames = 0;
+	stringstream ss;
+	ss << "{\"instances\":[";
+	for (size_t i = 0; i < instances.size(); i++) {
+		if (i > 0) ss << ",";
+		ss << "{\"instance\":" << instanceIds[i] << ",\"success\":" << (results[i].success ? "true" : "false");
+		if (results[i].success) {
+			ss << ",\"result\":" << results[i].data;
+		} else {
+			ss << ",\"error\":\"" << JsonEscape(results[i].error) << "\"";
+		}
+		ss << "}";
+		totalFrames += framesRun[i];
+	}
+	ss << "],\"frames\":" << totalFrames;
+	ss << ",\"threads\":" << std::min<size_t>(instances.size(), _instancePool->GetConcurrency());
+	ss << ",\"elapsedMs\":" << fixed << setprecision(2) << elapsedMs;
+	ss << ",\"fps\":" << setprecision(1) << (elapsedMs > 0 ? totalFrames * 1000.0 / elapsedMs : 0);
+	ss << "}";
+
+	SocketResponse resp;
+	resp.success = true;
+	resp.data = ss.str();
+	return resp;
+}
+
+SocketResponse SocketServer::HandleRunFrames(Emulator* emu, const SocketCommand& cmd) {
+	SocketResponse resp;
+
+	// "instances":"1,2,3" (or "all") runs the same batch on several instances in parallel
+	string instancesParam = cmd.GetParam("instances");
+	if (!instancesParam.empty()) {
+		SocketServer* server = emu->GetSocketServer();
+		if (!server) {
+			resp.success = false;
+			resp.error = "instances can only be used through instance 0";
+			resp.errorCode = SocketErrorCode::InvalidParameter;
+			return resp;
+		}
+
+		vector<uint32_t> instanceIds;
+		if (NormalizeKey(instancesParam) == "all") {
+			instanceIds = server->GetInstanceIds();
+		} else {
+			for (const string& entry : StringUtilities::Split(instancesParam, ',')) {
+				int instanceId = 0;
+				if (!TryParseInt(StringUtilities::Trim(entry), instanceId) || instanceId < 0 || !server->GetInstance((uint32_t)instanceId) ||
+					std::find(instanceIds.begin(), instanceIds.end(), (uint32_t)instanceId) != instanceIds.end()) {
+					resp.success = false;
+					resp.error = "Unknown or duplicate instance: " + entry;
+					resp.errorCode = SocketErrorCode::InvalidParameter;
+					return resp;
+				}
+				instanceIds.push_back((uint32_t)instanceId);
+			}
+		}
+		return server->RunFramesOnInstances(instanceIds, cmd);
+	}
+
+	if (!emu->IsRunning()) {
+		resp.success = false;
+		resp.error = "No ROM loaded";
+		resp.errorCode = SocketErrorCode::EmulatorNotRunning;
+		return resp;
+	}
+
+	int frameCount = 0;
+	if (!TryParseInt(cmd.GetParam("frames"), frameCount) || frameCount < 1 || frameCount > 100000) {
+		resp.success = false;
+		resp.error = "frames must be 1-100000";
+		resp.errorCode = SocketErrorCode::InvalidParameter;
+		return resp;
+	}
+
+	int stride = 0;
+	int player = 0;
+	if ((cmd.params.count("stride") && (!TryParseInt(cmd.GetParam("stride"), stride) || stride < 0)) ||
+		(cmd.params.count("player") && (!TryParseInt(cmd.GetParam("player"), player) || player < 0 || player > 7))) {
+		resp.success = false;
+		resp.error = "stride must be >= 0 and player 0-7";
+		resp.errorCode = SocketErrorCode::InvalidParameter;
+		return resp;
+	}
+
+	// Input sequence: ';'-separated frames of ','-separated buttons, each optionally repeated with *N
+	HeadlessInputProvider input;
+	input.Port = (uint8_t)player;
+	input.Loop = NormalizeKey(cmd.GetParam("loop")) == "true";
+	for (const string& entry : StringUtilities::Split(cmd.GetParam("input"), ';')) {
+		string buttons = entry;
+		int repeat = 1;
+		size_t star = entry.rfind('*');
+		if (star != string::npos) {
+			buttons = entry.substr(0, star);
+			if (!TryParseInt(StringUtilities::Trim(entry.substr(star + 1)), repeat) || repeat < 1 || repeat > frameCount) {
+				resp.success = false;
+				resp.error = "Invalid repeat count in input: " + entry;
+				resp.errorCode = SocketErrorCode::InvalidParameter;
+				return resp;
+			}
+		}
+
+		DebugControllerState state = {};
+		for (const string& button : StringUtilities::Split(buttons, ',')) {
+			if (!TryParseButton(button, state)) {
+				resp.success = false;
+				resp.error = "Unknown button: " + button;
+				resp.errorCode = SocketErrorCode::InvalidParameter;
+				return resp;
+			}
+		}
+		input.Frames.insert(input.Frames.end(), repeat, state);
+		if (input.Frames.size() > (size_t)frameCount) {
+			input.Frames.resize(frameCount);
+			break;
+		}
+	}
+
+	if (cmd.params.count("input")) {
+		shared_ptr<IConsole> console = emu->GetConsole();
+		shared_ptr<BaseControlDevice> device = console ? console->GetControlManager()->GetControlDeviceByIndex((uint8_t)player) : nullptr;
+		if (!device || !HeadlessInputProvider::IsSupported(device.get())) {
+			resp.success = false;
+			resp.error = "input requires a standard controller on player " + std::to_string(player);
+			resp.errorCode = SocketErrorCode::InvalidParameter;
+			return resp;
+		}
+	}
+
+	// Memory ranges to sample: memtype:addr:len. CPU addresses in $7E0000-$7FFFFF map to WRAM.
+	struct ReadRange {
+		MemoryType type;
+		uint32_t addr;
+		uint32_t length;
+	};
+	vector<ReadRange> reads;
+	size_t sampleSize = 0;
+	for (const string& entry : StringUtilities::Split(cmd.GetParam("reads"), ',')) {
+		if (StringUtilities::Trim(entry).empty()) {
+			continue;
+		}
+		vector<string> parts = StringUtilities::Split(entry, ':');
+		ReadRange range = {};
+		int length = 0;
+		bool valid = parts.size() == 3 && TryParseMemoryType(StringUtilities::Trim(parts[0]), range.type) && TryParseInt(StringUtilities::Trim(parts[2]), length) && length > 0;
+		if (valid) {
+			try {
+				string addrStr = StringUtilities::Trim(parts[1]);
+				range.addr = (addrStr.size() > 2 && (addrStr[1] == 'x' || addrStr[1] == 'X')) ? std::stoul(addrStr.substr(2), nullptr, 16) : std::stoul(addrStr, nullptr, 16);
+			} catch (...) {
+				valid = false;
+			}
+		}
+		range.length = (uint32_t)length;
+		if (valid && range.type == MemoryType::SnesMemory && range.addr >= 0x7E0000 && range.addr + range.length <= 0x800000) {
+			range.type = MemoryType::SnesWorkRam;
+			range.addr -= 0x7E0000;
+		}
+		ConsoleMemoryInfo mem = valid ? emu->GetMemory(range.type) : ConsoleMemoryInfo {};
+		if (!valid || !mem.Memory || (uint64_t)range.addr + range.length > mem.Size) {
+			resp.success = false;
+			resp.error = "Invalid read range (memtype:addr:len with a RAM/ROM memory type): " + entry;
+			resp.errorCode = SocketErrorCode::InvalidParameter;
+			return resp;
+		}
+		reads.push_back(range);
+		sampleSize += range.length;
+	}
+
+	size_t sampleCount = reads.empty() ? 0 : (stride > 0 ? frameCount / stride + 1 : 1);
+	if (sampleSize * sampleCount > SocketBinaryMaxPayload) {
+		resp.success = false;
+		resp.error = "Requested samples exceed " + std::to_string(SocketBinaryMaxPayload) + " bytes - reduce reads or increase stride";
+		resp.errorCode = SocketErrorCode::RequestTooLarge;
+		return resp;
+	}
+
+	// Samples are copied on the emulation side and only encoded once the batch is done
+	vector<uint32_t> sampleFrames;
+	vector<uint8_t> sampleData;
+	sampleData.reserve(sampleSize * sampleCount);
+	auto takeSample = [&]() {
+		sampleFrames.push_back(emu->GetFrameCount());
+		for (const ReadRange& range : reads) {
+			uint8_t* src = (uint8_t*)emu->GetMemory(range.type).Memory + range.addr;
+			sampleData.insert(sampleData.end(), src, src + range.length);
+		}
+	};
+
+	bool render = NormalizeKey(cmd.GetParam("render", "true")) != "false";
+	uint32_t startFrame = emu->GetFrameCount();
+	auto start = std::chrono::steady_clock::now();
+
+	uint32_t framesRun = emu->RunHeadlessFrames((uint32_t)frameCount, render, &input, [&](uint32_t framesDone) {
+		input.FrameIndex = framesDone;
+		if (!reads.empty() && ((stride > 0 && framesDone % stride == 0) || framesDone == (uint32_t)frameCount)) {
+			takeSample();
+		}
+		return true;
+	});
+
+	double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	stringstream ss;
+	ss << "{\"frames\":" << framesRun;
+	ss << ",\"startFrame\":" << startFrame;
+	ss << ",\"endFrame\":" << emu->GetFrameCount();
+	ss << ",\"elapsedMs\":" << fixed << setprecision(2) << elapsedMs;
+	ss << ",\"fps\":" << setprecision(1) << (elapsedMs > 0 ? framesRun * 1000.0 / elapsedMs : 0);
+	ss << ",\"samples\":[";
+	size_t offset = 0;
+	for (size_t i = 0; i < sampleFrames.size(); i++) {
+		if (i > 0) ss << ",";
+		ss << "{\"frame\":" << sampleFrames[i] << ",\"data\":[";
+		for (size_t j = 0; j < reads.size(); j++) {
+			if (j > 0) ss << ",";
+			vector<uint8_t> chunk(sampleData.begin() + offset, sampleData.begin() + offset + reads[j].length);
+			ss << "\"" << Base64Encode(chunk) << "\"";
+			offset += reads[j].length;
+		}
+		ss << "]}";
+	}
+	ss << "]}";
+
+	resp.success = true;
+	resp.data = ss.str();
+	return resp;
+}
+
 // ============================================================================
 // Emulation Control Handlers
 // ============================================================================
@@ -3373,7 +4592,78 @@ static bool ReadRequestLine(int clientFd, std::atomic<bool>& running, string& ou
 	return false;
 }
 
+static bool ReadExact(int clientFd, std::atomic<bool>& running, uint8_t* out, size_t length, string& error)
+{
+	constexpr int kTotalTimeoutMs = 5000;
+	constexpr int kPollSliceMs = 50;
+
+	size_t received = 0;
+	auto start = std::chrono::steady_clock::now();
+	while(received < length) {
+		if(!running.load()) {
+			error = "Server shutting down";
+			return false;
+		}
+
+		ssize_t n = read(clientFd, out + received, length - received);
+		if(n > 0) {
+			received += (size_t)n;
+			continue;
+		}
+		if(n == 0) {
+			error = "Client closed connection";
+			return false;
+		}
+		if(errno == EINTR) {
+			continue;
+		}
+		if(errno != EAGAIN && errno != EWOULDBLOCK) {
+			error = "Failed to read request";
+			return false;
+		}
+
+		auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+		if(elapsed >= kTotalTimeoutMs) {
+			error = "Timeout waiting for request";
+			return false;
+		}
+
+		struct pollfd pfd;
+		pfd.fd = clientFd;
+		pfd.events = POLLIN;
+		pfd.revents = 0;
+		if(poll(&pfd, 1, std::min<int>(kPollSliceMs, kTotalTimeoutMs - static_cast<int>(elapsed))) < 0 && errno != EINTR) {
+			error = "Poll failed";
+			return false;
+		}
+	}
+	return true;
+}
+
+// Returns a pointer to memory[start..end] - the live buffer when the memory type has one,
+// otherwise a copy made through the memory dumper (e.g. for CPU address spaces)
+static const uint8_t* GetSearchMemory(MemoryDumper* dumper, MemoryType memType, uint32_t start, uint32_t end, vector<uint8_t>& scratch)
+{
+	uint32_t memSize = dumper->GetMemorySize(memType);
+	uint8_t* buffer = dumper->GetMemoryBuffer(memType);
+	if (buffer && !DebugUtilities::IsRelativeMemory(memType)) {
+		return buffer + start;
+	}
+
+	uint32_t length = end - start + 1;
+	if (length >= memSize / 2) {
+		// Block copies are much faster than per-byte reads for large ranges
+		scratch.resize(memSize);
+		dumper->GetMemoryState(memType, scratch.data());
+		return scratch.data() + start;
+	}
+	scratch.resize(length);
+	dumper->GetMemoryValues(memType, start, end, scratch.data());
+	return scratch.data();
+}
+
 SocketResponse SocketServer::HandleSearch(Emulator* emu, const SocketCommand& cmd) {
+	SocketInstanceState& state = *emu->GetSocketState();
 	SocketResponse resp;
 
 	if (!emu->IsRunning()) {
@@ -3382,13 +4672,6 @@ SocketResponse SocketServer::HandleSearch(Emulator* emu, const SocketCommand& cm
 		return resp;
 	}
 
-	auto patternIt = cmd.params.find("pattern");
-	if (patternIt == cmd.params.end()) {
-		resp.success = false;
-		resp.error = "Missing pattern parameter";
-		return resp;
-	}
-
 	auto dbg = emu->GetDebugger(true);
 	if (!dbg.GetDebugger()) {
 		resp.success = false;
@@ -3396,49 +4679,105 @@ SocketResponse SocketServer::HandleSearch(Emulator* emu, const SocketCommand& cm
 		return resp;
 	}
 
-	// Parse pattern - space-separated hex bytes (e.g., "A9 00 8D")
-	string patternStr = patternIt->second;
-	vector<uint8_t> pattern;
-
-	size_t pos = 0;
-	while (pos < patternStr.size()) {
-		// Skip whitespace
-		while (pos < patternStr.size() && (patternStr[pos] == ' ' || patternStr[pos] == ',')) {
-			pos++;
-		}
-		if (pos >= patternStr.size()) break;
-
-		// Parse hex byte
-		size_t endPos = pos;
-		while (endPos < patternStr.size() && patternStr[endPos] != ' ' && patternStr[endPos] != ',') {
-			endPos++;
-		}
+	// Mode: pattern (default), value, or changed/unchanged/increased/decreased against a snapshot
+	string mode = NormalizeKey(cmd.GetParam("mode", cmd.params.count("value") ? "value" : "pattern"));
+	bool isCompare = mode == "changed" || mode == "unchanged" || mode == "increased" || mode == "decreased";
+	if (mode != "pattern" && mode != "value" && !isCompare) {
+		resp.success = false;
+		resp.error = "Unknown mode: " + mode + ". Use pattern, value, changed, unchanged, increased or decreased.";
+		resp.errorCode = SocketErrorCode::InvalidParameter;
+		return resp;
+	}
 
-		string byteStr = patternStr.substr(pos, endPos - pos);
-		if (byteStr.size() > 0) {
-			// Remove 0x prefix if present
-			if (byteStr.substr(0, 2) == "0x" || byteStr.substr(0, 2) == "0X") {
-				byteStr = byteStr.substr(2);
-			}
-			try {
-				pattern.push_back(static_cast<uint8_t>(std::stoul(byteStr, nullptr, 16)));
-			} catch (...) {
-				// Skip invalid bytes
-			}
-		}
-		pos = endPos;
+	int width = 1;
+	if (cmd.params.count("width") && (!TryParseInt(cmd.GetParam("width"), width) || width < 1 || width > 4)) {
+		resp.success = false;
+		resp.error = "width must be 1-4 bytes";
+		resp.errorCode = SocketErrorCode::InvalidParameter;
+		return resp;
+	}
+	int align = 1;
+	if (cmd.params.count("align") && (!TryParseInt(cmd.GetParam("align"), align) || align < 1)) {
+		resp.success = false;
+		resp.error = "align must be >= 1";
+		resp.errorCode = SocketErrorCode::InvalidParameter;
+		return resp;
 	}
 
-	if (pattern.empty()) {
+	int offset = 0;
+	int limit = 100;
+	if ((cmd.params.count("offset") && (!TryParseInt(cmd.GetParam("offset"), offset) || offset < 0)) ||
+		(cmd.params.count("limit") && (!TryParseInt(cmd.GetParam("limit"), limit) || limit < 0))) {
 		resp.success = false;
-		resp.error = "Invalid pattern";
+		resp.error = "offset and limit must be non-negative integers";
+		resp.errorCode = SocketErrorCode::InvalidParameter;
 		return resp;
 	}
+	limit = std::min(limit, 10000);
 
-	// Get memory type
+	MemorySearchPattern pattern;
+	MemorySnapshot snapshot;
 	MemoryType memType = MemoryType::SnesWorkRam;
+
+	if (mode == "pattern") {
+		auto patternIt = cmd.params.find("pattern");
+		if (patternIt == cmd.params.end()) {
+			resp.success = false;
+			resp.error = "Missing pattern parameter";
+			return resp;
+		}
+		string error;
+		if (!MemorySearchPattern::Parse(patternIt->second, pattern, error)) {
+			resp.success = false;
+			resp.error = error;
+			resp.errorCode = SocketErrorCode::InvalidParameter;
+			return resp;
+		}
+	} else if (mode == "value") {
+		auto valueIt = cmd.params.find("value");
+		if (valueIt == cmd.params.end()) {
+			resp.success = false;
+			resp.error = "Missing value parameter";
+			return resp;
+		}
+		string valueStr = valueIt->second;
+		uint32_t value = 0;
+		try {
+			value = (valueStr.size() > 2 && (valueStr.substr(0, 2) == "0x" || valueStr.substr(0, 2) == "0X")) ?
+				(uint32_t)std::stoul(valueStr.substr(2), nullptr, 16) : (uint32_t)std::stoul(valueStr);
+		} catch (...) {
+			resp.success = false;
+			resp.error = "Invalid value: " + valueStr;
+			resp.errorCode = SocketErrorCode::InvalidParameter;
+			return resp;
+		}
+		if (width < 4 && value >= (1u << (width * 8))) {
+			resp.success = false;
+			resp.error = "value does not fit in " + std::to_string(width) + " byte(s)";
+			resp.errorCode = SocketErrorCode::InvalidParameter;
+			return resp;
+		}
+		pattern = MemorySearchPattern::FromValue(value, width);
+	} else {
+		string snapshotName = cmd.GetParam("snapshot");
+		if (snapshotName.empty()) {
+			resp.success = false;
+			resp.error = "Missing snapshot parameter";
+			return resp;
+		}
+		auto lock = state.snapshotLock.AcquireSafe();
+		auto it = state.snapshots.find(snapshotName);
+		if (it == state.snapshots.end()) {
+			resp.success = false;
+			resp.error = "Snapshot not found: " + snapshotName;
+			return resp;
+		}
+		snapshot = it->second;
+		memType = static_cast<MemoryType>(snapshot.memoryType);
+	}
+
 	auto memtypeIt = cmd.params.find("memtype");
-	if (memtypeIt != cmd.params.end()) {
+	if (!isCompare && memtypeIt != cmd.params.end()) {
 		if(!TryParseMemoryType(memtypeIt->second, memType)) {
 			resp.success = false;
 			resp.error = "Unknown memtype: " + memtypeIt->second;
@@ -3446,12 +4785,19 @@ SocketResponse SocketServer::HandleSearch(Emulator* emu, const SocketCommand& cm
 		}
 	}
 
-	// Get search range
-	uint32_t startAddr = 0;
-	uint32_t endAddr = 0;
-
-	auto startIt = cmd.params.find("start");
-	auto endIt = cmd.params.find("end");
+	// Restrict results to the addresses of a previous (saved) search
+	vector<uint32_t> candidates;
+	string within = cmd.GetParam("within");
+	if (!within.empty()) {
+		auto lock = state.snapshotLock.AcquireSafe();
+		auto it = state.searchResults.find(within);
+		if (it == state.searchResults.end()) {
+			resp.success = false;
+			resp.error = "Search results not found: " + within;
+			return resp;
+		}
+		candidates = it->second;
+	}
 
 	auto dumper = dbg.GetDebugger()->GetMemoryDumper();
 	uint32_t memSize = dumper->GetMemorySize(memType);
@@ -3460,69 +4806,78 @@ SocketResponse SocketServer::HandleSearch(Emulator* emu, const SocketCommand& cm
 		resp.error = "Memory type not available or empty";
 		return resp;
 	}
+	if (isCompare && memSize != snapshot.data.size()) {
+		resp.success = false;
+		resp.error = "Snapshot size mismatch";
+		return resp;
+	}
 
-	if (startIt != cmd.params.end()) {
-		string s = startIt->second;
-		if (s.substr(0, 2) == "0x" || s.substr(0, 2) == "0X") {
-			startAddr = std::stoul(s.substr(2), nullptr, 16);
-		} else {
-			startAddr = std::stoul(s);
+	// Get search range
+	uint32_t startAddr = 0;
+	uint32_t endAddr = memSize - 1;
+	try {
+		auto parseAddr = [](const string& s) {
+			return (s.size() > 2 && (s.substr(0, 2) == "0x" || s.substr(0, 2) == "0X")) ?
+				(uint32_t)std::stoul(s.substr(2), nullptr, 16) : (uint32_t)std::stoul(s);
+		};
+		if (cmd.params.count("start")) {
+			startAddr = parseAddr(cmd.GetParam("start"));
 		}
+		if (cmd.params.count("end")) {
+			endAddr = std::min(parseAddr(cmd.GetParam("end")), memSize - 1);
+		}
+	} catch (...) {
+		resp.success = false;
+		resp.error = "Invalid start/end address";
+		resp.errorCode = SocketErrorCode::InvalidParameter;
+		return resp;
 	}
 
-	if (endIt != cmd.params.end()) {
-		string s = endIt->second;
-		if (s.substr(0, 2) == "0x" || s.substr(0, 2) == "0X") {
-			endAddr = std::stoul(s.substr(2), nullptr, 16);
+	vector<uint32_t> matches;
+	if (startAddr < memSize && startAddr <= endAddr) {
+		uint32_t length = endAddr - startAddr + 1;
+		vector<uint8_t> scratch;
+		const uint8_t* data = GetSearchMemory(dumper, memType, startAddr, endAddr, scratch);
+		if (isCompare) {
+			MemorySearchCompare compare = mode == "changed" ? MemorySearchCompare::Changed :
+				mode == "unchanged" ? MemorySearchCompare::Unchanged :
+				mode == "increased" ? MemorySearchCompare::Increased : MemorySearchCompare::Decreased;
+			MemorySearch::Compare(data, snapshot.data.data() + startAddr, length, startAddr, width, align, compare, matches);
 		} else {
-			endAddr = std::stoul(s);
+			MemorySearch::FindPattern(data, length, startAddr, pattern, align, matches);
 		}
-	} else {
-		endAddr = memSize > 0 ? memSize - 1 : 0x1FFFF;
 	}
 
-	if(startAddr >= memSize) {
-		resp.success = true;
-		resp.data = "{\"matches\":[],\"count\":0}";
-		return resp;
-	}
-	if(endAddr >= memSize) {
-		endAddr = memSize - 1;
+	if (!within.empty()) {
+		MemorySearch::Intersect(matches, candidates);
 	}
 
-	uint32_t patternSize = static_cast<uint32_t>(pattern.size());
-	if(patternSize == 0 || endAddr < startAddr || endAddr + 1 < patternSize) {
-		resp.success = true;
-		resp.data = "{\"matches\":[],\"count\":0}";
-		return resp;
+	string save = cmd.GetParam("save");
+	if (!save.empty()) {
+		auto lock = state.snapshotLock.AcquireSafe();
+		state.searchResults[save] = matches;
 	}
 
-	// Search for pattern
-	vector<uint32_t> matches;
-	uint32_t maxMatches = 100; // Limit results
-
-	uint32_t lastStart = endAddr - patternSize + 1;
-	for (uint32_t addr = startAddr; addr <= lastStart && matches.size() < maxMatches; addr++) {
-		bool found = true;
-		for (size_t i = 0; i < pattern.size() && found; i++) {
-			uint8_t memValue = dumper->GetMemoryValue(memType, addr + i);
-			if (memValue != pattern[i]) {
-				found = false;
-			}
-		}
-		if (found) {
-			matches.push_back(addr);
-		}
-	}
+	// Build response (one page of the results)
+	size_t total = matches.size();
+	size_t pageStart = std::min<size_t>(offset, total);
+	size_t pageEnd = std::min<size_t>(pageStart + limit, total);
 
-	// Build response
 	stringstream ss;
 	ss << "{\"matches\":[";
-	for (size_t i = 0; i < matches.size(); i++) {
-		if (i > 0) ss << ",";
+	for (size_t i = pageStart; i < pageEnd; i++) {
+		if (i > pageStart) ss << ",";
 		ss << "\"0x" << hex << uppercase << setw(6) << setfill('0') << matches[i] << "\"";
 	}
-	ss << "],\"count\":" << std::dec << matches.size() << "}";
+	ss << "],\"count\":" << std::dec << (pageEnd - pageStart);
+	ss << ",\"total\":" << total;
+	ss << ",\"offset\":" << pageStart;
+	ss << ",\"hasMore\":" << (pageEnd < total ? "true" : "false");
+	ss << ",\"mode\":\"" << mode << "\"";
+	if (!save.empty()) {
+		ss << ",\"saved\":\"" << JsonEscape(save) << "\"";
+	}
+	ss << "}";
 
 	resp.success = true;
 	resp.data = ss.str();
@@ -3530,6 +4885,7 @@ SocketResponse SocketServer::HandleSearch(Emulator* emu, const SocketCommand& cm
 }
 
 SocketResponse SocketServer::HandleSnapshot(Emulator* emu, const SocketCommand& cmd) {
+	SocketInstanceState& state = *emu->GetSocketState();
 	SocketResponse resp;
 
 	if (!emu->IsRunning()) {
@@ -3585,8 +4941,8 @@ SocketResponse SocketServer::HandleSnapshot(Emulator* emu, const SocketCommand&
 
 	// Store snapshot
 	{
-		auto lock = _snapshotLock.AcquireSafe();
-		_snapshots[snapshot.name] = std::move(snapshot);
+		auto lock = state.snapshotLock.AcquireSafe();
+		state.snapshots[snapshot.name] = std::move(snapshot);
 	}
 
 	stringstream ss;
@@ -3598,6 +4954,7 @@ SocketResponse SocketServer::HandleSnapshot(Emulator* emu, const SocketCommand&
 }
 
 SocketResponse SocketServer::HandleDiff(Emulator* emu, const SocketCommand& cmd) {
+	SocketInstanceState& state = *emu->GetSocketState();
 	SocketResponse resp;
 
 	if (!emu->IsRunning()) {
@@ -3616,9 +4973,9 @@ SocketResponse SocketServer::HandleDiff(Emulator* emu, const SocketCommand& cmd)
 	// Find snapshot
 	MemorySnapshot snapshot;
 	{
-		auto lock = _snapshotLock.AcquireSafe();
-		auto it = _snapshots.find(snapshotIt->second);
-		if (it == _snapshots.end()) {
+		auto lock = state.snapshotLock.AcquireSafe();
+		auto it = state.snapshots.find(snapshotIt->second);
+		if (it == state.snapshots.end()) {
 			resp.success = false;
 			resp.error = "Snapshot not found: " + snapshotIt->second;
 			return resp;
@@ -3678,7 +5035,244 @@ SocketResponse SocketServer::HandleDiff(Emulator* emu, const SocketCommand& cmd)
 	return resp;
 }
 
-SocketResponse SocketServer::HandleLabels(Emulator* emu, const SocketCommand& cmd) {
+SocketResponse SocketServer::HandleLabels(Emulator* emu, const SocketCommand& cmd) {
+	SocketResponse resp;
+
+	if (!emu->IsRunning()) {
+		resp.success = false;
+		resp.error = "No ROM loaded";
+		return resp;
+	}
+
+	auto dbg = emu->GetDebugger(true);
+	if (!dbg.GetDebugger()) {
+		resp.success = false;
+		resp.error = "Debugger not available";
+		return resp;
+	}
+
+	LabelManager* labelMgr = dbg.GetDebugger()->GetLabelManager();
+	if (!labelMgr) {
+		resp.success = false;
+		resp.error = "Label manager not available";
+		return resp;
+	}
+
+	// Get action (set, get, lookup, clear)
+	string action = "get";
+	auto actionIt = cmd.params.find("action");
+	if (actionIt != cmd.params.end()) {
+		action = actionIt->second;
+	}
+
+	if (action == "set") {
+		// Set a label
+		auto addrIt = cmd.params.find("addr");
+		auto labelIt = cmd.params.find("label");
+
+		if (addrIt == cmd.params.end() || labelIt == cmd.params.end()) {
+			resp.success = false;
+			resp.error = "Missing addr or label parameter";
+			return resp;
+		}
+
+		uint32_t addr = 0;
+		string addrStr = addrIt->second;
+		if (addrStr.substr(0, 2) == "0x" || addrStr.substr(0, 2) == "0X") {
+			addr = std::stoul(addrStr.substr(2), nullptr, 16);
+		} else {
+			addr = std::stoul(addrStr, nullptr, 16);
+		}
+
+		// Get memory type
+		MemoryType memType = MemoryType::SnesWorkRam;
+		auto memtypeIt = cmd.params.find("memtype");
+		if (memtypeIt != cmd.params.end()) {
+			if(!TryParseMemoryType(memtypeIt->second, memType)) {
+				resp.success = false;
+				resp.error = "Unknown memtype: " + memtypeIt->second;
+				return resp;
+			}
+		}
+
+		// Get comment (optional)
+		string comment = "";
+		auto commentIt = cmd.params.find("comment");
+		if (commentIt != cmd.params.end()) {
+			comment = commentIt->second;
+		}
+
+		labelMgr->SetLabel(addr, memType, labelIt->second, comment);
+
+		resp.success = true;
+		resp.data = "\"OK\"";
+	}
+	else if (action == "get") {
+		// Get label at address
+		auto addrIt = cmd.params.find("addr");
+		if (addrIt == cmd.params.end()) {
+			resp.success = false;
+			resp.error = "Missing addr parameter";
+			return resp;
+		}
+
+		uint32_t addr = 0;
+		string addrStr = addrIt->second;
+		if (addrStr.substr(0, 2) == "0x" || addrStr.substr(0, 2) == "0X") {
+			addr = std::stoul(addrStr.substr(2), nullptr, 16);
+		} else {
+			addr = std::stoul(addrStr, nullptr, 16);
+		}
+
+		MemoryType memType = MemoryType::SnesWorkRam;
+		auto memtypeIt = cmd.params.find("memtype");
+		if (memtypeIt != cmd.params.end()) {
+			if(!TryParseMemoryType(memtypeIt->second, memType)) {
+				resp.success = false;
+				resp.error = "Unknown memtype: " + memtypeIt->second;
+				return resp;
+			}
+		}
+
+		AddressInfo addrInfo;
+		addrInfo.Address = addr;
+		addrInfo.Type = memType;
+
+		LabelInfo labelInfo;
+		bool hasLabel = labelMgr->GetLabelAndComment(addrInfo, labelInfo);
+
+		stringstream ss;
+		ss << "{";
+		if (hasLabel) {
+			ss << "\"label\":\"" << JsonEscape(labelInfo.Label) << "\",";
+			ss << "\"comment\":\"" << JsonEscape(labelInfo.Comment) << "\"";
+		} else {
+			ss << "\"label\":null";
+		}
+		ss << "}";
+
+		resp.success = true;
+		resp.data = ss.str();
+	}
+	else if (action == "lookup") {
+		// Lookup address by label name
+		auto labelIt = cmd.params.find("label");
+		if (labelIt == cmd.params.end()) {
+			resp.success = false;
+			resp.error = "Missing label parameter";
+			return resp;
+		}
+
+		string labelName = labelIt->second;
+		AddressInfo addrInfo = labelMgr->GetLabelAbsoluteAddress(labelName);
+
+		if (addrInfo.Address >= 0) {
+			stringstream ss;
+			ss << "{\"addr\":\"0x" << hex << uppercase << setw(6) << setfill('0') << addrInfo.Address << "\",";
+			ss << "\"memtype\":" << std::dec << static_cast<int>(addrInfo.Type) << "}";
+			resp.success = true;
+			resp.data = ss.str();
+		} else {
+			resp.success = false;
+			resp.error = "Label not found: " + labelName;
+		}
+	}
+	else if (action == "clear") {
+		labelMgr->ClearLabels();
+		resp.success = true;
+		resp.data = "\"OK\"";
+	}
+	else {
+		resp.success = false;
+		resp.error = "Unknown action: " + action;
+	}
+
+	return resp;
+}
+
+// ============================================================================
+// Breakpoint Handlers
+// ============================================================================
+
+// This struct matches the Breakpoint class memory layout for API calls
+struct BreakpointData {
+	uint32_t id;
+	CpuType cpuType;
+	MemoryType memoryType;
+	BreakpointTypeFlags type;
+	int32_t startAddr;
+	int32_t endAddr;
+	bool enabled;
+	bool markEvent;
+	bool ignoreDummyOperations;
+	char condition[1000];
+};
+static_assert(sizeof(BreakpointData) == sizeof(Breakpoint), "BreakpointData layout mismatch");
+
+static CpuType ParseCpuType(const string& cpuType) {
+	string key = NormalizeKey(cpuType);
+	if (key.empty() || key == "snes") return CpuType::Snes;
+	if (key == "spc") return CpuType::Spc;
+	if (key == "necdsp") return CpuType::NecDsp;
+	if (key == "sa1") return CpuType::Sa1;
+	if (key == "gsu") return CpuType::Gsu;
+	if (key == "cx4") return CpuType::Cx4;
+	if (key == "gameboy" || key == "gb") return CpuType::Gameboy;
+	if (key == "nes") return CpuType::Nes;
+	if (key == "pce" || key == "pcengine") return CpuType::Pce;
+	if (key == "sms") return CpuType::Sms;
+	if (key == "gba") return CpuType::Gba;
+	return CpuType::Snes;
+}
+
+void SocketServer::SyncBreakpoints(Emulator* emu) {
+	SocketInstanceState& state = *emu->GetSocketState();
+	auto dbg = emu->GetDebugger(true);
+	if (!dbg.GetDebugger()) {
+		return;
+	}
+
+	auto lock = state.breakpointLock.AcquireSafe();
+
+	// Build array of BreakpointData matching Breakpoint class layout
+	vector<BreakpointData> bpData;
+	bpData.reserve(state.breakpoints.size());
+
+	for (const auto& sbp : state.breakpoints) {
+		if (!sbp.enabled) continue;
+
+		BreakpointData bp = {};
+		bp.id = sbp.id;
+		bp.cpuType = sbp.cpuType;
+		bp.memoryType = sbp.memoryType;
+		bp.type = static_cast<BreakpointTypeFlags>(sbp.type);
+		bp.startAddr = sbp.startAddr;
+		bp.endAddr = sbp.endAddr;
+		bp.enabled = sbp.enabled;
+		bp.markEvent = false;
+		bp.ignoreDummyOperations = false;
+
+		// Copy condition string
+		if (!sbp.condition.empty()) {
+			strncpy(bp.condition, sbp.condition.c_str(), sizeof(bp.condition) - 1);
+			bp.condition[sizeof(bp.condition) - 1] = '\0';
+		} else {
+			bp.condition[0] = '\0';
+		}
+
+		bpData.push_back(bp);
+	}
+
+	// Cast and call SetBreakpoints
+	// Note: BreakpointData layout matches Breakpoint class private members
+	dbg.GetDebugger()->SetBreakpoints(
+		reinterpret_cast<Breakpoint*>(bpData.data()),
+		static_cast<uint32_t>(bpData.size())
+	);
+}
+
+SocketResponse SocketServer::HandleBreakpoint(Emulator* emu, const SocketCommand& cmd) {
+	SocketInstanceState& state = *emu->GetSocketState();
 	SocketResponse resp;
 
 	if (!emu->IsRunning()) {
@@ -3687,35 +5281,19 @@ SocketResponse SocketServer::HandleLabels(Emulator* emu, const SocketCommand& cm
 		return resp;
 	}
 
-	auto dbg = emu->GetDebugger(true);
-	if (!dbg.GetDebugger()) {
-		resp.success = false;
-		resp.error = "Debugger not available";
-		return resp;
-	}
-
-	LabelManager* labelMgr = dbg.GetDebugger()->GetLabelManager();
-	if (!labelMgr) {
-		resp.success = false;
-		resp.error = "Label manager not available";
-		return resp;
-	}
-
-	// Get action (set, get, lookup, clear)
-	string action = "get";
+	// Get action (add, remove, list, enable, disable, clear)
+	string action = "list";
 	auto actionIt = cmd.params.find("action");
 	if (actionIt != cmd.params.end()) {
 		action = actionIt->second;
 	}
 
-	if (action == "set") {
-		// Set a label
+	if (action == "add") {
+		// Add a new breakpoint
 		auto addrIt = cmd.params.find("addr");
-		auto labelIt = cmd.params.find("label");
-
-		if (addrIt == cmd.params.end() || labelIt == cmd.params.end()) {
+		if (addrIt == cmd.params.end()) {
 			resp.success = false;
-			resp.error = "Missing addr or label parameter";
+			resp.error = "Missing addr parameter";
 			return resp;
 		}
 
@@ -3727,8 +5305,52 @@ SocketResponse SocketServer::HandleLabels(Emulator* emu, const SocketCommand& cm
 			addr = std::stoul(addrStr, nullptr, 16);
 		}
 
+		// Get breakpoint type (execute, read, write, or combination)
+		// Supports: "exec", "read", "write", or shorthand like "x", "r", "w", "rw", "xrw"
+		uint8_t bpType = static_cast<uint8_t>(BreakpointTypeFlags::Execute); // Default
+		auto bptypeIt = cmd.params.find("bptype");
+		if (bptypeIt != cmd.params.end()) {
+			string typeStr = bptypeIt->second;
+			bpType = 0;
+
+			// Check for full words first (to avoid false matches from substrings)
+			bool hasExec = typeStr.find("exec") != string::npos;
+			bool hasRead = typeStr.find("read") != string::npos;
+			bool hasWrite = typeStr.find("write") != string::npos;
+
+			// If no full words found, check for shorthand characters
+			// Only use single-char matching for short strings (e.g., "x", "rw", "xrw")
+			if (!hasExec && !hasRead && !hasWrite && typeStr.length() <= 4) {
+				for (char c : typeStr) {
+					if (c == 'x') hasExec = true;
+					if (c == 'r') hasRead = true;
+					if (c == 'w') hasWrite = true;
+				}
+			}
+
+			if (hasExec) bpType |= static_cast<uint8_t>(BreakpointTypeFlags::Execute);
+			if (hasRead) bpType |= static_cast<uint8_t>(BreakpointTypeFlags::Read);
+			if (hasWrite) bpType |= static_cast<uint8_t>(BreakpointTypeFlags::Write);
+
+			if (bpType == 0) {
+				bpType = static_cast<uint8_t>(BreakpointTypeFlags::Execute);
+			}
+		}
+
+		// Get end address (optional, for address range)
+		uint32_t endAddr = addr;
+		auto endaddrIt = cmd.params.find("endaddr");
+		if (endaddrIt != cmd.params.end()) {
+			string endAddrStr = endaddrIt->second;
+			if (endAddrStr.substr(0, 2) == "0x" || endAddrStr.substr(0, 2) == "0X") {
+				endAddr = std::stoul(endAddrStr.substr(2), nullptr, 16);
+			} else {
+				endAddr = std::stoul(endAddrStr, nullptr, 16);
+			}
+		}
+
 		// Get memory type
-		MemoryType memType = MemoryType::SnesWorkRam;
+		MemoryType memType = MemoryType::SnesMemory;
 		auto memtypeIt = cmd.params.find("memtype");
 		if (memtypeIt != cmd.params.end()) {
 			if(!TryParseMemoryType(memtypeIt->second, memType)) {
@@ -3738,182 +5360,313 @@ SocketResponse SocketServer::HandleLabels(Emulator* emu, const SocketCommand& cm
 			}
 		}
 
-		// Get comment (optional)
-		string comment = "";
-		auto commentIt = cmd.params.find("comment");
-		if (commentIt != cmd.params.end()) {
-			comment = commentIt->second;
+		// Get CPU type
+		CpuType cpuType = CpuType::Snes;
+		auto cputypeIt = cmd.params.find("cputype");
+		if (cputypeIt != cmd.params.end()) {
+			cpuType = ParseCpuType(cputypeIt->second);
 		}
 
-		labelMgr->SetLabel(addr, memType, labelIt->second, comment);
+		// Get condition (optional)
+		string condition = "";
+		auto condIt = cmd.params.find("condition");
+		if (condIt != cmd.params.end()) {
+			condition = condIt->second;
+		}
+
+		// Create the breakpoint
+		auto lock = state.breakpointLock.AcquireSafe();
+		uint32_t newId = state.nextBreakpointId++;
+
+		SocketBreakpoint sbp;
+		sbp.id = newId;
+		sbp.cpuType = cpuType;
+		sbp.memoryType = memType;
+		sbp.type = bpType;
+		sbp.startAddr = static_cast<int32_t>(addr);
+		sbp.endAddr = static_cast<int32_t>(endAddr);
+		sbp.enabled = true;
+		sbp.condition = condition;
+
+		state.breakpoints.push_back(sbp);
+		lock.Release();
+
+		// Sync with emulator
+		SyncBreakpoints(emu);
 
+		stringstream ss;
+		ss << "{\"id\":" << newId << "}";
 		resp.success = true;
-		resp.data = "\"OK\"";
+		resp.data = ss.str();
 	}
-	else if (action == "get") {
-		// Get label at address
-		auto addrIt = cmd.params.find("addr");
-		if (addrIt == cmd.params.end()) {
+	else if (action == "remove") {
+		// Remove a breakpoint by ID
+		auto idIt = cmd.params.find("id");
+		if (idIt == cmd.params.end()) {
 			resp.success = false;
-			resp.error = "Missing addr parameter";
+			resp.error = "Missing id parameter";
 			return resp;
 		}
 
-		uint32_t addr = 0;
-		string addrStr = addrIt->second;
-		if (addrStr.substr(0, 2) == "0x" || addrStr.substr(0, 2) == "0X") {
-			addr = std::stoul(addrStr.substr(2), nullptr, 16);
+		uint32_t bpId = std::stoul(idIt->second);
+
+		auto lock = state.breakpointLock.AcquireSafe();
+		auto it = std::find_if(state.breakpoints.begin(), state.breakpoints.end(),
+			[bpId](const SocketBreakpoint& bp) { return bp.id == bpId; });
+
+		if (it != state.breakpoints.end()) {
+			state.breakpoints.erase(it);
+			lock.Release();
+			SyncBreakpoints(emu);
+			resp.success = true;
+			resp.data = "\"OK\"";
 		} else {
-			addr = std::stoul(addrStr, nullptr, 16);
+			resp.success = false;
+			resp.error = "Breakpoint not found: " + std::to_string(bpId);
 		}
+	}
+	else if (action == "list") {
+		// List all breakpoints
+		auto lock = state.breakpointLock.AcquireSafe();
 
-		MemoryType memType = MemoryType::SnesWorkRam;
-		auto memtypeIt = cmd.params.find("memtype");
-		if (memtypeIt != cmd.params.end()) {
-			if(!TryParseMemoryType(memtypeIt->second, memType)) {
-				resp.success = false;
-				resp.error = "Unknown memtype: " + memtypeIt->second;
-				return resp;
+		stringstream ss;
+		ss << "{\"breakpoints\":[";
+		bool first = true;
+		for (const auto& bp : state.breakpoints) {
+			if (!first) ss << ",";
+			first = false;
+
+			ss << "{\"id\":" << bp.id;
+			ss << ",\"addr\":\"0x" << hex << uppercase << setw(6) << setfill('0') << bp.startAddr << "\"";
+			if (bp.endAddr != bp.startAddr) {
+				ss << ",\"endaddr\":\"0x" << hex << uppercase << setw(6) << setfill('0') << bp.endAddr << "\"";
+			}
+			ss << std::dec;
+			ss << ",\"type\":" << static_cast<int>(bp.type);
+			ss << ",\"enabled\":" << (bp.enabled ? "true" : "false");
+			if (!bp.condition.empty()) {
+				ss << ",\"condition\":\"" << JsonEscape(bp.condition) << "\"";
+			}
+			ss << "}";
+		}
+		ss << "]}";
+
+		resp.success = true;
+		resp.data = ss.str();
+	}
+	else if (action == "enable" || action == "disable") {
+		// Enable or disable a breakpoint
+		auto idIt = cmd.params.find("id");
+		if (idIt == cmd.params.end()) {
+			resp.success = false;
+			resp.error = "Missing id parameter";
+			return resp;
+		}
+
+		uint32_t bpId = std::stoul(idIt->second);
+		bool enable = (action == "enable");
+
+		auto lock = state.breakpointLock.AcquireSafe();
+		auto it = std::find_if(state.breakpoints.begin(), state.breakpoints.end(),
+			[bpId](const SocketBreakpoint& bp) { return bp.id == bpId; });
+
+		if (it != state.breakpoints.end()) {
+			it->enabled = enable;
+			lock.Release();
+			SyncBreakpoints(emu);
+			resp.success = true;
+			resp.data = "\"OK\"";
+		} else {
+			resp.success = false;
+			resp.error = "Breakpoint not found: " + std::to_string(bpId);
+		}
+	}
+	else if (action == "clear") {
+		// Remove all breakpoints
+		auto lock = state.breakpointLock.AcquireSafe();
+		state.breakpoints.clear();
+		lock.Release();
+		SyncBreakpoints(emu);
+
+		resp.success = true;
+		resp.data = "\"OK\"";
+	}
+	else {
+		resp.success = false;
+		resp.error = "Unknown action: " + action;
+	}
+
+	return resp;
+}
+
+SocketResponse SocketServer::HandleBatch(Emulator* emu, const SocketCommand& cmd) {
+	SocketResponse resp;
+
+	// Parse commands array from params
+	auto commandsIt = cmd.params.find("commands");
+	if (commandsIt == cmd.params.end()) {
+		resp.success = false;
+		resp.error = "Missing commands parameter";
+		return resp;
+	}
+
+	// The commands value should be a JSON array string
+	// Format: [{"type":"PING"},{"type":"READ","addr":"0x7E0000"}]
+	string commandsJson = commandsIt->second;
+
+	// Parse JSON array of commands
+	vector<SocketCommand> subCommands;
+	string parseError;
+
+	// Simple JSON array parsing
+	size_t pos = 0;
+	while (pos < commandsJson.size() && commandsJson[pos] != '[') pos++;
+	if (pos >= commandsJson.size()) {
+		resp.success = false;
+		resp.error = "Invalid commands format - expected JSON array";
+		return resp;
+	}
+	pos++; // Skip '['
+
+	while (pos < commandsJson.size()) {
+		// Skip whitespace
+		while (pos < commandsJson.size() && std::isspace(commandsJson[pos])) pos++;
+
+		if (pos >= commandsJson.size() || commandsJson[pos] == ']') break;
+
+		// Find the start of an object
+		if (commandsJson[pos] != '{') {
+			if (commandsJson[pos] == ',') {
+				pos++;
+				continue;
 			}
+			break;
 		}
 
-		AddressInfo addrInfo;
-		addrInfo.Address = addr;
-		addrInfo.Type = memType;
-
-		LabelInfo labelInfo;
-		bool hasLabel = labelMgr->GetLabelAndComment(addrInfo, labelInfo);
-
-		stringstream ss;
-		ss << "{";
-		if (hasLabel) {
-			ss << "\"label\":\"" << JsonEscape(labelInfo.Label) << "\",";
-			ss << "\"comment\":\"" << JsonEscape(labelInfo.Comment) << "\"";
-		} else {
-			ss << "\"label\":null";
+		// Find matching closing brace
+		int braceCount = 1;
+		size_t start = pos;
+		pos++;
+		while (pos < commandsJson.size() && braceCount > 0) {
+			if (commandsJson[pos] == '{') braceCount++;
+			else if (commandsJson[pos] == '}') braceCount--;
+			pos++;
 		}
-		ss << "}";
 
-		resp.success = true;
-		resp.data = ss.str();
-	}
-	else if (action == "lookup") {
-		// Lookup address by label name
-		auto labelIt = cmd.params.find("label");
-		if (labelIt == cmd.params.end()) {
+		if (braceCount != 0) {
 			resp.success = false;
-			resp.error = "Missing label parameter";
+			resp.error = "Invalid commands format - unmatched braces";
 			return resp;
 		}
 
-		string labelName = labelIt->second;
-		AddressInfo addrInfo = labelMgr->GetLabelAbsoluteAddress(labelName);
+		string subJson = commandsJson.substr(start, pos - start);
 
-		if (addrInfo.Address >= 0) {
-			stringstream ss;
-			ss << "{\"addr\":\"0x" << hex << uppercase << setw(6) << setfill('0') << addrInfo.Address << "\",";
-			ss << "\"memtype\":" << std::dec << static_cast<int>(addrInfo.Type) << "}";
-			resp.success = true;
-			resp.data = ss.str();
-		} else {
+		// Parse the sub-command
+		SocketCommand subCmd;
+		string subError;
+		unordered_map<string, string> subParams;
+		if (!ParseJsonObject(subJson, subParams, subError)) {
 			resp.success = false;
-			resp.error = "Label not found: " + labelName;
+			resp.error = "Failed to parse sub-command: " + subError;
+			return resp;
 		}
-	}
-	else if (action == "clear") {
-		labelMgr->ClearLabels();
-		resp.success = true;
-		resp.data = "\"OK\"";
-	}
-	else {
-		resp.success = false;
-		resp.error = "Unknown action: " + action;
-	}
-
-	return resp;
-}
 
-// ============================================================================
-// Breakpoint Handlers
-// ============================================================================
+		auto typeIt = subParams.find("type");
+		if (typeIt == subParams.end()) {
+			resp.success = false;
+			resp.error = "Sub-command missing type field";
+			return resp;
+		}
 
-// This struct matches the Breakpoint class memory layout for API calls
-struct BreakpointData {
-	uint32_t id;
-	CpuType cpuType;
-	MemoryType memoryType;
-	BreakpointTypeFlags type;
-	int32_t startAddr;
-	int32_t endAddr;
-	bool enabled;
-	bool markEvent;
-	bool ignoreDummyOperations;
-	char condition[1000];
-};
-static_assert(sizeof(BreakpointData) == sizeof(Breakpoint), "BreakpointData layout mismatch");
+		subCmd.type = typeIt->second;
+		std::transform(subCmd.type.begin(), subCmd.type.end(), subCmd.type.begin(),
+			[](unsigned char c) { return static_cast<char>(std::toupper(c)); });
 
-static CpuType ParseCpuType(const string& cpuType) {
-	string key = NormalizeKey(cpuType);
-	if (key.empty() || key == "snes") return CpuType::Snes;
-	if (key == "spc") return CpuType::Spc;
-	if (key == "necdsp") return CpuType::NecDsp;
-	if (key == "sa1") return CpuType::Sa1;
-	if (key == "gsu") return CpuType::Gsu;
-	if (key == "cx4") return CpuType::Cx4;
-	if (key == "gameboy" || key == "gb") return CpuType::Gameboy;
-	if (key == "nes") return CpuType::Nes;
-	if (key == "pce" || key == "pcengine") return CpuType::Pce;
-	if (key == "sms") return CpuType::Sms;
-	if (key == "gba") return CpuType::Gba;
-	return CpuType::Snes;
-}
+		subParams.erase(typeIt);
+		subCmd.params = std::move(subParams);
+		subCommands.push_back(std::move(subCmd));
+	}
 
-void SocketServer::SyncBreakpoints(Emulator* emu) {
-	auto dbg = emu->GetDebugger(true);
-	if (!dbg.GetDebugger()) {
-		return;
+	if (subCommands.empty()) {
+		resp.success = false;
+		resp.error = "No commands in batch";
+		return resp;
 	}
 
-	auto lock = _breakpointLock.AcquireSafe();
+	// Execute each sub-command and collect results
+	stringstream ss;
+	ss << "{\"results\":[";
 
-	// Build array of BreakpointData matching Breakpoint class layout
-	vector<BreakpointData> bpData;
-	bpData.reserve(_breakpoints.size());
+	bool allSuccess = true;
+	for (size_t i = 0; i < subCommands.size(); i++) {
+		const SocketCommand& subCmd = subCommands[i];
 
-	for (const auto& sbp : _breakpoints) {
-		if (!sbp.enabled) continue;
+		if (i > 0) ss << ",";
 
-		BreakpointData bp = {};
-		bp.id = sbp.id;
-		bp.cpuType = sbp.cpuType;
-		bp.memoryType = sbp.memoryType;
-		bp.type = static_cast<BreakpointTypeFlags>(sbp.type);
-		bp.startAddr = sbp.startAddr;
-		bp.endAddr = sbp.endAddr;
-		bp.enabled = sbp.enabled;
-		bp.markEvent = false;
-		bp.ignoreDummyOperations = false;
+		SocketResponse subResp;
+		if (subCmd.type == "PING") subResp = HandlePing(emu, subCmd);
+		else if (subCmd.type == "STATE") subResp = HandleState(emu, subCmd);
+		else if (subCmd.type == "HEALTH") subResp = HandleHealth(emu, subCmd);
+		else if (subCmd.type == "PAUSE") subResp = HandlePause(emu, subCmd);
+		else if (subCmd.type == "RESUME") subResp = HandleResume(emu, subCmd);
+		else if (subCmd.type == "RESET") subResp = HandleReset(emu, subCmd);
+		else if (subCmd.type == "READ") subResp = HandleRead(emu, subCmd);
+		else if (subCmd.type == "READ16") subResp = HandleRead16(emu, subCmd);
+		else if (subCmd.type == "WRITE") subResp = HandleWrite(emu, subCmd);
+		else if (subCmd.type == "WRITE16") subResp = HandleWrite16(emu, subCmd);
+		else if (subCmd.type == "READBLOCK") subResp = HandleReadBlock(emu, subCmd);
+		else if (subCmd.type == "WRITEBLOCK") subResp = HandleWriteBlock(emu, subCmd);
+		else if (subCmd.type == "SAVESTATE") subResp = HandleSaveState(emu, subCmd);
+		else if (subCmd.type == "SAVESTATE_LABEL") subResp = HandleSaveStateLabel(emu, subCmd);
+		else if (subCmd.type == "LOADSTATE") subResp = HandleLoadState(emu, subCmd);
+		else if (subCmd.type == "SCREENSHOT") subResp = HandleScreenshot(emu, subCmd);
+		else if (subCmd.type == "CPU") subResp = HandleGetCpuState(emu, subCmd);
+		else if (subCmd.type == "STATEINSPECT") subResp = HandleStateInspector(emu, subCmd);
+		else if (subCmd.type == "DISASM") subResp = HandleDisasm(emu, subCmd);
+		else if (subCmd.type == "DISASM_EXPORT") subResp = HandleDisasmExport(emu, subCmd);
+		else if (subCmd.type == "STEP") subResp = HandleStep(emu, subCmd);
+		else if (subCmd.type == "FRAME") subResp = HandleRunFrame(emu, subCmd);
+		else if (subCmd.type == "ROMINFO") subResp = HandleRomInfo(emu, subCmd);
+		else if (subCmd.type == "BREAKPOINT") subResp = HandleBreakpoint(emu, subCmd);
+		else if (subCmd.type == "LABELS") subResp = HandleLabels(emu, subCmd);
+		else if (subCmd.type == "SEARCH") subResp = HandleSearch(emu, subCmd);
+		else if (subCmd.type == "SNAPSHOT") subResp = HandleSnapshot(emu, subCmd);
+		else if (subCmd.type == "DIFF") subResp = HandleDiff(emu, subCmd);
+		else if (subCmd.type == "TRACE") subResp = HandleTrace(emu, subCmd);
+		else if (subCmd.type == "TRACE_QUERY") subResp = HandleTraceQuery(emu, subCmd);
+		else if (subCmd.type == "PROFILER") subResp = HandleProfiler(emu, subCmd);
+		else if (subCmd.type == "LOGPOINT") subResp = HandleLogpoint(emu, subCmd);
+		else if (subCmd.type == "SUBSCRIBE") subResp = HandleSubscribe(emu, subCmd);
+		else if (subCmd.type == "DEBUG_LOG") subResp = HandleDebugLog(emu, subCmd);
+		else {
+			subResp.success = false;
+			subResp.error = "Unknown command or not allowed in BATCH: " + subCmd.type;
+		}
 
-		// Copy condition string
-		if (!sbp.condition.empty()) {
-			strncpy(bp.condition, sbp.condition.c_str(), sizeof(bp.condition) - 1);
-			bp.condition[sizeof(bp.condition) - 1] = '\0';
-		} else {
-			bp.condition[0] = '\0';
+		if (!subResp.success) {
+			allSuccess = false;
 		}
 
-		bpData.push_back(bp);
+		// Add result to output
+		ss << "{\"type\":\"" << subCmd.type << "\",";
+		ss << "\"success\":" << (subResp.success ? "true" : "false");
+		if (!subResp.data.empty()) {
+			ss << ",\"data\":" << subResp.data;
+		}
+		if (!subResp.error.empty()) {
+			ss << ",\"error\":\"" << JsonEscape(subResp.error) << "\"";
+		}
+		ss << "}";
 	}
 
-	// Cast and call SetBreakpoints
-	// Note: BreakpointData layout matches Breakpoint class private members
-	dbg.GetDebugger()->SetBreakpoints(
-		reinterpret_cast<Breakpoint*>(bpData.data()),
-		static_cast<uint32_t>(bpData.size())
-	);
+	ss << "]}";
+
+	resp.success = allSuccess;
+	resp.data = ss.str();
+	return resp;
 }
 
-SocketResponse SocketServer::HandleBreakpoint(Emulator* emu, const SocketCommand& cmd) {
+SocketResponse SocketServer::HandleTrace(Emulator* emu, const SocketCommand& cmd) {
 	SocketResponse resp;
 
 	if (!emu->IsRunning()) {
@@ -3922,394 +5675,489 @@ SocketResponse SocketServer::HandleBreakpoint(Emulator* emu, const SocketCommand
 		return resp;
 	}
 
-	// Get action (add, remove, list, enable, disable, clear)
-	string action = "list";
+	auto dbg = emu->GetDebugger(true);
+	Debugger* debugger = dbg.GetDebugger();
+	if (!debugger) {
+		resp.success = false;
+		resp.error = "Debugger not available";
+		return resp;
+	}
+
+	string action;
 	auto actionIt = cmd.params.find("action");
 	if (actionIt != cmd.params.end()) {
 		action = actionIt->second;
+		std::transform(action.begin(), action.end(), action.begin(),
+			[](unsigned char c) { return static_cast<char>(std::tolower(c)); });
 	}
 
-	if (action == "add") {
-		// Add a new breakpoint
-		auto addrIt = cmd.params.find("addr");
-		if (addrIt == cmd.params.end()) {
-			resp.success = false;
-			resp.error = "Missing addr parameter";
+	// "read" returns rows from a binary trace log file, using the same output as the live trace below
+	if (!action.empty() && action != "read") {
+		if (action == "clear") {
+			debugger->ClearExecutionTrace();
+			resp.success = true;
+			resp.data = "\"OK\"";
+			return resp;
+		}
+
+		if (action == "status") {
+			bool enabled = false;
+			for (CpuType cpuType : emu->GetCpuTypes()) {
+				ITraceLogger* logger = debugger->GetTraceLogger(cpuType);
+				if (logger && logger->IsEnabled()) {
+					enabled = true;
+					break;
+				}
+			}
+
+			TraceLogFileSaver* fileSaver = debugger->GetTraceLogFileSaver();
+			stringstream ss;
+			ss << "{\"enabled\":" << (enabled ? "true" : "false");
+			ss << ",\"fileLogging\":" << (fileSaver->IsEnabled() ? "true" : "false");
+			ss << ",\"binary\":" << (fileSaver->IsEnabled() && fileSaver->IsBinary() ? "true" : "false") << "}";
+			resp.success = true;
+			resp.data = ss.str();
+			return resp;
+		}
+
+		if (action == "file_start" || action == "file_stop" || action == "convert") {
+			auto pathIt = cmd.params.find("path");
+			if (action != "file_stop" && (pathIt == cmd.params.end() || pathIt->second.empty())) {
+				resp.success = false;
+				resp.error = "Missing path parameter";
+				resp.errorCode = SocketErrorCode::MissingParameter;
+				return resp;
+			}
+
+			if (action == "file_start") {
+				// Binary logs store the raw CPU state and are only formatted by "read"/"convert"
+				auto binaryIt = cmd.params.find("binary");
+				bool binary = binaryIt == cmd.params.end() || ParseBoolValue(binaryIt->second);
+				if (!debugger->StartTraceLogFile(pathIt->second, binary)) {
+					resp.success = false;
+					resp.error = "Could not open file: " + pathIt->second;
+					resp.errorCode = SocketErrorCode::InvalidParameter;
+					return resp;
+				}
+				stringstream ss;
+				ss << "{\"path\":\"" << JsonEscape(pathIt->second) << "\",\"binary\":" << (binary ? "true" : "false") << "}";
+				resp.success = true;
+				resp.data = ss.str();
+				return resp;
+			}
+
+			if (action == "file_stop") {
+				debugger->StopTraceLogFile();
+				resp.success = true;
+				resp.data = "\"OK\"";
+				return resp;
+			}
+
+			auto outputIt = cmd.params.find("output");
+			string output = outputIt != cmd.params.end() ? outputIt->second : pathIt->second + ".txt";
+			int64_t rowCount = debugger->ConvertBinaryTraceLog(pathIt->second, output);
+			if (rowCount < 0) {
+				resp.success = false;
+				resp.error = "Could not convert binary trace log: " + pathIt->second;
+				resp.errorCode = SocketErrorCode::InvalidParameter;
+				return resp;
+			}
+			stringstream ss;
+			ss << "{\"output\":\"" << JsonEscape(output) << "\",\"rows\":" << rowCount << "}";
+			resp.success = true;
+			resp.data = ss.str();
 			return resp;
 		}
 
-		uint32_t addr = 0;
-		string addrStr = addrIt->second;
-		if (addrStr.substr(0, 2) == "0x" || addrStr.substr(0, 2) == "0X") {
-			addr = std::stoul(addrStr.substr(2), nullptr, 16);
-		} else {
-			addr = std::stoul(addrStr, nullptr, 16);
-		}
+		if (action == "start" || action == "stop") {
+			bool enable = action == "start";
+			TraceLoggerOptions options = {};
+			options.Enabled = enable;
+			options.IndentCode = false;
+			options.UseLabels = true;
 
-		// Get breakpoint type (execute, read, write, or combination)
-		// Supports: "exec", "read", "write", or shorthand like "x", "r", "w", "rw", "xrw"
-		uint8_t bpType = static_cast<uint8_t>(BreakpointTypeFlags::Execute); // Default
-		auto bptypeIt = cmd.params.find("bptype");
-		if (bptypeIt != cmd.params.end()) {
-			string typeStr = bptypeIt->second;
-			bpType = 0;
+			string format = "[Disassembly]";
+			string condition;
 
-			// Check for full words first (to avoid false matches from substrings)
-			bool hasExec = typeStr.find("exec") != string::npos;
-			bool hasRead = typeStr.find("read") != string::npos;
-			bool hasWrite = typeStr.find("write") != string::npos;
+			auto formatIt = cmd.params.find("format");
+			if (formatIt != cmd.params.end()) {
+				format = formatIt->second;
+			}
 
-			// If no full words found, check for shorthand characters
-			// Only use single-char matching for short strings (e.g., "x", "rw", "xrw")
-			if (!hasExec && !hasRead && !hasWrite && typeStr.length() <= 4) {
-				for (char c : typeStr) {
-					if (c == 'x') hasExec = true;
-					if (c == 'r') hasRead = true;
-					if (c == 'w') hasWrite = true;
-				}
+			auto conditionIt = cmd.params.find("condition");
+			if (conditionIt != cmd.params.end()) {
+				condition = conditionIt->second;
 			}
 
-			if (hasExec) bpType |= static_cast<uint8_t>(BreakpointTypeFlags::Execute);
-			if (hasRead) bpType |= static_cast<uint8_t>(BreakpointTypeFlags::Read);
-			if (hasWrite) bpType |= static_cast<uint8_t>(BreakpointTypeFlags::Write);
+			auto labelsIt = cmd.params.find("labels");
+			if (labelsIt != cmd.params.end()) {
+				options.UseLabels = ParseBoolValue(labelsIt->second);
+			}
 
-			if (bpType == 0) {
-				bpType = static_cast<uint8_t>(BreakpointTypeFlags::Execute);
+			auto indentIt = cmd.params.find("indent");
+			if (indentIt != cmd.params.end()) {
+				options.IndentCode = ParseBoolValue(indentIt->second);
 			}
-		}
 
-		// Get end address (optional, for address range)
-		uint32_t endAddr = addr;
-		auto endaddrIt = cmd.params.find("endaddr");
-		if (endaddrIt != cmd.params.end()) {
-			string endAddrStr = endaddrIt->second;
-			if (endAddrStr.substr(0, 2) == "0x" || endAddrStr.substr(0, 2) == "0X") {
-				endAddr = std::stoul(endAddrStr.substr(2), nullptr, 16);
-			} else {
-				endAddr = std::stoul(endAddrStr, nullptr, 16);
+			memset(options.Format, 0, sizeof(options.Format));
+			if (!format.empty()) {
+				strncpy(options.Format, format.c_str(), sizeof(options.Format) - 1);
 			}
-		}
 
-		// Get memory type
-		MemoryType memType = MemoryType::SnesMemory;
-		auto memtypeIt = cmd.params.find("memtype");
-		if (memtypeIt != cmd.params.end()) {
-			if(!TryParseMemoryType(memtypeIt->second, memType)) {
-				resp.success = false;
-				resp.error = "Unknown memtype: " + memtypeIt->second;
-				return resp;
+			memset(options.Condition, 0, sizeof(options.Condition));
+			if (!condition.empty()) {
+				strncpy(options.Condition, condition.c_str(), sizeof(options.Condition) - 1);
 			}
-		}
 
-		// Get CPU type
-		CpuType cpuType = CpuType::Snes;
-		auto cputypeIt = cmd.params.find("cputype");
-		if (cputypeIt != cmd.params.end()) {
-			cpuType = ParseCpuType(cputypeIt->second);
-		}
+			if (enable) {
+				auto clearIt = cmd.params.find("clear");
+				if (clearIt != cmd.params.end() && ParseBoolValue(clearIt->second)) {
+					debugger->ClearExecutionTrace();
+				}
+			}
 
-		// Get condition (optional)
-		string condition = "";
-		auto condIt = cmd.params.find("condition");
-		if (condIt != cmd.params.end()) {
-			condition = condIt->second;
+			for (CpuType cpuType : emu->GetCpuTypes()) {
+				ITraceLogger* logger = debugger->GetTraceLogger(cpuType);
+				if (logger) {
+					logger->SetOptions(options);
+				}
+			}
+			// The loggers' options were set explicitly, TRACE_QUERY stop must not revert them
+			emu->GetSocketState()->traceQueryLoggers.clear();
+
+			stringstream ss;
+			ss << "{\"enabled\":" << (enable ? "true" : "false") << "}";
+			resp.success = true;
+			resp.data = ss.str();
+			return resp;
 		}
 
-		// Create the breakpoint
-		auto lock = _breakpointLock.AcquireSafe();
-		uint32_t newId = _nextBreakpointId++;
+		resp.success = false;
+		resp.error = "Unknown TRACE action: " + action;
+		return resp;
+	}
 
-		SocketBreakpoint sbp;
-		sbp.id = newId;
-		sbp.cpuType = cpuType;
-		sbp.memoryType = memType;
-		sbp.type = bpType;
-		sbp.startAddr = static_cast<int32_t>(addr);
-		sbp.endAddr = static_cast<int32_t>(endAddr);
-		sbp.enabled = true;
-		sbp.condition = condition;
+	// Get optional count parameter (default 20, max 100)
+	uint32_t count = 20;
+	auto countIt = cmd.params.find("count");
+	if (countIt != cmd.params.end()) {
+		count = std::stoul(countIt->second);
+		if (count > 100) count = 100;
+		if (count == 0) count = 1;
+	}
 
-		_breakpoints.push_back(sbp);
-		lock.Release();
+	// Get optional offset parameter (default 0)
+	uint32_t offset = 0;
+	auto offsetIt = cmd.params.find("offset");
+	if (offsetIt != cmd.params.end()) {
+		offset = std::stoul(offsetIt->second);
+	}
 
-		// Sync with emulator
-		SyncBreakpoints(emu);
+	// Allocate trace buffer
+	vector<TraceRow> traceRows(count);
 
-		stringstream ss;
-		ss << "{\"id\":" << newId << "}";
-		resp.success = true;
-		resp.data = ss.str();
-	}
-	else if (action == "remove") {
-		// Remove a breakpoint by ID
-		auto idIt = cmd.params.find("id");
-		if (idIt == cmd.params.end()) {
+	uint32_t actualCount;
+	if (action == "read") {
+		auto pathIt = cmd.params.find("path");
+		int32_t rowCount = pathIt != cmd.params.end() ? debugger->GetBinaryTraceLog(pathIt->second, traceRows.data(), offset, count) : -1;
+		if (rowCount < 0) {
 			resp.success = false;
-			resp.error = "Missing id parameter";
+			resp.error = pathIt != cmd.params.end() ? "Not a binary trace log: " + pathIt->second : "Missing path parameter";
+			resp.errorCode = pathIt != cmd.params.end() ? SocketErrorCode::InvalidParameter : SocketErrorCode::MissingParameter;
 			return resp;
 		}
+		actualCount = (uint32_t)rowCount;
+	} else {
+		// Get execution trace from debugger
+		actualCount = dbg.GetDebugger()->GetExecutionTrace(traceRows.data(), offset, count);
+	}
 
-		uint32_t bpId = std::stoul(idIt->second);
+	// Build JSON response
+	stringstream ss;
+	ss << "{\"count\":" << actualCount << ",\"offset\":" << offset << ",\"entries\":[";
 
-		auto lock = _breakpointLock.AcquireSafe();
-		auto it = std::find_if(_breakpoints.begin(), _breakpoints.end(),
-			[bpId](const SocketBreakpoint& bp) { return bp.id == bpId; });
+	for (uint32_t i = 0; i < actualCount; i++) {
+		const TraceRow& row = traceRows[i];
 
-		if (it != _breakpoints.end()) {
-			_breakpoints.erase(it);
-			lock.Release();
-			SyncBreakpoints(emu);
-			resp.success = true;
-			resp.data = "\"OK\"";
-		} else {
-			resp.success = false;
-			resp.error = "Breakpoint not found: " + std::to_string(bpId);
-		}
-	}
-	else if (action == "list") {
-		// List all breakpoints
-		auto lock = _breakpointLock.AcquireSafe();
+		if (i > 0) ss << ",";
 
-		stringstream ss;
-		ss << "{\"breakpoints\":[";
-		bool first = true;
-		for (const auto& bp : _breakpoints) {
-			if (!first) ss << ",";
-			first = false;
+		ss << "{";
+		ss << "\"pc\":\"" << FormatHex(row.ProgramCounter, 6) << "\",";
+		ss << "\"cpu\":" << static_cast<int>(row.Type) << ",";
 
-			ss << "{\"id\":" << bp.id;
-			ss << ",\"addr\":\"0x" << hex << uppercase << setw(6) << setfill('0') << bp.startAddr << "\"";
-			if (bp.endAddr != bp.startAddr) {
-				ss << ",\"endaddr\":\"0x" << hex << uppercase << setw(6) << setfill('0') << bp.endAddr << "\"";
-			}
-			ss << std::dec;
-			ss << ",\"type\":" << static_cast<int>(bp.type);
-			ss << ",\"enabled\":" << (bp.enabled ? "true" : "false");
-			if (!bp.condition.empty()) {
-				ss << ",\"condition\":\"" << JsonEscape(bp.condition) << "\"";
-			}
-			ss << "}";
+		// Format bytecode as hex string
+		ss << "\"bytes\":\"";
+		for (int j = 0; j < row.ByteCodeSize && j < 8; j++) {
+			ss << hex << uppercase << setw(2) << setfill('0') << (int)row.ByteCode[j];
 		}
-		ss << "]}";
+		ss << dec << "\",";
 
-		resp.success = true;
-		resp.data = ss.str();
+		// Add disassembly output (escaped)
+		string logOutput(row.LogOutput, std::min((uint32_t)row.LogSize, (uint32_t)sizeof(row.LogOutput)));
+		ss << "\"disasm\":\"" << JsonEscape(logOutput) << "\"";
+
+		ss << "}";
 	}
-	else if (action == "enable" || action == "disable") {
-		// Enable or disable a breakpoint
-		auto idIt = cmd.params.find("id");
-		if (idIt == cmd.params.end()) {
-			resp.success = false;
-			resp.error = "Missing id parameter";
-			return resp;
-		}
 
-		uint32_t bpId = std::stoul(idIt->second);
-		bool enable = (action == "enable");
+	ss << "]}";
 
-		auto lock = _breakpointLock.AcquireSafe();
-		auto it = std::find_if(_breakpoints.begin(), _breakpoints.end(),
-			[bpId](const SocketBreakpoint& bp) { return bp.id == bpId; });
+	resp.success = true;
+	resp.data = ss.str();
+	return resp;
+}
 
-		if (it != _breakpoints.end()) {
-			it->enabled = enable;
-			lock.Release();
-			SyncBreakpoints(emu);
-			resp.success = true;
-			resp.data = "\"OK\"";
-		} else {
-			resp.success = false;
-			resp.error = "Breakpoint not found: " + std::to_string(bpId);
+// Parses "value" or "min-max" (decimal, 0x or $ prefixed hex) into a TRACE_QUERY filter
+static bool ParseTraceQueryRange(const string& value, TraceStoreRange& range) {
+	auto parseValue = [](string text, int64_t& out) {
+		text.erase(0, text.find_first_not_of(" \t"));
+		text.erase(text.find_last_not_of(" \t") + 1);
+		if (text.empty()) {
+			return false;
 		}
-	}
-	else if (action == "clear") {
-		// Remove all breakpoints
-		auto lock = _breakpointLock.AcquireSafe();
-		_breakpoints.clear();
-		lock.Release();
-		SyncBreakpoints(emu);
+		try {
+			size_t pos = 0;
+			out = text[0] == '$' ? std::stoll(text.substr(1), &pos, 16) : std::stoll(text, &pos, 0);
+			return pos == (text[0] == '$' ? text.size() - 1 : text.size());
+		} catch (...) {
+			return false;
+		}
+	};
 
-		resp.success = true;
-		resp.data = "\"OK\"";
-	}
-	else {
-		resp.success = false;
-		resp.error = "Unknown action: " + action;
+	size_t separator = value.find('-', 1);
+	range.Enabled = true;
+	if (separator == string::npos) {
+		if (!parseValue(value, range.Min)) {
+			return false;
+		}
+		range.Max = range.Min;
+		return true;
 	}
-
-	return resp;
+	return parseValue(value.substr(0, separator), range.Min) && parseValue(value.substr(separator + 1), range.Max) && range.Min <= range.Max;
 }
 
-SocketResponse SocketServer::HandleBatch(Emulator* emu, const SocketCommand& cmd) {
+SocketResponse SocketServer::HandleTraceQuery(Emulator* emu, const SocketCommand& cmd) {
 	SocketResponse resp;
 
-	// Parse commands array from params
-	auto commandsIt = cmd.params.find("commands");
-	if (commandsIt == cmd.params.end()) {
+	if (!emu->IsRunning()) {
 		resp.success = false;
-		resp.error = "Missing commands parameter";
+		resp.error = "No ROM loaded";
+		resp.errorCode = SocketErrorCode::EmulatorNotRunning;
 		return resp;
 	}
 
-	// The commands value should be a JSON array string
-	// Format: [{"type":"PING"},{"type":"READ","addr":"0x7E0000"}]
-	string commandsJson = commandsIt->second;
-
-	// Parse JSON array of commands
-	vector<SocketCommand> subCommands;
-	string parseError;
-
-	// Simple JSON array parsing
-	size_t pos = 0;
-	while (pos < commandsJson.size() && commandsJson[pos] != '[') pos++;
-	if (pos >= commandsJson.size()) {
+	auto dbg = emu->GetDebugger(true);
+	Debugger* debugger = dbg.GetDebugger();
+	if (!debugger) {
 		resp.success = false;
-		resp.error = "Invalid commands format - expected JSON array";
+		resp.error = "Debugger not available";
+		resp.errorCode = SocketErrorCode::DebuggerNotAvailable;
 		return resp;
 	}
-	pos++; // Skip '['
 
-	while (pos < commandsJson.size()) {
-		// Skip whitespace
-		while (pos < commandsJson.size() && std::isspace(commandsJson[pos])) pos++;
+	TraceStore* store = debugger->GetTraceStore();
+	SocketInstanceState& state = *emu->GetSocketState();
+	auto actionIt = cmd.params.find("action");
+	string action = actionIt != cmd.params.end() ? actionIt->second : "query";
+	std::transform(action.begin(), action.end(), action.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+	if (action == "start" || action == "stop" || action == "clear" || action == "status") {
+		if (action == "start") {
+			uint32_t maxRows = TraceStore::DefaultMaxRows;
+			auto maxRowsIt = cmd.params.find("max_rows");
+			if (maxRowsIt != cmd.params.end()) {
+				int value = 0;
+				if (!TryParseInt(maxRowsIt->second, value) || value <= 0 || value > 64 * 1024 * 1024) {
+					resp.success = false;
+					resp.error = "Invalid max_rows value (1 to 67108864)";
+					resp.errorCode = SocketErrorCode::InvalidParameter;
+					return resp;
+				}
+				maxRows = (uint32_t)value;
+			}
 
-		if (pos >= commandsJson.size() || commandsJson[pos] == ']') break;
+			{
+				DebugBreakHelper helper(debugger);
+				store->Start(maxRows);
+			}
 
-		// Find the start of an object
-		if (commandsJson[pos] != '{') {
-			if (commandsJson[pos] == ',') {
-				pos++;
-				continue;
+			// Rows are only recorded while the trace loggers are running
+			TraceLoggerOptions options = {};
+			options.Enabled = true;
+			options.UseLabels = true;
+			strncpy(options.Format, "[Disassembly]", sizeof(options.Format) - 1);
+			for (CpuType cpuType : emu->GetCpuTypes()) {
+				ITraceLogger* logger = debugger->GetTraceLogger(cpuType);
+				if (logger && !logger->IsEnabled()) {
+					state.traceQueryLoggers.push_back({ cpuType, logger->GetOptions() });
+					logger->SetOptions(options);
+				}
 			}
-			break;
+		} else if (action == "stop") {
+			DebugBreakHelper helper(debugger);
+			store->Stop();
+		} else if (action == "clear") {
+			DebugBreakHelper helper(debugger);
+			store->Clear();
 		}
 
-		// Find matching closing brace
-		int braceCount = 1;
-		size_t start = pos;
-		pos++;
-		while (pos < commandsJson.size() && braceCount > 0) {
-			if (commandsJson[pos] == '{') braceCount++;
-			else if (commandsJson[pos] == '}') braceCount--;
-			pos++;
+		if ((action == "stop" || action == "clear") && !store->IsEnabled()) {
+			// Turn off the loggers that start enabled (clearing a store that's still recording keeps them running)
+			for (auto& [cpuType, options] : state.traceQueryLoggers) {
+				ITraceLogger* logger = debugger->GetTraceLogger(cpuType);
+				if (logger) {
+					logger->SetOptions(options);
+				}
+			}
+			state.traceQueryLoggers.clear();
 		}
 
-		if (braceCount != 0) {
+		stringstream ss;
+		ss << "{\"enabled\":" << (store->IsEnabled() ? "true" : "false");
+		ss << ",\"rows\":" << store->GetRowCount();
+		ss << ",\"firstRow\":" << store->GetFirstRowId();
+		ss << ",\"maxRows\":" << store->GetMaxRows();
+		ss << ",\"memoryBytes\":" << store->GetMemorySize() << "}";
+		resp.success = true;
+		resp.data = ss.str();
+		return resp;
+	}
+
+	if (action != "query") {
+		resp.success = false;
+		resp.error = "Unknown TRACE_QUERY action: " + action;
+		resp.errorCode = SocketErrorCode::InvalidParameter;
+		return resp;
+	}
+
+	TraceStoreQuery query;
+	std::pair<const char*, TraceStoreRange*> rangeParams[] = {
+		{ "pc", &query.ProgramCounter },
+		{ "addr", &query.EffectiveAddress },
+		{ "opcode", &query.OpCode },
+		{ "a", &query.A },
+		{ "x", &query.X },
+		{ "y", &query.Y },
+		{ "sp", &query.SP },
+		{ "ps", &query.PS },
+		{ "frame", &query.FrameCount },
+	};
+	for (auto& param : rangeParams) {
+		auto it = cmd.params.find(param.first);
+		if (it != cmd.params.end() && !ParseTraceQueryRange(it->second, *param.second)) {
 			resp.success = false;
-			resp.error = "Invalid commands format - unmatched braces";
+			resp.error = string("Invalid ") + param.first + " value (expected a value or min-max range)";
+			resp.errorCode = SocketErrorCode::InvalidParameter;
 			return resp;
 		}
+	}
 
-		string subJson = commandsJson.substr(start, pos - start);
+	auto cpuIt = cmd.params.find("cpu");
+	if (cpuIt != cmd.params.end()) {
+		query.CpuMask = 1 << (int)ParseCpuType(cpuIt->second);
+	}
 
-		// Parse the sub-command
-		SocketCommand subCmd;
-		string subError;
-		unordered_map<string, string> subParams;
-		if (!ParseJsonObject(subJson, subParams, subError)) {
+	// Only look at the last N frames
+	auto framesIt = cmd.params.find("frames");
+	if (framesIt != cmd.params.end()) {
+		int frames = 0;
+		if (!TryParseInt(framesIt->second, frames) || frames <= 0) {
 			resp.success = false;
-			resp.error = "Failed to parse sub-command: " + subError;
+			resp.error = "Invalid frames value";
+			resp.errorCode = SocketErrorCode::InvalidParameter;
 			return resp;
 		}
+		uint32_t frameCount = emu->GetFrameCount();
+		query.FrameCount.Enabled = true;
+		query.FrameCount.Min = std::max<int64_t>(0, (int64_t)frameCount - frames + 1);
+		query.FrameCount.Max = frameCount;
+	}
 
-		auto typeIt = subParams.find("type");
-		if (typeIt == subParams.end()) {
+	auto countIt = cmd.params.find("count");
+	if (countIt != cmd.params.end()) {
+		int count = 0;
+		if (!TryParseInt(countIt->second, count) || count <= 0) {
 			resp.success = false;
-			resp.error = "Sub-command missing type field";
+			resp.error = "Invalid count value";
+			resp.errorCode = SocketErrorCode::InvalidParameter;
 			return resp;
 		}
+		query.MaxResults = std::min(count, 10000);
+	}
 
-		subCmd.type = typeIt->second;
-		std::transform(subCmd.type.begin(), subCmd.type.end(), subCmd.type.begin(),
-			[](unsigned char c) { return static_cast<char>(std::toupper(c)); });
-
-		subParams.erase(typeIt);
-		subCmd.params = std::move(subParams);
-		subCommands.push_back(std::move(subCmd));
+	auto startRowIt = cmd.params.find("start_row");
+	if (startRowIt != cmd.params.end()) {
+		try {
+			query.StartRow = std::stoull(startRowIt->second);
+		} catch (...) {
+			resp.success = false;
+			resp.error = "Invalid start_row value";
+			resp.errorCode = SocketErrorCode::InvalidParameter;
+			return resp;
+		}
 	}
 
-	if (subCommands.empty()) {
-		resp.success = false;
-		resp.error = "No commands in batch";
-		return resp;
+	TraceStoreQueryResult result;
+	auto startTime = std::chrono::steady_clock::now();
+	{
+		DebugBreakHelper helper(debugger);
+		store->Query(query, result);
 	}
+	double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
 
-	// Execute each sub-command and collect results
 	stringstream ss;
-	ss << "{\"results\":[";
-
-	bool allSuccess = true;
-	for (size_t i = 0; i < subCommands.size(); i++) {
-		const SocketCommand& subCmd = subCommands[i];
-
+	ss << "{\"count\":" << result.Rows.size();
+	ss << ",\"scannedRows\":" << result.ScannedRows;
+	ss << ",\"scannedChunks\":" << result.ScannedChunks;
+	ss << ",\"skippedChunks\":" << result.SkippedChunks;
+	ss << ",\"elapsedMs\":" << std::fixed << std::setprecision(3) << elapsedMs;
+	if (result.NextRow) {
+		ss << ",\"nextRow\":" << result.NextRow;
+	}
+	ss << ",\"rows\":[";
+	for (size_t i = 0; i < result.Rows.size(); i++) {
+		const TraceStoreRow& row = result.Rows[i];
 		if (i > 0) ss << ",";
-
-		SocketResponse subResp;
-		if (subCmd.type == "PING") subResp = HandlePing(emu, subCmd);
-		else if (subCmd.type == "STATE") subResp = HandleState(emu, subCmd);
-		else if (subCmd.type == "HEALTH") subResp = HandleHealth(emu, subCmd);
-		else if (subCmd.type == "PAUSE") subResp = HandlePause(emu, subCmd);
-		else if (subCmd.type == "RESUME") subResp = HandleResume(emu, subCmd);
-		else if (subCmd.type == "RESET") subResp = HandleReset(emu, subCmd);
-		else if (subCmd.type == "READ") subResp = HandleRead(emu, subCmd);
-		else if (subCmd.type == "READ16") subResp = HandleRead16(emu, subCmd);
-		else if (subCmd.type == "WRITE") subResp = HandleWrite(emu, subCmd);
-		else if (subCmd.type == "WRITE16") subResp = HandleWrite16(emu, subCmd);
-		else if (subCmd.type == "READBLOCK") subResp = HandleReadBlock(emu, subCmd);
-		else if (subCmd.type == "WRITEBLOCK") subResp = HandleWriteBlock(emu, subCmd);
-		else if (subCmd.type == "SAVESTATE") subResp = HandleSaveState(emu, subCmd);
-		else if (subCmd.type == "SAVESTATE_LABEL") subResp = HandleSaveStateLabel(emu, subCmd);
-		else if (subCmd.type == "LOADSTATE") subResp = HandleLoadState(emu, subCmd);
-		else if (subCmd.type == "SCREENSHOT") subResp = HandleScreenshot(emu, subCmd);
-		else if (subCmd.type == "CPU") subResp = HandleGetCpuState(emu, subCmd);
-		else if (subCmd.type == "STATEINSPECT") subResp = HandleStateInspector(emu, subCmd);
-		else if (subCmd.type == "DISASM") subResp = HandleDisasm(emu, subCmd);
-		else if (subCmd.type == "STEP") subResp = HandleStep(emu, subCmd);
-		else if (subCmd.type == "FRAME") subResp = HandleRunFrame(emu, subCmd);
-		else if (subCmd.type == "ROMINFO") subResp = HandleRomInfo(emu, subCmd);
-		else if (subCmd.type == "BREAKPOINT") subResp = HandleBreakpoint(emu, subCmd);
-		else if (subCmd.type == "LABELS") subResp = HandleLabels(emu, subCmd);
-		else if (subCmd.type == "SEARCH") subResp = HandleSearch(emu, subCmd);
-		else if (subCmd.type == "SNAPSHOT") subResp = HandleSnapshot(emu, subCmd);
-		else if (subCmd.type == "DIFF") subResp = HandleDiff(emu, subCmd);
-		else if (subCmd.type == "TRACE") subResp = HandleTrace(emu, subCmd);
-		else if (subCmd.type == "LOGPOINT") subResp = HandleLogpoint(emu, subCmd);
-		else if (subCmd.type == "SUBSCRIBE") subResp = HandleSubscribe(emu, subCmd);
-		else if (subCmd.type == "DEBUG_LOG") subResp = HandleDebugLog(emu, subCmd);
-		else {
-			subResp.success = false;
-			subResp.error = "Unknown command or not allowed in BATCH: " + subCmd.type;
-		}
-
-		if (!subResp.success) {
-			allSuccess = false;
-		}
-
-		// Add result to output
-		ss << "{\"type\":\"" << subCmd.type << "\",";
-		ss << "\"success\":" << (subResp.success ? "true" : "false");
-		if (!subResp.data.empty()) {
-			ss << ",\"data\":" << subResp.data;
-		}
-		if (!subResp.error.empty()) {
-			ss << ",\"error\":\"" << JsonEscape(subResp.error) << "\"";
+		ss << "{\"row\":" << result.RowIds[i];
+		ss << ",\"cpu\":" << static_cast<int>(row.Type);
+		ss << ",\"pc\":\"" << FormatHex(row.ProgramCounter, 6) << "\"";
+		ss << ",\"bytes\":\"";
+		for (int j = 0; j < row.OpSize && j < 4; j++) {
+			ss << hex << uppercase << setw(2) << setfill('0') << ((row.ByteCode >> (j * 8)) & 0xFF);
+		}
+		ss << dec << "\"";
+		ss << ",\"a\":" << row.A << ",\"x\":" << row.X << ",\"y\":" << row.Y;
+		ss << ",\"sp\":" << row.SP << ",\"ps\":" << row.PS;
+		if (row.EffectiveAddress >= 0) {
+			ss << ",\"addr\":\"" << FormatHex(row.EffectiveAddress, 6) << "\"";
+		} else {
+			ss << ",\"addr\":null";
 		}
-		ss << "}";
+		ss << ",\"cycle\":" << row.CycleCount;
+		ss << ",\"frame\":" << row.FrameCount;
+		ss << ",\"scanline\":" << row.Scanline << "}";
 	}
-
 	ss << "]}";
 
-	resp.success = allSuccess;
+	resp.success = true;
 	resp.data = ss.str();
 	return resp;
 }
 
-SocketResponse SocketServer::HandleTrace(Emulator* emu, const SocketCommand& cmd) {
+SocketResponse SocketServer::HandleDisasmExport(Emulator* emu, const SocketCommand& cmd) {
 	SocketResponse resp;
 
+	auto pathIt = cmd.params.find("path");
+	if (pathIt == cmd.params.end() || pathIt->second.empty()) {
+		resp.success = false;
+		resp.error = "Missing path parameter";
+		resp.errorCode = SocketErrorCode::MissingParameter;
+		return resp;
+	}
+
 	if (!emu->IsRunning()) {
 		resp.success = false;
 		resp.error = "No ROM loaded";
+		resp.errorCode = SocketErrorCode::EmulatorNotRunning;
 		return resp;
 	}
 
@@ -4318,170 +6166,264 @@ SocketResponse SocketServer::HandleTrace(Emulator* emu, const SocketCommand& cmd
 	if (!debugger) {
 		resp.success = false;
 		resp.error = "Debugger not available";
+		resp.errorCode = SocketErrorCode::DebuggerNotAvailable;
 		return resp;
 	}
 
-	string action;
-	auto actionIt = cmd.params.find("action");
-	if (actionIt != cmd.params.end()) {
-		action = actionIt->second;
-		std::transform(action.begin(), action.end(), action.begin(),
-			[](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+	// Defaults to the main CPU's PRG ROM
+	MemoryType memType = MemoryType::None;
+	switch (emu->GetCpuTypes()[0]) {
+		case CpuType::Snes: memType = MemoryType::SnesPrgRom; break;
+		case CpuType::Gameboy: memType = MemoryType::GbPrgRom; break;
+		case CpuType::Nes: memType = MemoryType::NesPrgRom; break;
+		case CpuType::Pce: memType = MemoryType::PcePrgRom; break;
+		case CpuType::Sms: memType = MemoryType::SmsPrgRom; break;
+		case CpuType::Gba: memType = MemoryType::GbaPrgRom; break;
+		default: break;
 	}
 
-	if (!action.empty()) {
-		if (action == "clear") {
-			debugger->ClearExecutionTrace();
-			resp.success = true;
-			resp.data = "\"OK\"";
-			return resp;
-		}
-
-		if (action == "status") {
-			bool enabled = false;
-			for (CpuType cpuType : emu->GetCpuTypes()) {
-				ITraceLogger* logger = debugger->GetTraceLogger(cpuType);
-				if (logger && logger->IsEnabled()) {
-					enabled = true;
-					break;
-				}
-			}
-
-			stringstream ss;
-			ss << "{\"enabled\":" << (enabled ? "true" : "false") << "}";
-			resp.success = true;
-			resp.data = ss.str();
-			return resp;
-		}
-
-		if (action == "start" || action == "stop") {
-			bool enable = action == "start";
-			TraceLoggerOptions options = {};
-			options.Enabled = enable;
-			options.IndentCode = false;
-			options.UseLabels = true;
-
-			string format = "[Disassembly]";
-			string condition;
-
-			auto formatIt = cmd.params.find("format");
-			if (formatIt != cmd.params.end()) {
-				format = formatIt->second;
-			}
-
-			auto conditionIt = cmd.params.find("condition");
-			if (conditionIt != cmd.params.end()) {
-				condition = conditionIt->second;
-			}
+	auto memtypeIt = cmd.params.find("memtype");
+	if (memtypeIt != cmd.params.end() && !TryParseMemoryType(memtypeIt->second, memType)) {
+		resp.success = false;
+		resp.error = "Unknown memtype: " + memtypeIt->second;
+		resp.errorCode = SocketErrorCode::InvalidParameter;
+		return resp;
+	}
 
-			auto labelsIt = cmd.params.find("labels");
-			if (labelsIt != cmd.params.end()) {
-				options.UseLabels = ParseBoolValue(labelsIt->second);
-			}
+	if (!debugger->GetCdlManager()->GetCodeDataLogger(memType)) {
+		resp.success = false;
+		resp.error = "No code data logger for memtype: " + string(magic_enum::enum_name(memType));
+		resp.errorCode = SocketErrorCode::InvalidParameter;
+		return resp;
+	}
 
-			auto indentIt = cmd.params.find("indent");
-			if (indentIt != cmd.params.end()) {
-				options.IndentCode = ParseBoolValue(indentIt->second);
-			}
+	auto fullIt = cmd.params.find("full");
+	bool full = fullIt != cmd.params.end() && ParseBoolValue(fullIt->second);
 
-			memset(options.Format, 0, sizeof(options.Format));
-			if (!format.empty()) {
-				strncpy(options.Format, format.c_str(), sizeof(options.Format) - 1);
-			}
+	DisassemblyExportResult result = debugger->GetDisassemblyExporter()->Export(memType, pathIt->second, full);
+	if (!result.Success) {
+		resp.success = false;
+		resp.error = "Could not write disassembly to: " + pathIt->second;
+		resp.errorCode = SocketErrorCode::InternalError;
+		return resp;
+	}
 
-			memset(options.Condition, 0, sizeof(options.Condition));
-			if (!condition.empty()) {
-				strncpy(options.Condition, condition.c_str(), sizeof(options.Condition) - 1);
-			}
+	std::ostringstream ss;
+	ss << "{\"path\":\"" << JsonEscape(pathIt->second) << "\"";
+	ss << ",\"memtype\":\"" << magic_enum::enum_name(memType) << "\"";
+	ss << ",\"blocks\":" << result.BlockCount;
+	ss << ",\"disassembled\":" << result.DisassembledBlocks;
+	ss << ",\"reused\":" << result.ReusedBlocks;
+	ss << ",\"lines\":" << result.LineCount;
+	ss << ",\"elapsedMs\":" << std::fixed << std::setprecision(2) << result.ElapsedMs << "}";
 
-			if (enable) {
-				auto clearIt = cmd.params.find("clear");
-				if (clearIt != cmd.params.end() && ParseBoolValue(clearIt->second)) {
-					debugger->ClearExecutionTrace();
-				}
-			}
+	resp.success = true;
+	resp.data = ss.str();
+	return resp;
+}
 
-			for (CpuType cpuType : emu->GetCpuTypes()) {
-				ITraceLogger* logger = debugger->GetTraceLogger(cpuType);
-				if (logger) {
-					logger->SetOptions(options);
-				}
-			}
+SocketResponse SocketServer::HandleProfiler(Emulator* emu, const SocketCommand& cmd) {
+	SocketResponse resp;
 
-			stringstream ss;
-			ss << "{\"enabled\":" << (enable ? "true" : "false") << "}";
-			resp.success = true;
-			resp.data = ss.str();
-			return resp;
-		}
+	if (!emu->IsRunning()) {
+		resp.success = false;
+		resp.error = "No ROM loaded";
+		resp.errorCode = SocketErrorCode::EmulatorNotRunning;
+		return resp;
+	}
 
+	auto dbg = emu->GetDebugger(true);
+	Debugger* debugger = dbg.GetDebugger();
+	if (!debugger) {
 		resp.success = false;
-		resp.error = "Unknown TRACE action: " + action;
+		resp.error = "Debugger not available";
+		resp.errorCode = SocketErrorCode::DebuggerNotAvailable;
 		return resp;
 	}
 
-	// Get optional count parameter (default 20, max 100)
+	SamplingProfiler* profiler = debugger->GetSamplingProfiler();
+	auto actionIt = cmd.params.find("action");
+	string action = actionIt != cmd.params.end() ? actionIt->second : "status";
+	std::transform(action.begin(), action.end(), action.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
 	uint32_t count = 20;
 	auto countIt = cmd.params.find("count");
 	if (countIt != cmd.params.end()) {
-		count = std::stoul(countIt->second);
-		if (count > 100) count = 100;
-		if (count == 0) count = 1;
-	}
-
-	// Get optional offset parameter (default 0)
-	uint32_t offset = 0;
-	auto offsetIt = cmd.params.find("offset");
-	if (offsetIt != cmd.params.end()) {
-		offset = std::stoul(offsetIt->second);
+		int value = 0;
+		if (!TryParseInt(countIt->second, value) || value < 0 || value > 100000) {
+			resp.success = false;
+			resp.error = "Invalid count value (0 to 100000)";
+			resp.errorCode = SocketErrorCode::InvalidParameter;
+			return resp;
+		}
+		count = (uint32_t)value;
 	}
 
-	// Allocate trace buffer
-	vector<TraceRow> traceRows(count);
-
-	// Get execution trace from debugger
-	uint32_t actualCount = dbg.GetDebugger()->GetExecutionTrace(traceRows.data(), offset, count);
-
-	// Build JSON response
-	stringstream ss;
-	ss << "{\"count\":" << actualCount << ",\"offset\":" << offset << ",\"entries\":[";
-
-	for (uint32_t i = 0; i < actualCount; i++) {
-		const TraceRow& row = traceRows[i];
+	// Function/address keys: absolute address | (memory type << 24)
+	auto appendFunction = [&](std::ostringstream& ss, int32_t key) {
+		ss << "\"name\":\"" << JsonEscape(profiler->GetFunctionName(key)) << "\"";
+		if (key >= 0) {
+			ss << ",\"addr\":\"" << FormatHex(key & 0xFFFFFF, 6) << "\"";
+			ss << ",\"memtype\":\"" << magic_enum::enum_name((MemoryType)((uint32_t)key >> 24)) << "\"";
+		}
+	};
+	auto percent = [](uint64_t clocks, uint64_t total) {
+		return total > 0 ? (double)clocks * 100.0 / total : 0.0;
+	};
 
-		if (i > 0) ss << ",";
+	std::ostringstream ss;
+	ss << std::fixed << std::setprecision(2);
 
-		ss << "{";
-		ss << "\"pc\":\"" << FormatHex(row.ProgramCounter, 6) << "\",";
-		ss << "\"cpu\":" << static_cast<int>(row.Type) << ",";
+	if (action == "start") {
+		CpuType cpuType = emu->GetCpuTypes()[0];
+		auto cpuIt = cmd.params.find("cpu");
+		if (cpuIt != cmd.params.end()) {
+			cpuType = ParseCpuType(cpuIt->second);
+		}
 
-		// Format bytecode as hex string
-		ss << "\"bytes\":\"";
-		for (int j = 0; j < row.ByteCodeSize && j < 8; j++) {
-			ss << hex << uppercase << setw(2) << setfill('0') << (int)row.ByteCode[j];
+		uint32_t interval = SamplingProfiler::DefaultInterval;
+		auto intervalIt = cmd.params.find("interval");
+		if (intervalIt != cmd.params.end()) {
+			int value = 0;
+			if (!TryParseInt(intervalIt->second, value) || value <= 0) {
+				resp.success = false;
+				resp.error = "Invalid interval value (clocks, > 0)";
+				resp.errorCode = SocketErrorCode::InvalidParameter;
+				return resp;
+			}
+			interval = (uint32_t)value;
 		}
-		ss << dec << "\",";
 
-		// Add disassembly output (escaped)
-		string logOutput(row.LogOutput, std::min((uint32_t)row.LogSize, (uint32_t)sizeof(row.LogOutput)));
-		ss << "\"disasm\":\"" << JsonEscape(logOutput) << "\"";
+		if (!profiler->Start(cpuType, interval)) {
+			resp.success = false;
+			resp.error = "CPU not available for profiling: " + CpuTypeName(cpuType);
+			resp.errorCode = SocketErrorCode::InvalidParameter;
+			return resp;
+		}
+		ss << "{\"enabled\":true,\"cpu\":\"" << CpuTypeName(cpuType) << "\",\"interval\":" << interval << "}";
+	} else if (action == "stop" || action == "reset" || action == "status") {
+		if (action == "stop") {
+			profiler->Stop();
+		} else if (action == "reset") {
+			profiler->Reset();
+		}
+
+		SamplingProfilerStatus status = profiler->GetStatus();
+		ss << "{\"enabled\":" << (status.Enabled ? "true" : "false");
+		ss << ",\"cpu\":\"" << CpuTypeName(status.Cpu) << "\"";
+		ss << ",\"interval\":" << status.Interval;
+		ss << ",\"samples\":" << status.SampleCount;
+		ss << ",\"totalClocks\":" << status.TotalClocks;
+		ss << ",\"functions\":" << status.FunctionCount;
+		ss << ",\"stacks\":" << status.StackCount;
+		ss << ",\"addresses\":" << status.AddressCount << "}";
+	} else if (action == "functions") {
+		DebugBreakHelper helper(debugger);
+		uint64_t total = profiler->GetStatus().TotalClocks;
+		ss << "{\"totalClocks\":" << total << ",\"functions\":[";
+		bool first = true;
+		for (SampledFunction& func : profiler->GetFunctions(count)) {
+			if (!first) ss << ",";
+			first = false;
+			ss << "{";
+			appendFunction(ss, func.Key);
+			ss << ",\"exclusive\":" << func.ExclusiveClocks;
+			ss << ",\"inclusive\":" << func.InclusiveClocks;
+			ss << ",\"samples\":" << func.SampleCount;
+			ss << ",\"pct\":" << percent(func.ExclusiveClocks, total) << "}";
+		}
+		ss << "]}";
+	} else if (action == "addresses") {
+		DebugBreakHelper helper(debugger);
+		uint64_t total = profiler->GetStatus().TotalClocks;
+		ss << "{\"totalClocks\":" << total << ",\"addresses\":[";
+		bool first = true;
+		for (auto& [key, clocks] : profiler->GetHotAddresses(count)) {
+			if (!first) ss << ",";
+			first = false;
+			ss << "{";
+			appendFunction(ss, key);
+			ss << ",\"clocks\":" << clocks;
+			ss << ",\"pct\":" << percent(clocks, total) << "}";
+		}
+		ss << "]}";
+	} else if (action == "frames") {
+		uint32_t frameCount = 1;
+		auto framesIt = cmd.params.find("frames");
+		if (framesIt != cmd.params.end()) {
+			int value = 0;
+			if (!TryParseInt(framesIt->second, value) || value <= 0 || value > 600) {
+				resp.success = false;
+				resp.error = "Invalid frames value (1 to 600)";
+				resp.errorCode = SocketErrorCode::InvalidParameter;
+				return resp;
+			}
+			frameCount = (uint32_t)value;
+		}
+
+		// Per-frame time by function (exclusive clocks), top "count" functions per frame
+		DebugBreakHelper helper(debugger);
+		ss << "{\"frames\":[";
+		bool firstFrame = true;
+		for (SampledFrame& frame : profiler->GetFrames(frameCount)) {
+			vector<std::pair<int32_t, uint64_t>> functions(frame.Functions.begin(), frame.Functions.end());
+			std::sort(functions.begin(), functions.end(), [](const std::pair<int32_t, uint64_t>& a, const std::pair<int32_t, uint64_t>& b) {
+				return a.second > b.second;
+			});
+			if (count > 0 && functions.size() > count) {
+				functions.resize(count);
+			}
 
-		ss << "}";
+			if (!firstFrame) ss << ",";
+			firstFrame = false;
+			ss << "{\"frame\":" << frame.Frame << ",\"clocks\":" << frame.TotalClocks << ",\"functions\":[";
+			bool first = true;
+			for (auto& [key, clocks] : functions) {
+				if (!first) ss << ",";
+				first = false;
+				ss << "{";
+				appendFunction(ss, key);
+				ss << ",\"clocks\":" << clocks;
+				ss << ",\"pct\":" << percent(clocks, frame.TotalClocks) << "}";
+			}
+			ss << "]}";
+		}
+		ss << "]}";
+	} else if (action == "export") {
+		auto pathIt = cmd.params.find("path");
+		if (pathIt == cmd.params.end() || pathIt->second.empty()) {
+			resp.success = false;
+			resp.error = "Missing path parameter";
+			resp.errorCode = SocketErrorCode::MissingParameter;
+			return resp;
+		}
+		if (!profiler->ExportFlameGraph(pathIt->second)) {
+			resp.success = false;
+			resp.error = "Could not write file: " + pathIt->second;
+			resp.errorCode = SocketErrorCode::InternalError;
+			return resp;
+		}
+		ss << "{\"path\":\"" << JsonEscape(pathIt->second) << "\",\"stacks\":" << profiler->GetStatus().StackCount << "}";
+	} else {
+		resp.success = false;
+		resp.error = "Unknown action: " + action + " (start/stop/reset/status/functions/addresses/frames/export)";
+		resp.errorCode = SocketErrorCode::InvalidParameter;
+		return resp;
 	}
 
-	ss << "]}";
-
 	resp.success = true;
 	resp.data = ss.str();
 	return resp;
 }
 
 SocketResponse SocketServer::HandleLogpoint(Emulator* emu, const SocketCommand& cmd) {
+	SocketInstanceState& state = *emu->GetSocketState();
 	SocketResponse resp;
 	auto actionIt = cmd.params.find("action");
 	string action = actionIt != cmd.params.end() ? actionIt->second : "list";
 
-	auto lock = _logpointLock.AcquireSafe();
+	auto lock = state.logpointLock.AcquireSafe();
+	state.DrainLogpointHits(emu->GetInstanceId());
 
 	if (action == "add") {
 		auto addrIt = cmd.params.find("addr");
@@ -4492,9 +6434,14 @@ SocketResponse SocketServer::HandleLogpoint(Emulator* emu, const SocketCommand&
 		}
 
 		SocketLogpoint lp;
-		lp.id = _nextLogpointId++;
 		lp.addr = std::stoul(addrIt->second, nullptr, 0);
 		lp.enabled = true;
+		if (lp.addr < 0 || lp.addr >= (1 << LogpointIndex::AddressBits)) {
+			resp.success = false;
+			resp.error = "addr out of range (max 0xFFFFFF)";
+			resp.errorCode = SocketErrorCode::InvalidParameter;
+			return resp;
+		}
 		
 		auto dbg = emu->GetDebugger(true);
 		lp.cpuType = dbg.GetDebugger()->GetMainCpuType();
@@ -4502,14 +6449,33 @@ SocketResponse SocketServer::HandleLogpoint(Emulator* emu, const SocketCommand&
 		auto cpuIt = cmd.params.find("cpu");
 		if (cpuIt != cmd.params.end()) {
 			lp.cpuType = (CpuType)std::stoi(cpuIt->second);
+			if ((int)lp.cpuType >= LogpointIndex::CpuCount) {
+				resp.success = false;
+				resp.error = "Invalid cpu value";
+				resp.errorCode = SocketErrorCode::InvalidParameter;
+				return resp;
+			}
 		}
 
 		auto exprIt = cmd.params.find("expression");
+		if (exprIt == cmd.params.end()) {
+			exprIt = cmd.params.find("expr");
+		}
 		if (exprIt != cmd.params.end()) {
 			lp.expression = exprIt->second;
 		}
 
-		_logpoints.push_back(lp);
+		// Compile the expression once here, hits only evaluate the RPN list
+		if (!lp.expression.empty() && !dbg.GetDebugger()->CompileExpression(lp.expression, lp.cpuType, lp.compiledExpression)) {
+			resp.success = false;
+			resp.error = "Invalid expression: " + lp.expression;
+			resp.errorCode = SocketErrorCode::InvalidParameter;
+			return resp;
+		}
+
+		lp.id = state.nextLogpointId++;
+		state.logpoints.push_back(lp);
+		state.RebuildLogpointIndex();
 		resp.success = true;
 		resp.data = "{\"id\":" + std::to_string(lp.id) + "}";
 	} else if (action == "remove") {
@@ -4521,9 +6487,10 @@ SocketResponse SocketServer::HandleLogpoint(Emulator* emu, const SocketCommand&
 		}
 
 		uint32_t id = std::stoul(idIt->second);
-		auto it = std::remove_if(_logpoints.begin(), _logpoints.end(), [id](const SocketLogpoint& lp) { return lp.id == id; });
-		if (it != _logpoints.end()) {
-			_logpoints.erase(it, _logpoints.end());
+		auto it = std::remove_if(state.logpoints.begin(), state.logpoints.end(), [id](const SocketLogpoint& lp) { return lp.id == id; });
+		if (it != state.logpoints.end()) {
+			state.logpoints.erase(it, state.logpoints.end());
+			state.RebuildLogpointIndex();
 			resp.success = true;
 		} else {
 			resp.success = false;
@@ -4532,9 +6499,9 @@ SocketResponse SocketServer::HandleLogpoint(Emulator* emu, const SocketCommand&
 	} else if (action == "list") {
 		stringstream ss;
 		ss << "{\"logpoints\":[";
-		for (size_t i = 0; i < _logpoints.size(); i++) {
+		for (size_t i = 0; i < state.logpoints.size(); i++) {
 			if (i > 0) ss << ",";
-			const auto& lp = _logpoints[i];
+			const auto& lp = state.logpoints[i];
 			ss << "{\"id\":" << lp.id << ",\"addr\":\"" << FormatHex(lp.addr, 6) << "\",\"cpu\":" << (int)lp.cpuType << ",\"enabled\":" << (lp.enabled ? "true" : "false") << ",\"expression\":\"" << JsonEscape(lp.expression) << "\"}";
 		}
 		ss << "]}";
@@ -4543,16 +6510,16 @@ SocketResponse SocketServer::HandleLogpoint(Emulator* emu, const SocketCommand&
 	} else if (action == "hits") {
 		stringstream ss;
 		ss << "{\"hits\":[";
-		for (size_t i = 0; i < _logpointHits.size(); i++) {
+		for (size_t i = 0; i < state.logpointHits.size(); i++) {
 			if (i > 0) ss << ",";
-			const auto& hit = _logpointHits[i];
+			const auto& hit = state.logpointHits[i];
 			ss << "{\"id\":" << hit.logpointId << ",\"pc\":\"" << FormatHex(hit.pc, 6) << "\",\"cpu\":" << (int)hit.cpuType << ",\"cycles\":" << hit.cycleCount << ",\"value\":\"" << JsonEscape(hit.value) << "\"}";
 		}
-		ss << "]}";
+		ss << "],\"dropped\":" << state.logpointHitsDropped.load() << "}";
 		resp.success = true;
 		resp.data = ss.str();
 	} else if (action == "clear") {
-		_logpointHits.clear();
+		state.logpointHits.clear();
 		resp.success = true;
 	} else {
 		resp.success = false;
@@ -4562,39 +6529,49 @@ SocketResponse SocketServer::HandleLogpoint(Emulator* emu, const SocketCommand&
 	return resp;
 }
 
-void SocketServer::CheckLogpoints(CpuType cpuType, uint32_t pc, Emulator* emu) {
-	auto lock = _logpointLock.AcquireSafe();
-	if (_logpoints.empty()) {
+// Emulation thread - only evaluates the precompiled expressions and queues the hits, DrainLogpointHits() formats them
+void SocketServer::CheckLogpoints(Debugger* debugger, CpuType cpuType, uint32_t pc, Emulator* emu) {
+	SocketInstanceState& state = *emu->GetSocketState();
+	const LogpointIndex* index = state.logpointIndex.load(std::memory_order_acquire);
+	if (!index) {
 		return;
 	}
 
-	for (const auto& lp : _logpoints) {
-		if (lp.enabled && lp.cpuType == cpuType && lp.addr == (int32_t)pc) {
-			LogpointHit hit;
-			hit.logpointId = lp.id;
-			hit.pc = pc;
-			hit.cpuType = cpuType;
-			
-			auto dbg = emu->GetDebugger(true);
-			if (dbg.GetDebugger()) {
-				hit.cycleCount = dbg.GetDebugger()->GetInstructionProgress(cpuType).CurrentCycle;
-				if (!lp.expression.empty()) {
-					EvalResultType resultType;
-					hit.value = std::to_string(dbg.GetDebugger()->EvaluateExpression(lp.expression, cpuType, resultType, false));
-				}
-			}
+	auto it = std::lower_bound(index->entries.begin(), index->entries.end(), std::make_pair(cpuType, pc), [](const LogpointIndex::Entry& entry, const std::pair<CpuType, uint32_t>& key) {
+		return entry.cpuType != key.first ? entry.cpuType < key.first : entry.addr < key.second;
+	});
 
-			_logpointHits.push_back(hit);
-			if (_logpointHits.size() > _logpointHitMaxSize) {
-				_logpointHits.pop_front();
-			}
+	uint64_t cycleCount = debugger->GetInstructionProgress(cpuType).CurrentCycle;
+	for (; it != index->entries.end() && it->cpuType == cpuType && it->addr == pc; it++) {
+		RawLogpointHit hit = {};
+		hit.logpointId = it->logpointId;
+		hit.pc = pc;
+		hit.cpuType = cpuType;
+		hit.cycleCount = cycleCount;
+		if (it->hasExpression) {
+			hit.hasValue = true;
+			hit.value = debugger->EvaluateExpression(it->expression, cpuType, hit.resultType);
+		}
 
-			// Also broadcast as event
-			stringstream ss;
-			ss << "{\"id\":" << hit.logpointId << ",\"pc\":\"" << FormatHex(hit.pc, 6) << "\",\"value\":\"" << JsonEscape(hit.value) << "\"}";
-			BroadcastEvent("LOGPOINT", ss.str());
+		if (!state.rawLogpointHits.TryPush(std::move(hit))) {
+			state.logpointHitsDropped++;
+		}
+	}
+}
+
+// Server thread - formats queued logpoint hits for every instance, returns true if any instance has logpoints
+bool SocketServer::DrainLogpointHits() {
+	bool hasLogpoints = false;
+	for (uint32_t id : GetInstanceIds()) {
+		Emulator* emu = GetInstance(id);
+		SocketInstanceState* state = emu ? emu->GetSocketState() : nullptr;
+		if (state && state->HasLogpoints()) {
+			hasLogpoints = true;
+			auto lock = state->logpointLock.AcquireSafe();
+			state->DrainLogpointHits(id);
 		}
 	}
+	return hasLogpoints;
 }
 
 SocketResponse SocketServer::HandleSubscribe(Emulator* emu, const SocketCommand& cmd) {
@@ -4656,8 +6633,39 @@ SocketResponse SocketServer::HandleSubscribe(Emulator* emu, const SocketCommand&
 			events.insert("all");
 		}
 
+		SocketEventPolicy policy = SocketEventPolicy::Queue;
+		string policyName = NormalizeKey(cmd.GetParam("policy", "queue"));
+		if (policyName == "queue") {
+			policy = SocketEventPolicy::Queue;
+		} else if (policyName == "coalesce") {
+			policy = SocketEventPolicy::Coalesce;
+		} else if (policyName == "drop") {
+			policy = SocketEventPolicy::Drop;
+		} else {
+			resp.success = false;
+			resp.error = "Unknown policy: " + policyName + ". Use queue, coalesce, or drop.";
+			resp.errorCode = SocketErrorCode::InvalidParameter;
+			return resp;
+		}
+
+		size_t maxBufferSize = 1024 * 1024;
+		if (cmd.HasParam("buffer_kb")) {
+			int bufferKb = 0;
+			if (!TryParseInt(cmd.GetParam("buffer_kb"), bufferKb) || bufferKb < 1 || bufferKb > 65536) {
+				resp.success = false;
+				resp.error = "Invalid buffer_kb (1-65536)";
+				resp.errorCode = SocketErrorCode::InvalidParameter;
+				return resp;
+			}
+			maxBufferSize = (size_t)bufferKb * 1024;
+		}
+
 		auto lock = _eventLock.AcquireSafe();
-		_eventSubscriptions[cmd.clientFd] = events;
+		EventSubscriber& subscriber = _eventSubscriptions[cmd.clientFd];
+		subscriber.events = events;
+		subscriber.policy = policy;
+		subscriber.maxBufferSize = maxBufferSize;
+		_eventSubscriberCount = (uint32_t)_eventSubscriptions.size();
 
 		// Build response
 		stringstream ss;
@@ -4668,14 +6676,31 @@ SocketResponse SocketServer::HandleSubscribe(Emulator* emu, const SocketCommand&
 			first = false;
 			ss << "\"" << e << "\"";
 		}
-		ss << "],\"client_fd\":" << cmd.clientFd << "}";
+		ss << "],\"client_fd\":" << cmd.clientFd;
+		ss << ",\"policy\":\"" << policyName << "\"";
+		ss << ",\"buffer_kb\":" << (maxBufferSize / 1024) << "}";
 
 		resp.success = true;
 		resp.data = ss.str();
 	}
 	else if (action == "unsubscribe") {
-		auto lock = _eventLock.AcquireSafe();
-		_eventSubscriptions.erase(cmd.clientFd);
+		string pendingData;
+		{
+			auto lock = _eventLock.AcquireSafe();
+			auto it = _eventSubscriptions.find(cmd.clientFd);
+			if (it != _eventSubscriptions.end()) {
+				EventSubscriber& subscriber = it->second;
+				pendingData = subscriber.outbound.substr(subscriber.outboundOffset) + subscriber.coalescedEvent;
+				_eventSubscriptions.erase(it);
+				_eventSubscriberCount = (uint32_t)_eventSubscriptions.size();
+			}
+		}
+
+		// Don't cut off a partially written event - send the rest before the response
+		// (blocking write, outside _eventLock so a slow client can't stall the other subscribers)
+		if (!pendingData.empty()) {
+			WriteAll(cmd.clientFd, pendingData);
+		}
 		resp.success = true;
 		resp.data = "\"Unsubscribed\"";
 	}
@@ -4703,30 +6728,166 @@ SocketResponse SocketServer::HandleSubscribe(Emulator* emu, const SocketCommand&
 	return resp;
 }
 
-void SocketServer::BroadcastEvent(string eventType, string data) {
-	auto lock = _eventLock.AcquireSafe();
-	if (_eventSubscriptions.empty()) return;
+// Called from the emulation thread (and debugger) - only queues the event, the publisher thread does the rest
+void SocketServer::BroadcastEvent(string eventType, string data, uint32_t instanceId) {
+	if (!HasEventSubscribers()) return;
 
-	stringstream ss;
-	ss << "{\"type\":\"EVENT\",\"event\":\"" << eventType << "\",\"data\":" << data << "}\n";
-	string eventJson = ss.str();
+	if (!_eventQueue.TryPush({ std::move(eventType), std::move(data), instanceId })) {
+		_eventsDroppedQueueFull++;
+		return;
+	}
+
+	if (_eventThreadIdle.load(std::memory_order_acquire)) {
+		_eventSignal.Signal();
+	}
+}
+
+void SocketServer::EventLoop() {
+	bool hasPendingData = false;
+	while (_running) {
+		_eventThreadIdle = true;
+		if (_eventQueue.GetSize() == 0) {
+			// Poll more often while some subscriber still has unsent data
+			_eventSignal.Wait(hasPendingData ? 2 : 50);
+		}
+		_eventThreadIdle = false;
+
+		auto lock = _eventLock.AcquireSafe();
+		SocketEvent evt;
+		while (_eventQueue.TryPop(evt)) {
+			DispatchEvent(evt);
+			_eventsPublished++;
+		}
+
+		hasPendingData = false;
+		for (auto it = _eventSubscriptions.begin(); it != _eventSubscriptions.end(); ) {
+			if (!FlushSubscriber(it->first, it->second)) {
+				// Connection is broken, the server loop will close it
+				it = _eventSubscriptions.erase(it);
+				_eventSubscriberCount = (uint32_t)_eventSubscriptions.size();
+				continue;
+			}
+			hasPendingData |= it->second.GetPendingSize() > 0;
+			++it;
+		}
+	}
+}
 
-	// Convert eventType to lowercase for matching
-	string eventTypeLower = eventType;
+// Appends the event to each matching subscriber's outbound buffer (caller must hold _eventLock)
+void SocketServer::DispatchEvent(const SocketEvent& evt) {
+	string eventTypeLower = evt.type;
 	std::transform(eventTypeLower.begin(), eventTypeLower.end(), eventTypeLower.begin(), [](unsigned char c) {
 		return static_cast<char>(std::tolower(c));
 	});
 
-	for (auto it = _eventSubscriptions.begin(); it != _eventSubscriptions.end(); ) {
-		int clientFd = it->first;
-		const auto& subscribedEvents = it->second;
-		bool shouldSend = subscribedEvents.count("all") > 0 || subscribedEvents.count(eventTypeLower) > 0;
-		if (shouldSend && !WriteAll(clientFd, eventJson)) {
-			it = _eventSubscriptions.erase(it);
+	string eventJson;
+	eventJson.reserve(evt.type.size() + evt.data.size() + 40);
+	eventJson += "{\"type\":\"EVENT\",\"event\":\"";
+	eventJson += evt.type;
+	eventJson += "\",\"data\":";
+	eventJson += evt.data;
+	if (evt.instanceId != 0) {
+		eventJson += ",\"instance\":";
+		eventJson += std::to_string(evt.instanceId);
+	}
+	eventJson += "}\n";
+
+	// Only the primary instance's frames are coalesced - each instance has its own frame counter
+	bool isCoalescable = eventTypeLower == "frame_complete" && evt.instanceId == 0;
+
+	for (auto& [clientFd, subscriber] : _eventSubscriptions) {
+		if (subscriber.events.count("all") == 0 && subscriber.events.count(eventTypeLower) == 0) {
 			continue;
 		}
-		++it;
+
+		size_t pendingSize = subscriber.outbound.size() - subscriber.outboundOffset;
+		if (subscriber.policy == SocketEventPolicy::Drop && subscriber.GetPendingSize() > 0) {
+			subscriber.droppedCount++;
+			continue;
+		}
+
+		if (subscriber.policy == SocketEventPolicy::Coalesce && isCoalescable && pendingSize > 0) {
+			// Replace any older pending frame_complete, it's sent once the buffer drains
+			if (!subscriber.coalescedEvent.empty()) {
+				subscriber.coalescedCount++;
+			}
+			subscriber.coalescedEvent = eventJson;
+			continue;
+		}
+
+		if (subscriber.GetPendingSize() + eventJson.size() > subscriber.maxBufferSize) {
+			subscriber.droppedCount++;
+			continue;
+		}
+
+		subscriber.outbound += eventJson;
+		subscriber.sentCount++;
+	}
+}
+
+// Writes as much pending data as the socket accepts without blocking (caller must hold _eventLock)
+// Returns false if the connection is broken
+bool SocketServer::FlushSubscriber(int clientFd, EventSubscriber& subscriber) {
+	while (true) {
+		if (subscriber.outboundOffset >= subscriber.outbound.size()) {
+			subscriber.outbound.clear();
+			subscriber.outboundOffset = 0;
+			if (subscriber.coalescedEvent.empty()) {
+				return true;
+			}
+			subscriber.outbound.swap(subscriber.coalescedEvent);
+			subscriber.sentCount++;
+		}
+
+		ssize_t result = SendSome(clientFd, subscriber.outbound.data() + subscriber.outboundOffset, subscriber.outbound.size() - subscriber.outboundOffset);
+		if (result < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			if (errno == EAGAIN || errno == EWOULDBLOCK) {
+				// Socket buffer is full, try again later
+				if (subscriber.outboundOffset > 64 * 1024) {
+					subscriber.outbound.erase(0, subscriber.outboundOffset);
+					subscriber.outboundOffset = 0;
+				}
+				return true;
+			}
+			return false;
+		}
+		if (result == 0) {
+			return false;
+		}
+		subscriber.outboundOffset += (size_t)result;
+	}
+}
+
+// Writes a command response, keeping it ordered with any events still queued for this client
+bool SocketServer::SendToClient(int clientFd, const string& data) {
+	{
+		auto lock = _eventLock.AcquireSafe();
+		auto it = _eventSubscriptions.find(clientFd);
+		if (it != _eventSubscriptions.end()) {
+			// Responses bypass the buffer limit and drop policy
+			EventSubscriber& subscriber = it->second;
+			subscriber.outbound += data;
+			if (!FlushSubscriber(clientFd, subscriber)) {
+				_eventSubscriptions.erase(it);
+				_eventSubscriberCount = (uint32_t)_eventSubscriptions.size();
+				return false;
+			}
+			if (subscriber.GetPendingSize() > 0) {
+				_eventSignal.Signal();
+			}
+			return true;
+		}
 	}
+	return WriteAll(clientFd, data);
+}
+
+void SocketServer::RemoveSubscriber(int clientFd) {
+	auto lock = _eventLock.AcquireSafe();
+	_eventSubscriptions.erase(clientFd);
+	_eventSubscriberCount = (uint32_t)_eventSubscriptions.size();
 }
 
 // ============================================================================
@@ -4734,6 +6895,7 @@ void SocketServer::BroadcastEvent(string eventType, string data) {
 // ============================================================================
 
 SocketResponse SocketServer::HandlePWatch(Emulator* emu, const SocketCommand& cmd) {
+	SocketInstanceState& state = *emu->GetSocketState();
 	SocketResponse resp;
 
 	string action = "start";
@@ -4751,17 +6913,17 @@ SocketResponse SocketServer::HandlePWatch(Emulator* emu, const SocketCommand& cm
 			if (depth > 100000) depth = 100000;
 		}
 
-		auto lock = _pRegisterLock.AcquireSafe();
-		_pRegisterLogMaxSize = depth;
-		_pRegisterWatchEnabled = true;
-		_pRegisterLog.clear();
+		auto lock = state.pRegisterLock.AcquireSafe();
+		state.pRegisterLogMaxSize = depth;
+		state.pRegisterWatchEnabled = true;
+		state.pRegisterLog.clear();
 
 		// Initialize last P register from current CPU state if available
 		if (emu && emu->IsRunning()) {
 			auto dbg = emu->GetDebugger(false);
 			if (dbg.GetDebugger()) {
 				SnesCpuState& cpu = static_cast<SnesCpuState&>(dbg.GetDebugger()->GetCpuStateRef(CpuType::Snes));
-				_lastPRegister = cpu.PS;
+				state.lastPRegister = cpu.PS;
 			}
 		}
 
@@ -4771,18 +6933,18 @@ SocketResponse SocketServer::HandlePWatch(Emulator* emu, const SocketCommand& cm
 		resp.data = ss.str();
 	}
 	else if (action == "stop") {
-		auto lock = _pRegisterLock.AcquireSafe();
-		_pRegisterWatchEnabled = false;
+		auto lock = state.pRegisterLock.AcquireSafe();
+		state.pRegisterWatchEnabled = false;
 
 		resp.success = true;
 		resp.data = "{\"enabled\":false}";
 	}
 	else if (action == "status") {
-		auto lock = _pRegisterLock.AcquireSafe();
+		auto lock = state.pRegisterLock.AcquireSafe();
 		stringstream ss;
-		ss << "{\"enabled\":" << (_pRegisterWatchEnabled ? "true" : "false");
-		ss << ",\"depth\":" << _pRegisterLogMaxSize;
-		ss << ",\"count\":" << _pRegisterLog.size() << "}";
+		ss << "{\"enabled\":" << (state.pRegisterWatchEnabled ? "true" : "false");
+		ss << ",\"depth\":" << state.pRegisterLogMaxSize;
+		ss << ",\"count\":" << state.pRegisterLog.size() << "}";
 		resp.success = true;
 		resp.data = ss.str();
 	}
@@ -4795,6 +6957,7 @@ SocketResponse SocketServer::HandlePWatch(Emulator* emu, const SocketCommand& cm
 }
 
 SocketResponse SocketServer::HandlePLog(Emulator* emu, const SocketCommand& cmd) {
+	SocketInstanceState& state = *emu->GetSocketState();
 	SocketResponse resp;
 	(void)emu;
 
@@ -4804,15 +6967,15 @@ SocketResponse SocketServer::HandlePLog(Emulator* emu, const SocketCommand& cmd)
 		count = std::stoul(countIt->second);
 	}
 
-	auto lock = _pRegisterLock.AcquireSafe();
+	auto lock = state.pRegisterLock.AcquireSafe();
 
 	stringstream ss;
 	ss << "{\"entries\":[";
 
 	uint32_t outputCount = 0;
 	// Output from most recent to oldest
-	auto it = _pRegisterLog.rbegin();
-	while (it != _pRegisterLog.rend() && outputCount < count) {
+	auto it = state.pRegisterLog.rbegin();
+	while (it != state.pRegisterLog.rend() && outputCount < count) {
 		if (outputCount > 0) ss << ",";
 
 		ss << "{\"pc\":\"0x" << hex << uppercase << setw(6) << setfill('0') << it->pc << "\"";
@@ -4841,7 +7004,7 @@ SocketResponse SocketServer::HandlePLog(Emulator* emu, const SocketCommand& cmd)
 		++outputCount;
 	}
 
-	ss << "],\"total\":" << _pRegisterLog.size();
+	ss << "],\"total\":" << state.pRegisterLog.size();
 	ss << ",\"returned\":" << outputCount << "}";
 
 	resp.success = true;
@@ -4850,6 +7013,7 @@ SocketResponse SocketServer::HandlePLog(Emulator* emu, const SocketCommand& cmd)
 }
 
 SocketResponse SocketServer::HandlePAssert(Emulator* emu, const SocketCommand& cmd) {
+	SocketInstanceState& state = *emu->GetSocketState();
 	SocketResponse resp;
 
 	if (!emu || !emu->IsRunning()) {
@@ -4909,8 +7073,8 @@ SocketResponse SocketServer::HandlePAssert(Emulator* emu, const SocketCommand& c
 	string condition = condSS.str();
 
 	// Add the breakpoint using existing infrastructure
-	auto lock = _breakpointLock.AcquireSafe();
-	uint32_t newId = _nextBreakpointId++;
+	auto lock = state.breakpointLock.AcquireSafe();
+	uint32_t newId = state.nextBreakpointId++;
 
 	SocketBreakpoint sbp;
 	sbp.id = newId;
@@ -4922,7 +7086,7 @@ SocketResponse SocketServer::HandlePAssert(Emulator* emu, const SocketCommand& c
 	sbp.enabled = true;
 	sbp.condition = condition;
 
-	_breakpoints.push_back(sbp);
+	state.breakpoints.push_back(sbp);
 	lock.Release();
 
 	SyncBreakpoints(emu);
@@ -4944,6 +7108,7 @@ SocketResponse SocketServer::HandlePAssert(Emulator* emu, const SocketCommand& c
 // ============================================================================
 
 SocketResponse SocketServer::HandleMemWatchWrites(Emulator* emu, const SocketCommand& cmd) {
+	SocketInstanceState& state = *emu->GetSocketState();
 	SocketResponse resp;
 	(void)emu;
 
@@ -4990,8 +7155,8 @@ SocketResponse SocketServer::HandleMemWatchWrites(Emulator* emu, const SocketCom
 		}
 
 		// Create watch region
-		auto lock = _memoryWatchLock.AcquireSafe();
-		uint32_t newId = _nextMemoryWatchId++;
+		auto lock = state.memoryWatchLock.AcquireSafe();
+		uint32_t newId = state.nextMemoryWatchId++;
 
 		MemoryWatchRegion watch;
 		watch.id = newId;
@@ -4999,8 +7164,9 @@ SocketResponse SocketServer::HandleMemWatchWrites(Emulator* emu, const SocketCom
 		watch.endAddr = addr + size - 1;
 		watch.maxDepth = depth;
 
-		_memoryWatches.push_back(watch);
-		_memoryWriteLog[newId] = std::deque<MemoryWriteRecord>();
+		state.memoryWatches.push_back(watch);
+		state.memoryWriteLog[newId].Init(depth);
+		state.RebuildMemoryWatchIndex();
 
 		stringstream ss;
 		ss << "{\"watch_id\":" << newId;
@@ -5021,13 +7187,14 @@ SocketResponse SocketServer::HandleMemWatchWrites(Emulator* emu, const SocketCom
 
 		uint32_t watchId = std::stoul(idIt->second);
 
-		auto lock = _memoryWatchLock.AcquireSafe();
-		auto it = std::find_if(_memoryWatches.begin(), _memoryWatches.end(),
+		auto lock = state.memoryWatchLock.AcquireSafe();
+		auto it = std::find_if(state.memoryWatches.begin(), state.memoryWatches.end(),
 			[watchId](const MemoryWatchRegion& w) { return w.id == watchId; });
 
-		if (it != _memoryWatches.end()) {
-			_memoryWatches.erase(it);
-			_memoryWriteLog.erase(watchId);
+		if (it != state.memoryWatches.end()) {
+			state.memoryWatches.erase(it);
+			state.RebuildMemoryWatchIndex();
+			state.memoryWriteLog.erase(watchId);
 			resp.success = true;
 			resp.data = "\"OK\"";
 		} else {
@@ -5036,20 +7203,20 @@ SocketResponse SocketServer::HandleMemWatchWrites(Emulator* emu, const SocketCom
 		}
 	}
 	else if (action == "list") {
-		auto lock = _memoryWatchLock.AcquireSafe();
+		auto lock = state.memoryWatchLock.AcquireSafe();
 
 		stringstream ss;
 		ss << "{\"watches\":[";
 		bool first = true;
-		for (const auto& w : _memoryWatches) {
+		for (const auto& w : state.memoryWatches) {
 			if (!first) ss << ",";
 			first = false;
 			ss << "{\"watch_id\":" << w.id;
 			ss << ",\"addr\":\"0x" << hex << uppercase << setw(6) << setfill('0') << w.startAddr << "\"";
 			ss << ",\"end_addr\":\"0x" << hex << uppercase << setw(6) << setfill('0') << w.endAddr << "\"";
 			ss << dec << ",\"depth\":" << w.maxDepth;
-			auto logIt = _memoryWriteLog.find(w.id);
-			ss << ",\"log_count\":" << (logIt != _memoryWriteLog.end() ? logIt->second.size() : 0);
+			auto logIt = state.memoryWriteLog.find(w.id);
+			ss << ",\"log_count\":" << (logIt != state.memoryWriteLog.end() ? logIt->second.count : 0);
 			ss << "}";
 		}
 		ss << "]}";
@@ -5058,9 +7225,10 @@ SocketResponse SocketServer::HandleMemWatchWrites(Emulator* emu, const SocketCom
 		resp.data = ss.str();
 	}
 	else if (action == "clear") {
-		auto lock = _memoryWatchLock.AcquireSafe();
-		_memoryWatches.clear();
-		_memoryWriteLog.clear();
+		auto lock = state.memoryWatchLock.AcquireSafe();
+		state.memoryWatches.clear();
+		state.RebuildMemoryWatchIndex();
+		state.memoryWriteLog.clear();
 		resp.success = true;
 		resp.data = "\"OK\"";
 	}
@@ -5073,6 +7241,7 @@ SocketResponse SocketServer::HandleMemWatchWrites(Emulator* emu, const SocketCom
 }
 
 SocketResponse SocketServer::HandleMemBlame(Emulator* emu, const SocketCommand& cmd) {
+	SocketInstanceState& state = *emu->GetSocketState();
 	SocketResponse resp;
 	(void)emu;
 
@@ -5081,21 +7250,21 @@ SocketResponse SocketServer::HandleMemBlame(Emulator* emu, const SocketCommand&
 	if (watchIdIt != cmd.params.end()) {
 		uint32_t watchId = std::stoul(watchIdIt->second);
 
-		auto lock = _memoryWatchLock.AcquireSafe();
-		auto logIt = _memoryWriteLog.find(watchId);
-		if (logIt == _memoryWriteLog.end()) {
+		auto lock = state.memoryWatchLock.AcquireSafe();
+		auto logIt = state.memoryWriteLog.find(watchId);
+		if (logIt == state.memoryWriteLog.end()) {
 			resp.success = false;
 			resp.error = "Watch not found: " + std::to_string(watchId);
 			return resp;
 		}
 
 		// Output the write log
+		const MemoryWriteRing& ring = logIt->second;
 		stringstream ss;
 		ss << "{\"writes\":[";
-		bool first = true;
-		for (const auto& rec : logIt->second) {
-			if (!first) ss << ",";
-			first = false;
+		for (uint32_t i = 0; i < ring.count; i++) {
+			const MemoryWriteRecord& rec = ring.Get(i);
+			if (i > 0) ss << ",";
 			ss << "{\"pc\":\"0x" << hex << uppercase << setw(6) << setfill('0') << rec.pc << "\"";
 			ss << ",\"addr\":\"0x" << hex << uppercase << setw(6) << setfill('0') << rec.addr << "\"";
 			ss << ",\"value\":\"0x" << hex << uppercase << setw(rec.size * 2) << setfill('0') << rec.value << "\"";
@@ -5104,7 +7273,7 @@ SocketResponse SocketServer::HandleMemBlame(Emulator* emu, const SocketCommand&
 			ss << dec << ",\"cycle\":" << rec.cycleCount;
 			ss << "}";
 		}
-		ss << "],\"count\":" << logIt->second.size() << "}";
+		ss << "],\"count\":" << ring.count << "}";
 
 		resp.success = true;
 		resp.data = ss.str();
@@ -5128,14 +7297,16 @@ SocketResponse SocketServer::HandleMemBlame(Emulator* emu, const SocketCommand&
 	}
 
 	// Find watches covering this address and collect writes
-	auto lock = _memoryWatchLock.AcquireSafe();
+	auto lock = state.memoryWatchLock.AcquireSafe();
 	vector<MemoryWriteRecord> matchingWrites;
 
-	for (const auto& w : _memoryWatches) {
+	for (const auto& w : state.memoryWatches) {
 		if (addr >= w.startAddr && addr <= w.endAddr) {
-			auto logIt = _memoryWriteLog.find(w.id);
-			if (logIt != _memoryWriteLog.end()) {
-				for (const auto& rec : logIt->second) {
+			auto logIt = state.memoryWriteLog.find(w.id);
+			if (logIt != state.memoryWriteLog.end()) {
+				const MemoryWriteRing& ring = logIt->second;
+				for (uint32_t i = 0; i < ring.count; i++) {
+					const MemoryWriteRecord& rec = ring.Get(i);
 					if (rec.addr == addr) {
 						matchingWrites.push_back(rec);
 					}
@@ -5171,6 +7342,7 @@ SocketResponse SocketServer::HandleMemBlame(Emulator* emu, const SocketCommand&
 // ============================================================================
 
 SocketResponse SocketServer::HandleSymbolsLoad(Emulator* emu, const SocketCommand& cmd) {
+	SocketInstanceState& state = *emu->GetSocketState();
 	SocketResponse resp;
 	(void)emu;
 
@@ -5197,12 +7369,12 @@ SocketResponse SocketServer::HandleSymbolsLoad(Emulator* emu, const SocketComman
 
 	// Simple JSON parsing for symbol file
 	// Expected format: {"SymbolName": {"addr": "7E0022", "size": 2, "type": "word"}, ...}
-	auto lock = _symbolLock.AcquireSafe();
+	auto lock = state.symbolLock.AcquireSafe();
 
 	// Clear existing symbols if requested
 	auto clearIt = cmd.params.find("clear");
 	if (clearIt != cmd.params.end() && (clearIt->second == "true" || clearIt->second == "1")) {
-		_symbolTable.clear();
+		state.symbolTable.clear();
 	}
 
 	// Parse the JSON (basic parsing)
@@ -5279,18 +7451,19 @@ SocketResponse SocketServer::HandleSymbolsLoad(Emulator* emu, const SocketComman
 		entry.addr = addr;
 		entry.size = size;
 		entry.type = type;
-		_symbolTable[symbolName] = entry;
+		state.symbolTable[symbolName] = entry;
 		count++;
 	}
 
 	stringstream ss;
-	ss << "{\"loaded\":" << count << ",\"total\":" << _symbolTable.size() << "}";
+	ss << "{\"loaded\":" << count << ",\"total\":" << state.symbolTable.size() << "}";
 	resp.success = true;
 	resp.data = ss.str();
 	return resp;
 }
 
 SocketResponse SocketServer::HandleSymbolsResolve(Emulator* emu, const SocketCommand& cmd) {
+	SocketInstanceState& state = *emu->GetSocketState();
 	SocketResponse resp;
 	(void)emu;
 
@@ -5303,9 +7476,9 @@ SocketResponse SocketServer::HandleSymbolsResolve(Emulator* emu, const SocketCom
 
 	string symbolName = symbolIt->second;
 
-	auto lock = _symbolLock.AcquireSafe();
-	auto it = _symbolTable.find(symbolName);
-	if (it == _symbolTable.end()) {
+	auto lock = state.symbolLock.AcquireSafe();
+	auto it = state.symbolTable.find(symbolName);
+	if (it == state.symbolTable.end()) {
 		resp.success = false;
 		resp.error = "Symbol not found: " + symbolName;
 		return resp;
@@ -5327,47 +7500,44 @@ SocketResponse SocketServer::HandleSymbolsResolve(Emulator* emu, const SocketCom
 // Collision Overlay Handlers
 // ============================================================================
 
-// Static state for collision overlay
-static bool _collisionOverlayEnabled = false;
-static string _collisionOverlayMode = "A";  // "A", "B", or "both"
-static vector<uint8_t> _collisionHighlightTiles;
 
 // Collision overlay getters for WatchHud
-bool SocketServer::IsCollisionOverlayEnabled() {
-	return _collisionOverlayEnabled;
+bool SocketServer::IsCollisionOverlayEnabled(Emulator* emu) {
+	return emu->GetSocketState()->collisionOverlayEnabled;
 }
 
-string SocketServer::GetCollisionOverlayMode() {
-	return _collisionOverlayMode;
+string SocketServer::GetCollisionOverlayMode(Emulator* emu) {
+	return emu->GetSocketState()->collisionOverlayMode;
 }
 
-const vector<uint8_t>& SocketServer::GetCollisionHighlightTiles() {
-	return _collisionHighlightTiles;
+const vector<uint8_t>& SocketServer::GetCollisionHighlightTiles(Emulator* emu) {
+	return emu->GetSocketState()->collisionHighlightTiles;
 }
 
 SocketResponse SocketServer::HandleCollisionOverlay(Emulator* emu, const SocketCommand& cmd) {
+	SocketInstanceState& state = *emu->GetSocketState();
 	SocketResponse resp;
 	(void)emu;
 
 	// Check for enabled parameter
 	auto enabledIt = cmd.params.find("enabled");
 	if (enabledIt != cmd.params.end()) {
-		_collisionOverlayEnabled = (enabledIt->second == "true" || enabledIt->second == "1");
+		state.collisionOverlayEnabled = (enabledIt->second == "true" || enabledIt->second == "1");
 	}
 
 	// Check for colmap parameter
 	auto colmapIt = cmd.params.find("colmap");
 	if (colmapIt != cmd.params.end()) {
 		string mode = colmapIt->second;
-		if (mode == "A" || mode == "a") _collisionOverlayMode = "A";
-		else if (mode == "B" || mode == "b") _collisionOverlayMode = "B";
-		else if (mode == "both" || mode == "BOTH") _collisionOverlayMode = "both";
+		if (mode == "A" || mode == "a") state.collisionOverlayMode = "A";
+		else if (mode == "B" || mode == "b") state.collisionOverlayMode = "B";
+		else if (mode == "both" || mode == "BOTH") state.collisionOverlayMode = "both";
 	}
 
 	// Check for highlight parameter (array of tile types to highlight)
 	auto highlightIt = cmd.params.find("highlight");
 	if (highlightIt != cmd.params.end()) {
-		_collisionHighlightTiles.clear();
+		state.collisionHighlightTiles.clear();
 		// Parse comma-separated list of hex values
 		string highlights = highlightIt->second;
 		// Remove brackets if present
@@ -5396,19 +7566,19 @@ SocketResponse SocketServer::HandleCollisionOverlay(Emulator* emu, const SocketC
 				} else {
 					tileType = static_cast<uint8_t>(std::stoul(val, nullptr, 16));
 				}
-				_collisionHighlightTiles.push_back(tileType);
+				state.collisionHighlightTiles.push_back(tileType);
 			}
 			pos = end + 1;
 		}
 	}
 
 	stringstream ss;
-	ss << "{\"enabled\":" << (_collisionOverlayEnabled ? "true" : "false");
-	ss << ",\"colmap\":\"" << _collisionOverlayMode << "\"";
+	ss << "{\"enabled\":" << (state.collisionOverlayEnabled ? "true" : "false");
+	ss << ",\"colmap\":\"" << state.collisionOverlayMode << "\"";
 	ss << ",\"highlight\":[";
-	for (size_t i = 0; i < _collisionHighlightTiles.size(); i++) {
+	for (size_t i = 0; i < state.collisionHighlightTiles.size(); i++) {
 		if (i > 0) ss << ",";
-		ss << "\"0x" << hex << uppercase << setw(2) << setfill('0') << (int)_collisionHighlightTiles[i] << "\"";
+		ss << "\"0x" << hex << uppercase << setw(2) << setfill('0') << (int)state.collisionHighlightTiles[i] << "\"";
 	}
 	ss << "]}";
 
@@ -5485,33 +7655,39 @@ static const char* Base64Chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrst
 
 static string Base64Encode(const vector<uint8_t>& data) {
 	string result;
-	result.reserve((data.size() * 4 / 3) + 4);
+	AppendBase64(result, data.data(), data.size());
+	return result;
+}
+
+// Encodes straight into the end of out (resized once, no per-character appends)
+static void AppendBase64(string& out, const uint8_t* data, size_t size) {
+	size_t start = out.size();
+	out.resize(start + (size + 2) / 3 * 4);
+	char* dst = &out[start];
 
 	size_t i = 0;
-	while (i + 2 < data.size()) {
+	for (; i + 2 < size; i += 3) {
 		uint32_t n = (data[i] << 16) | (data[i + 1] << 8) | data[i + 2];
-		result.push_back(Base64Chars[(n >> 18) & 0x3F]);
-		result.push_back(Base64Chars[(n >> 12) & 0x3F]);
-		result.push_back(Base64Chars[(n >> 6) & 0x3F]);
-		result.push_back(Base64Chars[n & 0x3F]);
-		i += 3;
+		dst[0] = Base64Chars[(n >> 18) & 0x3F];
+		dst[1] = Base64Chars[(n >> 12) & 0x3F];
+		dst[2] = Base64Chars[(n >> 6) & 0x3F];
+		dst[3] = Base64Chars[n & 0x3F];
+		dst += 4;
 	}
 
-	if (i + 1 == data.size()) {
+	if (i + 1 == size) {
 		uint32_t n = data[i] << 16;
-		result.push_back(Base64Chars[(n >> 18) & 0x3F]);
-		result.push_back(Base64Chars[(n >> 12) & 0x3F]);
-		result.push_back('=');
-		result.push_back('=');
-	} else if (i + 2 == data.size()) {
+		dst[0] = Base64Chars[(n >> 18) & 0x3F];
+		dst[1] = Base64Chars[(n >> 12) & 0x3F];
+		dst[2] = '=';
+		dst[3] = '=';
+	} else if (i + 2 == size) {
 		uint32_t n = (data[i] << 16) | (data[i + 1] << 8);
-		result.push_back(Base64Chars[(n >> 18) & 0x3F]);
-		result.push_back(Base64Chars[(n >> 12) & 0x3F]);
-		result.push_back(Base64Chars[(n >> 6) & 0x3F]);
-		result.push_back('=');
+		dst[0] = Base64Chars[(n >> 18) & 0x3F];
+		dst[1] = Base64Chars[(n >> 12) & 0x3F];
+		dst[2] = Base64Chars[(n >> 6) & 0x3F];
+		dst[3] = '=';
 	}
-
-	return result;
 }
 
 static string Base64Decode(const string& encoded) {
@@ -5661,6 +7837,7 @@ SocketResponse SocketServer::HandleHelp(Emulator* emu, const SocketCommand& cmd)
 			{"RESUME", "Resume emulation", "", "{\"type\":\"RESUME\"}"},
 			{"RESET", "Reset the emulator", "", "{\"type\":\"RESET\"}"},
 			{"FRAME", "Run one frame", "", "{\"type\":\"FRAME\"}"},
+			{"RUN_FRAMES", "Run N frames headless at uncapped speed with scripted input, returning memory samples", "frames, input (BUTTONS*N;...), loop, player, reads (memtype:addr:len,...), stride, render, instances (ids or all, run in parallel)", "{\"type\":\"RUN_FRAMES\",\"frames\":\"600\",\"input\":\"RIGHT*30;A,RIGHT*2\",\"reads\":\"wram:0x0022:2\",\"stride\":\"60\"}"},
 			{"STEP", "Step one instruction", "count (optional)", "{\"type\":\"STEP\",\"count\":\"10\"}"},
 			{"READ", "Read 1 byte from memory", "addr, memtype (optional)", "{\"type\":\"READ\",\"addr\":\"0x7E0022\"}"},
 			{"READ16", "Read 2 bytes (little-endian word)", "addr, memtype (optional)", "{\"type\":\"READ16\",\"addr\":\"0x7E0022\"}"},
@@ -5671,16 +7848,19 @@ SocketResponse SocketServer::HandleHelp(Emulator* emu, const SocketCommand& cmd)
 			{"WRITEBLOCK", "Write N bytes from hex string", "addr, hex, memtype (optional)", "{\"type\":\"WRITEBLOCK\",\"addr\":\"0x7E0000\",\"hex\":\"A9008D\"}"},
 			{"CPU", "Get compact CPU register state", "", "{\"type\":\"CPU\"}"},
 			{"DISASM", "Disassemble at address", "addr, count (optional), cputype (optional)", "{\"type\":\"DISASM\",\"addr\":\"0x008000\",\"count\":\"10\"}"},
+			{"DISASM_EXPORT", "Export the CDL-based disassembly of a whole ROM to a file (incremental)", "path, memtype (optional, default: main CPU PRG ROM), full (optional, disassemble all blocks)", "{\"type\":\"DISASM_EXPORT\",\"path\":\"game.asm\"}"},
 			{"BREAKPOINT", "Manage breakpoints", "action (add/list/remove/enable/disable/clear), addr, bptype, condition", "{\"type\":\"BREAKPOINT\",\"action\":\"add\",\"addr\":\"0x008000\",\"bptype\":\"exec\"}"},
-			{"TRACE", "Get or control execution trace log", "action (start/stop/status/clear) or count/offset; format/condition/labels/indent", "{\"type\":\"TRACE\",\"action\":\"start\",\"clear\":\"true\"}"},
+			{"TRACE_QUERY", "Record execution into a columnar trace store and filter it", "action (start/stop/clear/status/query); max_rows; pc/addr/opcode/a/x/y/sp/ps/frame (value or min-max), cpu, frames, count, start_row", "{\"type\":\"TRACE_QUERY\",\"addr\":\"0x7E0022\",\"frames\":\"600\"}"},
+			{"PROFILER", "Sampling profiler: PC + callstack every N clocks, per-function/per-frame time, flame graph export", "action (start/stop/reset/status/functions/addresses/frames/export); cpu, interval (start); count; frames; path (export)", "{\"type\":\"PROFILER\",\"action\":\"frames\",\"frames\":\"10\"}"},
+			{"TRACE", "Get or control execution trace log", "action (start/stop/status/clear/file_start/file_stop/read/convert) or count/offset; format/condition/labels/indent; path/binary/output", "{\"type\":\"TRACE\",\"action\":\"start\",\"clear\":\"true\"}"},
 			{"BATCH", "Execute multiple commands at once", "commands (JSON array as string)", "{\"type\":\"BATCH\",\"commands\":\"[{\\\"type\\\":\\\"PING\\\"}]\"}"},
-			{"SCREENSHOT", "Capture screen as base64 PNG", "", "{\"type\":\"SCREENSHOT\"}"},
-			{"SAVESTATE", "Save state to slot or file", "slot or path, label (optional), pause (optional), allow_external (optional)", "{\"type\":\"SAVESTATE\",\"slot\":\"1\",\"label\":\"Boss room\",\"pause\":\"true\"}"},
+			{"SCREENSHOT", "Capture screen as base64 PNG (default), QOI or raw ARGB, encoded on a worker thread", "format (png/qoi/raw), level (png 0-10, default 1), x/y/width/height (crop), downscale (1-8), encoding (base64/binary, binary protocol only)", "{\"type\":\"SCREENSHOT\",\"format\":\"qoi\",\"downscale\":\"2\"}"},
+			{"SAVESTATE", "Save state to slot or file", "slot or path, label (optional), pause (optional), allow_external (optional), compression (optional: zlib|lz4, default zlib)", "{\"type\":\"SAVESTATE\",\"slot\":\"1\",\"label\":\"Boss room\",\"pause\":\"true\"}"},
 			{"SAVESTATE_LABEL", "Get/set save state labels", "action (get/set/clear), slot or path, label (set only)", "{\"type\":\"SAVESTATE_LABEL\",\"action\":\"set\",\"slot\":\"1\",\"label\":\"Boss room\"}"},
 			{"LOADSTATE", "Load state from slot or file", "slot or path, pause (optional), allow_external (optional)", "{\"type\":\"LOADSTATE\",\"slot\":\"1\",\"pause\":\"true\"}"},
 			{"SNAPSHOT", "Create memory snapshot for diff", "name, memtype (optional)", "{\"type\":\"SNAPSHOT\",\"name\":\"before\"}"},
 			{"DIFF", "Compare current memory to snapshot", "snapshot", "{\"type\":\"DIFF\",\"snapshot\":\"before\"}"},
-			{"SEARCH", "Search memory for byte pattern", "pattern, memtype, start, end", "{\"type\":\"SEARCH\",\"pattern\":\"A9 00 8D\"}"},
+			{"SEARCH", "Search memory for a byte pattern, a value, or changes since a snapshot", "mode (pattern/value/changed/unchanged/increased/decreased), pattern (?? = wildcard), value, width, snapshot, memtype, start, end, align, within, save, offset, limit", "{\"type\":\"SEARCH\",\"pattern\":\"A9 ?? 8D\"}"},
 			{"LABELS", "Manage debug labels", "action (set/get/lookup/clear)", "{\"type\":\"LABELS\",\"action\":\"lookup\",\"addr\":\"0x008000\"}"},
 			{"P_WATCH", "Enable/disable P register change tracking", "action (start/stop/status), depth", "{\"type\":\"P_WATCH\",\"action\":\"start\",\"depth\":\"500\"}"},
 			{"P_LOG", "Get recent P register changes", "count", "{\"type\":\"P_LOG\",\"count\":\"50\"}"},
@@ -5702,6 +7882,9 @@ SocketResponse SocketServer::HandleHelp(Emulator* emu, const SocketCommand& cmd)
 			{"SUBSCRIBE", "Subscribe to event notifications", "events (array)", "{\"type\":\"SUBSCRIBE\",\"events\":\"[\\\"breakpoint_hit\\\"]\"}"},
 			{"LOADSCRIPT", "Load Lua script", "path or content", "{\"type\":\"LOADSCRIPT\",\"path\":\"/path/to/script.lua\"}"},
 			{"HELP", "Get API help", "command (optional)", "{\"type\":\"HELP\",\"command\":\"BREAKPOINT\"}"},
+			{"PROTOCOL", "Switch this connection to the binary framed protocol", "mode (json/binary)", "{\"type\":\"PROTOCOL\",\"mode\":\"binary\"}"},
+			{"SHM", "Export frame buffer and memory to POSIX shared memory each frame", "action (start/stop/status), name, memtypes", "{\"type\":\"SHM\",\"action\":\"start\",\"memtypes\":\"wram,vram\"}"},
+			{"INSTANCE", "Create/destroy/list emulator instances in this process (address them with \"instance\" on any command)", "action (create/destroy/list), count, rom, clone, id (comma-separated or all)", "{\"type\":\"INSTANCE\",\"action\":\"create\",\"count\":\"8\"}"},
 		};
 
 		for (const auto& help : commandHelps) {
@@ -5724,9 +7907,9 @@ SocketResponse SocketServer::HandleHelp(Emulator* emu, const SocketCommand& cmd)
 
 	// List all commands
 	static const vector<string> commands = {
-		"PING", "STATE", "HEALTH", "PAUSE", "RESUME", "RESET", "FRAME", "STEP",
+		"PING", "STATE", "HEALTH", "PAUSE", "RESUME", "RESET", "FRAME", "RUN_FRAMES", "STEP",
 		"READ", "READ16", "READBLOCK", "READBLOCK_BINARY", "WRITE", "WRITE16", "WRITEBLOCK",
-		"CPU", "DISASM", "BREAKPOINT", "TRACE", "BATCH",
+		"CPU", "DISASM", "DISASM_EXPORT", "BREAKPOINT", "TRACE", "TRACE_QUERY", "PROFILER", "BATCH",
 		"SCREENSHOT", "SAVESTATE", "SAVESTATE_LABEL", "LOADSTATE",
 		"SNAPSHOT", "DIFF", "SEARCH", "LABELS",
 		"P_WATCH", "P_LOG", "P_ASSERT",
@@ -5736,7 +7919,7 @@ SocketResponse SocketServer::HandleHelp(Emulator* emu, const SocketCommand& cmd)
 		"COLLISION_OVERLAY", "COLLISION_DUMP",
 		"ROMINFO", "SPEED", "REWIND", "CHEAT", "INPUT",
 		"STATEINSPECT", "LOGPOINT", "SUBSCRIBE", "LOADSCRIPT", "HELP",
-		"GAMESTATE", "SPRITES"
+		"GAMESTATE", "SPRITES", "PROTOCOL", "SHM", "INSTANCE"
 	};
 
 	stringstream ss;
@@ -6083,7 +8266,7 @@ SocketResponse SocketServer::HandleCapabilities(Emulator* emu, const SocketComma
     ss << "{";
     ss << "\"version\":\"1.1.0\",";
     ss << "\"commands\":" << handlerCount << ",";
-    ss << "\"features\":[\"error_codes\",\"validation\",\"yaze_sync\",\"p_watch\",\"mem_blame\",\"batch\",\"gamestate\",\"sprites\",\"script_running\",\"savestate_labels\",\"savestate_slots\"]";
+    ss << "\"features\":[\"error_codes\",\"validation\",\"yaze_sync\",\"p_watch\",\"mem_blame\",\"batch\",\"gamestate\",\"sprites\",\"script_running\",\"savestate_labels\",\"savestate_slots\",\"binary_protocol\",\"shared_memory\",\"headless_run\",\"instances\"]";
     ss << "}";
     
     resp.success = true;
@@ -6133,6 +8316,9 @@ SocketResponse SocketServer::HandleMetrics(Emulator* emu, const SocketCommand& c
     uint64_t totalLatency = 0;
     size_t agentCount = 0;
     size_t subscriptionCount = 0;
+    uint64_t subscriberDropped = 0;
+    uint64_t subscriberCoalesced = 0;
+    size_t pendingBytes = 0;
     
     {
         auto lock = _historyLock.AcquireSafe();
@@ -6153,6 +8339,11 @@ SocketResponse SocketServer::HandleMetrics(Emulator* emu, const SocketCommand& c
     {
         auto lock = _eventLock.AcquireSafe();
         subscriptionCount = _eventSubscriptions.size();
+        for (const auto& [clientFd, subscriber] : _eventSubscriptions) {
+            subscriberDropped += subscriber.droppedCount;
+            subscriberCoalesced += subscriber.coalescedCount;
+            pendingBytes += subscriber.GetPendingSize();
+        }
     }
     
     double avgLatency = totalCommands > 0 ? (double)totalLatency / totalCommands : 0;
@@ -6165,7 +8356,16 @@ SocketResponse SocketServer::HandleMetrics(Emulator* emu, const SocketCommand& c
     ss << "\"errorCount\":" << errorCount << ",";
     ss << "\"errorRate\":" << fixed << setprecision(4) << errorRate << ",";
     ss << "\"registeredAgents\":" << agentCount << ",";
-    ss << "\"activeSubscriptions\":" << subscriptionCount;
+    ss << "\"activeSubscriptions\":" << subscriptionCount << ",";
+    ss << "\"events\":{";
+    ss << "\"published\":" << _eventsPublished.load() << ",";
+    ss << "\"queueDepth\":" << _eventQueue.GetSize() << ",";
+    ss << "\"queueCapacity\":" << _eventQueue.GetCapacity() << ",";
+    ss << "\"droppedQueueFull\":" << _eventsDroppedQueueFull.load() << ",";
+    ss << "\"droppedBySubscribers\":" << subscriberDropped << ",";
+    ss << "\"coalesced\":" << subscriberCoalesced << ",";
+    ss << "\"pendingBytes\":" << pendingBytes;
+    ss << "}";
     ss << "}";
     
     resp.success = true;
@@ -6376,6 +8576,7 @@ SocketResponse SocketServer::HandleSaveStateWatch(Emulator* emu, const SocketCom
 }
 
 SocketResponse SocketServer::HandleStateDiff(Emulator* emu, const SocketCommand& cmd) {
+	SocketInstanceState& state = *emu->GetSocketState();
 	SocketResponse resp;
 
 	if (!emu->IsRunning()) {
@@ -6399,12 +8600,12 @@ SocketResponse SocketServer::HandleStateDiff(Emulator* emu, const SocketCommand&
 		}
 	}
 
-	auto lock = _stateLock.AcquireSafe();
+	auto lock = state.stateLock.AcquireSafe();
 	
 	stringstream ss;
 	ss << "{";
 	
-	if (_lastState.empty()) {
+	if (state.lastState.empty()) {
 		// First call, return everything
 		ss << "\"firstCall\":true,";
 		bool first = true;
@@ -6419,8 +8620,8 @@ SocketResponse SocketServer::HandleStateDiff(Emulator* emu, const SocketCommand&
 		ss << "\"changes\":{";
 		bool first = true;
 		for (const auto& kv : currentState) {
-			auto it = _lastState.find(kv.first);
-			if (it == _lastState.end() || it->second != kv.second) {
+			auto it = state.lastState.find(kv.first);
+			if (it == state.lastState.end() || it->second != kv.second) {
 				if (!first) ss << ",";
 				ss << "\"" << kv.first << "\":\"" << JsonEscape(kv.second) << "\"";
 				first = false;
@@ -6431,7 +8632,7 @@ SocketResponse SocketServer::HandleStateDiff(Emulator* emu, const SocketCommand&
 	ss << "}";
 
 	// Update cache
-	_lastState = currentState;
+	state.lastState = currentState;
 
 	resp.success = true;
 	resp.data = ss.str();
@@ -6439,6 +8640,7 @@ SocketResponse SocketServer::HandleStateDiff(Emulator* emu, const SocketCommand&
 }
 
 SocketResponse SocketServer::HandleWatchTrigger(Emulator* emu, const SocketCommand& cmd) {
+	SocketInstanceState& state = *emu->GetSocketState();
 	SocketResponse resp;
 	
 	auto actionIt = cmd.params.find("action");
@@ -6470,16 +8672,16 @@ SocketResponse SocketServer::HandleWatchTrigger(Emulator* emu, const SocketComma
 
 		string condition = cmd.GetParam("condition");
 		
-		auto lock = _watchTriggerLock.AcquireSafe();
+		auto lock = state.watchTriggerLock.AcquireSafe();
 		WatchTrigger trigger;
-		trigger.id = _nextWatchTriggerId++;
+		trigger.id = state.nextWatchTriggerId++;
 		trigger.addr = addr;
 		trigger.value = value;
 		trigger.condition = condition;
 		trigger.enabled = true;
 		trigger.triggered = false;
 		
-		_watchTriggers.push_back(trigger);
+		state.watchTriggers.push_back(trigger);
 		
 		resp.success = true;
 		resp.data = "{\"id\":" + std::to_string(trigger.id) + "}";
@@ -6492,13 +8694,13 @@ SocketResponse SocketServer::HandleWatchTrigger(Emulator* emu, const SocketComma
 		}
 		uint32_t id = std::stoul(cmd.GetParam("trigger_id"));
 		
-		auto lock = _watchTriggerLock.AcquireSafe();
-		auto it = std::remove_if(_watchTriggers.begin(), _watchTriggers.end(), 
+		auto lock = state.watchTriggerLock.AcquireSafe();
+		auto it = std::remove_if(state.watchTriggers.begin(), state.watchTriggers.end(), 
 			[id](const WatchTrigger& t) { return t.id == id; });
 			
-		bool found = it != _watchTriggers.end();
+		bool found = it != state.watchTriggers.end();
 		if (found) {
-			_watchTriggers.erase(it, _watchTriggers.end());
+			state.watchTriggers.erase(it, state.watchTriggers.end());
 			resp.success = true;
 			resp.data = "\"OK\"";
 		} else {
@@ -6507,11 +8709,11 @@ SocketResponse SocketServer::HandleWatchTrigger(Emulator* emu, const SocketComma
 		}
 	}
 	else if (action == "list") {
-		auto lock = _watchTriggerLock.AcquireSafe();
+		auto lock = state.watchTriggerLock.AcquireSafe();
 		stringstream ss;
 		ss << "{\"triggers\":[";
 		bool first = true;
-		for (const auto& t : _watchTriggers) {
+		for (const auto& t : state.watchTriggers) {
 			if (!first) ss << ",";
 			ss << "{\"id\":" << t.id << ",\"addr\":" << t.addr << ",\"value\":" << t.value 
 			   << ",\"condition\":\"" << t.condition << "\",\"triggered\":" << (t.triggered ? "true" : "false") << "}";
@@ -6523,7 +8725,7 @@ SocketResponse SocketServer::HandleWatchTrigger(Emulator* emu, const SocketComma
 	}
 	else if (action == "check") {
 		// Check all triggers against current memory
-		auto lock = _watchTriggerLock.AcquireSafe();
+		auto lock = state.watchTriggerLock.AcquireSafe();
 		stringstream ss;
 		ss << "{\"triggered\":[";
 		bool first = true;
@@ -6532,7 +8734,7 @@ SocketResponse SocketServer::HandleWatchTrigger(Emulator* emu, const SocketComma
 		if (dbg.GetDebugger()) {
 			auto dumper = dbg.GetDebugger()->GetMemoryDumper();
 			
-			for (auto& t : _watchTriggers) {
+			for (auto& t : state.watchTriggers) {
 				if (!t.enabled) continue;
 				
 				uint8_t memVal = dumper->GetMemoryValue(MemoryType::SnesMemory, t.addr);
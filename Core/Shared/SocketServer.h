@@ -1,16 +1,24 @@
 #pragma once
 #include "pch.h"
 #include "Utilities/SimpleLock.h"
+#include "Utilities/AutoResetEvent.h"
+#include "Utilities/MpscQueue.h"
 #include "Shared/MemoryType.h"
 #include "Shared/CpuType.h"
+#include "Debugger/ExpressionEvaluator.h"
+#include "Debugger/ITraceLogger.h"
 #include <thread>
 #include <atomic>
 #include <functional>
 #include <unordered_map>
 #include <deque>
 #include <set>
+#include <map>
+#include <algorithm>
 
 class Emulator;
+class Debugger;
+class ThreadPool;
 
 // Error codes for better error categorization
 enum class SocketErrorCode {
@@ -45,6 +53,7 @@ struct SocketCommand {
 	string type;
 	unordered_map<string, string> params;
 	int clientFd = -1;
+	bool binary = false;  // Received through the binary protocol (handlers may return raw bytes)
 	
 	// Validation helpers
 	bool HasParam(const string& key) const {
@@ -67,6 +76,26 @@ struct SocketResponse {
 	string ToJson() const;
 };
 
+// Binary framed protocol, enabled per connection by sending {"type":"PROTOCOL","mode":"binary"}
+// and waiting for its (JSON) response. All values are little-endian.
+//   Request:  u32 payloadSize | u16 opcode | u16 tag | payload
+//   Response: u32 payloadSize | u16 status (SocketErrorCode, 0 = success) | u16 tag | payload
+// On failure, the response payload is the UTF-8 error message. The tag is echoed back as-is.
+// Every opcode addresses the connection's selected instance (set with "instance" in the handshake
+// or with the Instance opcode, 0 by default).
+enum class SocketBinaryOpcode : uint16_t {
+	Ping = 0x00,     // -> (empty)
+	Read = 0x01,     // u8 memType, u32 addr, u32 length -> raw bytes
+	Write = 0x02,    // u8 memType, u32 addr, bytes -> (empty)
+	Frame = 0x03,    // u32 count -> (empty)
+	State = 0x04,    // -> u32 frame, u8 running, u8 paused
+	Command = 0x05,  // u8 len, type, u16 paramCount, [u8 len, key, u16 len, value]... -> handler data
+	Instance = 0x06, // u32 instanceId -> (empty)
+};
+
+constexpr uint32_t SocketBinaryHeaderSize = 8;
+constexpr uint32_t SocketBinaryMaxPayload = 16 * 1024 * 1024;
+
 // Command handler type
 using CommandHandler = std::function<SocketResponse(Emulator*, const SocketCommand&)>;
 
@@ -105,6 +134,85 @@ struct MemoryWatchRegion {
 	uint32_t maxDepth;
 };
 
+// Fixed-capacity write log for a single watch (allocated once when the watch is added)
+struct MemoryWriteRing {
+	vector<MemoryWriteRecord> records;
+	uint32_t head = 0;   // Index of the oldest record
+	uint32_t count = 0;
+
+	void Init(uint32_t capacity) {
+		records.resize(capacity);
+		head = 0;
+		count = 0;
+	}
+
+	void Push(const MemoryWriteRecord& record) {
+		uint32_t capacity = (uint32_t)records.size();
+		if(count < capacity) {
+			records[(head + count) % capacity] = record;
+			count++;
+		} else {
+			records[head] = record;
+			head = (head + 1) % capacity;
+		}
+	}
+
+	// i = 0 is the oldest record
+	const MemoryWriteRecord& Get(uint32_t i) const {
+		return records[(head + i) % records.size()];
+	}
+};
+
+// Immutable lookup structure for the write hook, rebuilt whenever a watch is added/removed.
+// The page bitmap rejects most writes with a single bit test, the sorted intervals resolve
+// the remaining ones without taking _memoryWatchLock.
+struct MemoryWatchIndex {
+	static constexpr uint32_t AddressBits = 24;
+	static constexpr uint32_t PageShift = 8;
+	static constexpr uint32_t PageCount = 1 << (AddressBits - PageShift);
+
+	struct Interval {
+		uint32_t startAddr;
+		uint32_t endAddr;
+		uint32_t maxEndAddr;  // Max endAddr of this and all previous intervals
+		uint32_t watchId;
+	};
+
+	uint64_t pageBitmap[PageCount / 64] = {};
+	vector<Interval> intervals;  // Sorted by startAddr
+
+	bool IsPageWatched(uint32_t addr) const {
+		uint32_t page = (addr & ((1 << AddressBits) - 1)) >> PageShift;
+		return (pageBitmap[page >> 6] >> (page & 0x3F)) & 0x01;
+	}
+
+	// Calls callback(interval) for every watch overlapping [addr, endAddr]
+	template<typename T>
+	void ForEachOverlap(uint32_t addr, uint32_t endAddr, T&& callback) const {
+		auto it = std::upper_bound(intervals.begin(), intervals.end(), endAddr, [](uint32_t value, const Interval& interval) {
+			return value < interval.startAddr;
+		});
+		while(it != intervals.begin()) {
+			--it;
+			if(it->maxEndAddr < addr) {
+				break;
+			}
+			if(it->endAddr >= addr) {
+				callback(*it);
+			}
+		}
+	}
+
+	bool Contains(uint32_t addr) const {
+		if(!IsPageWatched(addr)) {
+			return false;
+		}
+		bool found = false;
+		ForEachOverlap(addr, addr, [&found](const Interval&) { found = true; });
+		return found;
+	}
+};
+
 // Watch trigger for conditional breakpoints/events
 struct WatchTrigger {
 	uint32_t id;
@@ -142,6 +250,53 @@ struct SocketLogpoint {
 	int32_t addr;
 	bool enabled;
 	string expression;  // Expression to evaluate and log
+	ExpressionData compiledExpression;
+};
+
+// Lock-free view of the enabled logpoints, checked on every instruction.
+// Non-matching PCs cost a single bit test - only banks that contain a logpoint have a bitmap.
+struct LogpointIndex {
+	static constexpr uint32_t AddressBits = 24;
+	static constexpr uint32_t BankShift = 16;
+	static constexpr uint32_t BankCount = 1 << (AddressBits - BankShift);
+	static constexpr uint32_t BankWordCount = (1 << BankShift) / 64;
+	static constexpr int CpuCount = (int)CpuType::Gba + 1;
+
+	struct Entry {
+		uint32_t logpointId;
+		CpuType cpuType;
+		uint32_t addr;
+		bool hasExpression;
+		// Compiled once when the logpoint is added (Evaluate() takes a non-const reference, but doesn't modify it)
+		mutable ExpressionData expression;
+	};
+
+	unique_ptr<uint64_t[]> banks[CpuCount][BankCount];
+	vector<Entry> entries;  // Sorted by cpuType, then addr
+
+	bool IsSet(CpuType cpuType, uint32_t pc) const {
+		const uint64_t* bank = banks[(int)cpuType][(pc >> BankShift) & (BankCount - 1)].get();
+		return bank && ((bank[(pc & ((1 << BankShift) - 1)) >> 6] >> (pc & 0x3F)) & 0x01);
+	}
+
+	void Set(CpuType cpuType, uint32_t pc) {
+		unique_ptr<uint64_t[]>& bank = banks[(int)cpuType][(pc >> BankShift) & (BankCount - 1)];
+		if(!bank) {
+			bank.reset(new uint64_t[BankWordCount]());
+		}
+		bank[(pc & ((1 << BankShift) - 1)) >> 6] |= (uint64_t)1 << (pc & 0x3F);
+	}
+};
+
+// Logpoint hit as written by the emulation thread - formatted later by the socket thread
+struct RawLogpointHit {
+	uint32_t logpointId;
+	uint32_t pc;
+	CpuType cpuType;
+	EvalResultType resultType;
+	bool hasValue;
+	uint64_t cycleCount;
+	int64_t value;
 };
 
 // Logpoint hit record
@@ -153,6 +308,35 @@ struct LogpointHit {
 	string value;  // Evaluated expression result
 };
 
+// Event queued by BroadcastEvent for the publisher thread
+struct SocketEvent {
+	string type;
+	string data;
+	uint32_t instanceId = 0;
+};
+
+// What to do with events when a subscriber can't keep up
+enum class SocketEventPolicy {
+	Queue,     // Buffer events until the outbound buffer is full, then drop new ones
+	Coalesce,  // Like Queue, but only the latest pending frame_complete is kept
+	Drop       // Drop events whenever previous data is still waiting to be sent
+};
+
+// Per-client subscription state, owned by the publisher thread (under _eventLock)
+struct EventSubscriber {
+	std::set<string> events;
+	SocketEventPolicy policy = SocketEventPolicy::Queue;
+	size_t maxBufferSize = 1024 * 1024;
+	string outbound;              // Bytes not yet written to the socket
+	size_t outboundOffset = 0;    // Bytes of outbound already written
+	string coalescedEvent;        // Latest pending coalesced event (Coalesce policy)
+	uint64_t sentCount = 0;
+	uint64_t droppedCount = 0;
+	uint64_t coalescedCount = 0;
+
+	size_t GetPendingSize() const { return outbound.size() - outboundOffset + coalescedEvent.size(); }
+};
+
 // Request validation structure
 struct CommandValidation {
 	size_t maxRequestSize;  // Max request size in bytes
@@ -189,6 +373,104 @@ struct SaveLoadResult {
 	uint64_t timestampMs = 0;
 };
 
+// Socket API debugging state for a single Emulator (snapshots, breakpoints, watches, logpoints, ...).
+// Each Emulator owns one, so instances running in the same process never see each other's state.
+// Connection-level state (event subscriptions, agents, command history) stays in SocketServer.
+struct SocketInstanceState {
+	// Memory snapshots for diff operations
+	unordered_map<string, MemorySnapshot> snapshots;
+	// Saved SEARCH results (sorted addresses) for narrowing later searches with "within"
+	unordered_map<string, vector<uint32_t>> searchResults;
+	SimpleLock snapshotLock;
+
+	// Breakpoint management
+	vector<SocketBreakpoint> breakpoints;
+	uint32_t nextBreakpointId = 1;
+	SimpleLock breakpointLock;
+
+	// P register change tracking
+	std::deque<PRegisterChange> pRegisterLog;
+	uint32_t pRegisterLogMaxSize = 1000;
+	bool pRegisterWatchEnabled = false;
+	uint8_t lastPRegister = 0;
+	SimpleLock pRegisterLock;
+
+	// Memory write attribution
+	vector<MemoryWatchRegion> memoryWatches;
+	unordered_map<uint32_t, MemoryWriteRing> memoryWriteLog;
+	uint32_t nextMemoryWatchId = 1;
+	SimpleLock memoryWatchLock;
+	// Lock-free view of memoryWatches for the write hook, replaced (never modified) on add/remove.
+	// Replaced indexes are kept in retiredMemoryWatchIndexes until the emulation thread (the only
+	// lock-free reader) is known to no longer reference them.
+	atomic<const MemoryWatchIndex*> memoryWatchIndex { nullptr };
+	vector<unique_ptr<MemoryWatchIndex>> retiredMemoryWatchIndexes;
+	atomic<bool> hasRetiredMemoryWatchIndexes { false };
+
+	// Symbol table
+	unordered_map<string, SymbolEntry> symbolTable;
+	SimpleLock symbolLock;
+
+	// Logpoints
+	vector<SocketLogpoint> logpoints;
+	std::deque<LogpointHit> logpointHits;
+	uint32_t nextLogpointId = 1;
+	uint32_t logpointHitMaxSize = 1000;
+	SimpleLock logpointLock;
+	// Same publish/retire scheme as memoryWatchIndex
+	atomic<const LogpointIndex*> logpointIndex { nullptr };
+	vector<unique_ptr<LogpointIndex>> retiredLogpointIndexes;
+	atomic<bool> hasRetiredLogpointIndexes { false };
+	// Filled by the emulation thread, drained (and formatted) by the socket thread with DrainLogpointHits()
+	MpscQueue<RawLogpointHit> rawLogpointHits { 4096 };
+	atomic<uint64_t> logpointHitsDropped { 0 };
+
+	// State diff caching
+	unordered_map<string, string> lastState;
+	SimpleLock stateLock;
+
+	// Watch triggers
+	vector<WatchTrigger> watchTriggers;
+	uint32_t nextWatchTriggerId = 1;
+	SimpleLock watchTriggerLock;
+
+	// Trace loggers enabled by TRACE_QUERY start, with the options they had before. They are restored
+	// once the trace store stops recording, unless TRACE start/stop has set their options since then.
+	vector<std::pair<CpuType, TraceLoggerOptions>> traceQueryLoggers;
+
+	// Collision overlay (drawn by WatchHud)
+	bool collisionOverlayEnabled = false;
+	string collisionOverlayMode = "A";  // "A", "B", or "both"
+	vector<uint8_t> collisionHighlightTiles;
+
+	~SocketInstanceState();
+
+	// Debugger hooks - called from SnesDebugger on the emulation thread
+	void LogPRegisterChange(uint32_t pc, uint8_t oldP, uint8_t newP, uint8_t opcode, uint64_t cycleCount);
+	void LogMemoryWrite(uint32_t pc, uint32_t addr, uint16_t value, uint8_t size, uint64_t cycleCount, uint16_t stackPointer);
+	bool IsPRegisterWatchEnabled() const { return pRegisterWatchEnabled; }
+	bool HasLogpoints() const { return logpointIndex.load(std::memory_order_relaxed) != nullptr; }
+	bool HasLogpoint(CpuType cpuType, uint32_t pc) const {
+		const LogpointIndex* index = logpointIndex.load(std::memory_order_acquire);
+		return index && index->IsSet(cpuType, pc);
+	}
+	bool HasMemoryWatch(uint32_t addr) const {
+		const MemoryWatchIndex* index = memoryWatchIndex.load(std::memory_order_acquire);
+		return index && index->Contains(addr);
+	}
+
+	// Rebuilds and publishes memoryWatchIndex (caller must hold memoryWatchLock)
+	void RebuildMemoryWatchIndex();
+	// Called from the emulation thread once it no longer holds a reference to any memory watch index
+	void ReleaseRetiredMemoryWatchIndexes();
+
+	// Rebuilds and publishes logpointIndex from logpoints (caller must hold logpointLock)
+	void RebuildLogpointIndex();
+	void ReleaseRetiredLogpointIndexes();
+	// Formats queued raw hits into logpointHits and broadcasts them (caller must hold logpointLock)
+	void DrainLogpointHits(uint32_t instanceId);
+};
+
 class SocketServer {
 private:
 	Emulator* _emu;
@@ -200,43 +482,35 @@ private:
 
 	unordered_map<string, CommandHandler> _handlers;
 
-	// Memory snapshots for diff operations (static for use in static handlers)
-	static unordered_map<string, MemorySnapshot> _snapshots;
-	static SimpleLock _snapshotLock;
-
-	// Breakpoint management (static for use in static handlers)
-	static vector<SocketBreakpoint> _breakpoints;
-	static uint32_t _nextBreakpointId;
-	static SimpleLock _breakpointLock;
-
-	// P register change tracking (static for use in static handlers)
-	static std::deque<PRegisterChange> _pRegisterLog;
-	static uint32_t _pRegisterLogMaxSize;
-	static bool _pRegisterWatchEnabled;
-	static uint8_t _lastPRegister;
-	static SimpleLock _pRegisterLock;
-
-	// Memory write attribution (static for use in static handlers)
-	static vector<MemoryWatchRegion> _memoryWatches;
-	static unordered_map<uint32_t, std::deque<MemoryWriteRecord>> _memoryWriteLog;
-	static uint32_t _nextMemoryWatchId;
-	static SimpleLock _memoryWatchLock;
-
-	// Symbol table (static for use in static handlers)
-	static unordered_map<string, SymbolEntry> _symbolTable;
-	static SimpleLock _symbolLock;
-
-	// Logpoints (static for use in static handlers)
-	static vector<SocketLogpoint> _logpoints;
-	static std::deque<LogpointHit> _logpointHits;
-	static uint32_t _nextLogpointId;
-	static uint32_t _logpointHitMaxSize;
-	static SimpleLock _logpointLock;
+	// Connections that switched to the binary protocol, with their selected instance (only used by the server thread)
+	unordered_map<int, uint32_t> _binaryClients;
+
+	// Secondary emulator instances created with INSTANCE, addressed by the "instance" parameter
+	// of any command (instance 0 is _emu). Only the server thread creates and destroys them.
+	std::map<uint32_t, unique_ptr<Emulator>> _instances;
+	uint32_t _nextInstanceId = 1;
+	SimpleLock _instanceLock;
+	// Runs RUN_FRAMES on several instances at once
+	unique_ptr<ThreadPool> _instancePool;
+
+	uint32_t CreateInstance(const string& romPath, bool cloneState, string& error);
+	bool DestroyInstance(uint32_t instanceId);
+	void ReleaseInstances();
+	vector<uint32_t> GetInstanceIds();
+	SocketResponse RunFramesOnInstances(const vector<uint32_t>& instanceIds, const SocketCommand& cmd);
 
 	// Event subscription (static for use in static handlers)
-	// Maps client FD -> set of subscribed event types
-	static unordered_map<int, std::set<string>> _eventSubscriptions;
+	// Maps client FD -> subscription state. Events are queued by BroadcastEvent (any thread)
+	// and written to subscribers by the publisher thread, so slow clients never block emulation.
+	static unordered_map<int, EventSubscriber> _eventSubscriptions;
 	static SimpleLock _eventLock;
+	static MpscQueue<SocketEvent> _eventQueue;
+	static AutoResetEvent _eventSignal;
+	static atomic<bool> _eventThreadIdle;
+	static atomic<uint32_t> _eventSubscriberCount;
+	static atomic<uint64_t> _eventsPublished;
+	static atomic<uint64_t> _eventsDroppedQueueFull;
+	unique_ptr<thread> _eventThread;
 
 	// Agent registration (static for use in static handlers)
 	static unordered_map<int, AgentInfo> _registeredAgents;
@@ -261,18 +535,9 @@ private:
 	static SocketLogLevel _logLevel;
 	static SimpleLock _logLevelLock;
 
-	// State diff caching
-	static unordered_map<string, string> _lastState;
-	static SimpleLock _stateLock;
-
-	// Watch triggers
-	static vector<WatchTrigger> _watchTriggers;
-	static uint32_t _nextWatchTriggerId;
-	static SimpleLock _watchTriggerLock;
-
 	// Helper to sync breakpoints with emulator
 	static void SyncBreakpoints(Emulator* emu);
-	
+
 	// Request validation helper
 	static bool ValidateCommand(const SocketCommand& cmd, string& error, SocketErrorCode& errorCode);
 	
@@ -280,7 +545,17 @@ private:
 	static void InitializeValidationRules();
 
 	void ServerLoop();
+	bool DrainLogpointHits();
+	void EventLoop();
 	bool HandleClient(int clientFd);
+	// instanceId is the connection's selected instance, updated by the Instance opcode
+	bool HandleBinaryClient(int clientFd, uint32_t& instanceId);
+	SocketResponse DispatchCommand(const SocketCommand& cmd);
+	static void RecordCommandHistory(const string& command, SocketErrorCode errorCode, uint64_t latencyUs);
+	static bool SendToClient(int clientFd, const string& data);
+	static void DispatchEvent(const SocketEvent& evt);
+	static bool FlushSubscriber(int clientFd, EventSubscriber& subscriber);
+	static void RemoveSubscriber(int clientFd);
 	bool ParseCommand(const string& json, SocketCommand& cmd, string& error);
 	void RegisterHandlers();
 
@@ -309,6 +584,7 @@ private:
 	static SocketResponse HandleDisasm(Emulator* emu, const SocketCommand& cmd);
 	static SocketResponse HandleStep(Emulator* emu, const SocketCommand& cmd);
 	static SocketResponse HandleRunFrame(Emulator* emu, const SocketCommand& cmd);
+	static SocketResponse HandleRunFrames(Emulator* emu, const SocketCommand& cmd);
         static SocketResponse HandleCallstack(Emulator* emu, const SocketCommand& cmd);
         static SocketResponse HandleOsd(Emulator* emu, const SocketCommand& cmd);
 
@@ -332,6 +608,13 @@ private:
 
 	// Trace handler
 	static SocketResponse HandleTrace(Emulator* emu, const SocketCommand& cmd);
+	static SocketResponse HandleTraceQuery(Emulator* emu, const SocketCommand& cmd);
+
+	// Disassembly export handler
+	static SocketResponse HandleDisasmExport(Emulator* emu, const SocketCommand& cmd);
+
+	// Sampling profiler handler
+	static SocketResponse HandleProfiler(Emulator* emu, const SocketCommand& cmd);
 
 	// Logpoint handler
 	static SocketResponse HandleLogpoint(Emulator* emu, const SocketCommand& cmd);
@@ -378,6 +661,15 @@ private:
 	static SocketResponse HandleSaveStateSync(Emulator* emu, const SocketCommand& cmd);
 	static SocketResponse HandleSaveStateWatch(Emulator* emu, const SocketCommand& cmd);
 
+	// Protocol negotiation handler
+	static SocketResponse HandleProtocol(Emulator* emu, const SocketCommand& cmd);
+
+	// Shared memory export handler
+	static SocketResponse HandleShm(Emulator* emu, const SocketCommand& cmd);
+
+	// Emulator instance management handler
+	static SocketResponse HandleInstance(Emulator* emu, const SocketCommand& cmd);
+
 	// Agent-friendly feature handlers
 	static SocketResponse HandleStateDiff(Emulator* emu, const SocketCommand& cmd);
 	static SocketResponse HandleWatchTrigger(Emulator* emu, const SocketCommand& cmd);
@@ -398,17 +690,17 @@ public:
 	// Register custom command handler
 	void RegisterHandler(const string& command, CommandHandler handler);
 
-	// Debugger hook methods - called from SnesDebugger to log events
-	static void LogPRegisterChange(uint32_t pc, uint8_t oldP, uint8_t newP, uint8_t opcode, uint64_t cycleCount);
-	static void LogMemoryWrite(uint32_t pc, uint32_t addr, uint16_t value, uint8_t size, uint64_t cycleCount, uint16_t stackPointer);
-	static void CheckLogpoints(CpuType cpuType, uint32_t pc, Emulator* emu);
-	static void BroadcastEvent(string eventType, string data);
-	static bool IsPRegisterWatchEnabled() { return _pRegisterWatchEnabled; }
-	static bool HasMemoryWatch(uint32_t addr);
-	static bool HasLogpoints() { return !_logpoints.empty(); }
+	// Emulator for an instance id (0 = the emulator owning this server), nullptr if there is none
+	Emulator* GetInstance(uint32_t instanceId);
+
+	// Called from the debugger when HasLogpoint(cpuType, pc) is true
+	static void CheckLogpoints(Debugger* debugger, CpuType cpuType, uint32_t pc, Emulator* emu);
+	// Queues an event for subscribers. Events raised by a secondary instance carry its id.
+	static void BroadcastEvent(string eventType, string data, uint32_t instanceId = 0);
+	static bool HasEventSubscribers() { return _eventSubscriberCount.load(std::memory_order_relaxed) > 0; }
 
 	// Collision overlay accessors - called from WatchHud for rendering
-	static bool IsCollisionOverlayEnabled();
-	static string GetCollisionOverlayMode();
-	static const vector<uint8_t>& GetCollisionHighlightTiles();
+	static bool IsCollisionOverlayEnabled(Emulator* emu);
+	static string GetCollisionOverlayMode(Emulator* emu);
+	static const vector<uint8_t>& GetCollisionHighlightTiles(Emulator* emu);
 };
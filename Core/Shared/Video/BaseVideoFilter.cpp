@@ -94,6 +94,7 @@ FrameInfo BaseVideoFilter::SendFrame(uint16_t *ppuOutputBuffer, uint32_t frameNu
 	auto lock = _frameLock.AcquireSafe();
 	_overscan = enableOverscan ? _emu->GetSettings()->GetOverscan() : OverscanDimensions{};
 	_isOddFrame = frameNumber % 2;
+	_frameNumber = frameNumber;
 	_videoPhase = videoPhase;
 	_frameData = frameData;
 	_ppuOutputBuffer = ppuOutputBuffer;
@@ -163,23 +164,31 @@ void BaseVideoFilter::YiqToRgb(double y, double i, double q, double& r, double&
 	b = std::max(0.0, std::min(1.0, (y + _yiqToRgbMatrix[4] * i + _yiqToRgbMatrix[5] * q)));
 }
 
+bool BaseVideoFilter::CopyOutputBuffer(vector<uint32_t>& buffer, FrameInfo& frameInfo, uint32_t& frameNumber)
+{
+	auto lock = _frameLock.AcquireSafe();
+	if(_bufferSize == 0 || !GetOutputBuffer()) {
+		return false;
+	}
+
+	buffer.resize(_bufferSize);
+	memcpy(buffer.data(), GetOutputBuffer(), _bufferSize * sizeof(buffer[0]));
+	frameInfo = _frameInfo;
+	frameNumber = _frameNumber;
+	return true;
+}
+
 void BaseVideoFilter::TakeScreenshot(VideoFilterType filterType, string filename, std::stringstream *stream)
 {
 	uint32_t* pngBuffer;
 	FrameInfo frameInfo;
-	uint32_t* frameBuffer = nullptr;
-	{
-		auto lock = _frameLock.AcquireSafe();
-		if(_bufferSize == 0 || !GetOutputBuffer()) {
-			return;
-		}
-
-		frameBuffer = new uint32_t[_bufferSize];
-		memcpy(frameBuffer, GetOutputBuffer(), _bufferSize * sizeof(frameBuffer[0]));
-		frameInfo = _frameInfo;
+	uint32_t frameNumber;
+	vector<uint32_t> frameBuffer;
+	if(!CopyOutputBuffer(frameBuffer, frameInfo, frameNumber)) {
+		return;
 	}
 
-	pngBuffer = frameBuffer;
+	pngBuffer = frameBuffer.data();
 	
 	uint8_t scale = 1;
 
@@ -192,6 +201,8 @@ void BaseVideoFilter::TakeScreenshot(VideoFilterType filterType, string filename
 
 	unique_ptr<ScaleFilter> scaleFilter = ScaleFilter::GetScaleFilter(_emu, filterType);
 	if(scaleFilter) {
+		//Single-threaded, to avoid starting a thread pool for a one-off frame
+		scaleFilter->SetThreadCount(1);
 		pngBuffer = scaleFilter->ApplyFilter(pngBuffer, frameInfo.Width, frameInfo.Height);
 		frameInfo = scaleFilter->GetFrameInfo(frameInfo);
 		scale = scaleFilter->GetScale();
@@ -204,8 +215,6 @@ void BaseVideoFilter::TakeScreenshot(VideoFilterType filterType, string filename
 	} else {
 		PNGHelper::WritePNG(*stream, pngBuffer, frameInfo.Width, frameInfo.Height);
 	}
-
-	delete[] frameBuffer;
 }
 
 void BaseVideoFilter::TakeScreenshot(string romName, VideoFilterType filterType)
@@ -15,6 +15,7 @@ private:
 	OverscanDimensions _overscan = {};
 	bool _isOddFrame = false;
 	uint32_t _videoPhase = 0;
+	atomic<uint32_t> _frameNumber = {}; //Read without _frameLock by ScreenshotEncoder
 
 	void UpdateBufferSize();
 
@@ -48,6 +49,10 @@ public:
 
 	uint32_t* GetOutputBuffer();
 	FrameInfo SendFrame(uint16_t *ppuOutputBuffer, uint32_t frameNumber, uint32_t videoPhase, void* frameData, bool enableOverscan = true);
+	//Copies the last filtered frame (before rotation/scaling), returns false if no frame has been filtered yet
+	bool CopyOutputBuffer(vector<uint32_t>& buffer, FrameInfo& frameInfo, uint32_t& frameNumber);
+	uint32_t GetFrameNumber() { return _frameNumber; }
+
 	void TakeScreenshot(string romName, VideoFilterType filterType);
 	void TakeScreenshot(VideoFilterType filterType, string filename, std::stringstream *stream = nullptr);
 
@@ -2,9 +2,6 @@
 #include <algorithm>
 #include "Shared/Video/DebugHud.h"
 #include "Shared/Video/DrawCommand.h"
-#include "Shared/Video/DrawLineCommand.h"
-#include "Shared/Video/DrawPixelCommand.h"
-#include "Shared/Video/DrawRectangleCommand.h"
 #include "Shared/Video/DrawStringCommand.h"
 #include "Shared/Video/DrawScreenBufferCommand.h"
 
@@ -34,9 +31,7 @@ bool DebugHud::Draw(uint32_t* argbBuffer, FrameInfo frameInfo, OverscanDimension
 	if(clearAndUpdate) {
 		unordered_map<uint32_t, uint32_t> drawPixels;
 		drawPixels.reserve(1000);
-		for(unique_ptr<DrawCommand>& command : _commands) {
-			command->Draw(&drawPixels, argbBuffer, frameInfo, overscan, frameNumber, scaleFactors);
-		}
+		DrawCommands(&drawPixels, argbBuffer, frameInfo, overscan, frameNumber, scaleFactors);
 
 		isDirty = drawPixels.size() != _drawPixels.size();
 		if(!isDirty) {
@@ -63,30 +58,98 @@ bool DebugHud::Draw(uint32_t* argbBuffer, FrameInfo frameInfo, OverscanDimension
 		}
 	} else {
 		isDirty = true;
-		for(unique_ptr<DrawCommand>& command : _commands) {
-			command->Draw(nullptr, argbBuffer, frameInfo, overscan, frameNumber, scaleFactors);
-		}
+		DrawCommands(nullptr, argbBuffer, frameInfo, overscan, frameNumber, scaleFactors);
 	}
 
-	_commands.erase(std::remove_if(_commands.begin(), _commands.end(), [](const unique_ptr<DrawCommand>& c) { return c->Expired(); }), _commands.end());
+	_commands.erase(std::remove_if(_commands.begin(), _commands.end(), [](const HudCommand& c) {
+		return c.Object ? c.Object->Expired() : c.FrameCount == 0;
+	}), _commands.end());
 	_commandCount = (uint32_t)_commands.size();
 
 	return isDirty;
 }
 
+void DebugHud::DrawCommands(unordered_map<uint32_t, uint32_t>* drawPixels, uint32_t* argbBuffer, FrameInfo& frameInfo, OverscanDimensions& overscan, uint32_t frameNumber, HudScaleFactors& scaleFactors)
+{
+	_renderer.SetTarget(drawPixels, argbBuffer, frameInfo, overscan, scaleFactors);
+	for(HudCommand& cmd : _commands) {
+		if(cmd.Object) {
+			cmd.Object->Draw(drawPixels, argbBuffer, frameInfo, overscan, frameNumber, scaleFactors);
+			continue;
+		}
+
+		if(cmd.StartFrame < 0) {
+			//When no start frame was specified, start on the next drawn frame
+			cmd.StartFrame = frameNumber;
+		}
+
+		if(cmd.StartFrame <= (int32_t)frameNumber) {
+			_renderer.Draw(cmd);
+			cmd.FrameCount--;
+		}
+	}
+}
+
+void DebugHud::AddPrimitive(HudCommandType type, int x, int y, int x2, int y2, int color, int frameCount, int startFrame)
+{
+	//Invert alpha byte - 0 = opaque, 255 = transparent (this way, no need to specifiy alpha channel all the time)
+	color = (~color & 0xFF000000) | (color & 0xFFFFFF);
+	frameCount = frameCount > 0 ? frameCount : -1;
+
+	auto lock = _commandLock.AcquireSafe();
+	if(type == HudCommandType::FilledRectangle && !_commands.empty()) {
+		//Merge with the previous fill when it is adjacent and identical otherwise (e.g scripts drawing images pixel by pixel)
+		//Only the last command is checked, so the draw order is unchanged
+		HudCommand& last = _commands.back();
+		if(last.Type == type && last.Color == color && last.FrameCount == frameCount && last.StartFrame == startFrame) {
+			if(last.Y == y && last.Y2 == y2 && last.X2 + 1 == x) {
+				last.X2 = x2;
+				return;
+			} else if(last.X == x && last.X2 == x2 && last.Y2 + 1 == y) {
+				last.Y2 = y2;
+				return;
+			}
+		}
+	}
+
+	if(_commands.size() < DebugHud::MaxCommandCount) {
+		HudCommand& cmd = _commands.emplace_back();
+		cmd.Type = type;
+		cmd.X = x;
+		cmd.Y = y;
+		cmd.X2 = x2;
+		cmd.Y2 = y2;
+		cmd.Color = color;
+		cmd.FrameCount = frameCount;
+		cmd.StartFrame = startFrame;
+		_commandCount++;
+	}
+}
+
 void DebugHud::DrawPixel(int x, int y, int color, int frameCount, int startFrame)
 {
-	AddCommand(unique_ptr<DrawCommand>(new DrawPixelCommand(x, y, color, frameCount, startFrame)));
+	AddPrimitive(HudCommandType::FilledRectangle, x, y, x, y, color, frameCount, startFrame);
 }
 
 void DebugHud::DrawLine(int x, int y, int x2, int y2, int color, int frameCount, int startFrame)
 {
-	AddCommand(unique_ptr<DrawCommand>(new DrawLineCommand(x, y, x2, y2, color, frameCount, startFrame)));
+	AddPrimitive(HudCommandType::Line, x, y, x2, y2, color, frameCount, startFrame);
 }
 
 void DebugHud::DrawRectangle(int x, int y, int width, int height, int color, bool fill, int frameCount, int startFrame)
 {
-	AddCommand(unique_ptr<DrawCommand>(new DrawRectangleCommand(x, y, width, height, color, fill, frameCount, startFrame)));
+	if(width < 0) {
+		x += width + 1;
+		width = -width;
+	}
+	if(height < 0) {
+		y += height + 1;
+		height = -height;
+	}
+
+	//Zero-sized rectangles are still added: fills draw nothing, but outlines still draw their sides
+	//(e.g a width of 0 draws 2 adjacent vertical lines)
+	AddPrimitive(fill ? HudCommandType::FilledRectangle : HudCommandType::Rectangle, x, y, x + width - 1, y + height - 1, color, frameCount, startFrame);
 }
 
 void DebugHud::DrawString(int x, int y, string text, int color, int backColor, int frameCount, int startFrame, int maxWidth)
@@ -3,21 +3,27 @@
 #include "Utilities/SimpleLock.h"
 #include "Shared/SettingTypes.h"
 #include "Shared/Video/DrawCommand.h"
+#include "Shared/Video/HudPrimitiveRenderer.h"
 
 class DebugHud
 {
 private:
 	static constexpr size_t MaxCommandCount = 500000;
-	vector<unique_ptr<DrawCommand>> _commands;
+	vector<HudCommand> _commands;
+	HudPrimitiveRenderer _renderer;
 	atomic<uint32_t> _commandCount;
 	SimpleLock _commandLock;
 	unordered_map<uint32_t, uint32_t> _drawPixels;
 
+	void DrawCommands(unordered_map<uint32_t, uint32_t>* drawPixels, uint32_t* argbBuffer, FrameInfo& frameInfo, OverscanDimensions& overscan, uint32_t frameNumber, HudScaleFactors& scaleFactors);
+	void AddPrimitive(HudCommandType type, int x, int y, int x2, int y2, int color, int frameCount, int startFrame);
+
 public:
 	DebugHud();
 	~DebugHud();
 
 	bool HasCommands() { return _commandCount > 0; }
+	uint32_t GetCommandCount() { return _commandCount; }
 
 	bool Draw(uint32_t* argbBuffer, FrameInfo frameInfo, OverscanDimensions overscan, uint32_t frameNumber, HudScaleFactors scaleFactors, bool clearAndUpdate = false);
 	void ClearScreen();
@@ -31,7 +37,9 @@ public:
 	{
 		auto lock = _commandLock.AcquireSafe();
 		if(_commands.size() < DebugHud::MaxCommandCount) {
-			_commands.push_back(std::move(cmd));
+			HudCommand& entry = _commands.emplace_back();
+			entry.Type = HudCommandType::Object;
+			entry.Object = std::move(cmd);
 			_commandCount++;
 		}
 	}
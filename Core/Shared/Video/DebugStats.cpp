@@ -6,6 +6,7 @@
 #include "Shared/Emulator.h"
 #include "Shared/RewindManager.h"
 #include "Shared/EmuSettings.h"
+#include "Shared/Video/VideoDecoder.h"
 
 void DebugStats::DisplayStats(Emulator *emu, double lastFrameTime)
 {
@@ -103,4 +104,50 @@ void DebugStats::DisplayStats(Emulator *emu, double lastFrameTime)
 		ss << "   Per min.: " << std::fixed << std::setprecision(2) << (memUsage * 60 * 60 / rewindStats.HistoryDuration) << " MB";
 		hud->DrawString(9, 82, ss.str(), 0xFFFFFF, 0xFF000000, 1, startFrame);
 	}
+
+	DisplayPipelineStats(emu, startFrame);
+}
+
+void DebugStats::DisplayPipelineStats(Emulator* emu, int startFrame)
+{
+	DebugHud* hud = emu->GetDebugHud();
+	FrameTimingHistogram& latency = emu->GetVideoDecoder()->GetPresentLatency();
+	FrameTimingHistogram& stalls = emu->GetVideoDecoder()->GetStallTime();
+
+	hud->DrawRectangle(8, 97, 243, 49, 0x40000000, true, 1, startFrame);
+	hud->DrawRectangle(8, 97, 243, 49, 0xFFFFFF, false, 1, startFrame);
+	hud->DrawString(10, 99, "Frame Pipeline", 0xFFFFFF, 0xFF000000, 1, startFrame);
+
+	std::stringstream ss;
+	ss << "Latency: " << std::fixed << std::setprecision(2) << latency.GetAverage() << " ms";
+	hud->DrawString(10, 110, ss.str(), 0xFFFFFF, 0xFF000000, 1, startFrame);
+
+	ss = std::stringstream();
+	ss << "  Max: " << std::fixed << std::setprecision(2) << latency.GetMax() << " ms";
+	hud->DrawString(10, 119, ss.str(), 0xFFFFFF, 0xFF000000, 1, startFrame);
+
+	//Waits shorter than 1ms aren't counted as stalls
+	uint32_t stallCount = stalls.GetTotalCount() - stalls.GetCount(0);
+	int color = stallCount > 0 ? 0xFFA500 : 0xFFFFFF;
+	hud->DrawString(10, 128, "Stalls: " + std::to_string(stallCount), color, 0xFF000000, 1, startFrame);
+
+	ss = std::stringstream();
+	ss << "  Max: " << std::fixed << std::setprecision(2) << stalls.GetMax() << " ms";
+	hud->DrawString(10, 137, ss.str(), color, 0xFF000000, 1, startFrame);
+
+	//Latency histogram, one bar per bucket (<1ms, <2ms, <4ms ... 32ms+)
+	uint32_t maxCount = 1;
+	for(uint32_t i = 0; i < FrameTimingHistogram::BucketCount; i++) {
+		maxCount = std::max(maxCount, latency.GetCount(i));
+	}
+
+	for(uint32_t i = 0; i < FrameTimingHistogram::BucketCount; i++) {
+		int height = (int)((uint64_t)latency.GetCount(i) * 25 / maxCount);
+		if(height > 0) {
+			int barColor = i < 5 ? 0x00FF00 : (i < 6 ? 0xFFA500 : 0xFF0000);
+			hud->DrawRectangle(134 + i * 16, 135 - height, 14, height, barColor, true, 1, startFrame);
+		}
+	}
+	hud->DrawString(134, 137, "<1ms", 0xFFFFFF, 0xFF000000, 1, startFrame);
+	hud->DrawString(222, 137, "32+", 0xFFFFFF, 0xFF000000, 1, startFrame);
 }
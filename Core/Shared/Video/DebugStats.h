@@ -3,6 +3,67 @@
 
 class Emulator;
 
+//Lock-free histogram of durations, written by one thread and read by the UI/emulation threads.
+//Bucket i counts durations < 2^i ms, the last bucket counts everything above.
+class FrameTimingHistogram
+{
+public:
+	static constexpr uint32_t BucketCount = 7;
+
+private:
+	atomic<uint32_t> _buckets[BucketCount] = {};
+	atomic<uint64_t> _totalUs;
+	atomic<uint32_t> _maxUs;
+
+public:
+	FrameTimingHistogram()
+	{
+		Reset();
+	}
+
+	void Add(double ms)
+	{
+		uint32_t bucket = 0;
+		while(bucket < BucketCount - 1 && ms >= (double)(1 << bucket)) {
+			bucket++;
+		}
+		_buckets[bucket]++;
+
+		uint32_t us = (uint32_t)std::min(ms * 1000, (double)UINT32_MAX);
+		_totalUs += us;
+		if(us > _maxUs) {
+			_maxUs = us;
+		}
+	}
+
+	void Reset()
+	{
+		for(uint32_t i = 0; i < BucketCount; i++) {
+			_buckets[i] = 0;
+		}
+		_totalUs = 0;
+		_maxUs = 0;
+	}
+
+	uint32_t GetCount(uint32_t bucket) { return _buckets[bucket]; }
+	double GetMax() { return _maxUs / 1000.0; }
+
+	uint32_t GetTotalCount()
+	{
+		uint32_t count = 0;
+		for(uint32_t i = 0; i < BucketCount; i++) {
+			count += _buckets[i];
+		}
+		return count;
+	}
+
+	double GetAverage()
+	{
+		uint32_t count = GetTotalCount();
+		return count ? (_totalUs / 1000.0 / count) : 0;
+	}
+};
+
 class DebugStats
 {
 private:
@@ -11,6 +72,8 @@ private:
 	double _lastFrameMin = 9999;
 	double _lastFrameMax = 0;
 
+	void DisplayPipelineStats(Emulator* emu, int startFrame);
+
 public:
 	void DisplayStats(Emulator *emu, double lastFrameTime);
 };
\ No newline at end of file
@@ -110,6 +110,22 @@ protected:
 		}
 	}
 
+	void SetTarget(unordered_map<uint32_t, uint32_t>* drawnPixels, uint32_t* argbBuffer, FrameInfo frameInfo, OverscanDimensions& overscan, HudScaleFactors& scaleFactors)
+	{
+		_argbBuffer = argbBuffer;
+		_drawnPixels = drawnPixels;
+		_frameInfo = frameInfo;
+		_overscan = overscan;
+
+		if(scaleFactors.X != 0 && scaleFactors.Y != 0) {
+			_xScale = scaleFactors.X;
+			_yScale = scaleFactors.Y;
+		} else {
+			_yScale = 1;
+			_xScale = 1;
+		}
+	}
+
 public:
 	DrawCommand(int startFrame, int frameCount, bool useIntegerScaling = false)
 	{ 
@@ -130,19 +146,7 @@ public:
 		}
 
 		if(_startFrame <= (int32_t)frameNumber) {
-			_argbBuffer = argbBuffer;
-			_drawnPixels = drawnPixels;
-			_frameInfo = frameInfo;
-			_overscan = overscan;
-
-			if(scaleFactors.X != 0 && scaleFactors.Y != 0) {
-				_xScale = scaleFactors.X;
-				_yScale = scaleFactors.Y;
-			} else {
-				_yScale = 1;
-				_xScale = 1;
-			}
-
+			SetTarget(drawnPixels, argbBuffer, frameInfo, overscan, scaleFactors);
 			InternalDraw();
 
 			_frameCount--;
@@ -0,0 +1,117 @@
+#pragma once
+#include "pch.h"
+#include "Shared/Video/DrawCommand.h"
+
+enum class HudCommandType : uint8_t
+{
+	Object, //DrawCommand instance (strings, screen buffers)
+	Line,
+	Rectangle,
+	FilledRectangle, //Also used for pixels & horizontal/vertical spans of pixels
+};
+
+//DebugHud command list entry - pixels, lines & rectangles are stored inline (no allocation per primitive)
+struct HudCommand
+{
+	HudCommandType Type;
+	int32_t X;
+	int32_t Y;
+	int32_t X2; //Inclusive
+	int32_t Y2; //Inclusive
+	int32_t Color; //Alpha byte is inverted (0 = opaque)
+	int32_t FrameCount;
+	int32_t StartFrame;
+	unique_ptr<DrawCommand> Object;
+};
+
+//Draws the inline DebugHud primitives, using the same per-pixel logic (scaling, blending, dirty tracking) as DrawCommand
+class HudPrimitiveRenderer : public DrawCommand
+{
+protected:
+	void InternalDraw() override
+	{
+	}
+
+	void DrawLine(HudCommand& cmd)
+	{
+		int x = cmd.X;
+		int y = cmd.Y;
+		int dx = abs(cmd.X2 - x), sx = x < cmd.X2 ? 1 : -1;
+		int dy = abs(cmd.Y2 - y), sy = y < cmd.Y2 ? 1 : -1;
+		int err = (dx > dy ? dx : -dy) / 2, e2;
+
+		while(true) {
+			DrawPixel(x, y, cmd.Color);
+			if(x == cmd.X2 && y == cmd.Y2) {
+				break;
+			}
+
+			e2 = err;
+			if(e2 > -dx) {
+				err -= dy; x += sx;
+			}
+			if(e2 < dy) {
+				err += dx; y += sy;
+			}
+		}
+	}
+
+	void DrawRectangle(HudCommand& cmd)
+	{
+		int width = cmd.X2 - cmd.X + 1;
+		int height = cmd.Y2 - cmd.Y + 1;
+		for(int i = 0; i < width; i++) {
+			DrawPixel(cmd.X + i, cmd.Y, cmd.Color);
+			DrawPixel(cmd.X + i, cmd.Y + height - 1, cmd.Color);
+		}
+		for(int i = 1; i < height - 1; i++) {
+			DrawPixel(cmd.X, cmd.Y + i, cmd.Color);
+			DrawPixel(cmd.X + width - 1, cmd.Y + i, cmd.Color);
+		}
+	}
+
+	void FillRectangle(HudCommand& cmd)
+	{
+		uint32_t alpha = cmd.Color & 0xFF000000;
+		if(alpha == 0xFF000000 && !_drawnPixels && _xScale == 1 && _yScale == 1) {
+			//Opaque & unscaled: clip once and fill each row
+			int left = (int)_overscan.Left;
+			int top = (int)_overscan.Top;
+			int x = std::max(cmd.X, left) - left;
+			int x2 = std::min(cmd.X2, left + (int)_frameInfo.Width - 1) - left;
+			int y = std::max(cmd.Y, top) - top;
+			int y2 = std::min(cmd.Y2, top + (int)_frameInfo.Height - 1) - top;
+			for(int row = y; row <= y2 && x <= x2; row++) {
+				uint32_t* start = _argbBuffer + row * _frameInfo.Width;
+				std::fill(start + x, start + x2 + 1, (uint32_t)cmd.Color);
+			}
+			return;
+		}
+
+		for(int y = cmd.Y; y <= cmd.Y2; y++) {
+			for(int x = cmd.X; x <= cmd.X2; x++) {
+				DrawPixel(x, y, cmd.Color);
+			}
+		}
+	}
+
+public:
+	HudPrimitiveRenderer() : DrawCommand(0, 0)
+	{
+	}
+
+	void SetTarget(unordered_map<uint32_t, uint32_t>* drawnPixels, uint32_t* argbBuffer, FrameInfo frameInfo, OverscanDimensions& overscan, HudScaleFactors& scaleFactors)
+	{
+		DrawCommand::SetTarget(drawnPixels, argbBuffer, frameInfo, overscan, scaleFactors);
+	}
+
+	void Draw(HudCommand& cmd)
+	{
+		switch(cmd.Type) {
+			case HudCommandType::Line: DrawLine(cmd); break;
+			case HudCommandType::Rectangle: DrawRectangle(cmd); break;
+			case HudCommandType::FilledRectangle: FillRectangle(cmd); break;
+			case HudCommandType::Object: break;
+		}
+	}
+};
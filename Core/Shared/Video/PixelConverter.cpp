@@ -0,0 +1,386 @@
+#include "pch.h"
+#include "Shared/Video/PixelConverter.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+	//SSE2 is always available on x64, AVX2 is detected at runtime
+	#define PIXELCONVERTER_X64
+	#include <immintrin.h>
+	#ifdef _MSC_VER
+		#include <intrin.h>
+		#define PIXELCONVERTER_AVX2
+	#else
+		#define PIXELCONVERTER_AVX2 __attribute__((target("avx2")))
+	#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+	//NEON is always available on ARM64
+	#define PIXELCONVERTER_NEON
+	#include <arm_neon.h>
+#endif
+
+struct PixelConverterKernels
+{
+	PixelConverterIsa Isa;
+	void (*Convert)(const uint16_t* in, uint32_t* out, uint32_t count);
+	void (*ConvertDoubled)(const uint16_t* in, uint32_t* out, uint32_t count);
+	void (*ConvertAndBlend)(const uint16_t* a, const uint16_t* b, uint32_t* out, uint32_t count);
+	void (*BlendWithNext)(uint32_t* pixels, uint32_t count);
+};
+
+//Scalar implementation - also used for the pixels left over by the SIMD loops
+static __forceinline uint32_t ExpandRgb555(uint16_t rgb555)
+{
+	//Move the 3 channels to the low bits of separate bytes, then expand all of them at once
+	uint32_t t = ((rgb555 & 0x1F) << 16) | ((rgb555 & 0x3E0) << 3) | ((rgb555 & 0x7C00) >> 10);
+	return 0xFF000000 | (t << 3) | ((t >> 2) & 0x070707);
+}
+
+static __forceinline uint32_t BlendArgb(uint32_t a, uint32_t b)
+{
+	return (((a ^ b) & 0xFFFEFEFE) >> 1) + (a & b);
+}
+
+static void ConvertScalar(const uint16_t* in, uint32_t* out, uint32_t count)
+{
+	for(uint32_t i = 0; i < count; i++) {
+		out[i] = ExpandRgb555(in[i]);
+	}
+}
+
+static void ConvertDoubledScalar(const uint16_t* in, uint32_t* out, uint32_t count)
+{
+	for(uint32_t i = 0; i < count; i++) {
+		uint32_t argb = ExpandRgb555(in[i]);
+		out[i * 2] = argb;
+		out[i * 2 + 1] = argb;
+	}
+}
+
+static void ConvertAndBlendScalar(const uint16_t* a, const uint16_t* b, uint32_t* out, uint32_t count)
+{
+	for(uint32_t i = 0; i < count; i++) {
+		out[i] = BlendArgb(ExpandRgb555(a[i]), ExpandRgb555(b[i]));
+	}
+}
+
+static void BlendWithNextScalar(uint32_t* pixels, uint32_t count)
+{
+	for(uint32_t i = 0; i + 1 < count; i++) {
+		pixels[i] = BlendArgb(pixels[i], pixels[i + 1]);
+	}
+}
+
+static const PixelConverterKernels _scalarKernels = { PixelConverterIsa::Scalar, ConvertScalar, ConvertDoubledScalar, ConvertAndBlendScalar, BlendWithNextScalar };
+
+#ifdef PIXELCONVERTER_X64
+//SSE2: 8 pixels per iteration (4 per register)
+static __forceinline __m128i ExpandSse2(__m128i v)
+{
+	__m128i r = _mm_slli_epi32(_mm_and_si128(v, _mm_set1_epi32(0x1F)), 16);
+	__m128i g = _mm_slli_epi32(_mm_and_si128(v, _mm_set1_epi32(0x3E0)), 3);
+	__m128i b = _mm_srli_epi32(_mm_and_si128(v, _mm_set1_epi32(0x7C00)), 10);
+	__m128i t = _mm_or_si128(_mm_or_si128(r, g), b);
+	__m128i lowBits = _mm_and_si128(_mm_srli_epi32(t, 2), _mm_set1_epi32(0x070707));
+	return _mm_or_si128(_mm_or_si128(_mm_slli_epi32(t, 3), lowBits), _mm_set1_epi32((int)0xFF000000));
+}
+
+static __forceinline __m128i BlendSse2(__m128i a, __m128i b)
+{
+	__m128i diff = _mm_and_si128(_mm_xor_si128(a, b), _mm_set1_epi32((int)0xFFFEFEFE));
+	return _mm_add_epi32(_mm_srli_epi32(diff, 1), _mm_and_si128(a, b));
+}
+
+static void ConvertSse2(const uint16_t* in, uint32_t* out, uint32_t count)
+{
+	__m128i zero = _mm_setzero_si128();
+	uint32_t i = 0;
+	for(; i + 8 <= count; i += 8) {
+		__m128i px = _mm_loadu_si128((const __m128i*)(in + i));
+		_mm_storeu_si128((__m128i*)(out + i), ExpandSse2(_mm_unpacklo_epi16(px, zero)));
+		_mm_storeu_si128((__m128i*)(out + i + 4), ExpandSse2(_mm_unpackhi_epi16(px, zero)));
+	}
+	ConvertScalar(in + i, out + i, count - i);
+}
+
+static void ConvertDoubledSse2(const uint16_t* in, uint32_t* out, uint32_t count)
+{
+	__m128i zero = _mm_setzero_si128();
+	uint32_t i = 0;
+	for(; i + 8 <= count; i += 8) {
+		__m128i px = _mm_loadu_si128((const __m128i*)(in + i));
+		__m128i lo = ExpandSse2(_mm_unpacklo_epi16(px, zero));
+		__m128i hi = ExpandSse2(_mm_unpackhi_epi16(px, zero));
+		_mm_storeu_si128((__m128i*)(out + i * 2), _mm_unpacklo_epi32(lo, lo));
+		_mm_storeu_si128((__m128i*)(out + i * 2 + 4), _mm_unpackhi_epi32(lo, lo));
+		_mm_storeu_si128((__m128i*)(out + i * 2 + 8), _mm_unpacklo_epi32(hi, hi));
+		_mm_storeu_si128((__m128i*)(out + i * 2 + 12), _mm_unpackhi_epi32(hi, hi));
+	}
+	ConvertDoubledScalar(in + i, out + i * 2, count - i);
+}
+
+static void ConvertAndBlendSse2(const uint16_t* a, const uint16_t* b, uint32_t* out, uint32_t count)
+{
+	__m128i zero = _mm_setzero_si128();
+	uint32_t i = 0;
+	for(; i + 8 <= count; i += 8) {
+		__m128i pxA = _mm_loadu_si128((const __m128i*)(a + i));
+		__m128i pxB = _mm_loadu_si128((const __m128i*)(b + i));
+		_mm_storeu_si128((__m128i*)(out + i), BlendSse2(ExpandSse2(_mm_unpacklo_epi16(pxA, zero)), ExpandSse2(_mm_unpacklo_epi16(pxB, zero))));
+		_mm_storeu_si128((__m128i*)(out + i + 4), BlendSse2(ExpandSse2(_mm_unpackhi_epi16(pxA, zero)), ExpandSse2(_mm_unpackhi_epi16(pxB, zero))));
+	}
+	ConvertAndBlendScalar(a + i, b + i, out + i, count - i);
+}
+
+static void BlendWithNextSse2(uint32_t* pixels, uint32_t count)
+{
+	//Both loads are done before the store, and the next iteration only reads pixels that haven't been written yet
+	uint32_t i = 0;
+	for(; i + 5 <= count; i += 4) {
+		__m128i a = _mm_loadu_si128((const __m128i*)(pixels + i));
+		__m128i b = _mm_loadu_si128((const __m128i*)(pixels + i + 1));
+		_mm_storeu_si128((__m128i*)(pixels + i), BlendSse2(a, b));
+	}
+	BlendWithNextScalar(pixels + i, count - i);
+}
+
+static const PixelConverterKernels _sse2Kernels = { PixelConverterIsa::Sse2, ConvertSse2, ConvertDoubledSse2, ConvertAndBlendSse2, BlendWithNextSse2 };
+
+//AVX2: 16 pixels per iteration (8 per register)
+PIXELCONVERTER_AVX2 static __forceinline __m256i ExpandAvx2(__m256i v)
+{
+	__m256i r = _mm256_slli_epi32(_mm256_and_si256(v, _mm256_set1_epi32(0x1F)), 16);
+	__m256i g = _mm256_slli_epi32(_mm256_and_si256(v, _mm256_set1_epi32(0x3E0)), 3);
+	__m256i b = _mm256_srli_epi32(_mm256_and_si256(v, _mm256_set1_epi32(0x7C00)), 10);
+	__m256i t = _mm256_or_si256(_mm256_or_si256(r, g), b);
+	__m256i lowBits = _mm256_and_si256(_mm256_srli_epi32(t, 2), _mm256_set1_epi32(0x070707));
+	return _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(t, 3), lowBits), _mm256_set1_epi32((int)0xFF000000));
+}
+
+PIXELCONVERTER_AVX2 static __forceinline __m256i BlendAvx2(__m256i a, __m256i b)
+{
+	__m256i diff = _mm256_and_si256(_mm256_xor_si256(a, b), _mm256_set1_epi32((int)0xFFFEFEFE));
+	return _mm256_add_epi32(_mm256_srli_epi32(diff, 1), _mm256_and_si256(a, b));
+}
+
+PIXELCONVERTER_AVX2 static __forceinline __m256i LoadRgb555Avx2(const uint16_t* in)
+{
+	return _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)in));
+}
+
+PIXELCONVERTER_AVX2 static void ConvertAvx2(const uint16_t* in, uint32_t* out, uint32_t count)
+{
+	uint32_t i = 0;
+	for(; i + 16 <= count; i += 16) {
+		_mm256_storeu_si256((__m256i*)(out + i), ExpandAvx2(LoadRgb555Avx2(in + i)));
+		_mm256_storeu_si256((__m256i*)(out + i + 8), ExpandAvx2(LoadRgb555Avx2(in + i + 8)));
+	}
+	ConvertScalar(in + i, out + i, count - i);
+}
+
+PIXELCONVERTER_AVX2 static void ConvertDoubledAvx2(const uint16_t* in, uint32_t* out, uint32_t count)
+{
+	uint32_t i = 0;
+	for(; i + 8 <= count; i += 8) {
+		__m256i argb = ExpandAvx2(LoadRgb555Avx2(in + i));
+		//unpack works on each 128-bit half: lo = p0 p0 p1 p1 | p4 p4 p5 p5, hi = p2 p2 p3 p3 | p6 p6 p7 p7
+		__m256i lo = _mm256_unpacklo_epi32(argb, argb);
+		__m256i hi = _mm256_unpackhi_epi32(argb, argb);
+		_mm256_storeu_si256((__m256i*)(out + i * 2), _mm256_permute2x128_si256(lo, hi, 0x20));
+		_mm256_storeu_si256((__m256i*)(out + i * 2 + 8), _mm256_permute2x128_si256(lo, hi, 0x31));
+	}
+	ConvertDoubledScalar(in + i, out + i * 2, count - i);
+}
+
+PIXELCONVERTER_AVX2 static void ConvertAndBlendAvx2(const uint16_t* a, const uint16_t* b, uint32_t* out, uint32_t count)
+{
+	uint32_t i = 0;
+	for(; i + 16 <= count; i += 16) {
+		_mm256_storeu_si256((__m256i*)(out + i), BlendAvx2(ExpandAvx2(LoadRgb555Avx2(a + i)), ExpandAvx2(LoadRgb555Avx2(b + i))));
+		_mm256_storeu_si256((__m256i*)(out + i + 8), BlendAvx2(ExpandAvx2(LoadRgb555Avx2(a + i + 8)), ExpandAvx2(LoadRgb555Avx2(b + i + 8))));
+	}
+	ConvertAndBlendScalar(a + i, b + i, out + i, count - i);
+}
+
+PIXELCONVERTER_AVX2 static void BlendWithNextAvx2(uint32_t* pixels, uint32_t count)
+{
+	uint32_t i = 0;
+	for(; i + 9 <= count; i += 8) {
+		__m256i a = _mm256_loadu_si256((const __m256i*)(pixels + i));
+		__m256i b = _mm256_loadu_si256((const __m256i*)(pixels + i + 1));
+		_mm256_storeu_si256((__m256i*)(pixels + i), BlendAvx2(a, b));
+	}
+	BlendWithNextScalar(pixels + i, count - i);
+}
+
+static const PixelConverterKernels _avx2Kernels = { PixelConverterIsa::Avx2, ConvertAvx2, ConvertDoubledAvx2, ConvertAndBlendAvx2, BlendWithNextAvx2 };
+
+static bool IsAvx2Supported()
+{
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 0);
+	if(info[0] < 7) {
+		return false;
+	}
+
+	//AVX2 also requires the OS to save the YMM registers (OSXSAVE + XCR0)
+	__cpuid(info, 1);
+	bool osxsave = (info[2] & (1 << 27)) != 0;
+	bool avx = (info[2] & (1 << 28)) != 0;
+	if(!osxsave || !avx || (_xgetbv(0) & 0x06) != 0x06) {
+		return false;
+	}
+
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#else
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+#ifdef PIXELCONVERTER_NEON
+//NEON: 8 pixels per iteration (4 per register)
+static __forceinline uint32x4_t ExpandNeon(uint32x4_t v)
+{
+	uint32x4_t r = vshlq_n_u32(vandq_u32(v, vdupq_n_u32(0x1F)), 16);
+	uint32x4_t g = vshlq_n_u32(vandq_u32(v, vdupq_n_u32(0x3E0)), 3);
+	uint32x4_t b = vshrq_n_u32(vandq_u32(v, vdupq_n_u32(0x7C00)), 10);
+	uint32x4_t t = vorrq_u32(vorrq_u32(r, g), b);
+	uint32x4_t lowBits = vandq_u32(vshrq_n_u32(t, 2), vdupq_n_u32(0x070707));
+	return vorrq_u32(vorrq_u32(vshlq_n_u32(t, 3), lowBits), vdupq_n_u32(0xFF000000));
+}
+
+static __forceinline uint32x4_t BlendNeon(uint32x4_t a, uint32x4_t b)
+{
+	uint32x4_t diff = vandq_u32(veorq_u32(a, b), vdupq_n_u32(0xFFFEFEFE));
+	return vaddq_u32(vshrq_n_u32(diff, 1), vandq_u32(a, b));
+}
+
+static void ConvertNeon(const uint16_t* in, uint32_t* out, uint32_t count)
+{
+	uint32_t i = 0;
+	for(; i + 8 <= count; i += 8) {
+		uint16x8_t px = vld1q_u16(in + i);
+		vst1q_u32(out + i, ExpandNeon(vmovl_u16(vget_low_u16(px))));
+		vst1q_u32(out + i + 4, ExpandNeon(vmovl_u16(vget_high_u16(px))));
+	}
+	ConvertScalar(in + i, out + i, count - i);
+}
+
+static void ConvertDoubledNeon(const uint16_t* in, uint32_t* out, uint32_t count)
+{
+	uint32_t i = 0;
+	for(; i + 8 <= count; i += 8) {
+		uint16x8_t px = vld1q_u16(in + i);
+		uint32x4_t lo = ExpandNeon(vmovl_u16(vget_low_u16(px)));
+		uint32x4_t hi = ExpandNeon(vmovl_u16(vget_high_u16(px)));
+		uint32x4x2_t loPairs = vzipq_u32(lo, lo);
+		uint32x4x2_t hiPairs = vzipq_u32(hi, hi);
+		vst1q_u32(out + i * 2, loPairs.val[0]);
+		vst1q_u32(out + i * 2 + 4, loPairs.val[1]);
+		vst1q_u32(out + i * 2 + 8, hiPairs.val[0]);
+		vst1q_u32(out + i * 2 + 12, hiPairs.val[1]);
+	}
+	ConvertDoubledScalar(in + i, out + i * 2, count - i);
+}
+
+static void ConvertAndBlendNeon(const uint16_t* a, const uint16_t* b, uint32_t* out, uint32_t count)
+{
+	uint32_t i = 0;
+	for(; i + 8 <= count; i += 8) {
+		uint16x8_t pxA = vld1q_u16(a + i);
+		uint16x8_t pxB = vld1q_u16(b + i);
+		vst1q_u32(out + i, BlendNeon(ExpandNeon(vmovl_u16(vget_low_u16(pxA))), ExpandNeon(vmovl_u16(vget_low_u16(pxB)))));
+		vst1q_u32(out + i + 4, BlendNeon(ExpandNeon(vmovl_u16(vget_high_u16(pxA))), ExpandNeon(vmovl_u16(vget_high_u16(pxB)))));
+	}
+	ConvertAndBlendScalar(a + i, b + i, out + i, count - i);
+}
+
+static void BlendWithNextNeon(uint32_t* pixels, uint32_t count)
+{
+	uint32_t i = 0;
+	for(; i + 5 <= count; i += 4) {
+		uint32x4_t a = vld1q_u32(pixels + i);
+		uint32x4_t b = vld1q_u32(pixels + i + 1);
+		vst1q_u32(pixels + i, BlendNeon(a, b));
+	}
+	BlendWithNextScalar(pixels + i, count - i);
+}
+
+static const PixelConverterKernels _neonKernels = { PixelConverterIsa::Neon, ConvertNeon, ConvertDoubledNeon, ConvertAndBlendNeon, BlendWithNextNeon };
+#endif
+
+static const PixelConverterKernels* GetKernels(PixelConverterIsa isa)
+{
+	switch(isa) {
+		case PixelConverterIsa::Scalar: return &_scalarKernels;
+#ifdef PIXELCONVERTER_X64
+		case PixelConverterIsa::Sse2: return &_sse2Kernels;
+		case PixelConverterIsa::Avx2: return IsAvx2Supported() ? &_avx2Kernels : nullptr;
+#endif
+#ifdef PIXELCONVERTER_NEON
+		case PixelConverterIsa::Neon: return &_neonKernels;
+#endif
+		default: return nullptr;
+	}
+}
+
+static const PixelConverterKernels* GetBestKernels()
+{
+	for(PixelConverterIsa isa : { PixelConverterIsa::Avx2, PixelConverterIsa::Neon, PixelConverterIsa::Sse2 }) {
+		if(const PixelConverterKernels* kernels = GetKernels(isa)) {
+			return kernels;
+		}
+	}
+	return &_scalarKernels;
+}
+
+//Only changed by SetIsa (benchmarks), the filters just read it
+static const PixelConverterKernels* _kernels = GetBestKernels();
+
+void PixelConverter::ConvertRgb555(const uint16_t* in, uint32_t* out, uint32_t count)
+{
+	_kernels->Convert(in, out, count);
+}
+
+void PixelConverter::ConvertRgb555Doubled(const uint16_t* in, uint32_t* out, uint32_t count)
+{
+	_kernels->ConvertDoubled(in, out, count);
+}
+
+void PixelConverter::ConvertAndBlendRgb555(const uint16_t* a, const uint16_t* b, uint32_t* out, uint32_t count)
+{
+	_kernels->ConvertAndBlend(a, b, out, count);
+}
+
+void PixelConverter::BlendWithNextPixel(uint32_t* pixels, uint32_t count)
+{
+	_kernels->BlendWithNext(pixels, count);
+}
+
+PixelConverterIsa PixelConverter::GetIsa()
+{
+	return _kernels->Isa;
+}
+
+vector<PixelConverterIsa> PixelConverter::GetSupportedIsas()
+{
+	vector<PixelConverterIsa> isas;
+	for(PixelConverterIsa isa : { PixelConverterIsa::Scalar, PixelConverterIsa::Sse2, PixelConverterIsa::Avx2, PixelConverterIsa::Neon }) {
+		if(GetKernels(isa)) {
+			isas.push_back(isa);
+		}
+	}
+	return isas;
+}
+
+bool PixelConverter::SetIsa(PixelConverterIsa isa)
+{
+	const PixelConverterKernels* kernels = GetKernels(isa);
+	if(!kernels) {
+		return false;
+	}
+	_kernels = kernels;
+	return true;
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include "pch.h"
+
+enum class PixelConverterIsa
+{
+	Scalar,
+	Sse2,
+	Avx2,
+	Neon
+};
+
+//Converts 15-bit BGR555 (red in the low bits, bit 15 ignored) frames to ARGB and blends ARGB pixels, several pixels at a time.
+//The output matches the default video filters' lookup tables when no color adjustments are applied:
+//each 5-bit channel is expanded to 8 bits with (c << 3) | (c >> 2) and blending averages each channel (rounding down).
+//The fastest instruction set supported by the CPU is selected at startup.
+class PixelConverter
+{
+public:
+	static void ConvertRgb555(const uint16_t* in, uint32_t* out, uint32_t count);
+
+	//Writes each converted pixel twice (out receives count * 2 pixels)
+	static void ConvertRgb555Doubled(const uint16_t* in, uint32_t* out, uint32_t count);
+
+	//out[i] = blend(convert(a[i]), convert(b[i])), used to blend the previous frame with the current one
+	static void ConvertAndBlendRgb555(const uint16_t* a, const uint16_t* b, uint32_t* out, uint32_t count);
+
+	//pixels[i] = blend(pixels[i], pixels[i + 1]) - the last pixel is left unchanged
+	static void BlendWithNextPixel(uint32_t* pixels, uint32_t count);
+
+	static PixelConverterIsa GetIsa();
+	static vector<PixelConverterIsa> GetSupportedIsas();
+
+	//Forces the instruction set used by all filters (for benchmarks), returns false if the CPU doesn't support it
+	static bool SetIsa(PixelConverterIsa isa);
+};
@@ -6,6 +6,7 @@
 #include "Utilities/HQX/hqx.h"
 #include "Utilities/Scale2x/scalebit.h"
 #include "Utilities/KreedSaiEagle/SaiEagle.h"
+#include "Utilities/ThreadPool.h"
 
 bool ScaleFilter::_hqxInitDone = false;
 
@@ -31,6 +32,29 @@ uint32_t ScaleFilter::GetScale()
 	return _filterScale;
 }
 
+void ScaleFilter::SetThreadCount(uint32_t threadCount)
+{
+	if(threadCount != _threadCount) {
+		_threadCount = threadCount;
+		_pool.reset();
+	}
+}
+
+uint32_t ScaleFilter::GetBandCount(uint32_t height)
+{
+	if(_threadCount == 1 || height < MinBandHeight * 2) {
+		return 1;
+	}
+
+	if(!_pool) {
+		//Created on the first frame, the workers are kept until the filter is destroyed
+		_pool.reset(new ThreadPool(_threadCount > 0 ? _threadCount - 1 : 0));
+	}
+
+	//More bands than threads, so that threads that get cheaper bands (e.g flat areas) pick up more of them
+	return std::max<uint32_t>(1, std::min(_pool->GetConcurrency() * BandsPerThread, height / MinBandHeight));
+}
+
 uint32_t ScaleFilter::ApplyBrightness(uint32_t argb, uint8_t brightness)
 {
 	uint8_t r = ((argb & 0xFF0000) >> 16) * brightness / 255;
@@ -40,7 +64,7 @@ uint32_t ScaleFilter::ApplyBrightness(uint32_t argb, uint8_t brightness)
 	return 0xFF000000 | (r << 16) | (g << 8) | b;
 }
 
-void ScaleFilter::ApplyLcdGridFilter(uint32_t* inputArgbBuffer)
+void ScaleFilter::ApplyLcdGridFilter(uint32_t* inputArgbBuffer, uint32_t yFirst, uint32_t yLast)
 {
 	VideoConfig& cfg = _emu->GetSettings()->GetVideoConfig();
 	uint8_t topLeft = (uint8_t)(cfg.LcdGridTopLeftBrightness * 255);
@@ -48,7 +72,7 @@ void ScaleFilter::ApplyLcdGridFilter(uint32_t* inputArgbBuffer)
 	uint8_t bottomLeft = (uint8_t)(cfg.LcdGridBottomLeftBrightness * 255);
 	uint8_t bottomRight = (uint8_t)(cfg.LcdGridBottomRightBrightness * 255);
 
-	for(uint32_t y = 0; y < _height; y++) {
+	for(uint32_t y = yFirst; y < yLast; y++) {
 		for(uint32_t x = 0; x < _width; x++) {
 			uint32_t srcColor = inputArgbBuffer[y * _width + x];
 			
@@ -61,11 +85,12 @@ void ScaleFilter::ApplyLcdGridFilter(uint32_t* inputArgbBuffer)
 	}
 }
 
-void ScaleFilter::ApplyPrescaleFilter(uint32_t *inputArgbBuffer)
+void ScaleFilter::ApplyPrescaleFilter(uint32_t *inputArgbBuffer, uint32_t yFirst, uint32_t yLast)
 {
-	uint32_t* outputBuffer = _outputBuffer;
+	uint32_t* outputBuffer = _outputBuffer + yFirst * _width * _filterScale * _filterScale;
+	inputArgbBuffer += yFirst * _width;
 
-	for(uint32_t y = 0; y < _height; y++) {
+	for(uint32_t y = yFirst; y < yLast; y++) {
 		for(uint32_t x = 0; x < _width; x++) {
 			for(uint32_t i = 0; i < _filterScale; i++) {
 				*(outputBuffer++) = *inputArgbBuffer;
@@ -89,26 +114,46 @@ void ScaleFilter::UpdateOutputBuffer(uint32_t width, uint32_t height)
 	}
 }
 
-uint32_t* ScaleFilter::ApplyFilter(uint32_t *inputArgbBuffer, uint32_t width, uint32_t height)
+void ScaleFilter::ApplyFilterToRows(uint32_t* inputArgbBuffer, uint32_t yFirst, uint32_t yLast)
 {
-	UpdateOutputBuffer(width, height);
+	uint32_t width = _width;
+	uint32_t height = _height;
 
 	if(_scaleFilterType == ScaleFilterType::xBRZ) {
-		xbrz::scale(_filterScale, inputArgbBuffer, _outputBuffer, width, height, xbrz::ColorFormat::ARGB);
+		xbrz::scale(_filterScale, inputArgbBuffer, _outputBuffer, width, height, xbrz::ColorFormat::ARGB, xbrz::ScalerCfg(), yFirst, yLast);
 	} else if(_scaleFilterType == ScaleFilterType::HQX) {
-		hqx(_filterScale, inputArgbBuffer, _outputBuffer, width, height);
+		hqx(_filterScale, inputArgbBuffer, _outputBuffer, width, height, yFirst, yLast);
 	} else if(_scaleFilterType == ScaleFilterType::Scale2x) {
-		scale(_filterScale, _outputBuffer, width*sizeof(uint32_t)*_filterScale, inputArgbBuffer, width*sizeof(uint32_t), 4, width, height);
+		if(yFirst == 0 && yLast == height) {
+			//Whole frame (single-threaded), use the original single-pass scaler
+			scale(_filterScale, _outputBuffer, width*sizeof(uint32_t)*_filterScale, inputArgbBuffer, width*sizeof(uint32_t), 4, width, height);
+		} else {
+			scale_slice(_filterScale, _outputBuffer, width*sizeof(uint32_t)*_filterScale, inputArgbBuffer, width*sizeof(uint32_t), 4, width, height, yFirst, yLast);
+		}
 	} else if(_scaleFilterType == ScaleFilterType::_2xSai) {
-		twoxsai_generic_xrgb8888(width, height, inputArgbBuffer, width, _outputBuffer, width * _filterScale);
+		twoxsai_generic_xrgb8888(width, height, inputArgbBuffer, width, _outputBuffer, width * _filterScale, yFirst, yLast);
 	} else if(_scaleFilterType == ScaleFilterType::Super2xSai) {
-		supertwoxsai_generic_xrgb8888(width, height, inputArgbBuffer, width, _outputBuffer, width * _filterScale);
+		supertwoxsai_generic_xrgb8888(width, height, inputArgbBuffer, width, _outputBuffer, width * _filterScale, yFirst, yLast);
 	} else if(_scaleFilterType == ScaleFilterType::SuperEagle) {
-		supereagle_generic_xrgb8888(width, height, inputArgbBuffer, width, _outputBuffer, width * _filterScale);
+		supereagle_generic_xrgb8888(width, height, inputArgbBuffer, width, _outputBuffer, width * _filterScale, yFirst, yLast);
 	} else if(_scaleFilterType == ScaleFilterType::Prescale) {
-		ApplyPrescaleFilter(inputArgbBuffer);
+		ApplyPrescaleFilter(inputArgbBuffer, yFirst, yLast);
 	} else if(_scaleFilterType == ScaleFilterType::LcdGrid) {
-		ApplyLcdGridFilter(inputArgbBuffer);
+		ApplyLcdGridFilter(inputArgbBuffer, yFirst, yLast);
+	}
+}
+
+uint32_t* ScaleFilter::ApplyFilter(uint32_t *inputArgbBuffer, uint32_t width, uint32_t height)
+{
+	UpdateOutputBuffer(width, height);
+
+	uint32_t bandCount = GetBandCount(height);
+	if(bandCount <= 1) {
+		ApplyFilterToRows(inputArgbBuffer, 0, height);
+	} else {
+		_pool->ParallelFor(bandCount, [=](uint32_t band) {
+			ApplyFilterToRows(inputArgbBuffer, height * band / bandCount, height * (band + 1) / bandCount);
+		});
 	}
 
 	return _outputBuffer;
@@ -4,10 +4,16 @@
 #include "Shared/SettingTypes.h"
 
 class Emulator;
+class ThreadPool;
 
+//Frames are split into bands of rows that are scaled in parallel by a thread pool
+//(every filter reads the rows above/below its band but only writes the band's output rows)
 class ScaleFilter
 {
 private:
+	static constexpr uint32_t MinBandHeight = 8;
+	static constexpr uint32_t BandsPerThread = 4;
+
 	static bool _hqxInitDone;
 	
 	Emulator* _emu = nullptr;
@@ -18,17 +24,26 @@ private:
 	uint32_t _width = 0;
 	uint32_t _height = 0;
 
+	unique_ptr<ThreadPool> _pool;
+	uint32_t _threadCount = 0;
+
 	uint32_t ApplyBrightness(uint32_t argb, uint8_t brightness);
-	void ApplyLcdGridFilter(uint32_t* inputArgbBuffer);
+	void ApplyLcdGridFilter(uint32_t* inputArgbBuffer, uint32_t yFirst, uint32_t yLast);
 
-	void ApplyPrescaleFilter(uint32_t *inputArgbBuffer);
+	void ApplyPrescaleFilter(uint32_t *inputArgbBuffer, uint32_t yFirst, uint32_t yLast);
 	void UpdateOutputBuffer(uint32_t width, uint32_t height);
 
+	uint32_t GetBandCount(uint32_t height);
+	void ApplyFilterToRows(uint32_t* inputArgbBuffer, uint32_t yFirst, uint32_t yLast);
+
 public:
 	ScaleFilter(Emulator* emu, ScaleFilterType scaleFilterType, uint32_t scale);
 	~ScaleFilter();
 
 	uint32_t GetScale();
+
+	//Number of threads used to scale a frame, including the calling thread (0 = one per hardware thread, 1 = no worker threads)
+	void SetThreadCount(uint32_t threadCount);
 	uint32_t* ApplyFilter(uint32_t *inputArgbBuffer, uint32_t width, uint32_t height);
 	FrameInfo GetFrameInfo(FrameInfo baseFrameInfo);
 
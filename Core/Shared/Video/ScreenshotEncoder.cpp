@@ -0,0 +1,313 @@
+#include "pch.h"
+#include "Shared/Video/ScreenshotEncoder.h"
+#include "Shared/Video/BaseVideoFilter.h"
+#include "Shared/Video/ScaleFilter.h"
+#include "Shared/Video/RotateFilter.h"
+#include "Shared/Video/ScanlineFilter.h"
+#include "Shared/Emulator.h"
+#include "Shared/EmuSettings.h"
+#include "Utilities/PNGHelper.h"
+#include "Utilities/QoiEncoder.h"
+
+ScreenshotEncoder::ScreenshotEncoder(Emulator* emu)
+{
+	_emu = emu;
+	_prefetchFramesLeft = 0;
+	_lastFrameNumber = 0;
+}
+
+ScreenshotEncoder::~ScreenshotEncoder()
+{
+	{
+		std::unique_lock<std::mutex> lock(_lock);
+		_stopFlag = true;
+	}
+	_jobSignal.notify_all();
+	_resultSignal.notify_all();
+	if(_thread.joinable()) {
+		_thread.join();
+	}
+}
+
+shared_ptr<ScreenshotResult> ScreenshotEncoder::FindResult(uint32_t frameNumber, const ScreenshotOptions& options)
+{
+	for(shared_ptr<ScreenshotResult>& result : _results) {
+		if(result->FrameNumber == frameNumber && result->Options == options) {
+			return result;
+		}
+	}
+	return nullptr;
+}
+
+bool ScreenshotEncoder::IsPending(uint32_t frameNumber, const ScreenshotOptions& options)
+{
+	if(_busy && _busyFrame == frameNumber && _busyOptions == options) {
+		return true;
+	}
+	for(Job& job : _jobs) {
+		if(job.FrameNumber == frameNumber && job.Options == options) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool ScreenshotEncoder::IsWaitedFor(const ScreenshotResult& result)
+{
+	for(std::pair<uint32_t, ScreenshotOptions>& key : _waiting) {
+		if(key.first == result.FrameNumber && key.second == result.Options) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void ScreenshotEncoder::AddResult(shared_ptr<ScreenshotResult> result)
+{
+	_results.push_back(result);
+
+	//Evict the oldest results, except the ones a Capture() call hasn't picked up yet
+	//(prefetched frames can arrive faster than the requesting thread wakes up)
+	auto it = _results.begin();
+	while(_results.size() > MaxResults && it != _results.end()) {
+		if(IsWaitedFor(**it)) {
+			it++;
+		} else {
+			it = _results.erase(it);
+		}
+	}
+}
+
+vector<uint32_t> ScreenshotEncoder::GetFreeBuffer()
+{
+	vector<uint32_t> buffer;
+	if(!_freeBuffers.empty()) {
+		buffer = std::move(_freeBuffers.back());
+		_freeBuffers.pop_back();
+	}
+	return buffer;
+}
+
+void ScreenshotEncoder::OnFrameDecoded(BaseVideoFilter* filter, VideoFilterType filterType)
+{
+	_lastFrameNumber = filter->GetFrameNumber();
+	if(_prefetchFramesLeft.load(std::memory_order_relaxed) == 0) {
+		return;
+	}
+	_prefetchFramesLeft--;
+
+	Job job;
+	{
+		std::unique_lock<std::mutex> lock(_lock);
+		job.Buffer = GetFreeBuffer();
+		job.Options = _prefetchOptions;
+	}
+
+	if(!filter->CopyOutputBuffer(job.Buffer, job.Size, job.FrameNumber)) {
+		return;
+	}
+	job.FilterType = filterType;
+	job.Prefetch = true;
+
+	{
+		std::unique_lock<std::mutex> lock(_lock);
+		//Nobody asked for the previous frame yet, encoding the latest one is more useful
+		for(auto it = _jobs.begin(); it != _jobs.end();) {
+			if(it->Prefetch) {
+				_freeBuffers.push_back(std::move(it->Buffer));
+				it = _jobs.erase(it);
+			} else {
+				it++;
+			}
+		}
+		_jobs.push_back(std::move(job));
+	}
+	_jobSignal.notify_one();
+}
+
+shared_ptr<ScreenshotResult> ScreenshotEncoder::Capture(const ScreenshotFrameCopier& copyFrame, const ScreenshotOptions& options)
+{
+	std::unique_lock<std::mutex> lock(_lock);
+	if(!_thread.joinable()) {
+		_thread = std::thread(&ScreenshotEncoder::WorkerLoop, this);
+	}
+
+	_prefetchOptions = options;
+	_prefetchFramesLeft = PrefetchFrames;
+
+	uint32_t frameNumber = _lastFrameNumber;
+	if(!FindResult(frameNumber, options) && !IsPending(frameNumber, options)) {
+		Job job;
+		job.Buffer = GetFreeBuffer();
+		lock.unlock();
+		bool copied = copyFrame(job.Buffer, job.Size, job.FrameNumber, job.FilterType);
+		lock.lock();
+
+		if(!copied) {
+			return nullptr;
+		}
+
+		//The decode thread may have produced a new frame in the meantime
+		frameNumber = job.FrameNumber;
+		if(!FindResult(frameNumber, options) && !IsPending(frameNumber, options)) {
+			job.Options = options;
+			_jobs.push_front(std::move(job));
+			_jobSignal.notify_one();
+		}
+	}
+
+	//Make sure a queued prefetch of this frame doesn't get replaced by the next one
+	for(Job& job : _jobs) {
+		if(job.FrameNumber == frameNumber && job.Options == options) {
+			job.Prefetch = false;
+		}
+	}
+
+	_waiting.push_back({ frameNumber, options });
+	_resultSignal.wait(lock, [&] { return _stopFlag || FindResult(frameNumber, options) || !IsPending(frameNumber, options); });
+	for(auto it = _waiting.begin(); it != _waiting.end(); it++) {
+		if(it->first == frameNumber && it->second == options) {
+			_waiting.erase(it);
+			break;
+		}
+	}
+	return FindResult(frameNumber, options);
+}
+
+void ScreenshotEncoder::WorkerLoop()
+{
+	std::unique_lock<std::mutex> lock(_lock);
+	while(true) {
+		_jobSignal.wait(lock, [this] { return _stopFlag || !_jobs.empty(); });
+		if(_stopFlag) {
+			break;
+		}
+
+		Job job = std::move(_jobs.front());
+		_jobs.pop_front();
+		_busy = true;
+		_busyFrame = job.FrameNumber;
+		_busyOptions = job.Options;
+
+		lock.unlock();
+		shared_ptr<ScreenshotResult> result = Encode(job);
+		lock.lock();
+
+		_busy = false;
+		AddResult(result);
+		if(_freeBuffers.size() < 2) {
+			_freeBuffers.push_back(std::move(job.Buffer));
+		}
+		_resultSignal.notify_all();
+	}
+}
+
+void ScreenshotEncoder::CropAndDownscale(uint32_t* buffer, FrameInfo& size, const ScreenshotOptions& options, vector<uint32_t>& output)
+{
+	uint32_t cropWidth = options.CropWidth ? std::min(options.CropWidth, size.Width - options.CropX) : size.Width - options.CropX;
+	uint32_t cropHeight = options.CropHeight ? std::min(options.CropHeight, size.Height - options.CropY) : size.Height - options.CropY;
+
+	uint32_t factor = options.Downscale;
+	uint32_t outWidth = cropWidth / factor;
+	uint32_t outHeight = cropHeight / factor;
+	output.resize(outWidth * outHeight);
+
+	uint32_t* src = buffer + options.CropY * size.Width + options.CropX;
+	if(factor == 1) {
+		for(uint32_t y = 0; y < outHeight; y++) {
+			memcpy(output.data() + y * outWidth, src + y * size.Width, outWidth * sizeof(uint32_t));
+		}
+	} else {
+		uint32_t blockSize = factor * factor;
+		for(uint32_t y = 0; y < outHeight; y++) {
+			for(uint32_t x = 0; x < outWidth; x++) {
+				uint32_t r = 0, g = 0, b = 0;
+				uint32_t* block = src + y * factor * size.Width + x * factor;
+				for(uint32_t i = 0; i < factor; i++) {
+					for(uint32_t j = 0; j < factor; j++) {
+						uint32_t px = block[i * size.Width + j];
+						r += (px >> 16) & 0xFF;
+						g += (px >> 8) & 0xFF;
+						b += px & 0xFF;
+					}
+				}
+				output[y * outWidth + x] = 0xFF000000 | ((r / blockSize) << 16) | ((g / blockSize) << 8) | (b / blockSize);
+			}
+		}
+	}
+
+	size.Width = outWidth;
+	size.Height = outHeight;
+}
+
+shared_ptr<ScreenshotResult> ScreenshotEncoder::Encode(Job& job)
+{
+	shared_ptr<ScreenshotResult> result(new ScreenshotResult());
+	result->FrameNumber = job.FrameNumber;
+	result->Options = job.Options;
+
+	//Same processing as BaseVideoFilter::TakeScreenshot
+	uint32_t* buffer = job.Buffer.data();
+	FrameInfo size = job.Size;
+	uint8_t scale = 1;
+
+	VideoConfig cfg = _emu->GetSettings()->GetVideoConfig();
+	if(cfg.ScreenRotation != 0) {
+		if(!_rotateFilter || _rotateFilter->GetAngle() != cfg.ScreenRotation) {
+			_rotateFilter.reset(new RotateFilter(cfg.ScreenRotation));
+		}
+		buffer = _rotateFilter->ApplyFilter(buffer, size.Width, size.Height);
+		size = _rotateFilter->GetFrameInfo(size);
+	}
+
+	if(!_scaleFilterReady || _scaleFilterType != job.FilterType) {
+		_scaleFilter = ScaleFilter::GetScaleFilter(_emu, job.FilterType);
+		_scaleFilterType = job.FilterType;
+		_scaleFilterReady = true;
+	}
+	if(_scaleFilter) {
+		buffer = _scaleFilter->ApplyFilter(buffer, size.Width, size.Height);
+		size = _scaleFilter->GetFrameInfo(size);
+		scale = _scaleFilter->GetScale();
+	}
+
+	ScanlineFilter::ApplyFilter(buffer, size.Width, size.Height, cfg.ScanlineIntensity, scale);
+
+	ScreenshotOptions& options = job.Options;
+	if(options.CropX >= size.Width || options.CropY >= size.Height) {
+		result->Error = "Crop rectangle is outside of the " + std::to_string(size.Width) + "x" + std::to_string(size.Height) + " frame";
+		return result;
+	}
+
+	if(options.CropX || options.CropY || options.CropWidth || options.CropHeight || options.Downscale > 1) {
+		CropAndDownscale(buffer, size, options, _cropBuffer);
+		buffer = _cropBuffer.data();
+		if(size.Width == 0 || size.Height == 0) {
+			result->Error = "Downscale factor is larger than the cropped frame";
+			return result;
+		}
+	}
+
+	result->Width = size.Width;
+	result->Height = size.Height;
+
+	switch(options.Format) {
+		case ScreenshotFormat::Raw:
+			result->Data.resize(size.Width * size.Height * sizeof(uint32_t));
+			memcpy(result->Data.data(), buffer, result->Data.size());
+			break;
+
+		case ScreenshotFormat::Qoi:
+			result->Data.resize(QoiEncoder::GetMaxSize(size.Width, size.Height));
+			result->Data.resize(QoiEncoder::Encode(buffer, size.Width, size.Height, result->Data.data()));
+			break;
+
+		case ScreenshotFormat::Png:
+			if(!PNGHelper::WritePNG(result->Data, buffer, size.Width, size.Height, 24, options.PngLevel)) {
+				result->Error = "PNG encoding failed";
+			}
+			break;
+	}
+
+	return result;
+}
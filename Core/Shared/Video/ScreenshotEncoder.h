@@ -0,0 +1,125 @@
+#pragma once
+#include "pch.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include "Shared/SettingTypes.h"
+
+class Emulator;
+class BaseVideoFilter;
+class ScaleFilter;
+class RotateFilter;
+
+enum class ScreenshotFormat
+{
+	Raw, //0xAARRGGBB pixels, little-endian (B, G, R, A byte order)
+	Qoi,
+	Png
+};
+
+struct ScreenshotOptions
+{
+	ScreenshotFormat Format = ScreenshotFormat::Png;
+	uint32_t PngLevel = 1;
+
+	//Crop rectangle, in the coordinates of the rotated/scaled frame (CropWidth/CropHeight = 0: up to the frame's edge)
+	uint32_t CropX = 0;
+	uint32_t CropY = 0;
+	uint32_t CropWidth = 0;
+	uint32_t CropHeight = 0;
+
+	//Integer downscale factor (each output pixel is the average of a Downscale x Downscale block), applied after cropping
+	uint32_t Downscale = 1;
+
+	bool operator==(const ScreenshotOptions& other) const
+	{
+		return (
+			Format == other.Format && (Format != ScreenshotFormat::Png || PngLevel == other.PngLevel) &&
+			CropX == other.CropX && CropY == other.CropY && CropWidth == other.CropWidth && CropHeight == other.CropHeight &&
+			Downscale == other.Downscale
+		);
+	}
+};
+
+struct ScreenshotResult
+{
+	uint32_t FrameNumber = 0;
+	uint32_t Width = 0;
+	uint32_t Height = 0;
+	ScreenshotOptions Options;
+	vector<uint8_t> Data;
+	string Error;
+};
+
+//Copies the video filter's last output (with the HUD drawn on it), returns false if there is no frame yet
+using ScreenshotFrameCopier = std::function<bool(vector<uint32_t>& buffer, FrameInfo& size, uint32_t& frameNumber, VideoFilterType& filterType)>;
+
+//Encodes screenshots of the video filter's output on a worker thread.
+//Results are kept per frame number and options, so a frame is only encoded once no matter how often it's requested.
+//After a request, the decode thread also hands the next PrefetchFrames frames to the worker as they are produced,
+//encoded with the same options - clients that request a screenshot every frame usually get an image that's already encoded.
+class ScreenshotEncoder
+{
+private:
+	static constexpr uint32_t PrefetchFrames = 60;
+	static constexpr uint32_t MaxResults = 4;
+
+	struct Job
+	{
+		vector<uint32_t> Buffer;
+		FrameInfo Size = {};
+		uint32_t FrameNumber = 0;
+		ScreenshotOptions Options;
+		VideoFilterType FilterType = VideoFilterType::None;
+		bool Prefetch = false;
+	};
+
+	Emulator* _emu;
+
+	std::thread _thread;
+	std::mutex _lock;
+	std::condition_variable _jobSignal;
+	std::condition_variable _resultSignal;
+	bool _stopFlag = false;
+
+	//Protected by _lock
+	deque<Job> _jobs;
+	bool _busy = false;
+	uint32_t _busyFrame = 0;
+	ScreenshotOptions _busyOptions;
+	deque<shared_ptr<ScreenshotResult>> _results;
+	vector<std::pair<uint32_t, ScreenshotOptions>> _waiting; //Results Capture() is waiting for (never evicted)
+	vector<vector<uint32_t>> _freeBuffers;
+	ScreenshotOptions _prefetchOptions;
+
+	atomic<uint32_t> _prefetchFramesLeft;
+	atomic<uint32_t> _lastFrameNumber;
+
+	//Only used by the worker thread
+	unique_ptr<RotateFilter> _rotateFilter;
+	unique_ptr<ScaleFilter> _scaleFilter;
+	VideoFilterType _scaleFilterType = VideoFilterType::None;
+	bool _scaleFilterReady = false;
+	vector<uint32_t> _cropBuffer;
+
+	void WorkerLoop();
+	shared_ptr<ScreenshotResult> Encode(Job& job);
+	static void CropAndDownscale(uint32_t* buffer, FrameInfo& size, const ScreenshotOptions& options, vector<uint32_t>& output);
+
+	shared_ptr<ScreenshotResult> FindResult(uint32_t frameNumber, const ScreenshotOptions& options);
+	bool IsPending(uint32_t frameNumber, const ScreenshotOptions& options);
+	bool IsWaitedFor(const ScreenshotResult& result);
+	void AddResult(shared_ptr<ScreenshotResult> result);
+	vector<uint32_t> GetFreeBuffer();
+
+public:
+	ScreenshotEncoder(Emulator* emu);
+	~ScreenshotEncoder();
+
+	//Called by the decode thread after each frame is filtered and the HUD is drawn on it (before scaling)
+	void OnFrameDecoded(BaseVideoFilter* filter, VideoFilterType filterType);
+
+	//Blocks until the last decoded frame is encoded - returns nullptr if no frame has been produced yet
+	shared_ptr<ScreenshotResult> Capture(const ScreenshotFrameCopier& copyFrame, const ScreenshotOptions& options);
+};
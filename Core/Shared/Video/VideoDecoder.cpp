@@ -11,6 +11,7 @@
 #include "Shared/Video/ScaleFilter.h"
 #include "Shared/Video/RotateFilter.h"
 #include "Shared/Video/ScanlineFilter.h"
+#include "Shared/Video/ScreenshotEncoder.h"
 #include "Shared/Video/DebugHud.h"
 #include "Shared/InputHud.h"
 #include "Shared/RenderedFrame.h"
@@ -20,10 +21,12 @@
 VideoDecoder::VideoDecoder(Emulator* emu)
 {
 	_emu = emu;
-	_frameChanged = false;
+	_writeIndex = 0;
+	_decodedIndex = 0;
 	_stopFlag = false;
 	_baseFrameSize = { 256, 239 };
 	_lastFrameSize = _baseFrameSize;
+	_screenshotEncoder.reset(new ScreenshotEncoder(emu));
 }
 
 VideoDecoder::~VideoDecoder()
@@ -50,13 +53,13 @@ FrameInfo VideoDecoder::GetBaseFrameInfo(bool removeOverscan)
 		}
 
 		return {
-			(uint32_t)(_baseFrameSize.Width * _frame.Scale) - hOverscan,
-			(uint32_t)(_baseFrameSize.Height * _frame.Scale) - vOverscan
+			(uint32_t)(_baseFrameSize.Width * _lastFrameScale) - hOverscan,
+			(uint32_t)(_baseFrameSize.Height * _lastFrameScale) - vOverscan
 		};
 	} else {
 		return {
-			(uint32_t)(_baseFrameSize.Width * _frame.Scale),
-			(uint32_t)(_baseFrameSize.Height * _frame.Scale)
+			(uint32_t)(_baseFrameSize.Width * _lastFrameScale),
+			(uint32_t)(_baseFrameSize.Height * _lastFrameScale)
 		};
 	}
 }
@@ -90,8 +93,9 @@ void VideoDecoder::UpdateVideoFilter()
 	}
 }
 
-void VideoDecoder::DecodeFrame(bool forRewind)
+void VideoDecoder::DecodeFrame(RenderedFrame& frame, bool forRewind)
 {
+	auto outputLock = _outputLock.AcquireSafe();
 	UpdateVideoFilter();
 
 	bool isAudioPlayer = _emu->GetAudioPlayerHud() != nullptr;
@@ -100,12 +104,12 @@ void VideoDecoder::DecodeFrame(bool forRewind)
 		_baseFrameSize.Width = 256;
 		_baseFrameSize.Height = 240;
 	} else {
-		_baseFrameSize.Width = _frame.Width;
-		_baseFrameSize.Height = _frame.Height;
+		_baseFrameSize.Width = frame.Width;
+		_baseFrameSize.Height = frame.Height;
 	}
 
 	_videoFilter->SetBaseFrameInfo(_baseFrameSize);
-	FrameInfo frameSize = _videoFilter->SendFrame((uint16_t*)_frame.FrameBuffer, _frame.FrameNumber, _frame.VideoPhase, _frame.Data);
+	FrameInfo frameSize = _videoFilter->SendFrame((uint16_t*)frame.FrameBuffer, frame.FrameNumber, frame.VideoPhase, frame.Data);
 
 	uint32_t* outputBuffer = _videoFilter->GetOutputBuffer();
 	
@@ -120,7 +124,9 @@ void VideoDecoder::DecodeFrame(bool forRewind)
 		}
 	}
 
-	_emu->GetDebugHud()->Draw(outputBuffer, frameSize, overscan, _frame.FrameNumber, _videoFilter->GetScaleFactor());
+	_emu->GetDebugHud()->Draw(outputBuffer, frameSize, overscan, frame.FrameNumber, _videoFilter->GetScaleFactor());
+	_screenshotEncoder->OnFrameDecoded(_videoFilter.get(), _videoFilterType);
+	outputLock.Release();
 
 	if(_scaleFilter && !isAudioPlayer) {
 		outputBuffer = _scaleFilter->ApplyFilter(outputBuffer, frameSize.Width, frameSize.Height);
@@ -128,11 +134,11 @@ void VideoDecoder::DecodeFrame(bool forRewind)
 	}
 
 	if(!isAudioPlayer) {
-		uint8_t scale = std::max<uint8_t>(1, (uint8_t)((double)frameSize.Height / (_frame.Height - overscan.Top - overscan.Bottom)));
+		uint8_t scale = std::max<uint8_t>(1, (uint8_t)((double)frameSize.Height / (frame.Height - overscan.Top - overscan.Bottom)));
 		ScanlineFilter::ApplyFilter(outputBuffer, frameSize.Width, frameSize.Height, _emu->GetSettings()->GetVideoConfig().ScanlineIntensity, scale);
 	}
 
-	RenderedFrame convertedFrame((void*)outputBuffer, frameSize.Width, frameSize.Height, _frame.Scale, _frame.FrameNumber, _frame.InputData);
+	RenderedFrame convertedFrame((void*)outputBuffer, frameSize.Width, frameSize.Height, frame.Scale, frame.FrameNumber, frame.InputData);
 
 	double aspectRatio = _emu->GetSettings()->GetAspectRatio(_emu->GetRegion(), _baseFrameSize);
 	if(frameSize.Height != _lastFrameSize.Height || frameSize.Width != _lastFrameSize.Width || aspectRatio != _lastAspectRatio) {
@@ -143,8 +149,7 @@ void VideoDecoder::DecodeFrame(bool forRewind)
 	
 	//Rewind manager will take care of sending the correct frame to the video renderer
 	_emu->GetRewindManager()->SendFrame(convertedFrame, forRewind);
-
-	_frameChanged = false;
+	_lastFrameScale = frame.Scale;
 }
 
 void VideoDecoder::DecodeThread()
@@ -152,14 +157,21 @@ void VideoDecoder::DecodeThread()
 	//This thread will decode the PPU's output (color ID to RGB, intensify r/g/b and produce a HD version of the frame if needed)
 	while(!_stopFlag.load()) {
 		//DecodeFrame returns the final ARGB frame we want to display in the emulator window
-		while(!_frameChanged) {
+		while(_decodedIndex.load(std::memory_order_relaxed) == _writeIndex.load(std::memory_order_acquire)) {
 			_waitForFrame.Wait();
 			if(_stopFlag.load()) {
 				return;
 			}
 		}
 
-		DecodeFrame();
+		uint32_t index = _decodedIndex.load(std::memory_order_relaxed);
+		DecoderQueueSlot& slot = _queue[index % QueueSize];
+		DecodeFrame(slot.Frame, slot.ForRewind);
+		_presentLatency.Add(slot.SubmitTimer.GetElapsedMS());
+
+		//Hand the slot back to the emulation thread
+		_decodedIndex.store(index + 1, std::memory_order_release);
+		_frameDecoded.Signal();
 	}
 }
 
@@ -168,35 +180,57 @@ uint32_t VideoDecoder::GetFrameCount()
 	return _frameCount;
 }
 
-void VideoDecoder::WaitForAsyncFrameDecode()
+bool VideoDecoder::WaitForQueue(uint32_t maxPending)
 {
-	while(_frameChanged) {
-		//Spin until decode is done
-		std::this_thread::sleep_for(std::chrono::duration<int, std::milli>(15));
+	//Blocks until at most maxPending frames are queued or being decoded (frames are never dropped,
+	//the rewind manager and video recorders need every one of them)
+	while(_writeIndex.load(std::memory_order_relaxed) - _decodedIndex.load(std::memory_order_acquire) > maxPending) {
+		if(_stopFlag || !_decodeThread) {
+			return false;
+		}
+		_frameDecoded.Wait(50);
 	}
+	return true;
+}
+
+void VideoDecoder::WaitForAsyncFrameDecode()
+{
+	WaitForQueue(0);
 }
 
 void VideoDecoder::UpdateFrame(RenderedFrame frame, bool sync, bool forRewind)
 {
-	if(_emu->IsRunAheadFrame()) {
+	if(_emu->IsRunAheadFrame() || _emu->IsHeadlessRenderSkipped()) {
 		return;
 	}
 
-	if(_frameChanged) {
-		//Last frame isn't done decoding yet - sometimes Signal() introduces a 25-30ms delay
-		while(_frameChanged) {
-			//Spin until decode is done
-		}
-		//At this point, we are sure that the decode thread is no longer busy
-	}
+	//HD packs keep their per-frame data in the PPU's double-buffered HdScreenInfo, which isn't copied into
+	//the queue - in that case, only allow one frame to be in flight at once (like the PPU's buffers)
+	Timer stallTimer;
+	bool queueReady = WaitForQueue((sync || frame.Data) ? 0 : QueueSize - 1);
+	_stallTime.Add(stallTimer.GetElapsedMS());
 
 	_emu->OnBeforeSendFrame();
 
-	_frame = frame;
 	if(sync) {
-		DecodeFrame(forRewind);
-	} else {
-		_frameChanged = true;
+		DecodeFrame(frame, forRewind);
+	} else if(queueReady) {
+		uint32_t index = _writeIndex.load(std::memory_order_relaxed);
+		DecoderQueueSlot& slot = _queue[index % QueueSize];
+
+		//Copy the PPU's output into the slot, the PPU will start drawing the next frame into its buffer right away
+		uint32_t bufferSize = frame.FrameBufferSize ? frame.FrameBufferSize / sizeof(uint16_t) : frame.Width * frame.Height;
+		if(slot.Buffer.size() < bufferSize) {
+			slot.Buffer.resize(bufferSize);
+		}
+		memcpy(slot.Buffer.data(), frame.FrameBuffer, bufferSize * sizeof(uint16_t));
+
+		slot.Frame = std::move(frame);
+		slot.Frame.FrameBuffer = slot.Buffer.data();
+		slot.ForRewind = forRewind;
+		slot.SubmitTimer.Reset();
+
+		_writeIndex.store(index + 1, std::memory_order_release);
 		_waitForFrame.Signal();
 	}
 	_frameCount++;
@@ -206,13 +240,19 @@ void VideoDecoder::StartThread()
 {
 	auto lock = _stopStartLock.AcquireSafe();
 	if(!_decodeThread) {
+		auto outputLock = _outputLock.AcquireSafe();
 		_videoFilter.reset();
 		UpdateVideoFilter();
 		_videoFilter->SetBaseFrameInfo(_baseFrameSize);
+		outputLock.Release();
 		_stopFlag = false;
-		_frameChanged = false;
+		_writeIndex = 0;
+		_decodedIndex = 0;
 		_frameCount = 0;
 		_waitForFrame.Reset();
+		_frameDecoded.Reset();
+		_presentLatency.Reset();
+		_stallTime.Reset();
 		
 		_emu->GetVideoRenderer()->ClearFrame();
 
@@ -226,6 +266,7 @@ void VideoDecoder::StopThread()
 	_stopFlag = true;
 	if(_decodeThread) {
 		_waitForFrame.Signal();
+		_frameDecoded.Signal();
 		_decodeThread->join();
 
 		_decodeThread.reset();
@@ -253,3 +294,12 @@ void VideoDecoder::TakeScreenshot(std::stringstream &stream)
 		_videoFilter->TakeScreenshot(_videoFilterType, "", &stream);
 	}
 }
+
+shared_ptr<ScreenshotResult> VideoDecoder::TakeScreenshot(const ScreenshotOptions& options)
+{
+	return _screenshotEncoder->Capture([this](vector<uint32_t>& buffer, FrameInfo& size, uint32_t& frameNumber, VideoFilterType& filterType) {
+		auto lock = _outputLock.AcquireSafe();
+		filterType = _videoFilterType;
+		return _videoFilter && _videoFilter->CopyOutputBuffer(buffer, size, frameNumber);
+	}, options);
+}
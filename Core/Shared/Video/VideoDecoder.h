@@ -2,18 +2,36 @@
 #include "pch.h"
 #include "Utilities/SimpleLock.h"
 #include "Utilities/AutoResetEvent.h"
+#include "Utilities/Timer.h"
 #include "Shared/SettingTypes.h"
 #include "Shared/RenderedFrame.h"
+#include "Shared/Video/DebugStats.h"
 
 class BaseVideoFilter;
 class ScaleFilter;
 class RotateFilter;
 class IRenderingDevice;
 class Emulator;
+class ScreenshotEncoder;
+struct ScreenshotOptions;
+struct ScreenshotResult;
+
+struct DecoderQueueSlot
+{
+	RenderedFrame Frame;
+	vector<uint16_t> Buffer; //Copy of the PPU's output buffer, owned by the slot (Frame.FrameBuffer points to it)
+	bool ForRewind = false;
+	Timer SubmitTimer;
+};
 
 class VideoDecoder
 {
 private:
+	//Single producer (emulation thread) / single consumer (decode thread) ring of frames waiting to be decoded.
+	//A slot belongs to the emulation thread until _writeIndex is incremented past it, and to the decode thread
+	//until _decodedIndex is incremented past it - the indexes only ever increase (slot = index % QueueSize)
+	static constexpr uint32_t QueueSize = 3;
+
 	Emulator* _emu;
 
 	ConsoleType _consoleType = ConsoleType::Snes;
@@ -21,9 +39,17 @@ private:
 	unique_ptr<thread> _decodeThread;
 
 	SimpleLock _stopStartLock;
+	SimpleLock _outputLock; //Held from filtering a frame until the HUD is drawn on it (screenshots never see a frame without its HUD)
 	AutoResetEvent _waitForFrame;
-	
-	atomic<bool> _frameChanged;
+	AutoResetEvent _frameDecoded;
+
+	DecoderQueueSlot _queue[QueueSize];
+	atomic<uint32_t> _writeIndex;
+	atomic<uint32_t> _decodedIndex;
+
+	FrameTimingHistogram _presentLatency;
+	FrameTimingHistogram _stallTime;
+
 	atomic<bool> _stopFlag;
 	uint32_t _frameCount = 0;
 	bool _forceFilterUpdate = false;
@@ -32,16 +58,19 @@ private:
 
 	FrameInfo _baseFrameSize = {};
 	FrameInfo _lastFrameSize = {};
-	RenderedFrame _frame = {};
+	double _lastFrameScale = 1.0;
 
 	VideoFilterType _videoFilterType = VideoFilterType::None;
 	unique_ptr<BaseVideoFilter> _videoFilter;
 	unique_ptr<ScaleFilter> _scaleFilter;
 	unique_ptr<RotateFilter> _rotateFilter;
+	unique_ptr<ScreenshotEncoder> _screenshotEncoder;
 
 	void UpdateVideoFilter();
 
+	void DecodeFrame(RenderedFrame& frame, bool forRewind);
 	void DecodeThread();
+	bool WaitForQueue(uint32_t maxPending);
 
 public:
 	VideoDecoder(Emulator* console);
@@ -49,16 +78,22 @@ public:
 
 	void Init();
 
-	void DecodeFrame(bool synchronous = false);
 	void TakeScreenshot();
 	void TakeScreenshot(std::stringstream &stream);
+	//Encodes the last frame on the screenshot encoder's thread (blocks until done), nullptr if there is no frame yet
+	shared_ptr<ScreenshotResult> TakeScreenshot(const ScreenshotOptions& options);
 	
 	void ForceFilterUpdate() { _forceFilterUpdate = true; }
 
 	uint32_t GetFrameCount();
 	FrameInfo GetBaseFrameInfo(bool removeOverscan);
 	FrameInfo GetFrameInfo();
-	double GetLastFrameScale() { return _frame.Scale; }
+	double GetLastFrameScale() { return _lastFrameScale; }
+
+	//Time between a frame being sent by the PPU and the decoded frame being sent to the renderer
+	FrameTimingHistogram& GetPresentLatency() { return _presentLatency; }
+	//Time the emulation thread spent waiting for a free slot in the decode queue
+	FrameTimingHistogram& GetStallTime() { return _stallTime; }
 
 	void UpdateFrame(RenderedFrame frame, bool sync, bool forRewind);
 
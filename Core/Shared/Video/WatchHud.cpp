@@ -63,11 +63,7 @@ void WatchHud::DrawOutlinedString(DebugHud* hud, int x, int y, const string& tex
 
 void WatchHud::DrawCollisionOverlay(DebugHud* hud, uint32_t screenWidth, uint32_t screenHeight)
 {
-	if(!SocketServer::IsCollisionOverlayEnabled()) {
-		return;
-	}
-
-	if(!_emu || !_emu->IsRunning()) {
+	if(!_emu || !SocketServer::IsCollisionOverlayEnabled(_emu) || !_emu->IsRunning()) {
 		return;
 	}
 
@@ -79,8 +75,8 @@ void WatchHud::DrawCollisionOverlay(DebugHud* hud, uint32_t screenWidth, uint32_
 	Debugger* debugger = dbg.GetDebugger();
 	MemoryDumper* dumper = debugger->GetMemoryDumper();
 
-	string mode = SocketServer::GetCollisionOverlayMode();
-	const vector<uint8_t>& highlightTiles = SocketServer::GetCollisionHighlightTiles();
+	string mode = SocketServer::GetCollisionOverlayMode(_emu);
+	const vector<uint8_t>& highlightTiles = SocketServer::GetCollisionHighlightTiles(_emu);
 
 	// ALTTP collision map addresses
 	// COLMAPA: $7F2000 (primary)
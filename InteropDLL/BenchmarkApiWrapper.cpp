@@ -0,0 +1,804 @@
+#include "Common.h"
+#include "Core/Shared/Emulator.h"
+#include "Core/Shared/EmuSettings.h"
+#include "Core/Shared/SaveStateManager.h"
+#include "Core/Shared/DebuggerRequest.h"
+#include "Core/Debugger/Debugger.h"
+#include "Core/Debugger/ExpressionEvaluator.h"
+#include "Core/Debugger/Breakpoint.h"
+#include "Core/Debugger/BreakpointManager.h"
+#include "Core/Debugger/DebugUtilities.h"
+#include "Core/Shared/Video/DebugHud.h"
+#include "Core/Shared/Video/ScaleFilter.h"
+#include "Core/Shared/Video/PixelConverter.h"
+#include "Core/Shared/Video/VideoDecoder.h"
+#include "Core/Shared/Video/ScreenshotEncoder.h"
+#include "Core/Shared/ColorUtilities.h"
+#include "Utilities/FolderUtilities.h"
+#include "Utilities/VirtualFile.h"
+#include "Utilities/Timer.h"
+#include "Utilities/CompressionHelper.h"
+#include "Utilities/PNGHelper.h"
+#include "Utilities/QoiEncoder.h"
+#include "Utilities/magic_enum.hpp"
+#include <sstream>
+#include <functional>
+#include <random>
+
+//Micro-benchmarks run by the benchmark tool (Benchmark/Benchmark.cpp): "benchmark <name> [args]"
+
+static vector<string> GetBenchmarkRoms(vector<string>& args)
+{
+	vector<string> roms;
+	for(string& arg : args) {
+		vector<string> files = FolderUtilities::GetFilesInFolder(arg, { ".sfc", ".smc", ".gb", ".gbc", ".nes", ".pce", ".cue", ".sms", ".gg", ".sg", ".gba", ".ws", ".wsc" }, false);
+		if(!files.empty()) {
+			std::sort(files.begin(), files.end());
+			roms.insert(roms.end(), files.begin(), files.end());
+		} else {
+			roms.push_back(arg);
+		}
+	}
+	return roms;
+}
+
+static uint32_t GetIntArg(vector<string>& args, string name, uint32_t defaultValue)
+{
+	for(size_t i = 0; i + 1 < args.size(); i++) {
+		if(args[i] == name) {
+			uint32_t value = (uint32_t)std::stoul(args[i + 1]);
+			args.erase(args.begin() + i, args.begin() + i + 2);
+			return value;
+		}
+	}
+	return defaultValue;
+}
+
+//Save/load time of the keyed (file) save state format vs the compact format used by rewind, run-ahead & step back
+static int BenchmarkSaveStates(vector<string>& args)
+{
+	uint32_t iterations = GetIntArg(args, "--iterations", 500);
+	uint32_t frames = GetIntArg(args, "--frames", 300);
+	vector<string> roms = GetBenchmarkRoms(args);
+	if(roms.empty()) {
+		std::cout << "Usage: benchmark savestate [--iterations N] [--frames N] <rom files/folders>" << std::endl;
+		return 1;
+	}
+
+	printf("%-12s %-28s %10s %10s %10s %10s %10s %10s %8s\n", "Console", "ROM", "KeyedSize", "KeyedSave", "KeyedLoad", "CompSize", "CompSave", "CompLoad", "Speedup");
+
+	for(string& rom : roms) {
+		unique_ptr<Emulator> emu(new Emulator());
+		emu->Initialize(true, false);
+		emu->GetSettings()->SetFlag(EmulationFlags::ConsoleMode);
+		if(!emu->LoadRom((VirtualFile)rom, VirtualFile(), false)) {
+			std::cout << "Could not load: " << rom << std::endl;
+			emu->Release();
+			continue;
+		}
+
+		//Run a few frames to get past the initial (mostly empty) state
+		emu->RunHeadlessFrames(frames, false, nullptr, {});
+
+		auto measure = [&](bool compact, size_t& stateSize, double& saveUs, double& loadUs) {
+			std::stringstream state;
+			emu->Serialize(state, true, 0, compact);
+			stateSize = state.str().size();
+
+			Timer timer;
+			for(uint32_t i = 0; i < iterations; i++) {
+				std::stringstream out;
+				emu->Serialize(out, true, 0, compact);
+			}
+			saveUs = timer.GetElapsedMS() * 1000 / iterations;
+
+			timer.Reset();
+			for(uint32_t i = 0; i < iterations; i++) {
+				state.clear();
+				state.seekg(0, std::ios::beg);
+				emu->Deserialize(state, SaveStateManager::FileFormatVersion, true, std::nullopt, false);
+			}
+			loadUs = timer.GetElapsedMS() * 1000 / iterations;
+		};
+
+		size_t keyedSize, compactSize;
+		double keyedSave, keyedLoad, compactSave, compactLoad;
+		measure(false, keyedSize, keyedSave, keyedLoad);
+		measure(true, compactSize, compactSave, compactLoad);
+
+		string console = string(magic_enum::enum_name(emu->GetConsoleType()));
+		string name = FolderUtilities::GetFilename(rom, false).substr(0, 28);
+		printf("%-12s %-28s %10zu %8.1fus %8.1fus %10zu %8.1fus %8.1fus %7.2fx\n", console.c_str(), name.c_str(),
+			keyedSize, keyedSave, keyedLoad, compactSize, compactSave, compactLoad, (keyedSave + keyedLoad) / (compactSave + compactLoad));
+		fflush(stdout);
+
+		emu->Stop(false);
+		emu->Release();
+	}
+	return 0;
+}
+
+//Compression speed/ratio of zlib (level 1, used by .mss files) vs LZ4 (used by rewind & in-memory states) on real save states
+static int BenchmarkCompression(vector<string>& args)
+{
+	uint32_t iterations = GetIntArg(args, "--iterations", 200);
+	uint32_t frames = GetIntArg(args, "--frames", 300);
+	vector<string> roms = GetBenchmarkRoms(args);
+	if(roms.empty()) {
+		std::cout << "Usage: benchmark compression [--iterations N] [--frames N] <rom files/folders>" << std::endl;
+		return 1;
+	}
+
+	printf("%-12s %-28s %10s %-5s %10s %8s %12s %12s\n", "Console", "ROM", "StateSize", "Codec", "CompSize", "Ratio", "Compress", "Decompress");
+
+	for(string& rom : roms) {
+		unique_ptr<Emulator> emu(new Emulator());
+		emu->Initialize(true, false);
+		emu->GetSettings()->SetFlag(EmulationFlags::ConsoleMode);
+		if(!emu->LoadRom((VirtualFile)rom, VirtualFile(), false)) {
+			std::cout << "Could not load: " << rom << std::endl;
+			emu->Release();
+			continue;
+		}
+
+		emu->RunHeadlessFrames(frames, false, nullptr, {});
+
+		std::stringstream stateStream;
+		emu->Serialize(stateStream, true, 0);
+		string state = stateStream.str();
+
+		string console = string(magic_enum::enum_name(emu->GetConsoleType()));
+		string name = FolderUtilities::GetFilename(rom, false).substr(0, 28);
+
+		for(CompressionCodec codec : { CompressionCodec::Zlib, CompressionCodec::Lz4 }) {
+			vector<uint8_t> compressed;
+			Timer timer;
+			for(uint32_t i = 0; i < iterations; i++) {
+				CompressionHelper::CompressBlock((uint8_t*)state.data(), (uint32_t)state.size(), 1, codec, compressed);
+			}
+			double compressMs = timer.GetElapsedMS();
+
+			vector<uint8_t> output(state.size());
+			timer.Reset();
+			for(uint32_t i = 0; i < iterations; i++) {
+				if(!CompressionHelper::DecompressBlock(compressed.data(), (uint32_t)compressed.size(), codec, output.data(), (uint32_t)output.size())) {
+					std::cout << "Decompression failed: " << rom << std::endl;
+					return 1;
+				}
+			}
+			double decompressMs = timer.GetElapsedMS();
+
+			double totalMb = (double)state.size() * iterations / (1024 * 1024);
+			printf("%-12s %-28s %10zu %-5s %10zu %7.2fx %7.0f MB/s %7.0f MB/s\n", console.c_str(), name.c_str(), state.size(),
+				string(magic_enum::enum_name(codec)).c_str(), compressed.size(), (double)state.size() / compressed.size(),
+				totalMb * 1000 / compressMs, totalMb * 1000 / decompressMs);
+		}
+		fflush(stdout);
+
+		emu->Stop(false);
+		emu->Release();
+	}
+	return 0;
+}
+
+//Evaluation time of compiled expressions (ExpressionEvaluator::Compile) vs the RPN interpreter
+static int BenchmarkExpressions(vector<string>& args)
+{
+	uint32_t iterations = GetIntArg(args, "--iterations", 1000000);
+	vector<string> roms = GetBenchmarkRoms(args);
+	if(roms.empty()) {
+		std::cout << "Usage: benchmark expression [--iterations N] <rom files/folders>" << std::endl;
+		return 1;
+	}
+
+	vector<string> expressions = {
+		"[$0010] == $20",
+		"a == $12 && [$0011] != 0",
+		"{$0010} + [$0012] * 256 > 1000",
+		"(a & $FF) == 3 || [$0020 + $10 * 2] == 5",
+		"[[$0010] + $100] == $FF && scanline > 100",
+	};
+
+	printf("%-12s %-44s %10s %10s %8s\n", "Console", "Expression", "Interp", "Compiled", "Speedup");
+
+	for(string& rom : roms) {
+		unique_ptr<Emulator> emu(new Emulator());
+		emu->Initialize(true, false);
+		emu->GetSettings()->SetFlag(EmulationFlags::ConsoleMode);
+		if(!emu->LoadRom((VirtualFile)rom, VirtualFile(), false)) {
+			std::cout << "Could not load: " << rom << std::endl;
+			emu->Release();
+			continue;
+		}
+
+		emu->RunHeadlessFrames(60, false, nullptr, {});
+		string console = string(magic_enum::enum_name(emu->GetConsoleType()));
+
+		{
+			auto dbgRequest = emu->GetDebugger(true);
+			Debugger* debugger = dbgRequest.GetDebugger();
+			CpuType cpuType = debugger->GetMainCpuType();
+
+			for(string& expression : expressions) {
+				ExpressionData compiled;
+				if(!debugger->CompileExpression(expression, cpuType, compiled)) {
+					printf("%-12s %-44s %10s\n", console.c_str(), expression.c_str(), "(invalid)");
+					continue;
+				}
+				ExpressionData interpreted = compiled;
+				interpreted.Program.clear();
+
+				auto measure = [&](ExpressionData& data) {
+					EvalResultType resultType;
+					int64_t sum = 0;
+					Timer timer;
+					for(uint32_t i = 0; i < iterations; i++) {
+						sum += debugger->EvaluateExpression(data, cpuType, resultType);
+					}
+					double ns = timer.GetElapsedMS() * 1000000 / iterations;
+					return std::make_pair(ns, sum);
+				};
+
+				auto [interpNs, interpSum] = measure(interpreted);
+				auto [compiledNs, compiledSum] = measure(compiled);
+				if(interpSum != compiledSum) {
+					std::cout << "Result mismatch: " << expression << std::endl;
+					return 1;
+				}
+
+				printf("%-12s %-44s %8.1fns %8.1fns %7.2fx\n", console.c_str(), expression.c_str(), interpNs, compiledNs, interpNs / compiledNs);
+			}
+		}
+		fflush(stdout);
+
+		emu->Stop(false);
+		emu->Release();
+	}
+	return 0;
+}
+
+//Matches the Breakpoint class memory layout (see BreakpointData in SocketServer.cpp)
+struct BenchmarkBreakpoint
+{
+	uint32_t id;
+	CpuType cpuType;
+	MemoryType memoryType;
+	BreakpointTypeFlags type;
+	int32_t startAddr;
+	int32_t endAddr;
+	bool enabled;
+	bool markEvent;
+	bool ignoreDummyOperations;
+	char condition[1000];
+};
+static_assert(sizeof(BenchmarkBreakpoint) == sizeof(Breakpoint), "BenchmarkBreakpoint layout mismatch");
+
+//Read breakpoint check time of the indexed BreakpointManager vs a linear scan over every breakpoint
+static int BenchmarkBreakpoints(vector<string>& args)
+{
+	uint32_t iterations = GetIntArg(args, "--iterations", 1000000);
+	vector<string> roms = GetBenchmarkRoms(args);
+	if(roms.empty()) {
+		std::cout << "Usage: benchmark breakpoints [--iterations N] <rom files/folders>" << std::endl;
+		return 1;
+	}
+
+	printf("%-12s %12s %10s %10s %8s %8s\n", "Console", "Breakpoints", "Linear", "Indexed", "Hits", "Speedup");
+
+	for(string& rom : roms) {
+		unique_ptr<Emulator> emu(new Emulator());
+		emu->Initialize(true, false);
+		emu->GetSettings()->SetFlag(EmulationFlags::ConsoleMode);
+		if(!emu->LoadRom((VirtualFile)rom, VirtualFile(), false)) {
+			std::cout << "Could not load: " << rom << std::endl;
+			emu->Release();
+			continue;
+		}
+
+		string console = string(magic_enum::enum_name(emu->GetConsoleType()));
+
+		{
+			auto dbgRequest = emu->GetDebugger(true);
+			Debugger* debugger = dbgRequest.GetDebugger();
+			CpuType cpuType = debugger->GetMainCpuType();
+			MemoryType cpuMemType = DebugUtilities::GetCpuMemoryType(cpuType);
+
+			//Same random reads for every breakpoint count, with their absolute addresses resolved up front
+			std::mt19937 rng(1234);
+			vector<MemoryOperationInfo> operations;
+			vector<AddressInfo> addresses;
+			operations.reserve(iterations);
+			addresses.reserve(iterations);
+			for(uint32_t i = 0; i < iterations; i++) {
+				uint32_t addr = rng() & 0xFFFF;
+				operations.push_back(MemoryOperationInfo(addr, 0, MemoryOperationType::Read, cpuMemType));
+				addresses.push_back(debugger->GetAbsoluteAddress({ (int32_t)addr, cpuMemType }));
+			}
+
+			for(uint32_t count : { 1, 10, 100, 1000 }) {
+				vector<BenchmarkBreakpoint> bpData(count);
+				for(uint32_t i = 0; i < count; i++) {
+					BenchmarkBreakpoint& bp = bpData[i];
+					bp = {};
+					bp.id = i;
+					bp.cpuType = cpuType;
+					bp.memoryType = cpuMemType;
+					bp.type = BreakpointTypeFlags::Read;
+					bp.startAddr = rng() & 0xFFFF;
+					bp.endAddr = std::min<int32_t>(bp.startAddr + (rng() & 0x0F), 0xFFFF);
+					bp.enabled = true;
+				}
+				Breakpoint* breakpoints = reinterpret_cast<Breakpoint*>(bpData.data());
+
+				BreakpointManager bpManager(debugger, nullptr, cpuType, nullptr);
+				bpManager.SetBreakpoints(breakpoints, count);
+
+				//Checksums of the returned breakpoint IDs (-1 when nothing matched)
+				uint64_t linearSum = 0;
+				uint32_t hitCount = 0;
+				Timer timer;
+				for(uint32_t i = 0; i < iterations; i++) {
+					int id = -1;
+					for(uint32_t j = 0; j < count; j++) {
+						if(breakpoints[j].Matches(operations[i], addresses[i])) {
+							id = breakpoints[j].GetId();
+							hitCount++;
+							break;
+						}
+					}
+					linearSum += id + 1;
+				}
+				double linearNs = timer.GetElapsedMS() * 1000000 / iterations;
+
+				uint64_t indexedSum = 0;
+				timer.Reset();
+				for(uint32_t i = 0; i < iterations; i++) {
+					indexedSum += bpManager.CheckBreakpoint(operations[i], addresses[i], false) + 1;
+				}
+				double indexedNs = timer.GetElapsedMS() * 1000000 / iterations;
+
+				if(linearSum != indexedSum) {
+					std::cout << "Result mismatch: " << count << " breakpoints" << std::endl;
+					return 1;
+				}
+
+				printf("%-12s %12u %8.1fns %8.1fns %7.2f%% %7.2fx\n", console.c_str(), count, linearNs, indexedNs,
+					100.0 * hitCount / iterations, linearNs / indexedNs);
+			}
+		}
+		fflush(stdout);
+
+		emu->Stop(false);
+		emu->Release();
+	}
+	return 0;
+}
+
+//Time to queue & draw N DebugHud primitives per frame (pixels, filled rectangles) - no ROM needed
+static int BenchmarkHud(vector<string>& args)
+{
+	uint32_t frames = GetIntArg(args, "--frames", 100);
+
+	constexpr uint32_t width = 256;
+	constexpr uint32_t height = 240;
+	vector<uint32_t> buffer(width * height);
+	FrameInfo frameInfo = { width, height };
+	OverscanDimensions overscan = {};
+	HudScaleFactors scale = { 1, 1 };
+
+	printf("%-14s %10s %10s %12s %12s\n", "Pattern", "Primitives", "Commands", "Add", "Draw");
+
+	for(uint32_t count : { 1000, 10000, 100000 }) {
+		for(string pattern : { "pixels", "random-pixels", "rectangles" }) {
+			DebugHud hud;
+			std::mt19937 rng(1234);
+			double addMs = 0;
+			double drawMs = 0;
+			uint32_t commandCount = 0;
+
+			for(uint32_t frame = 0; frame < frames; frame++) {
+				Timer timer;
+				for(uint32_t i = 0; i < count; i++) {
+					if(pattern == "pixels") {
+						//Row-major image, e.g a script drawing a sprite pixel by pixel
+						uint32_t pos = i % (width * height);
+						hud.DrawPixel(pos % width, pos / width, (i / 7) & 0x01 ? 0xFF0000 : 0x00FF00, 1);
+					} else if(pattern == "random-pixels") {
+						hud.DrawPixel(rng() % width, rng() % height, rng() & 0xFFFFFF, 1);
+					} else {
+						uint32_t pos = i % ((width / 8) * (height / 8));
+						hud.DrawRectangle((pos % (width / 8)) * 8, (pos / (width / 8)) * 8, 8, 8, 0x404040 | (i & 0x0F), true, 1);
+					}
+				}
+				addMs += timer.GetElapsedMS();
+				commandCount = hud.GetCommandCount();
+
+				timer.Reset();
+				hud.Draw(buffer.data(), frameInfo, overscan, frame, scale);
+				drawMs += timer.GetElapsedMS();
+			}
+
+			printf("%-14s %10u %10u %10.1fus %10.1fus\n", pattern.c_str(), count, commandCount, addMs * 1000 / frames, drawMs * 1000 / frames);
+			fflush(stdout);
+		}
+	}
+	return 0;
+}
+
+//Frame time of each ScaleFilter (single-threaded vs split into row bands) on a synthetic frame - no ROM needed
+static int BenchmarkScaleFilters(vector<string>& args)
+{
+	uint32_t frames = GetIntArg(args, "--frames", 30);
+	uint32_t threads = GetIntArg(args, "--threads", 0);
+	//Defaults to the SNES hi-res + interlaced output size
+	uint32_t width = GetIntArg(args, "--width", 512);
+	uint32_t height = GetIntArg(args, "--height", 478);
+
+	//Blocky pattern with some noise, so that the filters' edge detection has work to do
+	std::mt19937 rng(1234);
+	vector<uint32_t> input(width * height);
+	for(uint32_t y = 0; y < height; y++) {
+		for(uint32_t x = 0; x < width; x++) {
+			uint32_t block = ((x / 8) * 7 + (y / 8) * 13) % 5;
+			input[y * width + x] = 0xFF000000 | (block * 0x302010) | ((rng() & 0x07) == 0 ? 0xFFFFFF : 0);
+		}
+	}
+
+	//Needed by the LCD grid filter's settings
+	unique_ptr<Emulator> emu(new Emulator());
+	emu->Initialize(true, false);
+
+	vector<VideoFilterType> filters = {
+		VideoFilterType::xBRZ2x, VideoFilterType::xBRZ3x, VideoFilterType::xBRZ4x, VideoFilterType::xBRZ5x, VideoFilterType::xBRZ6x,
+		VideoFilterType::HQ2x, VideoFilterType::HQ3x, VideoFilterType::HQ4x,
+		VideoFilterType::Scale2x, VideoFilterType::Scale3x, VideoFilterType::Scale4x,
+		VideoFilterType::_2xSai, VideoFilterType::Super2xSai, VideoFilterType::SuperEagle,
+		VideoFilterType::Prescale2x, VideoFilterType::Prescale4x, VideoFilterType::Prescale10x,
+		VideoFilterType::LcdGrid
+	};
+
+	printf("%-12s %5s %12s %12s %8s %8s\n", "Filter", "Scale", "Single", "Banded", "Threads", "Speedup");
+
+	for(VideoFilterType filterType : filters) {
+		unique_ptr<ScaleFilter> filter = ScaleFilter::GetScaleFilter(emu.get(), filterType);
+
+		auto measure = [&](uint32_t threadCount, vector<uint32_t>& output) {
+			filter->SetThreadCount(threadCount);
+			//Warm up (allocates the output buffer & starts the worker threads)
+			uint32_t* result = filter->ApplyFilter(input.data(), width, height);
+			Timer timer;
+			for(uint32_t i = 0; i < frames; i++) {
+				result = filter->ApplyFilter(input.data(), width, height);
+			}
+			double ms = timer.GetElapsedMS() / frames;
+			output.assign(result, result + width * height * filter->GetScale() * filter->GetScale());
+			return ms;
+		};
+
+		//A single thread runs each scaler over the whole frame in one pass (the original scale() for Scale2x),
+		//the banded output must be identical to it
+		vector<uint32_t> singleOutput;
+		vector<uint32_t> bandedOutput;
+		double singleMs = measure(1, singleOutput);
+		double bandedMs = measure(threads, bandedOutput);
+		if(singleOutput != bandedOutput) {
+			std::cout << "Output mismatch: " << magic_enum::enum_name(filterType) << std::endl;
+			return 1;
+		}
+
+		uint32_t threadCount = threads ? threads : std::thread::hardware_concurrency();
+		printf("%-12s %4ux %10.2fms %10.2fms %8u %7.2fx\n", string(magic_enum::enum_name(filterType)).c_str(), filter->GetScale(),
+			singleMs, bandedMs, threadCount, singleMs / bandedMs);
+		fflush(stdout);
+	}
+
+	emu->Release();
+	return 0;
+}
+
+//RGB555 to ARGB conversion & blending time of each PixelConverter instruction set vs the filters' lookup table loops - no ROM needed
+static int BenchmarkPixelConversion(vector<string>& args)
+{
+	uint32_t frames = GetIntArg(args, "--frames", 200);
+	uint32_t width = GetIntArg(args, "--width", 512);
+	uint32_t height = GetIntArg(args, "--height", 478);
+	uint32_t pixelCount = width * height;
+
+	//Same table as the default video filters (without color adjustments)
+	vector<uint32_t> palette(0x8000);
+	for(uint32_t rgb555 = 0; rgb555 < 0x8000; rgb555++) {
+		uint8_t r = ColorUtilities::Convert5BitTo8Bit(rgb555 & 0x1F);
+		uint8_t g = ColorUtilities::Convert5BitTo8Bit((rgb555 >> 5) & 0x1F);
+		uint8_t b = ColorUtilities::Convert5BitTo8Bit((rgb555 >> 10) & 0x1F);
+		palette[rgb555] = 0xFF000000 | (r << 16) | (g << 8) | b;
+	}
+	auto blend = [](uint32_t a, uint32_t b) { return ((((a) ^ (b)) & 0xfffefefeL) >> 1) + ((a) & (b)); };
+
+	//The first 32768 pixels cover every color, the rest is random
+	std::mt19937 rng(1234);
+	vector<uint16_t> frame(pixelCount);
+	vector<uint16_t> prevFrame(pixelCount);
+	for(uint32_t i = 0; i < pixelCount; i++) {
+		frame[i] = i < 0x8000 ? i : (rng() & 0x7FFF);
+		prevFrame[i] = rng() & 0x7FFF;
+	}
+
+	struct PixelOperation
+	{
+		string Name;
+		std::function<void(uint32_t*)> LookupTable;
+		std::function<void(uint32_t*)> Converter;
+		uint32_t OutputSize;
+	};
+
+	vector<PixelOperation> operations = {
+		{ "convert",
+			[&](uint32_t* out) { for(uint32_t i = 0; i < pixelCount; i++) { out[i] = palette[frame[i]]; } },
+			[&](uint32_t* out) { PixelConverter::ConvertRgb555(frame.data(), out, pixelCount); },
+			pixelCount
+		},
+		{ "convert-2x",
+			[&](uint32_t* out) { for(uint32_t i = 0; i < pixelCount * 2; i++) { out[i] = palette[frame[i / 2]]; } },
+			[&](uint32_t* out) { PixelConverter::ConvertRgb555Doubled(frame.data(), out, pixelCount); },
+			pixelCount * 2
+		},
+		{ "frame-blend",
+			[&](uint32_t* out) { for(uint32_t i = 0; i < pixelCount; i++) { out[i] = blend(palette[prevFrame[i]], palette[frame[i]]); } },
+			[&](uint32_t* out) { PixelConverter::ConvertAndBlendRgb555(prevFrame.data(), frame.data(), out, pixelCount); },
+			pixelCount
+		},
+		{ "hires-blend",
+			[&](uint32_t* out) {
+				for(uint32_t i = 0; i < pixelCount; i++) { out[i] = palette[frame[i]]; }
+				for(uint32_t i = 0; i + 1 < pixelCount; i++) { out[i] = blend(out[i], out[i + 1]); }
+			},
+			[&](uint32_t* out) {
+				PixelConverter::ConvertRgb555(frame.data(), out, pixelCount);
+				PixelConverter::BlendWithNextPixel(out, pixelCount);
+			},
+			pixelCount
+		},
+	};
+
+	PixelConverterIsa defaultIsa = PixelConverter::GetIsa();
+	vector<PixelConverterIsa> isas = PixelConverter::GetSupportedIsas();
+
+	printf("%-12s %10s", "Operation", "LUT");
+	for(PixelConverterIsa isa : isas) {
+		printf(" %10s", string(magic_enum::enum_name(isa)).c_str());
+	}
+	printf(" %8s\n", "Speedup");
+
+	int result = 0;
+	for(PixelOperation& op : operations) {
+		vector<uint32_t> expected(op.OutputSize);
+		vector<uint32_t> output(op.OutputSize);
+
+		Timer timer;
+		for(uint32_t i = 0; i < frames; i++) {
+			op.LookupTable(expected.data());
+		}
+		double lutUs = timer.GetElapsedMS() * 1000 / frames;
+		printf("%-12s %8.1fus", op.Name.c_str(), lutUs);
+
+		double bestUs = lutUs;
+		for(PixelConverterIsa isa : isas) {
+			PixelConverter::SetIsa(isa);
+			std::fill(output.begin(), output.end(), 0);
+			timer.Reset();
+			for(uint32_t i = 0; i < frames; i++) {
+				op.Converter(output.data());
+			}
+			double us = timer.GetElapsedMS() * 1000 / frames;
+			bestUs = std::min(bestUs, us);
+
+			if(output != expected) {
+				printf(" %10s", "MISMATCH");
+				result = 1;
+			} else {
+				printf(" %8.1fus", us);
+			}
+		}
+		printf(" %7.2fx\n", lutUs / bestUs);
+		fflush(stdout);
+	}
+
+	PixelConverter::SetIsa(defaultIsa);
+	return result;
+}
+
+//Time per frame of the video decoder's queue (async) vs decoding on the emulation thread (sync), per ROM.
+//Each frame is sent from an exact-size copy of the PPU's buffer (run with SANITIZER=address to catch over-reads,
+//e.g. PC Engine and Game Gear frames, whose buffers are not Width * Height pixels) and both paths must produce the same image
+static int BenchmarkDecoder(vector<string>& args)
+{
+	uint32_t iterations = GetIntArg(args, "--iterations", 300);
+	uint32_t frames = GetIntArg(args, "--frames", 300);
+	vector<string> roms = GetBenchmarkRoms(args);
+	if(roms.empty()) {
+		std::cout << "Usage: benchmark decoder [--iterations N] [--frames N] <rom files/folders>" << std::endl;
+		return 1;
+	}
+
+	printf("%-12s %-28s %9s %10s %10s %10s %10s %8s\n", "Console", "ROM", "Size", "Sync", "Queued", "Latency", "Max", "Stalls");
+
+	int result = 0;
+	for(string& rom : roms) {
+		unique_ptr<Emulator> emu(new Emulator());
+		emu->Initialize(true, false);
+		emu->GetSettings()->SetFlag(EmulationFlags::ConsoleMode);
+		if(!emu->LoadRom((VirtualFile)rom, VirtualFile(), false)) {
+			std::cout << "Could not load: " << rom << std::endl;
+			emu->Release();
+			continue;
+		}
+
+		emu->RunHeadlessFrames(frames, false, nullptr, {});
+
+		VideoDecoder* decoder = emu->GetVideoDecoder();
+		PpuFrameInfo ppuFrame = emu->GetPpuFrame();
+		vector<uint16_t> buffer((uint16_t*)ppuFrame.FrameBuffer, (uint16_t*)ppuFrame.FrameBuffer + ppuFrame.FrameBufferSize / sizeof(uint16_t));
+
+		ScreenshotOptions rawOptions;
+		rawOptions.Format = ScreenshotFormat::Raw;
+		uint32_t frameNumber = 0x10000000;
+
+		//Frames are sent from the emulation thread, like the PPUs do
+		auto sendFrames = [&](bool sync, uint32_t count) {
+			double ms = 0;
+			emu->RunHeadlessFrames(1, true, nullptr, [&](uint32_t) {
+				Timer timer;
+				for(uint32_t i = 0; i < count; i++) {
+					RenderedFrame frame(buffer.data(), ppuFrame.Width, ppuFrame.Height, 1.0, frameNumber++);
+					frame.FrameBufferSize = ppuFrame.FrameBufferSize;
+					decoder->UpdateFrame(frame, sync, false);
+				}
+				decoder->WaitForAsyncFrameDecode();
+				ms = timer.GetElapsedMS() / count;
+				return true;
+			});
+			shared_ptr<ScreenshotResult> screenshot = decoder->TakeScreenshot(rawOptions);
+			return std::make_pair(ms, screenshot ? screenshot->Data : vector<uint8_t>());
+		};
+
+		//Send each frame at least twice, so filters that blend with the previous frame produce the same output
+		decoder->GetPresentLatency().Reset();
+		decoder->GetStallTime().Reset();
+		auto [queuedMs, queuedOutput] = sendFrames(false, std::max<uint32_t>(iterations, 2));
+		double latency = decoder->GetPresentLatency().GetAverage();
+		double maxLatency = decoder->GetPresentLatency().GetMax();
+		uint32_t stalls = decoder->GetStallTime().GetTotalCount() - decoder->GetStallTime().GetCount(0);
+		auto [syncMs, syncOutput] = sendFrames(true, std::max<uint32_t>(iterations, 2));
+
+		string console = string(magic_enum::enum_name(emu->GetConsoleType()));
+		string name = FolderUtilities::GetFilename(rom, false).substr(0, 28);
+		string size = std::to_string(ppuFrame.Width) + "x" + std::to_string(ppuFrame.Height);
+		printf("%-12s %-28s %9s %7.3f ms %7.3f ms %7.3f ms %7.3f ms %8u\n", console.c_str(), name.c_str(), size.c_str(), syncMs, queuedMs, latency, maxLatency, stalls);
+		if(queuedOutput.empty() || queuedOutput != syncOutput) {
+			std::cout << "Output mismatch: " << rom << std::endl;
+			result = 1;
+		}
+		fflush(stdout);
+
+		emu->Stop(false);
+		emu->Release();
+	}
+	return result;
+}
+
+//Encoding time/size of each screenshot format (PNG at the default level vs the faster options), per ROM
+static int BenchmarkScreenshots(vector<string>& args)
+{
+	uint32_t iterations = GetIntArg(args, "--iterations", 100);
+	uint32_t frames = GetIntArg(args, "--frames", 300);
+	vector<string> roms = GetBenchmarkRoms(args);
+	if(roms.empty()) {
+		std::cout << "Usage: benchmark screenshot [--iterations N] [--frames N] <rom files/folders>" << std::endl;
+		return 1;
+	}
+
+	printf("%-12s %-28s %9s %-8s %10s %10s\n", "Console", "ROM", "Size", "Format", "Bytes", "Encode");
+
+	for(string& rom : roms) {
+		unique_ptr<Emulator> emu(new Emulator());
+		emu->Initialize(true, false);
+		emu->GetSettings()->SetFlag(EmulationFlags::ConsoleMode);
+		if(!emu->LoadRom((VirtualFile)rom, VirtualFile(), false)) {
+			std::cout << "Could not load: " << rom << std::endl;
+			emu->Release();
+			continue;
+		}
+
+		emu->RunHeadlessFrames(frames, true, nullptr, {});
+		emu->GetVideoDecoder()->WaitForAsyncFrameDecode();
+
+		ScreenshotOptions rawOptions;
+		rawOptions.Format = ScreenshotFormat::Raw;
+		shared_ptr<ScreenshotResult> raw = emu->GetVideoDecoder()->TakeScreenshot(rawOptions);
+		if(!raw || raw->Data.empty()) {
+			std::cout << "No frame: " << rom << std::endl;
+			emu->Release();
+			continue;
+		}
+
+		uint32_t width = raw->Width;
+		uint32_t height = raw->Height;
+		uint32_t* argb = (uint32_t*)raw->Data.data();
+
+		struct ScreenshotEncoding
+		{
+			string Name;
+			std::function<void(vector<uint8_t>&)> Encode;
+		};
+
+		vector<ScreenshotEncoding> encodings = {
+			{ "png-6", [&](vector<uint8_t>& out) { PNGHelper::WritePNG(out, argb, width, height, 24, 6); } },
+			{ "png-1", [&](vector<uint8_t>& out) { PNGHelper::WritePNG(out, argb, width, height, 24, 1); } },
+			{ "qoi", [&](vector<uint8_t>& out) {
+				out.resize(QoiEncoder::GetMaxSize(width, height));
+				out.resize(QoiEncoder::Encode(argb, width, height, out.data()));
+			} },
+			{ "raw", [&](vector<uint8_t>& out) { out.assign(raw->Data.begin(), raw->Data.end()); } },
+		};
+
+		string console = string(magic_enum::enum_name(emu->GetConsoleType()));
+		string name = FolderUtilities::GetFilename(rom, false).substr(0, 28);
+		string size = std::to_string(width) + "x" + std::to_string(height);
+
+		for(ScreenshotEncoding& encoding : encodings) {
+			vector<uint8_t> output;
+			Timer timer;
+			for(uint32_t i = 0; i < iterations; i++) {
+				encoding.Encode(output);
+			}
+			double encodeMs = timer.GetElapsedMS() / iterations;
+
+			printf("%-12s %-28s %9s %-8s %10zu %7.3f ms\n", console.c_str(), name.c_str(), size.c_str(), encoding.Name.c_str(), output.size(), encodeMs);
+		}
+		fflush(stdout);
+
+		emu->Stop(false);
+		emu->Release();
+	}
+	return 0;
+}
+
+struct BenchmarkInfo
+{
+	string Name;
+	string Description;
+	std::function<int(vector<string>&)> Run;
+};
+
+static vector<BenchmarkInfo> _benchmarks = {
+	{ "savestate", "Save state save/load time (keyed vs compact format), per ROM", BenchmarkSaveStates },
+	{ "compression", "Save state compression speed/ratio (zlib vs LZ4), per ROM", BenchmarkCompression },
+	{ "expression", "Debugger expression evaluation time (compiled vs RPN interpreter), per ROM", BenchmarkExpressions },
+	{ "breakpoints", "Breakpoint check time for 1/10/100/1000 breakpoints (indexed vs linear scan), per ROM", BenchmarkBreakpoints },
+	{ "hud", "DebugHud add/draw time for 1k/10k/100k pixels & rectangles per frame", BenchmarkHud },
+	{ "scalefilter", "Frame time of each scale filter (xBRZ, HQX, Scale2x, etc.), single-threaded vs row bands", BenchmarkScaleFilters },
+	{ "pixels", "RGB555 to ARGB conversion/blend time of each SIMD instruction set vs lookup tables (checks the output is identical)", BenchmarkPixelConversion },
+	{ "decoder", "Video decoder frame time (frame queue vs sync) & present latency, per ROM (checks both produce the same image)", BenchmarkDecoder },
+	{ "screenshot", "Screenshot encoding time/size of PNG (level 6 and 1), QOI and raw ARGB, per ROM", BenchmarkScreenshots },
+};
+
+extern "C"
+{
+	DllExport int __stdcall RunBenchmark(vector<string> args)
+	{
+		if(!args.empty()) {
+			for(BenchmarkInfo& benchmark : _benchmarks) {
+				if(benchmark.Name == args[0]) {
+					args.erase(args.begin());
+					return benchmark.Run(args);
+				}
+			}
+		}
+
+		std::cout << "Usage: benchmark <name> [args]" << std::endl;
+		for(BenchmarkInfo& benchmark : _benchmarks) {
+			printf("  %-12s %s\n", benchmark.Name.c_str(), benchmark.Description.c_str());
+		}
+		return 1;
+	}
+}
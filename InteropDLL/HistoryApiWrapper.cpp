@@ -51,7 +51,7 @@ extern "C"
 	DllExport void __stdcall HistoryViewerInitialize(void* windowHandle, void* viewerHandle)
 	{
 		_historyPlayer.reset(new Emulator());
-		_historyPlayer->Initialize();
+		_historyPlayer->Initialize(true, false);
 		_historyPlayer->GetSettings()->CopySettings(*_emu->GetSettings());
 
 		_historyViewer = _historyPlayer->GetHistoryViewer();
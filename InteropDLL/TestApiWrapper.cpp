@@ -1,18 +1,24 @@
 #include "Common.h"
 #include "Core/Shared/RecordedRomTest.h"
+#include "Core/Shared/RomTestSuite.h"
 #include "Core/Shared/Emulator.h"
 #include "Core/Shared/EmuSettings.h"
+#include "Utilities/Timer.h"
+#include "Utilities/magic_enum.hpp"
 
 extern unique_ptr<Emulator> _emu;
 shared_ptr<RecordedRomTest> _recordedRomTest;
 
+//In seconds, a hung test (e.g a ROM that never reaches the expected frame) fails instead of blocking the run
+static constexpr uint32_t DefaultTestTimeout = 300;
+
 extern "C"
 {
 	DllExport RomTestResult __stdcall RunRecordedTest(char* filename, bool inBackground)
 	{
 		if(inBackground) {
 			unique_ptr<Emulator> emu(new Emulator());
-			emu->Initialize();
+			emu->Initialize(true, false);
 			emu->GetSettings()->SetFlag(EmulationFlags::ConsoleMode);
 			shared_ptr<RecordedRomTest> romTest(new RecordedRomTest(emu.get(), true));
 			return romTest->Run(filename);
@@ -25,29 +31,13 @@ extern "C"
 	DllExport uint64_t __stdcall RunTest(char* filename, uint32_t address, MemoryType memType)
 	{
 		unique_ptr<Emulator> emu(new Emulator());
-		emu->Initialize();
+		emu->Initialize(true, false);
 		emu->GetSettings()->SetFlag(EmulationFlags::ConsoleMode);
 		emu->GetSettings()->GetGameboyConfig().Model = GameboyModel::Gameboy;
 		emu->GetSettings()->GetGameboyConfig().RamPowerOnState = RamState::AllZeros;
-		emu->LoadRom((VirtualFile)filename, VirtualFile());
-		emu->GetSettings()->SetFlag(EmulationFlags::MaximumSpeed);
-
-		while(emu->GetFrameCount() < 500) {
-			std::this_thread::sleep_for(std::chrono::duration<int, std::milli>(10));
-		}
 
-		ConsoleMemoryInfo memInfo = emu->GetMemory(memType);
-		uint8_t* memBuffer = (uint8_t*)memInfo.Memory;
-		uint64_t result = memBuffer[address];
-		for(int i = 1; i < 8; i++) {
-			if(address + i < memInfo.Size) {
-				result |= ((uint64_t)memBuffer[address + i] << (8*i));
-			} else {
-				break;
-			}
-		}
-		
-		emu->Stop(false);
+		uint64_t result = 0;
+		RomTestSuite::RunMemoryTest(emu.get(), filename, 500, memType, address, 8, result);
 		emu->Release();
 
 		return result;
@@ -68,4 +58,91 @@ extern "C"
 	}
 
 	DllExport bool __stdcall RomTestRecording() { return _recordedRomTest != nullptr; }
+
+	//Entry point of the romtests tool (RomTestRunner/RomTestRunner.cpp)
+	DllExport int __stdcall RunTestSuite(vector<string> args)
+	{
+		auto printUsage = []() {
+			std::cout << "Usage: romtests [--threads N] [--timeout seconds] [--junit report.xml] [--json report.json] [--verbose] <manifest/folder/.mtp>..." << std::endl;
+			std::cout << "  --threads: 0 = one per hardware thread (default)" << std::endl;
+			std::cout << "  --timeout: per test, unless set in the manifest (default: " << DefaultTestTimeout << ", 0 = none)" << std::endl;
+		};
+
+		//Parses a whole (decimal) argument, std::stoul alone accepts negative values & trailing garbage
+		auto parseArg = [](const string& arg, uint32_t maxValue, uint32_t& value) {
+			if(arg.empty() || arg.size() > 9 || !std::all_of(arg.begin(), arg.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+				return false;
+			}
+			value = (uint32_t)std::stoul(arg);
+			return value <= maxValue;
+		};
+
+		uint32_t threadCount = 0;
+		uint32_t timeout = DefaultTestTimeout;
+		string junitFile;
+		string jsonFile;
+		bool verbose = false;
+		vector<RomTestCase> tests;
+		for(size_t i = 0; i < args.size(); i++) {
+			if(args[i] == "--threads" || args[i] == "--timeout") {
+				uint32_t& value = args[i] == "--threads" ? threadCount : timeout;
+				if(i + 1 >= args.size() || !parseArg(args[i + 1], args[i] == "--threads" ? 1024 : 86400, value)) {
+					std::cout << "Invalid value for " << args[i] << ": " << (i + 1 < args.size() ? args[i + 1] : "") << std::endl;
+					printUsage();
+					return 2;
+				}
+				i++;
+			} else if(args[i] == "--junit" && i + 1 < args.size()) {
+				junitFile = args[++i];
+			} else if(args[i] == "--json" && i + 1 < args.size()) {
+				jsonFile = args[++i];
+			} else if(args[i] == "--verbose") {
+				verbose = true;
+			} else {
+				string error;
+				if(!RomTestSuite::LoadTests(args[i], tests, error)) {
+					std::cout << error << std::endl;
+					return 2;
+				}
+			}
+		}
+
+		if(tests.empty()) {
+			printUsage();
+			return 2;
+		}
+
+		for(RomTestCase& test : tests) {
+			if(!test.Timeout.has_value()) {
+				test.Timeout = timeout;
+			}
+		}
+
+		Timer timer;
+		uint32_t doneCount = 0;
+		vector<RomTestCaseResult> results = RomTestSuite::Run(tests, threadCount, [&](RomTestCase& test, RomTestCaseResult& result) {
+			doneCount++;
+			if(verbose || result.State != RomTestState::Passed) {
+				printf("[%u/%u] %s: %s (%.0f ms, %.0f fps) %s\n", doneCount, (uint32_t)tests.size(), string(magic_enum::enum_name(result.State)).c_str(), test.Name.c_str(),
+					result.WallMs, result.WallMs > 0 ? result.Frames * 1000.0 / result.WallMs : 0.0, result.Message.c_str());
+			}
+		});
+		double totalMs = timer.GetElapsedMS();
+
+		uint32_t failed = 0;
+		uint64_t frames = 0;
+		for(RomTestCaseResult& result : results) {
+			failed += result.State == RomTestState::Failed ? 1 : 0;
+			frames += result.Frames;
+		}
+		printf("%u tests, %u failed, %.1f s, %.0f frames/s\n", (uint32_t)tests.size(), failed, totalMs / 1000, totalMs > 0 ? frames * 1000.0 / totalMs : 0.0);
+
+		if(!junitFile.empty() && !RomTestSuite::WriteJUnitReport(junitFile, tests, results, totalMs)) {
+			std::cout << "Could not write: " << junitFile << std::endl;
+		}
+		if(!jsonFile.empty() && !RomTestSuite::WriteJsonReport(jsonFile, tests, results, totalMs)) {
+			std::cout << "Could not write: " << jsonFile << std::endl;
+		}
+		return failed > 0 ? 1 : 0;
+	}
 }
\ No newline at end of file
@@ -0,0 +1,22 @@
+#include <vector>
+#include <string>
+
+#ifndef _WIN32
+	#define __stdcall
+#endif
+
+using std::string;
+using std::vector;
+
+extern "C" {
+	int __stdcall RunTestSuite(vector<string> args);
+}
+
+//Runs recorded (.mtp) and memory-value ROM tests in parallel (see Core/Shared/RomTestSuite.h for the manifest format)
+//e.g: romtests --threads 16 --timeout 120 --junit results.xml --json results.json tests/manifest.txt
+//Returns 0 if every test passed, 1 if any test failed, 2 on usage/manifest errors
+int main(int argc, char* argv[])
+{
+	vector<string> args(argv + 1, argv + argc);
+	return RunTestSuite(args);
+}
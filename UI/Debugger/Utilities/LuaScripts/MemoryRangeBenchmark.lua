@@ -0,0 +1,110 @@
+-----------------------
+-- Name: Memory Range Benchmark
+-- Author: Mesen
+-----------------------
+-- Compares the time needed to read/write an 8 KB block of memory one byte at a time (emu.read/emu.write)
+-- with the bulk functions (emu.readRange/emu.writeRange/emu.unpackArray).
+-- Results are written to the script log window after a few frames.
+--
+-- Note: This script needs the "Allow access to I/O and OS functions" option (uses os.clock)
+-----------------------
+
+if os == nil then
+  emu.displayMessage("Script", "This script requires access to OS functions (see script settings).")
+  return
+end
+
+local memTypes = {
+  Snes = emu.memType.snesDebug,
+  Nes = emu.memType.nesDebug,
+  Gameboy = emu.memType.gameboyDebug,
+  PcEngine = emu.memType.pceDebug,
+  Sms = emu.memType.smsDebug,
+  Gba = emu.memType.gbaDebug
+}
+
+local memType = memTypes[emu.getState()["consoleType"]]
+if memType == nil then
+  emu.displayMessage("Script", "This script does not support this console.")
+  return
+end
+
+local blockSize = 0x2000
+local iterations = 20
+local frames = 0
+local output = {}
+
+function Measure(name, func)
+  local start = os.clock()
+  for i = 1, iterations do
+    func()
+  end
+  local elapsed = (os.clock() - start) * 1000000 / iterations
+  emu.log(string.format("%-32s %10.1f us", name, elapsed))
+  return elapsed
+end
+
+function RunBenchmark()
+  emu.log(string.format("Block size: %d bytes, memory type: %d", blockSize, memType))
+
+  local perByte = Measure("emu.read (per byte)", function()
+    local sum = 0
+    for addr = 0, blockSize - 1 do
+      sum = sum + emu.read(addr, memType)
+    end
+  end)
+
+  local bulkString = Measure("emu.readRange (string)", function()
+    local sum = 0
+    local data = emu.readRange(0, blockSize, memType)
+    for i = 1, blockSize do
+      sum = sum + string.byte(data, i)
+    end
+  end)
+
+  local bulkTable = Measure("emu.readRange (reused table)", function()
+    local sum = 0
+    emu.readRange(0, blockSize, memType, output)
+    for i = 1, blockSize do
+      sum = sum + output[i]
+    end
+  end)
+
+  Measure("emu.read16 (per word)", function()
+    local sum = 0
+    for addr = 0, blockSize - 2, 2 do
+      sum = sum + emu.read16(addr, memType)
+    end
+  end)
+
+  Measure("emu.readRange + unpackArray (16-bit)", function()
+    local sum = 0
+    local words = emu.unpackArray(emu.readRange(0, blockSize, memType), 2)
+    for i = 1, #words do
+      sum = sum + words[i]
+    end
+  end)
+
+  local data = emu.readRange(0, blockSize, memType)
+  Measure("emu.write (per byte)", function()
+    for addr = 0, blockSize - 1 do
+      emu.write(addr, string.byte(data, addr + 1), memType)
+    end
+  end)
+
+  Measure("emu.writeRange (string)", function()
+    emu.writeRange(0, data, memType)
+  end)
+
+  emu.log(string.format("Speedup: %.1fx (string), %.1fx (table)", perByte / bulkString, perByte / bulkTable))
+end
+
+function OnFrame()
+  frames = frames + 1
+  if frames == 10 then
+    RunBenchmark()
+  end
+end
+
+emu.addEventCallback(OnFrame, emu.eventType.endFrame)
+emu.displayMessage("Script", "Memory range benchmark will run in a few frames, see the script log.")
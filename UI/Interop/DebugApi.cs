@@ -24,7 +24,9 @@ namespace Mesen.Interop
 		[DllImport(DllPath)] public static extern void Step(CpuType cpuType, Int32 instructionCount, StepType type = StepType.Step);
 
 		[DllImport(DllPath)] public static extern void StartLogTraceToFile([MarshalAs(UnmanagedType.LPUTF8Str)] string filename);
+		[DllImport(DllPath)] public static extern void StartLogTraceToBinaryFile([MarshalAs(UnmanagedType.LPUTF8Str)] string filename);
 		[DllImport(DllPath)] public static extern void StopLogTraceToFile();
+		[DllImport(DllPath)] public static extern Int64 ConvertBinaryTraceLog([MarshalAs(UnmanagedType.LPUTF8Str)] string inputFile, [MarshalAs(UnmanagedType.LPUTF8Str)] string outputFile);
 
 		[DllImport(DllPath)] public static extern void SetTraceOptions(CpuType cpuType, InteropTraceLoggerOptions options);
 
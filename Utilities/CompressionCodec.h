@@ -0,0 +1,8 @@
+#pragma once
+#include "pch.h"
+
+enum class CompressionCodec : uint8_t
+{
+	Zlib = 0,
+	Lz4 = 1 //Much faster, lower ratio - LZ4 compressed save states can't be loaded by older versions
+};
@@ -1,44 +1,83 @@
 #pragma once
 #include "pch.h"
 #include "miniz.h"
+#include "Lz4.h"
+#include "CompressionCodec.h"
 
 class CompressionHelper
 {
 public:
-	static void Compress(string data, int compressionLevel, vector<uint8_t>& output)
+	//Compresses a single block (compressionLevel is ignored by LZ4) - returns false if the data can't be compressed
+	static bool CompressBlock(const uint8_t* data, uint32_t size, int compressionLevel, CompressionCodec codec, vector<uint8_t>& output)
 	{
-		unsigned long compressedSize = compressBound((unsigned long)data.size());
-		uint8_t* compressedData = new uint8_t[compressedSize];
-		compress2(compressedData, &compressedSize, (unsigned char*)data.c_str(), (unsigned long)data.size(), compressionLevel);
+		switch(codec) {
+			case CompressionCodec::Lz4:
+				output.resize(Lz4::GetMaxCompressedSize(size));
+				output.resize(Lz4::Compress(data, size, output.data()));
+				return true;
 
-		uint32_t size = (uint32_t)compressedSize;
+			default:
+			case CompressionCodec::Zlib: {
+				unsigned long compressedSize = compressBound((unsigned long)size);
+				output.resize(compressedSize);
+				if(compress2(output.data(), &compressedSize, data, (unsigned long)size, compressionLevel) != MZ_OK) {
+					return false;
+				}
+				output.resize(compressedSize);
+				return true;
+			}
+		}
+	}
+
+	//Decompresses a block produced by CompressBlock, which must decompress to exactly outputSize bytes
+	static bool DecompressBlock(const uint8_t* data, uint32_t size, CompressionCodec codec, uint8_t* output, uint32_t outputSize)
+	{
+		switch(codec) {
+			case CompressionCodec::Lz4:
+				return Lz4::Decompress(data, size, output, outputSize);
+
+			case CompressionCodec::Zlib: {
+				unsigned long decompSize = outputSize;
+				return uncompress(output, &decompSize, data, (unsigned long)size) == MZ_OK && decompSize == outputSize;
+			}
+		}
+		return false;
+	}
+
+	//Output: original size (4 bytes), compressed size (4 bytes), codec (1 byte), compressed data
+	static void Compress(const string& data, int compressionLevel, vector<uint8_t>& output, CompressionCodec codec = CompressionCodec::Zlib)
+	{
+		vector<uint8_t> compressedData;
+		CompressBlock((const uint8_t*)data.c_str(), (uint32_t)data.size(), compressionLevel, codec, compressedData);
+
+		uint32_t size = (uint32_t)compressedData.size();
 		uint32_t originalSize = (uint32_t)data.size();
 		output.insert(output.end(), (char*)&originalSize, (char*)&originalSize + sizeof(uint32_t));
 		output.insert(output.end(), (char*)&size, (char*)&size + sizeof(uint32_t));
-		output.insert(output.end(), (char*)compressedData, (char*)compressedData + compressedSize);
-		delete[] compressedData;
+		output.push_back((uint8_t)codec);
+		output.insert(output.end(), compressedData.begin(), compressedData.end());
 	}
 
 	static bool Decompress(vector<uint8_t>& input, vector<uint8_t>& output)
 	{
+		constexpr uint32_t headerSize = sizeof(uint32_t) * 2 + 1;
+		if(input.size() < headerSize) {
+			return false;
+		}
+
 		uint32_t decompressedSize;
 		uint32_t compressedSize;
 
 		memcpy(&decompressedSize, input.data(), sizeof(uint32_t));
 		memcpy(&compressedSize, input.data() + sizeof(uint32_t), sizeof(uint32_t));
+		CompressionCodec codec = (CompressionCodec)input[sizeof(uint32_t) * 2];
 
-		if(decompressedSize >= 1024 * 1024 * 10 || compressedSize >= 1024 * 1024 * 10) {
+		if(decompressedSize >= 1024 * 1024 * 10 || compressedSize >= 1024 * 1024 * 10 || compressedSize > input.size() - headerSize) {
 			//Limit to 10mb the data's size
 			return false;
 		}
 
 		output.resize(decompressedSize, 0);
-
-		unsigned long decompSize = decompressedSize;
-		if(uncompress(output.data(), &decompSize, input.data() + sizeof(uint32_t)*2, (unsigned long)input.size() - sizeof(uint32_t) * 2) != MZ_OK) {
-			return false;
-		}
-
-		return true;
+		return DecompressBlock(input.data() + headerSize, compressedSize, codec, output.data(), decompressedSize);
 	}
-};
\ No newline at end of file
+};
@@ -130,12 +130,17 @@
          out += 2
 #endif
 
-void twoxsai_generic_xrgb8888(unsigned width, unsigned height, uint32_t *src, unsigned src_stride, uint32_t *dst, unsigned dst_stride)
+void twoxsai_generic_xrgb8888(unsigned width, unsigned height, uint32_t *src, unsigned src_stride, uint32_t *dst, unsigned dst_stride, unsigned yFirst, unsigned yLast)
 {
    unsigned finish;
-	int y = 0;
+	int y = yFirst;
 	int x = 0;
-	for(; height; height--) {
+	if(yLast > height) {
+		yLast = height;
+	}
+	src += yFirst * src_stride;
+	dst += yFirst * 2 * dst_stride;
+	for(height -= yFirst; y < (int)yLast; height--) {
 		uint32_t *in = (uint32_t*)src;
 		uint32_t *out = (uint32_t*)dst;
 
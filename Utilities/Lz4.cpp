@@ -0,0 +1,195 @@
+#include "pch.h"
+#include "Lz4.h"
+
+static constexpr int HashLog = 12;
+static constexpr uint32_t MinMatch = 4;
+static constexpr uint32_t LastLiterals = 5; //The last 5 bytes are always literals
+static constexpr uint32_t MatchFindLimit = 12; //The last match must start at least 12 bytes before the end
+static constexpr uint32_t MaxOffset = 65535;
+
+static __forceinline uint32_t Read32(const uint8_t* ptr)
+{
+	uint32_t value;
+	memcpy(&value, ptr, sizeof(value));
+	return value;
+}
+
+static __forceinline uint64_t Read64(const uint8_t* ptr)
+{
+	uint64_t value;
+	memcpy(&value, ptr, sizeof(value));
+	return value;
+}
+
+static __forceinline uint32_t Hash(uint32_t sequence)
+{
+	return (sequence * 2654435761U) >> (32 - HashLog);
+}
+
+static __forceinline uint8_t* WriteLength(uint8_t* op, uint32_t length)
+{
+	while(length >= 255) {
+		*op++ = 255;
+		length -= 255;
+	}
+	*op++ = (uint8_t)length;
+	return op;
+}
+
+static uint8_t* WriteSequence(uint8_t* op, const uint8_t* literals, uint32_t literalLength)
+{
+	uint8_t* token = op++;
+	if(literalLength >= 15) {
+		*token = 15 << 4;
+		op = WriteLength(op, literalLength - 15);
+	} else {
+		*token = (uint8_t)(literalLength << 4);
+	}
+	memcpy(op, literals, literalLength);
+	return op + literalLength;
+}
+
+uint32_t Lz4::Compress(const uint8_t* src, uint32_t size, uint8_t* dst)
+{
+	const uint8_t* ip = src;
+	const uint8_t* anchor = src;
+	const uint8_t* end = src + size;
+	uint8_t* op = dst;
+
+	if(size > MatchFindLimit) {
+		uint32_t hashTable[1 << HashLog] = {};
+		const uint8_t* matchFindLimit = end - MatchFindLimit;
+		const uint8_t* matchLimit = end - LastLiterals;
+
+		ip++;
+		while(ip < matchFindLimit) {
+			uint32_t sequence = Read32(ip);
+			uint32_t hash = Hash(sequence);
+			const uint8_t* match = src + hashTable[hash];
+			hashTable[hash] = (uint32_t)(ip - src);
+
+			if(match >= ip || ip - match > MaxOffset || Read32(match) != sequence) {
+				//Skip ahead faster the longer it's been since the last match (incompressible data)
+				ip += 1 + ((ip - anchor) >> 6);
+				continue;
+			}
+
+			//Extend the match backwards into the pending literals
+			while(ip > anchor && match > src && ip[-1] == match[-1]) {
+				ip--;
+				match--;
+			}
+
+			//Extend the match forward, 8 bytes at a time
+			const uint8_t* matchEnd = ip + MinMatch;
+			const uint8_t* ref = match + MinMatch;
+			while(matchEnd + 8 <= matchLimit && Read64(matchEnd) == Read64(ref)) {
+				matchEnd += 8;
+				ref += 8;
+			}
+			while(matchEnd < matchLimit && *matchEnd == *ref) {
+				matchEnd++;
+				ref++;
+			}
+
+			uint8_t* token = op;
+			op = WriteSequence(op, anchor, (uint32_t)(ip - anchor));
+
+			uint16_t offset = (uint16_t)(ip - match);
+			*op++ = (uint8_t)offset;
+			*op++ = (uint8_t)(offset >> 8);
+
+			uint32_t matchLength = (uint32_t)(matchEnd - ip) - MinMatch;
+			if(matchLength >= 15) {
+				*token |= 15;
+				op = WriteLength(op, matchLength - 15);
+			} else {
+				*token |= (uint8_t)matchLength;
+			}
+
+			ip = matchEnd;
+			anchor = ip;
+			if(ip - 2 > src && ip < matchFindLimit) {
+				hashTable[Hash(Read32(ip - 2))] = (uint32_t)(ip - 2 - src);
+			}
+		}
+	}
+
+	op = WriteSequence(op, anchor, (uint32_t)(end - anchor));
+	return (uint32_t)(op - dst);
+}
+
+static __forceinline bool ReadLength(const uint8_t*& ip, const uint8_t* end, uint32_t& length)
+{
+	uint8_t value;
+	do {
+		if(ip >= end) {
+			return false;
+		}
+		value = *ip++;
+		length += value;
+	} while(value == 255);
+	return true;
+}
+
+bool Lz4::Decompress(const uint8_t* src, uint32_t srcSize, uint8_t* dst, uint32_t dstSize)
+{
+	const uint8_t* ip = src;
+	const uint8_t* end = src + srcSize;
+	uint8_t* op = dst;
+	uint8_t* outEnd = dst + dstSize;
+
+	while(ip < end) {
+		uint8_t token = *ip++;
+
+		uint32_t literalLength = token >> 4;
+		if(literalLength == 15 && !ReadLength(ip, end, literalLength)) {
+			return false;
+		}
+		if(literalLength > (size_t)(end - ip) || literalLength > (size_t)(outEnd - op)) {
+			return false;
+		}
+		memcpy(op, ip, literalLength);
+		ip += literalLength;
+		op += literalLength;
+
+		if(ip == end) {
+			//The last sequence only contains literals
+			break;
+		}
+
+		if(end - ip < 2) {
+			return false;
+		}
+		uint32_t offset = ip[0] | (ip[1] << 8);
+		ip += 2;
+		if(offset == 0 || offset > (size_t)(op - dst)) {
+			return false;
+		}
+
+		uint32_t matchLength = token & 0x0F;
+		if(matchLength == 15 && !ReadLength(ip, end, matchLength)) {
+			return false;
+		}
+		matchLength += MinMatch;
+		if(matchLength > (size_t)(outEnd - op)) {
+			return false;
+		}
+
+		const uint8_t* match = op - offset;
+		if(offset >= matchLength) {
+			memcpy(op, match, matchLength);
+			op += matchLength;
+		} else {
+			//Overlapping copy (repeated pattern) - each copy doubles the length of the pattern that can be copied at once
+			uint8_t* copyEnd = op + matchLength;
+			while(op < copyEnd) {
+				uint32_t length = std::min((uint32_t)(op - match), (uint32_t)(copyEnd - op));
+				memcpy(op, match, length);
+				op += length;
+			}
+		}
+	}
+
+	return op == outEnd;
+}
@@ -0,0 +1,17 @@
+#pragma once
+#include "pch.h"
+
+//Compressor/decompressor for the LZ4 block format (compatible with LZ4_compress_default/LZ4_decompress_safe).
+//Much faster than zlib in both directions, at the cost of a lower compression ratio - used for in-memory save states.
+class Lz4
+{
+public:
+	//Size of the buffer required by Compress() in the worst case (incompressible data)
+	static uint32_t GetMaxCompressedSize(uint32_t size) { return size + size / 255 + 16; }
+
+	//dst must be at least GetMaxCompressedSize(size) bytes - returns the compressed size
+	static uint32_t Compress(const uint8_t* src, uint32_t size, uint8_t* dst);
+
+	//Returns false if the data is invalid or doesn't decompress to exactly dstSize bytes
+	static bool Decompress(const uint8_t* src, uint32_t srcSize, uint8_t* dst, uint32_t dstSize);
+};
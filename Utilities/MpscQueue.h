@@ -0,0 +1,91 @@
+#pragma once
+#include "pch.h"
+
+//Bounded lock-free queue with any number of producers and a single consumer.
+//Push never blocks - it fails when the queue is full, and the caller decides what to drop.
+//Each slot carries a sequence number that tells producers/consumer whether it is free or filled.
+template<typename T>
+class MpscQueue
+{
+private:
+	struct Slot
+	{
+		atomic<size_t> Sequence;
+		T Value;
+	};
+
+	unique_ptr<Slot[]> _slots;
+	size_t _mask = 0;
+
+	alignas(64) atomic<size_t> _writePos;
+	alignas(64) atomic<size_t> _readPos;
+
+public:
+	//capacity is rounded up to a power of 2
+	MpscQueue(size_t capacity)
+	{
+		size_t size = 2;
+		while(size < capacity) {
+			size <<= 1;
+		}
+		_slots.reset(new Slot[size]);
+		_mask = size - 1;
+		for(size_t i = 0; i < size; i++) {
+			_slots[i].Sequence.store(i, std::memory_order_relaxed);
+		}
+		_writePos.store(0, std::memory_order_relaxed);
+		_readPos.store(0, std::memory_order_relaxed);
+	}
+
+	bool TryPush(T&& value)
+	{
+		size_t pos = _writePos.load(std::memory_order_relaxed);
+		while(true) {
+			Slot& slot = _slots[pos & _mask];
+			size_t seq = slot.Sequence.load(std::memory_order_acquire);
+			intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+			if(diff == 0) {
+				if(_writePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+					slot.Value = std::move(value);
+					slot.Sequence.store(pos + 1, std::memory_order_release);
+					return true;
+				}
+			} else if(diff < 0) {
+				//Queue is full
+				return false;
+			} else {
+				pos = _writePos.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	//Must only be called from the consumer thread
+	bool TryPop(T& value)
+	{
+		size_t pos = _readPos.load(std::memory_order_relaxed);
+		Slot& slot = _slots[pos & _mask];
+		size_t seq = slot.Sequence.load(std::memory_order_acquire);
+		if((intptr_t)seq - (intptr_t)(pos + 1) < 0) {
+			//Queue is empty (or the producer hasn't finished writing this slot yet)
+			return false;
+		}
+
+		value = std::move(slot.Value);
+		slot.Sequence.store(pos + _mask + 1, std::memory_order_release);
+		_readPos.store(pos + 1, std::memory_order_relaxed);
+		return true;
+	}
+
+	//Approximate number of queued items (exact when no push/pop is in progress)
+	size_t GetSize() const
+	{
+		size_t writePos = _writePos.load(std::memory_order_relaxed);
+		size_t readPos = _readPos.load(std::memory_order_relaxed);
+		return writePos > readPos ? writePos - readPos : 0;
+	}
+
+	size_t GetCapacity() const
+	{
+		return _mask + 1;
+	}
+};
@@ -7,6 +7,16 @@
 #include "spng.h"
 
 bool PNGHelper::WritePNG(std::stringstream &stream, uint32_t* buffer, uint32_t xSize, uint32_t ySize, uint32_t bitsPerPixel)
+{
+	vector<uint8_t> pngData;
+	if(WritePNG(pngData, buffer, xSize, ySize, bitsPerPixel, MZ_DEFAULT_LEVEL)) {
+		stream.write((char*)pngData.data(), pngData.size());
+		return true;
+	}
+	return false;
+}
+
+bool PNGHelper::WritePNG(vector<uint8_t>& output, uint32_t* buffer, uint32_t xSize, uint32_t ySize, uint32_t bitsPerPixel, uint32_t compressionLevel)
 {
 	size_t pngSize = 0;
 
@@ -31,12 +41,12 @@ bool PNGHelper::WritePNG(std::stringstream &stream, uint32_t* buffer, uint32_t x
 		return false;
 	}
 
-	void* pngData = tdefl_write_image_to_png_file_in_memory_ex(convertedData.data(), xSize, ySize, bitsPerPixel / 8, &pngSize, MZ_DEFAULT_LEVEL, MZ_FALSE);
+	void* pngData = tdefl_write_image_to_png_file_in_memory_ex(convertedData.data(), xSize, ySize, bitsPerPixel / 8, &pngSize, std::min<uint32_t>(compressionLevel, MZ_UBER_COMPRESSION), MZ_FALSE);
 	if(!pngData) {
 		std::cout << "tdefl_write_image_to_png_file_in_memory_ex() failed!" << std::endl;
 		return false;
 	} else {
-		stream.write((char*)pngData, pngSize);
+		output.assign((uint8_t*)pngData, (uint8_t*)pngData + pngSize);
 		mz_free(pngData);
 		return true;
 	}
@@ -0,0 +1,103 @@
+#include "pch.h"
+#include "QoiEncoder.h"
+
+static constexpr uint8_t OpIndex = 0x00;
+static constexpr uint8_t OpDiff = 0x40;
+static constexpr uint8_t OpLuma = 0x80;
+static constexpr uint8_t OpRun = 0xC0;
+static constexpr uint8_t OpRgb = 0xFE;
+static constexpr uint32_t MaxRun = 62;
+
+static __forceinline uint8_t* Write32BE(uint8_t* dst, uint32_t value)
+{
+	dst[0] = (uint8_t)(value >> 24);
+	dst[1] = (uint8_t)(value >> 16);
+	dst[2] = (uint8_t)(value >> 8);
+	dst[3] = (uint8_t)value;
+	return dst + 4;
+}
+
+static __forceinline uint32_t GetIndexPosition(uint32_t rgb)
+{
+	//(r * 3 + g * 5 + b * 7 + a * 11) % 64, with a = 255
+	uint32_t r = (rgb >> 16) & 0xFF;
+	uint32_t g = (rgb >> 8) & 0xFF;
+	uint32_t b = rgb & 0xFF;
+	return (r * 3 + g * 5 + b * 7 + 255 * 11) & 0x3F;
+}
+
+uint32_t QoiEncoder::Encode(const uint32_t* argb, uint32_t width, uint32_t height, uint8_t* dst)
+{
+	uint8_t* op = dst;
+	*op++ = 'q';
+	*op++ = 'o';
+	*op++ = 'i';
+	*op++ = 'f';
+	op = Write32BE(op, width);
+	op = Write32BE(op, height);
+	*op++ = 3; //Channels
+	*op++ = 0; //sRGB with linear alpha
+
+	//Pixels are compared without their alpha channel (always 255 in the output)
+	uint32_t index[64] = {};
+	uint32_t prev = 0;
+	uint32_t run = 0;
+
+	uint32_t pixelCount = width * height;
+	for(uint32_t i = 0; i < pixelCount; i++) {
+		uint32_t px = argb[i] & 0xFFFFFF;
+
+		if(px == prev) {
+			run++;
+			if(run == MaxRun) {
+				*op++ = OpRun | (uint8_t)(run - 1);
+				run = 0;
+			}
+			continue;
+		}
+
+		if(run > 0) {
+			*op++ = OpRun | (uint8_t)(run - 1);
+			run = 0;
+		}
+
+		uint32_t pos = GetIndexPosition(px);
+		//The index starts out zeroed (a = 0), so it can't match any pixel until it's been written
+		if(index[pos] == (px | 0xFF000000)) {
+			*op++ = OpIndex | (uint8_t)pos;
+		} else {
+			index[pos] = px | 0xFF000000;
+
+			int8_t vr = (int8_t)(((px >> 16) & 0xFF) - ((prev >> 16) & 0xFF));
+			int8_t vg = (int8_t)(((px >> 8) & 0xFF) - ((prev >> 8) & 0xFF));
+			int8_t vb = (int8_t)((px & 0xFF) - (prev & 0xFF));
+			int8_t vgr = (int8_t)(vr - vg);
+			int8_t vgb = (int8_t)(vb - vg);
+
+			if(vr > -3 && vr < 2 && vg > -3 && vg < 2 && vb > -3 && vb < 2) {
+				*op++ = OpDiff | (uint8_t)((vr + 2) << 4) | (uint8_t)((vg + 2) << 2) | (uint8_t)(vb + 2);
+			} else if(vgr > -9 && vgr < 8 && vg > -33 && vg < 32 && vgb > -9 && vgb < 8) {
+				*op++ = OpLuma | (uint8_t)(vg + 32);
+				*op++ = (uint8_t)((vgr + 8) << 4) | (uint8_t)(vgb + 8);
+			} else {
+				*op++ = OpRgb;
+				*op++ = (uint8_t)(px >> 16);
+				*op++ = (uint8_t)(px >> 8);
+				*op++ = (uint8_t)px;
+			}
+		}
+		prev = px;
+	}
+
+	if(run > 0) {
+		*op++ = OpRun | (uint8_t)(run - 1);
+	}
+
+	//End marker
+	for(int i = 0; i < 7; i++) {
+		*op++ = 0;
+	}
+	*op++ = 1;
+
+	return (uint32_t)(op - dst);
+}
@@ -0,0 +1,15 @@
+#pragma once
+#include "pch.h"
+
+//Encoder for the QOI image format (https://qoiformat.org) - lossless, and typically 20-50x faster than
+//PNG/deflate for a 30-40% larger file, which makes it a good fit for screenshots taken every frame.
+//Images are written as 3-channel (RGB, sRGB) images, the alpha channel of the input is ignored.
+class QoiEncoder
+{
+public:
+	//Size of the buffer required by Encode() in the worst case
+	static uint32_t GetMaxSize(uint32_t width, uint32_t height) { return width * height * 4 + 14 + 8; }
+
+	//argb is a width*height buffer of 0xAARRGGBB pixels, dst must be at least GetMaxSize() bytes - returns the encoded size
+	static uint32_t Encode(const uint32_t* argb, uint32_t width, uint32_t height, uint8_t* dst);
+};
@@ -471,3 +471,82 @@ void scale(unsigned scale, void* void_dst, unsigned dst_slice, const void* void_
 	}
 }
 
+/**
+ * Apply the Scale effect on a slice of rows of a bitmap.
+ * This function produces the same output as ::scale() for the source rows [y_first, y_last),
+ * the rows outside of the slice are only read (as neighbors).
+ * Different slices of the same bitmap can be processed concurrently.
+ * \param scale Scale factor. 2, 203 (fox 2x3), 204 (for 2x4), 3 or 4.
+ * \param void_dst Pointer at the first pixel of the destination bitmap (not of the slice).
+ * \param dst_slice Size in bytes of a destination bitmap row.
+ * \param void_src Pointer at the first pixel of the source bitmap (not of the slice).
+ * \param src_slice Size in bytes of a source bitmap row.
+ * \param pixel Bytes per pixel of the source and destination bitmap.
+ * \param width Horizontal size in pixels of the source bitmap.
+ * \param height Vertical size in pixels of the source bitmap.
+ * \param y_first First source row to process.
+ * \param y_last Source row after the last row to process.
+ */
+void scale_slice(unsigned scale, void* void_dst, unsigned dst_slice, const void* void_src, unsigned src_slice, unsigned pixel, unsigned width, unsigned height, unsigned y_first, unsigned y_last)
+{
+	unsigned char* dst = (unsigned char*)void_dst;
+	const unsigned char* src = (const unsigned char*)void_src;
+	unsigned y;
+
+	if (y_last > height)
+		y_last = height;
+	if (y_first >= y_last)
+		return;
+
+	if (scale == 4 || scale == 404) {
+		/* first pass: scale2x of the source rows used by the slice, into a buffer of 2x rows */
+		unsigned s_first = y_first > 0 ? y_first - 1 : 0;
+		unsigned s_last = y_last < height ? y_last + 1 : height;
+		unsigned mid_slice = (2 * pixel * width + 0x7) & ~0x7; /* align to 8 bytes */
+		unsigned char* mid = (unsigned char*)malloc(2 * (s_last - s_first) * mid_slice);
+
+		if (!mid)
+			return;
+
+		for (y = s_first; y < s_last; ++y) {
+			unsigned char* row = mid + 2 * (y - s_first) * mid_slice;
+			stage_scale2x(row, row + mid_slice, SCSRC(y > 0 ? y - 1 : 0), SCSRC(y), SCSRC(y + 1 < height ? y + 1 : y), pixel, width);
+		}
+
+		/* second pass: scale2x of the 2x rows, 2 rows of the buffer for each source row */
+		for (y = y_first; y < y_last; ++y) {
+			unsigned m = 2 * y;
+			const unsigned char* mid0 = mid + ((m > 0 ? m - 1 : 0) - 2 * s_first) * mid_slice;
+			const unsigned char* mid1 = mid + (m - 2 * s_first) * mid_slice;
+			const unsigned char* mid2 = mid1 + mid_slice;
+			const unsigned char* mid3 = mid + ((m + 2 < 2 * height ? m + 2 : m + 1) - 2 * s_first) * mid_slice;
+			stage_scale4x(SCDST(4 * y), SCDST(4 * y + 1), SCDST(4 * y + 2), SCDST(4 * y + 3), mid0, mid1, mid2, mid3, pixel, width);
+		}
+
+		free(mid);
+		return;
+	}
+
+	for (y = y_first; y < y_last; ++y) {
+		const unsigned char* src0 = SCSRC(y > 0 ? y - 1 : 0);
+		const unsigned char* src1 = SCSRC(y);
+		const unsigned char* src2 = SCSRC(y + 1 < height ? y + 1 : y);
+
+		switch (scale) {
+		case 202 :
+		case 2 :
+			stage_scale2x(SCDST(2 * y), SCDST(2 * y + 1), src0, src1, src2, pixel, width);
+			break;
+		case 203 :
+			stage_scale2x3(SCDST(3 * y), SCDST(3 * y + 1), SCDST(3 * y + 2), src0, src1, src2, pixel, width);
+			break;
+		case 204 :
+			stage_scale2x4(SCDST(4 * y), SCDST(4 * y + 1), SCDST(4 * y + 2), SCDST(4 * y + 3), src0, src1, src2, pixel, width);
+			break;
+		case 303 :
+		case 3 :
+			stage_scale3x(SCDST(3 * y), SCDST(3 * y + 1), SCDST(3 * y + 2), src0, src1, src2, pixel, width);
+			break;
+		}
+	}
+}
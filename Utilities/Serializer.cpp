@@ -1,8 +1,15 @@
 #include "pch.h"
 #include <algorithm>
+#include <sstream>
 #include "Serializer.h"
 #include "ISerializable.h"
-#include "miniz.h"
+#include "SimpleLock.h"
+#include "CompressionHelper.h"
+
+//Compact format layouts, shared by all emulator instances (never freed, data saved with a layout can be loaded at any time)
+static SimpleLock _layoutLock;
+static vector<unique_ptr<SerializerLayout>> _layouts;
+static constexpr size_t MaxLayoutCount = 256;
 
 Serializer::Serializer(uint32_t version, bool forSave, SerializeFormat format)
 {
@@ -20,6 +27,10 @@ Serializer::Serializer(uint32_t version, bool forSave, SerializeFormat format)
 
 void Serializer::AddKeyPrefix(string prefix)
 {
+	if(_compactMode == CompactMode::Replay) {
+		LeaveReplay();
+	}
+
 	vector<string> keys;
 	for(auto& kvp : _values) {
 		keys.push_back(kvp.first);
@@ -33,6 +44,10 @@ void Serializer::AddKeyPrefix(string prefix)
 
 void Serializer::RemoveKeyPrefix(string prefix)
 {
+	if(_compactMode == CompactMode::Replay) {
+		LeaveReplay();
+	}
+
 	vector<string> keys;
 	vector<string> keysToRemove;
 
@@ -56,24 +71,25 @@ void Serializer::RemoveKeyPrefix(string prefix)
 
 void Serializer::RemoveKeys(vector<string>& keysToRemove)
 {
+	if(_compactMode == CompactMode::Replay) {
+		LeaveReplay();
+	}
+
 	for(string& key : keysToRemove) {
 		_values.erase(key);
 	}
 }
 
-bool Serializer::LoadFrom(istream &file)
+bool Serializer::ReadStateData(istream& file, uint32_t& layoutId)
 {
-	if(_saving) {
-		return false;
-	}
-
-	if(_format == SerializeFormat::Text) {
-		return LoadFromTextFormat(file);
-	}
-
 	char value = 0;
 	file.get(value);
-	bool isCompressed = value == 1;
+	bool isCompressed = (value & Serializer::CompressedFlag) != 0;
+
+	layoutId = 0;
+	if(value & Serializer::CompactFlag) {
+		file.read((char*)&layoutId, sizeof(layoutId));
+	}
 
 	if(isCompressed) {
 		uint32_t decompressedSize;
@@ -92,8 +108,8 @@ bool Serializer::LoadFrom(istream &file)
 
 		_data = vector<uint8_t>(decompressedSize, 0);
 
-		unsigned long decompSize = decompressedSize;
-		if(uncompress(_data.data(), &decompSize, compressedData.data(), (unsigned long)compressedData.size()) != MZ_OK) {
+		CompressionCodec codec = (value & Serializer::Lz4Flag) ? CompressionCodec::Lz4 : CompressionCodec::Zlib;
+		if(!CompressionHelper::DecompressBlock(compressedData.data(), compressedSize, codec, _data.data(), decompressedSize)) {
 			return false;
 		}
 	} else {
@@ -106,6 +122,41 @@ bool Serializer::LoadFrom(istream &file)
 		file.read((char*)_data.data(), stateSize);
 	}
 
+	return true;
+}
+
+bool Serializer::LoadFrom(istream &file)
+{
+	if(_saving) {
+		return false;
+	}
+
+	if(_format == SerializeFormat::Text) {
+		return LoadFromTextFormat(file);
+	}
+
+	uint32_t layoutId;
+	if(!ReadStateData(file, layoutId)) {
+		return false;
+	}
+
+	if(layoutId) {
+		_layout = FindLayout(layoutId);
+		if(!_layout) {
+			return false;
+		}
+
+		_compactMode = CompactMode::Replay;
+		_layoutPos = 0;
+		_readPos = 0;
+		if(_layout->Version != _version) {
+			//Keys are still valid, but values may be streamed in a different order
+			LeaveReplay();
+			return _values.size() > 0;
+		}
+		return true;
+	}
+
 	uint32_t size = (uint32_t)_data.size();
 	uint32_t i = 0;
 	string key;
@@ -204,25 +255,38 @@ bool Serializer::LoadFromTextFormat(istream& file)
 	return true;
 }
 
-void Serializer::SaveTo(ostream& file, int compressionLevel)
+void Serializer::SaveTo(ostream& file, int compressionLevel, CompressionCodec codec)
 {
 	if(_format == SerializeFormat::Text) {
 		file.write((char*)_data.data(), _data.size());
 	} else {
+		if(_compactMode != CompactMode::None) {
+			_layoutId = FinishCompactLayout();
+		}
+
 		bool isCompressed = compressionLevel > 0;
-		file.put((char)isCompressed);
+		uint8_t flags = isCompressed ? Serializer::CompressedFlag : 0;
+		if(isCompressed && codec == CompressionCodec::Lz4) {
+			flags |= Serializer::Lz4Flag;
+		}
+		if(_layoutId) {
+			flags |= Serializer::CompactFlag;
+		}
+
+		file.put((char)flags);
+		if(_layoutId) {
+			file.write((char*)&_layoutId, sizeof(_layoutId));
+		}
 
 		if(isCompressed) {
-			unsigned long compressedSize = compressBound((unsigned long)_data.size());
-			uint8_t* compressedData = new uint8_t[compressedSize];
-			compress2(compressedData, &compressedSize, (unsigned char*)_data.data(), (unsigned long)_data.size(), compressionLevel);
+			vector<uint8_t> compressedData;
+			CompressionHelper::CompressBlock(_data.data(), (uint32_t)_data.size(), compressionLevel, codec, compressedData);
 
-			uint32_t size = (uint32_t)compressedSize;
+			uint32_t size = (uint32_t)compressedData.size();
 			uint32_t originalSize = (uint32_t)_data.size();
 			file.write((char*)&originalSize, sizeof(uint32_t));
 			file.write((char*)&size, sizeof(uint32_t));
-			file.write((char*)compressedData, compressedSize);
-			delete[] compressedData;
+			file.write((char*)compressedData.data(), compressedData.size());
 		} else {
 			file.write((char*)_data.data(), _data.size());
 		}
@@ -269,12 +333,29 @@ string Serializer::NormalizeName(const char* name, int index)
 
 void Serializer::PushNamePrefix(const char* name, int index)
 {
-	_prefixes.push_back(NormalizeName(name, index));
+	if(_compactMode == CompactMode::Replay && MatchLayout(name, index, 0, SerializerLayoutEntryType::PushPrefix)) {
+		_layoutPrefixes.push_back(_layoutPos - 1);
+		return;
+	}
+
+	string prefix = NormalizeName(name, index);
+	if(_compactMode == CompactMode::Record) {
+		_newLayout->Entries.push_back({ name, index, 0, SerializerLayoutEntryType::PushPrefix, prefix });
+	}
+	_prefixes.push_back(prefix);
 	UpdatePrefix();
 }
 
 void Serializer::PopNamePrefix()
 {
+	if(_compactMode == CompactMode::Replay && MatchLayout("", -1, 0, SerializerLayoutEntryType::PopPrefix)) {
+		_layoutPrefixes.pop_back();
+		return;
+	}
+
+	if(_compactMode == CompactMode::Record) {
+		_newLayout->Entries.push_back({ "", -1, 0, SerializerLayoutEntryType::PopPrefix, "" });
+	}
 	_prefixes.pop_back();
 	UpdatePrefix();
 }
@@ -287,4 +368,184 @@ void Serializer::UpdatePrefix()
 			_prefix += prefix + ".";
 		}
 	}
-}
\ No newline at end of file
+}
+void Serializer::UseCompactFormat(uint32_t layoutId)
+{
+	if(!_saving || _format != SerializeFormat::Binary) {
+		return;
+	}
+
+	_layout = FindLayout(layoutId);
+	if(_layout && _layout->Version == _version) {
+		_compactMode = CompactMode::Replay;
+		_layoutPos = 0;
+	} else {
+		_layout = nullptr;
+		_newLayout.reset(new SerializerLayout());
+		_newLayout->Version = _version;
+		_compactMode = CompactMode::Record;
+	}
+}
+
+void Serializer::LeaveReplay()
+{
+	//Restore the key prefix, which isn't maintained while replaying
+	_prefixes.clear();
+	for(uint32_t pos : _layoutPrefixes) {
+		_prefixes.push_back(_layout->Entries[pos].Key);
+	}
+	_layoutPrefixes.clear();
+	UpdatePrefix();
+
+	if(_saving) {
+		//The values written so far match the layout, keep them and record a new layout from this point
+		_newLayout.reset(new SerializerLayout());
+		_newLayout->Version = _version;
+		_newLayout->Entries.assign(_layout->Entries.begin(), _layout->Entries.begin() + _layoutPos);
+		_compactMode = CompactMode::Record;
+	} else {
+		//Look up the remaining values by key
+		vector<std::pair<const string*, SerializeValue>> values;
+		GetLayoutValues(*_layout, _data, values);
+		for(auto& value : values) {
+			_values.emplace(*value.first, value.second);
+		}
+		_compactMode = CompactMode::None;
+	}
+	_layout = nullptr;
+}
+
+uint32_t Serializer::FinishCompactLayout()
+{
+	if(_compactMode == CompactMode::Replay) {
+		if(_layoutPos == _layout->Entries.size()) {
+			_compactMode = CompactMode::None;
+			return _layout->Id;
+		}
+
+		//Fewer values than the layout contains, the data only matches the start of the layout
+		LeaveReplay();
+	}
+
+	_compactMode = CompactMode::None;
+	uint32_t layoutId = RegisterLayout(_newLayout);
+	if(layoutId == 0) {
+		//Too many layouts, save with the keyed format instead
+		vector<uint8_t> keyedData;
+		WriteKeyedData(*_newLayout, _data, keyedData);
+		_data = std::move(keyedData);
+	}
+	_newLayout.reset();
+	return layoutId;
+}
+
+const SerializerLayout* Serializer::FindLayout(uint32_t layoutId)
+{
+	auto lock = _layoutLock.AcquireSafe();
+	return layoutId > 0 && layoutId <= _layouts.size() ? _layouts[layoutId - 1].get() : nullptr;
+}
+
+uint32_t Serializer::RegisterLayout(unique_ptr<SerializerLayout>& layout)
+{
+	auto isSameLayout = [&](const SerializerLayout& existing) {
+		if(existing.Version != layout->Version || existing.Entries.size() != layout->Entries.size()) {
+			return false;
+		}
+		for(size_t i = 0; i < existing.Entries.size(); i++) {
+			const SerializerLayoutEntry& a = existing.Entries[i];
+			const SerializerLayoutEntry& b = layout->Entries[i];
+			if(a.Name != b.Name || a.Index != b.Index || a.Size != b.Size || a.Type != b.Type) {
+				return false;
+			}
+		}
+		return true;
+	};
+
+	auto lock = _layoutLock.AcquireSafe();
+	//Layouts alternate when e.g both rewind (with settings) and run-ahead (without) are used
+	for(unique_ptr<SerializerLayout>& existing : _layouts) {
+		if(isSameLayout(*existing)) {
+			return existing->Id;
+		}
+	}
+
+	if(_layouts.size() >= MaxLayoutCount) {
+		return 0;
+	}
+
+	layout->Id = (uint32_t)_layouts.size() + 1;
+	_layouts.push_back(std::move(layout));
+	return _layouts.back()->Id;
+}
+
+void Serializer::GetLayoutValues(const SerializerLayout& layout, vector<uint8_t>& data, vector<std::pair<const string*, SerializeValue>>& values)
+{
+	uint32_t size = (uint32_t)data.size();
+	uint32_t pos = 0;
+	for(const SerializerLayoutEntry& entry : layout.Entries) {
+		uint32_t valueSize = entry.Size;
+		switch(entry.Type) {
+			case SerializerLayoutEntryType::Sized:
+				if(pos + 4 > size) {
+					return;
+				}
+				valueSize = data[pos] | (data[pos + 1] << 8) | (data[pos + 2] << 16) | (data[pos + 3] << 24);
+				pos += 4;
+				[[fallthrough]];
+
+			case SerializerLayoutEntryType::Value:
+				if(pos + valueSize > size) {
+					return;
+				}
+				values.push_back({ &entry.Key, SerializeValue(data.data() + pos, valueSize) });
+				pos += valueSize;
+				break;
+
+			default:
+				break;
+		}
+	}
+}
+
+void Serializer::WriteKeyedData(const SerializerLayout& layout, vector<uint8_t>& data, vector<uint8_t>& out)
+{
+	vector<std::pair<const string*, SerializeValue>> values;
+	GetLayoutValues(layout, data, values);
+
+	out.clear();
+	out.reserve(data.size() * 2);
+	for(auto& value : values) {
+		const string& key = *value.first;
+		uint32_t size = value.second.Size;
+		out.insert(out.end(), key.begin(), key.end());
+		out.push_back(0);
+		out.insert(out.end(), (uint8_t*)&size, (uint8_t*)&size + sizeof(size));
+		out.insert(out.end(), value.second.DataPtr, value.second.DataPtr + size);
+	}
+}
+
+bool Serializer::ConvertToKeyedFormat(vector<uint8_t>& state)
+{
+	if(state.empty() || !(state[0] & Serializer::CompactFlag)) {
+		return true;
+	}
+
+	std::stringstream stream;
+	stream.write((char*)state.data(), state.size());
+	stream.seekg(0, std::ios::beg);
+
+	Serializer s(0, false);
+	uint32_t layoutId;
+	const SerializerLayout* layout;
+	if(!s.ReadStateData(stream, layoutId) || !(layout = FindLayout(layoutId))) {
+		return false;
+	}
+
+	vector<uint8_t> keyedData;
+	WriteKeyedData(*layout, s._data, keyedData);
+
+	state.clear();
+	state.push_back(0);
+	state.insert(state.end(), keyedData.begin(), keyedData.end());
+	return true;
+}
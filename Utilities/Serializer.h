@@ -5,6 +5,7 @@
 #include "Utilities/FastString.h"
 #include "Utilities/magic_enum.hpp"
 #include "Utilities/safe_ptr.h"
+#include "Utilities/CompressionCodec.h"
 
 class Serializer;
 
@@ -69,6 +70,35 @@ enum class SerializeFormat
 	Map
 };
 
+enum class SerializerLayoutEntryType : uint8_t
+{
+	Value, //Fixed size value or array
+	Sized, //Vector or string, size is stored in the data before the value
+	PushPrefix,
+	PopPrefix
+};
+
+struct SerializerLayoutEntry
+{
+	//Copy of the name given to Stream()/PushNamePrefix() - callers can build names on the fly (e.g GbaPpu), so the pointer can't be kept
+	string Name;
+	int Index;
+	uint32_t Size;
+	SerializerLayoutEntryType Type;
+
+	//Full key for values, normalized name for prefixes (used to convert the data back to the keyed format)
+	string Key;
+};
+
+//Sequence of Stream()/PushNamePrefix()/PopNamePrefix() calls made by a save, recorded once
+//and then used to save/load the values positionally without building or looking up keys
+struct SerializerLayout
+{
+	uint32_t Id = 0;
+	uint32_t Version = 0;
+	vector<SerializerLayoutEntry> Entries;
+};
+
 class Serializer
 {
 private:
@@ -86,11 +116,96 @@ private:
 	bool _saving = false;
 	SerializeFormat _format = SerializeFormat::Binary;
 
+	//Compact format
+	enum class CompactMode { None, Record, Replay };
+	CompactMode _compactMode = CompactMode::None;
+	const SerializerLayout* _layout = nullptr;
+	unique_ptr<SerializerLayout> _newLayout;
+	uint32_t _layoutPos = 0;
+	uint32_t _layoutId = 0;
+	uint32_t _readPos = 0;
+	vector<uint32_t> _layoutPrefixes;
+
+	static constexpr uint8_t CompressedFlag = 0x01;
+	static constexpr uint8_t CompactFlag = 0x02;
+	static constexpr uint8_t Lz4Flag = 0x04;
+
 private:
+	bool ReadStateData(istream& file, uint32_t& layoutId);
 	bool LoadFromTextFormat(istream& file);
 	string NormalizeName(const char* name, int index);
 	void UpdatePrefix();
 
+	static const SerializerLayout* FindLayout(uint32_t layoutId);
+	static uint32_t RegisterLayout(unique_ptr<SerializerLayout>& layout);
+	static void GetLayoutValues(const SerializerLayout& layout, vector<uint8_t>& data, vector<std::pair<const string*, SerializeValue>>& values);
+	static void WriteKeyedData(const SerializerLayout& layout, vector<uint8_t>& data, vector<uint8_t>& out);
+
+	void LeaveReplay();
+	uint32_t FinishCompactLayout();
+
+	__forceinline bool MatchLayout(const char* name, int index, uint32_t size, SerializerLayoutEntryType type)
+	{
+		if(_layoutPos < _layout->Entries.size()) {
+			const SerializerLayoutEntry& entry = _layout->Entries[_layoutPos];
+			if(entry.Index == index && entry.Size == size && entry.Type == type && strcmp(entry.Name.c_str(), name) == 0) {
+				_layoutPos++;
+				return true;
+			}
+		}
+		LeaveReplay();
+		return false;
+	}
+
+	//Compact format: handles the next value positionally if it matches the layout, otherwise switches
+	//to the keyed format (when loading) or to recording a new layout (when saving) and returns false
+	__forceinline bool ReplayValue(const char* name, int index, uint32_t size, SerializerLayoutEntryType type, SerializeValue& savedValue)
+	{
+		bool isSized = type == SerializerLayoutEntryType::Sized;
+		if(!MatchLayout(name, index, isSized ? 0 : size, type)) {
+			return false;
+		}
+
+		if(_saving) {
+			if(isSized) {
+				WriteValue(size);
+			}
+			return true;
+		}
+
+		if(isSized) {
+			if(_readPos + 4 > _data.size()) {
+				LeaveReplay();
+				return false;
+			}
+			ReadValue(size, &_data[_readPos]);
+			_readPos += 4;
+		}
+		if(_readPos + size > _data.size()) {
+			LeaveReplay();
+			return false;
+		}
+		savedValue = SerializeValue(_data.data() + _readPos, size);
+		_readPos += size;
+		return true;
+	}
+
+	//Writes the key & size of a value (keyed format), or adds it to the layout being recorded (compact format)
+	void WriteValueHeader(string& key, const char* name, int index, uint32_t size, SerializerLayoutEntryType type)
+	{
+		if(_compactMode == CompactMode::Record) {
+			bool isSized = type == SerializerLayoutEntryType::Sized;
+			_newLayout->Entries.push_back({ name, index, isSized ? 0 : size, type, key });
+			if(isSized) {
+				WriteValue(size);
+			}
+		} else {
+			_data.insert(_data.end(), key.begin(), key.end());
+			_data.push_back(0);
+			WriteValue(size);
+		}
+	}
+
 	string GetKey(const char* name, int index)
 	{
 		string valName = NormalizeName(name, index);
@@ -105,9 +220,12 @@ private:
 	{
 		uint8_t* ptr = (uint8_t*)&value;
 		constexpr bool isBigEndian = false;
-		constexpr int mask = isBigEndian ? sizeof(T) - 1 : 0;
-		for(int i = 0; i < (int)sizeof(T); i++) {
-			_data.push_back(ptr[i ^ mask]);
+		if constexpr(!isBigEndian) {
+			_data.insert(_data.end(), ptr, ptr + sizeof(T));
+		} else {
+			for(int i = (int)sizeof(T) - 1; i >= 0; i--) {
+				_data.push_back(ptr[i]);
+			}
 		}
 	}
 
@@ -116,9 +234,31 @@ private:
 	{
 		uint8_t* ptr = (uint8_t*)&value;
 		constexpr bool isBigEndian = false;
-		constexpr int mask = isBigEndian ? sizeof(T) - 1 : 0;
-		for(int i = 0; i < (int)sizeof(T); i++) {
-			ptr[i ^ mask] = src[i];
+		if constexpr(!isBigEndian) {
+			memcpy(ptr, src, sizeof(T));
+		} else {
+			for(int i = 0; i < (int)sizeof(T); i++) {
+				ptr[sizeof(T) - 1 - i] = src[i];
+			}
+		}
+	}
+
+	template<typename T> void WriteVector(vector<T>& values)
+	{
+		for(uint32_t i = 0, elementCount = (uint32_t)values.size(); i < elementCount; i++) {
+			WriteValue(values[i]);
+		}
+	}
+
+	template<typename T> void ReadVector(vector<T>& values, SerializeValue& savedValue)
+	{
+		uint32_t elementCount = savedValue.Size / sizeof(T);
+		values.resize(elementCount);
+
+		uint8_t* src = savedValue.DataPtr;
+		for(uint32_t i = 0; i < elementCount; i++) {
+			ReadValue(values[i], src);
+			src += sizeof(T);
 		}
 	}
 
@@ -221,7 +361,7 @@ public:
 	SerializeFormat GetFormat() { return _format; }
 	unordered_map<string, SerializeMapValue>& GetMapValues() { return _mapValues; }
 
-	bool IsValid() { return _values.size() > 0; }
+	bool IsValid() { return _compactMode == CompactMode::Replay || _values.size() > 0; }
 	void AddKeyPrefix(string prefix);
 	void RemoveKeyPrefix(string prefix);
 	void RemoveKeys(vector<string>& keys);
@@ -242,6 +382,18 @@ public:
 		if constexpr(std::is_base_of<ISerializable, T>::value) {
 			Stream((ISerializable&)value, name, index);
 		} else {
+			if(_compactMode == CompactMode::Replay) {
+				SerializeValue savedValue;
+				if(ReplayValue(name, index, sizeof(T), SerializerLayoutEntryType::Value, savedValue)) {
+					if(_saving) {
+						WriteValue(value);
+					} else {
+						ReadValue(value, savedValue.DataPtr);
+					}
+					return;
+				}
+			}
+
 			string key = GetKey(name, index);
 
 			CheckDuplicateKey(key);
@@ -249,12 +401,8 @@ public:
 			if(_saving) {
 				switch(_format) {
 					case SerializeFormat::Binary:
-						//Write key
-						_data.insert(_data.end(), key.begin(), key.end());
-						_data.push_back(0);
-
-						//Write value size
-						WriteValue((uint32_t)sizeof(T));
+						//Write key & value size
+						WriteValueHeader(key, name, index, (uint32_t)sizeof(T), SerializerLayoutEntryType::Value);
 
 						//Write value
 						WriteValue(value);
@@ -345,6 +493,18 @@ public:
 			return;
 		}
 
+		if(_compactMode == CompactMode::Replay) {
+			SerializeValue savedValue;
+			if(ReplayValue(name, -1, (uint32_t)(elementCount * sizeof(T)), SerializerLayoutEntryType::Value, savedValue)) {
+				if(_saving) {
+					_data.insert(_data.end(), (uint8_t*)arrayValues, (uint8_t*)(arrayValues + elementCount));
+				} else {
+					memcpy(arrayValues, savedValue.DataPtr, savedValue.Size);
+				}
+				return;
+			}
+		}
+
 		string key = GetKey(name, -1);
 
 		CheckDuplicateKey(key);
@@ -352,12 +512,8 @@ public:
 		//TODO detect big vs little endian
 		constexpr bool isBigEndian = false;
 		if(_saving) {
-			//Write key
-			_data.insert(_data.end(), key.begin(), key.end());
-			_data.push_back(0);
-
-			//Write array size
-			WriteValue((uint32_t)(elementCount * sizeof(T)));
+			//Write key & array size
+			WriteValueHeader(key, name, -1, (uint32_t)(elementCount * sizeof(T)), SerializerLayoutEntryType::Value);
 
 			//Write array content
 			if constexpr(sizeof(T) == 1 || !isBigEndian) {
@@ -394,35 +550,30 @@ public:
 			return;
 		}
 
+		SerializeValue savedValue;
+		if(_compactMode == CompactMode::Replay && ReplayValue(name, index, (uint32_t)(values.size() * sizeof(T)), SerializerLayoutEntryType::Sized, savedValue)) {
+			if(_saving) {
+				WriteVector(values);
+			} else {
+				ReadVector(values, savedValue);
+			}
+			return;
+		}
+
 		string key = GetKey(name, index);
 
 		CheckDuplicateKey(key);
 
 		if(_saving) {
-			//Write key
-			_data.insert(_data.end(), key.begin(), key.end());
-			_data.push_back(0);
-
-			uint32_t elementCount = (uint32_t)values.size();
-			//Write array size
-			WriteValue((uint32_t)(elementCount * sizeof(T)));
+			//Write key & array size
+			WriteValueHeader(key, name, index, (uint32_t)(values.size() * sizeof(T)), SerializerLayoutEntryType::Sized);
 
 			//Write array content
-			for(uint32_t i = 0; i < elementCount; i++) {
-				WriteValue(values[i]);
-			}
+			WriteVector(values);
 		} else {
 			auto result = _values.find(key);
 			if(result != _values.end()) {
-				SerializeValue& savedValue = result->second;
-				uint32_t elementCount = savedValue.Size / sizeof(T);
-				values.resize(elementCount);
-
-				uint8_t* src = savedValue.DataPtr;
-				for(uint32_t i = 0; i < elementCount; i++) {
-					ReadValue(values[i], src);
-					src += sizeof(T);
-				}
+				ReadVector(values, result->second);
 			} else {
 				values.clear();
 			}
@@ -431,13 +582,34 @@ public:
 
 	void PushNamePrefix(const char* name, int index = -1);
 	void PopNamePrefix();
-	void SaveTo(ostream &file, int compressionLevel = 1);
+	void SaveTo(ostream &file, int compressionLevel = 1, CompressionCodec codec = CompressionCodec::Zlib);
 	bool LoadFrom(istream& file);
 	void LoadFromMap(unordered_map<string, SerializeMapValue>& map);
+
+	//Compact format (binary format only): the first save records the layout of the state (see SerializerLayout),
+	//later saves given its ID stream the values positionally. Saves that no longer match the layout record a
+	//new one, loads that don't match fall back to key lookups. Layouts only exist in memory, so this is
+	//meant for short-lived states (rewind, run-ahead, etc.) - LoadFrom() detects the format automatically.
+	void UseCompactFormat(uint32_t layoutId);
+	//Layout used by the data written by SaveTo() (0 for the keyed format)
+	uint32_t GetCompactLayoutId() { return _layoutId; }
+
+	//Converts a state saved with the compact format to the keyed format (e.g before writing it to a file)
+	static bool ConvertToKeyedFormat(vector<uint8_t>& state);
 };
 
 template<> inline void Serializer::Stream(string& value, const char* name, int index)
 {
+	SerializeValue savedValue;
+	if(_compactMode == CompactMode::Replay && ReplayValue(name, index, (uint32_t)value.size(), SerializerLayoutEntryType::Sized, savedValue)) {
+		if(_saving) {
+			_data.insert(_data.end(), value.begin(), value.end());
+		} else {
+			value = string(savedValue.DataPtr, savedValue.DataPtr + savedValue.Size);
+		}
+		return;
+	}
+
 	string key = GetKey(name, index);
 
 	CheckDuplicateKey(key);
@@ -450,12 +622,8 @@ template<> inline void Serializer::Stream(string& value, const char* name, int i
 		}
 	} else {
 		if(_saving) {
-			//Write key
-			_data.insert(_data.end(), key.begin(), key.end());
-			_data.push_back(0);
-
-			//Write string size
-			WriteValue((uint32_t)value.size());
+			//Write key & string size
+			WriteValueHeader(key, name, index, (uint32_t)value.size(), SerializerLayoutEntryType::Sized);
 
 			//Write string content
 			_data.insert(_data.end(), value.begin(), value.end());
@@ -0,0 +1,91 @@
+#include "pch.h"
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(uint32_t threadCount)
+{
+	if(threadCount == 0) {
+		uint32_t hwThreads = std::thread::hardware_concurrency();
+		threadCount = hwThreads > 1 ? hwThreads - 1 : 0;
+	}
+
+	_nextIndex = 0;
+	for(uint32_t i = 0; i < threadCount; i++) {
+		_threads.emplace_back(&ThreadPool::WorkerLoop, this);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		_stop = true;
+	}
+	_workSignal.notify_all();
+
+	for(std::thread& thread : _threads) {
+		thread.join();
+	}
+}
+
+void ThreadPool::WorkerLoop()
+{
+	uint64_t lastJobId = 0;
+	while(true) {
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_workSignal.wait(lock, [&] { return _stop || _jobId != lastJobId; });
+			if(_stop) {
+				return;
+			}
+			lastJobId = _jobId;
+		}
+
+		RunTasks();
+
+		std::unique_lock<std::mutex> lock(_mutex);
+		if(--_busyWorkers == 0) {
+			_doneSignal.notify_all();
+		}
+	}
+}
+
+void ThreadPool::RunTasks()
+{
+	uint32_t index;
+	while((index = _nextIndex++) < _taskCount) {
+		(*_task)(index);
+	}
+}
+
+void ThreadPool::ParallelFor(uint32_t count, const std::function<void(uint32_t)>& task)
+{
+	if(count == 0) {
+		return;
+	}
+
+	if(_threads.empty() || count == 1) {
+		for(uint32_t i = 0; i < count; i++) {
+			task(i);
+		}
+		return;
+	}
+
+	std::unique_lock<std::mutex> jobLock(_jobLock);
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		_task = &task;
+		_taskCount = count;
+		_nextIndex = 0;
+		_busyWorkers = (uint32_t)_threads.size();
+		_jobId++;
+	}
+	_workSignal.notify_all();
+
+	RunTasks();
+
+	//Workers still reference _task until they have all checked in
+	std::unique_lock<std::mutex> lock(_mutex);
+	_doneSignal.wait(lock, [this] { return _busyWorkers == 0; });
+	_task = nullptr;
+	_taskCount = 0;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "pch.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+//Fixed set of worker threads for data-parallel work (one job at a time).
+//ParallelFor() hands out indexes [0, count) to the workers and the calling thread,
+//and returns once every index has been processed.
+class ThreadPool
+{
+private:
+	vector<std::thread> _threads;
+
+	std::mutex _mutex;
+	std::condition_variable _workSignal;
+	std::condition_variable _doneSignal;
+	std::mutex _jobLock;
+
+	const std::function<void(uint32_t)>* _task = nullptr;
+	uint32_t _taskCount = 0;
+	atomic<uint32_t> _nextIndex;
+	uint32_t _busyWorkers = 0;
+	uint64_t _jobId = 0;
+	bool _stop = false;
+
+	void WorkerLoop();
+	void RunTasks();
+
+public:
+	//threadCount = 0 uses one worker per hardware thread (minus the calling thread)
+	ThreadPool(uint32_t threadCount = 0);
+	~ThreadPool();
+
+	//Number of threads that run tasks, including the calling thread
+	uint32_t GetConcurrency() { return (uint32_t)_threads.size() + 1; }
+
+	void ParallelFor(uint32_t count, const std::function<void(uint32_t)>& task);
+};
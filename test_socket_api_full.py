@@ -5,6 +5,7 @@ import glob
 import time
 import base64
 import os
+import struct
 
 # --- Fixtures ---
 
@@ -48,6 +49,42 @@ def send_command(sock, cmd_type, **params):
     # Allow caller to handle success/failure, but return whole object
     return result
 
+def recv_exact(conn, length):
+    """Read exactly length bytes from a socket."""
+    data = b""
+    while len(data) < length:
+        chunk = conn.recv(length - len(data))
+        assert chunk
+        data += chunk
+    return data
+
+def open_binary_connection(socket_path):
+    """Open a new connection and switch it to the binary protocol, returns (conn, handshake data)."""
+    conn = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    conn.settimeout(5.0)
+    conn.connect(socket_path)
+    conn.sendall(b'{"type":"PROTOCOL","mode":"binary"}\n')
+    line = b""
+    while not line.endswith(b"\n"):
+        line += conn.recv(1)
+    info = json.loads(line)
+    assert info["success"]
+    return conn, info["data"]
+
+def binary_request(conn, opcode, tag, payload=b""):
+    """Send one binary frame, returns (status, payload) of the response."""
+    conn.sendall(struct.pack("<IHH", len(payload), opcode, tag) + payload)
+    size, status, resp_tag = struct.unpack("<IHH", recv_exact(conn, 8))
+    assert resp_tag == tag
+    return status, recv_exact(conn, size)
+
+def binary_command_payload(cmd_type, **params):
+    """Payload of a binary COMMAND frame."""
+    payload = bytes([len(cmd_type)]) + cmd_type.encode() + struct.pack("<H", len(params))
+    for key, value in params.items():
+        payload += bytes([len(key)]) + key.encode() + struct.pack("<H", len(value)) + value.encode()
+    return payload
+
 # --- Core Tests ---
 
 def test_ping(sock):
@@ -117,6 +154,45 @@ def test_savestate_pause_param(sock):
     res = send_command(sock, "LOADSTATE", slot="1", pause="true")
     assert res["success"]
 
+def test_savestate_lz4_compression(sock):
+    res = send_command(sock, "SAVESTATE", slot="1", compression="lz4", pause="true")
+    assert res["success"]
+    res = send_command(sock, "LOADSTATE", slot="1", pause="true")
+    assert res["success"]
+    res = send_command(sock, "SAVESTATE", slot="1", compression="brotli")
+    assert not res["success"]
+
+def test_logpoint_compiled(sock):
+    res = send_command(sock, "LOGPOINT", action="add", addr="0x008000", expression="A +")
+    assert not res["success"]
+    res = send_command(sock, "LOGPOINT", action="add", addr="0x008000", expression="A")
+    assert res["success"]
+    lp_id = res["data"]["id"]
+    try:
+        res = send_command(sock, "LOGPOINT", action="hits")
+        assert res["success"]
+        assert "dropped" in res["data"]
+    finally:
+        send_command(sock, "LOGPOINT", action="remove", id=str(lp_id))
+
+def test_logpoint_boolean_value(sock):
+    # Values are formatted according to the expression's result type
+    send_command(sock, "PAUSE")
+    lp_id = None
+    try:
+        pc = send_command(sock, "CPU")["data"]["pc"]
+        res = send_command(sock, "LOGPOINT", action="add", addr=pc, expression="A == A")
+        assert res["success"]
+        lp_id = res["data"]["id"]
+        assert send_command(sock, "STEP", count="1")["success"]
+        time.sleep(0.1)
+        hits = [hit for hit in send_command(sock, "LOGPOINT", action="hits")["data"]["hits"] if hit["id"] == lp_id]
+        assert hits and all(hit["value"] == "true" for hit in hits)
+    finally:
+        if lp_id is not None:
+            send_command(sock, "LOGPOINT", action="remove", id=str(lp_id))
+        send_command(sock, "RESUME")
+
 def test_step(sock):
     send_command(sock, "PAUSE")
     try:
@@ -172,6 +248,124 @@ def test_search(sock):
         
     assert found
 
+def test_search_modes(sock):
+    # Unique marker in WRAM: 12 34 56 at 0x1F80
+    send_command(sock, "PAUSE")
+    try:
+        send_command(sock, "WRITEBLOCK", addr="0x7E1F80", hex="123456")
+
+        res = send_command(sock, "SEARCH", pattern="12 ?? 56", memtype="wram", save="marker")
+        assert res["success"]
+        assert "0x001F80" in res["data"]["matches"]
+        assert res["data"]["total"] >= 1
+
+        res = send_command(sock, "SEARCH", mode="value", value="0x563412", width="3", memtype="wram")
+        assert res["success"] and "0x001F80" in res["data"]["matches"]
+
+        # Pagination covers the same results
+        res = send_command(sock, "SEARCH", pattern="??", memtype="wram", start="0x1F80", end="0x1F8F", limit="10")
+        assert res["data"]["total"] == 16 and res["data"]["count"] == 10 and res["data"]["hasMore"]
+        res = send_command(sock, "SEARCH", pattern="??", memtype="wram", start="0x1F80", end="0x1F8F", offset="10", limit="10")
+        assert res["data"]["count"] == 6 and not res["data"]["hasMore"]
+
+        # Snapshot-relative filtering, narrowed to the saved marker results
+        assert send_command(sock, "SNAPSHOT", name="search_test", memtype="wram")["success"]
+        send_command(sock, "WRITE", addr="0x7E1F80", value="0x13")
+        res = send_command(sock, "SEARCH", mode="increased", snapshot="search_test", within="marker")
+        assert res["success"] and res["data"]["matches"] == ["0x001F80"]
+        res = send_command(sock, "SEARCH", mode="changed", snapshot="search_test", start="0x1F00", end="0x1FFF")
+        assert "0x001F80" in res["data"]["matches"]
+
+        res = send_command(sock, "SEARCH", pattern="XX")
+        assert not res["success"]
+    finally:
+        send_command(sock, "RESUME")
+
+def test_run_frames(sock):
+    send_command(sock, "PAUSE")
+    try:
+        start = send_command(sock, "STATE")["data"]["frame"]
+        res = send_command(sock, "RUN_FRAMES", frames="120", input="RIGHT*10;A", reads="wram:0x0000:16,snesmemory:0x7E0010:4", stride="50")
+        assert res["success"]
+        data = res["data"]
+        assert data["frames"] == 120
+        assert data["endFrame"] - data["startFrame"] == 120
+        assert data["startFrame"] >= start
+        # Samples at 50, 100 and the final frame
+        assert [s["frame"] - data["startFrame"] for s in data["samples"]] == [50, 100, 120]
+        assert [len(base64.b64decode(d)) for d in data["samples"][0]["data"]] == [16, 4]
+        # Last sample matches a regular read of the final state
+        res = send_command(sock, "READBLOCK_BINARY", addr="0x0000", size="16", memtype="wram")
+        assert base64.b64decode(res["data"]["bytes"]) == base64.b64decode(data["samples"][-1]["data"][0])
+        # Still paused afterwards
+        assert send_command(sock, "STATE")["data"]["paused"]
+
+        assert not send_command(sock, "RUN_FRAMES", frames="10", input="JUMP")["success"]
+        assert not send_command(sock, "RUN_FRAMES", frames="0")["success"]
+    finally:
+        send_command(sock, "RESUME")
+
+def test_instances(socket_path, sock):
+    send_command(sock, "PAUSE")
+    conn = None
+    try:
+        res = send_command(sock, "INSTANCE", action="create", count="2")
+        assert res["success"]
+        ids = res["data"]["created"]
+        assert len(ids) == 2 and 0 not in ids
+        listed = [i["id"] for i in send_command(sock, "INSTANCE")["data"]["instances"]]
+        assert listed[0] == 0 and all(i in listed for i in ids)
+
+        # Clones start from instance 0's state, then diverge independently
+        main = send_command(sock, "READBLOCK_BINARY", addr="0x0000", size="64", memtype="wram")["data"]["bytes"]
+        clone = send_command(sock, "READBLOCK_BINARY", addr="0x0000", size="64", memtype="wram", instance=str(ids[0]))["data"]["bytes"]
+        assert main == clone
+        before = send_command(sock, "READ", addr="0x7E1F90")["data"]
+        value = "0xA5" if before == "0x5A" else "0x5A"
+        assert send_command(sock, "WRITE", addr="0x7E1F90", value=value, instance=str(ids[0]))["success"]
+        assert send_command(sock, "READ", addr="0x7E1F90", instance=str(ids[0]))["data"] == value
+        assert send_command(sock, "READ", addr="0x7E1F90", instance=str(ids[1]))["data"] == before
+        assert send_command(sock, "READ", addr="0x7E1F90")["data"] == before
+
+        # Snapshots are per instance
+        assert send_command(sock, "SNAPSHOT", name="inst_snap", memtype="wram", instance=str(ids[1]))["success"]
+        assert not send_command(sock, "DIFF", snapshot="inst_snap", instance=str(ids[0]))["success"]
+
+        # Binary clients address the instance selected in the handshake or with the INSTANCE opcode
+        conn, info = open_binary_connection(socket_path)
+        opcodes = info["opcodes"]
+        wram = info["memoryTypes"]["SnesWorkRam"]
+        assert binary_request(conn, opcodes["INSTANCE"], 1, struct.pack("<I", 9999))[0] != 0
+        assert binary_request(conn, opcodes["INSTANCE"], 2, struct.pack("<I", ids[1]))[0] == 0
+        assert binary_request(conn, opcodes["WRITE"], 3, struct.pack("<BI", wram, 0x1F91) + b"\xC3")[0] == 0
+        assert binary_request(conn, opcodes["READ"], 4, struct.pack("<BII", wram, 0x1F91, 1)) == (0, b"\xC3")
+        assert send_command(sock, "READ", addr="0x7E1F91", instance=str(ids[1]))["data"] == "0xC3"
+        assert send_command(sock, "READ", addr="0x7E1F91", instance=str(ids[0]))["data"] != "0xC3"
+        status, data = binary_request(conn, opcodes["COMMAND"], 5, binary_command_payload("READ", addr="0x7E1F91"))
+        assert status == 0 and json.loads(data) == "0xC3"
+
+        # Parallel batch: same script on every instance gives the same frame count each
+        res = send_command(sock, "RUN_FRAMES", frames="60", input="RIGHT*10", reads="wram:0x0000:8", instances=",".join(map(str, ids)))
+        assert res["success"]
+        data = res["data"]
+        assert data["frames"] == 120
+        assert [r["instance"] for r in data["instances"]] == ids
+        assert all(r["success"] and r["result"]["frames"] == 60 for r in data["instances"])
+
+        assert not send_command(sock, "PING", instance="9999")["success"]
+        assert not send_command(sock, "RUN_FRAMES", frames="1", instances=f"{ids[0]},{ids[0]}")["success"]
+
+        res = send_command(sock, "INSTANCE", action="destroy", id=",".join(map(str, ids)))
+        assert res["success"] and res["data"]["destroyed"] == 2
+        assert not send_command(sock, "STATE", instance=str(ids[0]))["success"]
+        assert not send_command(sock, "INSTANCE", action="destroy", id="0")["success"]
+        assert binary_request(conn, opcodes["STATE"], 6)[0] != 0
+    finally:
+        if conn:
+            conn.close()
+        send_command(sock, "INSTANCE", action="destroy", id="all")
+        send_command(sock, "RESUME")
+
 # --- Discovery Tests ---
 
 def test_capabilities(sock):
@@ -235,6 +429,34 @@ def test_metrics(sock):
     assert res["success"]
     assert "avgLatencyUs" in res["data"]
 
+def test_subscribe_slow_client_metrics(socket_path, sock):
+    # A subscriber that never reads must not stall emulation; its events get coalesced/dropped instead
+    slow = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    slow.settimeout(5.0)
+    slow.connect(socket_path)
+    try:
+        res = send_command(slow, "SUBSCRIBE", events="frame_complete", policy="coalesce", buffer_kb="1")
+        assert res["success"]
+        assert res["data"]["policy"] == "coalesce"
+
+        start = send_command(sock, "STATE")["data"]["frame"]
+        send_command(sock, "RESUME")
+        time.sleep(0.5)
+        send_command(sock, "PAUSE")
+        end = send_command(sock, "STATE")["data"]["frame"]
+        assert end > start
+
+        res = send_command(sock, "METRICS")
+        assert res["success"]
+        events = res["data"]["events"]
+        for key in ("published", "queueDepth", "queueCapacity", "droppedQueueFull", "droppedBySubscribers", "coalesced"):
+            assert key in events
+    finally:
+        slow.close()
+
+    res = send_command(sock, "SUBSCRIBE", action="subscribe", policy="bogus")
+    assert not res["success"]
+
 def test_batch(sock):
     cmds = json.dumps([
         {"type": "PING"},
@@ -253,6 +475,110 @@ def test_batch(sock):
     assert results[0]["data"] == "PONG"
     assert "pc" in results[1]["data"] # lowercase
 
+def test_binary_protocol(socket_path, sock):
+    conn, info = open_binary_connection(socket_path)
+    try:
+        opcodes = info["opcodes"]
+        wram = info["memoryTypes"]["SnesWorkRam"]
+
+        status, data = binary_request(conn, opcodes["PING"], 1)
+        assert status == 0 and data == b""
+
+        # Same bytes as the JSON path
+        status, data = binary_request(conn, opcodes["READ"], 2, struct.pack("<BII", wram, 0x0000, 64))
+        assert status == 0 and len(data) == 64
+        res = send_command(sock, "READBLOCK_BINARY", addr="0x0000", size="64", memtype="wram")
+        assert base64.b64decode(res["data"]["bytes"]) == data
+
+        # Generic handler access without JSON
+        status, data = binary_request(conn, opcodes["COMMAND"], 3, binary_command_payload("PING"))
+        assert status == 0 and json.loads(data) == "PONG"
+
+        # Errors keep the connection usable
+        status, data = binary_request(conn, 0x7F, 4)
+        assert status == 4
+        status, data = binary_request(conn, opcodes["STATE"], 5)
+        assert status == 0 and len(data) == 6
+    finally:
+        conn.close()
+
+def test_screenshot_formats(socket_path, sock):
+    # No option: bare base64 PNG string
+    res = send_command(sock, "SCREENSHOT")
+    assert res["success"]
+    assert base64.b64decode(res["data"]).startswith(b"\x89PNG")
+
+    res = send_command(sock, "SCREENSHOT", format="raw")
+    assert res["success"]
+    shot = res["data"]
+    width, height = shot["width"], shot["height"]
+    assert shot["format"] == "raw"
+    assert len(base64.b64decode(shot["data"])) == shot["size"] == width * height * 4
+
+    res = send_command(sock, "SCREENSHOT", format="qoi")
+    assert res["success"]
+    assert base64.b64decode(res["data"]["data"]).startswith(b"qoif")
+
+    res = send_command(sock, "SCREENSHOT", format="png", level="0", x="8", y="4", width="64", height="32", downscale="2")
+    assert res["success"]
+    assert (res["data"]["width"], res["data"]["height"]) == (32, 16)
+    assert base64.b64decode(res["data"]["data"]).startswith(b"\x89PNG")
+
+    res = send_command(sock, "SCREENSHOT", format="bmp")
+    assert not res["success"]
+    res = send_command(sock, "SCREENSHOT", x=str(width))
+    assert not res["success"]
+    res = send_command(sock, "SCREENSHOT", encoding="binary")
+    assert not res["success"]
+
+    # Raw bytes through the binary protocol
+    conn, info = open_binary_connection(socket_path)
+    try:
+        payload = binary_command_payload("SCREENSHOT", format="raw", encoding="binary")
+        status, data = binary_request(conn, info["opcodes"]["COMMAND"], 1, payload)
+        assert status == 0
+        frame, w, h, fmt = struct.unpack("<IIII", data[:16])
+        assert (w, h, fmt) == (width, height, 0)
+        assert len(data) == 16 + w * h * 4
+    finally:
+        conn.close()
+
+def test_shared_memory_export(sock):
+    from multiprocessing import resource_tracker, shared_memory
+
+    res = send_command(sock, "SHM", action="start", memtypes="wram,vram")
+    assert res["success"]
+    info = res["data"]
+    assert info["active"]
+    assert info["memtypes"] == ["SnesWorkRam", "SnesVideoRam"]
+
+    try:
+        assert send_command(sock, "FRAME")["success"]
+        shm = shared_memory.SharedMemory(name=info["name"].lstrip("/"))
+        resource_tracker.unregister(shm._name, "shared_memory")
+        try:
+            magic, version, _, sequence = struct.unpack_from("<8sIIQ", shm.buf, 0)
+            assert magic == b"MESENSHM" and version == info["version"]
+            assert sequence % 2 == 0 and sequence > 0
+
+            # Region table follows the fixed 64-byte header
+            region_count = struct.unpack_from("<I", shm.buf, 60)[0]
+            assert region_count == 2
+            _, offset, size, _, name = struct.unpack_from("<IIII32s", shm.buf, 64)
+            assert name.rstrip(b"\0") == b"SnesWorkRam" and size == 0x20000
+
+            # Paused emulator: the exported WRAM matches what the socket returns
+            send_command(sock, "PAUSE")
+            send_command(sock, "FRAME")
+            res = send_command(sock, "READBLOCK_BINARY", addr="0x0000", size="64", memtype="wram")
+            assert base64.b64decode(res["data"]["bytes"]) == bytes(shm.buf[offset:offset + 64])
+        finally:
+            shm.close()
+            send_command(sock, "RESUME")
+    finally:
+        res = send_command(sock, "SHM", action="stop")
+        assert res["success"] and not res["data"]["active"]
+
 # --- Input ---
 
 def test_input_macro(sock):
@@ -305,6 +631,59 @@ def test_memory_write_attribution(sock):
     # Cleanup
     send_command(sock, "MEM_WATCH_WRITES", action="remove", watch_id=str(watch_id))
 
+def test_memory_write_watch_overlap(sock):
+    # Overlapping and adjacent regions must all be tracked independently
+    send_command(sock, "PAUSE")
+    ids = []
+    try:
+        # Find an address the game writes every frame (low WRAM holds the direct page and stack)
+        res = send_command(sock, "MEM_WATCH_WRITES", action="add", addr="0x7E0000", size="8192", depth="10000")
+        assert res["success"]
+        ids.append(res["data"]["watch_id"])
+        assert send_command(sock, "FRAME")["success"]
+        writes = send_command(sock, "MEM_BLAME", watch_id=str(ids[0]))["data"]["writes"]
+        assert writes
+        addrs = [int(w["addr"], 16) for w in writes]
+        hot = max(set(addrs), key=addrs.count)
+        send_command(sock, "MEM_WATCH_WRITES", action="remove", watch_id=str(ids.pop()))
+
+        # Two watches overlapping on the hot address, and one right after them
+        for addr, size in ((hot - 2, 8), (hot, 2), (hot + 6, 8)):
+            res = send_command(sock, "MEM_WATCH_WRITES", action="add", addr=hex(addr), size=str(size), depth="10000")
+            assert res["success"]
+            ids.append(res["data"]["watch_id"])
+
+        res = send_command(sock, "MEM_WATCH_WRITES", action="list")
+        assert res["success"]
+        listed = {w["watch_id"] for w in res["data"]["watches"]}
+        assert set(ids) <= listed
+
+        assert send_command(sock, "FRAME")["success"]
+
+        def hot_writes(watch_id):
+            res = send_command(sock, "MEM_BLAME", watch_id=str(watch_id))
+            assert res["success"]
+            return [(w["cycle"], w["value"]) for w in res["data"]["writes"] if int(w["addr"], 16) == hot]
+
+        # Both overlapping watches report every write to the shared address, the adjacent one none
+        outer, inner, adjacent = (hot_writes(watch_id) for watch_id in ids)
+        assert inner and outer == inner
+        assert adjacent == []
+
+        # Ring buffers never exceed the requested depth
+        res = send_command(sock, "MEM_WATCH_WRITES", action="add", addr=hex(hot), size="1", depth="4")
+        ids.append(res["data"]["watch_id"])
+        send_command(sock, "RESUME")
+        time.sleep(0.2)
+        send_command(sock, "PAUSE")
+        res = send_command(sock, "MEM_BLAME", watch_id=str(ids[-1]))
+        assert res["success"]
+        assert 0 < res["data"]["count"] <= 4
+    finally:
+        for watch_id in ids:
+            send_command(sock, "MEM_WATCH_WRITES", action="remove", watch_id=str(watch_id))
+        send_command(sock, "RESUME")
+
 def test_trace_execution(sock):
     # Trace usually returns recent execution
     res = send_command(sock, "TRACE", count="10")
@@ -312,6 +691,135 @@ def test_trace_execution(sock):
     assert "entries" in res["data"]
     assert len(res["data"]["entries"]) <= 10
 
+def test_trace_binary_file(sock, tmp_path):
+    path = str(tmp_path / "trace.mtrace")
+    send_command(sock, "PAUSE")
+    send_command(sock, "TRACE", action="start", clear="true")
+    try:
+        res = send_command(sock, "TRACE", action="file_start", path=path)
+        assert res["success"]
+        assert res["data"]["binary"]
+        # A few hundred instructions, so the whole log can be read back below
+        assert send_command(sock, "STEP", count="300")["success"]
+        time.sleep(0.1)
+        res = send_command(sock, "TRACE", action="file_stop")
+        assert res["success"]
+    finally:
+        send_command(sock, "TRACE", action="stop")
+        send_command(sock, "RESUME")
+
+    res = send_command(sock, "TRACE", action="read", path=path, count="5")
+    assert res["success"]
+    assert len(res["data"]["entries"]) <= 5
+
+    read_rows = 0
+    while True:
+        res = send_command(sock, "TRACE", action="read", path=path, count="100", offset=str(read_rows))
+        assert res["success"]
+        read_rows += res["data"]["count"]
+        if res["data"]["count"] < 100:
+            break
+
+    output = tmp_path / "trace.txt"
+    res = send_command(sock, "TRACE", action="convert", path=path, output=str(output))
+    assert res["success"]
+    assert res["data"]["rows"] > 0
+    assert res["data"]["rows"] == read_rows
+    assert len(output.read_text().splitlines()) == read_rows
+
+    res = send_command(sock, "TRACE", action="read", path=str(tmp_path / "missing.mtrace"))
+    assert not res["success"]
+
+def test_trace_query(sock):
+    tracing = send_command(sock, "TRACE", action="status")["data"]["enabled"]
+    res = send_command(sock, "TRACE_QUERY", action="start", max_rows="100000")
+    assert res["success"]
+    try:
+        send_command(sock, "RESUME")
+        time.sleep(0.2)
+        send_command(sock, "PAUSE")
+
+        res = send_command(sock, "TRACE_QUERY", action="status")
+        assert res["success"]
+        assert res["data"]["rows"] > 0
+
+        res = send_command(sock, "TRACE_QUERY", pc="0x000000-0xFFFFFF", count="5")
+        assert res["success"]
+        assert res["data"]["count"] == 5
+        assert "nextRow" in res["data"]
+
+        res = send_command(sock, "TRACE_QUERY", start_row=str(res["data"]["nextRow"]), frames="60", count="5")
+        assert res["success"]
+        assert res["data"]["count"] <= 5
+
+        res = send_command(sock, "TRACE_QUERY", addr="0x7E0022")
+        assert res["success"]
+        assert all(row["addr"] == "0x7E0022" for row in res["data"]["rows"])
+
+        res = send_command(sock, "TRACE_QUERY", pc="zzz")
+        assert not res["success"]
+    finally:
+        send_command(sock, "TRACE_QUERY", action="stop")
+        send_command(sock, "TRACE_QUERY", action="clear")
+
+    # Loggers enabled by start are turned back off by stop
+    assert send_command(sock, "TRACE", action="status")["data"]["enabled"] == tracing
+
+def test_profiler(sock, tmp_path):
+    res = send_command(sock, "PROFILER", action="start", interval="200")
+    assert res["success"]
+    try:
+        send_command(sock, "RESUME")
+        time.sleep(0.5)
+        send_command(sock, "PAUSE")
+
+        res = send_command(sock, "PROFILER", action="status")
+        assert res["success"]
+        assert res["data"]["enabled"]
+        assert res["data"]["samples"] > 0
+
+        res = send_command(sock, "PROFILER", action="functions", count="5")
+        assert res["success"]
+        functions = res["data"]["functions"]
+        assert 0 < len(functions) <= 5
+        assert all(functions[i]["exclusive"] >= functions[i + 1]["exclusive"] for i in range(len(functions) - 1))
+
+        res = send_command(sock, "PROFILER", action="frames", frames="2")
+        assert res["success"]
+        assert 0 < len(res["data"]["frames"]) <= 2
+
+        path = str(tmp_path / "profile.folded")
+        res = send_command(sock, "PROFILER", action="export", path=path)
+        assert res["success"]
+        with open(path) as f:
+            assert all(line.startswith("[root]") for line in f)
+
+        res = send_command(sock, "PROFILER", action="bogus")
+        assert not res["success"]
+    finally:
+        send_command(sock, "PROFILER", action="stop")
+        send_command(sock, "PROFILER", action="reset")
+
+def test_disasm_export(sock, tmp_path):
+    path = str(tmp_path / "export.asm")
+    send_command(sock, "PAUSE")
+    res = send_command(sock, "DISASM_EXPORT", path=path, full="true")
+    assert res["success"]
+    assert res["data"]["blocks"] > 0
+    assert res["data"]["disassembled"] == res["data"]["blocks"]
+    assert os.path.getsize(path) > 0
+
+    # Nothing changed, every block is reused
+    res = send_command(sock, "DISASM_EXPORT", path=path)
+    assert res["success"]
+    assert res["data"]["reused"] == res["data"]["blocks"]
+
+    res = send_command(sock, "DISASM_EXPORT", path=path, memtype="zzz")
+    assert not res["success"]
+
+    res = send_command(sock, "DISASM_EXPORT")
+    assert not res["success"]
+
 def test_symbols_integration(sock):
     # Use the discovered oos.mlb
     mlb_path = "/Users/scawful/src/hobby/oracle-of-secrets/Roms/oos.mlb"
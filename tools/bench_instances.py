@@ -0,0 +1,84 @@
+#!/usr/bin/env python3
+"""
+bench_instances - Measure RUN_FRAMES throughput across emulator instances in one process
+
+Creates N instances (INSTANCE action=create, cloned from the running game), then runs
+the same RUN_FRAMES batch on 1, 2, 4, ... N of them in parallel and prints aggregate
+frames/second and scaling efficiency relative to a single instance.
+
+Usage:
+    bench_instances.py [--socket PATH] [--max N] [--frames N] [--input SCRIPT]
+
+Requires a running Mesen2 instance with a ROM loaded.
+"""
+
+import argparse
+import glob
+import json
+import os
+import socket
+import sys
+
+
+def find_socket():
+    sockets = glob.glob("/tmp/mesen2-*.sock")
+    if not sockets:
+        print("Error: No Mesen2 socket found. Is Mesen running?")
+        sys.exit(1)
+    return sorted(sockets, key=lambda x: -int(x.split('-')[1].split('.')[0]))[0]
+
+
+def send_command(sock, cmd_type, **params):
+    sock.sendall((json.dumps({"type": cmd_type, **params}) + "\n").encode())
+    data = b""
+    while not data.endswith(b"\n"):
+        chunk = sock.recv(1 << 20)
+        if not chunk:
+            raise ConnectionError("Connection closed")
+        data += chunk
+    res = json.loads(data)
+    if not res.get("success"):
+        raise RuntimeError(f"{cmd_type} failed: {res.get('error')}")
+    return res["data"]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--socket", default=None, help="Socket path (default: newest /tmp/mesen2-*.sock)")
+    parser.add_argument("--max", type=int, default=os.cpu_count() or 1, help="Max instance count (default: CPU count)")
+    parser.add_argument("--frames", type=int, default=1800, help="Frames per instance per run")
+    parser.add_argument("--input", default="RIGHT*20;A;RIGHT*20;B", help="Looped RUN_FRAMES input script")
+    args = parser.parse_args()
+
+    sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    sock.connect(args.socket or find_socket())
+
+    ids = send_command(sock, "INSTANCE", action="create", count=str(args.max))["created"]
+    try:
+        counts = []
+        n = 1
+        while n < args.max:
+            counts.append(n)
+            n *= 2
+        counts.append(args.max)
+
+        # Warm up every instance once (first frames include cache/allocation effects)
+        send_command(sock, "RUN_FRAMES", frames="60", input=args.input, loop="true", render="false",
+                     instances=",".join(map(str, ids)))
+
+        print(f"{'instances':>9} {'threads':>8} {'frames':>9} {'ms':>9} {'fps':>10} {'speedup':>8} {'eff':>6}")
+        base_fps = None
+        for count in counts:
+            data = send_command(sock, "RUN_FRAMES", frames=str(args.frames), input=args.input, loop="true",
+                                render="false", instances=",".join(map(str, ids[:count])))
+            fps = data["fps"]
+            base_fps = base_fps or fps
+            speedup = fps / base_fps
+            print(f"{count:>9} {data['threads']:>8} {data['frames']:>9} {data['elapsedMs']:>9.1f} {fps:>10.1f} "
+                  f"{speedup:>7.2f}x {speedup / min(count, data['threads']) * 100:>5.0f}%")
+    finally:
+        send_command(sock, "INSTANCE", action="destroy", id=",".join(map(str, ids)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,142 @@
+#!/usr/bin/env python3
+"""
+bench_socket_protocol - Compare round-trip latency of the JSON and binary socket protocols
+
+Runs the same READ/WRITE/STATE requests over a line-delimited JSON connection
+and over a binary framed connection (PROTOCOL mode=binary), then prints
+per-request latency percentiles for both.
+
+Usage:
+    bench_socket_protocol.py [--socket PATH] [--count N] [--size BYTES]
+
+Requires a running Mesen2 instance with a SNES ROM loaded.
+"""
+
+import argparse
+import glob
+import json
+import socket
+import statistics
+import struct
+import sys
+import time
+
+OP_PING = 0x00
+OP_READ = 0x01
+OP_WRITE = 0x02
+OP_STATE = 0x04
+
+
+def find_socket():
+    sockets = glob.glob("/tmp/mesen2-*.sock")
+    if not sockets:
+        print("Error: No Mesen2 socket found. Is Mesen running?")
+        sys.exit(1)
+    return sorted(sockets, key=lambda x: -int(x.split('-')[1].split('.')[0]))[0]
+
+
+def recv_exact(sock, length):
+    data = bytearray()
+    while len(data) < length:
+        chunk = sock.recv(length - len(data))
+        if not chunk:
+            raise ConnectionError("Connection closed")
+        data += chunk
+    return bytes(data)
+
+
+class JsonClient:
+    def __init__(self, path):
+        self.sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        self.sock.connect(path)
+        self.buffer = b""
+
+    def request(self, cmd):
+        self.sock.sendall((json.dumps(cmd) + "\n").encode())
+        while b"\n" not in self.buffer:
+            chunk = self.sock.recv(65536)
+            if not chunk:
+                raise ConnectionError("Connection closed")
+            self.buffer += chunk
+        line, self.buffer = self.buffer.split(b"\n", 1)
+        return json.loads(line)
+
+
+class BinaryClient:
+    def __init__(self, path):
+        self.sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        self.sock.connect(path)
+        # Handshake is JSON - wait for the response before sending any frame
+        self.sock.sendall(b'{"type":"PROTOCOL","mode":"binary"}\n')
+        line = b""
+        while not line.endswith(b"\n"):
+            line += self.sock.recv(1)
+        info = json.loads(line)
+        if not info.get("success"):
+            raise RuntimeError(f"Binary protocol not supported: {info.get('error')}")
+        self.memory_types = info["data"]["memoryTypes"]
+        self.tag = 0
+
+    def request(self, opcode, payload=b""):
+        self.tag = (self.tag + 1) & 0xFFFF
+        self.sock.sendall(struct.pack("<IHH", len(payload), opcode, self.tag) + payload)
+        size, status, tag = struct.unpack("<IHH", recv_exact(self.sock, 8))
+        data = recv_exact(self.sock, size) if size else b""
+        if status != 0:
+            raise RuntimeError(f"Request failed ({status}): {data.decode(errors='replace')}")
+        assert tag == self.tag
+        return data
+
+
+def measure(name, count, fn):
+    for _ in range(min(100, count)):
+        fn()
+    samples = []
+    for _ in range(count):
+        start = time.perf_counter()
+        fn()
+        samples.append((time.perf_counter() - start) * 1e6)
+    samples.sort()
+    return {
+        "name": name,
+        "mean": statistics.mean(samples),
+        "p50": samples[len(samples) // 2],
+        "p99": samples[min(len(samples) - 1, int(len(samples) * 0.99))],
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--socket", default=None, help="Socket path (default: newest /tmp/mesen2-*.sock)")
+    parser.add_argument("--count", type=int, default=5000, help="Requests per benchmark")
+    parser.add_argument("--size", type=int, default=256, help="Block size for block reads")
+    args = parser.parse_args()
+
+    path = args.socket or find_socket()
+    js = JsonClient(path)
+    bn = BinaryClient(path)
+    wram = bn.memory_types["SnesWorkRam"]
+    addr = 0x0022
+    block = args.size
+
+    results = [
+        measure("json   PING", args.count, lambda: js.request({"type": "PING"})),
+        measure("binary PING", args.count, lambda: bn.request(OP_PING)),
+        measure("json   STATE", args.count, lambda: js.request({"type": "STATE"})),
+        measure("binary STATE", args.count, lambda: bn.request(OP_STATE)),
+        measure("json   READ (1 byte)", args.count, lambda: js.request({"type": "READ", "addr": hex(addr), "memtype": "wram"})),
+        measure("binary READ (1 byte)", args.count, lambda: bn.request(OP_READ, struct.pack("<BII", wram, addr, 1))),
+        measure(f"json   READBLOCK_BINARY ({block} bytes)", args.count,
+                lambda: js.request({"type": "READBLOCK_BINARY", "addr": hex(addr), "size": str(block), "memtype": "wram"})),
+        measure(f"binary READ ({block} bytes)", args.count, lambda: bn.request(OP_READ, struct.pack("<BII", wram, addr, block))),
+        measure("json   WRITE (1 byte)", args.count, lambda: js.request({"type": "WRITE", "addr": hex(0x1F00), "value": "0x00", "memtype": "wram"})),
+        measure("binary WRITE (1 byte)", args.count, lambda: bn.request(OP_WRITE, struct.pack("<BI", wram, 0x1F00) + b"\x00")),
+    ]
+
+    print(f"{'request':<36} {'mean us':>10} {'p50 us':>10} {'p99 us':>10}")
+    for r in results:
+        print(f"{r['name']:<36} {r['mean']:>10.1f} {r['p50']:>10.1f} {r['p99']:>10.1f}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,162 @@
+#!/usr/bin/env python3
+"""
+mesen2_shm - Read emulator memory and the frame buffer through the SHM shared memory export
+
+Starts the export (SHM action=start) on a running Mesen2 instance, then reads a
+consistent snapshot straight from shared memory using the header's seqlock.
+With --bench, compares snapshot latency against READBLOCK_BINARY + SCREENSHOT.
+
+Usage:
+    mesen2_shm.py [--socket PATH] [--memtypes wram,vram] [--bench] [--count N]
+
+Can also be imported: SharedMemoryReader(name).snapshot() returns
+(frame_count, frame_info, {memtype_name: bytes}).
+"""
+
+import argparse
+import base64
+import glob
+import json
+import socket
+import statistics
+import struct
+import sys
+import time
+from multiprocessing import resource_tracker, shared_memory
+
+MAGIC = b"MESENSHM"
+# Magic, Version, HeaderSize, Sequence, FrameCount, LayoutId, TotalSize,
+# FrameWidth, FrameHeight, FrameOffset, FrameSize, FrameBytesPerPixel, RegionCount
+HEADER = struct.Struct("<8sIIQQIIIIIIII")
+SEQUENCE_OFFSET = 16
+REGION = struct.Struct("<IIII32s")
+
+
+def find_socket():
+    sockets = glob.glob("/tmp/mesen2-*.sock")
+    if not sockets:
+        print("Error: No Mesen2 socket found. Is Mesen running?")
+        sys.exit(1)
+    return sorted(sockets, key=lambda x: -int(x.split('-')[1].split('.')[0]))[0]
+
+
+def send_command(sock, cmd_type, **params):
+    sock.sendall((json.dumps({"type": cmd_type, **params}) + "\n").encode())
+    data = b""
+    while not data.endswith(b"\n"):
+        chunk = sock.recv(1 << 20)
+        if not chunk:
+            raise ConnectionError("Connection closed")
+        data += chunk
+    return json.loads(data)
+
+
+class SharedMemoryReader:
+    def __init__(self, name):
+        self.name = name.lstrip("/")
+        self.shm = None
+        self.layout_id = None
+        self._open()
+
+    def _open(self):
+        if self.shm:
+            self.shm.close()
+        self.shm = shared_memory.SharedMemory(name=self.name)
+        # The emulator owns the object - don't let Python unlink it when this process exits
+        resource_tracker.unregister(self.shm._name, "shared_memory")
+        header = HEADER.unpack_from(self.shm.buf, 0)
+        if header[0] != MAGIC:
+            raise RuntimeError("Not a Mesen2 shared memory export")
+        if header[1] != 1:
+            raise RuntimeError(f"Unsupported version {header[1]}")
+
+    def _read_layout(self):
+        (_, _, _, _, _, layout_id, total_size, width, height,
+         frame_offset, _, bpp, region_count) = HEADER.unpack_from(self.shm.buf, 0)
+        if total_size > self.shm.size:
+            self._open()
+            return None
+        regions = []
+        for i in range(region_count):
+            mem_type, offset, size, _, name = REGION.unpack_from(self.shm.buf, HEADER.size + i * REGION.size)
+            regions.append((name.rstrip(b"\0").decode(), offset, size))
+        return layout_id, width, height, frame_offset, bpp, regions
+
+    def _sequence(self):
+        return struct.unpack_from("<Q", self.shm.buf, SEQUENCE_OFFSET)[0]
+
+    def snapshot(self, memtypes=None, include_frame=True):
+        buf = self.shm.buf
+        while True:
+            seq = self._sequence()
+            if seq & 1:
+                continue
+            layout = self._read_layout()
+            if layout is None:
+                continue
+            layout_id, width, height, frame_offset, bpp, regions = layout
+            frame_count = struct.unpack_from("<Q", buf, 24)[0]
+            frame = bytes(buf[frame_offset:frame_offset + width * height * bpp]) if include_frame else None
+            memory = {name: bytes(buf[offset:offset + size])
+                      for name, offset, size in regions if memtypes is None or name in memtypes}
+            if self._sequence() == seq:
+                return frame_count, {"width": width, "height": height, "bpp": bpp, "data": frame}, memory
+
+    def close(self):
+        self.shm.close()
+
+
+def measure(count, fn):
+    for _ in range(min(20, count)):
+        fn()
+    samples = []
+    for _ in range(count):
+        start = time.perf_counter()
+        fn()
+        samples.append((time.perf_counter() - start) * 1e6)
+    samples.sort()
+    return statistics.mean(samples), samples[len(samples) // 2], samples[min(len(samples) - 1, int(len(samples) * 0.99))]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--socket", default=None, help="Socket path (default: newest /tmp/mesen2-*.sock)")
+    parser.add_argument("--memtypes", default="", help="Comma-separated memory types (default: all RAM types)")
+    parser.add_argument("--bench", action="store_true", help="Compare against READBLOCK_BINARY + SCREENSHOT")
+    parser.add_argument("--count", type=int, default=200, help="Iterations per benchmark")
+    args = parser.parse_args()
+
+    sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    sock.connect(args.socket or find_socket())
+    res = send_command(sock, "SHM", action="start", memtypes=args.memtypes)
+    if not res.get("success"):
+        print(f"Error: {res.get('error')}")
+        sys.exit(1)
+    info = res["data"]
+    print(f"Exporting {', '.join(info['memtypes'])} to {info['name']} ({info['size']} bytes)")
+
+    # Wait for the first published frame
+    send_command(sock, "FRAME")
+    reader = SharedMemoryReader(info["name"])
+    frame_count, frame, memory = reader.snapshot()
+    print(f"frame {frame_count}: {frame['width']}x{frame['height']} @ {frame['bpp']} bytes/pixel")
+    for name, data in memory.items():
+        print(f"  {name:<20} {len(data):>8} bytes")
+
+    if args.bench:
+        def socket_snapshot():
+            res = send_command(sock, "READBLOCK_BINARY", addr="0x0000", size=str(0x20000), memtype="wram")
+            base64.b64decode(res["data"]["bytes"])
+            send_command(sock, "SCREENSHOT")
+
+        print(f"{'method':<36} {'mean us':>10} {'p50 us':>10} {'p99 us':>10}")
+        for name, fn in [("shm (frame + wram)", lambda: reader.snapshot(memtypes={"SnesWorkRam"})),
+                         ("socket (READBLOCK_BINARY + SCREENSHOT)", socket_snapshot)]:
+            mean, p50, p99 = measure(args.count, fn)
+            print(f"{name:<36} {mean:>10.1f} {p50:>10.1f} {p99:>10.1f}")
+
+    reader.close()
+
+
+if __name__ == "__main__":
+    main()